@@ -0,0 +1,144 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+#include "AssetArchive.hpp"
+#include "Lz4.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace nether::Benchmark
+{
+    static constexpr std::string_view ASSET_DIRECTORY = "assets";
+    static constexpr std::string_view LZ4_INPUT_PATH = "assets/Suzanne/glTF/Suzanne.gltf";
+
+    // Reads one byte per page, so every page of the file is read from disk (or the page cache) without the benchmark being about summing bytes.
+    static uint64_t touchPages(const std::span<const std::byte> data)
+    {
+        uint64_t sum{};
+        for (size_t offset = 0u; offset < data.size(); offset += 4096u)
+        {
+            sum += static_cast<uint64_t>(data[offset]);
+        }
+
+        return sum;
+    }
+
+#ifndef _WIN32
+    // Drops the pages of the file from the page cache, so the next read goes to the disk. Does not need any privileges, unlike dropping the whole cache. Only clean pages
+    // are dropped, so the file (e.g. the archive, which was just written) is flushed first.
+    static void evictFromPageCache(const std::string& filePath)
+    {
+        const int32_t file = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file >= 0)
+        {
+            fdatasync(file);
+            posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+            close(file);
+        }
+    }
+#endif
+
+    void runAssetArchiveBenchmarks(BenchmarkRunner& runner)
+    {
+        if (!std::filesystem::exists(ASSET_DIRECTORY))
+        {
+            std::cout << "Skipping the asset archive benchmarks, the assets were not found (run from the repository root)." << std::endl;
+            return;
+        }
+
+        std::vector<std::string> filePaths{};
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(ASSET_DIRECTORY))
+        {
+            if (entry.is_regular_file())
+            {
+                filePaths.push_back(entry.path().generic_string());
+            }
+        }
+
+        const std::string archivePath = (std::filesystem::temp_directory_path() / "NetherBenchmarks.pak").string();
+        writeAssetArchive(archivePath, filePaths, true);
+
+        // Opening and reading every asset : one mapping per file, against one mapping for the archive (compressed entries are decompressed).
+        const auto readLooseFiles = [&]()
+        {
+            uint64_t sum{};
+            for (const std::string& filePath : filePaths)
+            {
+                const MappedFile mappedFile(filePath);
+                sum += touchPages(mappedFile.getData());
+            }
+
+            doNotOptimize(sum);
+        };
+
+        std::vector<std::byte> decompressedData{};
+        const auto readArchive = [&]()
+        {
+            const AssetArchive archive(archivePath);
+
+            uint64_t sum{};
+            for (const std::string& filePath : filePaths)
+            {
+                sum += touchPages(archive.read(*archive.find(filePath), decompressedData));
+            }
+
+            doNotOptimize(sum);
+        };
+
+        runner.run("AssetArchive/readAll/loose/warm", filePaths.size(), readLooseFiles);
+        runner.run("AssetArchive/readAll/archive/warm", filePaths.size(), readArchive);
+
+        // There is no way to drop a file from the cache without privileges on Windows, so the cold benchmarks are Linux only.
+#ifndef _WIN32
+        runner.runWithSetup(
+            "AssetArchive/readAll/loose/cold",
+            filePaths.size(),
+            [&]()
+            {
+                for (const std::string& filePath : filePaths)
+                {
+                    evictFromPageCache(filePath);
+                }
+            },
+            readLooseFiles);
+
+        runner.runWithSetup("AssetArchive/readAll/archive/cold", filePaths.size(), [&]() { evictFromPageCache(archivePath); }, readArchive);
+#endif
+
+        // Lookups of every asset, in an archive that is already open.
+        const AssetArchive archive(archivePath);
+        runner.run("AssetArchive/find",
+                   filePaths.size(),
+                   [&]()
+                   {
+                       for (const std::string& filePath : filePaths)
+                       {
+                           doNotOptimize(archive.find(filePath));
+                       }
+                   });
+
+        // The packer's compressor and the loader's decompressor, on the JSON of a .gltf file (vertex data and PNGs barely compress).
+        const std::vector<char> lz4Input = readFile(LZ4_INPUT_PATH);
+        const std::span<const std::byte> lz4InputBytes = std::as_bytes(std::span(lz4Input));
+
+        runner.run("Lz4/compress/Suzanne.gltf", lz4InputBytes.size(), [&]() { doNotOptimize(Lz4::compress(lz4InputBytes).size()); });
+
+        const std::vector<std::byte> compressedData = Lz4::compress(lz4InputBytes);
+        std::vector<std::byte> lz4Output(lz4InputBytes.size());
+        runner.run("Lz4/decompress/Suzanne.gltf",
+                   lz4InputBytes.size(),
+                   [&]()
+                   {
+                       Lz4::decompress(compressedData, lz4Output);
+                       doNotOptimize(lz4Output.back());
+                   });
+
+        std::cout << std::format("LZ4 compressed Suzanne.gltf from {} to {} bytes.", lz4InputBytes.size(), compressedData.size()) << std::endl;
+
+        std::filesystem::remove(archivePath);
+    }
+}
@@ -0,0 +1,162 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+#include "AssetLoader.hpp"
+#include "AssetPipeline.hpp"
+#include "GltfImporter.hpp"
+#include "JobSystem.hpp"
+
+#include <tiny_gltf.h>
+
+namespace nether::Benchmark
+{
+    // The largest mesh and texture in assets/.
+    static constexpr std::string_view MODEL_PATH = "assets/Suzanne/glTF/Suzanne.gltf";
+    static constexpr std::string_view IMAGE_PATH = "assets/Suzanne/glTF/Suzanne_BaseColor.png";
+
+    // Every mesh and texture of the cube and Suzanne, which is what the engine loads at startup and then some.
+    static constexpr std::array<std::string_view, 2u> PIPELINE_MODEL_PATHS = {
+        "assets/Cube/glTF/Cube.gltf",
+        "assets/Suzanne/glTF/Suzanne.gltf",
+    };
+
+    static constexpr std::array<std::string_view, 5u> PIPELINE_IMAGE_PATHS = {
+        "assets/Cube/glTF/Cube_BaseColor.png",
+        "assets/Cube/glTF/Cube_BaseColor_original.png",
+        "assets/Cube/glTF/Cube_MetallicRoughness.png",
+        "assets/Suzanne/glTF/Suzanne_BaseColor.png",
+        "assets/Suzanne/glTF/Suzanne_MetallicRoughness.png",
+    };
+
+    static constexpr uint64_t PIPELINE_ASSET_COUNT = PIPELINE_MODEL_PATHS.size() + PIPELINE_IMAGE_PATHS.size();
+
+    // Loading every asset one after the other on the calling thread (as Engine::createMesh / createTexture do), against the I/O and decode stages of the asset
+    // pipeline. The upload stage is left out, only the CPU side of loading is measured.
+    static void runAssetPipelineBenchmarks(BenchmarkRunner& runner)
+    {
+        runner.run("AssetPipeline/serial",
+                   PIPELINE_ASSET_COUNT,
+                   [&]()
+                   {
+                       for (const std::string_view modelPath : PIPELINE_MODEL_PATHS)
+                       {
+                           doNotOptimize(loadMeshData(modelPath).indices.back());
+                       }
+
+                       for (const std::string_view imagePath : PIPELINE_IMAGE_PATHS)
+                       {
+                           doNotOptimize(loadImage(imagePath).pixels.back());
+                       }
+                   });
+
+        for (const uint32_t threadCount : getThreadCounts())
+        {
+            const std::string name = std::format("AssetPipeline/pipelined/threads:{}", threadCount);
+            if (!runner.isEnabled(name))
+            {
+                continue;
+            }
+
+            // With a single thread, the pipeline loads on the thread that takes the decoded assets.
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = threadCount - 1u});
+            AssetPipeline assetPipeline(jobSystem);
+
+            std::vector<DecodedAsset> decodedAssets{};
+            runner.run(name,
+                       PIPELINE_ASSET_COUNT,
+                       [&]()
+                       {
+                           for (const std::string_view modelPath : PIPELINE_MODEL_PATHS)
+                           {
+                               assetPipeline.request(AssetLoadRequest{.path = std::string(modelPath), .type = AssetType::Mesh});
+                           }
+
+                           for (const std::string_view imagePath : PIPELINE_IMAGE_PATHS)
+                           {
+                               assetPipeline.request(AssetLoadRequest{.path = std::string(imagePath), .type = AssetType::Texture});
+                           }
+
+                           decodedAssets.clear();
+                           while (assetPipeline.getPendingCount() != 0u)
+                           {
+                               assetPipeline.waitForDecodedAssets(decodedAssets, PIPELINE_ASSET_COUNT);
+                           }
+
+                           doNotOptimize(decodedAssets.size());
+                       });
+        }
+    }
+
+    void runAssetBenchmarks(BenchmarkRunner& runner)
+    {
+        if (!std::filesystem::exists(MODEL_PATH) || !std::filesystem::exists(IMAGE_PATH))
+        {
+            std::cout << "Skipping the asset benchmarks, the assets were not found (run from the repository root)." << std::endl;
+            return;
+        }
+
+        // The file is read and parsed every iteration, so this includes the (cached) file system reads.
+        runner.run("Asset/loadGltfModel/Suzanne",
+                   1u,
+                   [&]()
+                   {
+                       tinygltf::Model model{};
+                       loadGltfModel(MODEL_PATH, model);
+                       doNotOptimize(model.accessors.size());
+                   });
+
+        // The importer Engine::createMesh uses, mapping the .gltf and .bin files.
+        runner.run("Asset/importGltf/Suzanne",
+                   1u,
+                   [&]()
+                   {
+                       const MappedFile file(MODEL_PATH);
+
+                       GltfModel gltfModel{};
+                       importGltf(file.getData(), std::filesystem::path(MODEL_PATH).parent_path().generic_string(), gltfModel);
+                       doNotOptimize(gltfModel.accessors.size());
+                   });
+
+        // The accessor decode, without the parse.
+        tinygltf::Model model{};
+        loadGltfModel(MODEL_PATH, model);
+
+        const size_t vertexCount = decodeMeshData(model).positions.size();
+        runner.run("Asset/decodeMeshData/tinygltf/Suzanne",
+                   vertexCount,
+                   [&]()
+                   {
+                       const MeshData meshData = decodeMeshData(model);
+                       doNotOptimize(meshData.indices.back());
+                   });
+
+        const MappedFile modelFile(MODEL_PATH);
+
+        GltfModel gltfModel{};
+        importGltf(modelFile.getData(), std::filesystem::path(MODEL_PATH).parent_path().generic_string(), gltfModel);
+
+        runner.run("Asset/decodeMeshData/importer/Suzanne",
+                   vertexCount,
+                   [&]()
+                   {
+                       const MeshData meshData = decodeMeshData(gltfModel);
+                       doNotOptimize(meshData.indices.back());
+                   });
+
+        // The image decode of D3D12GraphicsBackend::createTexture, from memory so it does not include the file read.
+        const std::vector<char> encodedImage = readFile(IMAGE_PATH);
+        const std::span<const std::byte> encodedImageBytes = std::as_bytes(std::span(encodedImage));
+
+        const ImageData firstImage = decodeImage(encodedImageBytes);
+        runner.run("Asset/decodeImage/Suzanne_BaseColor",
+                   static_cast<uint64_t>(firstImage.width) * firstImage.height,
+                   [&]()
+                   {
+                       const ImageData image = decodeImage(encodedImageBytes);
+                       doNotOptimize(image.pixels.back());
+                   });
+
+        runAssetPipelineBenchmarks(runner);
+    }
+}
@@ -0,0 +1,107 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+#include "AssetRegistry.hpp"
+#include "JobSystem.hpp"
+
+namespace nether::Benchmark
+{
+    static constexpr uint32_t ASSET_COUNT = 256u;
+    static constexpr uint32_t LOOKUP_COUNT = 64u * 1024u;
+    static constexpr uint32_t LOOKUP_BATCH_SIZE = 1024u;
+
+    // Stands in for a mesh or texture, the registry only moves it around.
+    struct BenchmarkAsset
+    {
+        uint32_t value{};
+    };
+
+    static BenchmarkAsset loadBenchmarkAsset(const std::string_view assetPath) { return BenchmarkAsset{static_cast<uint32_t>(assetPath.size())}; }
+
+    void runAssetRegistryBenchmarks(BenchmarkRunner& runner)
+    {
+        std::vector<std::string> assetPaths{};
+        for (const uint32_t i : std::views::iota(0u, ASSET_COUNT))
+        {
+            assetPaths.push_back(std::format("assets/Mesh{}/glTF/Mesh{}.gltf", i, i));
+        }
+
+        // Loading, releasing and destroying every asset, single threaded.
+        runner.run("AssetRegistry/acquire/miss",
+                   ASSET_COUNT,
+                   [&]()
+                   {
+                       AssetRegistry<BenchmarkAsset> registry(ASSET_COUNT, 0u);
+                       for (const std::string& assetPath : assetPaths)
+                       {
+                           registry.release(registry.acquire(assetPath, loadBenchmarkAsset));
+                       }
+
+                       registry.collectGarbage(0u);
+                       doNotOptimize(registry.getAssetCount());
+                   });
+
+        // Lookups by path of assets that are loaded (and stay referenced), from 1 to N threads. Each lookup takes a reference and drops it.
+        AssetRegistry<BenchmarkAsset> registry(ASSET_COUNT, 0u);
+
+        std::vector<AssetHandle<BenchmarkAsset>> handles{};
+        for (const std::string& assetPath : assetPaths)
+        {
+            handles.push_back(registry.acquire(assetPath, loadBenchmarkAsset));
+        }
+
+        for (const uint32_t threadCount : getThreadCounts())
+        {
+            const std::string acquireName = std::format("AssetRegistry/acquire/hit/threads:{}", threadCount);
+            const std::string referenceName = std::format("AssetRegistry/addReference/threads:{}", threadCount);
+            if (!runner.isEnabled(acquireName) && !runner.isEnabled(referenceName))
+            {
+                continue;
+            }
+
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = threadCount - 1u});
+
+            runner.run(acquireName,
+                       LOOKUP_COUNT,
+                       [&]()
+                       {
+                           jobSystem.parallelFor(LOOKUP_COUNT,
+                                                 LOOKUP_BATCH_SIZE,
+                                                 [&](const uint32_t begin, const uint32_t end)
+                                                 {
+                                                     for (const uint32_t i : std::views::iota(begin, end))
+                                                     {
+                                                         const AssetHandle<BenchmarkAsset> handle = registry.acquire(assetPaths[i % ASSET_COUNT], loadBenchmarkAsset);
+                                                         doNotOptimize(registry.get(handle).value);
+                                                         registry.release(handle);
+                                                     }
+                                                 });
+                       });
+
+            // Taking references to handles that are already held, which never locks.
+            runner.run(referenceName,
+                       LOOKUP_COUNT,
+                       [&]()
+                       {
+                           jobSystem.parallelFor(LOOKUP_COUNT,
+                                                 LOOKUP_BATCH_SIZE,
+                                                 [&](const uint32_t begin, const uint32_t end)
+                                                 {
+                                                     for (const uint32_t i : std::views::iota(begin, end))
+                                                     {
+                                                         const AssetHandle<BenchmarkAsset> handle = handles[i % ASSET_COUNT];
+                                                         registry.addReference(handle);
+                                                         doNotOptimize(registry.get(handle).value);
+                                                         registry.release(handle);
+                                                     }
+                                                 });
+                       });
+        }
+
+        for (const AssetHandle<BenchmarkAsset> handle : handles)
+        {
+            registry.release(handle);
+        }
+    }
+}
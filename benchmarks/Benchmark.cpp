@@ -0,0 +1,182 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+namespace nether::Benchmark
+{
+    static constexpr uint32_t MIN_SAMPLE_COUNT = 10u;
+
+    static double toNanoseconds(const Clock::duration duration) { return std::chrono::duration<double, std::nano>(duration).count(); }
+
+    std::vector<uint32_t> getThreadCounts()
+    {
+        const uint32_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+        std::vector<uint32_t> threadCounts{};
+        for (uint32_t threadCount = 1u; threadCount < maxThreadCount; threadCount *= 2u)
+        {
+            threadCounts.push_back(threadCount);
+        }
+        threadCounts.push_back(maxThreadCount);
+
+        return threadCounts;
+    }
+
+    bool BenchmarkRunner::isEnabled(const std::string_view name) const { return name.find(m_options.filter) != std::string_view::npos; }
+
+    void BenchmarkRunner::run(const std::string_view name, const uint64_t itemsPerIteration, const std::function<void()>& function)
+    {
+        if (!isEnabled(name))
+        {
+            return;
+        }
+
+        // Warm up (caches, lazily allocated memory), and estimate how many iterations fit in a sample.
+        uint64_t iterationsPerSample{1u};
+        while (true)
+        {
+            const Clock::time_point beginTime = Clock::now();
+            for ([[maybe_unused]] const uint64_t i : std::views::iota(0u, iterationsPerSample))
+            {
+                function();
+            }
+            const Clock::duration duration = Clock::now() - beginTime;
+
+            if (duration >= m_options.sampleDuration / 2)
+            {
+                break;
+            }
+
+            iterationsPerSample *= 2u;
+        }
+
+        std::vector<double> sampleTimes{};
+        sampleTimes.reserve(m_options.sampleCount);
+
+        const Clock::time_point benchmarkBeginTime = Clock::now();
+        while (sampleTimes.size() < m_options.sampleCount)
+        {
+            const Clock::time_point beginTime = Clock::now();
+            for ([[maybe_unused]] const uint64_t i : std::views::iota(0u, iterationsPerSample))
+            {
+                function();
+            }
+            const Clock::time_point endTime = Clock::now();
+
+            sampleTimes.push_back(toNanoseconds(endTime - beginTime) / static_cast<double>(iterationsPerSample));
+
+            if (sampleTimes.size() >= MIN_SAMPLE_COUNT && endTime - benchmarkBeginTime > m_options.maxBenchmarkDuration)
+            {
+                break;
+            }
+        }
+
+        addResult(name, itemsPerIteration, iterationsPerSample, sampleTimes);
+    }
+
+    void BenchmarkRunner::runWithSetup(const std::string_view name, const uint64_t itemsPerIteration, const std::function<void()>& setup, const std::function<void()>& function)
+    {
+        if (!isEnabled(name))
+        {
+            return;
+        }
+
+        // Warm up.
+        setup();
+        function();
+
+        std::vector<double> sampleTimes{};
+        sampleTimes.reserve(m_options.sampleCount);
+
+        const Clock::time_point benchmarkBeginTime = Clock::now();
+        while (sampleTimes.size() < m_options.sampleCount)
+        {
+            setup();
+
+            const Clock::time_point beginTime = Clock::now();
+            function();
+            const Clock::time_point endTime = Clock::now();
+
+            sampleTimes.push_back(toNanoseconds(endTime - beginTime));
+
+            if (sampleTimes.size() >= MIN_SAMPLE_COUNT && endTime - benchmarkBeginTime > m_options.maxBenchmarkDuration)
+            {
+                break;
+            }
+        }
+
+        addResult(name, itemsPerIteration, 1u, sampleTimes);
+    }
+
+    void BenchmarkRunner::addSamples(const std::string_view name, const uint64_t itemsPerIteration, std::vector<double> sampleTimes)
+    {
+        if (!isEnabled(name) || sampleTimes.empty())
+        {
+            return;
+        }
+
+        addResult(name, itemsPerIteration, 1u, sampleTimes);
+    }
+
+    void BenchmarkRunner::addResult(const std::string_view name, const uint64_t itemsPerIteration, const uint64_t iterationsPerSample, std::vector<double>& sampleTimes)
+    {
+        std::ranges::sort(sampleTimes);
+
+        const size_t sampleCount = sampleTimes.size();
+
+        // Nearest rank percentiles.
+        const auto getPercentile = [&](const double percentile)
+        {
+            const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sampleCount)));
+            return sampleTimes[std::clamp<size_t>(rank, 1u, sampleCount) - 1u];
+        };
+
+        BenchmarkResult& result = m_results.emplace_back(BenchmarkResult{
+            .name = std::string(name),
+            .itemsPerIteration = itemsPerIteration,
+            .iterationsPerSample = iterationsPerSample,
+            .sampleCount = static_cast<uint32_t>(sampleCount),
+            .medianTime = getPercentile(50.0),
+            .p99Time = getPercentile(99.0),
+            .meanTime = std::accumulate(sampleTimes.begin(), sampleTimes.end(), 0.0) / static_cast<double>(sampleCount),
+            .minTime = sampleTimes.front(),
+        });
+
+        result.throughput = static_cast<double>(itemsPerIteration) / (result.medianTime * 1e-9);
+
+        std::cout << std::format("{:<52} median {:>12.1f} ns   p99 {:>12.1f} ns   {:>14.0f} items/s\n", result.name, result.medianTime, result.p99Time, result.throughput);
+    }
+
+    void BenchmarkRunner::writeJson(std::ostream& stream) const
+    {
+        const std::string_view buildConfiguration = NETHER_DEBUG_MODE ? "Debug" : (NETHER_SHIPPING_MODE ? "Shipping" : "Release");
+
+        stream << "{\n";
+        stream << std::format("  \"context\": {{\"buildConfiguration\": \"{}\", \"hardwareConcurrency\": {}, \"timeUnit\": \"ns\"}},\n",
+                              buildConfiguration,
+                              std::thread::hardware_concurrency());
+        stream << "  \"benchmarks\": [\n";
+
+        for (const size_t resultIndex : std::views::iota(size_t{0u}, m_results.size()))
+        {
+            const BenchmarkResult& result = m_results[resultIndex];
+
+            // Benchmark names are plain ASCII without quotes, so they need no escaping.
+            stream << std::format("    {{\"name\": \"{}\", \"itemsPerIteration\": {}, \"iterationsPerSample\": {}, \"sampleCount\": {}, \"median\": {:.3f}, \"p99\": {:.3f}, "
+                                  "\"mean\": {:.3f}, \"min\": {:.3f}, \"itemsPerSecond\": {:.3f}}}{}\n",
+                                  result.name,
+                                  result.itemsPerIteration,
+                                  result.iterationsPerSample,
+                                  result.sampleCount,
+                                  result.medianTime,
+                                  result.p99Time,
+                                  result.meanTime,
+                                  result.minTime,
+                                  result.throughput,
+                                  resultIndex + 1u < m_results.size() ? "," : "");
+        }
+
+        stream << "  ]\n";
+        stream << "}\n";
+    }
+}
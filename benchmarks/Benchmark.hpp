@@ -0,0 +1,99 @@
+#pragma once
+
+// Minimal benchmark harness for the CPU side of the engine. A benchmark is timed in samples of several iterations (so each sample is long enough to time reliably), and
+// the statistics are computed over the per iteration time of the samples. Results are printed as a table, and can be written as JSON to compare builds.
+namespace nether::Benchmark
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchmarkOptions
+    {
+        // Only benchmarks whose name contains the filter run.
+        std::string filter{};
+
+        uint32_t sampleCount{100u};
+
+        // Target duration of a sample. Iterations that take longer are timed one by one.
+        Clock::duration sampleDuration{std::chrono::milliseconds(2)};
+
+        // Upper bound on the time spent in a single benchmark. Stops sampling early (with at least 10 samples) when reached.
+        Clock::duration maxBenchmarkDuration{std::chrono::seconds(3)};
+    };
+
+    // Times are per iteration, in nanoseconds.
+    struct BenchmarkResult
+    {
+        std::string name{};
+
+        uint64_t itemsPerIteration{};
+        uint64_t iterationsPerSample{};
+        uint32_t sampleCount{};
+
+        double medianTime{};
+        double p99Time{};
+        double meanTime{};
+        double minTime{};
+
+        // Items per second, at the median time.
+        double throughput{};
+    };
+
+    // Keeps the compiler from optimizing away a value (or the work that computed it).
+    template <typename T> inline void doNotOptimize(const T& value)
+    {
+        static volatile const void* sink{};
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    // 1, 2, 4, ... up to (and including) the number of hardware threads, for benchmarks that scale with the thread count.
+    [[nodiscard]] std::vector<uint32_t> getThreadCounts();
+
+    class BenchmarkRunner
+    {
+      public:
+        explicit BenchmarkRunner(const BenchmarkOptions& options) : m_options(options) {}
+
+        // For setup that is too expensive to do for benchmarks that are filtered out.
+        [[nodiscard]] bool isEnabled(const std::string_view name) const;
+
+        // Calls function repeatedly. itemsPerIteration is the amount of work (entities, draws, bytes, ...) one call does, and is only used for the throughput.
+        void run(const std::string_view name, const uint64_t itemsPerIteration, const std::function<void()>& function);
+
+        // Like run, but calls setup before every iteration, outside of the timed region. Every iteration is timed on its own, so the work should take at least a few
+        // microseconds.
+        void runWithSetup(const std::string_view name, const uint64_t itemsPerIteration, const std::function<void()>& setup, const std::function<void()>& function);
+
+        // For benchmarks that time themselves (e.g the frame replay), where every sample is a single iteration.
+        void addSamples(const std::string_view name, const uint64_t itemsPerIteration, std::vector<double> sampleTimes);
+
+        std::span<const BenchmarkResult> getResults() const { return m_results; }
+
+        void writeJson(std::ostream& stream) const;
+
+      private:
+        void addResult(const std::string_view name, const uint64_t itemsPerIteration, const uint64_t iterationsPerSample, std::vector<double>& sampleTimes);
+
+      private:
+        BenchmarkOptions m_options{};
+        std::vector<BenchmarkResult> m_results{};
+    };
+
+    // Each group registers its benchmarks with the runner (see Main.cpp).
+    void runSceneBenchmarks(BenchmarkRunner& runner);
+    void runRenderingBenchmarks(BenchmarkRunner& runner);
+    void runThreadingBenchmarks(BenchmarkRunner& runner);
+    void runJobSystemBenchmarks(BenchmarkRunner& runner);
+    void runAssetBenchmarks(BenchmarkRunner& runner);
+    void runAssetRegistryBenchmarks(BenchmarkRunner& runner);
+    void runAssetArchiveBenchmarks(BenchmarkRunner& runner);
+
+    // Checks the glTF importer against tinygltf and benchmarks their JSON parse throughput. Then generates a .glb and a .gltf (with a .bin) of about largeAssetSizeInMiB
+    // in the temporary directory, and times (and on Linux, measures the peak memory of) importing them.
+    void runGltfBenchmarks(BenchmarkRunner& runner, const uint64_t largeAssetSizeInMiB);
+
+    void runShaderBenchmarks(BenchmarkRunner& runner);
+
+    // Replays the camera path file, or a orbit around the scene if it is empty.
+    void runReplayBenchmarks(BenchmarkRunner& runner, const std::filesystem::path& cameraPathFile);
+}
@@ -0,0 +1,102 @@
+#include "Pch.hpp"
+
+#include "BenchmarkScene.hpp"
+
+namespace nether::Benchmark
+{
+    BenchmarkScene::BenchmarkScene(GraphicsBackend& graphicsBackend, const BenchmarkSceneDesc& desc)
+    {
+        // Every mesh is a cube (from -1 to 1, like the one in assets/) worth of indices, the null backend only checks that draws stay inside the index buffer.
+        constexpr uint32_t meshIndexCount = 36u;
+
+        m_meshes.resize(desc.meshCount);
+        for (Mesh& mesh : m_meshes)
+        {
+            mesh.indexCount = meshIndexCount;
+            mesh.boundingSphere = math::XMFLOAT4(0.0f, 0.0f, 0.0f, std::sqrt(3.0f));
+            mesh.indexBuffer = graphicsBackend.createIndexBuffer(nullptr, meshIndexCount * sizeof(uint32_t), L"Benchmark index buffer");
+        }
+
+        m_graphicsPipelines.resize(desc.pipelineCount);
+        for (GraphicsPipeline& graphicsPipeline : m_graphicsPipelines)
+        {
+            graphicsPipeline = graphicsBackend.createGraphicsPipeline(Shader{}, Shader{}, L"Benchmark pipeline");
+        }
+
+        std::mt19937 randomEngine(desc.seed);
+        std::uniform_real_distribution<float> angleDistribution(-math::XM_PI, math::XM_PI);
+        std::uniform_real_distribution<float> positionDistribution(-desc.sceneExtent, desc.sceneExtent);
+        std::uniform_real_distribution<float> clusterOffsetDistribution(-desc.clusterRadius, desc.clusterRadius);
+        std::uniform_real_distribution<float> childOffsetDistribution(-desc.childOffset, desc.childOffset);
+        std::uniform_real_distribution<float> scaleDistribution(0.5f, 2.0f);
+        std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+
+        std::vector<math::XMFLOAT3> clusterCenters(desc.clusterCount);
+        for (math::XMFLOAT3& clusterCenter : clusterCenters)
+        {
+            clusterCenter = math::XMFLOAT3{positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+        }
+
+        const auto getRootPosition = [&]()
+        {
+            if (clusterCenters.empty())
+            {
+                return math::XMFLOAT3{positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+            }
+
+            const math::XMFLOAT3& clusterCenter = clusterCenters[std::min(static_cast<size_t>(unitDistribution(randomEngine) * clusterCenters.size()), clusterCenters.size() - 1u)];
+            return math::XMFLOAT3{clusterCenter.x + clusterOffsetDistribution(randomEngine),
+                                  clusterCenter.y + clusterOffsetDistribution(randomEngine),
+                                  clusterCenter.z + clusterOffsetDistribution(randomEngine)};
+        };
+
+        m_scene.reserve(desc.entityCount);
+        m_entities.reserve(desc.entityCount);
+
+        for (const uint32_t entityIndex : std::views::iota(0u, desc.entityCount))
+        {
+            EntityHandle parent{};
+            if (entityIndex > 0u && unitDistribution(randomEngine) >= desc.rootProbability)
+            {
+                const uint32_t parentRange = std::min(entityIndex, 64u);
+                parent = m_entities[entityIndex - 1u - static_cast<uint32_t>(unitDistribution(randomEngine) * static_cast<float>(parentRange - 1u))];
+            }
+
+            const EntityHandle entity = m_scene.createEntity("Benchmark entity", parent);
+            m_entities.push_back(entity);
+
+            const math::XMFLOAT3 translate =
+                parent.isValid() ? math::XMFLOAT3{childOffsetDistribution(randomEngine), childOffsetDistribution(randomEngine), childOffsetDistribution(randomEngine)}
+                                 : getRootPosition();
+
+            const float scale = scaleDistribution(randomEngine);
+            m_scene.setTransform(entity,
+                                 Transform{
+                                     .rotate = {angleDistribution(randomEngine), angleDistribution(randomEngine), angleDistribution(randomEngine)},
+                                     .scale = {scale, scale, scale},
+                                     .translate = translate,
+                                 });
+
+            const uint32_t combination = entityIndex % (desc.meshCount * desc.pipelineCount * desc.textureCount);
+            m_scene.getRenderable(entity) = Renderable{
+                .mesh = &m_meshes[combination % desc.meshCount],
+                .graphicsPipeline = &m_graphicsPipelines[(combination / desc.meshCount) % desc.pipelineCount],
+                .albedoTextureIndex = combination / (desc.meshCount * desc.pipelineCount),
+            };
+        }
+
+        m_scene.updateTransforms();
+    }
+
+    void BenchmarkScene::touchTransforms(const uint32_t stride)
+    {
+        m_touchAngle += 0.001f;
+
+        for (size_t denseIndex = 0u; denseIndex < m_scene.size(); denseIndex += stride)
+        {
+            Transform transform = m_scene.getTransformAtIndex(denseIndex);
+            transform.rotate.y = m_touchAngle;
+            m_scene.setTransformAtIndex(denseIndex, transform);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Scene.hpp"
+#include "GraphicsBackend.hpp"
+
+namespace nether::Benchmark
+{
+    struct BenchmarkSceneDesc
+    {
+        uint32_t entityCount{10000u};
+
+        // Renderables are spread uniformly over every combination of mesh, pipeline and texture.
+        uint32_t meshCount{64u};
+        uint32_t pipelineCount{4u};
+        uint32_t textureCount{8u};
+
+        // Chance of a entity being a root. The others are parented to one of the 64 entities created before them, which gives hierarchies a few levels deep.
+        float rootProbability{0.125f};
+
+        // Roots are spread uniformly over a cube of sceneExtent (half size) around the origin, or, with a non zero clusterCount, placed within clusterRadius of one of
+        // clusterCount random points in that cube. Children are offset from their parent by up to childOffset on each axis.
+        float sceneExtent{25.0f};
+        uint32_t clusterCount{0u};
+        float clusterRadius{4.0f};
+        float childOffset{2.0f};
+
+        uint32_t seed{1u};
+    };
+
+    // Synthetic (stress) scene with random transforms, hierarchy and renderables. The meshes and pipelines are created through the graphics backend (the null backend in
+    // benchmarks), and the scene's transforms are up to date after construction. The same desc always generates the same scene.
+    class BenchmarkScene
+    {
+      public:
+        BenchmarkScene(GraphicsBackend& graphicsBackend, const BenchmarkSceneDesc& desc);
+
+        // The scene holds pointers into the mesh and pipeline arrays.
+        BenchmarkScene(const BenchmarkScene&) = delete;
+        BenchmarkScene& operator=(const BenchmarkScene&) = delete;
+
+        Scene& getScene() { return m_scene; }
+        std::span<const EntityHandle> getEntities() const { return m_entities; }
+
+        // Marks the local transform of every stride-th entity (by dense index) dirty, with a small change so the world matrices differ every call.
+        void touchTransforms(const uint32_t stride);
+
+      private:
+        std::vector<Mesh> m_meshes{};
+        std::vector<GraphicsPipeline> m_graphicsPipelines{};
+
+        Scene m_scene{};
+        std::vector<EntityHandle> m_entities{};
+
+        float m_touchAngle{};
+    };
+}
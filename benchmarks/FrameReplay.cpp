@@ -0,0 +1,161 @@
+#include "Pch.hpp"
+
+#include "FrameReplay.hpp"
+
+#include "AllocationTracker.hpp"
+#include "FrameBuilder.hpp"
+#include "FrameRenderer.hpp"
+#include "NullGraphicsBackend.hpp"
+
+namespace nether::Benchmark
+{
+    // Stages of a frame, in the order they run.
+    enum class ReplayStages : uint8_t
+    {
+        Update,
+        Cull,
+        Sort,
+        Gather,
+        Record,
+        Frame,
+        TotalStages
+    };
+
+    static constexpr std::array<std::string_view, EnumClassValue(ReplayStages::TotalStages)> REPLAY_STAGE_NAMES = {
+        "update",
+        "cull",
+        "sort",
+        "gather",
+        "record",
+        "frame",
+    };
+
+    // Frames before the replay is expected not to allocate anymore (the arenas and arrays have grown to the size of the scene).
+    static constexpr uint32_t WARM_UP_FRAME_COUNT = 3u;
+
+    // The projection of Engine::update, at a 16:9 aspect ratio.
+    static const math::XMMATRIX PROJECTION_MATRIX = math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+    void runFrameReplay(BenchmarkRunner& runner, const std::string_view name, const FrameReplayDesc& desc, const CameraPath& cameraPath)
+    {
+        const bool isAnyStageEnabled =
+            std::ranges::any_of(REPLAY_STAGE_NAMES, [&](const std::string_view stageName) { return runner.isEnabled(std::format("{}/{}", name, stageName)); });
+        if (!isAnyStageEnabled)
+        {
+            return;
+        }
+
+        const std::span<const CameraState> cameraStates = cameraPath.getFrames();
+
+        NullGraphicsBackend graphicsBackend(desc.recordingThreadCount, desc.sceneDesc.entityCount);
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = desc.recordingThreadCount - 1u});
+        ParallelRecorder parallelRecorder(jobSystem);
+
+        BenchmarkScene benchmarkScene(graphicsBackend, desc.sceneDesc);
+        Scene& scene = benchmarkScene.getScene();
+
+        Camera camera{};
+        FrameBuilder frameBuilder{};
+        FrameRenderer frameRenderer{};
+        FramePacket framePacket{};
+        framePacket.arena.reserve(getFramePacketArenaSize(desc.sceneDesc.entityCount));
+
+        std::array<std::vector<double>, EnumClassValue(ReplayStages::TotalStages)> stageTimes{};
+        for (std::vector<double>& times : stageTimes)
+        {
+            times.reserve(cameraStates.size());
+        }
+
+        uint64_t visibleSetHash{FNV_OFFSET_BASIS};
+        uint64_t visibleInstanceCount{};
+        uint64_t drawCount{};
+
+        AllocationTracker::FrameAllocations frameAllocations{};
+        uint64_t steadyStateAllocationCount{};
+
+        for (const size_t frameIndex : std::views::iota(size_t{0u}, cameraStates.size()))
+        {
+            // Every allocation the stages make from here on is a violation, as in the engine.
+            if (frameIndex == WARM_UP_FRAME_COUNT)
+            {
+                AllocationTracker::collectFrame(frameAllocations);
+                AllocationTracker::setSteadyState(true);
+            }
+
+            std::array<Clock::time_point, EnumClassValue(ReplayStages::Frame)> stageEndTimes{};
+
+            const Clock::time_point frameBeginTime = Clock::now();
+
+            framePacket.arena.reset();
+
+            benchmarkScene.touchTransforms(desc.animationStride);
+            scene.updateTransforms();
+
+            camera.setState(cameraStates[frameIndex]);
+            const math::XMMATRIX viewMatrix = camera.getLookAtMatrix();
+            framePacket.sceneData.viewMatrix = viewMatrix;
+            framePacket.sceneData.viewProjectionMatrix = viewMatrix * PROJECTION_MATRIX;
+            stageEndTimes[EnumClassValue(ReplayStages::Update)] = Clock::now();
+
+            frameBuilder.cull(scene, framePacket.sceneData.viewProjectionMatrix);
+            stageEndTimes[EnumClassValue(ReplayStages::Cull)] = Clock::now();
+
+            frameBuilder.buildDraws(scene);
+            stageEndTimes[EnumClassValue(ReplayStages::Sort)] = Clock::now();
+
+            frameBuilder.gatherInstances(scene, framePacket);
+            stageEndTimes[EnumClassValue(ReplayStages::Gather)] = Clock::now();
+
+            frameRenderer.render(graphicsBackend, parallelRecorder, framePacket);
+            stageEndTimes[EnumClassValue(ReplayStages::Record)] = Clock::now();
+
+            Clock::time_point stageBeginTime = frameBeginTime;
+            for (const uint32_t stage : std::views::iota(0u, EnumClassValue(ReplayStages::Frame)))
+            {
+                stageTimes[stage].push_back(std::chrono::duration<double, std::nano>(stageEndTimes[stage] - stageBeginTime).count());
+                stageBeginTime = stageEndTimes[stage];
+            }
+            stageTimes[EnumClassValue(ReplayStages::Frame)].push_back(std::chrono::duration<double, std::nano>(stageBeginTime - frameBeginTime).count());
+
+            visibleSetHash = hashBytes(std::as_bytes(frameBuilder.getVisibleIndices()), visibleSetHash);
+            visibleInstanceCount += framePacket.instances.size();
+            drawCount += framePacket.draws.size();
+        }
+
+        if (AllocationTracker::isSteadyState())
+        {
+            AllocationTracker::collectFrame(frameAllocations);
+            AllocationTracker::setSteadyState(false);
+
+            steadyStateAllocationCount = frameAllocations.getViolationCount();
+        }
+
+        const double frameCount = static_cast<double>(cameraStates.size());
+        std::cout << std::format("{} : {} frames, {:.1f} visible instances and {:.1f} draws per frame, visible set hash {:016x}, {} heap allocations in steady state\n",
+                                 name,
+                                 cameraStates.size(),
+                                 static_cast<double>(visibleInstanceCount) / frameCount,
+                                 static_cast<double>(drawCount) / frameCount,
+                                 visibleSetHash,
+                                 steadyStateAllocationCount);
+
+        // The frame loop must not allocate once warmed up. Only checked when allocation tracking is compiled in (not in Shipping).
+        if (steadyStateAllocationCount > 0u)
+        {
+            for (const AllocationTracker::SubsystemAllocations& subsystem : std::span(frameAllocations.subsystems).first(frameAllocations.subsystemCount))
+            {
+                if (subsystem.violationCount > 0u)
+                {
+                    std::cout << std::format("  {} : {} allocations, {} bytes\n", subsystem.name, subsystem.violationCount, subsystem.allocatedBytes);
+                }
+            }
+
+            fatalError(std::format("{} allocated in steady state frames.", name));
+        }
+
+        for (const uint32_t stage : std::views::iota(0u, EnumClassValue(ReplayStages::TotalStages)))
+        {
+            runner.addSamples(std::format("{}/{}", name, REPLAY_STAGE_NAMES[stage]), 1u, std::move(stageTimes[stage]));
+        }
+    }
+}
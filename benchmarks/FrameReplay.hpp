@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+
+#include "CameraPath.hpp"
+
+namespace nether::Benchmark
+{
+    struct FrameReplayDesc
+    {
+        BenchmarkSceneDesc sceneDesc{};
+
+        // Every animationStride-th entity (by dense index) is moved every frame, so the transform update has work to do.
+        uint32_t animationStride{100u};
+
+        // Threads the draws are recorded on (including the replaying thread).
+        uint32_t recordingThreadCount{1u};
+    };
+
+    // Replays a camera path over a stress scene, and runs every stage of a frame on it : the transform update, culling, sorting the visible renderables into draws,
+    // gathering the instance data and recording the draws (through the null backend). The stages run one after the other on the calling thread (in the engine, recording
+    // overlaps the simulation of the next frame), so that each of them can be timed on its own.
+    // Each stage, and the whole frame, is reported as a benchmark named "<name>/<stage>" with one sample per frame, and items being frames. The scene and camera path fully
+    // determine the frames, which is checked by printing a hash of the visible set. After a few frames of warm up, any heap allocation made by the stages is an error (when
+    // allocation tracking is compiled in, see AllocationTracker.hpp).
+    void runFrameReplay(BenchmarkRunner& runner, const std::string_view name, const FrameReplayDesc& desc, const CameraPath& cameraPath);
+}
@@ -0,0 +1,558 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+#include "AssetLoader.hpp"
+#include "GltfImporter.hpp"
+#include "JsonReader.hpp"
+
+#include <tiny_gltf.h>
+
+namespace nether::Benchmark
+{
+    static constexpr std::array<std::string_view, 2u> SAMPLE_MODEL_PATHS = {
+        "assets/Cube/glTF/Cube.gltf",
+        "assets/Suzanne/glTF/Suzanne.gltf",
+    };
+
+    // The JSON of a large level exported as a single file : SCENE_MESH_COUNT meshes (with 4 accessors and buffer views each) and SCENE_NODE_COUNT nodes. The accessors
+    // all view the same vertex, so the file is almost all JSON.
+    static constexpr uint32_t SCENE_MESH_COUNT = 50000u;
+    static constexpr uint32_t SCENE_NODE_COUNT = 200000u;
+    static constexpr uint32_t SCENE_MATERIAL_COUNT = 16u;
+
+    // Importing a large asset takes seconds, so only a few samples are taken.
+    static constexpr uint32_t LARGE_ASSET_SAMPLE_COUNT = 3u;
+
+    // Interleaved position, normal and texture coordinate (32 bytes), and a 32 bit index per vertex. Which is the size of the vertex in MeshData as well.
+    static constexpr uint64_t VERTEX_STRIDE = 32u;
+    static constexpr uint64_t BYTES_PER_VERTEX = VERTEX_STRIDE + sizeof(uint32_t);
+
+    // The length of a .glb is 32 bit, with room left for the headers and the JSON.
+    static constexpr uint64_t MAX_GLB_BUFFER_SIZE = std::numeric_limits<uint32_t>::max() - 65536u;
+
+    static std::string getLargeAssetJson(const uint64_t vertexCount, const std::string_view bufferUri)
+    {
+        const uint64_t vertexDataSize = vertexCount * VERTEX_STRIDE;
+        const uint64_t indexDataSize = vertexCount * sizeof(uint32_t);
+
+        const std::string uri = bufferUri.empty() ? std::string{} : std::format(R"(,"uri":"{}")", bufferUri);
+
+        return std::format(R"({{"asset":{{"version":"2.0"}},"scene":0,"scenes":[{{"nodes":[0]}}],"nodes":[{{"mesh":0}}],)"
+                           R"("meshes":[{{"primitives":[{{"attributes":{{"POSITION":0,"NORMAL":1,"TEXCOORD_0":2}},"indices":3}}]}}],)"
+                           R"("buffers":[{{"byteLength":{}{}}}],)"
+                           R"("bufferViews":[{{"buffer":0,"byteLength":{},"byteStride":{},"target":34962}},{{"buffer":0,"byteOffset":{},"byteLength":{},"target":34963}}],)"
+                           R"("accessors":[{{"bufferView":0,"componentType":5126,"count":{},"type":"VEC3","min":[0,0,0],"max":[1024,1024,1]}},)"
+                           R"({{"bufferView":0,"byteOffset":12,"componentType":5126,"count":{},"type":"VEC3"}},)"
+                           R"({{"bufferView":0,"byteOffset":24,"componentType":5126,"count":{},"type":"VEC2"}},)"
+                           R"({{"bufferView":1,"componentType":5125,"count":{},"type":"SCALAR"}}]}})",
+                           vertexDataSize + indexDataSize,
+                           uri,
+                           vertexDataSize,
+                           VERTEX_STRIDE,
+                           vertexDataSize,
+                           indexDataSize,
+                           vertexCount,
+                           vertexCount,
+                           vertexCount,
+                           vertexCount);
+    }
+
+    // A grid of vertices drawn as a triangle list, written in blocks so generating a multi gigabyte asset does not need that much memory.
+    static void writeLargeAssetBuffer(std::ofstream& file, const uint64_t vertexCount)
+    {
+        static constexpr uint64_t BLOCK_VERTEX_COUNT = 65536u;
+
+        struct Vertex
+        {
+            math::XMFLOAT3 position{};
+            math::XMFLOAT3 normal{};
+            math::XMFLOAT2 textureCoord{};
+        };
+
+        std::vector<Vertex> vertices(BLOCK_VERTEX_COUNT);
+        for (uint64_t firstVertex = 0u; firstVertex < vertexCount; firstVertex += BLOCK_VERTEX_COUNT)
+        {
+            const uint64_t blockVertexCount = std::min(BLOCK_VERTEX_COUNT, vertexCount - firstVertex);
+            for (const uint64_t i : std::views::iota(0u, blockVertexCount))
+            {
+                const uint64_t vertex = firstVertex + i;
+                const float x = static_cast<float>(vertex % 1024u);
+                const float y = static_cast<float>((vertex / 1024u) % 1024u);
+
+                vertices[i] = Vertex{{x, y, static_cast<float>(vertex % 2u)}, {0.0f, 0.0f, 1.0f}, {x / 1024.0f, y / 1024.0f}};
+            }
+
+            file.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(blockVertexCount * sizeof(Vertex)));
+        }
+
+        std::vector<uint32_t> indices(BLOCK_VERTEX_COUNT);
+        for (uint64_t firstIndex = 0u; firstIndex < vertexCount; firstIndex += BLOCK_VERTEX_COUNT)
+        {
+            const uint64_t blockIndexCount = std::min(BLOCK_VERTEX_COUNT, vertexCount - firstIndex);
+            std::iota(indices.begin(), indices.begin() + static_cast<ptrdiff_t>(blockIndexCount), static_cast<uint32_t>(firstIndex));
+
+            file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(blockIndexCount * sizeof(uint32_t)));
+        }
+    }
+
+    static void writeLargeGlb(const std::filesystem::path& glbPath, const uint64_t vertexCount)
+    {
+        std::string json = getLargeAssetJson(vertexCount, {});
+        json.resize((json.size() + 3u) & ~size_t{3u}, ' ');
+
+        const uint32_t bufferSize = static_cast<uint32_t>(vertexCount * BYTES_PER_VERTEX);
+        const std::array<uint32_t, 3u> header = {0x46546C67u, 2u, static_cast<uint32_t>(12u + 8u + json.size() + 8u + bufferSize)};
+        const std::array<uint32_t, 2u> jsonChunkHeader = {static_cast<uint32_t>(json.size()), 0x4E4F534Au};
+        const std::array<uint32_t, 2u> binaryChunkHeader = {bufferSize, 0x004E4942u};
+
+        std::ofstream file(glbPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+        file.write(reinterpret_cast<const char*>(jsonChunkHeader.data()), sizeof(jsonChunkHeader));
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+        file.write(reinterpret_cast<const char*>(binaryChunkHeader.data()), sizeof(binaryChunkHeader));
+        writeLargeAssetBuffer(file, vertexCount);
+
+        if (!file.good())
+        {
+            fatalError(std::format("Failed to write the large asset with path : {}", glbPath.string()));
+        }
+    }
+
+    static void writeLargeGltf(const std::filesystem::path& gltfPath, const uint64_t vertexCount)
+    {
+        const std::filesystem::path binPath = std::filesystem::path(gltfPath).replace_extension(".bin");
+
+        std::ofstream(gltfPath, std::ios::trunc) << getLargeAssetJson(vertexCount, binPath.filename().string());
+
+        std::ofstream binFile(binPath, std::ios::binary | std::ios::trunc);
+        writeLargeAssetBuffer(binFile, vertexCount);
+
+        if (!binFile.good())
+        {
+            fatalError(std::format("Failed to write the large asset with path : {}", binPath.string()));
+        }
+    }
+
+#ifdef __linux__
+    // In bytes, for the kB values of /proc/self/status (e.g. "VmHWM", the peak resident set size).
+    static uint64_t readProcessStatus(const std::string_view key)
+    {
+        std::ifstream status("/proc/self/status");
+
+        std::string line{};
+        while (std::getline(status, line))
+        {
+            if (line.starts_with(key) && line.size() > key.size() && line[key.size()] == ':')
+            {
+                return std::stoull(line.substr(key.size() + 1u)) * 1024u;
+            }
+        }
+
+        return 0u;
+    }
+
+    // Peak resident set size while calling function, above the resident set size before it. Resetting the peak does not need any privileges.
+    static uint64_t measurePeakResidentSize(const std::function<void()>& function)
+    {
+        std::ofstream("/proc/self/clear_refs") << "5";
+        const uint64_t residentSize = readProcessStatus("VmRSS");
+
+        function();
+
+        const uint64_t peakResidentSize = readProcessStatus("VmHWM");
+        return peakResidentSize > residentSize ? peakResidentSize - residentSize : 0u;
+    }
+#endif
+
+    static std::string getSceneJson()
+    {
+        std::string json = R"({"asset":{"version":"2.0","generator":"NetherBenchmarks"},"scene":0,)"
+                           "\n"
+                           R"("buffers":[{"byteLength":12,"uri":"data:application/octet-stream;base64,AAAAAAAAAAAAAAAA"}],)";
+
+        const auto appendArray = [&](const std::string_view key, const uint32_t count, const auto& appendElement)
+        {
+            json += std::format("\n\"{}\":[", key);
+            for (const uint32_t i : std::views::iota(0u, count))
+            {
+                json += i == 0u ? "\n    " : ",\n    ";
+                appendElement(i);
+            }
+
+            json += "],";
+        };
+
+        appendArray("bufferViews",
+                    SCENE_MESH_COUNT * 4u,
+                    [&](const uint32_t i)
+                    {
+                        static constexpr std::array<uint32_t, 4u> byteLengths = {12u, 12u, 8u, 4u};
+                        json += std::format(R"({{"buffer":0,"byteLength":{}}})", byteLengths[i % 4u]);
+                    });
+
+        appendArray("accessors",
+                    SCENE_MESH_COUNT * 4u,
+                    [&](const uint32_t i)
+                    {
+                        switch (i % 4u)
+                        {
+                            case 0u:
+                                json += std::format(R"({{"bufferView":{},"componentType":5126,"count":1,"type":"VEC3","min":[0.0,0.0,0.0],"max":[0.0,0.0,0.0]}})",
+                                                    i);
+                                break;
+                            case 1u:
+                                json += std::format(R"({{"bufferView":{},"componentType":5126,"count":1,"type":"VEC3"}})", i);
+                                break;
+                            case 2u:
+                                json += std::format(R"({{"bufferView":{},"componentType":5126,"count":1,"type":"VEC2"}})", i);
+                                break;
+                            default:
+                                json += std::format(R"({{"bufferView":{},"componentType":5125,"count":1,"type":"SCALAR"}})", i);
+                                break;
+                        }
+                    });
+
+        appendArray("materials",
+                    SCENE_MATERIAL_COUNT,
+                    [&](const uint32_t i)
+                    {
+                        json += std::format(R"({{"name":"Material{}","pbrMetallicRoughness":{{"baseColorFactor":[0.8,0.8,0.8,1.0],"metallicFactor":0.0,"roughnessFactor":0.5}}}})",
+                                            i);
+                    });
+
+        appendArray("meshes",
+                    SCENE_MESH_COUNT,
+                    [&](const uint32_t i)
+                    {
+                        json += std::format(R"({{"name":"Mesh{}","primitives":[{{"attributes":{{"POSITION":{},"NORMAL":{},"TEXCOORD_0":{}}},"indices":{},"material":{}}}]}})",
+                                            i,
+                                            i * 4u,
+                                            i * 4u + 1u,
+                                            i * 4u + 2u,
+                                            i * 4u + 3u,
+                                            i % SCENE_MATERIAL_COUNT);
+                    });
+
+        appendArray("nodes",
+                    SCENE_NODE_COUNT,
+                    [&](const uint32_t i)
+                    {
+                        json += std::format(R"({{"name":"Node{}","mesh":{},"translation":[{:.3f},{:.3f},{:.3f}],"rotation":[0.0,0.0,0.0,1.0],"scale":[1.0,1.0,1.0]}})",
+                                            i,
+                                            i % SCENE_MESH_COUNT,
+                                            static_cast<float>(i % 512u) * 2.5f,
+                                            static_cast<float>((i / 512u) % 512u) * 2.5f,
+                                            static_cast<float>(i / (512u * 512u)) * 2.5f);
+                    });
+
+        json += "\n\"scenes\":[{\"nodes\":[";
+        for (const uint32_t i : std::views::iota(0u, SCENE_NODE_COUNT))
+        {
+            json += std::format("{}{}", i == 0u ? "" : ",", i);
+        }
+
+        json += "]}]}\n";
+
+        return json;
+    }
+
+    // The arrays the importer reads against the ones of tinygltf, and the mesh decoded by each. A difference is a fatal error.
+    static void checkConformance(const std::string_view name, const tinygltf::Model& model, const GltfModel& gltfModel)
+    {
+        static constexpr std::array<int32_t, 7u> tinyGltfTypes = {
+            TINYGLTF_TYPE_SCALAR,
+            TINYGLTF_TYPE_VEC2,
+            TINYGLTF_TYPE_VEC3,
+            TINYGLTF_TYPE_VEC4,
+            TINYGLTF_TYPE_MAT2,
+            TINYGLTF_TYPE_MAT3,
+            TINYGLTF_TYPE_MAT4,
+        };
+
+        // tinygltf uses -1 for indices that are not set.
+        const auto isSameIndex = [](const int32_t index, const uint32_t gltfIndex) { return index < 0 ? gltfIndex == ~0u : static_cast<uint32_t>(index) == gltfIndex; };
+
+        bool isConformant = model.buffers.size() == gltfModel.buffers.size() && model.bufferViews.size() == gltfModel.bufferViews.size() &&
+                            model.accessors.size() == gltfModel.accessors.size() && model.meshes.size() == gltfModel.meshes.size() &&
+                            model.nodes.size() == gltfModel.nodes.size();
+
+        for (size_t i = 0u; isConformant && i < model.buffers.size(); ++i)
+        {
+            const std::span<const std::byte> data = std::as_bytes(std::span(model.buffers[i].data));
+            isConformant = data.size() >= gltfModel.buffers[i].byteLength && std::ranges::equal(data.first(gltfModel.buffers[i].byteLength), gltfModel.buffers[i].data);
+        }
+
+        for (size_t i = 0u; isConformant && i < model.bufferViews.size(); ++i)
+        {
+            const tinygltf::BufferView& bufferView = model.bufferViews[i];
+            const GltfBufferView& gltfBufferView = gltfModel.bufferViews[i];
+
+            isConformant = isSameIndex(bufferView.buffer, gltfBufferView.buffer) && bufferView.byteOffset == gltfBufferView.byteOffset &&
+                           bufferView.byteLength == gltfBufferView.byteLength && bufferView.byteStride == gltfBufferView.byteStride;
+        }
+
+        for (size_t i = 0u; isConformant && i < model.accessors.size(); ++i)
+        {
+            const tinygltf::Accessor& accessor = model.accessors[i];
+            const GltfAccessor& gltfAccessor = gltfModel.accessors[i];
+
+            isConformant = isSameIndex(accessor.bufferView, gltfAccessor.bufferView) && accessor.byteOffset == gltfAccessor.byteOffset &&
+                           accessor.count == gltfAccessor.count && accessor.componentType == static_cast<int32_t>(gltfAccessor.componentType) &&
+                           accessor.type == tinyGltfTypes[EnumClassValue(gltfAccessor.type)];
+        }
+
+        for (size_t i = 0u; isConformant && i < model.meshes.size(); ++i)
+        {
+            const std::vector<tinygltf::Primitive>& primitives = model.meshes[i].primitives;
+            const GltfMesh& gltfMesh = gltfModel.meshes[i];
+
+            isConformant = primitives.size() == gltfMesh.primitiveCount;
+            for (size_t j = 0u; isConformant && j < primitives.size(); ++j)
+            {
+                const GltfPrimitive& gltfPrimitive = gltfModel.primitives[gltfMesh.firstPrimitive + j];
+
+                const auto getAttribute = [&](const std::string& attributeName)
+                {
+                    const auto attribute = primitives[j].attributes.find(attributeName);
+                    return attribute != primitives[j].attributes.end() ? attribute->second : -1;
+                };
+
+                isConformant = isSameIndex(getAttribute("POSITION"), gltfPrimitive.position) && isSameIndex(getAttribute("NORMAL"), gltfPrimitive.normal) &&
+                               isSameIndex(getAttribute("TEXCOORD_0"), gltfPrimitive.textureCoord) && isSameIndex(primitives[j].indices, gltfPrimitive.indices);
+            }
+        }
+
+        for (size_t i = 0u; isConformant && i < model.nodes.size(); ++i)
+        {
+            isConformant = isSameIndex(model.nodes[i].mesh, gltfModel.nodes[i].mesh);
+        }
+
+        if (isConformant)
+        {
+            const MeshData meshData = decodeMeshData(model);
+            const MeshData gltfMeshData = decodeMeshData(gltfModel);
+
+            const auto isSameData = [](const auto& a, const auto& b) { return std::ranges::equal(std::as_bytes(std::span(a)), std::as_bytes(std::span(b))); };
+
+            isConformant = isSameData(meshData.positions, gltfMeshData.positions) && isSameData(meshData.textureCoords, gltfMeshData.textureCoords) &&
+                           isSameData(meshData.normals, gltfMeshData.normals) && meshData.indices == gltfMeshData.indices;
+        }
+
+        if (!isConformant)
+        {
+            fatalError(std::format("The glTF importer does not match tinygltf on {}.", name));
+        }
+    }
+
+    static void checkFileConformance(const std::string& modelPath)
+    {
+        tinygltf::Model model{};
+        loadGltfModel(modelPath, model);
+
+        const MappedFile file(modelPath);
+
+        GltfModel gltfModel{};
+        importGltf(file.getData(), std::filesystem::path(modelPath).parent_path().generic_string(), gltfModel);
+
+        checkConformance(modelPath, model, gltfModel);
+    }
+
+    static void printParseThroughput(const BenchmarkRunner& runner, const std::string_view name)
+    {
+        const auto result = std::ranges::find(runner.getResults(), name, &BenchmarkResult::name);
+        if (result != runner.getResults().end())
+        {
+            std::cout << std::format("{} : {:.1f} MB/s", name, result->throughput / 1e6) << std::endl;
+        }
+    }
+
+    // Parse throughput of the tokenizer alone, of the importer and of tinygltf, in bytes of JSON per second. The importer and tinygltf are checked against each other
+    // first, on the sample assets, on small generated .glb / .gltf files and on the scene.
+    static void runGltfParseBenchmarks(BenchmarkRunner& runner)
+    {
+        const std::array<std::string_view, 3u> parsers = {"tokenizer", "importer", "tinygltf"};
+        if (!std::ranges::any_of(parsers, [&](const std::string_view parser) { return runner.isEnabled(std::format("Gltf/parse/scene/{}", parser)); }))
+        {
+            return;
+        }
+
+        for (const std::string_view modelPath : SAMPLE_MODEL_PATHS)
+        {
+            if (std::filesystem::exists(modelPath))
+            {
+                checkFileConformance(std::string(modelPath));
+            }
+        }
+
+        for (const std::string_view fileName : {"NetherBenchmarksConformance.glb", "NetherBenchmarksConformance.gltf"})
+        {
+            const std::filesystem::path filePath = std::filesystem::temp_directory_path() / fileName;
+            if (filePath.extension() == ".glb")
+            {
+                writeLargeGlb(filePath, 3000u);
+            }
+            else
+            {
+                writeLargeGltf(filePath, 3000u);
+            }
+
+            checkFileConformance(filePath.string());
+
+            std::filesystem::remove(filePath);
+            if (filePath.extension() == ".gltf")
+            {
+                std::filesystem::remove(std::filesystem::path(filePath).replace_extension(".bin"));
+            }
+        }
+
+        const std::string sceneJson = getSceneJson();
+        const std::span<const std::byte> sceneFile = std::as_bytes(std::span(sceneJson));
+
+        {
+            tinygltf::Model model{};
+            parseGltfModel(sceneFile, {}, model);
+
+            GltfModel gltfModel{};
+            importGltf(sceneFile, {}, gltfModel);
+
+            checkConformance("the generated scene", model, gltfModel);
+        }
+
+        std::cout << std::format("The glTF importer matches tinygltf, the generated scene is {} MB of JSON.", sceneJson.size() / 1000000u) << std::endl;
+
+        std::vector<uint64_t> tokens{};
+        tokens.reserve(JsonTokenizer::WINDOW_SIZE + 1u);
+
+        runner.run("Gltf/parse/scene/tokenizer",
+                   sceneJson.size(),
+                   [&]()
+                   {
+                       JsonTokenizer tokenizer(sceneJson);
+
+                       uint64_t tokenCount{};
+                       bool isTokenizing{true};
+                       while (isTokenizing)
+                       {
+                           tokens.clear();
+                           isTokenizing = tokenizer.tokenizeWindow(tokens);
+                           tokenCount += tokens.size();
+                       }
+
+                       doNotOptimize(tokenCount);
+                   });
+
+        runner.run("Gltf/parse/scene/importer",
+                   sceneJson.size(),
+                   [&]()
+                   {
+                       GltfModel gltfModel{};
+                       importGltf(sceneFile, {}, gltfModel);
+                       doNotOptimize(gltfModel.nodes.size());
+                   });
+
+        runner.run("Gltf/parse/scene/tinygltf",
+                   sceneJson.size(),
+                   [&]()
+                   {
+                       tinygltf::Model model{};
+                       parseGltfModel(sceneFile, {}, model);
+                       doNotOptimize(model.nodes.size());
+                   });
+
+        for (const std::string_view parser : parsers)
+        {
+            printParseThroughput(runner, std::format("Gltf/parse/scene/{}", parser));
+        }
+    }
+
+    void runGltfBenchmarks(BenchmarkRunner& runner, const uint64_t largeAssetSizeInMiB)
+    {
+        runGltfParseBenchmarks(runner);
+
+        // Loading a mesh the way Engine::createMesh used to (tinygltf copies every buffer into a std::vector), against the importer (buffers are views of the mapped files).
+        const std::array<std::string_view, 2u> fileNames = {"NetherBenchmarksLarge.glb", "NetherBenchmarksLarge.gltf"};
+
+        const auto getName = [&](const std::string_view fileName, const std::string_view importer)
+        { return std::format("Gltf/large/{}/{}MiB/{}", std::filesystem::path(fileName).extension().string().substr(1u), largeAssetSizeInMiB, importer); };
+
+        const bool isEnabled = std::ranges::any_of(fileNames,
+                                                   [&](const std::string_view fileName)
+                                                   { return runner.isEnabled(getName(fileName, "tinygltf")) || runner.isEnabled(getName(fileName, "importer")); });
+        if (!isEnabled)
+        {
+            return;
+        }
+
+        // A multiple of 3 vertices, so they are whole triangles.
+        const uint64_t vertexCount = std::min(largeAssetSizeInMiB * 1024u * 1024u, MAX_GLB_BUFFER_SIZE) / BYTES_PER_VERTEX / 3u * 3u;
+        const uint64_t meshDataSize = vertexCount * BYTES_PER_VERTEX;
+
+        for (const std::string_view fileName : fileNames)
+        {
+            const std::filesystem::path filePath = std::filesystem::temp_directory_path() / fileName;
+            if (filePath.extension() == ".glb")
+            {
+                writeLargeGlb(filePath, vertexCount);
+            }
+            else
+            {
+                writeLargeGltf(filePath, vertexCount);
+            }
+
+            const std::string modelPath = filePath.string();
+
+            const auto loadWithTinyGltf = [&]()
+            {
+                tinygltf::Model model{};
+                loadGltfModel(modelPath, model);
+
+                const MeshData meshData = decodeMeshData(model);
+                doNotOptimize(meshData.indices.back());
+            };
+
+            const auto loadWithImporter = [&]()
+            {
+                const MeshData meshData = loadMeshData(modelPath);
+                doNotOptimize(meshData.indices.back());
+            };
+
+            for (const auto& [importer, load] : {std::pair<std::string_view, std::function<void()>>{"tinygltf", loadWithTinyGltf}, {"importer", loadWithImporter}})
+            {
+                const std::string name = getName(fileName, importer);
+                if (!runner.isEnabled(name))
+                {
+                    continue;
+                }
+
+                std::vector<double> sampleTimes{};
+                for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, LARGE_ASSET_SAMPLE_COUNT))
+                {
+                    const Clock::time_point beginTime = Clock::now();
+                    load();
+                    sampleTimes.push_back(std::chrono::duration<double, std::nano>(Clock::now() - beginTime).count());
+                }
+
+                runner.addSamples(name, meshDataSize, std::move(sampleTimes));
+
+                // Pages of the mapped file count as resident once they are read, but they are clean and shared with the page cache, so the kernel can drop them
+                // under memory pressure. The copies tinygltf makes can not be.
+#ifdef __linux__
+                const uint64_t peakResidentSize = measurePeakResidentSize(load);
+                std::cout << std::format("{} : peak resident set size {} MiB ({:.2f}x the {} MiB of MeshData).",
+                                         name,
+                                         peakResidentSize / (1024u * 1024u),
+                                         static_cast<double>(peakResidentSize) / static_cast<double>(meshDataSize),
+                                         meshDataSize / (1024u * 1024u))
+                          << std::endl;
+#endif
+            }
+
+            std::filesystem::remove(filePath);
+            if (filePath.extension() == ".gltf")
+            {
+                std::filesystem::remove(std::filesystem::path(filePath).replace_extension(".bin"));
+            }
+        }
+    }
+}
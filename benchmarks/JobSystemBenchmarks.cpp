@@ -0,0 +1,186 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+#include "JobSystem.hpp"
+
+namespace nether::Benchmark
+{
+    static constexpr uint32_t JOB_COUNT = 1024u;
+    static constexpr uint32_t PARALLEL_FOR_ITEM_COUNT = 1024u * 1024u;
+    static constexpr uint32_t FIBONACCI_INPUT = 20u;
+    static constexpr uint32_t FIBONACCI_SERIAL_CUTOFF = 8u;
+    static constexpr uint32_t TASK_COUNT = 256u;
+
+    static void emptyJob([[maybe_unused]] void* const data) {}
+
+    static uint64_t fibonacci(const uint32_t n) { return n < 2u ? n : fibonacci(n - 1u) + fibonacci(n - 2u); }
+
+    // Fork / join, every level waits for the job it forked from inside a job.
+    static uint64_t parallelFibonacci(JobSystem& jobSystem, const uint32_t n)
+    {
+        if (n < FIBONACCI_SERIAL_CUTOFF)
+        {
+            return fibonacci(n);
+        }
+
+        uint64_t first{};
+        JobCounter counter{};
+        jobSystem.schedule([&]() { first = parallelFibonacci(jobSystem, n - 1u); }, &counter);
+
+        const uint64_t second = parallelFibonacci(jobSystem, n - 2u);
+        jobSystem.wait(counter);
+
+        return first + second;
+    }
+
+    static Task<uint32_t> incrementOnWorker(JobSystem& jobSystem, const uint32_t value)
+    {
+        co_await jobSystem.schedule();
+        co_return value + 1u;
+    }
+
+    // Each step awaits the previous one, and hops to a worker.
+    static Task<uint32_t> runTaskChain(JobSystem& jobSystem, const uint32_t length)
+    {
+        uint32_t value{};
+        for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, length))
+        {
+            value = co_await incrementOnWorker(jobSystem, value);
+        }
+
+        co_return value;
+    }
+
+    static Task<uint64_t> sumOnWorker(JobSystem& jobSystem, const uint32_t begin, const uint32_t end)
+    {
+        co_await jobSystem.schedule();
+
+        uint64_t sum{};
+        for (const uint32_t i : std::views::iota(begin, end))
+        {
+            sum += i;
+        }
+
+        co_return sum;
+    }
+
+    static Task<uint64_t> runWhenAll(JobSystem& jobSystem, const uint32_t taskCount)
+    {
+        std::vector<Task<uint64_t>> tasks{};
+        tasks.reserve(taskCount);
+        for (const uint32_t i : std::views::iota(0u, taskCount))
+        {
+            tasks.push_back(sumOnWorker(jobSystem, i * 1024u, (i + 1u) * 1024u));
+        }
+
+        co_await jobSystem.whenAll(std::span(tasks));
+
+        uint64_t sum{};
+        for (Task<uint64_t>& task : tasks)
+        {
+            sum += task.getResult();
+        }
+
+        co_return sum;
+    }
+
+    void runJobSystemBenchmarks(BenchmarkRunner& runner)
+    {
+        std::vector<float> values(PARALLEL_FOR_ITEM_COUNT, 1.0f);
+
+        for (const uint32_t threadCount : getThreadCounts())
+        {
+            // The calling thread counts as one of the threads, as it runs jobs while it waits.
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = threadCount - 1u});
+
+            // Scheduling overhead, with allocated jobs and with jobs the caller owns.
+            runner.run(std::format("JobSystem/schedule/1024/threads:{}", threadCount),
+                       JOB_COUNT,
+                       [&]()
+                       {
+                           JobCounter counter{};
+                           for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, JOB_COUNT))
+                           {
+                               jobSystem.schedule([]() {}, &counter);
+                           }
+
+                           jobSystem.wait(counter);
+                       });
+
+            std::vector<Job> jobs(JOB_COUNT);
+            runner.run(std::format("JobSystem/submit/1024/threads:{}", threadCount),
+                       JOB_COUNT,
+                       [&]()
+                       {
+                           JobCounter counter{};
+                           for (Job& job : jobs)
+                           {
+                               job = Job{.function = emptyJob, .counter = &counter};
+                               jobSystem.submit(job);
+                           }
+
+                           jobSystem.wait(counter);
+                       });
+
+            // A dependency chain, every job is scheduled once the previous one finished.
+            runner.run(std::format("JobSystem/submitAfter/chain:1024/threads:{}", threadCount),
+                       JOB_COUNT,
+                       [&]()
+                       {
+                           std::vector<JobCounter> counters(JOB_COUNT);
+                           for (const uint32_t i : std::views::iota(0u, JOB_COUNT))
+                           {
+                               jobs[i] = Job{.function = emptyJob, .counter = &counters[i]};
+                               if (i == 0u)
+                               {
+                                   jobSystem.submit(jobs[i]);
+                               }
+                               else
+                               {
+                                   jobSystem.submitAfter(counters[i - 1u], jobs[i]);
+                               }
+                           }
+
+                           jobSystem.wait(counters.back());
+                       });
+
+            // A streaming kernel, and a range small enough that the overhead shows.
+            runner.run(std::format("JobSystem/parallelFor/1M/threads:{}", threadCount),
+                       values.size(),
+                       [&]()
+                       {
+                           jobSystem.parallelFor(PARALLEL_FOR_ITEM_COUNT,
+                                                 1024u,
+                                                 [&](const uint32_t begin, const uint32_t end)
+                                                 {
+                                                     for (const uint32_t i : std::views::iota(begin, end))
+                                                     {
+                                                         values[i] = values[i] * 0.5f + 1.0f;
+                                                     }
+                                                 });
+                       });
+
+            runner.run(std::format("JobSystem/parallelFor/256/threads:{}", threadCount),
+                       256u,
+                       [&]()
+                       {
+                           jobSystem.parallelFor(256u,
+                                                 16u,
+                                                 [&](const uint32_t begin, const uint32_t end)
+                                                 {
+                                                     for (const uint32_t i : std::views::iota(begin, end))
+                                                     {
+                                                         values[i] += 1.0f;
+                                                     }
+                                                 });
+                       });
+
+            runner.run(std::format("JobSystem/fibonacci/20/threads:{}", threadCount), 1u, [&]() { doNotOptimize(parallelFibonacci(jobSystem, FIBONACCI_INPUT)); });
+
+            // Coroutine overhead: a task per step, and fanning out to many tasks.
+            runner.run(std::format("Task/chain/1024/threads:{}", threadCount), JOB_COUNT, [&]() { doNotOptimize(jobSystem.runTask(runTaskChain(jobSystem, JOB_COUNT))); });
+            runner.run(std::format("Task/whenAll/256/threads:{}", threadCount), TASK_COUNT, [&]() { doNotOptimize(jobSystem.runTask(runWhenAll(jobSystem, TASK_COUNT))); });
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+// Usage : NetherBenchmarks [--filter <substring>] [--samples <count>] [--json <path>] [--camera-path <path>] [--large-asset-size <MiB>]
+// Run from the repository root, the asset and shader benchmarks load files from assets/ and shaders/. The camera path is replayed by the frame replay benchmarks (record
+// one with the "Camera path" window of the engine). The glTF benchmarks generate a large asset of the given size (256 MiB by default, pass e.g. 3072 for a multi gigabyte
+// asset, up to the 4 GiB limit of .glb files).
+int main(int argc, char** argv)
+{
+    using namespace nether::Benchmark;
+
+    BenchmarkOptions options{};
+    std::string jsonPath{};
+    std::filesystem::path cameraPathFile{};
+    uint64_t largeAssetSizeInMiB{256u};
+
+    const std::vector<std::string_view> arguments(argv + 1, argv + argc);
+    for (size_t i = 0u; i < arguments.size(); ++i)
+    {
+        const bool hasValue = i + 1u < arguments.size();
+
+        if (arguments[i] == "--filter" && hasValue)
+        {
+            options.filter = arguments[++i];
+        }
+        else if (arguments[i] == "--samples" && hasValue)
+        {
+            options.sampleCount = std::max(static_cast<uint32_t>(std::stoul(std::string(arguments[++i]))), 1u);
+        }
+        else if (arguments[i] == "--json" && hasValue)
+        {
+            jsonPath = arguments[++i];
+        }
+        else if (arguments[i] == "--camera-path" && hasValue)
+        {
+            cameraPathFile = arguments[++i];
+        }
+        else if (arguments[i] == "--large-asset-size" && hasValue)
+        {
+            largeAssetSizeInMiB = std::max(std::stoull(std::string(arguments[++i])), 1ull);
+        }
+        else
+        {
+            std::cout << "Usage : NetherBenchmarks [--filter <substring>] [--samples <count>] [--json <path>] [--camera-path <path>] [--large-asset-size <MiB>]" << std::endl;
+            return -1;
+        }
+    }
+
+    BenchmarkRunner runner(options);
+
+    try
+    {
+        runSceneBenchmarks(runner);
+        runRenderingBenchmarks(runner);
+        runThreadingBenchmarks(runner);
+        runJobSystemBenchmarks(runner);
+        runAssetBenchmarks(runner);
+        runAssetRegistryBenchmarks(runner);
+        runAssetArchiveBenchmarks(runner);
+        runGltfBenchmarks(runner, largeAssetSizeInMiB);
+        runShaderBenchmarks(runner);
+        runReplayBenchmarks(runner, cameraPathFile);
+    }
+    catch (const std::exception& exception)
+    {
+        std::cout << "[Exception Caught] : " << exception.what() << std::endl;
+        return -1;
+    }
+
+    if (!jsonPath.empty())
+    {
+        std::ofstream jsonFile(jsonPath);
+        runner.writeJson(jsonFile);
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+
+#include "DrawList.hpp"
+#include "IndirectCommands.hpp"
+#include "NullGraphicsBackend.hpp"
+#include "RenderGraph.hpp"
+
+namespace nether::Benchmark
+{
+    static constexpr uint32_t DRAW_ENTITY_COUNT = 16384u;
+
+    // A chain of passes where each pass writes a transient resource that the next one and the one after reads, with every 8th pass on the compute queue and every
+    // 16th pass's output unused (so the pass is culled). The last pass writes the imported back buffer.
+    static void buildRenderGraph(RenderGraph& renderGraph, const uint32_t passCount)
+    {
+        renderGraph.clear();
+
+        const RenderGraphResource backBuffer = renderGraph.importResource("Back buffer", ResourceState::Present, ResourceState::Present);
+
+        std::array<RenderGraphResource, 2u> previousOutputs{};
+        for (const uint32_t passIndex : std::views::iota(0u, passCount - 1u))
+        {
+            const bool isComputePass = passIndex % 8u == 7u;
+            const RenderGraphPass pass = renderGraph.addPass("Pass", isComputePass ? QueueType::Compute : QueueType::Graphics);
+
+            for (const RenderGraphResource previousOutput : previousOutputs)
+            {
+                if (previousOutput.isValid())
+                {
+                    renderGraph.read(pass, previousOutput, ResourceState::ShaderResource);
+                }
+            }
+
+            const RenderGraphResource output = renderGraph.createTransientResource("Output", (1u + passIndex % 4u) * 4u * 1024u * 1024u, 64u * 1024u);
+            renderGraph.write(pass, output, isComputePass ? ResourceState::UnorderedAccess : ResourceState::RenderTarget);
+
+            if (passIndex % 16u != 15u)
+            {
+                previousOutputs = {previousOutputs[1], output};
+            }
+        }
+
+        const RenderGraphPass presentPass = renderGraph.addPass("Present");
+        renderGraph.read(presentPass, previousOutputs[1], ResourceState::ShaderResource);
+        renderGraph.write(presentPass, backBuffer, ResourceState::RenderTarget);
+
+        renderGraph.compile();
+    }
+
+    void runRenderingBenchmarks(BenchmarkRunner& runner)
+    {
+        NullGraphicsBackend graphicsBackend(1u, DRAW_ENTITY_COUNT);
+        BenchmarkScene benchmarkScene(graphicsBackend, BenchmarkSceneDesc{.entityCount = DRAW_ENTITY_COUNT});
+        const std::span<const Renderable> renderables = benchmarkScene.getScene().getRenderables();
+
+        DrawList drawList{};
+        runner.run("DrawList/build/16384",
+                   DRAW_ENTITY_COUNT,
+                   [&]()
+                   {
+                       drawList.build(renderables);
+                       doNotOptimize(drawList.getDraws().size());
+                   });
+
+        IndirectCommandBuilder indirectCommandBuilder{};
+        runner.run("IndirectCommandBuilder/build/16384",
+                   drawList.getDraws().size(),
+                   [&]()
+                   {
+                       indirectCommandBuilder.build(drawList.getDraws(), 0u, 1u);
+                       doNotOptimize(indirectCommandBuilder.getRecords().size());
+                   });
+
+        // Descriptors are allocated from a free list (see DescriptorAllocator.hpp) by D3D12GraphicsBackend::createTexture, createStructuredBuffer, ..., and released when
+        // their asset is destroyed. The handle arithmetic does not need a device.
+        constexpr uint32_t descriptorCount = 1024u;
+
+        DescriptorHeap descriptorHeap{};
+        descriptorHeap.descriptorSize = 32u;
+        descriptorHeap.allocator.init(descriptorCount, "Benchmark descriptor heap");
+
+        std::vector<uint32_t> descriptorIndices(descriptorCount);
+        runner.run("DescriptorHeap/allocateAndRelease/1024",
+                   descriptorCount,
+                   [&]()
+                   {
+                       for (uint32_t& descriptorIndex : descriptorIndices)
+                       {
+                           descriptorIndex = descriptorHeap.allocate();
+                       }
+
+                       doNotOptimize(descriptorHeap.getCpuDescriptorHandleAtIndex(descriptorIndices.back()));
+
+                       for (const uint32_t descriptorIndex : descriptorIndices)
+                       {
+                           descriptorHeap.release(descriptorIndex);
+                       }
+                   });
+
+        RenderGraph renderGraph{};
+        for (const uint32_t passCount : {16u, 128u, 512u})
+        {
+            runner.run(std::format("RenderGraph/buildAndCompile/passes:{}", passCount),
+                       passCount,
+                       [&]()
+                       {
+                           buildRenderGraph(renderGraph, passCount);
+                           doNotOptimize(renderGraph.getBarriers().size());
+                       });
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "FrameReplay.hpp"
+
+namespace nether::Benchmark
+{
+    // 5 seconds at 60 frames per second.
+    static constexpr uint32_t ORBIT_FRAME_COUNT = 300u;
+
+    void runReplayBenchmarks(BenchmarkRunner& runner, const std::filesystem::path& cameraPathFile)
+    {
+        // The default orbit is inside the scenes, so about half of them is in view at any time.
+        const CameraPath cameraPath = cameraPathFile.empty() ? CameraPath::createOrbit(ORBIT_FRAME_COUNT, 20.0f, 5.0f) : CameraPath::load(cameraPathFile);
+
+        const std::array<std::pair<std::string_view, BenchmarkSceneDesc>, 3u> scenes = {{
+            {"uniform/16384", BenchmarkSceneDesc{.entityCount = 16384u}},
+            {"clustered/16384", BenchmarkSceneDesc{.entityCount = 16384u, .sceneExtent = 50.0f, .clusterCount = 32u}},
+            {"clustered/131072", BenchmarkSceneDesc{.entityCount = 131072u, .sceneExtent = 50.0f, .clusterCount = 256u}},
+        }};
+
+        // Single threaded, and with the recording spread over all hardware threads.
+        std::vector<uint32_t> recordingThreadCounts = {1u, std::max(std::thread::hardware_concurrency(), 1u)};
+        if (recordingThreadCounts.back() == 1u)
+        {
+            recordingThreadCounts.pop_back();
+        }
+
+        for (const auto& [sceneName, sceneDesc] : scenes)
+        {
+            for (const uint32_t recordingThreadCount : recordingThreadCounts)
+            {
+                runFrameReplay(runner,
+                               std::format("Replay/{}/threads:{}", sceneName, recordingThreadCount),
+                               FrameReplayDesc{
+                                   .sceneDesc = sceneDesc,
+                                   .recordingThreadCount = recordingThreadCount,
+                               },
+                               cameraPath);
+            }
+        }
+    }
+}
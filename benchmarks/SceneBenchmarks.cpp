@@ -0,0 +1,223 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+
+#include "Camera.hpp"
+#include "NullGraphicsBackend.hpp"
+
+namespace nether::Benchmark
+{
+    // The scene store is meant to scale to scenes of this size.
+    static constexpr uint32_t SCENE_ENTITY_COUNT = 1000000u;
+
+    // Hierarchies with the same number of entities, but opposite shapes : long chains, or roots with many direct children.
+    static constexpr uint32_t HIERARCHY_ROOT_COUNT = 128u;
+    static constexpr uint32_t HIERARCHY_ENTITIES_PER_ROOT = 1024u;
+    static constexpr uint32_t HIERARCHY_ENTITY_COUNT = HIERARCHY_ROOT_COUNT * HIERARCHY_ENTITIES_PER_ROOT;
+
+    enum class HierarchyShape : uint8_t
+    {
+        Deep,
+        Wide,
+    };
+
+    // Returns the roots, the scene's transforms are up to date after creation.
+    static std::vector<EntityHandle> createHierarchy(Scene& scene, const HierarchyShape shape)
+    {
+        scene.reserve(HIERARCHY_ENTITY_COUNT);
+
+        std::vector<EntityHandle> roots{};
+        for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, HIERARCHY_ROOT_COUNT))
+        {
+            const EntityHandle root = scene.createEntity("Root");
+            roots.push_back(root);
+
+            EntityHandle parent = root;
+            for ([[maybe_unused]] const uint32_t j : std::views::iota(1u, HIERARCHY_ENTITIES_PER_ROOT))
+            {
+                const EntityHandle child = scene.createEntity("Child", parent);
+                scene.setTransform(child, Transform{.rotate = {0.0f, 0.001f, 0.0f}, .translate = {0.0f, 0.01f, 0.0f}});
+
+                if (shape == HierarchyShape::Deep)
+                {
+                    parent = child;
+                }
+            }
+        }
+
+        scene.updateTransforms();
+
+        return roots;
+    }
+
+    static void runHierarchyBenchmarks(BenchmarkRunner& runner, const HierarchyShape shape)
+    {
+        const std::string_view shapeName = shape == HierarchyShape::Deep ? "deep" : "wide";
+
+        Scene scene{};
+        const std::vector<EntityHandle> roots = createHierarchy(scene, shape);
+
+        // Marks every stride-th entity (by dense index) dirty. In the deep hierarchy, everything below a dirty entity is recomputed as well.
+        float touchAngle{};
+        const auto touchTransforms = [&](const uint32_t stride)
+        {
+            touchAngle += 0.001f;
+
+            for (size_t denseIndex = 0u; denseIndex < scene.size(); denseIndex += stride)
+            {
+                Transform transform = scene.getTransformAtIndex(denseIndex);
+                transform.rotate.x = touchAngle;
+                scene.setTransformAtIndex(denseIndex, transform);
+            }
+        };
+
+        runner.run(std::format("Scene/hierarchy/{}/clean/{}", shapeName, HIERARCHY_ENTITY_COUNT), HIERARCHY_ENTITY_COUNT, [&]() { scene.updateTransforms(); });
+
+        const std::array<std::pair<std::string_view, uint32_t>, 4u> dirtyRatios = {{
+            {"onePercentDirty", 100u},
+            {"tenPercentDirty", 10u},
+            {"halfDirty", 2u},
+            {"allDirty", 1u},
+        }};
+
+        for (const auto& [dirtyRatioName, stride] : dirtyRatios)
+        {
+            runner.runWithSetup(
+                std::format("Scene/hierarchy/{}/{}/{}", shapeName, dirtyRatioName, HIERARCHY_ENTITY_COUNT),
+                HIERARCHY_ENTITY_COUNT,
+                [&, stride]() { touchTransforms(stride); },
+                [&]() { scene.updateTransforms(); });
+        }
+
+        // Moving the second root under the first changes the depth of a whole chain (deep), or of one root and its children (wide), so the hierarchy is re-sorted.
+        runner.runWithSetup(
+            std::format("Scene/hierarchy/{}/reparent/{}", shapeName, HIERARCHY_ENTITY_COUNT),
+            HIERARCHY_ENTITY_COUNT,
+            [&]() { scene.setParent(roots[1], scene.getParent(roots[1]).isValid() ? EntityHandle{} : roots[0]); },
+            [&]() { scene.updateTransforms(); });
+    }
+
+    void runSceneBenchmarks(BenchmarkRunner& runner)
+    {
+        // Nothing is drawn, the backend only creates the meshes and pipelines of the scene.
+        NullGraphicsBackend graphicsBackend(1u, 1u);
+        BenchmarkScene benchmarkScene(graphicsBackend, BenchmarkSceneDesc{.entityCount = SCENE_ENTITY_COUNT});
+        Scene& scene = benchmarkScene.getScene();
+
+        std::vector<EntityHandle> createdEntities{};
+        runner.run("Scene/createDestroyEntities/1000000",
+                   SCENE_ENTITY_COUNT,
+                   [&]()
+                   {
+                       Scene createdScene{};
+                       createdEntities.clear();
+
+                       for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, SCENE_ENTITY_COUNT))
+                       {
+                           createdEntities.push_back(createdScene.createEntity("Entity"));
+                       }
+
+                       for (const EntityHandle entity : createdEntities)
+                       {
+                           createdScene.destroyEntity(entity);
+                       }
+
+                       doNotOptimize(createdScene.size());
+                   });
+
+        runner.run("Scene/iterateWorldMatrices/1000000",
+                   SCENE_ENTITY_COUNT,
+                   [&]()
+                   {
+                       float sum{};
+                       for (const math::XMFLOAT4X4& worldMatrix : scene.getWorldMatrices())
+                       {
+                           sum += worldMatrix._41 + worldMatrix._42 + worldMatrix._43;
+                       }
+
+                       doNotOptimize(sum);
+                   });
+
+        runner.run("Scene/lookupByHandle/1000000",
+                   SCENE_ENTITY_COUNT,
+                   [&]()
+                   {
+                       float sum{};
+                       for (const EntityHandle entity : benchmarkScene.getEntities())
+                       {
+                           sum += scene.getWorldMatrix(entity)._41;
+                       }
+
+                       doNotOptimize(sum);
+                   });
+
+        // The transform composition and hierarchy propagation of Engine::update.
+        runner.run("Scene/updateTransforms/clean/1000000", SCENE_ENTITY_COUNT, [&]() { scene.updateTransforms(); });
+
+        runner.runWithSetup(
+            "Scene/updateTransforms/allDirty/1000000", SCENE_ENTITY_COUNT, [&]() { benchmarkScene.touchTransforms(1u); }, [&]() { scene.updateTransforms(); });
+
+        runner.runWithSetup(
+            "Scene/updateTransforms/onePercentDirty/1000000", SCENE_ENTITY_COUNT, [&]() { benchmarkScene.touchTransforms(100u); }, [&]() { scene.updateTransforms(); });
+
+        // Reparenting makes updateTransforms re-sort the hierarchy.
+        const std::span<const EntityHandle> entities = benchmarkScene.getEntities();
+        runner.runWithSetup(
+            "Scene/updateTransforms/reparent/1000000",
+            SCENE_ENTITY_COUNT,
+            [&]() { scene.setParent(entities.back(), scene.getParent(entities.back()).isValid() ? EntityHandle{} : entities.front()); },
+            [&]() { scene.updateTransforms(); });
+
+        runHierarchyBenchmarks(runner, HierarchyShape::Deep);
+        runHierarchyBenchmarks(runner, HierarchyShape::Wide);
+
+        // The kernel on its own, every transform dirty.
+        {
+            std::vector<std::vector<float>> components(9u, std::vector<float>(SCENE_ENTITY_COUNT));
+            for (const uint32_t i : std::views::iota(0u, SCENE_ENTITY_COUNT))
+            {
+                for (const uint32_t component : std::views::iota(0u, 9u))
+                {
+                    components[component][i] = 0.5f + static_cast<float>((i * 7u + component * 13u) % 100u) * 0.01f;
+                }
+            }
+
+            const TransformKernel::LocalTransforms localTransforms = {
+                .translateX = components[0].data(),
+                .translateY = components[1].data(),
+                .translateZ = components[2].data(),
+                .rotateX = components[3].data(),
+                .rotateY = components[4].data(),
+                .rotateZ = components[5].data(),
+                .scaleX = components[6].data(),
+                .scaleY = components[7].data(),
+                .scaleZ = components[8].data(),
+                .count = SCENE_ENTITY_COUNT,
+            };
+
+            std::vector<math::XMFLOAT4X4> localMatrices(SCENE_ENTITY_COUNT);
+            std::vector<math::XMFLOAT4X4> localNormalMatrices(SCENE_ENTITY_COUNT);
+
+            runner.run("TransformKernel/compose/1000000",
+                       SCENE_ENTITY_COUNT,
+                       [&]()
+                       {
+                           TransformKernel::compose(localTransforms, nullptr, localMatrices, localNormalMatrices);
+                           doNotOptimize(localMatrices.back());
+                       });
+        }
+
+        Camera camera{};
+        camera.handleInput(Keys::W, true);
+        camera.handleInput(Keys::ALeft, true);
+
+        runner.run("Camera/updateAndGetLookAtMatrix",
+                   1u,
+                   [&]()
+                   {
+                       camera.update(1.0f / 60.0f);
+                       doNotOptimize(camera.getLookAtMatrix());
+                   });
+    }
+}
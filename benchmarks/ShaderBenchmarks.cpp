@@ -0,0 +1,108 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+#include "ShaderCache.hpp"
+
+// Only built where DXC is available (see premake5.lua), and shipping builds do not compile shaders at runtime.
+#if defined(NETHER_HAS_DXC) && !defined(NETHER_SHIPPING)
+#include "ShaderCompiler.hpp"
+#endif
+
+namespace nether::Benchmark
+{
+    static constexpr std::string_view SHADER_PATH = "shaders/PhongShader.hlsl";
+
+    static constexpr uint64_t MAX_CACHE_SIZE_IN_BYTES = 64u * 1024u * 1024u;
+
+    // Cache directories are recreated empty, so every run starts cold.
+    static std::filesystem::path resetCacheDirectory()
+    {
+        const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "NetherBenchmarks" / "ShaderCache";
+
+        std::filesystem::remove_all(cacheDirectory);
+        ShaderCache::setCacheDirectory(cacheDirectory, MAX_CACHE_SIZE_IN_BYTES);
+
+        return cacheDirectory;
+    }
+
+    // DXC is only used on Windows (see premake5.lua), elsewhere only the cache is benchmarked.
+    static void runShaderCompilerBenchmarks(BenchmarkRunner& runner);
+
+    void runShaderBenchmarks(BenchmarkRunner& runner)
+    {
+        if (!std::filesystem::exists(SHADER_PATH))
+        {
+            std::cout << "Skipping the shader benchmarks, the shaders were not found (run from the repository root)." << std::endl;
+            return;
+        }
+
+        // Hashing the source and every included file, which every compile does before it can look at the cache.
+        const std::array<std::filesystem::path, 1u> includeDirectories = {"shaders"};
+        const std::array<const wchar_t*, 4u> compilationArguments = {L"-E", L"VsMain", L"-T", L"vs_6_6"};
+
+        runner.run("ShaderCache/computeKey/PhongShader",
+                   1u,
+                   [&]() { doNotOptimize(ShaderCache::computeKey(SHADER_PATH, includeDirectories, compilationArguments, 0u)); });
+
+        // Bytecode about the size of a compiled PhongShader variant.
+        const std::vector<std::byte> bytecode(8u * 1024u, std::byte{0xABu});
+        constexpr uint64_t cacheKey = 0x0123456789ABCDEFu;
+
+        resetCacheDirectory();
+
+        runner.run("ShaderCache/load/miss", 1u, [&]() { doNotOptimize(ShaderCache::load(~cacheKey).has_value()); });
+        runner.run("ShaderCache/store/8KiB", bytecode.size(), [&]() { ShaderCache::store(cacheKey, bytecode); });
+        runner.run("ShaderCache/load/hit/8KiB", bytecode.size(), [&]() { doNotOptimize(ShaderCache::load(cacheKey)->size()); });
+
+        runShaderCompilerBenchmarks(runner);
+
+        std::filesystem::remove_all(resetCacheDirectory());
+    }
+
+#if defined(NETHER_HAS_DXC) && !defined(NETHER_SHIPPING)
+    static void runShaderCompilerBenchmarks(BenchmarkRunner& runner)
+    {
+        const std::wstring shaderPath = stringToWString(SHADER_PATH);
+
+        // The first compile sets up the compiler, and points the cache at its default directory.
+        [[maybe_unused]] const Shader firstShader = ShaderCompiler::compile(ShaderTypes::Vertex, shaderPath);
+
+        runner.runWithSetup(
+            "ShaderCompiler/compile/PhongShader/cold", 1u, []() { resetCacheDirectory(); }, [&]() { doNotOptimize(ShaderCompiler::compile(ShaderTypes::Vertex, shaderPath)); });
+
+        resetCacheDirectory();
+        runner.run("ShaderCompiler/compile/PhongShader/warm", 1u, [&]() { doNotOptimize(ShaderCompiler::compile(ShaderTypes::Vertex, shaderPath)); });
+
+        // Every variant of the vertex and pixel shader, as compiled at startup.
+        const ShaderPermutationDesc vertexShaderDesc = {
+            .shaderType = ShaderTypes::Vertex,
+            .shaderPath = shaderPath,
+            .features = {L"PHONG_SPECULAR", L"PHONG_DIRECTIONAL_LIGHT"},
+        };
+
+        ShaderPermutationDesc pixelShaderDesc = vertexShaderDesc;
+        pixelShaderDesc.shaderType = ShaderTypes::Pixel;
+
+        std::vector<ShaderCompileJob> jobs{};
+        for (const ShaderVariantKey variantKey : ShaderCompiler::getAllVariantKeys(static_cast<uint32_t>(vertexShaderDesc.features.size())))
+        {
+            jobs.push_back(ShaderCompiler::getVariantJob(vertexShaderDesc, variantKey));
+            jobs.push_back(ShaderCompiler::getVariantJob(pixelShaderDesc, variantKey));
+        }
+
+        for (const uint32_t threadCount : getThreadCounts())
+        {
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = threadCount - 1u});
+
+            runner.runWithSetup(
+                std::format("ShaderCompiler/compileBatch/PhongShader/cold/threads:{}", threadCount),
+                jobs.size(),
+                []() { resetCacheDirectory(); },
+                [&]() { doNotOptimize(ShaderCompiler::compileBatch(jobSystem, jobs)); });
+        }
+    }
+#else
+    static void runShaderCompilerBenchmarks([[maybe_unused]] BenchmarkRunner& runner) {}
+#endif
+}
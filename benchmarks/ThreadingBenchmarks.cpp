@@ -0,0 +1,147 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+
+#include "DrawList.hpp"
+#include "FrameRenderer.hpp"
+#include "NullGraphicsBackend.hpp"
+#include "ParallelRecorder.hpp"
+#include "Profiler.hpp"
+#include "TripleBuffer.hpp"
+
+namespace nether::Benchmark
+{
+    static constexpr uint32_t RECORDING_ENTITY_COUNT = 16384u;
+
+    // Stands in for the work of a simulation or render frame. Spins rather than sleeps, so the timing does not depend on the scheduler's wake up latency.
+    static void spinFor(const Clock::duration duration)
+    {
+        const Clock::time_point endTime = Clock::now() + duration;
+        while (Clock::now() < endTime)
+        {
+        }
+    }
+
+    void runThreadingBenchmarks(BenchmarkRunner& runner)
+    {
+        // The render thread's side of a frame, with the recording spread over 1 to N threads. The null backend validates and counts the draws instead of recording them,
+        // so this measures the engine's overhead rather than the driver's.
+        for (const uint32_t threadCount : getThreadCounts())
+        {
+            const std::string name = std::format("FrameRenderer/render/16384/threads:{}", threadCount);
+            if (!runner.isEnabled(name))
+            {
+                continue;
+            }
+
+            NullGraphicsBackend graphicsBackend(threadCount, RECORDING_ENTITY_COUNT);
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = threadCount - 1u});
+            ParallelRecorder parallelRecorder(jobSystem);
+
+            // Draws are batched per pipeline, so there are enough batches to split.
+            BenchmarkScene benchmarkScene(graphicsBackend, BenchmarkSceneDesc{.entityCount = RECORDING_ENTITY_COUNT, .pipelineCount = 512u, .textureCount = 1u});
+
+            DrawList drawList{};
+            drawList.build(benchmarkScene.getScene().getRenderables());
+
+            FramePacket framePacket{};
+            framePacket.draws = drawList.getDraws();
+
+            const std::span<InstanceData> instances = framePacket.arena.allocateArray<InstanceData>(drawList.getInstanceIndices().size());
+            std::ranges::fill(instances, InstanceData{});
+            framePacket.instances = instances;
+
+            FrameRenderer frameRenderer{};
+            runner.run(name, framePacket.draws.size(), [&]() { frameRenderer.render(graphicsBackend, parallelRecorder, framePacket); });
+        }
+
+        // The parallel recorder on its own, with chunks of fixed synthetic work.
+        constexpr uint32_t chunkCount = 64u;
+        constexpr uint32_t chunkWorkSize = 4096u;
+
+        std::vector<RecordingChunk> recordingChunks{};
+        splitIntoChunks(chunkCount * chunkWorkSize, chunkCount, 1u, recordingChunks);
+
+        std::vector<std::byte> workData(chunkCount * chunkWorkSize, std::byte{1u});
+        std::vector<uint64_t> chunkHashes(chunkCount);
+
+        const ParallelRecorder::RecordChunkFunction hashChunk = [&](const uint32_t chunkIndex, const RecordingChunk& chunk)
+        { chunkHashes[chunkIndex] = hashBytes(std::span(workData).subspan(chunk.firstItem, chunk.itemCount)); };
+
+        for (const uint32_t threadCount : getThreadCounts())
+        {
+            const std::string name = std::format("ParallelRecorder/record/64x4KiB/threads:{}", threadCount);
+            if (!runner.isEnabled(name))
+            {
+                continue;
+            }
+
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = threadCount - 1u});
+            ParallelRecorder parallelRecorder(jobSystem);
+            runner.run(name, workData.size(), [&]() { parallelRecorder.record(recordingChunks, hashChunk); });
+        }
+
+        // Frames through the simulation / render handoff of Engine::run. With equal sim and render costs, the two overlap and a frame costs about one of them.
+        constexpr uint32_t handoffFrameCount = 256u;
+        for (const Clock::duration frameWork : {Clock::duration::zero(), Clock::duration(std::chrono::microseconds(20))})
+        {
+            const std::string name = std::format("TripleBuffer/handoff/work:{}us", std::chrono::duration_cast<std::chrono::microseconds>(frameWork).count());
+            runner.run(name,
+                       handoffFrameCount,
+                       [&]()
+                       {
+                           TripleBuffer<uint32_t> frames{};
+
+                           std::jthread renderThread(
+                               [&]()
+                               {
+                                   while (const uint32_t* const frame = frames.acquire())
+                                   {
+                                       spinFor(frameWork);
+                                       if (*frame == handoffFrameCount - 1u)
+                                       {
+                                           return;
+                                       }
+                                   }
+                               });
+
+                           for (const uint32_t frame : std::views::iota(0u, handoffFrameCount))
+                           {
+                               spinFor(frameWork);
+                               frames.getWriteSlot() = frame;
+
+                               if (!frames.waitUntilConsumed())
+                               {
+                                   break;
+                               }
+                               frames.publish();
+                           }
+
+                           renderThread.join();
+                       });
+        }
+
+        // Cost of a profiler zone, paid by every instrumented scope in Debug and Release builds (even with the profiler window closed).
+        constexpr uint32_t zoneCount = 1024u;
+        runner.run("Profiler/scope/1024",
+                   zoneCount,
+                   [&]()
+                   {
+                       for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, zoneCount))
+                       {
+                           const Profiler::ProfileScope profileScope("Benchmark zone");
+                       }
+                   });
+
+        runner.run("Profiler/recordZone/1024",
+                   zoneCount,
+                   [&]()
+                   {
+                       for (const uint32_t i : std::views::iota(0u, zoneCount))
+                       {
+                           Profiler::recordZone("Benchmark zone", i, i + 1u);
+                       }
+                   });
+    }
+}
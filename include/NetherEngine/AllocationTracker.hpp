@@ -0,0 +1,77 @@
+#pragma once
+
+// Counts heap allocations (through a replaced global operator new), attributed to the subsystem whose scope the allocating thread is in. Used to keep the frame loop free
+// of allocations : the engine reports the allocations of every frame per subsystem, and once it reaches steady state, any allocation made inside a subsystem scope is a
+// violation (which is fatal in Debug builds, see Engine::run). Only depends on the standard library.
+//
+// The macro compiles to nothing, and operator new is left alone, unless NETHER_ALLOCATION_TRACKING is defined (see premake5.lua).
+#ifdef NETHER_ALLOCATION_TRACKING
+static constexpr bool NETHER_ALLOCATION_TRACKING_MODE = true;
+
+#define NETHER_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define NETHER_ALLOCATION_CONCAT(a, b) NETHER_ALLOCATION_CONCAT_INNER(a, b)
+
+// Name must be a string literal. The subsystem is looked up once per call site.
+#define NETHER_ALLOCATION_SCOPE(name)                                                                                                                                     \
+    static const uint32_t NETHER_ALLOCATION_CONCAT(allocationSubsystemIndex, __LINE__) = ::nether::AllocationTracker::getSubsystemIndex(name);                             \
+    const ::nether::AllocationTracker::SubsystemScope NETHER_ALLOCATION_CONCAT(allocationScope, __LINE__)(NETHER_ALLOCATION_CONCAT(allocationSubsystemIndex, __LINE__))
+#else
+static constexpr bool NETHER_ALLOCATION_TRACKING_MODE = false;
+
+#define NETHER_ALLOCATION_SCOPE(name)
+#endif
+
+namespace nether::AllocationTracker
+{
+    // Subsystem 0 is for allocations made outside of any subsystem scope, which are counted but never violations.
+    inline constexpr uint32_t UNTRACKED_SUBSYSTEM_INDEX = 0u;
+    inline constexpr uint32_t MAX_SUBSYSTEM_COUNT = 32u;
+
+    struct SubsystemAllocations
+    {
+        const char* name{};
+
+        uint64_t allocationCount{};
+        uint64_t allocatedBytes{};
+
+        // Allocations made while in steady state.
+        uint64_t violationCount{};
+    };
+
+    // Allocations of every subsystem since the previous collectFrame, in subsystem index order.
+    struct FrameAllocations
+    {
+        std::array<SubsystemAllocations, MAX_SUBSYSTEM_COUNT> subsystems{};
+        uint32_t subsystemCount{};
+
+        uint64_t getAllocationCount() const;
+        uint64_t getViolationCount() const;
+    };
+
+    // Registers the subsystem on first use. Names are compared by value, so scopes in different files can share a subsystem.
+    uint32_t getSubsystemIndex(const std::string_view name);
+
+    // Allocations on the calling thread go to the subsystem until the scope ends. Scopes nest, the innermost one wins.
+    class SubsystemScope
+    {
+      public:
+        explicit SubsystemScope(const uint32_t subsystemIndex);
+        ~SubsystemScope();
+
+        SubsystemScope(const SubsystemScope&) = delete;
+        SubsystemScope& operator=(const SubsystemScope&) = delete;
+
+      private:
+        uint32_t m_previousSubsystemIndex{};
+    };
+
+    // Once set, allocations inside subsystem scopes (on any thread) are counted as violations.
+    void setSteadyState(const bool isEnabled);
+    bool isSteadyState();
+
+    // Called by a single thread, at the end of every frame. Does not allocate.
+    void collectFrame(FrameAllocations& frameAllocations);
+
+    // Allocations since the program started (all subsystems), e.g. to check a piece of code does not allocate.
+    uint64_t getTotalAllocationCount();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+// Pack file of assets, written offline by NetherPacker (see tools/NetherPacker/Main.cpp) and mapped at runtime, so loading assets does not open a file per asset.
+// Layout : the header, the payloads (each aligned to PAYLOAD_ALIGNMENT), the bucket table, the directory and the path table. The directory is sorted by the hash of the
+// asset paths, and the bucket table has the first entry of each range of hashes, so a lookup hashes the path once and compares it to about one entry.
+// Entries are stored as is, or compressed with LZ4 when that saves enough space. Assets are found by their canonical path (see getCanonicalAssetPath), relative to
+// the directory the packer was run from (e.g. "assets/Cube/glTF/Cube.gltf").
+namespace nether
+{
+    enum class AssetCompression : uint32_t
+    {
+        None,
+        Lz4,
+    };
+
+    struct AssetArchiveHeader
+    {
+        static constexpr uint32_t MAGIC = 0x4B41504Eu; // "NPAK".
+        static constexpr uint32_t VERSION = 1u;
+
+        uint32_t magic{MAGIC};
+        uint32_t version{VERSION};
+
+        uint32_t entryCount{};
+        uint32_t bucketCount{};
+
+        // bucketCount + 1 uint32_t, bucket i has the entries [bucketTable[i], bucketTable[i + 1]).
+        uint64_t bucketTableOffset{};
+        uint64_t directoryOffset{};
+
+        uint64_t pathTableOffset{};
+        uint64_t pathTableSize{};
+    };
+
+    struct AssetArchiveEntry
+    {
+        uint64_t pathHash{};
+        uint32_t pathOffset{};
+        uint32_t pathSize{};
+
+        uint64_t dataOffset{};
+        uint64_t storedSize{};
+
+        // Size of the asset once decompressed.
+        uint64_t size{};
+
+        AssetCompression compression{};
+        uint32_t padding{};
+    };
+
+    class AssetArchive
+    {
+      public:
+        static constexpr uint64_t PAYLOAD_ALIGNMENT = 64u;
+
+        // An empty archive, which has no assets.
+        AssetArchive() = default;
+
+        // The whole archive is validated once here (failing to open it or a malformed archive is a fatal error), so lookups and reads do no checks.
+        explicit AssetArchive(const std::string_view archivePath);
+
+        AssetArchive(AssetArchive&& other) noexcept;
+        AssetArchive& operator=(AssetArchive&& other) noexcept;
+
+        AssetArchive(const AssetArchive&) = delete;
+        AssetArchive& operator=(const AssetArchive&) = delete;
+
+        // Returns nullptr if the archive has no asset with that path. assetPath does not have to be canonical.
+        [[nodiscard]] const AssetArchiveEntry* find(const std::string_view assetPath) const;
+
+        // Asks the OS to start reading the entry's payload into memory. Returns right away.
+        void prefetch(const AssetArchiveEntry& entry) const;
+
+        // Uncompressed entries are a view of the mapped archive (no copy). Compressed entries are decompressed into buffer, which the returned span points into.
+        [[nodiscard]] std::span<const std::byte> read(const AssetArchiveEntry& entry, std::vector<std::byte>& buffer) const;
+
+        std::string_view getPath(const AssetArchiveEntry& entry) const { return m_pathTable.substr(entry.pathOffset, entry.pathSize); }
+        std::span<const AssetArchiveEntry> getEntries() const { return m_entries; }
+
+      private:
+        std::span<const std::byte> getStoredData(const AssetArchiveEntry& entry) const { return m_file.getData().subspan(entry.dataOffset, entry.storedSize); }
+
+      private:
+        MappedFile m_file{};
+
+        std::span<const uint32_t> m_bucketTable{};
+        std::span<const AssetArchiveEntry> m_entries{};
+        std::string_view m_pathTable{};
+    };
+
+    // Packs the files (given by path, relative to the working directory) into an archive. Each file is stored under its canonical path, and compressed if compress is set
+    // and LZ4 makes it small enough. Failing to read a file or to write the archive is a fatal error.
+    void writeAssetArchive(const std::string_view archivePath, const std::span<const std::string> filePaths, const bool compress);
+}
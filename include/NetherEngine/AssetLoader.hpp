@@ -0,0 +1,54 @@
+#pragma once
+
+namespace tinygltf
+{
+    class Model;
+}
+
+// Decoding of asset files into CPU side data. Kept apart from the upload to the GPU (see Engine::createMesh and GraphicsBackend::createTexture), so it can run (and be benchmarked)
+// without a graphics device.
+namespace nether
+{
+    // One array per vertex attribute, matching the structured buffers the mesh shaders read. Indices are widened to 32 bit.
+    struct MeshData
+    {
+        std::vector<math::XMFLOAT3> positions{};
+        std::vector<math::XMFLOAT2> textureCoords{};
+        std::vector<math::XMFLOAT3> normals{};
+
+        std::vector<uint32_t> indices{};
+
+        // Sphere around the center of the position's bounding box (center in xyz, radius in w).
+        math::XMFLOAT4 boundingSphere{};
+    };
+
+    // RGBA, 8 bits per component, rows are tightly packed.
+    struct ImageData
+    {
+        uint32_t width{};
+        uint32_t height{};
+
+        std::vector<uint8_t> pixels{};
+    };
+
+    // Not the minimal sphere, but close enough for culling and cheap to compute.
+    [[nodiscard]] math::XMFLOAT4 computeBoundingSphere(const std::span<const math::XMFLOAT3> positions);
+
+    // Parses a .gltf (or .glb) file and loads the buffers it references. Failing to load the file is a fatal error.
+    void loadGltfModel(const std::string_view modelPath, tinygltf::Model& model);
+
+    class AssetArchive;
+
+    // Like loadGltfModel, for a .gltf file that is already in memory. Buffers are loaded relative to baseDirectory, from the asset archive if it is not null and has them.
+    void parseGltfModel(const std::span<const std::byte> gltfFile, const std::string_view baseDirectory, tinygltf::Model& model, const AssetArchive* const assetArchive = nullptr);
+
+    // Decodes the accessors of all primitives of the first node's mesh.
+    [[nodiscard]] MeshData decodeMeshData(const tinygltf::Model& model);
+
+    // Cube from -1 to 1 on every axis, with a face per side. Used as the placeholder of meshes that are still loading.
+    [[nodiscard]] MeshData makeCubeMeshData();
+
+    // Failing to load or decode the image is a fatal error.
+    [[nodiscard]] ImageData loadImage(const std::string_view imagePath);
+    [[nodiscard]] ImageData decodeImage(const std::span<const std::byte> encodedImage);
+}
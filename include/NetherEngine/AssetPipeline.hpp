@@ -0,0 +1,109 @@
+#pragma once
+
+#include "AssetArchive.hpp"
+#include "AssetLoader.hpp"
+#include "JobSystem.hpp"
+#include "MappedFile.hpp"
+
+// Loads assets in the background, in three stages :
+// - I/O, in a job of the job system. Finds the asset in the asset archive or maps its file, and asks the OS to read all of it (see MappedFile::prefetch), rather than
+//   page by page as the decoder gets to it. Disk reads of one job overlap with the decode of others.
+// - Decode, in the same job. Turns the file into MeshData / ImageData.
+// - Upload, by the owner of the pipeline (see Engine::uploadDecodedAssets), which takes the decoded assets in batches.
+// The pipeline has no threads of its own, so it shares the cores with everything else that runs on the job system. At most maxInFlightCount assets are between the
+// I/O stage and the upload : once that many are loading or waiting to be uploaded, the next request only starts once the upload stage took some, which bounds the
+// memory of decoded assets that are not uploaded yet. Without workers, the loads run on the thread that takes the decoded assets, when it takes them.
+namespace nether
+{
+    enum class AssetType : uint8_t
+    {
+        Mesh,
+        Texture,
+    };
+
+    struct AssetLoadRequest
+    {
+        std::string path{};
+        AssetType type{};
+
+        // Passed through to the decoded asset, e.g. the registry handle to publish the asset to.
+        uint64_t userData{};
+    };
+
+    struct DecodedAsset
+    {
+        AssetLoadRequest request{};
+
+        // Only the member matching the request's type is filled in.
+        MeshData meshData{};
+        ImageData imageData{};
+
+        // Set (and logged) if the asset could not be read or decoded.
+        std::exception_ptr loadException{};
+    };
+
+    struct AssetPipelineDesc
+    {
+        uint32_t maxInFlightCount{16u};
+
+        // Assets (and the buffers of .gltf files) are read from the archive if it has them, and from loose files otherwise. Must outlive the pipeline.
+        const AssetArchive* assetArchive{};
+    };
+
+    class AssetPipeline
+    {
+      public:
+        explicit AssetPipeline(JobSystem& jobSystem, const AssetPipelineDesc& desc = AssetPipelineDesc{});
+
+        // Waits for the loads that started. Requests that did not start, and assets that are not taken, are dropped.
+        ~AssetPipeline();
+
+        AssetPipeline(const AssetPipeline&) = delete;
+        AssetPipeline& operator=(const AssetPipeline&) = delete;
+
+        // Never waits. Requests start loading in order, and finish in any order.
+        void request(AssetLoadRequest request);
+
+        // Moves up to maxCount decoded assets (in the order they finished decoding) to the end of decodedAssets, and returns how many were moved. Never waits (for
+        // other threads).
+        size_t takeDecodedAssets(std::vector<DecodedAsset>& decodedAssets, const size_t maxCount);
+
+        // Waits until at least one asset is decoded, then behaves like takeDecodedAssets. Returns 0 right away if nothing is pending.
+        size_t waitForDecodedAssets(std::vector<DecodedAsset>& decodedAssets, const size_t maxCount);
+
+        // Requests that have not been taken by the upload stage yet.
+        uint32_t getPendingCount() const { return m_pendingCount.load(std::memory_order_acquire); }
+
+      private:
+        // Where the I/O stage found a requested asset : an entry of the asset archive, or a loose file.
+        struct AssetFile
+        {
+            const AssetArchiveEntry* archiveEntry{};
+            MappedFile mappedFile{};
+        };
+
+        // Starts loading requests until maxInFlightCount assets are in flight. Called whenever a request is added or the upload stage makes room. Without workers,
+        // the loads run right away on the calling thread, if runInline is set (and not at all otherwise).
+        void startLoads(const bool runInline);
+
+        // Maps, reads and decodes the file, and queues the result for the upload stage. Does not throw.
+        void load(AssetLoadRequest& request);
+
+      private:
+        JobSystem& m_jobSystem;
+        uint32_t m_maxInFlightCount{};
+        const AssetArchive* m_assetArchive{};
+
+        // Requests that did not start loading, and assets between the I/O stage and the upload stage. Requests only start while fewer than maxInFlightCount assets
+        // are in flight.
+        std::mutex m_mutex{};
+        std::condition_variable m_decodedAssetAdded{};
+        std::deque<AssetLoadRequest> m_requests{};
+        std::deque<DecodedAsset> m_decodedAssets{};
+        uint32_t m_inFlightCount{};
+
+        std::atomic<uint32_t> m_pendingCount{};
+
+        JobCounter m_loadCounter{};
+    };
+}
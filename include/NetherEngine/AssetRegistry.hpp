@@ -0,0 +1,431 @@
+#pragma once
+
+// Handle based storage of loaded assets. Each asset is identified by its path, so loading the same file twice (or from several threads at once) returns the same asset,
+// and assets are reference counted and destroyed a few frames after their last reference is dropped (once the GPU can no longer be using them). The assets themselves
+// are created by a loader callback (e.g. Engine::createMesh), so the registry can be used (and benchmarked) without a graphics device.
+namespace nether
+{
+    // Stable handle to an asset in an AssetRegistry. The index refers to a slot of the registry, and the generation is bumped every time that slot is freed so that stale
+    // handles can be detected. T only tags the handle, so mesh and texture handles can not be mixed up.
+    template <typename T> struct AssetHandle
+    {
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        uint32_t index{INVALID_INDEX};
+        uint32_t generation{};
+
+        bool isValid() const { return index != INVALID_INDEX; }
+
+        auto operator<=>(const AssetHandle& other) const = default;
+    };
+
+    using MeshHandle = AssetHandle<Mesh>;
+    using TextureHandle = AssetHandle<Texture>;
+
+    // Lexically normalized, with forward slashes (e.g "assets/./Cube\\Cube.gltf" and "assets/Cube/Cube.gltf" are the same asset). Does not touch the file system.
+    [[nodiscard]] std::string getCanonicalAssetPath(const std::string_view assetPath);
+
+    // Transparent, so the path map can be searched with a string_view.
+    struct AssetPathHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view assetPath) const { return std::hash<std::string_view>{}(assetPath); }
+    };
+
+    enum class AssetState : uint32_t
+    {
+        Loading,
+        Loaded,
+        // The load failed, and the path was unregistered. The slot is freed once every reference is released.
+        Failed,
+    };
+
+    // Slots are allocated up front, so assets never move : the reference returned by get stays valid for as long as the asset is referenced. Lookups by path take a
+    // shared lock on one of SHARD_COUNT shards of the path map, and reference counting is lock free except when a count drops to zero. Everything is thread safe, except
+    // collectGarbage which must always be called by the same thread.
+    template <typename T> class AssetRegistry
+    {
+      public:
+        using Handle = AssetHandle<T>;
+
+        // Called by collectGarbage on every loaded asset it destroys, before its slot can be reused (e.g. to return the asset's descriptors to the heap).
+        using Destroyer = std::function<void(T& asset)>;
+
+        // A released asset is destroyed by the first collectGarbage whose frame number is at least retireLatency frames after the release.
+        explicit AssetRegistry(const uint32_t maxAssetCount, const uint64_t retireLatency, Destroyer destroyer = {});
+
+        AssetRegistry(const AssetRegistry&) = delete;
+        AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+        // Returns the asset at the given path and takes a reference to it. If it is not loaded, loader (a callable taking the canonical path and returning a T) is
+        // called on the calling thread, with no lock held, and concurrent acquires of the same path wait for it. If loader throws, the exception is rethrown by every
+        // waiting acquire and the path is not registered. Running out of slots is a fatal error.
+        template <typename Loader> [[nodiscard]] Handle acquire(const std::string_view assetPath, Loader&& loader);
+
+        // If isNewLoad is set, the path was not registered and the caller must load the asset, and complete the load with finishLoad or failLoad (from any thread). The
+        // load must be completed even if every reference was released meanwhile : the slot is only freed once it is.
+        struct AsyncAcquire
+        {
+            Handle handle{};
+            bool isNewLoad{};
+        };
+
+        // Like acquire, but returns right away, with the asset possibly still loading (see getState). get must only be called once the asset is loaded.
+        [[nodiscard]] AsyncAcquire acquireAsync(const std::string_view assetPath);
+
+        // Publishes the asset, and wakes up the acquires waiting for it. The handle is the one acquireAsync returned, whether or not it is still referenced.
+        void finishLoad(const Handle handle, T&& asset);
+
+        // Unregisters the path, and rethrows loadException from the acquires waiting for it. Does not release the caller's reference.
+        void failLoad(const Handle handle, const std::exception_ptr loadException);
+
+        // Takes another reference to an asset the caller already holds a reference to.
+        void addReference(const Handle handle);
+
+        // Drops a reference. Once the last one is dropped, the asset stays loaded (and acquiring its path again gives it back) until collectGarbage destroys it.
+        void release(const Handle handle);
+
+        // Destroys the assets that were released at least retireLatency frames ago and have not been acquired since. Assets that are still loading are destroyed by the
+        // first collectGarbage after their load completes. frameNumber must never decrease.
+        void collectGarbage(const uint64_t frameNumber);
+
+        // The handle must be referenced.
+        T& get(const Handle handle) { return *m_slots[handle.index].asset; }
+        const T& get(const Handle handle) const { return *m_slots[handle.index].asset; }
+
+        AssetState getState(const Handle handle) const { return m_slots[handle.index].state.load(std::memory_order_acquire); }
+
+        // Canonical path (see getCanonicalAssetPath), the handle must be referenced.
+        const std::string& getPath(const Handle handle) const { return m_slots[handle.index].path; }
+
+        uint32_t getReferenceCount(const Handle handle) const { return m_slots[handle.index].referenceCount.load(std::memory_order_relaxed); }
+
+        // Assets that are loaded, loading or waiting to be destroyed.
+        uint32_t getAssetCount() const;
+
+        uint32_t getMaxAssetCount() const { return m_maxAssetCount; }
+
+      public:
+        static constexpr uint32_t SHARD_COUNT = 16u;
+
+      private:
+        struct Slot
+        {
+            std::optional<T> asset{};
+            std::exception_ptr loadException{};
+
+            std::atomic<AssetState> state{AssetState::Loading};
+            std::atomic<uint32_t> referenceCount{};
+
+            // Only changed by collectGarbage, when the slot is freed.
+            std::atomic<uint32_t> generation{};
+
+            // Written under the lock of the shard the path is in.
+            std::string path{};
+            uint32_t shardIndex{};
+            uint64_t releaseFrame{};
+        };
+
+        struct alignas(64) Shard
+        {
+            std::shared_mutex mutex{};
+            std::unordered_map<std::string, uint32_t, AssetPathHash, std::equal_to<>> slotIndices{};
+        };
+
+        struct RetiredAsset
+        {
+            uint32_t index{};
+            uint32_t generation{};
+            uint64_t releaseFrame{};
+        };
+
+        // Called with the lock of the shard held. Takes a reference to the asset at the given path, if it is registered.
+        Handle findAndReference(const Shard& shard, const std::string_view assetPath);
+
+        // Pops a free slot. The path is only used for the error message.
+        Handle allocateSlot(const std::string_view assetPath);
+
+        // Waits until the asset is loaded. If its loader threw, drops the reference and rethrows.
+        void waitUntilLoaded(const Handle handle);
+
+        // The slot of a load that is not completed, checking that the handle is the one that started it.
+        Slot& getLoadingSlot(const Handle handle, const std::string_view operation);
+
+        // Returns false if the asset is still loading, in which case it has to be retired again later.
+        bool destroyIfUnused(const RetiredAsset& retiredAsset);
+
+      private:
+        std::unique_ptr<Slot[]> m_slots{};
+        uint32_t m_maxAssetCount{};
+
+        std::array<Shard, SHARD_COUNT> m_shards{};
+
+        mutable std::mutex m_freeSlotMutex{};
+        std::vector<uint32_t> m_freeSlotIndices{};
+
+        // Ordered by release frame (give or take a frame, as the lock is taken after the release).
+        std::mutex m_retiredAssetMutex{};
+        std::deque<RetiredAsset> m_retiredAssets{};
+
+        std::atomic<uint64_t> m_frameNumber{};
+        uint64_t m_retireLatency{};
+
+        Destroyer m_destroyer{};
+    };
+
+    template <typename T>
+    inline AssetRegistry<T>::AssetRegistry(const uint32_t maxAssetCount, const uint64_t retireLatency, Destroyer destroyer)
+        : m_slots(std::make_unique<Slot[]>(maxAssetCount)), m_maxAssetCount(maxAssetCount), m_retireLatency(retireLatency), m_destroyer(std::move(destroyer))
+    {
+        // Reversed, so slots are handed out from index 0.
+        m_freeSlotIndices.resize(maxAssetCount);
+        std::iota(m_freeSlotIndices.rbegin(), m_freeSlotIndices.rend(), 0u);
+    }
+
+    template <typename T> template <typename Loader> inline AssetHandle<T> AssetRegistry<T>::acquire(const std::string_view assetPath, Loader&& loader)
+    {
+        const AsyncAcquire asyncAcquire = acquireAsync(assetPath);
+        if (!asyncAcquire.isNewLoad)
+        {
+            waitUntilLoaded(asyncAcquire.handle);
+            return asyncAcquire.handle;
+        }
+
+        try
+        {
+            finishLoad(asyncAcquire.handle, loader(std::string_view(getPath(asyncAcquire.handle))));
+        }
+        catch (...)
+        {
+            failLoad(asyncAcquire.handle, std::current_exception());
+            release(asyncAcquire.handle);
+            throw;
+        }
+
+        return asyncAcquire.handle;
+    }
+
+    template <typename T> inline typename AssetRegistry<T>::AsyncAcquire AssetRegistry<T>::acquireAsync(const std::string_view assetPath)
+    {
+        const std::string canonicalPath = getCanonicalAssetPath(assetPath);
+        const uint32_t shardIndex = static_cast<uint32_t>(AssetPathHash{}(canonicalPath) % SHARD_COUNT);
+        Shard& shard = m_shards[shardIndex];
+
+        // Fast path, the asset is already registered.
+        {
+            const std::shared_lock lock(shard.mutex);
+            if (const Handle handle = findAndReference(shard, canonicalPath); handle.isValid())
+            {
+                return AsyncAcquire{handle, false};
+            }
+        }
+
+        // Another thread may have registered the path since the shared lock was dropped, in which case that thread loads it.
+        const std::unique_lock lock(shard.mutex);
+        if (const Handle handle = findAndReference(shard, canonicalPath); handle.isValid())
+        {
+            return AsyncAcquire{handle, false};
+        }
+
+        const Handle handle = allocateSlot(canonicalPath);
+
+        Slot& slot = m_slots[handle.index];
+        slot.state.store(AssetState::Loading, std::memory_order_relaxed);
+        slot.referenceCount.store(1u, std::memory_order_relaxed);
+        slot.path = canonicalPath;
+        slot.shardIndex = shardIndex;
+
+        shard.slotIndices.emplace(canonicalPath, handle.index);
+
+        return AsyncAcquire{handle, true};
+    }
+
+    template <typename T> inline void AssetRegistry<T>::finishLoad(const Handle handle, T&& asset)
+    {
+        Slot& slot = getLoadingSlot(handle, "finishLoad");
+        slot.asset.emplace(std::move(asset));
+
+        slot.state.store(AssetState::Loaded, std::memory_order_release);
+        slot.state.notify_all();
+    }
+
+    template <typename T> inline void AssetRegistry<T>::failLoad(const Handle handle, const std::exception_ptr loadException)
+    {
+        Slot& slot = getLoadingSlot(handle, "failLoad");
+        slot.loadException = loadException;
+
+        {
+            const std::unique_lock lock(m_shards[slot.shardIndex].mutex);
+            m_shards[slot.shardIndex].slotIndices.erase(slot.path);
+        }
+
+        slot.state.store(AssetState::Failed, std::memory_order_release);
+        slot.state.notify_all();
+    }
+
+    template <typename T> inline void AssetRegistry<T>::addReference(const Handle handle)
+    {
+        m_slots[handle.index].referenceCount.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    template <typename T> inline void AssetRegistry<T>::release(const Handle handle)
+    {
+        Slot& slot = m_slots[handle.index];
+
+        // Counts above one are decremented without a lock. The last reference is dropped under the shard's lock, so it can not race with an acquire by path taking the
+        // asset back.
+        uint32_t referenceCount = slot.referenceCount.load(std::memory_order_relaxed);
+        while (referenceCount > 1u)
+        {
+            if (slot.referenceCount.compare_exchange_weak(referenceCount, referenceCount - 1u, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+
+        RetiredAsset retiredAsset{};
+        {
+            const std::unique_lock lock(m_shards[slot.shardIndex].mutex);
+            if (slot.referenceCount.fetch_sub(1u, std::memory_order_acq_rel) != 1u)
+            {
+                return;
+            }
+
+            slot.releaseFrame = m_frameNumber.load(std::memory_order_relaxed);
+            retiredAsset = RetiredAsset{handle.index, handle.generation, slot.releaseFrame};
+        }
+
+        const std::scoped_lock lock(m_retiredAssetMutex);
+        m_retiredAssets.push_back(retiredAsset);
+    }
+
+    template <typename T> inline void AssetRegistry<T>::collectGarbage(const uint64_t frameNumber)
+    {
+        m_frameNumber.store(frameNumber, std::memory_order_relaxed);
+
+        const std::scoped_lock lock(m_retiredAssetMutex);
+
+        // Assets that are still loading are kept at the front, in order, so the next collection checks them again.
+        size_t retiredIndex{};
+        size_t keptCount{};
+        for (; retiredIndex < m_retiredAssets.size() && m_retiredAssets[retiredIndex].releaseFrame + m_retireLatency <= frameNumber; ++retiredIndex)
+        {
+            if (!destroyIfUnused(m_retiredAssets[retiredIndex]))
+            {
+                m_retiredAssets[keptCount++] = m_retiredAssets[retiredIndex];
+            }
+        }
+
+        m_retiredAssets.erase(m_retiredAssets.begin() + static_cast<ptrdiff_t>(keptCount), m_retiredAssets.begin() + static_cast<ptrdiff_t>(retiredIndex));
+    }
+
+    template <typename T> inline uint32_t AssetRegistry<T>::getAssetCount() const
+    {
+        const std::scoped_lock lock(m_freeSlotMutex);
+        return m_maxAssetCount - static_cast<uint32_t>(m_freeSlotIndices.size());
+    }
+
+    template <typename T> inline AssetHandle<T> AssetRegistry<T>::findAndReference(const Shard& shard, const std::string_view assetPath)
+    {
+        const auto slotIndex = shard.slotIndices.find(assetPath);
+        if (slotIndex == shard.slotIndices.end())
+        {
+            return Handle{};
+        }
+
+        Slot& slot = m_slots[slotIndex->second];
+        slot.referenceCount.fetch_add(1u, std::memory_order_relaxed);
+
+        return Handle{slotIndex->second, slot.generation.load(std::memory_order_relaxed)};
+    }
+
+    template <typename T> inline AssetHandle<T> AssetRegistry<T>::allocateSlot(const std::string_view assetPath)
+    {
+        const std::scoped_lock lock(m_freeSlotMutex);
+        if (m_freeSlotIndices.empty())
+        {
+            fatalError(std::format("Asset registry is full ({} assets), {} can not be loaded.", m_maxAssetCount, assetPath));
+        }
+
+        const uint32_t slotIndex = m_freeSlotIndices.back();
+        m_freeSlotIndices.pop_back();
+
+        return Handle{slotIndex, m_slots[slotIndex].generation.load(std::memory_order_relaxed)};
+    }
+
+    template <typename T> inline void AssetRegistry<T>::waitUntilLoaded(const Handle handle)
+    {
+        Slot& slot = m_slots[handle.index];
+        slot.state.wait(AssetState::Loading, std::memory_order_acquire);
+
+        if (slot.state.load(std::memory_order_acquire) == AssetState::Failed)
+        {
+            // Copied first, the slot can be freed as soon as the reference is dropped.
+            const std::exception_ptr loadException = slot.loadException;
+            release(handle);
+            std::rethrow_exception(loadException);
+        }
+    }
+
+    template <typename T> inline typename AssetRegistry<T>::Slot& AssetRegistry<T>::getLoadingSlot(const Handle handle, const std::string_view operation)
+    {
+        Slot& slot = m_slots[handle.index];
+        if (slot.generation.load(std::memory_order_relaxed) != handle.generation || slot.state.load(std::memory_order_relaxed) != AssetState::Loading)
+        {
+            fatalError(std::format("AssetRegistry::{} called for slot {}, which is not loading (or was reused).", operation, handle.index));
+        }
+
+        return slot;
+    }
+
+    template <typename T> inline bool AssetRegistry<T>::destroyIfUnused(const RetiredAsset& retiredAsset)
+    {
+        Slot& slot = m_slots[retiredAsset.index];
+
+        // Already freed, by an earlier entry of the same release frame.
+        if (slot.generation.load(std::memory_order_relaxed) != retiredAsset.generation)
+        {
+            return true;
+        }
+
+        {
+            Shard& shard = m_shards[slot.shardIndex];
+            const std::unique_lock lock(shard.mutex);
+
+            // Acquired again since (if it was released again as well, a later entry destroys it).
+            if (slot.referenceCount.load(std::memory_order_relaxed) != 0u || slot.releaseFrame != retiredAsset.releaseFrame)
+            {
+                return true;
+            }
+
+            // Released before its load completed. The path still leads to the slot, and finishLoad / failLoad will write to it, so it can not be reused yet.
+            const AssetState state = slot.state.load(std::memory_order_acquire);
+            if (state == AssetState::Loading)
+            {
+                return false;
+            }
+
+            if (state == AssetState::Loaded)
+            {
+                shard.slotIndices.erase(slot.path);
+            }
+
+            slot.generation.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        // Nothing can reach the slot anymore, so the asset is destroyed without holding the shard's lock.
+        if (slot.asset && m_destroyer)
+        {
+            m_destroyer(*slot.asset);
+        }
+
+        slot.asset.reset();
+        slot.loadException = nullptr;
+
+        const std::scoped_lock lock(m_freeSlotMutex);
+        m_freeSlotIndices.push_back(retiredAsset.index);
+
+        return true;
+    }
+}
@@ -15,6 +15,14 @@ namespace nether
         TotalKeys
     };
 
+    // Everything the view matrix depends on, so that camera movement can be recorded and replayed (see CameraPath).
+    struct CameraState
+    {
+        math::XMFLOAT3 position{};
+        float pitch{};
+        float yaw{};
+    };
+
     class Camera
     {
       public:
@@ -23,6 +31,9 @@ namespace nether
 
         math::XMMATRIX getLookAtMatrix();
 
+        CameraState getState() const;
+        void setState(const CameraState& state);
+
       private:
         // Note that the default values for the vectors must be set correctly (especially the W component).
         math::XMFLOAT4 m_cameraPosition{0.0f, 0.0f, -5.0f, 1.0f};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Camera.hpp"
+
+namespace nether
+{
+    // The camera state of consecutive frames. Recorded in the engine (from the "Camera path" window), and replayed by the frame replay benchmark so that the same views
+    // are rendered on every run.
+    class CameraPath
+    {
+      public:
+        // A camera circling the origin at the given radius and height, looking at the origin. Used when no recorded path is given.
+        static CameraPath createOrbit(const uint32_t frameCount, const float radius, const float height);
+
+        // The file is plain text, with one frame per line : position x, y, z, pitch and yaw. Failing to read or write the file is a fatal error.
+        static CameraPath load(const std::filesystem::path& filePath);
+        void save(const std::filesystem::path& filePath) const;
+
+        void addFrame(const CameraState& cameraState) { m_frames.push_back(cameraState); }
+        void clear() { m_frames.clear(); }
+
+        std::span<const CameraState> getFrames() const { return m_frames; }
+
+      private:
+        std::vector<CameraState> m_frames{};
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Instruction set extensions the engine has optional code paths for. The build only assumes x64 (SSE2), functions that use more than that are compiled for the extension
+// one by one (with the macros below), and are only called if the CPU supports it.
+
+// Marks a function that uses AVX2 intrinsics, only that function is compiled for AVX2. MSVC allows the intrinsics in any function.
+// Code shared with the scalar path (e.g a template instantiated for both a float and a 8 wide lane type) must be NETHER_FORCE_INLINE : it is then compiled as part of the
+// AVX2 function that calls it. A out of line call would pass the 256 bit values between code compiled with and without AVX, which use different calling conventions.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NETHER_AVX2_FUNCTION
+#define NETHER_FORCE_INLINE __forceinline
+#else
+#define NETHER_AVX2_FUNCTION __attribute__((target("avx2")))
+#define NETHER_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace nether::CpuFeatures
+{
+    // AVX2, and OS support for saving the 256 bit registers. Checked once, then cached.
+    [[nodiscard]] bool isAvx2Supported();
+}
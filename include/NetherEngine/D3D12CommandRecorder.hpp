@@ -0,0 +1,22 @@
+#pragma once
+
+#include "GraphicsBackend.hpp"
+
+namespace nether
+{
+    // Records into a chunk command list of the D3D12 backend. The state every chunk needs (descriptor heaps, root signature, render targets) is set by
+    // D3D12GraphicsBackend::beginChunk.
+    class D3D12CommandRecorder final : public CommandRecorder
+    {
+      public:
+        void reset(ID3D12GraphicsCommandList2* const commandList, ID3D12CommandSignature* const drawIndirectCommandSignature, ID3D12Resource* const indirectCommandBuffer);
+
+        void setGraphicsPipeline(const GraphicsPipeline& graphicsPipeline) override;
+        void drawIndirect(const uint32_t firstRecord, const uint32_t recordCount) override;
+
+      private:
+        ID3D12GraphicsCommandList2* m_commandList{};
+        ID3D12CommandSignature* m_drawIndirectCommandSignature{};
+        ID3D12Resource* m_indirectCommandBuffer{};
+    };
+}
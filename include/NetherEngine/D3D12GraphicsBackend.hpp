@@ -0,0 +1,258 @@
+#pragma once
+
+#include "D3D12CommandRecorder.hpp"
+#include "RenderGraph.hpp"
+
+// The D3D12 implementation of GraphicsBackend. Owns the device, the command queues, the descriptor heaps, the swapchain and the per frame buffers, and records the render
+// graph barriers and the UI around the chunks recorded by the frame renderer. Only built on Windows.
+namespace nether
+{
+    struct D3D12GraphicsBackendDesc
+    {
+        HWND windowHandle{};
+        Uint2 windowDimensions{};
+
+        // One chunk command list per thread that can record.
+        uint32_t maxChunkCount{};
+
+        // Capacity of the per frame instance and indirect command buffers.
+        uint32_t maxInstanceCount{};
+
+        // Meshes and textures that can exist at once, which the CBV / SRV / UAV heap is sized for.
+        uint32_t maxMeshCount{};
+        uint32_t maxTextureCount{};
+
+        // Textures with mips that one upload batch can hold, which the constants and UAVs of the mip generation dispatches are sized for.
+        uint32_t maxUploadBatchTextureCount{};
+    };
+
+    class D3D12GraphicsBackend final : public GraphicsBackend
+    {
+      public:
+        // ImGui's context must exist, as the backend sets up ImGui's D3D12 renderer.
+        explicit D3D12GraphicsBackend(const D3D12GraphicsBackendDesc& desc);
+        ~D3D12GraphicsBackend() override;
+
+        D3D12GraphicsBackend(const D3D12GraphicsBackend&) = delete;
+        D3D12GraphicsBackend& operator=(const D3D12GraphicsBackend&) = delete;
+
+        [[nodiscard]] IndexBuffer createIndexBuffer(const std::byte* data, const uint32_t bufferSize, const std::wstring_view indexBufferName) override;
+        [[nodiscard]] StructuredBuffer createStructuredBuffer(const std::byte* data, const uint32_t numberOfComponents, const uint32_t stride, const std::wstring_view bufferName) override;
+
+        [[nodiscard]] Texture createTexture(const std::string_view texturePath, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName) override;
+        [[nodiscard]] Texture createTexture(const ImageData& image, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName) override;
+
+        void setMipMapGenerationShader(const Shader& computeShader) override;
+
+        void beginUploadBatch() override;
+        void submitUploadBatch() override;
+        [[nodiscard]] bool completeUploadBatch(const bool waitForGPU) override;
+
+        [[nodiscard]] GraphicsPipeline createGraphicsPipeline(const Shader& vertexShader, const Shader& pixelShader, const std::wstring_view pipelineName) override;
+
+        uint32_t getMaxChunkCount() const override { return static_cast<uint32_t>(m_commandRecorders.size()); }
+
+        FrameBuffers beginFrame() override;
+        CommandRecorder& beginChunk(const uint32_t chunkIndex) override;
+        void setUIDrawData(const ImDrawData* const uiDrawData) override { m_uiDrawData = uiDrawData; }
+        void submitFrame(const uint32_t chunkCount) override;
+
+        void flushGPU() override;
+
+        void destroyStructuredBuffer(StructuredBuffer& structuredBuffer) override;
+        void destroyTexture(Texture& texture) override;
+
+      private:
+        FrameResources& getCurrentFrameResources() { return m_frameResources[m_frameIndex]; }
+
+        void initDevice();
+        void initDescriptorHeaps(const uint32_t maxMeshCount, const uint32_t maxTextureCount, const uint32_t maxUploadBatchTextureCount);
+        void initCommandObjects(const uint32_t maxChunkCount);
+        void initSyncPrimitives();
+        void initSwapchain(const HWND windowHandle);
+        void initRenderGraph();
+        void initImgui();
+        void initRootSignature();
+        void initFrameBuffers();
+        void initMipGenerationData(const uint32_t maxUploadBatchTextureCount);
+
+        void executeCopyCommands();
+        void executeComputeCommands();
+
+        // While an upload batch is recorded, copies go to the batch's command list, and the upload buffer is kept alive until the batch completes. Otherwise the copy
+        // list is executed (and waited for) right away.
+        ID3D12GraphicsCommandList2* getCopyCommandList() const;
+        void submitCopyCommands(Comptr<ID3D12Resource> uploadBuffer);
+
+        // If data is nullptr, a buffer with CPU / GPU access will be created. Else, a GPU only buffer will be created.
+        [[nodiscard]] Comptr<ID3D12Resource> createBuffer(const D3D12_RESOURCE_DESC& bufferResourceDesc, const std::byte* data, const std::wstring_view bufferName);
+
+        template <typename T> [[nodiscard]] ConstantBuffer<T> createConstantBuffer(const std::wstring_view constantBufferName);
+
+        // Copy of the mip generation pipeline, which keeps it alive for as long as the command lists recorded with it run, even if the shader is reloaded meanwhile.
+        ComputePipeline getMipMapGenerationPipeline();
+
+        // Records the dispatches that generate the mip chains of the textures into one compute command list, and adds the UAVs they write to uavIndices (to be
+        // released once the list ran). The dispatch constants are written to the slots of m_mipGenerationData, so only one recorded list can be pending at a time.
+        void recordMipGeneration(ID3D12GraphicsCommandList2* const commandList,
+                                 const ComputePipeline& pipeline,
+                                 const std::span<const Texture> textures,
+                                 std::vector<uint32_t>& uavIndices);
+
+        // Generates the mips of a texture created outside of an upload batch, and waits for it.
+        void generateMips(const Texture& texture);
+
+        // Maps a render graph resource handle to the D3D12 resource it refers to this frame.
+        ID3D12Resource* getRenderGraphResource(const RenderGraphResource resource);
+
+        // Translate the barriers of a compiled render graph pass, and submit them as one batch.
+        void recordRenderGraphBarriers(ID3D12GraphicsCommandList* const commandList, const std::span<const RenderGraphBarrier> barriers);
+
+      private:
+        // SRVs of the position, texture coordinate and normal buffers (the index buffer is bound through a view, not a descriptor), and of the texture.
+        static constexpr uint32_t MESH_DESCRIPTOR_COUNT = 3u;
+        static constexpr uint32_t TEXTURE_DESCRIPTOR_COUNT = 1u;
+
+        // Scene CBV, instance buffer SRV and indirect command buffer SRV of every frame, and the ImGui font SRV.
+        static constexpr uint32_t BACKEND_DESCRIPTOR_COUNT = FRAME_COUNT * 3u + 1u;
+
+        // Every dispatch writes at least one mip level below the top one, and every such level is written through one UAV. Per texture of an upload batch, the
+        // dispatches take a constant buffer slot (with its CBV) each, and the UAVs are released once the batch completes.
+        static constexpr uint32_t MAX_MIP_GENERATION_DISPATCH_COUNT_PER_TEXTURE = D3D12_REQ_MIP_LEVELS - 1u;
+        static constexpr uint32_t MIP_GENERATION_DESCRIPTOR_COUNT_PER_TEXTURE = MAX_MIP_GENERATION_DISPATCH_COUNT_PER_TEXTURE * 2u;
+
+      private:
+        Uint2 m_windowDimensions{};
+
+        D3D12_VIEWPORT m_viewport{};
+        D3D12_RECT m_scissorRect{};
+
+        Comptr<IDXGIFactory6> m_factory{};
+        Comptr<IDXGIAdapter2> m_adapter{};
+        Comptr<ID3D12Device5> m_device{};
+
+        Comptr<ID3D12CommandQueue> m_directCommandQueue{};
+        std::array<FrameResources, FRAME_COUNT> m_frameResources{};
+
+        Comptr<ID3D12CommandQueue> m_copyCommandQueue{};
+        Comptr<ID3D12Fence> m_copyFence{};
+
+        Comptr<ID3D12CommandAllocator> m_copyCommandAllocator{};
+        Comptr<ID3D12GraphicsCommandList2> m_copyCommandList{};
+
+        Comptr<ID3D12CommandQueue> m_computeCommandQueue{};
+        Comptr<ID3D12Fence> m_computeFence{};
+
+        Comptr<ID3D12CommandAllocator> m_computeCommandAllocator{};
+        Comptr<ID3D12GraphicsCommandList2> m_computeCommandList{};
+
+        uint64_t m_copyFenceValue{};
+        uint64_t m_computeFenceValue{};
+
+        uint32_t m_frameIndex{};
+
+        Comptr<ID3D12Fence1> m_fence{};
+        HANDLE m_fenceEvent{};
+
+        DescriptorHeap m_rtvDescriptorHeap{};
+        DescriptorHeap m_dsvDescriptorHeap{};
+        DescriptorHeap m_cbvSrvUavDescriptorHeap{};
+
+        std::array<Comptr<ID3D12Resource>, FRAME_COUNT> m_backBuffers{};
+        Comptr<IDXGISwapChain3> m_swapchain{};
+
+        Comptr<ID3D12Resource> m_depthStencilTexture{};
+
+        RenderGraph m_renderGraph{};
+        RenderGraphResource m_backBufferResource{};
+        RenderGraphResource m_depthStencilResource{};
+        RenderGraphPass m_forwardPass{};
+        RenderGraphPass m_uiPass{};
+
+        // Memory that all transient render graph resources are placed in.
+        Comptr<ID3D12Heap> m_transientHeap{};
+        std::vector<D3D12_RESOURCE_BARRIER> m_resourceBarriers{};
+
+        Comptr<ID3D12RootSignature> m_bindlessRootSignature{};
+        Comptr<ID3D12CommandSignature> m_drawIndirectCommandSignature{};
+
+        uint32_t m_maxInstanceCount{};
+
+        // Recorded into its own command list, so the batch can be in flight on the copy queue while other copies are executed. fenceValue is 0 when no batch is in
+        // flight.
+        struct UploadBatch
+        {
+            Comptr<ID3D12CommandAllocator> commandAllocator{};
+            Comptr<ID3D12GraphicsCommandList2> commandList{};
+
+            bool isRecording{false};
+            uint64_t fenceValue{};
+
+            std::vector<Comptr<ID3D12Resource>> uploadBuffers{};
+
+            // Textures that get their mips once the batch is uploaded. The compute list waits for the copy queue on the GPU, and computeFenceValue is 0 if the batch
+            // has no such textures.
+            std::vector<Texture> mipMappedTextures{};
+
+            Comptr<ID3D12CommandAllocator> computeCommandAllocator{};
+            Comptr<ID3D12GraphicsCommandList2> computeCommandList{};
+            uint64_t computeFenceValue{};
+
+            ComputePipeline mipMapGenerationPipeline{};
+            std::vector<uint32_t> mipGenerationUavIndices{};
+        };
+
+        UploadBatch m_uploadBatch{};
+
+        std::vector<D3D12CommandRecorder> m_commandRecorders{};
+        std::vector<ID3D12CommandList*> m_submittedCommandLists{};
+
+        // Set by the render thread before it submits a frame with UI.
+        const ImDrawData* m_uiDrawData{};
+
+        // The constants of every mip generation dispatch of a command list, in a slot of their own (with its own CBV), so a whole upload batch is recorded into one
+        // list. Persistently mapped.
+        struct MipGenerationData
+        {
+            Comptr<ID3D12Resource> buffer{};
+            GenerateMipMapData* bufferPointer{};
+            std::vector<uint32_t> cbvIndices{};
+        };
+
+        MipGenerationData m_mipGenerationData{};
+        uint32_t m_maxUploadBatchTextureCount{};
+
+        // Replaced by the render thread when the shader is reloaded, while the simulation thread records upload batches with it.
+        std::mutex m_mipMapGenerationPipelineMutex{};
+        ComputePipeline m_mipMapGenerationPipeline{};
+    };
+
+    template <typename T> inline ConstantBuffer<T> D3D12GraphicsBackend::createConstantBuffer(const std::wstring_view constantBufferName)
+    {
+        ConstantBuffer<T> constantBuffer{};
+
+        const D3D12_RESOURCE_DESC constantBufferResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0u,
+            .Width = sizeof(T),
+            .Height = 1u,
+            .DepthOrArraySize = 1u,
+            .MipLevels = 1u,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc = {1u, 0u},
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE,
+        };
+
+        constantBuffer.buffer = createBuffer(constantBufferResourceDesc, nullptr, constantBufferName);
+        const D3D12_CONSTANT_BUFFER_VIEW_DESC constantBufferConstantBufferViewDesc = {
+            .BufferLocation = constantBuffer.buffer->GetGPUVirtualAddress(),
+            .SizeInBytes = sizeof(T),
+        };
+
+        constantBuffer.cbvIndex = m_cbvSrvUavDescriptorHeap.allocate();
+        m_device->CreateConstantBufferView(&constantBufferConstantBufferViewDesc, m_cbvSrvUavDescriptorHeap.getCpuDescriptorHandleAtIndex(constantBuffer.cbvIndex));
+
+        return constantBuffer;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Hands out the slots of a descriptor heap (see DescriptorHeap in Types.hpp). Only depends on the standard library, so it is tested without a device.
+namespace nether
+{
+    // Slots are handed out in order until the heap has been used up once, and after that from the slots that were released. Running out of slots is a fatal error, as
+    // writing past the end of a descriptor heap is undefined behaviour. A slot must only be released once the GPU is done with it (assets are released
+    // ASSET_RETIRE_LATENCY frames after their last use, see Engine.hpp). Thread safe.
+    class DescriptorAllocator
+    {
+      public:
+        DescriptorAllocator() = default;
+
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        // The name is only used for error messages.
+        void init(const uint32_t capacity, const std::string_view name);
+
+        [[nodiscard]] uint32_t allocate();
+        void release(const uint32_t index);
+
+        uint32_t getCapacity() const { return m_capacity; }
+
+        // Slots that are allocated and not released.
+        uint32_t getAllocatedCount() const;
+
+      private:
+        std::string m_name{};
+        uint32_t m_capacity{};
+
+        mutable std::mutex m_mutex{};
+
+        // Slots at or above this index were never handed out.
+        uint32_t m_nextUnusedIndex{};
+        std::vector<uint32_t> m_freeIndices{};
+    };
+}
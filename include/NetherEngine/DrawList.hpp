@@ -0,0 +1,59 @@
+#pragma once
+
+#include "LinearArena.hpp"
+#include "Scene.hpp"
+
+namespace nether
+{
+    // A single instanced draw. All instances share the pipeline, mesh and material.
+    struct InstancedDraw
+    {
+        GraphicsPipeline* graphicsPipeline{};
+        Mesh* mesh{};
+        uint32_t albedoTextureIndex{};
+
+        uint32_t indexCount{};
+
+        // Range of this draw's instances in DrawList::getInstanceIndices (and hence in the per frame instance buffer).
+        uint32_t firstInstance{};
+        uint32_t instanceCount{};
+    };
+
+    // Builds the list of draws for a frame. Renderables with identical pipeline / mesh / material are merged into a single instanced draw, and draws are sorted by pipeline,
+    // then mesh, so that state changes are minimized. CPU only, the caller is responsible for filling the instance buffer and recording the draws.
+    class DrawList
+    {
+      public:
+        // The renderables are indexed by the scene's dense index. The internal arrays are reused across frames, so in steady state no allocations are made.
+        void build(const std::span<const Renderable> renderables);
+
+        // Only includes the renderables at the given dense indices (e.g the output of FrustumCuller).
+        void build(const std::span<const Renderable> renderables, const std::span<const uint32_t> visibleIndices);
+
+        std::span<const InstancedDraw> getDraws() const { return m_draws; }
+
+        // Dense index of the renderable for each instance, in draw order.
+        std::span<const uint32_t> getInstanceIndices() const { return m_instanceIndices; }
+
+      private:
+        struct SortEntry
+        {
+            GraphicsPipeline* graphicsPipeline{};
+            Mesh* mesh{};
+            uint32_t albedoTextureIndex{};
+            uint32_t denseIndex{};
+        };
+
+        // Only needed while building, so they live in the calling thread's scratch arena.
+        using SortEntries = ArenaVector<SortEntry>;
+
+        static void addSortEntry(SortEntries& sortEntries, const Renderable& renderable, const uint32_t denseIndex);
+
+        // Sorts the entries and merges them into draws.
+        void buildDraws(SortEntries& sortEntries);
+
+      private:
+        std::vector<InstancedDraw> m_draws{};
+        std::vector<uint32_t> m_instanceIndices{};
+    };
+}
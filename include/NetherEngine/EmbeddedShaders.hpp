@@ -0,0 +1,18 @@
+#pragma once
+
+// Shader bytecode compiled offline by "premake5 bake-shaders" (see premake5.lua) and linked into Shipping builds, so they start without compiling any shader. Only depends
+// on the standard library.
+namespace nether
+{
+    struct EmbeddedShader
+    {
+        // "<shader path>|<shader type>|<define>;<define>;...", see ShaderCompiler::getEmbeddedShaderKey.
+        std::string_view key{};
+
+        const uint8_t* bytecode{};
+        size_t bytecodeSize{};
+    };
+
+    // Defined in generated/EmbeddedShaders.cpp in Shipping builds. Other builds compile shaders at runtime, and get a empty list.
+    std::span<const EmbeddedShader> getEmbeddedShaders();
+}
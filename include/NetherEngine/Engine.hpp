@@ -1,11 +1,25 @@
 #pragma once
 
 #include "Camera.hpp"
+#include "CameraPath.hpp"
+#include "Scene.hpp"
+#include "FrameBuilder.hpp"
+#include "ParallelRecorder.hpp"
+#include "FramePacket.hpp"
+#include "GraphicsBackend.hpp"
+#include "FrameRenderer.hpp"
+#include "ShaderReloader.hpp"
+#include "TripleBuffer.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
+#include "AssetRegistry.hpp"
+#include "AssetPipeline.hpp"
 
 struct SDL_Window;
 
 namespace nether
 {
+    // Owns the window, the scene and the assets, and renders through a graphics backend (D3D12GraphicsBackend), which owns everything on the GPU side.
     class Engine
     {
       public:
@@ -13,25 +27,38 @@ namespace nether
         void run();
 
       private:
-        void update(const float deltaTime);
-        void render();
+        // Simulation thread. Runs the UI and the scene update, and fills the packet of the next frame.
+        void updateUI();
+        void updateProfilerUI();
+        void updateAllocationsUI();
+        void update(const float deltaTime, FramePacket& framePacket);
+        void copyUIDrawData(FramePacket& framePacket);
 
-        void flushGPU();
+        // Collects the allocations of the frame, and enters steady state once the engine has warmed up (see AllocationTracker.hpp).
+        void trackFrameAllocations();
 
-      private:
-        FrameResources& getCurrentFrameResources() { return m_frameResources[m_frameIndex]; }
+        // Requests the asset from the asset pipeline, unless it is already registered. The asset can be used once the registry reports it as loaded.
+        [[nodiscard]] MeshHandle loadMeshAsync(const std::string_view meshPath);
+        [[nodiscard]] TextureHandle loadTextureAsync(const std::string_view texturePath);
 
-        void initPlatformBackend();
+        // Upload stage of the asset pipeline. Completes the upload batch in flight once the copy queue is done with it, and records the next batch from the decoded
+        // assets. Never waits for the GPU.
+        void uploadDecodedAssets();
 
-        void initGraphicsBackend();
+        // Publishes the assets of the batch in flight to the registries. Returns false if the copy queue is not done with it yet, unless waitForGPU is set.
+        bool completeUploadBatch(const bool waitForGPU);
 
-        void initDescriptorHeaps();
-        void initCommandObjects();
-        void initSyncPrimitives();
-        void initSwapchain();
+        // Swaps the placeholders of renderables for their assets, once these are loaded.
+        void resolvePendingRenderables();
 
-        void initImgui();
+        // Render thread. Records and submits the packets published by the simulation thread until stopped.
+        void renderLoop(const std::stop_token stopToken);
+        void render(const FramePacket& framePacket);
 
+      private:
+        void initPlatformBackend();
+
+        void initImgui();
 
         void initPipelines();
 
@@ -41,29 +68,46 @@ namespace nether
         void initTextures();
         void initScene();
 
-        void executeCopyCommands();
-        void executeComputeCommands();
+        // Recreates the pipelines whose shaders were recompiled by the shader reloader. Must be called between frames, on the render thread.
+        void reloadShaders();
 
       private:
-        // If data is nullptr, a buffer with CPU / GPU access will be created. Else, a GPU only buffer will be created.
-        [[nodiscard]] Comptr<ID3D12Resource> createBuffer(const D3D12_RESOURCE_DESC& bufferResourceDesc, const std::byte* data, const std::wstring_view bufferName);
+        // The buffers are created through the graphics backend, so the mesh is uploaded with the upload batch if one is recorded.
+        [[nodiscard]] Mesh createMesh(const std::string_view meshPath);
+        [[nodiscard]] Mesh createMesh(const MeshData& meshData, const std::wstring_view meshName);
+        void destroyMesh(Mesh& mesh);
+
+        // Add the newly created pipeline (see GraphicsBackend::createGraphicsPipeline) to the unordered map.
+        void createPipeline(const Shader& vertexShader, const Shader& pixelShader, const std::wstring pipelineName);
 
-        [[nodiscard]] Texture createTexture(const std::string_view texturePath, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName);
+      public:
+        static constexpr uint32_t MAX_INSTANCE_COUNT = 16384u;
 
-        // Helper functions for creating specific types of buffers (structured byffer, index, constant etc). Might be removed eventually, or made into templated functions.
-        [[nodiscard]] IndexBuffer createIndexBuffer(const std::byte* data, const uint32_t bufferSize, const std::wstring_view indexBufferName);
-        [[nodiscard]] StructuredBuffer createStructuredBuffer(const std::byte* data, const uint32_t numberOfComponents, const uint32_t stride, const std::wstring_view bufferName);
-        template <typename T> [[nodiscard]] ConstantBuffer<T> createConstantBuffer(const std::wstring_view constantBufferName);
+        static constexpr uint32_t MAX_MESH_COUNT = 1024u;
+        static constexpr uint32_t MAX_TEXTURE_COUNT = 1024u;
 
-        [[nodiscard]] Mesh createMesh(const std::string_view meshPath);
+        // Frames a released asset is kept alive for : the simulation thread is one packet ahead of the render thread, which is FRAME_COUNT frames ahead of the GPU.
+        static constexpr uint64_t ASSET_RETIRE_LATENCY = GraphicsBackend::FRAME_COUNT + 1u;
 
-        // Add the newly created pipeline to the unordered map.
-        void createPipeline(const std::wstring vertexShaderPath, const std::wstring pixelShaderPath, const std::wstring pipelineName);
+        // Decoded assets uploaded per batch (and so per frame), which bounds the time uploadDecodedAssets takes.
+        static constexpr uint32_t MAX_UPLOAD_BATCH_SIZE = 8u;
 
-        void generateMips(Texture& texture);
+        // Relative to the working directory, like the paths of the assets in it.
+        static constexpr std::string_view ASSET_ARCHIVE_PATH = "assets.pak";
 
-      public:
-        static constexpr uint32_t FRAME_COUNT = 2u;
+        // Feature bits of the shaders/PhongShader.hlsl variants.
+        static constexpr ShaderVariantKey PHONG_FEATURE_SPECULAR = 1u << 0u;
+        static constexpr ShaderVariantKey PHONG_FEATURE_DIRECTIONAL_LIGHT = 1u << 1u;
+        static constexpr uint32_t PHONG_FEATURE_COUNT = 2u;
+
+        // Number of recent frames shown in the timeline of the profiler window.
+        static constexpr uint32_t PROFILER_TIMELINE_FRAME_COUNT = 3u;
+
+        // Frames until the frame loop is expected not to allocate anymore (arenas and arrays have reached their working size, and every packet was written once).
+        static constexpr uint32_t ALLOCATION_WARM_UP_FRAME_COUNT = 8u;
+
+        // Written to the working directory, and read by the frame replay benchmark (see benchmarks/FrameReplay.hpp).
+        static constexpr std::string_view CAMERA_PATH_FILE = "camera_path.txt";
 
       private:
         SDL_Window* m_window{};
@@ -71,95 +115,90 @@ namespace nether
 
         Uint2 m_windowDimensions{};
 
-        D3D12_VIEWPORT m_viewport{};
-        D3D12_RECT m_scissorRect{};
-
-        Comptr<IDXGIFactory6> m_factory{};
-        Comptr<IDXGIAdapter2> m_adapter{};
-        Comptr<ID3D12Device5> m_device{};
-
-        Comptr<ID3D12CommandQueue> m_directCommandQueue{};
-        std::array<FrameResources, FRAME_COUNT> m_frameResources{};
+        uint32_t m_frameCount{};
 
-        Comptr<ID3D12CommandQueue> m_copyCommandQueue{};
-        Comptr<ID3D12Fence> m_copyFence{};
+        // Created once the window exists. Only used by the render thread once the engine is initialized, except for the upload batches of the simulation thread.
+        std::unique_ptr<GraphicsBackend> m_graphicsBackend{};
 
-        Comptr<ID3D12CommandAllocator> m_copyCommandAllocator{};
-        Comptr<ID3D12GraphicsCommandList2> m_copyCommandList{};
+        std::unordered_map<std::wstring, GraphicsPipeline> m_graphicsPipelines{};
 
-        Comptr<ID3D12CommandQueue> m_computeCommandQueue{};
-        Comptr<ID3D12Fence> m_computeFence{};
+        // Indexed by the variant key (a combination of PHONG_FEATURE_* bits). Points into m_graphicsPipelines.
+        std::array<GraphicsPipeline*, 1u << PHONG_FEATURE_COUNT> m_basePipelineVariants{};
 
-        Comptr<ID3D12CommandAllocator> m_computeCommandAllocator{};
-        Comptr<ID3D12GraphicsCommandList2> m_computeCommandList{};
+        // Decodes assets, compiles shaders and records command lists. Declared before the members that use it, so it outlives them.
+        JobSystem m_jobSystem{};
 
-        uint64_t m_copyFenceValue{};
-        uint64_t m_computeFenceValue{};
+        // Indexed by the program index returned by ShaderReloader::addProgram. Recreates the pipeline(s) built from the program's shaders.
+        ShaderReloader m_shaderReloader{m_jobSystem};
+        std::vector<std::function<void(std::span<const Shader>)>> m_pipelineRebuilders{};
 
-        uint32_t m_frameIndex{};
-        uint32_t m_frameCount{};
+        // Destroyed assets return their descriptors to the graphics backend, which the GPU is done with by then.
+        AssetRegistry<Mesh> m_meshes{MAX_MESH_COUNT, ASSET_RETIRE_LATENCY, [this](Mesh& mesh) { destroyMesh(mesh); }};
+        AssetRegistry<Texture> m_textures{MAX_TEXTURE_COUNT, ASSET_RETIRE_LATENCY, [this](Texture& texture) { m_graphicsBackend->destroyTexture(texture); }};
 
-        Comptr<ID3D12Fence1> m_fence{};
-        HANDLE m_fenceEvent{};
+        MeshHandle m_cubeMesh{};
+        TextureHandle m_albedoTexture{};
 
-        DescriptorHeap m_rtvDescriptorHeap{};
-        DescriptorHeap m_dsvDescriptorHeap{};
-        DescriptorHeap m_cbvSrvUavDescriptorHeap{};
+        // Used by renderables whose assets are still loading, so the first frame does not wait for any asset.
+        Mesh m_placeholderMesh{};
+        Texture m_placeholderTexture{};
 
-        std::array<Comptr<ID3D12Resource>, FRAME_COUNT> m_backBuffers{};
-        Comptr<IDXGISwapChain3> m_swapchain{};
+        struct PendingRenderable
+        {
+            EntityHandle entity{};
+            MeshHandle mesh{};
+            TextureHandle albedoTexture{};
+        };
 
-        Comptr<ID3D12Resource> m_depthStencilTexture{};
+        std::vector<PendingRenderable> m_pendingRenderables{};
 
-        Comptr<ID3D12RootSignature> m_bindlessRootSignature{};
+        // Empty unless ASSET_ARCHIVE_PATH exists. Opened before any asset is requested, and read by the asset pipeline.
+        AssetArchive m_assetArchive{};
 
-        std::unordered_map<std::wstring, GraphicsPipeline> m_graphicsPipelines{};
+        // Decodes on the job system's workers. The simulation thread is the upload stage.
+        AssetPipeline m_assetPipeline{m_jobSystem, AssetPipelineDesc{.assetArchive = &m_assetArchive}};
 
-        std::unordered_map<std::wstring, Mesh> m_meshes{};
-        std::unordered_map<std::wstring, Texture> m_textures{};
+        // Assets of the upload batch in flight in the graphics backend, handed to their registries once the batch completes.
+        struct UploadBatch
+        {
+            std::vector<std::pair<MeshHandle, Mesh>> meshes{};
+            std::vector<std::pair<TextureHandle, Texture>> textures{};
+        };
 
-        std::unordered_map<std::wstring, Renderable> m_renderables{};
+        UploadBatch m_uploadBatch{};
+        std::vector<DecodedAsset> m_decodedAssets{};
 
-        Camera m_camera{};
+        Scene m_scene{};
+        EntityHandle m_lightEntity{};
 
-        bool m_showUI{true};
+        FrameBuilder m_frameBuilder{};
+        FrameRenderer m_frameRenderer{};
 
-        math::XMFLOAT3 m_directionalLightColor{1.0f, 1.0f, 1.0f};
-        math::XMFLOAT3 m_directionalLightPosition{};
+        ParallelRecorder m_parallelRecorder{m_jobSystem};
 
-        ConstantBuffer<GenerateMipMapData> m_mipGenBuffer{};
-        ComputePipeline m_mipMapGenerationPipeline{};
-    };
+        // Packets are handed from the simulation thread (the thread that calls run) to the render thread. Once the engine is initialized, the scene, draw list, camera
+        // and UI state are only used by the simulation thread, and the graphics objects only by the render thread.
+        TripleBuffer<FramePacket> m_framePackets{};
+        std::exception_ptr m_renderException{};
 
-    template <typename T> inline ConstantBuffer<T> Engine::createConstantBuffer(const std::wstring_view constantBufferName)
-    {
-        ConstantBuffer<T> constantBuffer{};
-
-        const D3D12_RESOURCE_DESC constantBufferResourceDesc = {
-            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
-            .Alignment = 0u,
-            .Width = sizeof(T),
-            .Height = 1u,
-            .DepthOrArraySize = 1u,
-            .MipLevels = 1u,
-            .Format = DXGI_FORMAT_UNKNOWN,
-            .SampleDesc = {1u, 0u},
-            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
-            .Flags = D3D12_RESOURCE_FLAG_NONE,
-        };
+        Camera m_camera{};
 
-        constantBuffer.buffer = createBuffer(constantBufferResourceDesc, nullptr, constantBufferName);
-        const D3D12_CONSTANT_BUFFER_VIEW_DESC constantBufferConstantBufferViewDesc = {
-            .BufferLocation = constantBuffer.buffer->GetGPUVirtualAddress(),
-            .SizeInBytes = sizeof(T),
-        };
+        // Recorded from the "Camera path" window, and saved to CAMERA_PATH_FILE when recording stops.
+        CameraPath m_cameraPath{};
+        bool m_isRecordingCameraPath{false};
 
-        m_device->CreateConstantBufferView(&constantBufferConstantBufferViewDesc, m_cbvSrvUavDescriptorHeap.currentCpuDescriptorHandle);
+        bool m_showUI{true};
 
-        constantBuffer.cbvIndex = m_cbvSrvUavDescriptorHeap.currentDescriptorIndex;
+        // State of the profiler window, only used by the simulation thread.
+        Profiler::ProfileCapture m_profilerTimeline{};
+        int32_t m_profilerCaptureFrameCount{60};
+        uint32_t m_profilerCaptureFramesRemaining{};
 
-        m_cbvSrvUavDescriptorHeap.offset();
+        // Allocations of the last frame, shown in the allocations window.
+        AllocationTracker::FrameAllocations m_frameAllocations{};
 
-        return constantBuffer;
-    }
+        math::XMFLOAT3 m_lightColor{1.0f, 1.0f, 1.0f};
+        math::XMFLOAT3 m_directionalLightColor{1.0f, 1.0f, 1.0f};
+        math::XMFLOAT3 m_directionalLightPosition{};
+    };
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+// Detects changes to a set of files. The OS notifies the watcher of changes in the directories of the watched files (inotify on Linux, change notifications on
+// Windows), and only the files of directories with notifications have their last write time checked. Directories are watched rather than files, as editors often
+// replace a file instead of writing to it. Without notifications (they are disabled, or the OS refused to watch a directory), the files are polled instead.
+// Editors often save a file in several steps (truncate, write, rename), so changes are debounced: they are only reported once no watched file has changed for the
+// debounce duration, and all files that changed in the meantime are reported together.
+// Only depends on the standard library (and the OS).
+namespace nether
+{
+    class FileWatcher
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit FileWatcher(const Clock::duration debounceDuration, const bool useNativeNotifications = true);
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        // Watching a file that is already watched does nothing.
+        void watch(const std::filesystem::path& filePath);
+
+        // Returns the files whose last write time changed, once the changes have settled. A file that is missing (e.g. in the middle of being replaced) is not
+        // considered changed until it exists again.
+        [[nodiscard]] std::vector<std::filesystem::path> poll(const Clock::time_point currentTime);
+
+        size_t getWatchedFileCount() const { return m_watchedFiles.size(); }
+
+        // Number of watched directories that get OS notifications. The files of the other directories are polled.
+        size_t getNativelyWatchedDirectoryCount() const;
+
+      private:
+        // A inotify file descriptor / watch descriptor, or a change notification handle.
+        static constexpr intptr_t INVALID_NATIVE_HANDLE = -1;
+
+        struct WatchedDirectory
+        {
+            std::filesystem::path path{};
+            intptr_t nativeHandle{INVALID_NATIVE_HANDLE};
+            bool hasChanged{};
+        };
+
+        struct WatchedFile
+        {
+            std::filesystem::path path{};
+            uint32_t directoryIndex{};
+            std::filesystem::file_time_type lastWriteTime{};
+            bool isChangePending{};
+        };
+
+        uint32_t watchDirectory(const std::filesystem::path& directoryPath);
+
+        // Sets hasChanged on the directories the OS reported changes in.
+        void collectNativeNotifications();
+
+      private:
+        Clock::duration m_debounceDuration{};
+        Clock::time_point m_lastChangeTime{};
+
+        // The inotify instance on Linux, unused on Windows (every directory has its own handle). Invalid if notifications are disabled.
+        intptr_t m_nativeWatcher{INVALID_NATIVE_HANDLE};
+        bool m_useNativeNotifications{};
+
+        std::vector<WatchedDirectory> m_watchedDirectories{};
+        std::vector<WatchedFile> m_watchedFiles{};
+    };
+}
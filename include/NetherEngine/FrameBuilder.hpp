@@ -0,0 +1,29 @@
+#pragma once
+
+#include "DrawList.hpp"
+#include "FramePacket.hpp"
+#include "FrustumCuller.hpp"
+
+namespace nether
+{
+    // The simulation thread's side of rendering a frame (the render thread's side is FrameRenderer): culls the scene against the camera, merges the visible renderables
+    // into sorted instanced draws, and gathers their per instance data into the frame packet. The scene's transforms must be up to date.
+    // The packet's draws and instances are allocated from its arena, which the caller resets before every frame. The stages are also exposed one by one, so they can be
+    // timed separately (see benchmarks/FrameReplay.hpp).
+    class FrameBuilder
+    {
+      public:
+        void build(const Scene& scene, const math::XMMATRIX& viewProjectionMatrix, FramePacket& framePacket);
+
+        void cull(const Scene& scene, const math::XMMATRIX& viewProjectionMatrix);
+        void buildDraws(const Scene& scene);
+        void gatherInstances(const Scene& scene, FramePacket& framePacket) const;
+
+        std::span<const uint32_t> getVisibleIndices() const { return m_frustumCuller.getVisibleIndices(); }
+        const DrawList& getDrawList() const { return m_drawList; }
+
+      private:
+        FrustumCuller m_frustumCuller{};
+        DrawList m_drawList{};
+    };
+}
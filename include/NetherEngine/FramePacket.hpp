@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DrawList.hpp"
+#include "LinearArena.hpp"
+
+struct ImDrawList;
+
+namespace nether
+{
+    // Everything the render thread needs to record a frame, produced by the simulation thread. Not modified once published, so the simulation of the next frame can run
+    // while this one is recorded.
+    struct FramePacket
+    {
+        SceneData sceneData{};
+
+        // Transient data of the frame, reset by the simulation thread before it writes the packet. The arena settles at the size of the largest frame, so in steady
+        // state filling the packet does not allocate.
+        LinearArena arena{};
+
+        // Visible draws, and the per instance data in draw order (see DrawList::getInstanceIndices). Allocated from the arena.
+        std::span<const InstancedDraw> draws{};
+        std::span<const InstanceData> instances{};
+
+        // ImGui reuses its draw lists every frame, so their buffers are swapped into lists owned by the packet.
+        std::vector<ImDrawList*> uiDrawLists{};
+        uint32_t uiDrawListCount{};
+        math::XMFLOAT2 uiDisplayPosition{};
+        math::XMFLOAT2 uiDisplaySize{};
+        math::XMFLOAT2 uiFramebufferScale{};
+        bool showUI{};
+    };
+
+    // Arena size that fits the draws and instances of a frame with up to maxInstanceCount instances, to reserve it up front (see LinearArena::reserve).
+    inline constexpr size_t getFramePacketArenaSize(const size_t maxInstanceCount)
+    {
+        return maxInstanceCount * (sizeof(InstancedDraw) + sizeof(InstanceData)) + 2u * alignof(std::max_align_t);
+    }
+}
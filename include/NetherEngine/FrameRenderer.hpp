@@ -0,0 +1,29 @@
+#pragma once
+
+#include "FramePacket.hpp"
+#include "GraphicsBackend.hpp"
+#include "ParallelRecorder.hpp"
+
+namespace nether
+{
+    // Records the batches in order into a single command list. The pipeline is only set when it changes.
+    void recordDrawBatches(CommandRecorder& commandRecorder, const std::span<const IndirectDrawBatch> batches);
+
+    // The graphics API independent part of rendering a frame packet: uploads the per frame data, encodes the draws into indirect records, and records the batches in
+    // parallel chunks through the graphics backend.
+    class FrameRenderer
+    {
+      public:
+        // Below this many draw batches per chunk, the cost of a extra command list outweighs recording in parallel.
+        static constexpr uint32_t MIN_BATCHES_PER_RECORDING_CHUNK = 16u;
+
+        void render(GraphicsBackend& graphicsBackend, ParallelRecorder& parallelRecorder, const FramePacket& framePacket);
+
+        std::span<const IndirectDrawBatch> getBatches() const { return m_indirectCommandBuilder.getBatches(); }
+        std::span<const RecordingChunk> getRecordingChunks() const { return m_recordingChunks; }
+
+      private:
+        IndirectCommandBuilder m_indirectCommandBuilder{};
+        std::vector<RecordingChunk> m_recordingChunks{};
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Scene.hpp"
+
+namespace nether
+{
+    // Tests the bounding sphere of every renderable (see Mesh::boundingSphere) against the view frustum. Spheres are moved into world space with the entity's world matrix,
+    // and scaled by its largest axis scale, so the test is conservative for non uniform scales.
+    class FrustumCuller
+    {
+      public:
+        // viewProjectionMatrix is in the engine's convention (row vectors, D3D clip space with z in [0, w]).
+        void cull(const Scene& scene, const math::XMMATRIX& viewProjectionMatrix);
+
+        // Dense indices of the visible renderables, in increasing order. The array is reused across frames, so in steady state no allocations are made.
+        std::span<const uint32_t> getVisibleIndices() const { return m_visibleIndices; }
+
+      private:
+        std::vector<uint32_t> m_visibleIndices{};
+    };
+}
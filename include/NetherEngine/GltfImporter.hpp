@@ -0,0 +1,115 @@
+#pragma once
+
+#include "AssetLoader.hpp"
+#include "MappedFile.hpp"
+
+// Importer of the parts of glTF 2.0 the engine renders (buffers, buffer views, accessors, meshes and nodes), from .gltf and .glb files. Unlike tinygltf (see
+// loadGltfModel), which reads every buffer into a std::vector, buffers are views : of the .glb's binary chunk, of mapped .bin files, or of asset archive entries. So the
+// attributes are decoded straight from the file, and the only copy of the vertex data made while importing is the MeshData.
+// The JSON is streamed through JsonReader straight into flat arrays (only the buffer uris allocate), indices between them are validated once the whole file is read.
+namespace nether
+{
+    class AssetArchive;
+
+    enum class GltfComponentType : uint32_t
+    {
+        Byte = 5120u,
+        UnsignedByte = 5121u,
+        Short = 5122u,
+        UnsignedShort = 5123u,
+        UnsignedInt = 5125u,
+        Float = 5126u,
+    };
+
+    enum class GltfAccessorType : uint32_t
+    {
+        Scalar,
+        Vec2,
+        Vec3,
+        Vec4,
+        Mat2,
+        Mat3,
+        Mat4,
+    };
+
+    struct GltfBuffer
+    {
+        uint64_t byteLength{};
+
+        // Set by the importer once the buffer is resolved, exactly byteLength bytes.
+        std::span<const std::byte> data{};
+    };
+
+    struct GltfBufferView
+    {
+        uint32_t buffer{};
+        uint64_t byteOffset{};
+        uint64_t byteLength{};
+
+        // 0 if the elements are tightly packed.
+        uint32_t byteStride{};
+    };
+
+    struct GltfAccessor
+    {
+        static constexpr uint32_t NO_BUFFER_VIEW = ~0u;
+
+        uint32_t bufferView{NO_BUFFER_VIEW};
+        uint64_t byteOffset{};
+        uint64_t count{};
+
+        GltfComponentType componentType{};
+        GltfAccessorType type{};
+    };
+
+    // Accessor indices of the attributes the engine uses, INVALID_INDEX if the primitive does not have them.
+    struct GltfPrimitive
+    {
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        uint32_t position{INVALID_INDEX};
+        uint32_t normal{INVALID_INDEX};
+        uint32_t textureCoord{INVALID_INDEX};
+        uint32_t indices{INVALID_INDEX};
+    };
+
+    // The primitives of a mesh are contiguous in GltfModel::primitives.
+    struct GltfMesh
+    {
+        uint32_t firstPrimitive{};
+        uint32_t primitiveCount{};
+    };
+
+    struct GltfNode
+    {
+        static constexpr uint32_t NO_MESH = ~0u;
+
+        uint32_t mesh{NO_MESH};
+    };
+
+    struct GltfModel
+    {
+        std::vector<GltfBuffer> buffers{};
+        std::vector<GltfBufferView> bufferViews{};
+        std::vector<GltfAccessor> accessors{};
+        std::vector<GltfMesh> meshes{};
+        std::vector<GltfPrimitive> primitives{};
+        std::vector<GltfNode> nodes{};
+
+        // Storage of buffers that are not views of the imported file : mapped .bin files, and decoded data URIs / decompressed archive entries. decodeMeshData releases
+        // the pages of the mapped files it has read.
+        std::vector<MappedFile> mappedFiles{};
+        std::vector<std::vector<std::byte>> bufferStorage{};
+    };
+
+    // Imports a .gltf or .glb file (told apart by the .glb magic) that is in memory, e.g. mapped. The model's buffers can point into file, which has to outlive the model.
+    // External buffers are loaded relative to baseDirectory, from the asset archive if it is not null and has them. A malformed file is a fatal error.
+    void importGltf(const std::span<const std::byte> file, const std::string_view baseDirectory, GltfModel& model, const AssetArchive* const assetArchive = nullptr);
+
+    // Decodes the accessors of all primitives of the first node's mesh, like decodeMeshData(const tinygltf::Model&). Accessors are bounds checked against their buffers.
+    // Pages of large mapped buffers leave the working set once they are decoded, so the import of a large asset peaks at about the size of its MeshData.
+    [[nodiscard]] MeshData decodeMeshData(const GltfModel& model);
+
+    // Maps the file, imports it and decodes its mesh.
+    [[nodiscard]] MeshData loadMeshData(const std::string_view modelPath);
+}
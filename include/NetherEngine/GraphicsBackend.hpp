@@ -0,0 +1,91 @@
+#pragma once
+
+#include "AssetLoader.hpp"
+#include "IndirectCommands.hpp"
+
+struct ImDrawData;
+
+// The graphics API calls the engine makes, so that everything above them (update, culling, sorting, instancing, recording and asset streaming) can run without a GPU.
+// D3D12GraphicsBackend is the D3D12 implementation, NullGraphicsBackend the headless one.
+namespace nether
+{
+    // Records into the command list of one recording chunk (see ParallelRecorder.hpp). Only used by the thread that records the chunk.
+    class CommandRecorder
+    {
+      public:
+        virtual ~CommandRecorder() = default;
+
+        virtual void setGraphicsPipeline(const GraphicsPipeline& graphicsPipeline) = 0;
+
+        // Draws recordCount records of the frame's indirect command buffer, starting at firstRecord, with the current pipeline. Every record binds its own index buffer.
+        virtual void drawIndirect(const uint32_t firstRecord, const uint32_t recordCount) = 0;
+    };
+
+    // CPU visible buffers of the current frame, valid from beginFrame until submitFrame.
+    struct FrameBuffers
+    {
+        SceneData* sceneData{};
+        uint32_t sceneBufferIndex{};
+
+        std::span<InstanceData> instances{};
+        uint32_t instanceBufferIndex{};
+
+        std::span<IndirectDrawRecord> indirectDrawRecords{};
+    };
+
+    class GraphicsBackend
+    {
+      public:
+        // Frames the CPU can record while the GPU renders the previous ones. Resources a frame uses must stay alive until the GPU is done with it.
+        static constexpr uint32_t FRAME_COUNT = 2u;
+
+        virtual ~GraphicsBackend() = default;
+
+        // If data is nullptr, a buffer with CPU / GPU access will be created. Else, a GPU only buffer will be created.
+        [[nodiscard]] virtual IndexBuffer createIndexBuffer(const std::byte* data, const uint32_t bufferSize, const std::wstring_view indexBufferName) = 0;
+        [[nodiscard]] virtual StructuredBuffer createStructuredBuffer(const std::byte* data, const uint32_t numberOfComponents, const uint32_t stride, const std::wstring_view bufferName) = 0;
+
+        [[nodiscard]] virtual Texture createTexture(const std::string_view texturePath, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName) = 0;
+        [[nodiscard]] virtual Texture createTexture(const ImageData& image, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName) = 0;
+
+        // Compute shader (shaders/GenerateMipMaps.hlsl) that generates the mip chain of textures created with generateMipMaps. Must be set before such a texture is
+        // created, and can be replaced (e.g. when the shader is reloaded) by another thread than the one that uploads. Its root constants are checked against
+        // GenerateMipMapRenderResources.
+        virtual void setMipMapGenerationShader(const Shader& computeShader) = 0;
+
+        // Buffers and textures created between beginUploadBatch and submitUploadBatch are uploaded together, without waiting for the GPU. Otherwise every upload is
+        // waited for. One batch is in flight at a time, so a batch only begins once completeUploadBatch returned true.
+        virtual void beginUploadBatch() = 0;
+        virtual void submitUploadBatch() = 0;
+
+        // Returns true once the resources of the batch in flight (if any) can be used, and the next batch can begin. Textures of the batch get their mips on the GPU
+        // once their upload is done, and can only be used once that is done as well. Returns false if the GPU is not done with the batch yet, unless waitForGPU is set.
+        [[nodiscard]] virtual bool completeUploadBatch(const bool waitForGPU) = 0;
+
+        // The root constants of the shaders are checked against RenderResources, mismatches are fatal.
+        [[nodiscard]] virtual GraphicsPipeline createGraphicsPipeline(const Shader& vertexShader, const Shader& pixelShader, const std::wstring_view pipelineName) = 0;
+
+        // Upper bound for the chunk count passed to beginChunk / submitFrame.
+        virtual uint32_t getMaxChunkCount() const = 0;
+
+        // Called once per frame, before anything else is recorded.
+        virtual FrameBuffers beginFrame() = 0;
+
+        // Safe to call from multiple threads, as long as each uses a different chunk index. The recorder is valid until submitFrame.
+        virtual CommandRecorder& beginChunk(const uint32_t chunkIndex) = 0;
+
+        // UI drawn on top of the next submitted frame, which must stay valid until then. Cleared by submitFrame, so frames without UI skip the call.
+        virtual void setUIDrawData(const ImDrawData* const uiDrawData) = 0;
+
+        // Submits chunks 0 to chunkCount - 1 in order, and presents the frame.
+        virtual void submitFrame(const uint32_t chunkCount) = 0;
+
+        // Waits until the GPU is done with every submitted frame, e.g. before replacing resources that frames in flight might use.
+        virtual void flushGPU() = 0;
+
+        // Return the descriptor of the buffer / texture, which is reused by the next one created. The GPU must be done with it, as it is for assets their registry
+        // destroys (see Engine::ASSET_RETIRE_LATENCY).
+        virtual void destroyStructuredBuffer(StructuredBuffer& structuredBuffer) = 0;
+        virtual void destroyTexture(Texture& texture) = 0;
+    };
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "DrawList.hpp"
+#include "RootConstantLayout.hpp"
+
+// Records for indirect draw submission. Each record holds the root constants of a draw, its index buffer and its draw arguments, so all draws of a pipeline can be submitted
+// with a single ExecuteIndirect call (and later, be generated / compacted on the GPU). Nothing in this file depends on the graphics API, the command signature is built from
+// IndirectDrawLayout by the engine.
+namespace nether
+{
+    // Number of 32 bit root constants in the bindless root signature (see D3D12GraphicsBackend::initRootSignature).
+    inline constexpr uint32_t MAX_ROOT_CONSTANT_COUNT = 64u;
+
+    // Root constants used by the mesh shaders. Must match the RenderResources struct in shaders/PhongShader.hlsl and shaders/LightShader.hlsl, member for member.
+    struct RenderResources
+    {
+        uint32_t positionBufferIndex{};
+        uint32_t textureCoordBufferIndex{};
+        uint32_t normalBufferIndex{};
+
+        uint32_t sceneBufferIndex{};
+        uint32_t instanceBufferIndex{};
+        uint32_t instanceOffset{};
+
+        uint32_t albedoTextureIndex{};
+    };
+
+    // Checked against the reflected RenderResources of the mesh shaders when their pipelines are created.
+    inline constexpr std::array<RootConstantField, 7u> RENDER_RESOURCES_FIELDS = {{
+        {"positionBufferIndex", offsetof(RenderResources, positionBufferIndex), sizeof(uint32_t)},
+        {"textureCoordBufferIndex", offsetof(RenderResources, textureCoordBufferIndex), sizeof(uint32_t)},
+        {"normalBufferIndex", offsetof(RenderResources, normalBufferIndex), sizeof(uint32_t)},
+        {"sceneBufferIndex", offsetof(RenderResources, sceneBufferIndex), sizeof(uint32_t)},
+        {"instanceBufferIndex", offsetof(RenderResources, instanceBufferIndex), sizeof(uint32_t)},
+        {"instanceOffset", offsetof(RenderResources, instanceOffset), sizeof(uint32_t)},
+        {"albedoTextureIndex", offsetof(RenderResources, albedoTextureIndex), sizeof(uint32_t)},
+    }};
+
+    inline constexpr RootConstantLayout RENDER_RESOURCES_LAYOUT = {
+        .name = "RenderResources",
+        .sizeInBytes = sizeof(RenderResources),
+        .fields = RENDER_RESOURCES_FIELDS,
+    };
+
+    // Same layout as D3D12_DRAW_INDEXED_ARGUMENTS.
+    struct DrawIndexedArguments
+    {
+        uint32_t indexCountPerInstance{};
+        uint32_t instanceCount{};
+        uint32_t startIndexLocation{};
+        int32_t baseVertexLocation{};
+        uint32_t startInstanceLocation{};
+    };
+
+    // Same layout as D3D12_INDEX_BUFFER_VIEW. The 64 bit address is split in two, so that the view can follow the 32 bit root constants without padding.
+    struct IndexBufferView
+    {
+        uint32_t bufferLocationLow{};
+        uint32_t bufferLocationHigh{};
+        uint32_t sizeInBytes{};
+        uint32_t format{};
+    };
+
+    struct IndirectDrawRecord
+    {
+        RenderResources renderResources{};
+        IndexBufferView indexBufferView{};
+        DrawIndexedArguments drawArguments{};
+    };
+
+    // Description of a IndirectDrawRecord, in the terms the command signature needs.
+    struct IndirectDrawLayout
+    {
+        uint32_t rootParameterIndex{};
+        uint32_t rootConstantOffset{};
+        uint32_t rootConstantCount{};
+
+        uint32_t indexBufferViewOffsetInBytes{};
+        uint32_t drawArgumentsOffsetInBytes{};
+        uint32_t byteStride{};
+    };
+
+    inline constexpr IndirectDrawLayout INDIRECT_DRAW_LAYOUT = {
+        .rootParameterIndex = 0u,
+        .rootConstantOffset = 0u,
+        .rootConstantCount = static_cast<uint32_t>(sizeof(RenderResources) / sizeof(uint32_t)),
+        .indexBufferViewOffsetInBytes = static_cast<uint32_t>(offsetof(IndirectDrawRecord, indexBufferView)),
+        .drawArgumentsOffsetInBytes = static_cast<uint32_t>(offsetof(IndirectDrawRecord, drawArguments)),
+        .byteStride = static_cast<uint32_t>(sizeof(IndirectDrawRecord)),
+    };
+
+    // The command signature writes the root constants, sets the index buffer and then reads the draw arguments from the same record, with no padding in between.
+    static_assert(sizeof(RenderResources) % sizeof(uint32_t) == 0u, "RenderResources must be made of 32 bit values.");
+    static_assert(INDIRECT_DRAW_LAYOUT.rootConstantOffset + INDIRECT_DRAW_LAYOUT.rootConstantCount <= MAX_ROOT_CONSTANT_COUNT,
+                  "RenderResources does not fit in the root constants of the bindless root signature.");
+    static_assert(INDIRECT_DRAW_LAYOUT.indexBufferViewOffsetInBytes == sizeof(RenderResources), "The index buffer view must directly follow the root constants.");
+    static_assert(INDIRECT_DRAW_LAYOUT.drawArgumentsOffsetInBytes == INDIRECT_DRAW_LAYOUT.indexBufferViewOffsetInBytes + sizeof(IndexBufferView),
+                  "Draw arguments must directly follow the index buffer view.");
+    static_assert(sizeof(IndexBufferView) == 16u, "IndexBufferView must match D3D12_INDEX_BUFFER_VIEW.");
+    static_assert(sizeof(DrawIndexedArguments) == 5u * sizeof(uint32_t), "DrawIndexedArguments must match D3D12_DRAW_INDEXED_ARGUMENTS.");
+    static_assert(INDIRECT_DRAW_LAYOUT.byteStride == sizeof(RenderResources) + sizeof(IndexBufferView) + sizeof(DrawIndexedArguments),
+                  "IndirectDrawRecord must be tightly packed.");
+    static_assert(INDIRECT_DRAW_LAYOUT.byteStride % sizeof(uint32_t) == 0u, "Command signature byte stride must be a multiple of 4.");
+
+    // Consecutive records that share a pipeline, which are submitted with one ExecuteIndirect call (the records bind their own index buffer).
+    struct IndirectDrawBatch
+    {
+        GraphicsPipeline* graphicsPipeline{};
+
+        uint32_t firstRecord{};
+        uint32_t recordCount{};
+    };
+
+    [[nodiscard]] IndirectDrawRecord encodeIndirectDraw(const InstancedDraw& draw, const uint32_t sceneBufferIndex, const uint32_t instanceBufferIndex);
+
+    // Encodes the draws of a DrawList into records, in the same order. The arrays are reused across frames.
+    class IndirectCommandBuilder
+    {
+      public:
+        void build(const std::span<const InstancedDraw> draws, const uint32_t sceneBufferIndex, const uint32_t instanceBufferIndex);
+
+        // Makes room for maxDrawCount draws, so that later builds (up to that many draws) do not allocate.
+        void reserve(const size_t maxDrawCount);
+
+        std::span<const IndirectDrawRecord> getRecords() const { return m_records; }
+        std::span<const IndirectDrawBatch> getBatches() const { return m_batches; }
+
+      private:
+        std::vector<IndirectDrawRecord> m_records{};
+        std::vector<IndirectDrawBatch> m_batches{};
+    };
+}
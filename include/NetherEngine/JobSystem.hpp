@@ -0,0 +1,267 @@
+#pragma once
+
+#include "Task.hpp"
+#include "WorkStealingDeque.hpp"
+
+namespace nether
+{
+    class JobCounter;
+    class JobSystem;
+
+    // A unit of work. The job system does not copy jobs, so a job must stay alive (and unchanged) until it ran. Most code does not deal with jobs directly, and uses
+    // JobSystem::schedule, parallelFor or tasks instead.
+    struct Job
+    {
+        void (*function)(void* data){};
+        void* data{};
+
+        // Incremented when the job is submitted, and decremented once the function returned. Can be null.
+        JobCounter* counter{};
+    };
+
+    // Number of unfinished jobs in a group, used to wait for them (fork / join) or to run other jobs once they are done (see JobSystem::scheduleAfter). The counter must
+    // outlive the jobs it counts. If a job throws, the first exception is kept and rethrown by JobSystem::wait.
+    class JobCounter
+    {
+      public:
+        JobCounter() = default;
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool isDone() const { return m_state.load(std::memory_order_acquire) == 0u; }
+
+      private:
+        friend class JobSystem;
+
+        // The low bits are the number of unfinished jobs. The top bits are a spin lock that protects the members below, and a flag set while there are dependent jobs. The
+        // job that brings the count to zero takes the dependent jobs under the lock, and clears the lock and the flag in the same atomic operation, so the counter is
+        // never touched once a waiter can see it at zero (and destroy it).
+        static constexpr uint32_t LOCKED_BIT = 1u << 31u;
+        static constexpr uint32_t HAS_DEPENDENT_JOBS_BIT = 1u << 30u;
+        static constexpr uint32_t COUNT_MASK = HAS_DEPENDENT_JOBS_BIT - 1u;
+
+        std::atomic<uint32_t> m_state{};
+
+        std::exception_ptr m_exception{};
+        std::vector<Job*> m_dependentJobs{};
+    };
+
+    struct JobSystemDesc
+    {
+        static constexpr uint32_t DEFAULT_WORKER_THREAD_COUNT = ~0u;
+
+        // By default, one worker per hardware thread, minus one for the thread that creates the job system (which runs jobs while it waits). With 0 workers, every job
+        // runs on the thread that waits for it.
+        uint32_t workerThreadCount{DEFAULT_WORKER_THREAD_COUNT};
+
+        // Pins worker i to hardware thread i + 1 (wrapping around), which leaves hardware thread 0 to the thread that creates the job system. Best effort, failures are
+        // ignored.
+        bool pinWorkerThreads{false};
+    };
+
+    // Work stealing job system. Every worker thread has a WorkStealingDeque: jobs submitted from a worker go to its own deque (and run there in LIFO order, which is cache
+    // friendly for fork / join), idle workers steal the oldest jobs from the others. Jobs submitted from other threads go through a shared queue. Workers spin briefly when
+    // they run out of jobs, and then sleep until a job is submitted.
+    // Waiting (wait, runTask) runs jobs on the waiting thread, so waiting from inside a job does not deadlock, and the thread that created the job system is a worker in
+    // all but name while it waits.
+    class JobSystem
+    {
+      public:
+        static constexpr uint32_t MAX_WORKER_THREAD_COUNT = 64u;
+
+        explicit JobSystem(const JobSystemDesc& desc = JobSystemDesc{});
+
+        // Every job must have finished.
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // The function is moved into a job allocated by the job system. If counter is null and the function throws, the program is terminated.
+        void schedule(std::function<void()> function, JobCounter* const counter = nullptr);
+
+        // Like schedule, but the job only runs once the jobs counted by dependency (at the time of the call) have finished.
+        void scheduleAfter(JobCounter& dependency, std::function<void()> function, JobCounter* const counter = nullptr);
+
+        // Without allocations, for jobs the caller keeps alive.
+        void submit(Job& job);
+        void submitAfter(JobCounter& dependency, Job& job);
+
+        // Runs jobs on the calling thread until every job counted by counter has finished. Rethrows the first exception thrown by one of them.
+        void wait(JobCounter& counter);
+
+        // Calls function(begin, end) on sub ranges that together cover [0, count) once, and returns once all of them are done. Threads grab batches of at least
+        // minBatchSize items from a shared index. Batches start large (a fraction of the remaining items per thread) and shrink towards the end, so that there are few
+        // batches when the work is even, and the threads still finish together when it is not. Does not allocate.
+        template <typename Function> void parallelFor(const uint32_t count, const uint32_t minBatchSize, Function&& function);
+
+        // co_await jobSystem.schedule() suspends the coroutine and resumes it on a worker.
+        auto schedule() noexcept;
+
+        // co_await jobSystem.whenAll(tasks) starts every task on a worker and resumes once all are done (on the thread that finished last). The results are then read with
+        // Task::getResult.
+        template <typename T> auto whenAll(const std::span<Task<T>> tasks) noexcept;
+
+        // Starts the task on the calling thread, waits for it (running jobs meanwhile), and returns its result.
+        template <typename T> T runTask(Task<T> task);
+
+        uint32_t getWorkerThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        // Number of threads that run jobs (workers + the thread that waits).
+        uint32_t getThreadCount() const { return getWorkerThreadCount() + 1u; }
+
+        // One worker per hardware thread, excluding the calling thread.
+        static uint32_t getDefaultWorkerThreadCount();
+
+      private:
+        using RangeFunction = void (*)(void* data, const uint32_t begin, const uint32_t end);
+
+        struct Worker
+        {
+            WorkStealingDeque deque{};
+            std::thread thread{};
+        };
+
+        // Coroutine that starts running immediately and destroys itself when done, used to wait for tasks.
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+
+        class ScheduleAwaiter
+        {
+          public:
+            explicit ScheduleAwaiter(JobSystem& jobSystem) : m_jobSystem(jobSystem) {}
+
+            bool await_ready() noexcept { return false; }
+            void await_suspend(const std::coroutine_handle<> coroutine);
+            void await_resume() noexcept {}
+
+          private:
+            JobSystem& m_jobSystem;
+
+            // Lives in the coroutine frame while the coroutine is suspended.
+            Job m_job{};
+        };
+
+        template <typename T> class WhenAllAwaiter
+        {
+          public:
+            WhenAllAwaiter(JobSystem& jobSystem, const std::span<Task<T>> tasks) : m_jobSystem(jobSystem), m_tasks(tasks) {}
+
+            bool await_ready() noexcept { return m_tasks.empty(); }
+            bool await_suspend(const std::coroutine_handle<> coroutine);
+            void await_resume() noexcept {}
+
+          private:
+            JobSystem& m_jobSystem;
+            std::span<Task<T>> m_tasks{};
+
+            // One per task, plus one for await_suspend, so the awaiting coroutine is not resumed before await_suspend is done with the awaiter.
+            std::atomic<uint32_t> m_remainingCount{};
+        };
+
+        void workerLoop(const uint32_t workerIndex);
+
+        // Pushes to the calling worker's deque, or to the shared queue from other threads. Does not touch the job's counter.
+        void pushJob(Job& job);
+
+        // workerIndex is INVALID_WORKER_INDEX for threads that are not workers.
+        Job* findJob(const uint32_t workerIndex);
+        bool hasPendingJobs() const;
+
+        void execute(Job& job);
+        void finishJob(JobCounter& counter);
+        void addDependentJob(JobCounter& dependency, Job& job);
+
+        void parallelFor(const uint32_t count, const uint32_t minBatchSize, const RangeFunction rangeFunction, void* const data);
+
+        template <typename T> static DetachedTask signalWhenDone(Task<T>& task, JobSystem& jobSystem, JobCounter& counter);
+        template <typename T> static DetachedTask runOnWorker(Task<T>& task, JobSystem& jobSystem, std::atomic<uint32_t>& remainingCount, const std::coroutine_handle<> continuation);
+
+      private:
+        static constexpr uint32_t INVALID_WORKER_INDEX = ~0u;
+
+        std::vector<std::unique_ptr<Worker>> m_workers{};
+
+        // Jobs submitted from threads that are not workers.
+        std::mutex m_sharedQueueMutex{};
+        std::deque<Job*> m_sharedQueue{};
+        std::atomic<uint32_t> m_sharedQueueSize{};
+
+        // Sleeping workers wait for the epoch to change, which every submission does while a worker sleeps.
+        std::atomic<uint32_t> m_workEpoch{};
+        std::atomic<uint32_t> m_sleepingWorkerCount{};
+        std::atomic<bool> m_isShuttingDown{false};
+    };
+
+    template <typename Function> inline void JobSystem::parallelFor(const uint32_t count, const uint32_t minBatchSize, Function&& function)
+    {
+        using FunctionType = std::remove_reference_t<Function>;
+
+        const RangeFunction rangeFunction = [](void* const data, const uint32_t begin, const uint32_t end) { (*static_cast<FunctionType*>(data))(begin, end); };
+        parallelFor(count, minBatchSize, rangeFunction, const_cast<void*>(static_cast<const void*>(std::addressof(function))));
+    }
+
+    inline auto JobSystem::schedule() noexcept { return ScheduleAwaiter(*this); }
+
+    template <typename T> inline auto JobSystem::whenAll(const std::span<Task<T>> tasks) noexcept { return WhenAllAwaiter<T>(*this, tasks); }
+
+    template <typename T> inline T JobSystem::runTask(Task<T> task)
+    {
+        JobCounter counter{};
+        counter.m_state.store(1u, std::memory_order_relaxed);
+
+        signalWhenDone(task, *this, counter);
+        wait(counter);
+
+        if constexpr (std::is_void_v<T>)
+        {
+            task.getResult();
+        }
+        else
+        {
+            return std::move(task.getResult());
+        }
+    }
+
+    template <typename T> inline bool JobSystem::WhenAllAwaiter<T>::await_suspend(const std::coroutine_handle<> coroutine)
+    {
+        m_remainingCount.store(static_cast<uint32_t>(m_tasks.size()) + 1u, std::memory_order_relaxed);
+
+        for (Task<T>& task : m_tasks)
+        {
+            runOnWorker(task, m_jobSystem, m_remainingCount, coroutine);
+        }
+
+        // If every task is already done, the coroutine continues right away.
+        return m_remainingCount.fetch_sub(1u, std::memory_order_acq_rel) != 1u;
+    }
+
+    template <typename T> inline JobSystem::DetachedTask JobSystem::signalWhenDone(Task<T>& task, JobSystem& jobSystem, JobCounter& counter)
+    {
+        co_await task.whenDone();
+        jobSystem.finishJob(counter);
+    }
+
+    template <typename T>
+    inline JobSystem::DetachedTask
+    JobSystem::runOnWorker(Task<T>& task, JobSystem& jobSystem, std::atomic<uint32_t>& remainingCount, const std::coroutine_handle<> continuation)
+    {
+        co_await jobSystem.schedule();
+        co_await task.whenDone();
+
+        if (remainingCount.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        {
+            continuation.resume();
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+// JSON parser in two stages, after simdjson (https://arxiv.org/abs/1902.08318). The tokenizer finds the structural characters ({}[]:,), the opening quote of every string
+// and the first character of every number / literal, 64 bytes at a time (with AVX2 on CPUs that have it) and without branching on the characters. The reader walks the
+// tokens, and only looks at the bytes of the values it reads, so skipped values and the insides of strings are never parsed character by character. Tokens are found a
+// window at a time, so the memory the parser uses does not grow with the size of the JSON.
+namespace nether
+{
+    class JsonTokenizer
+    {
+      public:
+        explicit JsonTokenizer(const std::string_view json);
+
+        // Appends the offsets of the tokens of the next WINDOW_SIZE bytes to tokens. Once all of the JSON is tokenized, appends json.size() as the last token and returns
+        // false. Unterminated strings, control characters in strings and invalid escape sequences are fatal errors.
+        bool tokenizeWindow(std::vector<uint64_t>& tokens);
+
+        static constexpr uint64_t WINDOW_SIZE = 64u * 1024u;
+        static constexpr uint64_t BLOCK_SIZE = 64u;
+
+        // Bit i of each mask is set if character i of the block is of that class.
+        struct BlockMasks
+        {
+            uint64_t quote{};
+            uint64_t backslash{};
+            uint64_t structural{};
+            uint64_t whitespace{};
+            uint64_t control{};
+
+            bool operator==(const BlockMasks&) const = default;
+        };
+
+        // Classify the BLOCK_SIZE characters of a block, in two lanes that give the same masks. The AVX2 lane must only be called if CpuFeatures::isAvx2Supported().
+        static BlockMasks classifyBlockScalar(const char* const block);
+        static BlockMasks classifyBlockAvx2(const char* const block);
+
+      private:
+        void tokenizeBlock(const char* const block, const uint64_t blockOffset, std::vector<uint64_t>& tokens);
+        void validateEscape(const char* const block, const uint32_t index, const uint64_t blockOffset) const;
+
+      private:
+        std::string_view m_json{};
+        uint64_t m_position{};
+
+        // Chosen once, rather than for every block.
+        bool m_isAvx2Supported{};
+
+        // State carried from one block to the next : all ones if the block starts in a string, and 1 if its first character is escaped / follows a number or literal.
+        uint64_t m_isInString{};
+        uint64_t m_isEscaped{};
+        uint64_t m_isAfterScalar{};
+    };
+
+    // Reads the values of a JSON document in order. Values that are not read have to be skipped with skipValue. Malformed JSON is a fatal error.
+    class JsonReader
+    {
+      public:
+        explicit JsonReader(const std::string_view json);
+
+        // Calls readMember with the (raw, see readRawString) key of every member of the object. readMember has to read or skip the member's value.
+        template <typename F> void readObject(F&& readMember)
+        {
+            expect('{');
+            if (consume('}'))
+            {
+                return;
+            }
+
+            do
+            {
+                const std::string_view key = readRawString();
+                expect(':');
+                readMember(key);
+            } while (consume(','));
+
+            expect('}');
+        }
+
+        // Calls readElement for every element of the array, which has to read or skip the element.
+        template <typename F> void readArray(F&& readElement)
+        {
+            expect('[');
+            if (consume(']'))
+            {
+                return;
+            }
+
+            do
+            {
+                readElement();
+            } while (consume(','));
+
+            expect(']');
+        }
+
+        uint64_t readUnsigned();
+
+        // Indices into arrays, which are 32 bit.
+        uint32_t readIndex();
+
+        // The characters between the quotes, a view of the JSON. Escape sequences are not decoded, which is what keys and enums (which never have any) are compared with.
+        std::string_view readRawString();
+
+        // With escape sequences decoded.
+        std::string readString();
+
+        void skipValue() { skipValue(0u); }
+
+        // Only whitespace can follow the top level value.
+        void expectEnd();
+
+      private:
+        // Bounds the recursion of skipValue, so deeply nested input can not overflow the stack.
+        static constexpr uint32_t MAX_NESTING_DEPTH = 256u;
+
+        // The functions called for every token are defined here, so the readObject / readArray of callers inline them. Errors are reported out of line.
+        void check(const bool condition, const std::string_view message) const
+        {
+            if (!condition) [[unlikely]]
+            {
+                reportError(message);
+            }
+        }
+
+        void reportError(const std::string_view message) const;
+        void reportExpected(const char character) const;
+
+        // Makes sure the current token and the one after it are tokenized.
+        void fillTokens();
+
+        uint64_t getTokenPosition() const { return m_tokens[m_tokenIndex]; }
+        uint64_t getNextTokenPosition() const { return m_tokenIndex + 1u < m_tokens.size() ? m_tokens[m_tokenIndex + 1u] : m_json.size(); }
+
+        char peek()
+        {
+            if (m_tokenIndex + 1u >= m_tokens.size()) [[unlikely]]
+            {
+                fillTokens();
+            }
+
+            check(getTokenPosition() < m_json.size(), "unexpected end of file");
+            return m_json[getTokenPosition()];
+        }
+
+        bool consume(const char character)
+        {
+            if (peek() != character)
+            {
+                return false;
+            }
+
+            ++m_tokenIndex;
+            return true;
+        }
+
+        void expect(const char character)
+        {
+            if (!consume(character)) [[unlikely]]
+            {
+                reportExpected(character);
+            }
+        }
+
+        // The number or literal of the current token, without the whitespace that follows it.
+        std::string_view readScalar();
+
+        void skipValue(const uint32_t depth);
+
+      private:
+        std::string_view m_json{};
+
+        JsonTokenizer m_tokenizer;
+        bool m_isTokenized{};
+
+        // Tokens of the current window. The ones before m_tokenIndex are dropped when the next window is tokenized.
+        std::vector<uint64_t> m_tokens{};
+        size_t m_tokenIndex{};
+    };
+}
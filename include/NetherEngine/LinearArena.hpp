@@ -0,0 +1,116 @@
+#pragma once
+
+// Bump allocators for transient CPU data (per frame arrays, temporaries of a single function), so the frame loop does not go through the heap. Only depends on the standard
+// library.
+namespace nether
+{
+    // Allocates by bumping an offset into a block, and frees everything at once (reset, or rewind to a marker). When a block is full a larger one is chained, and on the
+    // next full reset the blocks are merged into a single block of the high watermark's size. So after a warm up (in steady state), an arena that is reset every frame
+    // does not allocate. Not thread safe, an arena belongs to a single thread at a time.
+    class LinearArena
+    {
+      public:
+        explicit LinearArena(const size_t initialCapacity = 64u * 1024u);
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        // Position in the arena, to free everything allocated after it with rewind.
+        struct Marker
+        {
+            size_t blockIndex{};
+            size_t offset{};
+        };
+
+        // alignment must be a power of two. Never returns nullptr.
+        [[nodiscard]] void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+
+        // Uninitialized storage for count objects of type T, which must be trivially destructible (destructors are never called).
+        template <typename T> [[nodiscard]] std::span<T> allocateArray(const size_t count);
+
+        Marker getMarker() const { return Marker{m_blockIndex, m_offset}; }
+        void rewind(const Marker marker);
+
+        // Frees everything, and merges the blocks if the arena overflowed since the last reset.
+        void reset();
+
+        // Makes sure capacity bytes fit in a single block (right away if nothing is in use, otherwise from the next reset), e.g. to size an arena for the largest frame up
+        // front.
+        void reserve(const size_t capacity);
+
+        // Bytes in use, and the most that were in use at once since the arena was created.
+        size_t getUsedSize() const;
+        size_t getHighWatermark() const { return m_highWatermark; }
+
+        size_t getCapacity() const;
+
+      private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data{};
+            size_t size{};
+        };
+
+        // Moves to the next block (chaining a new one if needed) that fits size bytes at the given alignment.
+        void* allocateFromNextBlock(const size_t size, const size_t alignment);
+
+      private:
+        std::vector<Block> m_blocks{};
+
+        // Block allocations are made from, and offset of the first free byte in it.
+        size_t m_blockIndex{};
+        size_t m_offset{};
+
+        size_t m_highWatermark{};
+    };
+
+    // STL allocator on top of a LinearArena, e.g. for a std::vector that only lives for a frame. deallocate does nothing, the memory is reclaimed with the arena, so
+    // containers should reserve their final size up front rather than grow.
+    template <typename T> class ArenaAllocator
+    {
+      public:
+        using value_type = T;
+
+        explicit ArenaAllocator(LinearArena& arena) noexcept : m_arena(&arena) {}
+        template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.getArena()) {}
+
+        [[nodiscard]] T* allocate(const size_t count) { return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T))); }
+        void deallocate([[maybe_unused]] T* const pointer, [[maybe_unused]] const size_t count) noexcept {}
+
+        LinearArena* getArena() const noexcept { return m_arena; }
+
+        template <typename U> bool operator==(const ArenaAllocator<U>& other) const noexcept { return m_arena == other.getArena(); }
+
+      private:
+        LinearArena* m_arena{};
+    };
+
+    template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    // Arena of the calling thread, for temporaries that do not outlive the function that allocates them (see ScratchScope). Created on first use.
+    LinearArena& getScratchArena();
+
+    // Frees everything allocated from the calling thread's scratch arena during the scope. Scopes nest.
+    class ScratchScope
+    {
+      public:
+        ScratchScope() : m_arena(getScratchArena()), m_marker(m_arena.getMarker()) {}
+        ~ScratchScope();
+
+        ScratchScope(const ScratchScope&) = delete;
+        ScratchScope& operator=(const ScratchScope&) = delete;
+
+        LinearArena& getArena() const { return m_arena; }
+
+      private:
+        LinearArena& m_arena;
+        LinearArena::Marker m_marker{};
+    };
+
+    template <typename T> inline std::span<T> LinearArena::allocateArray(const size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Destructors of arena allocated objects are never called.");
+
+        return std::span(static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count);
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// LZ4 block format (without the frame format around it), so blocks can be checked against the reference implementation (LZ4_compress_default / LZ4_decompress_safe).
+// The compressor is the simple greedy one, it is only run offline by the asset packer (see AssetArchive.hpp), the decompressor runs at load time.
+namespace nether::Lz4
+{
+    // Returns an empty vector for empty data.
+    [[nodiscard]] std::vector<std::byte> compress(const std::span<const std::byte> data);
+
+    // data must be exactly the size of the uncompressed block. Malformed blocks (including ones that decompress to a different size) are a fatal error, the
+    // decompressor never reads or writes out of bounds.
+    void decompress(const std::span<const std::byte> compressedData, const std::span<std::byte> data);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Read only view of a whole file, mapped into memory (mmap on Linux, a file mapping on Windows). Pages are read from disk on first access, so mapping a file is cheap and
+// prefetch lets the OS read it in the background while the file waits to be used (see AssetPipeline.hpp).
+namespace nether
+{
+    class MappedFile
+    {
+      public:
+        MappedFile() = default;
+
+        // Failing to open or map the file is a fatal error. Empty files are valid, and have no data.
+        explicit MappedFile(const std::string_view filePath);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Asks the OS to start reading the whole file (or a range of getData()) into memory. Returns right away.
+        void prefetch() const { prefetch(getData()); }
+        void prefetch(const std::span<const std::byte> range) const;
+
+        // Tells the OS that a range of getData() that was read is not needed anymore, so its pages leave the working set (the pages stay in the file cache, and are
+        // faulted back in if read again). The page the range ends in is kept, as the rest of it may still be read.
+        void release(const std::span<const std::byte> range) const;
+
+        std::span<const std::byte> getData() const { return std::span(m_data, m_size); }
+        size_t getSize() const { return m_size; }
+
+      private:
+        void unmap();
+
+      private:
+        const std::byte* m_data{};
+        size_t m_size{};
+    };
+}
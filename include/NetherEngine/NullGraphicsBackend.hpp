@@ -0,0 +1,109 @@
+#pragma once
+
+#include "DescriptorAllocator.hpp"
+#include "GraphicsBackend.hpp"
+
+namespace nether
+{
+    // Everything a NullGraphicsBackend was asked to do. Per frame counts are summed over all submitted frames.
+    struct NullGraphicsStatistics
+    {
+        uint64_t bufferCount{};
+        uint64_t textureCount{};
+        uint64_t graphicsPipelineCount{};
+        uint64_t uploadBatchCount{};
+
+        uint64_t frameCount{};
+        uint64_t chunkCount{};
+        uint64_t uiFrameCount{};
+
+        uint64_t pipelineChangeCount{};
+        uint64_t drawIndirectCount{};
+        uint64_t drawRecordCount{};
+        uint64_t instanceCount{};
+        uint64_t indexCount{};
+    };
+
+    class NullCommandRecorder final : public CommandRecorder
+    {
+      public:
+        void setGraphicsPipeline(const GraphicsPipeline& graphicsPipeline) override;
+        void drawIndirect(const uint32_t firstRecord, const uint32_t recordCount) override;
+
+      private:
+        friend class NullGraphicsBackend;
+
+        void reset(const std::span<const IndirectDrawRecord> indirectDrawRecords);
+
+      private:
+        std::span<const IndirectDrawRecord> m_indirectDrawRecords{};
+
+        const GraphicsPipeline* m_graphicsPipeline{};
+
+        bool m_isRecording{};
+        NullGraphicsStatistics m_statistics{};
+    };
+
+    // Runs the frame pipeline without a GPU (and on any platform). Resources are plain CPU memory or just descriptor indices, and commands are validated and counted
+    // instead of executed, so frames run at the speed of the CPU side of the engine. Meant for benchmarks and tests.
+    class NullGraphicsBackend final : public GraphicsBackend
+    {
+      public:
+        // Descriptor indices are allocated like the D3D12 backend does, running out of them is a fatal error.
+        NullGraphicsBackend(const uint32_t maxChunkCount, const uint32_t maxInstanceCount, const uint32_t maxDescriptorCount = DEFAULT_MAX_DESCRIPTOR_COUNT);
+
+        [[nodiscard]] IndexBuffer createIndexBuffer(const std::byte* data, const uint32_t bufferSize, const std::wstring_view indexBufferName) override;
+        [[nodiscard]] StructuredBuffer createStructuredBuffer(const std::byte* data, const uint32_t numberOfComponents, const uint32_t stride, const std::wstring_view bufferName) override;
+
+        // The texture is not loaded, only a descriptor index is assigned.
+        [[nodiscard]] Texture createTexture(const std::string_view texturePath, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName) override;
+        [[nodiscard]] Texture createTexture(const ImageData& image, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName) override;
+
+        // Mips are not generated, so the shader is ignored.
+        void setMipMapGenerationShader([[maybe_unused]] const Shader& computeShader) override {}
+
+        // Uploads complete right away, only the order of the calls is checked.
+        void beginUploadBatch() override;
+        void submitUploadBatch() override;
+        [[nodiscard]] bool completeUploadBatch(const bool waitForGPU) override;
+
+        // Shaders are not compiled headless, so empty shaders are accepted.
+        [[nodiscard]] GraphicsPipeline createGraphicsPipeline(const Shader& vertexShader, const Shader& pixelShader, const std::wstring_view pipelineName) override;
+
+        uint32_t getMaxChunkCount() const override { return static_cast<uint32_t>(m_commandRecorders.size()); }
+
+        FrameBuffers beginFrame() override;
+        CommandRecorder& beginChunk(const uint32_t chunkIndex) override;
+        void setUIDrawData(const ImDrawData* const uiDrawData) override { m_hasUIDrawData = uiDrawData != nullptr; }
+        void submitFrame(const uint32_t chunkCount) override;
+
+        void flushGPU() override {}
+
+        void destroyStructuredBuffer(StructuredBuffer& structuredBuffer) override;
+        void destroyTexture(Texture& texture) override;
+
+        const NullGraphicsStatistics& getStatistics() const { return m_statistics; }
+
+        // Descriptors of the buffers and textures that were created and not destroyed.
+        uint32_t getAllocatedDescriptorCount() const { return m_descriptorAllocator.getAllocatedCount(); }
+
+      public:
+        static constexpr uint32_t DEFAULT_MAX_DESCRIPTOR_COUNT = 65536u;
+
+      private:
+        std::vector<NullCommandRecorder> m_commandRecorders{};
+
+        SceneData m_sceneData{};
+        std::vector<InstanceData> m_instances{};
+        std::vector<IndirectDrawRecord> m_indirectDrawRecords{};
+
+        DescriptorAllocator m_descriptorAllocator{};
+        bool m_isFrameActive{};
+        bool m_hasUIDrawData{};
+
+        bool m_isUploadBatchRecording{};
+        bool m_isUploadBatchInFlight{};
+
+        NullGraphicsStatistics m_statistics{};
+    };
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "JobSystem.hpp"
+
+// Chunking and scheduling for multi threaded command list recording. Does not depend on the graphics API: the caller decides what "recording a chunk" means (in the engine,
+// recording a range of draw batches into the command list owned by that chunk).
+namespace nether
+{
+    // Contiguous range of work items (draw batches) that is recorded into a single command list.
+    struct RecordingChunk
+    {
+        uint32_t firstItem{};
+        uint32_t itemCount{};
+    };
+
+    // Splits itemCount items into at most maxChunkCount contiguous chunks of near equal size, each with at least minItemsPerChunk items (so small frames are not spread
+    // over many command lists). Chunks are in item order, so submitting the command lists in chunk order preserves the draw order. Always produces at least one chunk.
+    void splitIntoChunks(const uint32_t itemCount, const uint32_t maxChunkCount, const uint32_t minItemsPerChunk, std::vector<RecordingChunk>& chunks);
+
+    // Records chunks in parallel on the engine's job system, so recording shares its threads with the rest of the engine instead of keeping a pool of its own.
+    class ParallelRecorder
+    {
+      public:
+        using RecordChunkFunction = std::function<void(const uint32_t chunkIndex, const RecordingChunk& chunk)>;
+
+        explicit ParallelRecorder(JobSystem& jobSystem) : m_jobSystem(jobSystem) {}
+
+        // Calls recordChunk once per chunk, and returns once all chunks are recorded. Chunks are picked up by whichever thread is free, so recordChunk must only write to
+        // state owned by the chunk index. Only as many workers as there are chunks are woken, and the calling thread records chunks as well (and may run other jobs
+        // of the job system while it waits). If recordChunk throws, the first exception is rethrown on the calling thread.
+        void record(const std::span<const RecordingChunk> chunks, const RecordChunkFunction& recordChunk);
+
+        // Number of threads that can record at the same time (workers + the calling thread).
+        uint32_t getThreadCount() const { return m_jobSystem.getThreadCount(); }
+
+      private:
+        JobSystem& m_jobSystem;
+    };
+}
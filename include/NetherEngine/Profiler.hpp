@@ -0,0 +1,113 @@
+#pragma once
+
+// Scoped CPU zones. Each thread records the zones it finishes into its own ring buffer (no locks, a few relaxed stores per zone), and readers collect them from all threads
+// without stopping them, e.g. for the timeline in the UI or a Chrome trace (chrome://tracing, ui.perfetto.dev). Only depends on the standard library (and the compiler's
+// intrinsics for the time stamp counter).
+//
+// The macros compile to nothing unless NETHER_PROFILER is defined (see premake5.lua), so instrumentation can stay in hot code.
+#ifdef NETHER_PROFILER
+static constexpr bool NETHER_PROFILER_MODE = true;
+
+#define NETHER_PROFILE_CONCAT_INNER(a, b) a##b
+#define NETHER_PROFILE_CONCAT(a, b) NETHER_PROFILE_CONCAT_INNER(a, b)
+
+// Name must be a string literal (or otherwise outlive the profiler), only the pointer is stored.
+#define NETHER_PROFILE_SCOPE(name) const ::nether::Profiler::ProfileScope NETHER_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define NETHER_PROFILE_THREAD(name) ::nether::Profiler::setThreadName(name)
+#define NETHER_PROFILE_FRAME() ::nether::Profiler::markFrame()
+#else
+static constexpr bool NETHER_PROFILER_MODE = false;
+
+#define NETHER_PROFILE_SCOPE(name)
+#define NETHER_PROFILE_THREAD(name)
+#define NETHER_PROFILE_FRAME()
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+// Rather than using a static class, a namespace is used here. The corresponding .cpp file will hold the 'member functions' of the namespace.
+namespace nether::Profiler
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Zones a thread can hold before the oldest ones are overwritten. Captures longer than that (in zones) are truncated.
+    inline constexpr uint32_t ZONES_PER_THREAD = 1u << 16u;
+
+    // Frames whose boundaries are remembered, i.e. the longest capture in frames.
+    inline constexpr uint32_t MAX_CAPTURE_FRAME_COUNT = 255u;
+
+    // Times are in nanoseconds, on the Clock (converted from timestamps when the zones are collected).
+    struct ProfileZone
+    {
+        const char* name{};
+
+        uint32_t threadIndex{};
+
+        // Number of zones of the same thread this one is nested in.
+        uint32_t depth{};
+
+        int64_t beginTime{};
+        int64_t endTime{};
+    };
+
+    struct ProfileCapture
+    {
+        // Indexed by ProfileZone::threadIndex.
+        std::vector<std::string> threadNames{};
+
+        // Sorted by thread, then begin time (so parents come before their children).
+        std::vector<ProfileZone> zones{};
+
+        // Begin time of every captured frame, and the end time of the last one.
+        std::vector<int64_t> frameBoundaries{};
+
+        // False if some zones of the range were overwritten before they were collected.
+        bool isComplete{true};
+    };
+
+    inline int64_t getTime() { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(); }
+
+    // Zones and frames are timed with the time stamp counter on x64, which takes a few nanoseconds to read where a Clock read takes 20 ns (and 45 ns in some VMs). Every x64
+    // CPU the engine runs on has an invariant counter, which ticks at a constant rate and is synchronized between cores. Elsewhere, the time on the Clock.
+    inline int64_t getTimestamp()
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        return static_cast<int64_t>(__rdtsc());
+#else
+        return getTime();
+#endif
+    }
+
+    // Shown in the timeline and traces, threads without a name are numbered.
+    void setThreadName(const std::string_view name);
+
+    // Times are timestamps (see getTimestamp).
+    void recordZone(const char* const name, const int64_t beginTimestamp, const int64_t endTimestamp);
+
+    // Called by a single thread (the simulation thread) at the start of every frame.
+    void markFrame();
+
+    // Collects the zones of all threads that overlap the last frameCount complete frames. Returns false (and leaves the capture empty) if fewer frames were marked.
+    bool collectRecentFrames(const uint32_t frameCount, ProfileCapture& capture);
+
+    // Chrome trace_event JSON: a complete event per zone, a metadata event per thread name, and a instant event per frame boundary.
+    void writeChromeTrace(const ProfileCapture& capture, std::ostream& stream);
+
+    class ProfileScope
+    {
+      public:
+        explicit ProfileScope(const char* const name) : m_name(name), m_beginTimestamp(getTimestamp()) {}
+        ~ProfileScope() { recordZone(m_name, m_beginTimestamp, getTimestamp()); }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+      private:
+        const char* m_name{};
+        int64_t m_beginTimestamp{};
+    };
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+// Frame graph. Passes declare which resources they read and write, and compile() works out everything the hand written code used to do: the order passes run in, which
+// passes can be skipped, where transient resources live in memory and which barriers are needed between passes. Nothing in here depends on the graphics API, the engine
+// translates the compiled result into D3D12 calls.
+namespace nether
+{
+    // Resource states known to the render graph. Bit flags, so that read only states can be combined.
+    enum class ResourceState : uint32_t
+    {
+        Common = 0u,
+        RenderTarget = 1u << 0u,
+        DepthWrite = 1u << 1u,
+        DepthRead = 1u << 2u,
+        ShaderResource = 1u << 3u,
+        UnorderedAccess = 1u << 4u,
+        CopySource = 1u << 5u,
+        CopyDest = 1u << 6u,
+        IndirectArgument = 1u << 7u,
+        Present = 1u << 8u,
+    };
+
+    constexpr ResourceState operator|(const ResourceState a, const ResourceState b) { return static_cast<ResourceState>(EnumClassValue(a) | EnumClassValue(b)); }
+    constexpr ResourceState operator&(const ResourceState a, const ResourceState b) { return static_cast<ResourceState>(EnumClassValue(a) & EnumClassValue(b)); }
+
+    // States that a resource can be in while several passes read from it.
+    inline constexpr ResourceState READ_ONLY_RESOURCE_STATES = ResourceState::DepthRead | ResourceState::ShaderResource | ResourceState::CopySource |
+                                                               ResourceState::IndirectArgument | ResourceState::Present;
+
+    // States that only the graphics queue can transition a resource to or from. ShaderResource is one of them, as the engine maps it to pixel and non pixel shader access.
+    inline constexpr ResourceState GRAPHICS_QUEUE_RESOURCE_STATES = ResourceState::RenderTarget | ResourceState::DepthWrite | ResourceState::DepthRead |
+                                                                    ResourceState::ShaderResource | ResourceState::Present;
+
+    enum class QueueType : uint8_t
+    {
+        Graphics,
+        Compute,
+    };
+
+    struct RenderGraphResource
+    {
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        uint32_t index{INVALID_INDEX};
+
+        bool isValid() const { return index != INVALID_INDEX; }
+
+        auto operator<=>(const RenderGraphResource& other) const = default;
+    };
+
+    struct RenderGraphPass
+    {
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        uint32_t index{INVALID_INDEX};
+
+        bool isValid() const { return index != INVALID_INDEX; }
+
+        auto operator<=>(const RenderGraphPass& other) const = default;
+    };
+
+    enum class BarrierType : uint8_t
+    {
+        Transition,
+        // The memory of resource is about to be used, and was last used by aliasedResource (invalid if any resource could have used it).
+        Aliasing,
+        UnorderedAccess,
+    };
+
+    // A split transition begins right after the last pass that used the resource and ends right before the next pass that uses it, so the GPU can overlap the
+    // transition with the passes in between.
+    enum class BarrierSplit : uint8_t
+    {
+        None,
+        Begin,
+        End,
+    };
+
+    struct RenderGraphBarrier
+    {
+        BarrierType type{};
+        BarrierSplit split{};
+
+        RenderGraphResource resource{};
+        RenderGraphResource aliasedResource{};
+
+        ResourceState stateBefore{};
+        ResourceState stateAfter{};
+    };
+
+    // Cross queue dependency. The queue of signalPass must signal a fence after it (and after its barriers), and the queue of waitPass must wait for that fence before it
+    // (and before its barriers). Compiled pass indices.
+    struct QueueSync
+    {
+        uint32_t signalPass{};
+        uint32_t waitPass{};
+    };
+
+    // A pass that survived culling, in execution order. The barriers are ranges in RenderGraph::getBarriers, and must be submitted as one batch each.
+    struct CompiledPass
+    {
+        RenderGraphPass pass{};
+        QueueType queue{};
+
+        uint32_t firstBarrierBefore{};
+        uint32_t barrierBeforeCount{};
+
+        uint32_t firstBarrierAfter{};
+        uint32_t barrierAfterCount{};
+    };
+
+    class RenderGraph
+    {
+      public:
+        // Imported resources live outside the graph (e.g. the swapchain back buffers). They are expected in initialState when the graph starts, and are left in finalState.
+        // Passes that write to a imported resource are never culled.
+        RenderGraphResource importResource(const std::string_view name, const ResourceState initialState, const ResourceState finalState);
+
+        // Transient resources only live for the duration of the graph, and can share memory with other transient resources whose lifetime does not overlap. The size and
+        // alignment are the ones the graphics API reports for the resource. The content of a transient resource is undefined at its first use. The graph leaves transient
+        // resources in the state of their first use, so a graph that is compiled once and executed every frame finds them in the state they were created in.
+        RenderGraphResource createTransientResource(const std::string_view name, const uint64_t sizeInBytes, const uint64_t alignment);
+
+        // Passes with side effects (e.g. readbacks) are never culled. Passes must be added in submission order.
+        RenderGraphPass addPass(const std::string_view name, const QueueType queue = QueueType::Graphics, const bool hasSideEffects = false);
+
+        // A write does not keep earlier writers of the resource alive. Passes that depend on the previous content (e.g. depth testing against a depth prepass) must also
+        // declare a read.
+        void read(const RenderGraphPass pass, const RenderGraphResource resource, const ResourceState state);
+        void write(const RenderGraphPass pass, const RenderGraphResource resource, const ResourceState state);
+
+        // Topologically sorts and culls the passes, computes the transient resource lifetimes and memory offsets, and generates the barriers and queue syncs.
+        void compile();
+
+        // Remove all passes and resources, while keeping the allocated memory around so the graph can be rebuilt every frame.
+        void clear();
+
+        std::span<const CompiledPass> getCompiledPasses() const { return m_compiledPasses; }
+        std::span<const RenderGraphBarrier> getBarriers() const { return m_barriers; }
+        std::span<const QueueSync> getQueueSyncs() const { return m_queueSyncs; }
+
+        std::span<const RenderGraphBarrier> getBarriersBefore(const CompiledPass& compiledPass) const;
+        std::span<const RenderGraphBarrier> getBarriersAfter(const CompiledPass& compiledPass) const;
+
+        // Index into getCompiledPasses, or RenderGraphPass::INVALID_INDEX if the pass was culled.
+        uint32_t getCompiledPassIndex(const RenderGraphPass pass) const { return m_passes[pass.index].compiledIndex; }
+        bool isCulled(const RenderGraphPass pass) const { return getCompiledPassIndex(pass) == RenderGraphPass::INVALID_INDEX; }
+
+        // Size of the memory that all transient resources are placed in.
+        uint64_t getTransientHeapSize() const { return m_transientHeapSize; }
+
+        // Offset of a transient resource in the transient heap, and the state it must be created in (the state of its first use).
+        uint64_t getTransientOffset(const RenderGraphResource resource) const { return m_resources[resource.index].heapOffset; }
+        ResourceState getTransientInitialState(const RenderGraphResource resource) const { return m_resources[resource.index].firstUseState; }
+
+        // Transient resources that no surviving pass uses get no memory.
+        bool isAllocated(const RenderGraphResource resource) const { return m_resources[resource.index].firstUse != RenderGraphPass::INVALID_INDEX; }
+
+        std::string_view getName(const RenderGraphPass pass) const { return m_passes[pass.index].name; }
+        std::string_view getName(const RenderGraphResource resource) const { return m_resources[resource.index].name; }
+
+      private:
+        struct ResourceNode
+        {
+            std::string name{};
+            bool isImported{};
+
+            ResourceState initialState{};
+            ResourceState finalState{};
+
+            uint64_t sizeInBytes{};
+            uint64_t alignment{};
+
+            // Filled in by compile. The lifetime is in compiled pass indices.
+            uint32_t firstUse{RenderGraphPass::INVALID_INDEX};
+            uint32_t lastUse{RenderGraphPass::INVALID_INDEX};
+            ResourceState firstUseState{};
+            bool isUsedByAsyncQueue{};
+            uint64_t heapOffset{};
+        };
+
+        struct Access
+        {
+            RenderGraphResource resource{};
+            ResourceState state{};
+            bool isWrite{};
+        };
+
+        struct PassNode
+        {
+            std::string name{};
+            QueueType queue{};
+            bool hasSideEffects{};
+
+            std::vector<Access> accesses{};
+
+            // Filled in by compile.
+            std::vector<uint32_t> successors{};
+            std::vector<uint32_t> readPredecessors{};
+            uint32_t predecessorCount{};
+            bool isAlive{};
+            uint32_t compiledIndex{RenderGraphPass::INVALID_INDEX};
+        };
+
+        enum class BarrierTiming : uint8_t
+        {
+            BeforePass,
+            AfterPass,
+        };
+
+        // State of a resource while walking the compiled passes in generateBarriers.
+        struct ResourceTracking
+        {
+            ResourceState state{};
+            uint32_t lastUse{RenderGraphPass::INVALID_INDEX};
+            bool wasLastUseWrite{};
+        };
+
+        struct PendingBarrier
+        {
+            uint32_t compiledPass{};
+            BarrierTiming timing{};
+            RenderGraphBarrier barrier{};
+        };
+
+        void buildDependencies();
+        void cullPasses();
+        void sortPasses();
+        void computeLifetimes();
+        void placeTransientResources();
+        void generateBarriers();
+        void generateQueueSyncs();
+
+        void addDependency(const uint32_t from, const uint32_t to, const bool isReadDependency);
+
+      private:
+        std::vector<ResourceNode> m_resources{};
+        std::vector<PassNode> m_passes{};
+
+        std::vector<CompiledPass> m_compiledPasses{};
+        std::vector<RenderGraphBarrier> m_barriers{};
+        std::vector<QueueSync> m_queueSyncs{};
+
+        uint64_t m_transientHeapSize{};
+
+        // Scratch memory for compile.
+        std::vector<PendingBarrier> m_pendingBarriers{};
+        std::vector<ResourceTracking> m_resourceTracking{};
+        std::vector<std::vector<uint32_t>> m_resourceReaders{};
+        std::vector<uint32_t> m_placedResources{};
+        std::vector<uint32_t> m_scratchIndices{};
+    };
+}
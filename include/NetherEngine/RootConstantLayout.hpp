@@ -0,0 +1,36 @@
+#pragma once
+
+// Root constant structs are declared twice, once in C++ and once in HLSL. The C++ side describes its struct with a RootConstantLayout, and the layout the shaders were
+// compiled with (found through reflection) is checked against it when a pipeline is created, so the two can not silently drift apart. Only depends on the standard
+// library.
+namespace nether
+{
+    struct RootConstantField
+    {
+        std::string_view name{};
+        uint32_t offsetInBytes{};
+        uint32_t sizeInBytes{};
+    };
+
+    struct RootConstantLayout
+    {
+        std::string_view name{};
+        uint32_t sizeInBytes{};
+        std::span<const RootConstantField> fields{};
+    };
+
+    // A member of the root constant buffer (register b0, space0) of a compiled shader.
+    struct ReflectedRootConstant
+    {
+        std::string name{};
+        uint32_t offsetInBytes{};
+        uint32_t sizeInBytes{};
+    };
+
+    // Returns a empty string if every reflected member has a field with the same name, offset and size. A shader may declare fewer members than the C++ struct has (e.g. a
+    // prefix of it), as long as the ones it declares line up.
+    [[nodiscard]] std::string validateRootConstants(const RootConstantLayout& layout, const std::span<const ReflectedRootConstant> reflectedRootConstants);
+
+    // Number of 32 bit values needed to cover every reflected member, i.e. how many values have to be set for the shader to see all the data it reads.
+    [[nodiscard]] uint32_t getRootConstantCount(const std::span<const ReflectedRootConstant> reflectedRootConstants);
+}
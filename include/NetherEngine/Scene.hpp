@@ -0,0 +1,187 @@
+#pragma once
+
+#include "TransformKernel.hpp"
+
+namespace nether
+{
+    // Stable handle to a entity in the scene. The index refers to a slot in the sparse array, and the generation is bumped every time that slot is freed so that stale handles
+    // can be detected.
+    struct EntityHandle
+    {
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        uint32_t index{INVALID_INDEX};
+        uint32_t generation{};
+
+        bool isValid() const { return index != INVALID_INDEX; }
+
+        auto operator<=>(const EntityHandle& other) const = default;
+    };
+
+    // Local transform of a entity (relative to its parent). Only used to get / set the transform of a single entity, the scene stores them as a structure of arrays.
+    struct Transform
+    {
+        math::XMFLOAT3 rotate{0.0f, 0.0f, 0.0f};
+        math::XMFLOAT3 scale{1.0f, 1.0f, 1.0f};
+        math::XMFLOAT3 translate{0.0f, 0.0f, 0.0f};
+    };
+
+    struct Renderable
+    {
+        Mesh* mesh{};
+        GraphicsPipeline* graphicsPipeline{};
+
+        uint32_t albedoTextureIndex{};
+    };
+
+    // Stores all entities and their components in dense, tightly packed arrays (i.e the component at index i of each array belongs to the same entity).
+    // Entities are referred to by generational handles, which map to the dense index through the sparse array in O(1).
+    // Entities form a transform hierarchy. The dense arrays are kept in breadth first order (sorted by depth, so parents always come before their children), which lets
+    // updateTransforms propagate world matrices in a single linear pass. Structural changes (create / destroy / setParent) only mark the order as dirty, and the arrays are
+    // re-sorted once at the next updateTransforms.
+    class Scene
+    {
+      public:
+        [[nodiscard]] EntityHandle createEntity(const std::string_view name, const EntityHandle parent = EntityHandle{});
+        void destroyEntity(const EntityHandle entity);
+
+        [[nodiscard]] bool isAlive(const EntityHandle entity) const;
+
+        // Pass a invalid handle to make the entity a root. Children of a destroyed entity become roots.
+        void setParent(const EntityHandle entity, const EntityHandle parent);
+        EntityHandle getParent(const EntityHandle entity) const;
+
+        void reserve(const size_t entityCount);
+        void clear();
+
+        size_t size() const { return m_denseToEntityIndex.size(); }
+
+        // Recompute the world matrices of entities whose local transform changed, and of everything below them in the hierarchy. If nothing changed this is close to free.
+        // The dense indices of all entities whose world matrix changed are returned by getChangedTransformIndices (valid until the next call or structural change).
+        void updateTransforms();
+        std::span<const uint32_t> getChangedTransformIndices() const { return m_changedTransformIndices; }
+
+        // Accessors for the dense component arrays. Note that the dense index of a entity can change after any structural change followed by updateTransforms.
+        std::span<const math::XMFLOAT4X4> getWorldMatrices() const { return m_worldMatrices; }
+        std::span<const math::XMFLOAT4X4> getNormalMatrices() const { return m_normalMatrices; }
+        std::span<Renderable> getRenderables() { return m_renderables; }
+        std::span<const Renderable> getRenderables() const { return m_renderables; }
+
+        // Transforms are split across multiple arrays, so they are accessed by value. Setting a transform marks it as dirty.
+        Transform getTransformAtIndex(const size_t denseIndex) const;
+        void setTransformAtIndex(const size_t denseIndex, const Transform& transform);
+
+        // Handle based accessors. The handle must be alive.
+        Transform getTransform(const EntityHandle entity) const { return getTransformAtIndex(getDenseIndex(entity)); }
+        void setTransform(const EntityHandle entity, const Transform& transform) { setTransformAtIndex(getDenseIndex(entity), transform); }
+        const math::XMFLOAT4X4& getWorldMatrix(const EntityHandle entity) const { return m_worldMatrices[getDenseIndex(entity)]; }
+        Renderable& getRenderable(const EntityHandle entity) { return m_renderables[getDenseIndex(entity)]; }
+
+        EntityHandle getEntity(const size_t denseIndex) const;
+
+        // Names are only kept as a side table for tooling (ImGui, debug names), and are never used in the frame loop.
+        std::string_view getName(const size_t denseIndex) const { return m_names[denseIndex]; }
+
+      private:
+        uint32_t getDenseIndex(const EntityHandle entity) const;
+
+        TransformKernel::LocalTransforms getLocalTransforms(const size_t firstDenseIndex) const;
+
+        void markDirty(const size_t denseIndex);
+
+        // Re-sort all dense arrays into breadth first order, and resolve the parent handles into dense indices.
+        void sortHierarchy();
+
+        // Call function on every dense array, used to keep all of them in sync when entities are added / removed / reordered.
+        template <typename Function> void forEachDenseArray(Function&& function);
+
+      private:
+        static constexpr uint32_t INVALID_DENSE_INDEX = ~0u;
+
+        // Sparse arrays, indexed by EntityHandle::index.
+        std::vector<uint32_t> m_sparseToDenseIndex{};
+        std::vector<uint32_t> m_generations{};
+        std::vector<uint32_t> m_freeEntityIndices{};
+
+        // Dense arrays, indexed by dense index.
+        std::vector<uint32_t> m_denseToEntityIndex{};
+
+        // Hierarchy. The parent is stored as a handle (so it stays valid when the dense arrays are reordered), and is resolved to a dense index by sortHierarchy.
+        std::vector<EntityHandle> m_parents{};
+        std::vector<uint32_t> m_parentDenseIndices{};
+
+        // Local transform components, in structure of arrays form so they can be fed directly into the transform kernel.
+        std::vector<float> m_translateX{};
+        std::vector<float> m_translateY{};
+        std::vector<float> m_translateZ{};
+
+        std::vector<float> m_rotateX{};
+        std::vector<float> m_rotateY{};
+        std::vector<float> m_rotateZ{};
+
+        std::vector<float> m_scaleX{};
+        std::vector<float> m_scaleY{};
+        std::vector<float> m_scaleZ{};
+
+        // Set when the local transform changes, cleared by updateTransforms.
+        std::vector<uint8_t> m_localDirtyFlags{};
+
+        // Set by updateTransforms for entities whose world matrix changed, cleared at the start of the next updateTransforms.
+        std::vector<uint8_t> m_worldChangedFlags{};
+
+        // Output of the transform kernel, and the final world space matrices.
+        std::vector<math::XMFLOAT4X4> m_localMatrices{};
+        std::vector<math::XMFLOAT4X4> m_localNormalMatrices{};
+        std::vector<math::XMFLOAT4X4> m_worldMatrices{};
+        std::vector<math::XMFLOAT4X4> m_normalMatrices{};
+
+        std::vector<Renderable> m_renderables{};
+
+        std::vector<std::string> m_names{};
+
+        // Smallest dense index with a dirty local transform, so updateTransforms can skip the clean prefix of the hierarchy.
+        size_t m_firstDirtyDenseIndex{SIZE_MAX};
+        bool m_isHierarchyOrderDirty{false};
+
+        std::vector<uint32_t> m_changedTransformIndices{};
+
+        // Scratch buffers of sortHierarchy, kept so that re-sorting only allocates when the scene grows.
+        std::vector<uint32_t> m_sortDepths{};
+        std::vector<uint32_t> m_sortDepthOffsets{};
+        std::vector<uint32_t> m_sortAncestors{};
+        std::vector<uint32_t> m_sortOrder{};
+        std::vector<uint8_t> m_sortVisitedFlags{};
+    };
+
+    template <typename Function> inline void Scene::forEachDenseArray(Function&& function)
+    {
+        function(m_denseToEntityIndex);
+
+        function(m_parents);
+        function(m_parentDenseIndices);
+
+        function(m_translateX);
+        function(m_translateY);
+        function(m_translateZ);
+
+        function(m_rotateX);
+        function(m_rotateY);
+        function(m_rotateZ);
+
+        function(m_scaleX);
+        function(m_scaleY);
+        function(m_scaleZ);
+
+        function(m_localDirtyFlags);
+        function(m_worldChangedFlags);
+
+        function(m_localMatrices);
+        function(m_localNormalMatrices);
+        function(m_worldMatrices);
+        function(m_normalMatrices);
+
+        function(m_renderables);
+
+        function(m_names);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// Persistent on disk cache of compiled shader bytecode. Entries are keyed by a hash of everything that affects the output of the compiler: the shader source, the
+// contents of all (transitively) included files, the compiler arguments (entry point, target profile, debug / optimization flags, ...) and the compiler version.
+// Only depends on the standard library, the compiler is driven by ShaderCompiler.
+namespace nether::ShaderCache
+{
+    // The cache is disabled until a directory is set (and again if it is set to a empty path). Once the total size of the entries goes above maxSizeInBytes, the least
+    // recently used entries are evicted.
+    void setCacheDirectory(const std::filesystem::path& cacheDirectory, const uint64_t maxSizeInBytes);
+
+    // includeDirectories are searched (in order) for includes that are not found relative to the including file. If dependencies is not null, the canonical paths of the
+    // shader and all the files it (transitively) includes are written to it.
+    [[nodiscard]] uint64_t computeKey(const std::filesystem::path& shaderPath,
+                                      const std::span<const std::filesystem::path> includeDirectories,
+                                      const std::span<const wchar_t* const> compilationArguments,
+                                      const uint64_t compilerVersion,
+                                      std::vector<std::filesystem::path>* const dependencies = nullptr);
+
+    // Returns std::nullopt on a miss. A hit marks the entry as recently used.
+    [[nodiscard]] std::optional<std::vector<std::byte>> load(const uint64_t key);
+
+    // Safe to call from multiple threads / processes: entries are written to a temporary file and then renamed into place.
+    void store(const uint64_t key, const std::span<const std::byte> bytecode);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "JobSystem.hpp"
 #include "Types.hpp"
 
 namespace nether
@@ -10,10 +11,91 @@ namespace nether
         Pixel,
         Compute,
     };
+
+    // Passed to the compiler as -D name=value (or just -D name if value is empty).
+    struct ShaderDefine
+    {
+        std::wstring name{};
+        std::wstring value{};
+    };
+
+    struct ShaderCompileJob
+    {
+        ShaderTypes shaderType{};
+        std::wstring shaderPath{};
+        std::vector<ShaderDefine> defines{};
+    };
+
+    // The error message is empty if the compilation succeeded.
+    struct ShaderCompileResult
+    {
+        Shader shader{};
+        std::string errorMessage{};
+    };
+
+    // Bit i of a variant key enables feature i of a ShaderPermutationDesc.
+    using ShaderVariantKey = uint32_t;
+
+    // Variants are looked up in a dense array indexed by the key, so the feature count is kept small.
+    inline constexpr uint32_t MAX_SHADER_FEATURE_COUNT = 8u;
+
+    // A shader with optional features. Each feature is a define, that is set to 1 in the variants that enable the feature and to 0 in the others, so shaders test for
+    // features with #if (not #ifdef).
+    struct ShaderPermutationDesc
+    {
+        ShaderTypes shaderType{};
+        std::wstring shaderPath{};
+        std::vector<std::wstring> features{};
+
+        // Passed to every variant.
+        std::vector<ShaderDefine> defines{};
+    };
+
+    struct ShaderPermutationSet
+    {
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        // Variants whose preprocessed source is identical (e.g. a pixel shader only feature in the vertex shader) share a single shader.
+        std::vector<Shader> shaders{};
+
+        // Indexed by variant key, INVALID_INDEX for the variants that were not compiled.
+        std::vector<uint32_t> shaderIndices{};
+
+        const Shader& getShader(const ShaderVariantKey variantKey) const
+        {
+            if (variantKey >= shaderIndices.size() || shaderIndices[variantKey] == INVALID_INDEX)
+            {
+                fatalError(std::format("Shader variant {} was not compiled.", variantKey));
+            }
+
+            return shaders[shaderIndices[variantKey]];
+        }
+    };
 }
 
 // Rather than using a static class, a namespace is used here. The corresponding .cpp file will hold the 'member functions' of the namespace.
 namespace nether::ShaderCompiler
 {
-    Shader compile(const ShaderTypes& shaderType, const std::wstring_view shaderPath);
+    // Safe to call from multiple threads, each thread lazily creates its own DXC compiler instances. In Shipping builds, the shader is looked up in the embedded shaders
+    // instead, and it is a error if it was not baked.
+    Shader compile(const ShaderTypes& shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines = {});
+
+    // Compiles all jobs concurrently on the job system, with the calling thread helping while it waits. The returned shaders are in the same order as the jobs. If any
+    // job fails, a single fatal error listing the errors of all the failed jobs is raised.
+    std::vector<Shader> compileBatch(JobSystem& jobSystem, const std::span<const ShaderCompileJob> jobs);
+
+    // Same as compileBatch, but failures are returned to the caller instead of being fatal (e.g. when reloading shaders that are being edited).
+    std::vector<ShaderCompileResult> tryCompileBatch(JobSystem& jobSystem, const std::span<const ShaderCompileJob> jobs);
+
+    // Key of the shader in the list of embedded shaders (see EmbeddedShaders.hpp). Must match the keys written by "premake5 bake-shaders".
+    std::string getEmbeddedShaderKey(const ShaderTypes shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines);
+
+    // Every combination of featureCount features, i.e. the keys 0 to 2^featureCount - 1.
+    std::vector<ShaderVariantKey> getAllVariantKeys(const uint32_t featureCount);
+
+    // The job that compiles a single variant.
+    ShaderCompileJob getVariantJob(const ShaderPermutationDesc& permutationDesc, const ShaderVariantKey variantKey);
+
+    // Preprocesses the requested variants, and compiles each distinct preprocessed source once (concurrently, see compileBatch). Errors are fatal.
+    ShaderPermutationSet compilePermutations(JobSystem& jobSystem, const ShaderPermutationDesc& permutationDesc, const std::span<const ShaderVariantKey> variantKeys);
 }
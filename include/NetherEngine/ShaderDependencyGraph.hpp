@@ -0,0 +1,20 @@
+#pragma once
+
+// Only depends on the standard library, so unlike the shader reloader (see ShaderReloader.hpp) it is part of the core, and builds on every platform.
+namespace nether
+{
+    // Maps files to the shader programs that (transitively) include them. A program is the set of shaders a pipeline is built from.
+    class ShaderDependencyGraph
+    {
+      public:
+        // Replaces the dependencies of the program.
+        void setDependencies(const uint32_t programIndex, const std::span<const std::filesystem::path> dependencies);
+
+        // Sorted and without duplicates.
+        [[nodiscard]] std::vector<uint32_t> getAffectedPrograms(const std::span<const std::filesystem::path> changedFiles) const;
+
+      private:
+        std::unordered_map<std::filesystem::path::string_type, std::vector<uint32_t>> m_dependentPrograms{};
+        std::vector<std::vector<std::filesystem::path>> m_programDependencies{};
+    };
+}
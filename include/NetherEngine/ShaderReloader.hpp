@@ -0,0 +1,53 @@
+#pragma once
+
+#include "FileWatcher.hpp"
+#include "ShaderCompiler.hpp"
+#include "ShaderDependencyGraph.hpp"
+
+namespace nether
+{
+    struct ReloadedProgram
+    {
+        uint32_t programIndex{};
+
+        // In the same order as the jobs the program was added with.
+        std::vector<Shader> shaders{};
+    };
+
+    // Watches the dependencies of all added programs on a background thread. When a file changes, only the programs that depend on it are recompiled (on the job system,
+    // with the background thread helping). Programs that compiled without errors are handed to the engine through takeReloadedPrograms, which is meant to be called at a frame
+    // boundary, so pipelines are never swapped while a frame is being recorded. Programs that fail to compile keep their current shaders, and the errors are logged.
+    class ShaderReloader
+    {
+      public:
+        explicit ShaderReloader(JobSystem& jobSystem,
+                                const FileWatcher::Clock::duration pollInterval = std::chrono::milliseconds(100),
+                                const FileWatcher::Clock::duration debounceDuration = std::chrono::milliseconds(200));
+
+        // The shaders must have been compiled from the jobs (in the same order). Returns the index of the program, used by ReloadedProgram.
+        uint32_t addProgram(const std::span<const ShaderCompileJob> jobs, const std::span<const Shader> shaders);
+
+        [[nodiscard]] std::vector<ReloadedProgram> takeReloadedPrograms();
+
+      private:
+        void watchLoop(const std::stop_token stopToken);
+        void reloadPrograms(const std::span<const uint32_t> programIndices);
+
+      private:
+        JobSystem& m_jobSystem;
+        FileWatcher::Clock::duration m_pollInterval{};
+
+        // Guards all members below.
+        std::mutex m_mutex{};
+        std::condition_variable_any m_stopRequested{};
+
+        std::vector<std::vector<ShaderCompileJob>> m_programJobs{};
+        ShaderDependencyGraph m_dependencyGraph{};
+        FileWatcher m_fileWatcher;
+
+        std::vector<ReloadedProgram> m_reloadedPrograms{};
+
+        // Declared last, so the thread is stopped and joined before the members it uses are destroyed.
+        std::jthread m_watchThread{};
+    };
+}
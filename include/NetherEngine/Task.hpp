@@ -0,0 +1,163 @@
+#pragma once
+
+// C++20 coroutine task. Tasks are lazy: the body starts running when the task is awaited (or run with JobSystem::runTask), on the thread that awaits it. To continue on a
+// job system worker, the body awaits JobSystem::schedule, and to run several tasks in parallel it awaits JobSystem::whenAll (see JobSystem.hpp).
+namespace nether
+{
+    template <typename T = void> class Task;
+
+    // Parts of the promise that do not depend on the result type.
+    class TaskPromiseBase
+    {
+      public:
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Resumes whoever awaited the task (by symmetric transfer, so long chains of tasks do not grow the stack).
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(const std::coroutine_handle<>) noexcept { return continuation ? continuation : std::noop_coroutine(); }
+                void await_resume() noexcept {}
+
+                std::coroutine_handle<> continuation{};
+            };
+
+            return FinalAwaiter{m_continuation};
+        }
+
+        void unhandled_exception() { m_exception = std::current_exception(); }
+
+        void setContinuation(const std::coroutine_handle<> continuation) { m_continuation = continuation; }
+
+        void rethrowIfFailed() const
+        {
+            if (m_exception)
+            {
+                std::rethrow_exception(m_exception);
+            }
+        }
+
+      private:
+        std::coroutine_handle<> m_continuation{};
+        std::exception_ptr m_exception{};
+    };
+
+    template <typename T> class TaskPromise : public TaskPromiseBase
+    {
+      public:
+        Task<T> get_return_object() noexcept;
+
+        template <typename Value> void return_value(Value&& value) { m_value.emplace(std::forward<Value>(value)); }
+
+        T& getResult()
+        {
+            rethrowIfFailed();
+            return *m_value;
+        }
+
+      private:
+        std::optional<T> m_value{};
+    };
+
+    template <> class TaskPromise<void> : public TaskPromiseBase
+    {
+      public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() noexcept {}
+
+        void getResult() { rethrowIfFailed(); }
+    };
+
+    // Owns the coroutine, which is destroyed with the task. A task can be awaited once. Awaiting it returns the result, or rethrows the exception the body threw.
+    template <typename T> class Task
+    {
+      public:
+        using promise_type = TaskPromise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(const Handle coroutine) : m_coroutine(coroutine) {}
+
+        Task(Task&& other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {}
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy();
+                m_coroutine = std::exchange(other.m_coroutine, nullptr);
+            }
+
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() { destroy(); }
+
+        bool isValid() const { return static_cast<bool>(m_coroutine); }
+        bool isDone() const { return m_coroutine && m_coroutine.done(); }
+
+        // The task must be done.
+        decltype(auto) getResult() { return m_coroutine.promise().getResult(); }
+
+        auto operator co_await() & noexcept { return Awaiter{m_coroutine}; }
+        auto operator co_await() && noexcept { return Awaiter{m_coroutine}; }
+
+        // Like co_await, but only waits for the task to finish without returning its result (or rethrowing its exception).
+        auto whenDone() noexcept
+        {
+            struct DoneAwaiter : Awaiter
+            {
+                void await_resume() noexcept {}
+            };
+
+            return DoneAwaiter{{m_coroutine}};
+        }
+
+      private:
+        struct Awaiter
+        {
+            bool await_ready() noexcept { return !coroutine || coroutine.done(); }
+
+            // Starts the task, which resumes the awaiting coroutine when it finishes.
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaitingCoroutine) noexcept
+            {
+                coroutine.promise().setContinuation(awaitingCoroutine);
+                return coroutine;
+            }
+
+            decltype(auto) await_resume()
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    coroutine.promise().getResult();
+                }
+                else
+                {
+                    return std::move(coroutine.promise().getResult());
+                }
+            }
+
+            Handle coroutine{};
+        };
+
+        void destroy()
+        {
+            if (m_coroutine)
+            {
+                m_coroutine.destroy();
+            }
+        }
+
+      private:
+        Handle m_coroutine{};
+    };
+
+    template <typename T> inline Task<T> TaskPromise<T>::get_return_object() noexcept { return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)}; }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept { return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)}; }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Batched transform composition. Takes the local translation / rotation / scale of a batch of objects in SoA form and produces the local matrices and local normal matrices.
+// On CPUs with AVX2, 8 objects are processed per iteration (the tail of the batch, or CPUs without AVX2, go through a scalar path that uses the same math).
+namespace nether::TransformKernel
+{
+    // Structure of arrays view over the local transforms of a batch of objects. All arrays must have count elements.
+    // The rotation is in radians, and is applied in the same order as XMMatrixRotationX * XMMatrixRotationY * XMMatrixRotationZ.
+    struct LocalTransforms
+    {
+        const float* translateX{};
+        const float* translateY{};
+        const float* translateZ{};
+
+        const float* rotateX{};
+        const float* rotateY{};
+        const float* rotateZ{};
+
+        const float* scaleX{};
+        const float* scaleY{};
+        const float* scaleZ{};
+
+        size_t count{};
+    };
+
+    // localMatrices[i] = Rotation(i) * Scaling(i) * Translation(i).
+    // localNormalMatrices[i] = inverse-transpose of localMatrices[i]. Only the upper 3x3 is meaningful (the translation row is set to (0, 0, 0, 1)).
+    // The inverse is computed in closed form from the TRS components rather than with a general 4x4 inverse. Scale components must be non zero.
+    // If dirtyFlags is not null, transforms with a zero flag are skipped. Clean transforms that share a SIMD group with a dirty one are still recomputed, which writes the same
+    // values as before.
+    void compose(const LocalTransforms& localTransforms,
+                 const uint8_t* const dirtyFlags,
+                 const std::span<math::XMFLOAT4X4> localMatrices,
+                 const std::span<math::XMFLOAT4X4> localNormalMatrices);
+}
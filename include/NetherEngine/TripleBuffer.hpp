@@ -0,0 +1,92 @@
+#pragma once
+
+// Lock free handoff of values from a single producer thread to a single consumer thread. There are three slots: one the producer writes, one the consumer reads, and the
+// most recently published one in between. Publishing and acquiring swap a slot with the one in between, so neither side ever waits for the other to finish with a slot,
+// and no values are copied. Only depends on the standard library.
+namespace nether
+{
+    template <typename T> class TripleBuffer
+    {
+      public:
+        // Producer only. The slot is not visible to the consumer until publish is called.
+        T& getWriteSlot() { return m_slots[m_writeIndex]; }
+
+        // Producer only. Makes the write slot the latest value, and hands the producer the slot in between. A published value the consumer has not acquired yet is replaced.
+        void publish()
+        {
+            m_writeIndex = swapMiddleSlot(m_writeIndex | NEW_VALUE_BIT);
+        }
+
+        // Producer only. Blocks until the consumer acquired the last published value, so the producer does not run more than one value ahead. Returns false if closed.
+        bool waitUntilConsumed()
+        {
+            uint32_t state = m_state.load(std::memory_order_acquire);
+            while ((state & NEW_VALUE_BIT) && !(state & CLOSED_BIT))
+            {
+                m_state.wait(state, std::memory_order_acquire);
+                state = m_state.load(std::memory_order_acquire);
+            }
+
+            return !(state & CLOSED_BIT);
+        }
+
+        // Consumer only. Blocks until a value is published that was not acquired yet, and returns it. The value stays valid until the next call. Returns nullptr if closed.
+        const T* acquire()
+        {
+            uint32_t state = m_state.load(std::memory_order_acquire);
+            while (!(state & NEW_VALUE_BIT) && !(state & CLOSED_BIT))
+            {
+                m_state.wait(state, std::memory_order_acquire);
+                state = m_state.load(std::memory_order_acquire);
+            }
+
+            if (state & CLOSED_BIT)
+            {
+                return nullptr;
+            }
+
+            // The producer may have published again since the load, in which case the newer value is taken.
+            m_readIndex = swapMiddleSlot(m_readIndex);
+
+            return &m_slots[m_readIndex];
+        }
+
+        // Either side. Wakes up and fails all current and future waits, used to shut down the other thread.
+        void close()
+        {
+            m_state.fetch_or(CLOSED_BIT, std::memory_order_acq_rel);
+            m_state.notify_all();
+        }
+
+        // Only when neither thread uses the buffer, e.g. to release what the slots own at shutdown.
+        std::span<T, 3u> getAllSlots() { return m_slots; }
+
+      private:
+        // Makes slotIndex the slot in between (and sets or clears the new value bit), and returns the index of the slot that was in between. Once set, the closed bit
+        // is never cleared, so a close that races with the swap is not lost, and no waiter ever sees the buffer reopen.
+        uint32_t swapMiddleSlot(const uint32_t slotIndexAndNewValueBit)
+        {
+            uint32_t state = m_state.load(std::memory_order_relaxed);
+            while (!m_state.compare_exchange_weak(state, slotIndexAndNewValueBit | (state & CLOSED_BIT), std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+            }
+
+            m_state.notify_all();
+
+            return state & SLOT_INDEX_MASK;
+        }
+
+      private:
+        static constexpr uint32_t SLOT_INDEX_MASK = 0b011u;
+        static constexpr uint32_t NEW_VALUE_BIT = 0b100u;
+        static constexpr uint32_t CLOSED_BIT = 0b1000u;
+
+        std::array<T, 3u> m_slots{};
+
+        // Index of the slot in between, and the new value / closed bits.
+        std::atomic<uint32_t> m_state{1u};
+
+        uint32_t m_writeIndex{0u};
+        uint32_t m_readIndex{2u};
+    };
+}
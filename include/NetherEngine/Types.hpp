@@ -1,5 +1,8 @@
 #pragma once
 
+#include "DescriptorAllocator.hpp"
+#include "RootConstantLayout.hpp"
+
 struct Uint2
 {
     uint32_t x{};
@@ -8,6 +11,7 @@ struct Uint2
     auto operator<=>(const Uint2& other) const = default;
 };
 
+// The shader visible heaps are indexed by the bindless shaders, so views are written at the index the allocator hands out and stay there until they are released.
 struct DescriptorHeap
 {
     Comptr<ID3D12DescriptorHeap> descriptorHeap{};
@@ -16,10 +20,7 @@ struct DescriptorHeap
     CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorHandleFromHeapStart{};
     CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorHandleFromHeapStart{};
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE currentCpuDescriptorHandle{};
-    CD3DX12_GPU_DESCRIPTOR_HANDLE currentGpuDescriptorHandle{};
-
-    uint32_t currentDescriptorIndex{};
+    nether::DescriptorAllocator allocator{};
 
     void init(ID3D12Device5* const device, const D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t descriptorCount, const std::wstring_view descriptorName)
     {
@@ -46,22 +47,20 @@ struct DescriptorHeap
         descriptorSize = device->GetDescriptorHandleIncrementSize(heapType);
 
         cpuDescriptorHandleFromHeapStart = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
-        currentCpuDescriptorHandle = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
 
         if (descriptorHeapDesc.Flags == D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE)
         {
             gpuDescriptorHandleFromHeapStart = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
-            currentGpuDescriptorHandle = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
         }
+
+        allocator.init(descriptorCount, wStringToString(descriptorName));
     }
 
-    void offset()
-    {
-        currentDescriptorIndex++;
+    // Running out of descriptors is a fatal error.
+    [[nodiscard]] uint32_t allocate() { return allocator.allocate(); }
 
-        currentCpuDescriptorHandle.Offset(descriptorSize);
-        currentGpuDescriptorHandle.Offset(descriptorSize);
-    }
+    // The GPU must be done with the view.
+    void release(const uint32_t index) { allocator.release(index); }
 
     void offset(CD3DX12_CPU_DESCRIPTOR_HANDLE& cpuDescriptorHandle) const { cpuDescriptorHandle.Offset(descriptorSize); }
     void offset(CD3DX12_GPU_DESCRIPTOR_HANDLE& gpuDescriptorHandle) const { gpuDescriptorHandle.Offset(descriptorSize); }
@@ -71,21 +70,42 @@ struct DescriptorHeap
         CD3DX12_CPU_DESCRIPTOR_HANDLE descriptorHandle = cpuDescriptorHandleFromHeapStart;
         return descriptorHandle.Offset(index, descriptorSize);
     }
+
+    CD3DX12_GPU_DESCRIPTOR_HANDLE getGpuDescriptorHandleAtIndex(const uint32_t index) const
+    {
+        CD3DX12_GPU_DESCRIPTOR_HANDLE descriptorHandle = gpuDescriptorHandleFromHeapStart;
+        return descriptorHandle.Offset(index, descriptorSize);
+    }
 };
 
 struct Shader
 {
+    // Shaders are only compiled on Windows, the null graphics backend does not need bytecode.
+#ifdef _WIN32
     Comptr<IDxcBlob> shaderBlob{};
+#endif
+
+    // Canonical paths of the shader source and every file it (transitively) includes. Used to find the shaders to recompile when a file changes.
+    std::vector<std::filesystem::path> dependencies{};
+
+    // Layout of the root constants as the shader was compiled, empty if the shader does not use them.
+    std::vector<nether::ReflectedRootConstant> rootConstants{};
 };
 
 struct GraphicsPipeline
 {
     Comptr<ID3D12PipelineState> pipelineState{};
+
+    // Number of 32 bit root constants the shaders of the pipeline read.
+    uint32_t rootConstantCount{};
 };
 
 struct ComputePipeline
 {
     Comptr<ID3D12PipelineState> pipelineState{};
+
+    // Number of 32 bit root constants the shader of the pipeline reads.
+    uint32_t rootConstantCount{};
 };
 
 struct IndexBuffer
@@ -107,6 +127,10 @@ struct Mesh
     StructuredBuffer normalBuffer{};
 
     IndexBuffer indexBuffer{};
+    uint32_t indexCount{};
+
+    // Object space bounding sphere (center in xyz, radius in w), used for frustum culling.
+    math::XMFLOAT4 boundingSphere{};
 };
 
 struct Texture
@@ -139,22 +163,12 @@ template <typename T> struct ConstantBuffer
     }
 };
 
-struct alignas(256) TransformData
+// Per instance data, stored in a per frame structured buffer and indexed by SV_InstanceID (see shaders/Common.hlsli).
+struct InstanceData
 {
-    math::XMMATRIX modelMatrix{};
-    math::XMMATRIX inverseModelViewMatrix{};
-};
-
-struct Renderable
-{
-    Mesh* mesh{};
-    GraphicsPipeline* graphicsPipeline{};
-
-    math::XMFLOAT3 rotate{0.0f, 0.0f, 0.0f};
-    math::XMFLOAT3 scale{1.0f, 1.0f, 1.0f};
-    math::XMFLOAT3 translate{0.0f, 0.0f, 0.0f};
-
-    ConstantBuffer<TransformData> transformBuffer{};
+    math::XMFLOAT4X4 modelMatrix{};
+    // Inverse-transpose of the model matrix. It does not depend on the view, so it can be computed once for static objects.
+    math::XMFLOAT4X4 normalMatrix{};
 };
 
 struct alignas(256) SceneData
@@ -179,9 +193,21 @@ struct FrameResources
     Comptr<ID3D12CommandAllocator> commandAllocator{};
     Comptr<ID3D12GraphicsCommandList2> commandList{};
 
+    // One command allocator / list per recording chunk (see ParallelRecorder.hpp), so that chunks can be recorded on different threads.
+    std::vector<Comptr<ID3D12CommandAllocator>> chunkCommandAllocators{};
+    std::vector<Comptr<ID3D12GraphicsCommandList2>> chunkCommandLists{};
+
     uint64_t fenceValue{};
 
     ConstantBuffer<SceneData> sceneBuffer{};
+
+    // Upload heap buffer that stays mapped for the lifetime of the engine.
+    StructuredBuffer instanceBuffer{};
+    InstanceData* instanceBufferPointer{};
+
+    // Argument buffer for ExecuteIndirect, holds the IndirectDrawRecords of the frame (see IndirectCommands.hpp). Also stays mapped.
+    StructuredBuffer indirectCommandBuffer{};
+    std::byte* indirectCommandBufferPointer{};
 };
 
 enum class DimensionType : uint8_t
@@ -199,4 +225,30 @@ struct alignas(256) GenerateMipMapData
     DimensionType dimensionType;
     uint32_t isSrgb;
     math::XMFLOAT2 texelSize;
+};
+
+// Root constants of shaders/GenerateMipMaps.hlsl.
+struct GenerateMipMapRenderResources
+{
+    uint32_t mipGenBufferIndex{};
+    uint32_t sourceTextureIndex{};
+    uint32_t outputMip1Index{};
+    uint32_t outputMip2Index{};
+    uint32_t outputMip3Index{};
+    uint32_t outputMip4Index{};
+};
+
+inline constexpr std::array<nether::RootConstantField, 6u> GENERATE_MIP_MAP_RENDER_RESOURCES_FIELDS = {{
+    {"mipGenBufferIndex", offsetof(GenerateMipMapRenderResources, mipGenBufferIndex), sizeof(uint32_t)},
+    {"sourceTextureIndex", offsetof(GenerateMipMapRenderResources, sourceTextureIndex), sizeof(uint32_t)},
+    {"outputMip1Index", offsetof(GenerateMipMapRenderResources, outputMip1Index), sizeof(uint32_t)},
+    {"outputMip2Index", offsetof(GenerateMipMapRenderResources, outputMip2Index), sizeof(uint32_t)},
+    {"outputMip3Index", offsetof(GenerateMipMapRenderResources, outputMip3Index), sizeof(uint32_t)},
+    {"outputMip4Index", offsetof(GenerateMipMapRenderResources, outputMip4Index), sizeof(uint32_t)},
+}};
+
+inline constexpr nether::RootConstantLayout GENERATE_MIP_MAP_RENDER_RESOURCES_LAYOUT = {
+    .name = "GenerateMipMapRenderResources",
+    .sizeInBytes = sizeof(GenerateMipMapRenderResources),
+    .fields = GENERATE_MIP_MAP_RENDER_RESOURCES_FIELDS,
 };
\ No newline at end of file
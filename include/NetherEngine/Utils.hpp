@@ -6,6 +6,8 @@
 inline std::wstring stringToWString(const std::string_view inputString)
 {
     std::wstring result{};
+
+#ifdef _WIN32
     const std::string input{inputString};
 
     const int32_t length = MultiByteToWideChar(CP_UTF8, 0, input.c_str(), -1, NULL, 0);
@@ -14,6 +16,23 @@ inline std::wstring stringToWString(const std::string_view inputString)
         result.resize(size_t(length) - 1);
         MultiByteToWideChar(CP_UTF8, 0, input.c_str(), -1, result.data(), length);
     }
+#else
+    // wchar_t is UTF-32 on other platforms, so each code point is decoded into a single character.
+    for (size_t i = 0u; i < inputString.size();)
+    {
+        const uint8_t leadByte = static_cast<uint8_t>(inputString[i]);
+        const size_t length = leadByte < 0x80u ? 1u : leadByte < 0xE0u ? 2u : leadByte < 0xF0u ? 3u : 4u;
+
+        uint32_t codePoint = length == 1u ? leadByte : leadByte & (0x7Fu >> length);
+        for (size_t j = 1u; j < length && i + j < inputString.size(); j++)
+        {
+            codePoint = (codePoint << 6u) | (static_cast<uint8_t>(inputString[i + j]) & 0x3Fu);
+        }
+
+        result.push_back(static_cast<wchar_t>(codePoint));
+        i += length;
+    }
+#endif
 
     return result;
 }
@@ -21,6 +40,8 @@ inline std::wstring stringToWString(const std::string_view inputString)
 inline std::string wStringToString(const std::wstring_view inputWString)
 {
     std::string result{};
+
+#ifdef _WIN32
     const std::wstring input{inputWString};
 
     const int32_t length = WideCharToMultiByte(CP_UTF8, 0, input.c_str(), -1, NULL, 0, NULL, NULL);
@@ -29,35 +50,53 @@ inline std::string wStringToString(const std::wstring_view inputWString)
         result.resize(size_t(length) - 1);
         WideCharToMultiByte(CP_UTF8, 0, input.c_str(), -1, result.data(), length, NULL, NULL);
     }
+#else
+    for (const wchar_t character : inputWString)
+    {
+        const uint32_t codePoint = static_cast<uint32_t>(character);
+        if (codePoint < 0x80u)
+        {
+            result.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800u)
+        {
+            result.push_back(static_cast<char>(0xC0u | (codePoint >> 6u)));
+            result.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+        }
+        else if (codePoint < 0x10000u)
+        {
+            result.push_back(static_cast<char>(0xE0u | (codePoint >> 12u)));
+            result.push_back(static_cast<char>(0x80u | ((codePoint >> 6u) & 0x3Fu)));
+            result.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+        }
+        else
+        {
+            result.push_back(static_cast<char>(0xF0u | (codePoint >> 18u)));
+            result.push_back(static_cast<char>(0x80u | ((codePoint >> 12u) & 0x3Fu)));
+            result.push_back(static_cast<char>(0x80u | ((codePoint >> 6u) & 0x3Fu)));
+            result.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+        }
+    }
+#endif
 
     return result;
 }
 
-// Reference : https://github.com/microsoft/DirectX-Graphics-Samples/blob/e5ea2ac7430ce39e6f6d619fd85ae32581931589/Samples/Desktop/D3D12Fullscreen/src/DXSampleHelper.h#L21.
-inline std::string hresultToString(const HRESULT hr)
-{
-    char s_str[64] = {};
-    sprintf_s(s_str, "HRESULT of 0x%08X", static_cast<UINT>(hr));
-    return std::string(s_str);
-}
+inline std::string hresultToString(const HRESULT hr) { return std::format("HRESULT of 0x{:08X}", static_cast<uint32_t>(hr)); }
 
+// Fatal errors only throw, whatever thread they are raised on. The exception reaches the top level of the application (exceptions of the render thread and of jobs are
+// rethrown on the simulation thread), which reports it : src/Main.cpp shows a message box on Windows. Code that can recover (e.g. assets that fail to load) catches it,
+// and tests check for it, without a modal dialog blocking the thread.
 inline void fatalError(const std::wstring_view message, const std::source_location source_location = std::source_location::current())
 {
-    const auto errorMessage = std::string(wStringToString(message) + std::format(" Source Location data : File Name -> {}, Function Name -> {}, Line Number -> {}, Column -> {}",
-                                                                                 source_location.file_name(),
-                                                                                 source_location.function_name(),
-                                                                                 source_location.line(),
-                                                                                 source_location.column()));
-
-    ::MessageBoxW(nullptr, message.data(), L"ERROR!", MB_OK | MB_ICONEXCLAMATION);
-    throw std::runtime_error(errorMessage);
+    throw std::runtime_error(wStringToString(message) + std::format(" Source Location data : File Name -> {}, Function Name -> {}, Line Number -> {}, Column -> {}",
+                                                                    source_location.file_name(),
+                                                                    source_location.function_name(),
+                                                                    source_location.line(),
+                                                                    source_location.column()));
 }
 
-inline void fatalError(const std::string_view message)
-{
-    ::MessageBoxA(nullptr, message.data(), "ERROR!", MB_OK | MB_ICONEXCLAMATION);
-    throw std::runtime_error(message.data());
-}
+inline void fatalError(const std::string_view message) { throw std::runtime_error(std::string(message)); }
 
 inline void throwIfFailed(const HRESULT hr)
 {
@@ -113,6 +152,22 @@ inline void debugLog(const std::wstring_view message)
     return buffer;
 }
 
+// 64 bit FNV-1a hash. To hash data that is split in several pieces, pass the hash of the previous piece as the seed.
+inline constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+inline uint64_t hashBytes(const std::span<const std::byte> bytes, const uint64_t seed = FNV_OFFSET_BASIS)
+{
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t hash = seed;
+    for (const std::byte byte : bytes)
+    {
+        hash = (hash ^ static_cast<uint64_t>(byte)) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
 template <typename T> static inline constexpr typename std::underlying_type<T>::type EnumClassValue(const T& value) { return static_cast<std::underlying_type<T>::type>(value); }
 
 inline DXGI_FORMAT getNonSRGBFormat(const DXGI_FORMAT format)
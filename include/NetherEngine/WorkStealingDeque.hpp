@@ -0,0 +1,54 @@
+#pragma once
+
+namespace nether
+{
+    struct Job;
+
+    // Chase-Lev work stealing deque (with the memory orderings of "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013). The owning thread pushes
+    // and pops jobs at the bottom without locks or contention in the common case, while other threads steal from the top. The buffer grows when full. Old buffers are kept
+    // until the deque is destroyed, as a thief might still be reading from one.
+    class WorkStealingDeque
+    {
+      public:
+        explicit WorkStealingDeque(const uint32_t initialCapacity = 1024u);
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // Owner only.
+        void push(Job* const job);
+
+        // Owner only. Returns the most recently pushed job, or nullptr if empty.
+        Job* pop();
+
+        // Any thread. Returns the oldest job, or nullptr if the deque is empty or the steal lost a race (with the owner or another thief).
+        Job* steal();
+
+        // Any thread. Only a snapshot, the deque can change right after.
+        bool isEmpty() const;
+
+      private:
+        struct Buffer
+        {
+            explicit Buffer(const int64_t capacity) : capacity(capacity), slots(std::make_unique<std::atomic<Job*>[]>(static_cast<size_t>(capacity))) {}
+
+            std::atomic<Job*>& operator[](const int64_t index) { return slots[static_cast<size_t>(index & (capacity - 1))]; }
+
+            // Always a power of two, so indices wrap around with a mask.
+            int64_t capacity{};
+            std::unique_ptr<std::atomic<Job*>[]> slots{};
+        };
+
+        Buffer* grow(Buffer* const buffer, const int64_t top, const int64_t bottom);
+
+      private:
+        // Kept on separate cache lines, as thieves write to top while the owner writes to bottom.
+        alignas(64) std::atomic<int64_t> m_top{};
+        alignas(64) std::atomic<int64_t> m_bottom{};
+
+        std::atomic<Buffer*> m_buffer{};
+
+        // Owner only. Every buffer the deque had, the last one being the current buffer.
+        std::vector<std::unique_ptr<Buffer>> m_buffers{};
+    };
+}
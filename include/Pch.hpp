@@ -6,6 +6,13 @@ static constexpr bool NETHER_DEBUG_MODE = true;
 static constexpr bool NETHER_DEBUG_MODE = false;
 #endif
 
+// Shipping builds use the shaders embedded by "premake5 bake-shaders", and never compile shaders at runtime.
+#ifdef NETHER_SHIPPING
+static constexpr bool NETHER_SHIPPING_MODE = true;
+#else
+static constexpr bool NETHER_SHIPPING_MODE = false;
+#endif
+
 // STL includes.
 #include <iostream>
 #include <string>
@@ -13,18 +20,40 @@ static constexpr bool NETHER_DEBUG_MODE = false;
 #include <exception>
 #include <stdexcept>
 #include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <new>
 #include <format>
+#include <charconv>
 #include <span>
 #include <source_location>
 #include <fstream>
+#include <sstream>
 #include <ranges>
 #include <vector>
 #include <filesystem>
 #include <algorithm>
+#include <numeric>
 #include <array>
 #include <unordered_map>
 #include <chrono>
+#include <functional>
+#include <utility>
+#include <bit>
+#include <optional>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <coroutine>
+#include <deque>
 
+#ifdef _WIN32
 // Windows, DirectX12 and DXGI includes.
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -35,6 +64,20 @@ static constexpr bool NETHER_DEBUG_MODE = false;
 #include <wrl.h>
 #include <d3dx12.h>
 #include <d3d12shader.h>
+#else
+// Other platforms only build the core (see premake5.lua), which renders through the null graphics backend. The DirectX-Headers provide the D3D12 types the core shares with
+// the D3D12 backend (and ComPtr) through their WSL adapters, but there is no D3D12 runtime. DXC is only there if premake found its Linux package (see NETHER_HAS_DXC).
+#include <wsl/winadapter.h>
+#include <wsl/wrladapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12.h>
+
+#ifdef NETHER_HAS_DXC
+#include <dxc/dxcapi.h>
+#include <directx/d3d12shader.h>
+#endif
+#endif
 
 // Math library includes.
 #include <DirectXMath.h>
@@ -1,55 +1,451 @@
--- A Visual studio solution.
+-- gcc / clang sanitizers, e.g. "premake5 gmake2 --sanitize=thread" to run the tests under ThreadSanitizer.
+newoption
+{
+    trigger = "sanitize",
+    value = "sanitizer",
+    description = "Build with a gcc / clang sanitizer (not on Windows)",
+    allowed =
+    {
+        { "address", "AddressSanitizer" },
+        { "thread", "ThreadSanitizer" },
+        { "undefined", "UndefinedBehaviorSanitizer" },
+    }
+}
+
+-- A Visual studio solution on Windows, makefiles (premake5 gmake2) elsewhere.
 workspace "NetherEngine"
     configurations
     {
         "Debug",
-        "Release"
+        "Release",
+        "Shipping"
     }
     architecture "x64"
+    startproject "NetherEngine"
 
--- A Visual studio project.
-project "NetherEngine"
-    kind "ConsoleApp"
     language "C++"
     cppdialect "C++20"
 
-    objdir "bin-int/%{cfg.buildcfg}"
+    objdir "bin-int/%{cfg.buildcfg}/%{prj.name}"
     targetdir "bin/%{cfg.buildcfg}"
 
-    files
-    {
-        "src/**.cpp",
-        "include/**.hpp",
-        "shaders/**.hlsl"
-    }
-
     includedirs 
     { 
         "include/",
         "include/NetherEngine",
     }
 
-    links
-    {
-        "d3d12",
-        "dxgi",
-        "dxguid",
-        "dxcompiler",
-    }
-
     pchheader "Pch.hpp"
     pchsource "src/Pch.cpp"
 
     staticruntime "Off"
 
-    filter "files:**.hlsl"
-        buildaction "None"
+    -- No vectorextensions : the build only assumes x64 (SSE2), and the AVX2 paths are chosen at runtime (see CpuFeatures.hpp).
 
+    -- Profiler zones (see Profiler.hpp) and allocation tracking (see AllocationTracker.hpp) are compiled out of Shipping builds.
     filter "configurations:Debug"
-        defines "NETHER_DEBUG"
+        defines { "NETHER_DEBUG", "NETHER_PROFILER", "NETHER_ALLOCATION_TRACKING" }
         symbols "On"
         optimize "Debug"
 
     filter "configurations:Release"
-        defines "NETHER_RELEASE"
+        defines { "NETHER_RELEASE", "NETHER_PROFILER", "NETHER_ALLOCATION_TRACKING" }
         optimize "Speed"
+
+    filter "configurations:Shipping"
+        defines { "NETHER_RELEASE", "NETHER_SHIPPING" }
+        optimize "Speed"
+
+    filter {}
+
+    if _OPTIONS["sanitize"] then
+        filter "system:not windows"
+            buildoptions { "-fsanitize=" .. _OPTIONS["sanitize"], "-fno-omit-frame-pointer" }
+            linkoptions { "-fsanitize=" .. _OPTIONS["sanitize"] }
+
+        filter {}
+    end
+
+-- The CPU side of the engine (scene, draw lists, recording, render graph) and the null graphics backend. Does not use a window, the D3D12 runtime or DXC, so it builds on
+-- any platform with gcc / clang as well (std::format needs gcc 13 / clang 17). Outside of Windows, the directxmath and directx-headers vcpkg ports provide the math
+-- library and the D3D12 types.
+local coreFiles =
+{
+    "src/AllocationTracker.cpp",
+    "src/AssetArchive.cpp",
+    "src/AssetLoader.cpp",
+    "src/AssetPipeline.cpp",
+    "src/AssetRegistry.cpp",
+    "src/Camera.cpp",
+    "src/CameraPath.cpp",
+    "src/CpuFeatures.cpp",
+    "src/DescriptorAllocator.cpp",
+    "src/DrawList.cpp",
+    "src/FileWatcher.cpp",
+    "src/FrameBuilder.cpp",
+    "src/FrameRenderer.cpp",
+    "src/FrustumCuller.cpp",
+    "src/GltfImporter.cpp",
+    "src/IndirectCommands.cpp",
+    "src/JobSystem.cpp",
+    "src/JsonReader.cpp",
+    "src/LinearArena.cpp",
+    "src/Lz4.cpp",
+    "src/MappedFile.cpp",
+    "src/NullGraphicsBackend.cpp",
+    "src/ParallelRecorder.cpp",
+    "src/Profiler.cpp",
+    "src/RenderGraph.cpp",
+    "src/RootConstantLayout.cpp",
+    "src/Scene.cpp",
+    "src/ShaderCache.cpp",
+    "src/ShaderDependencyGraph.cpp",
+    "src/TransformKernel.cpp",
+    "src/WorkStealingDeque.cpp",
+}
+
+-- Shaders are compiled at runtime with DXC (see ShaderCompiler.hpp), which comes with the Windows SDK. Elsewhere, its Linux package is used if it is found : libdxcompiler.so
+-- and the include directory next to it, with the dxc/ headers (e.g. a DirectXShaderCompiler release, or the distribution's directx-shader-compiler package). The projects
+-- that link DXC define NETHER_HAS_DXC.
+local dxcLibraryDirectory = os.findlib("dxcompiler")
+local hasDxc = os.istarget("windows") or dxcLibraryDirectory ~= nil
+
+-- Builds the shader compiler into the current project, for the configurations of the current filter.
+local function useDxc()
+    defines "NETHER_HAS_DXC"
+    files { "src/ShaderCompiler.cpp", "src/EmbeddedShaders.cpp" }
+    links "dxcompiler"
+
+    if not os.istarget("windows") then
+        includedirs(path.join(dxcLibraryDirectory, "../include"))
+        libdirs(dxcLibraryDirectory)
+        runpathdirs(dxcLibraryDirectory)
+    end
+end
+
+project "NetherCore"
+    kind "StaticLib"
+
+    files
+    {
+        coreFiles,
+        "src/Pch.cpp",
+        "include/**.hpp"
+    }
+
+    filter "system:not windows"
+        links "pthread"
+
+    filter {}
+
+-- Benchmarks of the CPU side of the engine (see benchmarks/Benchmark.hpp), built on every platform and run without a GPU through the null graphics backend. Run from the
+-- repository root, e.g. "bin/Release/NetherBenchmarks --json results.json". Where DXC is available (see above), shader compilation is benchmarked as well, except in Shipping.
+project "NetherBenchmarks"
+    kind "ConsoleApp"
+
+    files
+    {
+        "benchmarks/**.cpp",
+        "benchmarks/**.hpp",
+        "src/Pch.cpp"
+    }
+
+    includedirs "benchmarks"
+
+    links "NetherCore"
+
+    debugdir "%{wks.location}"
+
+    filter "system:not windows"
+        links "pthread"
+
+    if hasDxc then
+        filter "configurations:not Shipping"
+            useDxc()
+    end
+
+    filter {}
+
+-- Tests of the CPU side of the engine (see tests/Test.hpp), built on every platform and run without a GPU. Run from the repository root, e.g. "bin/Debug/NetherTests" or
+-- "bin/Debug/NetherTests --filter Scene". The exit code is the number of failed tests. Where DXC is available (see above), shader compilation is tested as well. Shipping
+-- builds test the baked shaders instead, which are only baked on Windows (see NetherShaders).
+project "NetherTests"
+    kind "ConsoleApp"
+
+    files
+    {
+        "tests/**.cpp",
+        "tests/**.hpp",
+        "src/Pch.cpp"
+    }
+
+    includedirs "tests"
+
+    links "NetherCore"
+
+    debugdir "%{wks.location}"
+
+    if os.istarget("windows") then
+        dependson "NetherShaders"
+    end
+
+    filter "system:not windows"
+        links "pthread"
+
+    filter {}
+
+    if os.istarget("windows") then
+        useDxc()
+    elseif hasDxc then
+        filter "configurations:not Shipping"
+            useDxc()
+    end
+
+    filter { "system:windows", "configurations:Shipping" }
+        files "generated/EmbeddedShaders.cpp"
+
+    filter {}
+
+-- Offline packer of asset archives (see AssetArchive.hpp), built on every platform. Run from the repository root, e.g. "bin/Release/NetherPacker assets.pak assets".
+project "NetherPacker"
+    kind "ConsoleApp"
+
+    files
+    {
+        "tools/NetherPacker/**.cpp",
+        "src/Pch.cpp"
+    }
+
+    links "NetherCore"
+
+    debugdir "%{wks.location}"
+
+    filter "system:not windows"
+        links "pthread"
+
+    filter {}
+
+-- The D3D12 application, and the shader bake it embeds in Shipping builds. Windows only.
+if os.istarget("windows") then
+    -- Bakes the shaders before the projects that embed them are built, so the engine and the tests do not both write generated/EmbeddedShaders.cpp at once.
+    project "NetherShaders"
+        kind "Utility"
+
+        filter "configurations:Shipping"
+            prebuildcommands { '"%{wks.location}/premake5" bake-shaders' }
+
+        filter {}
+
+    project "NetherEngine"
+        kind "ConsoleApp"
+
+        files
+        {
+            "src/**.cpp",
+            "include/**.hpp",
+            "shaders/**.hlsl",
+            -- Written by the bake-shaders action (see below), only built in Shipping.
+            "generated/EmbeddedShaders.cpp"
+        }
+
+        removefiles(coreFiles)
+
+        links
+        {
+            "NetherCore",
+            "d3d12",
+            "dxgi",
+            "dxguid",
+            "dxcompiler",
+        }
+
+        dependson "NetherShaders"
+
+        filter "files:**.hlsl"
+            buildaction "None"
+
+        filter "configurations:not Shipping"
+            removefiles "generated/EmbeddedShaders.cpp"
+
+        filter {}
+end
+
+-- Offline shader compilation for Shipping builds. Runs the dxc command line compiler (the same flags as ShaderCompiler.cpp, minus debug and reflection data) on every shader
+-- listed below, and embeds the bytecode in generated/EmbeddedShaders.cpp. Only needs premake and dxc, so it runs on Linux as well.
+-- Each shader has to be listed here, a shader the engine asks for but that was not baked is a fatal error at startup in Shipping builds.
+local bakedShaders =
+{
+    { path = "shaders/PhongShader.hlsl", types = { "Vertex", "Pixel" }, features = { "PHONG_SPECULAR", "PHONG_DIRECTIONAL_LIGHT" } },
+    { path = "shaders/LightShader.hlsl", types = { "Vertex", "Pixel" } },
+    { path = "shaders/GenerateMipMaps.hlsl", types = { "Compute" } },
+}
+
+-- Entry point and target profile of each shader type, see ShaderCompiler::buildCompilationArguments.
+local shaderTypes =
+{
+    Vertex = { entryPoint = "VsMain", targetProfile = "vs_6_6" },
+    Pixel = { entryPoint = "PsMain", targetProfile = "ps_6_6" },
+    Compute = { entryPoint = "CsMain", targetProfile = "cs_6_6" },
+}
+
+newoption
+{
+    trigger = "dxc",
+    value = "path",
+    description = "dxc executable used by bake-shaders (defaults to the one on PATH)"
+}
+
+-- Returns the defines of every variant of the shader, in the same order and format as ShaderCompiler::getVariantJob.
+local function getVariantDefines(bakedShader)
+    local features = bakedShader.features or {}
+    local variantDefines = {}
+
+    for variantKey = 0, (1 << #features) - 1 do
+        local defines = {}
+        for featureIndex, feature in ipairs(features) do
+            local value = (variantKey >> (featureIndex - 1)) & 1
+            table.insert(defines, { name = feature, value = tostring(value) })
+        end
+
+        table.insert(variantDefines, defines)
+    end
+
+    return variantDefines
+end
+
+-- Must match ShaderCompiler::getEmbeddedShaderKey.
+local function getEmbeddedShaderKey(path, shaderType, defines)
+    local defineStrings = {}
+    for _, define in ipairs(defines) do
+        table.insert(defineStrings, define.value ~= "" and (define.name .. "=" .. define.value) or define.name)
+    end
+
+    return path .. "|" .. shaderType .. "|" .. table.concat(defineStrings, ";")
+end
+
+local function compileShader(dxc, path, shaderType, defines, outputPath)
+    local arguments =
+    {
+        dxc,
+        "-E", shaderTypes[shaderType].entryPoint,
+        "-T", shaderTypes[shaderType].targetProfile,
+        "-Zpr",
+        "-WX",
+        "-all_resources_bound",
+        "-I", "shaders",
+        "-O3",
+        "-Qstrip_debug",
+        "-Qstrip_reflect",
+        "-Fo", outputPath,
+    }
+
+    for _, define in ipairs(defines) do
+        table.insert(arguments, "-D")
+        table.insert(arguments, define.value ~= "" and (define.name .. "=" .. define.value) or define.name)
+    end
+
+    table.insert(arguments, path)
+
+    local command = table.concat(arguments, " ")
+    if not os.execute(command) then
+        error("Failed to compile " .. path .. " (" .. shaderType .. ") : " .. command, 0)
+    end
+
+    local file = assert(io.open(outputPath, "rb"))
+    local bytecode = file:read("a")
+    file:close()
+    os.remove(outputPath)
+
+    return bytecode
+end
+
+local function toByteArray(bytecode)
+    local lines = {}
+    for lineStart = 1, #bytecode, 16 do
+        local bytes = {}
+        for byteIndex = lineStart, math.min(lineStart + 15, #bytecode) do
+            table.insert(bytes, string.format("0x%02x", bytecode:byte(byteIndex)))
+        end
+
+        table.insert(lines, "        " .. table.concat(bytes, ", ") .. ",")
+    end
+
+    return table.concat(lines, "\n")
+end
+
+newaction
+{
+    trigger = "bake-shaders",
+    description = "Compile all shaders offline into generated/EmbeddedShaders.cpp, for Shipping builds",
+
+    execute = function()
+        os.chdir(_MAIN_SCRIPT_DIR)
+        os.mkdir("generated")
+
+        local dxc = _OPTIONS["dxc"] or "dxc"
+
+        -- Variants whose defines do not change the code compile to the same bytecode, which is only embedded once.
+        local uniqueBytecodes = {}
+        local bytecodeIndices = {}
+        local entries = {}
+
+        for _, bakedShader in ipairs(bakedShaders) do
+            for _, shaderType in ipairs(bakedShader.types) do
+                for _, defines in ipairs(getVariantDefines(bakedShader)) do
+                    local bytecode = compileShader(dxc, bakedShader.path, shaderType, defines, "generated/Shader.dxil")
+
+                    if not bytecodeIndices[bytecode] then
+                        table.insert(uniqueBytecodes, bytecode)
+                        bytecodeIndices[bytecode] = #uniqueBytecodes - 1
+                    end
+
+                    table.insert(entries, { key = getEmbeddedShaderKey(bakedShader.path, shaderType, defines), bytecodeIndex = bytecodeIndices[bytecode] })
+                end
+            end
+        end
+
+        local lines =
+        {
+            "// Generated by \"premake5 bake-shaders\", do not edit.",
+            "#include \"Pch.hpp\"",
+            "",
+            "#include \"EmbeddedShaders.hpp\"",
+            "",
+            "namespace nether",
+            "{",
+        }
+
+        for bytecodeIndex, bytecode in ipairs(uniqueBytecodes) do
+            table.insert(lines, string.format("    static constexpr uint8_t SHADER_%d[] = {", bytecodeIndex - 1))
+            table.insert(lines, toByteArray(bytecode))
+            table.insert(lines, "    };")
+            table.insert(lines, "")
+        end
+
+        table.insert(lines, "    static constexpr EmbeddedShader EMBEDDED_SHADERS[] = {")
+        for _, entry in ipairs(entries) do
+            table.insert(lines, string.format("        EmbeddedShader{\"%s\", SHADER_%d, sizeof(SHADER_%d)},", entry.key, entry.bytecodeIndex, entry.bytecodeIndex))
+        end
+        table.insert(lines, "    };")
+        table.insert(lines, "")
+        table.insert(lines, "    std::span<const EmbeddedShader> getEmbeddedShaders() { return EMBEDDED_SHADERS; }")
+        table.insert(lines, "}")
+        table.insert(lines, "")
+
+        -- Only rewritten when the contents change, so an unchanged bake does not trigger a rebuild.
+        local source = table.concat(lines, "\n")
+        local existingFile = io.open("generated/EmbeddedShaders.cpp", "rb")
+        local existingSource = existingFile and existingFile:read("a")
+        if existingFile then
+            existingFile:close()
+        end
+
+        if existingSource ~= source then
+            local file = assert(io.open("generated/EmbeddedShaders.cpp", "wb"))
+            file:write(source)
+            file:close()
+        end
+
+        print(string.format("Baked %d shaders (%d unique) into generated/EmbeddedShaders.cpp", #entries, #uniqueBytecodes))
+    end
+}
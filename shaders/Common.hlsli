@@ -1,10 +1,10 @@
 #ifndef COMMON_HLSLI
 #define COMMON_HLSLI
 
-struct TransformData
+struct InstanceData
 {
     row_major matrix modelMatrix;
-    row_major matrix inverseModelViewMatrix;
+    row_major matrix normalMatrix;
 };
 
 struct SceneData
@@ -20,6 +20,7 @@ struct GenerateMipMapData
     float2 texelSize;
 };
 
+// Must match GenerateMipMapRenderResources in include/NetherEngine/Types.hpp (checked through reflection when the pipeline is created).
 struct RenderResources
 {
     uint mipGenBufferIndex;
@@ -7,6 +7,7 @@ struct VertexOutput
     float2 textureCoord : TEXTURE_COORD;
 };
 
+// Must match RenderResources in include/NetherEngine/IndirectCommands.hpp, as it is also written by ExecuteIndirect (checked through reflection when the pipeline is created).
 struct RenderResources
 {
     uint positionBufferIndex;
@@ -14,7 +15,8 @@ struct RenderResources
     uint normalBufferIndex;
 
     uint sceneBufferIndex;
-    uint transformBufferIndex;
+    uint instanceBufferIndex;
+    uint instanceOffset;
 
     uint albedoTextureIndex;
 };
@@ -22,16 +24,19 @@ struct RenderResources
 
 ConstantBuffer<RenderResources> renderResources : register(b0);
 
-VertexOutput VsMain(uint vertexID : SV_VertexID)
+VertexOutput VsMain(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
 {
     VertexOutput output;
 
     StructuredBuffer<float3> positionBuffer = ResourceDescriptorHeap[renderResources.positionBufferIndex];
 
     ConstantBuffer<SceneData> sceneBuffer = ResourceDescriptorHeap[renderResources.sceneBufferIndex];
-    ConstantBuffer<TransformData> transformBuffer = ResourceDescriptorHeap[renderResources.transformBufferIndex];
+    StructuredBuffer<InstanceData> instanceBuffer = ResourceDescriptorHeap[renderResources.instanceBufferIndex];
 
-    output.position = mul(float4(positionBuffer[vertexID], 1.0f), mul(transformBuffer.modelMatrix, sceneBuffer.viewProjectionMatrix));
+    // SV_InstanceID does not include the start instance location, so the offset of this draw's instances is passed in explicitly.
+    const InstanceData instance = instanceBuffer[renderResources.instanceOffset + instanceID];
+
+    output.position = mul(float4(positionBuffer[vertexID], 1.0f), mul(instance.modelMatrix, sceneBuffer.viewProjectionMatrix));
 
     return output;
 }
@@ -1,6 +1,15 @@
 #include "StaticSamplers.hlsli"
 #include "Common.hlsli"
 
+// Permutation features (see PHONG_SHADER_FEATURES in src/Engine.cpp), defined to 0 or 1 by the shader compiler. Enabled when compiled without permutations.
+#ifndef PHONG_SPECULAR
+#define PHONG_SPECULAR 1
+#endif
+
+#ifndef PHONG_DIRECTIONAL_LIGHT
+#define PHONG_DIRECTIONAL_LIGHT 1
+#endif
+
 struct VertexOutput
 {
     float4 position : SV_Position;
@@ -9,6 +18,7 @@ struct VertexOutput
     float3 viewSpacePosition : WORLD_SPACE_COORD;
 };
 
+// Must match RenderResources in include/NetherEngine/IndirectCommands.hpp, as it is also written by ExecuteIndirect (checked through reflection when the pipeline is created).
 struct RenderResources
 {
     uint positionBufferIndex;
@@ -16,14 +26,15 @@ struct RenderResources
     uint normalBufferIndex;
 
     uint sceneBufferIndex;
-    uint transformBufferIndex;
+    uint instanceBufferIndex;
+    uint instanceOffset;
 
     uint albedoTextureIndex;
 };
 
 ConstantBuffer<RenderResources> renderResources : register(b0);
 
-VertexOutput VsMain(uint vertexID : SV_VertexID)
+VertexOutput VsMain(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
 {
     VertexOutput output;
 
@@ -32,12 +43,16 @@ VertexOutput VsMain(uint vertexID : SV_VertexID)
     StructuredBuffer<float3> normalBuffer = ResourceDescriptorHeap[renderResources.normalBufferIndex];
 
     ConstantBuffer<SceneData> sceneBuffer = ResourceDescriptorHeap[renderResources.sceneBufferIndex];
-    ConstantBuffer<TransformData> transformBuffer = ResourceDescriptorHeap[renderResources.transformBufferIndex];
+    StructuredBuffer<InstanceData> instanceBuffer = ResourceDescriptorHeap[renderResources.instanceBufferIndex];
+
+    // SV_InstanceID does not include the start instance location, so the offset of this draw's instances is passed in explicitly.
+    const InstanceData instance = instanceBuffer[renderResources.instanceOffset + instanceID];
 
-    output.position = mul(float4(positionBuffer[vertexID], 1.0f), mul(transformBuffer.modelMatrix, sceneBuffer.viewProjectionMatrix));
+    output.position = mul(float4(positionBuffer[vertexID], 1.0f), mul(instance.modelMatrix, sceneBuffer.viewProjectionMatrix));
     output.textureCoord = textureCoordBuffer[vertexID];
-    output.normal = mul(normalBuffer[vertexID], (float3x3)transpose(transformBuffer.inverseModelViewMatrix));
-    output.viewSpacePosition = mul(float4(positionBuffer[vertexID], 1.0f), mul(transformBuffer.modelMatrix, sceneBuffer.viewMatrix)).xyz;
+    // The view matrix is rigid, so it is its own inverse-transpose and can be applied to the world space normal directly.
+    output.normal = mul(mul(normalBuffer[vertexID], (float3x3)instance.normalMatrix), (float3x3)sceneBuffer.viewMatrix);
+    output.viewSpacePosition = mul(float4(positionBuffer[vertexID], 1.0f), mul(instance.modelMatrix, sceneBuffer.viewMatrix)).xyz;
 
     return output;
 }
@@ -64,6 +79,7 @@ float4 PsMain(VertexOutput input) : SV_Target
     const float diffuseStrength = max(dot(pixelToLightDirection, normal), 0.0f);
     const float3 diffuseColor = diffuseStrength * sceneBuffer.lightColor;
 
+#if PHONG_SPECULAR
     // Calculate the specular lighting (shiny - bright spot that occurs on shiny objects when we are looking near
     // the perfect reflection direction).
     const float specularStrength = 0.5f;
@@ -72,13 +88,20 @@ float4 PsMain(VertexOutput input) : SV_Target
 
     const float specularIntensity = pow(max(dot(perfectReflectionDirection, viewDirection), 0.0f), 32);
     const float3 specularColor = specularIntensity * sceneBuffer.lightColor * specularStrength;
-    
+#else
+    const float3 specularColor = float3(0.0f, 0.0f, 0.0f);
+#endif
+
+#if PHONG_DIRECTIONAL_LIGHT
     // Calculate directional light effect (only diffuse for now).
     const float3 directionalLightDirection = normalize(-sceneBuffer.viewSpaceDirectionalLightPosition);
 
     // Calculate the diffuse lighting (the directional impact the light has on the pixel).
     const float directionalDiffuseStrength = max(dot(directionalLightDirection, normal), 0.0f);
     const float3 directionalDiffuseColor = directionalDiffuseStrength * sceneBuffer.directionalLightColor;
+#else
+    const float3 directionalDiffuseColor = float3(0.0f, 0.0f, 0.0f);
+#endif
 
     const float3 color = (ambientColor + diffuseColor + directionalDiffuseColor  + specularColor) * albedoColor;
 
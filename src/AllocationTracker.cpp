@@ -0,0 +1,192 @@
+#include "Pch.hpp"
+
+#include "AllocationTracker.hpp"
+
+namespace nether::AllocationTracker
+{
+    // Everything here is constant initialized, as operator new can run before (or after) any dynamic initialization.
+    struct SubsystemCounters
+    {
+        std::atomic<uint64_t> allocationCount{};
+        std::atomic<uint64_t> allocatedBytes{};
+        std::atomic<uint64_t> violationCount{};
+    };
+
+    std::array<SubsystemCounters, MAX_SUBSYSTEM_COUNT> subsystemCounters{};
+
+    // Names are written under the mutex before the count is published.
+    std::mutex subsystemRegistryMutex{};
+    std::array<const char*, MAX_SUBSYSTEM_COUNT> subsystemNames{"Untracked"};
+    std::atomic<uint32_t> subsystemCount{1u};
+
+    std::atomic<bool> isInSteadyState{false};
+
+    thread_local uint32_t currentSubsystemIndex{UNTRACKED_SUBSYSTEM_INDEX};
+
+    // Totals at the previous collectFrame.
+    std::array<SubsystemAllocations, MAX_SUBSYSTEM_COUNT> previousTotals{};
+
+    void recordAllocation(const size_t size)
+    {
+        const uint32_t subsystemIndex = currentSubsystemIndex;
+        SubsystemCounters& counters = subsystemCounters[subsystemIndex];
+
+        counters.allocationCount.fetch_add(1u, std::memory_order_relaxed);
+        counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (subsystemIndex != UNTRACKED_SUBSYSTEM_INDEX && isInSteadyState.load(std::memory_order_relaxed))
+        {
+            counters.violationCount.fetch_add(1u, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t FrameAllocations::getAllocationCount() const
+    {
+        return std::accumulate(subsystems.begin(),
+                               subsystems.begin() + subsystemCount,
+                               uint64_t{0u},
+                               [](const uint64_t count, const SubsystemAllocations& subsystem) { return count + subsystem.allocationCount; });
+    }
+
+    uint64_t FrameAllocations::getViolationCount() const
+    {
+        return std::accumulate(subsystems.begin(),
+                               subsystems.begin() + subsystemCount,
+                               uint64_t{0u},
+                               [](const uint64_t count, const SubsystemAllocations& subsystem) { return count + subsystem.violationCount; });
+    }
+
+    uint32_t getSubsystemIndex(const std::string_view name)
+    {
+        const std::scoped_lock lock(subsystemRegistryMutex);
+
+        const uint32_t count = subsystemCount.load(std::memory_order_relaxed);
+        for (const uint32_t i : std::views::iota(0u, count))
+        {
+            if (subsystemNames[i] == name)
+            {
+                return i;
+            }
+        }
+
+        if (count == MAX_SUBSYSTEM_COUNT)
+        {
+            fatalError(std::format("Too many allocation tracking subsystems, {} can not be registered.", name));
+        }
+
+        // The macro only passes string literals, which are null terminated.
+        subsystemNames[count] = name.data();
+        subsystemCount.store(count + 1u, std::memory_order_release);
+
+        return count;
+    }
+
+    SubsystemScope::SubsystemScope(const uint32_t subsystemIndex) : m_previousSubsystemIndex(currentSubsystemIndex) { currentSubsystemIndex = subsystemIndex; }
+
+    SubsystemScope::~SubsystemScope() { currentSubsystemIndex = m_previousSubsystemIndex; }
+
+    void setSteadyState(const bool isEnabled) { isInSteadyState.store(isEnabled, std::memory_order_relaxed); }
+
+    bool isSteadyState() { return isInSteadyState.load(std::memory_order_relaxed); }
+
+    void collectFrame(FrameAllocations& frameAllocations)
+    {
+        frameAllocations.subsystemCount = subsystemCount.load(std::memory_order_acquire);
+
+        for (const uint32_t i : std::views::iota(0u, frameAllocations.subsystemCount))
+        {
+            const SubsystemAllocations totals = {
+                .name = subsystemNames[i],
+                .allocationCount = subsystemCounters[i].allocationCount.load(std::memory_order_relaxed),
+                .allocatedBytes = subsystemCounters[i].allocatedBytes.load(std::memory_order_relaxed),
+                .violationCount = subsystemCounters[i].violationCount.load(std::memory_order_relaxed),
+            };
+
+            frameAllocations.subsystems[i] = SubsystemAllocations{
+                .name = totals.name,
+                .allocationCount = totals.allocationCount - previousTotals[i].allocationCount,
+                .allocatedBytes = totals.allocatedBytes - previousTotals[i].allocatedBytes,
+                .violationCount = totals.violationCount - previousTotals[i].violationCount,
+            };
+
+            previousTotals[i] = totals;
+        }
+    }
+
+    uint64_t getTotalAllocationCount()
+    {
+        uint64_t allocationCount{};
+        for (const SubsystemCounters& counters : subsystemCounters)
+        {
+            allocationCount += counters.allocationCount.load(std::memory_order_relaxed);
+        }
+
+        return allocationCount;
+    }
+}
+
+#ifdef NETHER_ALLOCATION_TRACKING
+// Every form is replaced (rather than relying on the default array, nothrow and sized forms forwarding to the basic ones), so allocation and deallocation always match.
+static void* allocateTracked(const size_t size) noexcept
+{
+    nether::AllocationTracker::recordAllocation(size);
+    return std::malloc(size == 0u ? 1u : size);
+}
+
+static void* allocateTracked(const size_t size, const std::align_val_t alignment) noexcept
+{
+    nether::AllocationTracker::recordAllocation(size);
+
+    const size_t alignmentInBytes = static_cast<size_t>(alignment);
+    const size_t alignedSize = std::max((size + alignmentInBytes - 1u) & ~(alignmentInBytes - 1u), alignmentInBytes);
+
+#ifdef _WIN32
+    return _aligned_malloc(alignedSize, alignmentInBytes);
+#else
+    return std::aligned_alloc(alignmentInBytes, alignedSize);
+#endif
+}
+
+static void freeAligned(void* const pointer) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+static void* throwIfNull(void* const pointer)
+{
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+void* operator new(const size_t size) { return throwIfNull(allocateTracked(size)); }
+void* operator new[](const size_t size) { return throwIfNull(allocateTracked(size)); }
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return allocateTracked(size); }
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept { return allocateTracked(size); }
+
+void* operator new(const size_t size, const std::align_val_t alignment) { return throwIfNull(allocateTracked(size, alignment)); }
+void* operator new[](const size_t size, const std::align_val_t alignment) { return throwIfNull(allocateTracked(size, alignment)); }
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateTracked(size, alignment); }
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateTracked(size, alignment); }
+
+void operator delete(void* const pointer) noexcept { std::free(pointer); }
+void operator delete[](void* const pointer) noexcept { std::free(pointer); }
+void operator delete(void* const pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* const pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* const pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* const pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+void operator delete(void* const pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* const pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* const pointer, size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* const pointer, size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* const pointer, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(pointer); }
+void operator delete[](void* const pointer, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(pointer); }
+#endif
@@ -0,0 +1,236 @@
+#include "Pch.hpp"
+
+#include "AssetArchive.hpp"
+#include "AssetRegistry.hpp"
+#include "Lz4.hpp"
+
+namespace nether
+{
+    // Compressed entries are only kept if they save at least 1 / MIN_COMPRESSION_RATIO of the size, as uncompressed entries are read without a copy.
+    static constexpr uint64_t MIN_COMPRESSION_RATIO = 8u;
+
+    static uint64_t hashAssetPath(const std::string_view assetPath) { return hashBytes(std::as_bytes(std::span(assetPath))); }
+
+    // Maps the hash to [0, bucketCount) with its top bits, so entries sorted by hash are sorted by bucket as well.
+    static uint32_t getBucketIndex(const uint64_t pathHash, const uint32_t bucketCount) { return static_cast<uint32_t>(((pathHash >> 32u) * bucketCount) >> 32u); }
+
+    static bool isInRange(const uint64_t offset, const uint64_t size, const uint64_t rangeSize) { return offset <= rangeSize && size <= rangeSize - offset; }
+
+    AssetArchive::AssetArchive(const std::string_view archivePath) : m_file(archivePath)
+    {
+        const std::span<const std::byte> data = m_file.getData();
+
+        const auto checkArchive = [&](const bool condition)
+        {
+            if (!condition)
+            {
+                fatalError(std::format("Malformed asset archive : {}", archivePath));
+            }
+        };
+
+        checkArchive(data.size() >= sizeof(AssetArchiveHeader));
+
+        // The mapping is page aligned, and the writer aligns the tables to 8 bytes.
+        const AssetArchiveHeader& header = *reinterpret_cast<const AssetArchiveHeader*>(data.data());
+        checkArchive(header.magic == AssetArchiveHeader::MAGIC && header.version == AssetArchiveHeader::VERSION && header.bucketCount != 0u);
+
+        const uint64_t bucketTableSize = (uint64_t{header.bucketCount} + 1u) * sizeof(uint32_t);
+        const uint64_t directorySize = uint64_t{header.entryCount} * sizeof(AssetArchiveEntry);
+
+        checkArchive(isInRange(header.bucketTableOffset, bucketTableSize, data.size()) && header.bucketTableOffset % alignof(uint32_t) == 0u);
+        checkArchive(isInRange(header.directoryOffset, directorySize, data.size()) && header.directoryOffset % alignof(AssetArchiveEntry) == 0u);
+        checkArchive(isInRange(header.pathTableOffset, header.pathTableSize, data.size()));
+
+        m_bucketTable = std::span(reinterpret_cast<const uint32_t*>(data.data() + header.bucketTableOffset), header.bucketCount + 1u);
+        m_entries = std::span(reinterpret_cast<const AssetArchiveEntry*>(data.data() + header.directoryOffset), header.entryCount);
+        m_pathTable = std::string_view(reinterpret_cast<const char*>(data.data() + header.pathTableOffset), header.pathTableSize);
+
+        checkArchive(m_bucketTable.front() == 0u && m_bucketTable.back() == header.entryCount && std::ranges::is_sorted(m_bucketTable));
+
+        for (const uint32_t bucketIndex : std::views::iota(0u, header.bucketCount))
+        {
+            for (const uint32_t entryIndex : std::views::iota(m_bucketTable[bucketIndex], m_bucketTable[bucketIndex + 1u]))
+            {
+                const AssetArchiveEntry& entry = m_entries[entryIndex];
+
+                checkArchive(getBucketIndex(entry.pathHash, header.bucketCount) == bucketIndex);
+                checkArchive(isInRange(entry.pathOffset, entry.pathSize, m_pathTable.size()) && hashAssetPath(getPath(entry)) == entry.pathHash);
+                checkArchive(isInRange(entry.dataOffset, entry.storedSize, data.size()));
+                // LZ4 blocks can not expand by more than 255 times (a length byte of 255 per 255 bytes of a match), which bounds what read allocates.
+                checkArchive((entry.compression == AssetCompression::None && entry.storedSize == entry.size) ||
+                             (entry.compression == AssetCompression::Lz4 && entry.size / 255u <= entry.storedSize));
+            }
+        }
+    }
+
+    AssetArchive::AssetArchive(AssetArchive&& other) noexcept
+        : m_file(std::move(other.m_file)), m_bucketTable(std::exchange(other.m_bucketTable, {})), m_entries(std::exchange(other.m_entries, {})),
+          m_pathTable(std::exchange(other.m_pathTable, {}))
+    {
+    }
+
+    AssetArchive& AssetArchive::operator=(AssetArchive&& other) noexcept
+    {
+        if (this != &other)
+        {
+            m_file = std::move(other.m_file);
+            m_bucketTable = std::exchange(other.m_bucketTable, {});
+            m_entries = std::exchange(other.m_entries, {});
+            m_pathTable = std::exchange(other.m_pathTable, {});
+        }
+
+        return *this;
+    }
+
+    const AssetArchiveEntry* AssetArchive::find(const std::string_view assetPath) const
+    {
+        if (m_entries.empty())
+        {
+            return nullptr;
+        }
+
+        const std::string canonicalPath = getCanonicalAssetPath(assetPath);
+        const uint64_t pathHash = hashAssetPath(canonicalPath);
+
+        const uint32_t bucketIndex = getBucketIndex(pathHash, static_cast<uint32_t>(m_bucketTable.size() - 1u));
+        for (const uint32_t entryIndex : std::views::iota(m_bucketTable[bucketIndex], m_bucketTable[bucketIndex + 1u]))
+        {
+            const AssetArchiveEntry& entry = m_entries[entryIndex];
+            if (entry.pathHash == pathHash && getPath(entry) == canonicalPath)
+            {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void AssetArchive::prefetch(const AssetArchiveEntry& entry) const { m_file.prefetch(getStoredData(entry)); }
+
+    std::span<const std::byte> AssetArchive::read(const AssetArchiveEntry& entry, std::vector<std::byte>& buffer) const
+    {
+        if (entry.compression == AssetCompression::None)
+        {
+            return getStoredData(entry);
+        }
+
+        buffer.resize(entry.size);
+        Lz4::decompress(getStoredData(entry), buffer);
+
+        return buffer;
+    }
+
+    void writeAssetArchive(const std::string_view archivePath, const std::span<const std::string> filePaths, const bool compress)
+    {
+        std::vector<std::pair<uint64_t, std::string>> assetPaths{};
+        for (const std::string& filePath : filePaths)
+        {
+            std::string assetPath = getCanonicalAssetPath(filePath);
+            assetPaths.emplace_back(hashAssetPath(assetPath), std::move(assetPath));
+        }
+
+        // Sorted by hash, and then by path so the archive (path table included) does not depend on the order of filePaths.
+        std::ranges::sort(assetPaths);
+
+        const auto duplicate = std::ranges::adjacent_find(assetPaths);
+        if (duplicate != assetPaths.end())
+        {
+            fatalError(std::format("Asset {} is packed more than once.", duplicate->second));
+        }
+
+        std::vector<AssetArchiveEntry> entries{};
+        std::string pathTable{};
+
+        for (const auto& [pathHash, assetPath] : assetPaths)
+        {
+            entries.push_back(AssetArchiveEntry{
+                .pathHash = pathHash,
+                .pathOffset = static_cast<uint32_t>(pathTable.size()),
+                .pathSize = static_cast<uint32_t>(assetPath.size()),
+            });
+
+            pathTable += assetPath;
+        }
+
+        const auto getEntryPath = [&](const AssetArchiveEntry& entry) { return std::string_view(pathTable).substr(entry.pathOffset, entry.pathSize); };
+
+        std::ofstream archive(std::string(archivePath), std::ios::binary | std::ios::trunc);
+        if (!archive.is_open())
+        {
+            fatalError(std::format("Failed to create asset archive with path : {}", archivePath));
+        }
+
+        uint64_t offset{};
+        const auto write = [&](const void* const data, const uint64_t size)
+        {
+            archive.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            offset += size;
+        };
+
+        const auto alignTo = [&](const uint64_t alignment)
+        {
+            static constexpr std::array<char, AssetArchive::PAYLOAD_ALIGNMENT> zeros{};
+            write(zeros.data(), (alignment - offset % alignment) % alignment);
+        };
+
+        // Written again once the offsets of the tables are known.
+        AssetArchiveHeader header{
+            .entryCount = static_cast<uint32_t>(entries.size()),
+            .bucketCount = std::max(static_cast<uint32_t>(entries.size()), 1u),
+        };
+
+        write(&header, sizeof(AssetArchiveHeader));
+
+        for (AssetArchiveEntry& entry : entries)
+        {
+            const std::vector<char> file = readFile(std::string(getEntryPath(entry)));
+            const std::span<const std::byte> fileData = std::as_bytes(std::span(file));
+
+            std::vector<std::byte> compressedData{};
+            if (compress)
+            {
+                compressedData = Lz4::compress(fileData);
+            }
+
+            const bool isCompressed = compress && compressedData.size() + fileData.size() / MIN_COMPRESSION_RATIO <= fileData.size() && !fileData.empty();
+            const std::span<const std::byte> storedData = isCompressed ? std::span<const std::byte>(compressedData) : fileData;
+
+            alignTo(AssetArchive::PAYLOAD_ALIGNMENT);
+
+            entry.dataOffset = offset;
+            entry.storedSize = storedData.size();
+            entry.size = fileData.size();
+            entry.compression = isCompressed ? AssetCompression::Lz4 : AssetCompression::None;
+
+            write(storedData.data(), storedData.size());
+        }
+
+        std::vector<uint32_t> bucketTable(header.bucketCount + 1u);
+        for (const AssetArchiveEntry& entry : entries)
+        {
+            bucketTable[getBucketIndex(entry.pathHash, header.bucketCount) + 1u]++;
+        }
+
+        std::inclusive_scan(bucketTable.begin(), bucketTable.end(), bucketTable.begin());
+
+        alignTo(alignof(AssetArchiveEntry));
+        header.bucketTableOffset = offset;
+        write(bucketTable.data(), bucketTable.size() * sizeof(uint32_t));
+
+        alignTo(alignof(AssetArchiveEntry));
+        header.directoryOffset = offset;
+        write(entries.data(), entries.size() * sizeof(AssetArchiveEntry));
+
+        header.pathTableOffset = offset;
+        header.pathTableSize = pathTable.size();
+        write(pathTable.data(), pathTable.size());
+
+        archive.seekp(0);
+        archive.write(reinterpret_cast<const char*>(&header), sizeof(AssetArchiveHeader));
+
+        if (!archive.good())
+        {
+            fatalError(std::format("Failed to write asset archive with path : {}", archivePath));
+        }
+    }
+}
@@ -0,0 +1,297 @@
+#include "Pch.hpp"
+
+#include "AssetLoader.hpp"
+#include "AssetArchive.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#include <tiny_gltf.h>
+
+namespace nether
+{
+    // Start of the first element of a accessor, and the distance between elements in bytes.
+    static std::pair<const uint8_t*, size_t> getAccessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor)
+    {
+        const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+        const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
+
+        return {buffer.data.data() + bufferView.byteOffset + accessor.byteOffset, static_cast<size_t>(accessor.ByteStride(bufferView))};
+    }
+
+    static const tinygltf::Accessor& getAttributeAccessor(const tinygltf::Model& model, const tinygltf::Primitive& primitive, const std::string& attributeName)
+    {
+        const auto attribute = primitive.attributes.find(attributeName);
+        if (attribute == primitive.attributes.end())
+        {
+            fatalError(std::format("Mesh primitive has no {} attribute.", attributeName));
+        }
+
+        return model.accessors[attribute->second];
+    }
+
+    math::XMFLOAT4 computeBoundingSphere(const std::span<const math::XMFLOAT3> positions)
+    {
+        if (positions.empty())
+        {
+            return math::XMFLOAT4{};
+        }
+
+        math::XMVECTOR minPosition = math::XMLoadFloat3(&positions[0u]);
+        math::XMVECTOR maxPosition = minPosition;
+        for (const math::XMFLOAT3& position : positions)
+        {
+            minPosition = math::XMVectorMin(minPosition, math::XMLoadFloat3(&position));
+            maxPosition = math::XMVectorMax(maxPosition, math::XMLoadFloat3(&position));
+        }
+
+        const math::XMVECTOR center = (minPosition + maxPosition) * 0.5f;
+
+        math::XMVECTOR radiusSquared = math::XMVectorZero();
+        for (const math::XMFLOAT3& position : positions)
+        {
+            radiusSquared = math::XMVectorMax(radiusSquared, math::XMVector3LengthSq(math::XMLoadFloat3(&position) - center));
+        }
+
+        math::XMFLOAT4 boundingSphere{};
+        math::XMStoreFloat4(&boundingSphere, math::XMVectorSetW(center, math::XMVectorGetX(math::XMVectorSqrt(radiusSquared))));
+
+        return boundingSphere;
+    }
+
+    // Only fatal when the load failed, warnings of a successful load are ignored.
+    static void checkGltfLoad(const bool isLoaded, const std::string& error, const std::string& warning)
+    {
+        if (!isLoaded)
+        {
+            if (!error.empty())
+            {
+                fatalError(error);
+            }
+
+            if (!warning.empty())
+            {
+                fatalError(warning);
+            }
+        }
+    }
+
+    void loadGltfModel(const std::string_view modelPath, tinygltf::Model& model)
+    {
+        // Use tinygltf loader to load the model.
+        std::string warning{};
+        std::string error{};
+
+        tinygltf::TinyGLTF context{};
+
+        if (std::filesystem::path(modelPath).extension() == ".glb")
+        {
+            checkGltfLoad(context.LoadBinaryFromFile(&model, &error, &warning, std::string(modelPath)), error, warning);
+        }
+        else
+        {
+            checkGltfLoad(context.LoadASCIIFromFile(&model, &error, &warning, std::string(modelPath)), error, warning);
+        }
+    }
+
+    void parseGltfModel(const std::span<const std::byte> gltfFile, const std::string_view baseDirectory, tinygltf::Model& model, const AssetArchive* const assetArchive)
+    {
+        std::string warning{};
+        std::string error{};
+
+        tinygltf::TinyGLTF context{};
+
+        // Files that are not in the archive go through the default (file system) callbacks.
+        if (assetArchive)
+        {
+            tinygltf::FsCallbacks fsCallbacks{};
+            fsCallbacks.FileExists = [assetArchive](const std::string& filePath, void* userData)
+            { return assetArchive->find(filePath) != nullptr || tinygltf::FileExists(filePath, userData); };
+            fsCallbacks.ExpandFilePath = tinygltf::ExpandFilePath;
+            fsCallbacks.ReadWholeFile = [assetArchive](std::vector<unsigned char>* const contents, std::string* const fileError, const std::string& filePath, void* userData)
+            {
+                const AssetArchiveEntry* const entry = assetArchive->find(filePath);
+                if (!entry)
+                {
+                    return tinygltf::ReadWholeFile(contents, fileError, filePath, userData);
+                }
+
+                std::vector<std::byte> decompressedData{};
+                const std::span<const std::byte> data = assetArchive->read(*entry, decompressedData);
+
+                const auto bytes = reinterpret_cast<const unsigned char*>(data.data());
+                contents->assign(bytes, bytes + data.size());
+
+                return true;
+            };
+            fsCallbacks.WriteWholeFile = tinygltf::WriteWholeFile;
+            fsCallbacks.GetFileSizeInBytes = [assetArchive](size_t* const fileSize, std::string* const fileError, const std::string& filePath, void* userData)
+            {
+                const AssetArchiveEntry* const entry = assetArchive->find(filePath);
+                if (!entry)
+                {
+                    return tinygltf::GetFileSizeInBytes(fileSize, fileError, filePath, userData);
+                }
+
+                *fileSize = static_cast<size_t>(entry->size);
+                return true;
+            };
+
+            context.SetFsCallbacks(fsCallbacks);
+        }
+
+        const bool isLoaded = context.LoadASCIIFromString(
+            &model, &error, &warning, reinterpret_cast<const char*>(gltfFile.data()), static_cast<uint32_t>(gltfFile.size()), std::string(baseDirectory));
+        checkGltfLoad(isLoaded, error, warning);
+    }
+
+    MeshData decodeMeshData(const tinygltf::Model& model)
+    {
+        const tinygltf::Node& node = model.nodes[0u];
+        const tinygltf::Mesh& nodeMesh = model.meshes[std::max<int32_t>(0u, node.mesh)];
+
+        MeshData meshData{};
+
+        for (const tinygltf::Primitive& primitive : nodeMesh.primitives)
+        {
+            // Reference used :
+            // https://github.com/mateeeeeee/Adria-DX12/blob/fc98468095bf5688a186ca84d94990ccd2f459b0/Adria/Rendering/EntityLoader.cpp.
+
+            // Get Accessors, buffer view and buffer for each attribute (position, textureCoord, normal).
+            const tinygltf::Accessor& positionAccessor = getAttributeAccessor(model, primitive, "POSITION");
+            const tinygltf::Accessor& textureCoordAccessor = getAttributeAccessor(model, primitive, "TEXCOORD_0");
+            const tinygltf::Accessor& normalAccessor = getAttributeAccessor(model, primitive, "NORMAL");
+
+            const auto [positions, positionByteStride] = getAccessorData(model, positionAccessor);
+            const auto [textureCoords, textureCoordByteStride] = getAccessorData(model, textureCoordAccessor);
+            const auto [normals, normalByteStride] = getAccessorData(model, normalAccessor);
+
+            // Indices of the primitive start at its first vertex.
+            const uint32_t baseVertex = static_cast<uint32_t>(meshData.positions.size());
+
+            meshData.positions.reserve(meshData.positions.size() + positionAccessor.count);
+            meshData.textureCoords.reserve(meshData.textureCoords.size() + positionAccessor.count);
+            meshData.normals.reserve(meshData.normals.size() + positionAccessor.count);
+
+            // Fill in the vertices's array.
+            for (const size_t i : std::views::iota(0u, positionAccessor.count))
+            {
+                const float* const position = reinterpret_cast<const float*>(positions + i * positionByteStride);
+                const float* const textureCoord = reinterpret_cast<const float*>(textureCoords + i * textureCoordByteStride);
+                const float* const normal = reinterpret_cast<const float*>(normals + i * normalByteStride);
+
+                meshData.positions.emplace_back(position[0], position[1], position[2]);
+                meshData.textureCoords.emplace_back(textureCoord[0], textureCoord[1]);
+                meshData.normals.emplace_back(normal[0], normal[1], normal[2]);
+            }
+
+            // Fill indices array.
+            const tinygltf::Accessor& indexAccessor = model.accessors[primitive.indices];
+            const auto [indices, indexByteStride] = getAccessorData(model, indexAccessor);
+
+            meshData.indices.reserve(meshData.indices.size() + indexAccessor.count);
+
+            for (const size_t i : std::views::iota(0u, indexAccessor.count))
+            {
+                if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+                {
+                    meshData.indices.push_back(baseVertex + static_cast<uint32_t>(*reinterpret_cast<const uint16_t*>(indices + i * indexByteStride)));
+                }
+                else if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
+                {
+                    meshData.indices.push_back(baseVertex + *reinterpret_cast<const uint32_t*>(indices + i * indexByteStride));
+                }
+            }
+        }
+
+        meshData.boundingSphere = computeBoundingSphere(meshData.positions);
+
+        return meshData;
+    }
+
+    MeshData makeCubeMeshData()
+    {
+        // Normal of each face, and the two axes spanning it. u x v = -normal, so the corners below are clockwise when seen from outside the cube.
+        struct Face
+        {
+            math::XMFLOAT3 normal{};
+            math::XMFLOAT3 u{};
+            math::XMFLOAT3 v{};
+        };
+
+        constexpr std::array<Face, 6u> faces = {
+            Face{{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+            Face{{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+            Face{{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+            Face{{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+            Face{{0.0f, 0.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+            Face{{0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        };
+
+        // Bottom left, top left, top right and bottom right, as (u, v) coordinates.
+        constexpr std::array<std::pair<float, float>, 4u> corners = {{{-1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, -1.0f}}};
+
+        MeshData meshData{};
+        for (const Face& face : faces)
+        {
+            const uint32_t firstVertex = static_cast<uint32_t>(meshData.positions.size());
+
+            for (const auto [u, v] : corners)
+            {
+                meshData.positions.emplace_back(face.normal.x + u * face.u.x + v * face.v.x,
+                                                face.normal.y + u * face.u.y + v * face.v.y,
+                                                face.normal.z + u * face.u.z + v * face.v.z);
+                meshData.textureCoords.emplace_back((u + 1.0f) * 0.5f, (1.0f - v) * 0.5f);
+                meshData.normals.push_back(face.normal);
+            }
+
+            for (const uint32_t index : {0u, 1u, 2u, 0u, 2u, 3u})
+            {
+                meshData.indices.push_back(firstVertex + index);
+            }
+        }
+
+        meshData.boundingSphere = computeBoundingSphere(meshData.positions);
+
+        return meshData;
+    }
+
+    // Takes ownership of the pixels returned by stb_image.
+    static ImageData makeImageData(stbi_uc* const pixels, const int32_t width, const int32_t height, const std::string_view imageName)
+    {
+        if (!pixels)
+        {
+            fatalError(std::format("Failed to load image {} : {}", imageName, stbi_failure_reason()));
+        }
+
+        ImageData imageData{
+            .width = static_cast<uint32_t>(width),
+            .height = static_cast<uint32_t>(height),
+        };
+
+        imageData.pixels.assign(pixels, pixels + static_cast<size_t>(width) * static_cast<size_t>(height) * 4u);
+        stbi_image_free(pixels);
+
+        return imageData;
+    }
+
+    ImageData loadImage(const std::string_view imagePath)
+    {
+        int32_t width{};
+        int32_t height{};
+
+        stbi_uc* const pixels = stbi_load(std::string(imagePath).c_str(), &width, &height, nullptr, 4);
+        return makeImageData(pixels, width, height, imagePath);
+    }
+
+    ImageData decodeImage(const std::span<const std::byte> encodedImage)
+    {
+        int32_t width{};
+        int32_t height{};
+
+        stbi_uc* const pixels =
+            stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(encodedImage.data()), static_cast<int32_t>(encodedImage.size()), &width, &height, nullptr, 4);
+        return makeImageData(pixels, width, height, "from memory");
+    }
+}
@@ -0,0 +1,197 @@
+#include "Pch.hpp"
+
+#include "AssetPipeline.hpp"
+#include "GltfImporter.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    AssetPipeline::AssetPipeline(JobSystem& jobSystem, const AssetPipelineDesc& desc)
+        : m_jobSystem(jobSystem), m_maxInFlightCount(std::max(desc.maxInFlightCount, 1u)), m_assetArchive(desc.assetArchive)
+    {
+    }
+
+    AssetPipeline::~AssetPipeline()
+    {
+        // Loads that finish meanwhile do not start the dropped requests.
+        {
+            const std::scoped_lock lock(m_mutex);
+            m_requests.clear();
+        }
+
+        m_jobSystem.wait(m_loadCounter);
+    }
+
+    void AssetPipeline::request(AssetLoadRequest request)
+    {
+        m_pendingCount.fetch_add(1u, std::memory_order_relaxed);
+
+        {
+            const std::scoped_lock lock(m_mutex);
+            m_requests.push_back(std::move(request));
+        }
+
+        startLoads(false);
+    }
+
+    size_t AssetPipeline::takeDecodedAssets(std::vector<DecodedAsset>& decodedAssets, const size_t maxCount)
+    {
+        startLoads(true);
+
+        size_t count{};
+        {
+            const std::scoped_lock lock(m_mutex);
+
+            count = std::min(maxCount, m_decodedAssets.size());
+            for ([[maybe_unused]] const size_t i : std::views::iota(size_t{0u}, count))
+            {
+                decodedAssets.push_back(std::move(m_decodedAssets.front()));
+                m_decodedAssets.pop_front();
+            }
+
+            m_inFlightCount -= static_cast<uint32_t>(count);
+        }
+
+        if (count != 0u)
+        {
+            m_pendingCount.fetch_sub(static_cast<uint32_t>(count), std::memory_order_release);
+
+            // The room made by the upload stage goes to the next requests.
+            startLoads(false);
+        }
+
+        return count;
+    }
+
+    size_t AssetPipeline::waitForDecodedAssets(std::vector<DecodedAsset>& decodedAssets, const size_t maxCount)
+    {
+        startLoads(true);
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_decodedAssetAdded.wait(lock, [&]() { return !m_decodedAssets.empty() || getPendingCount() == 0u; });
+        }
+
+        return takeDecodedAssets(decodedAssets, maxCount);
+    }
+
+    void AssetPipeline::startLoads(const bool runInline)
+    {
+        const bool hasWorkers = m_jobSystem.getWorkerThreadCount() != 0u;
+        if (!hasWorkers && !runInline)
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+        while (!m_requests.empty() && m_inFlightCount < m_maxInFlightCount)
+        {
+            AssetLoadRequest request = std::move(m_requests.front());
+            m_requests.pop_front();
+
+            m_inFlightCount++;
+
+            if (hasWorkers)
+            {
+                m_jobSystem.schedule([this, request = std::move(request)]() mutable { load(request); }, &m_loadCounter);
+                continue;
+            }
+
+            lock.unlock();
+            load(request);
+            lock.lock();
+        }
+    }
+
+    // Keeps the exception being handled for the upload stage, and logs it : the asset's renderables keep their placeholder, so the log is the only sign of the failure.
+    static void recordLoadFailure(DecodedAsset& decodedAsset, const std::string_view stage)
+    {
+        decodedAsset.loadException = std::current_exception();
+
+        std::string reason = "unknown error";
+        try
+        {
+            std::rethrow_exception(decodedAsset.loadException);
+        }
+        catch (const std::exception& exception)
+        {
+            reason = exception.what();
+        }
+        catch (...)
+        {
+        }
+
+        std::cerr << std::format("[Warning] : Failed to {} asset {} : {}\n", stage, decodedAsset.request.path, reason);
+    }
+
+    void AssetPipeline::load(AssetLoadRequest& request)
+    {
+        NETHER_PROFILE_SCOPE("AssetPipeline::load");
+
+        DecodedAsset decodedAsset{
+            .request = std::move(request),
+        };
+
+        // Failures are reported through the decoded asset, so the load can be failed on the upload stage's side.
+        AssetFile assetFile{};
+        try
+        {
+            NETHER_PROFILE_SCOPE("AssetPipeline::map");
+
+            assetFile.archiveEntry = m_assetArchive ? m_assetArchive->find(decodedAsset.request.path) : nullptr;
+            if (assetFile.archiveEntry)
+            {
+                m_assetArchive->prefetch(*assetFile.archiveEntry);
+            }
+            else
+            {
+                assetFile.mappedFile = MappedFile(decodedAsset.request.path);
+                assetFile.mappedFile.prefetch();
+            }
+        }
+        catch (...)
+        {
+            recordLoadFailure(decodedAsset, "read");
+        }
+
+        if (!decodedAsset.loadException)
+        {
+            try
+            {
+                NETHER_PROFILE_SCOPE("AssetPipeline::decode");
+
+                // Compressed archive entries are decompressed here, on the decode stage.
+                std::vector<std::byte> decompressedData{};
+                const std::span<const std::byte> fileData =
+                    assetFile.archiveEntry ? m_assetArchive->read(*assetFile.archiveEntry, decompressedData) : assetFile.mappedFile.getData();
+
+                if (decodedAsset.request.type == AssetType::Mesh)
+                {
+                    // Buffers referenced by the .gltf file are mapped here, relative to its directory, and only live until the mesh is decoded.
+                    GltfModel model{};
+                    importGltf(fileData, std::filesystem::path(decodedAsset.request.path).parent_path().generic_string(), model, m_assetArchive);
+
+                    decodedAsset.meshData = decodeMeshData(model);
+                }
+                else
+                {
+                    decodedAsset.imageData = decodeImage(fileData);
+                }
+            }
+            catch (...)
+            {
+                recordLoadFailure(decodedAsset, "decode");
+            }
+        }
+
+        // Unmapped right away, rather than once the upload stage gets to the asset.
+        assetFile.mappedFile = MappedFile{};
+
+        {
+            const std::scoped_lock lock(m_mutex);
+            m_decodedAssets.push_back(std::move(decodedAsset));
+        }
+
+        m_decodedAssetAdded.notify_all();
+    }
+}
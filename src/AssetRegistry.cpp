@@ -0,0 +1,41 @@
+#include "Pch.hpp"
+
+#include "AssetRegistry.hpp"
+
+namespace nether
+{
+    // True if normalizing would not change the path : forward slashes only, and no empty, "." or ".." components.
+    static bool isCanonicalAssetPath(const std::string_view assetPath)
+    {
+        if (assetPath.empty() || assetPath.find('\\') != std::string_view::npos)
+        {
+            return false;
+        }
+
+        for (const auto component : std::views::split(assetPath, '/'))
+        {
+            const std::string_view name(component.begin(), component.end());
+            if (name.empty() || name == "." || name == "..")
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string getCanonicalAssetPath(const std::string_view assetPath)
+    {
+        // Paths written in code and asset files usually are canonical already, which saves going through std::filesystem on every lookup.
+        if (isCanonicalAssetPath(assetPath))
+        {
+            return std::string(assetPath);
+        }
+
+        // Backslashes are only separators on Windows, so they are replaced before the path is parsed.
+        std::string path(assetPath);
+        std::ranges::replace(path, '\\', '/');
+
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+}
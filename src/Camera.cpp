@@ -55,6 +55,23 @@ void nether::Camera::update(const float deltaTime)
     math::XMStoreFloat4(&m_cameraPosition, cameraPosition);
 }
 
+nether::CameraState nether::Camera::getState() const
+{
+    return CameraState{
+        .position = math::XMFLOAT3(m_cameraPosition.x, m_cameraPosition.y, m_cameraPosition.z),
+        .pitch = m_pitch,
+        .yaw = m_yaw,
+    };
+}
+
+// The camera basis vectors are derived from the pitch and yaw by getLookAtMatrix, so they do not need to be set here.
+void nether::Camera::setState(const CameraState& state)
+{
+    m_cameraPosition = math::XMFLOAT4(state.position.x, state.position.y, state.position.z, 1.0f);
+    m_pitch = state.pitch;
+    m_yaw = state.yaw;
+}
+
 math::XMMATRIX nether::Camera::getLookAtMatrix()
 {
     // Load all XMFLOATX into XMVECTOR's.
@@ -0,0 +1,68 @@
+#include "Pch.hpp"
+
+#include "CameraPath.hpp"
+
+namespace nether
+{
+    CameraPath CameraPath::createOrbit(const uint32_t frameCount, const float radius, const float height)
+    {
+        CameraPath cameraPath{};
+        cameraPath.m_frames.reserve(frameCount);
+
+        for (const uint32_t frame : std::views::iota(0u, frameCount))
+        {
+            const float angle = math::XM_2PI * static_cast<float>(frame) / static_cast<float>(frameCount);
+            const math::XMFLOAT3 position(radius * std::cos(angle), height, radius * std::sin(angle));
+
+            // The camera looks along +z rotated by the pitch (around x) and then the yaw (around y), so the angles that point it at the origin are :
+            // forward = (cos(pitch) * sin(yaw), -sin(pitch), cos(pitch) * cos(yaw)) = -position / |position|.
+            cameraPath.m_frames.push_back(CameraState{
+                .position = position,
+                .pitch = std::atan2(position.y, std::sqrt(position.x * position.x + position.z * position.z)),
+                .yaw = std::atan2(-position.x, -position.z),
+            });
+        }
+
+        return cameraPath;
+    }
+
+    CameraPath CameraPath::load(const std::filesystem::path& filePath)
+    {
+        std::ifstream file(filePath);
+        if (!file.is_open())
+        {
+            fatalError(std::format("Failed to open camera path {}.", filePath.string()));
+        }
+
+        CameraPath cameraPath{};
+
+        CameraState cameraState{};
+        while (file >> cameraState.position.x >> cameraState.position.y >> cameraState.position.z >> cameraState.pitch >> cameraState.yaw)
+        {
+            cameraPath.m_frames.push_back(cameraState);
+        }
+
+        if (!file.eof() || cameraPath.m_frames.empty())
+        {
+            fatalError(std::format("Camera path {} is malformed or empty.", filePath.string()));
+        }
+
+        return cameraPath;
+    }
+
+    void CameraPath::save(const std::filesystem::path& filePath) const
+    {
+        std::ofstream file(filePath);
+        if (!file.is_open())
+        {
+            fatalError(std::format("Failed to create camera path {}.", filePath.string()));
+        }
+
+        // Enough digits that the floats round trip exactly, so a replay renders exactly the recorded views.
+        file.precision(std::numeric_limits<float>::max_digits10);
+        for (const CameraState& cameraState : m_frames)
+        {
+            file << cameraState.position.x << ' ' << cameraState.position.y << ' ' << cameraState.position.z << ' ' << cameraState.pitch << ' ' << cameraState.yaw << '\n';
+        }
+    }
+}
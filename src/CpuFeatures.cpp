@@ -0,0 +1,40 @@
+#include "Pch.hpp"
+
+#include "CpuFeatures.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace nether::CpuFeatures
+{
+    static bool detectAvx2()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        std::array<int, 4u> cpuInfo{};
+
+        __cpuid(cpuInfo.data(), 0);
+        if (cpuInfo[0] < 7)
+        {
+            return false;
+        }
+
+        // CPUID.1:ECX.OSXSAVE[bit 27] and AVX[bit 28], then XCR0 must have both the SSE and AVX state enabled by the OS.
+        __cpuid(cpuInfo.data(), 1);
+        const bool isAvxSupported = (cpuInfo[2] & (1 << 27)) && (cpuInfo[2] & (1 << 28)) && (_xgetbv(0) & 0x6u) == 0x6u;
+
+        // CPUID.(EAX=7, ECX=0):EBX.AVX2[bit 5].
+        __cpuidex(cpuInfo.data(), 7, 0);
+        return isAvxSupported && (cpuInfo[1] & (1 << 5));
+#else
+        // Also checks OS support (XCR0).
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool isAvx2Supported()
+    {
+        static const bool isSupported = detectAvx2();
+        return isSupported;
+    }
+}
@@ -0,0 +1,25 @@
+#include "Pch.hpp"
+
+#include "D3D12CommandRecorder.hpp"
+
+namespace nether
+{
+    void D3D12CommandRecorder::reset(ID3D12GraphicsCommandList2* const commandList, ID3D12CommandSignature* const drawIndirectCommandSignature, ID3D12Resource* const indirectCommandBuffer)
+    {
+        m_commandList = commandList;
+        m_drawIndirectCommandSignature = drawIndirectCommandSignature;
+        m_indirectCommandBuffer = indirectCommandBuffer;
+    }
+
+    void D3D12CommandRecorder::setGraphicsPipeline(const GraphicsPipeline& graphicsPipeline) { m_commandList->SetPipelineState(graphicsPipeline.pipelineState.Get()); }
+
+    void D3D12CommandRecorder::drawIndirect(const uint32_t firstRecord, const uint32_t recordCount)
+    {
+        m_commandList->ExecuteIndirect(m_drawIndirectCommandSignature,
+                                       recordCount,
+                                       m_indirectCommandBuffer,
+                                       static_cast<uint64_t>(firstRecord) * INDIRECT_DRAW_LAYOUT.byteStride,
+                                       nullptr,
+                                       0u);
+    }
+}
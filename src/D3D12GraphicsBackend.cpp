@@ -0,0 +1,1428 @@
+#include "Pch.hpp"
+
+#include "D3D12GraphicsBackend.hpp"
+
+#include "Profiler.hpp"
+
+#include <imgui.h>
+#include <imgui_impl_dx12.h>
+
+// Setup the Agility SDK parameters.
+extern "C"
+{
+    __declspec(dllexport) extern const UINT D3D12SDKVersion = 602u;
+}
+extern "C"
+{
+    __declspec(dllexport) extern const char* D3D12SDKPath = ".\\D3D12\\";
+}
+
+namespace nether
+{
+    // Rejects shaders whose root constants do not match the C++ struct they are filled from, and returns the number of 32 bit values the shaders read.
+    static uint32_t validatePipelineRootConstants(const RootConstantLayout& rootConstantLayout, const std::span<const Shader* const> shaders, const std::wstring_view pipelineName)
+    {
+        // Embedded shaders are stripped of reflection data. Their layouts were validated by the development builds that compile the same sources.
+        if constexpr (NETHER_SHIPPING_MODE)
+        {
+            return rootConstantLayout.sizeInBytes / sizeof(uint32_t);
+        }
+
+        uint32_t rootConstantCount{};
+
+        for (const Shader* const shader : shaders)
+        {
+            const std::string errorMessage = validateRootConstants(rootConstantLayout, shader->rootConstants);
+            if (!errorMessage.empty())
+            {
+                fatalError(std::format("Root constants of pipeline {} do not match the C++ layout :\n{}", wStringToString(pipelineName), errorMessage));
+            }
+
+            rootConstantCount = std::max(rootConstantCount, getRootConstantCount(shader->rootConstants));
+        }
+
+        return rootConstantCount;
+    }
+
+    static D3D12_RESOURCE_STATES getD3D12ResourceState(const ResourceState state)
+    {
+        constexpr std::array<std::pair<ResourceState, D3D12_RESOURCE_STATES>, 9u> stateMapping = {{
+            {ResourceState::RenderTarget, D3D12_RESOURCE_STATE_RENDER_TARGET},
+            {ResourceState::DepthWrite, D3D12_RESOURCE_STATE_DEPTH_WRITE},
+            {ResourceState::DepthRead, D3D12_RESOURCE_STATE_DEPTH_READ},
+            {ResourceState::ShaderResource, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE},
+            {ResourceState::UnorderedAccess, D3D12_RESOURCE_STATE_UNORDERED_ACCESS},
+            {ResourceState::CopySource, D3D12_RESOURCE_STATE_COPY_SOURCE},
+            {ResourceState::CopyDest, D3D12_RESOURCE_STATE_COPY_DEST},
+            {ResourceState::IndirectArgument, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT},
+            {ResourceState::Present, D3D12_RESOURCE_STATE_PRESENT},
+        }};
+
+        D3D12_RESOURCE_STATES d3d12State = D3D12_RESOURCE_STATE_COMMON;
+        for (const auto& [resourceState, d3d12ResourceState] : stateMapping)
+        {
+            if ((state & resourceState) == resourceState)
+            {
+                d3d12State |= d3d12ResourceState;
+            }
+        }
+
+        return d3d12State;
+    }
+
+    D3D12GraphicsBackend::D3D12GraphicsBackend(const D3D12GraphicsBackendDesc& desc)
+        : m_windowDimensions(desc.windowDimensions), m_maxInstanceCount(desc.maxInstanceCount), m_maxUploadBatchTextureCount(desc.maxUploadBatchTextureCount)
+    {
+        // Initialize core DX12 objects.
+        initDevice();
+
+        // Create the RTV, DSV, Sampler, CBV_SRV_UAV descriptor heaps.
+        initDescriptorHeaps(desc.maxMeshCount, desc.maxTextureCount, desc.maxUploadBatchTextureCount);
+
+        // Create the command objects and synchronization primitives.
+        initCommandObjects(desc.maxChunkCount);
+        initSyncPrimitives();
+
+        // Create the swapchain and RTV's.
+        initSwapchain(desc.windowHandle);
+
+        // Setup the render graph, and create the transient resources (depth stencil texture) and their views.
+        initRenderGraph();
+
+        initImgui();
+
+        // Create the bindless root signature, shared by all pipelines, and the command signature used to draw with ExecuteIndirect.
+        initRootSignature();
+
+        // Create the scene buffer, instance buffer and indirect command buffer of every frame.
+        initFrameBuffers();
+
+        // Create the constant buffer slots of the mip generation dispatches.
+        initMipGenerationData(desc.maxUploadBatchTextureCount);
+    }
+
+    D3D12GraphicsBackend::~D3D12GraphicsBackend()
+    {
+        // The copy and compute queues might still be uploading a batch of assets, and generating its mips.
+        if (m_uploadBatch.fenceValue != 0u && m_copyFence->GetCompletedValue() < m_uploadBatch.fenceValue)
+        {
+            throwIfFailed(m_copyFence->SetEventOnCompletion(m_uploadBatch.fenceValue, nullptr));
+        }
+
+        if (m_uploadBatch.computeFenceValue != 0u && m_computeFence->GetCompletedValue() < m_uploadBatch.computeFenceValue)
+        {
+            throwIfFailed(m_computeFence->SetEventOnCompletion(m_uploadBatch.computeFenceValue, nullptr));
+        }
+
+        flushGPU();
+
+        ImGui_ImplDX12_Shutdown();
+    }
+
+    FrameBuffers D3D12GraphicsBackend::beginFrame()
+    {
+        FrameResources& frameResources = getCurrentFrameResources();
+
+        // Reset the command list and the command allocator to add new commands.
+        throwIfFailed(frameResources.commandAllocator->Reset());
+        throwIfFailed(frameResources.commandList->Reset(frameResources.commandAllocator.Get(), nullptr));
+
+        // Alias for the command list.
+        Comptr<ID3D12GraphicsCommandList2>& cmd = frameResources.commandList;
+
+        // All transitions come from the render graph.
+        const CompiledPass& forwardPass = m_renderGraph.getCompiledPasses()[m_renderGraph.getCompiledPassIndex(m_forwardPass)];
+        recordRenderGraphBarriers(cmd.Get(), m_renderGraph.getBarriersBefore(forwardPass));
+
+        // Setup render targets and depth stencil views.
+        const CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvDescriptorHeap.getCpuDescriptorHandleAtIndex(m_frameIndex));
+        const CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(m_dsvDescriptorHeap.cpuDescriptorHandleFromHeapStart);
+
+        constexpr std::array<float, 4> clearColor{0.1f, 0.1f, 0.1f, 1.0f};
+        cmd->ClearRenderTargetView(rtvHandle, clearColor.data(), 0u, nullptr);
+        cmd->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 1u, 0u, nullptr);
+
+        throwIfFailed(cmd->Close());
+
+        return FrameBuffers{
+            .sceneData = &frameResources.sceneBuffer.data,
+            .sceneBufferIndex = frameResources.sceneBuffer.cbvIndex,
+            .instances = std::span(frameResources.instanceBufferPointer, m_maxInstanceCount),
+            .instanceBufferIndex = frameResources.instanceBuffer.srvIndex,
+            .indirectDrawRecords = std::span(reinterpret_cast<IndirectDrawRecord*>(frameResources.indirectCommandBufferPointer), m_maxInstanceCount),
+        };
+    }
+
+    CommandRecorder& D3D12GraphicsBackend::beginChunk(const uint32_t chunkIndex)
+    {
+        FrameResources& frameResources = getCurrentFrameResources();
+        const Comptr<ID3D12GraphicsCommandList2>& chunkCmd = frameResources.chunkCommandLists[chunkIndex];
+
+        throwIfFailed(frameResources.chunkCommandAllocators[chunkIndex]->Reset());
+        throwIfFailed(chunkCmd->Reset(frameResources.chunkCommandAllocators[chunkIndex].Get(), nullptr));
+
+        // Command lists do not inherit state, so the descriptor heaps, root signature and render targets are set on every list.
+        const std::array<ID3D12DescriptorHeap*, 1u> shaderVisibleDescriptorHeaps{m_cbvSrvUavDescriptorHeap.descriptorHeap.Get()};
+        chunkCmd->SetDescriptorHeaps(static_cast<uint32_t>(shaderVisibleDescriptorHeaps.size()), shaderVisibleDescriptorHeaps.data());
+        chunkCmd->SetGraphicsRootSignature(m_bindlessRootSignature.Get());
+
+        const CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvDescriptorHeap.getCpuDescriptorHandleAtIndex(m_frameIndex));
+        const CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(m_dsvDescriptorHeap.cpuDescriptorHandleFromHeapStart);
+        chunkCmd->OMSetRenderTargets(1u, &rtvHandle, FALSE, &dsvHandle);
+
+        chunkCmd->RSSetViewports(1u, &m_viewport);
+        chunkCmd->RSSetScissorRects(1u, &m_scissorRect);
+
+        chunkCmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        m_commandRecorders[chunkIndex].reset(chunkCmd.Get(), m_drawIndirectCommandSignature.Get(), frameResources.indirectCommandBuffer.buffer.Get());
+        return m_commandRecorders[chunkIndex];
+    }
+
+    void D3D12GraphicsBackend::submitFrame(const uint32_t chunkCount)
+    {
+        FrameResources& frameResources = getCurrentFrameResources();
+
+        frameResources.sceneBuffer.update();
+
+        const CompiledPass& forwardPass = m_renderGraph.getCompiledPasses()[m_renderGraph.getCompiledPassIndex(m_forwardPass)];
+        const CompiledPass& uiPass = m_renderGraph.getCompiledPasses()[m_renderGraph.getCompiledPassIndex(m_uiPass)];
+
+        // The UI pass (and the transition back to the present state) go at the end of the last chunk.
+        const Comptr<ID3D12GraphicsCommandList2>& lastChunkCmd = frameResources.chunkCommandLists[chunkCount - 1u];
+
+        recordRenderGraphBarriers(lastChunkCmd.Get(), m_renderGraph.getBarriersAfter(forwardPass));
+        recordRenderGraphBarriers(lastChunkCmd.Get(), m_renderGraph.getBarriersBefore(uiPass));
+
+        if (const ImDrawData* const uiDrawData = std::exchange(m_uiDrawData, nullptr))
+        {
+            // ImGui's renderer does not modify the draw data, it just takes it by non const pointer.
+            ImGui_ImplDX12_RenderDrawData(const_cast<ImDrawData*>(uiDrawData), lastChunkCmd.Get());
+        }
+
+        recordRenderGraphBarriers(lastChunkCmd.Get(), m_renderGraph.getBarriersAfter(uiPass));
+
+        // Submit all lists in order with a single call.
+        m_submittedCommandLists.clear();
+        m_submittedCommandLists.push_back(frameResources.commandList.Get());
+
+        for (const uint32_t chunkIndex : std::views::iota(0u, chunkCount))
+        {
+            throwIfFailed(frameResources.chunkCommandLists[chunkIndex]->Close());
+            m_submittedCommandLists.push_back(frameResources.chunkCommandLists[chunkIndex].Get());
+        }
+
+        m_directCommandQueue->ExecuteCommandLists(static_cast<uint32_t>(m_submittedCommandLists.size()), m_submittedCommandLists.data());
+
+        {
+            NETHER_PROFILE_SCOPE("Present");
+            m_swapchain->Present(1u, 0u);
+        }
+
+        const uint64_t fenceValue = ++getCurrentFrameResources().fenceValue;
+
+        throwIfFailed(m_directCommandQueue->Signal(m_fence.Get(), fenceValue));
+
+        m_frameIndex = m_swapchain->GetCurrentBackBufferIndex();
+
+        if (m_fence->GetCompletedValue() < getCurrentFrameResources().fenceValue)
+        {
+            NETHER_PROFILE_SCOPE("Wait for GPU");
+
+            throwIfFailed(m_fence->SetEventOnCompletion(getCurrentFrameResources().fenceValue, m_fenceEvent));
+            ::WaitForSingleObject(m_fenceEvent, INFINITE);
+        }
+    }
+
+    void D3D12GraphicsBackend::flushGPU()
+    {
+        const uint64_t fenceValue = ++getCurrentFrameResources().fenceValue;
+        throwIfFailed(m_directCommandQueue->Signal(m_fence.Get(), fenceValue));
+
+        if (m_fence->GetCompletedValue() < fenceValue)
+        {
+            throwIfFailed(m_fence->SetEventOnCompletion(fenceValue, m_fenceEvent));
+            ::WaitForSingleObject(m_fenceEvent, INFINITE);
+        }
+    }
+
+    void D3D12GraphicsBackend::destroyStructuredBuffer(StructuredBuffer& structuredBuffer)
+    {
+        m_cbvSrvUavDescriptorHeap.release(structuredBuffer.srvIndex);
+        structuredBuffer = {};
+    }
+
+    void D3D12GraphicsBackend::destroyTexture(Texture& texture)
+    {
+        m_cbvSrvUavDescriptorHeap.release(texture.srvIndex);
+        texture = {};
+    }
+
+    void D3D12GraphicsBackend::initDevice()
+    {
+        // Enable the debug layer in debug builds.
+        if constexpr (NETHER_DEBUG_MODE)
+        {
+            Comptr<ID3D12Debug5> debugController{};
+            throwIfFailed(::D3D12GetDebugInterface(IID_PPV_ARGS(&debugController)));
+
+            debugController->EnableDebugLayer();
+
+            debugController->SetEnableAutoName(true);
+            debugController->SetEnableGPUBasedValidation(true);
+            debugController->SetEnableSynchronizedCommandQueueValidation(true);
+        }
+
+        // Create the DXGI factory for querying adapters and aid in creation of other DXGI objects.
+        // Set the DXGI_CREATE_FACTORY_DEBUG in debug mode.
+        constexpr uint32_t factoryCreationFlags = [=]()
+        {
+            if (NETHER_DEBUG_MODE)
+            {
+                return DXGI_CREATE_FACTORY_DEBUG;
+            }
+
+            return 0;
+        }();
+
+        throwIfFailed(::CreateDXGIFactory2(factoryCreationFlags, IID_PPV_ARGS(&m_factory)));
+
+        // Select the highest performance adapter and display its description (adapter represents the display subsystem,
+        // i.e GPU, video memory, etc).
+        throwIfFailed(m_factory->EnumAdapterByGpuPreference(0u, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&m_adapter)));
+
+        DXGI_ADAPTER_DESC1 adapterDesc{};
+        throwIfFailed(m_adapter->GetDesc1(&adapterDesc));
+        std::wcout << "Chosen adapter : " << adapterDesc.Description << L'\n';
+
+        // Create the device (i.e the logical GPU, used in creation of most d3d12 objects).
+        throwIfFailed(::D3D12CreateDevice(m_adapter.Get(), D3D_FEATURE_LEVEL_12_1, IID_PPV_ARGS(&m_device)));
+        setName(m_device.Get(), L"D3D12 Device");
+
+        // Setup the info queue in debug builds to place breakpoint on invalid API usage.
+        if constexpr (NETHER_DEBUG_MODE)
+        {
+            Comptr<ID3D12InfoQueue1> infoQueue{};
+            throwIfFailed(m_device.As(&infoQueue));
+
+            throwIfFailed(infoQueue->SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY_WARNING, true));
+            throwIfFailed(infoQueue->SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY_ERROR, true));
+            throwIfFailed(infoQueue->SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY_CORRUPTION, true));
+        }
+    }
+
+    void D3D12GraphicsBackend::initDescriptorHeaps(const uint32_t maxMeshCount, const uint32_t maxTextureCount, const uint32_t maxUploadBatchTextureCount)
+    {
+        // Create descriptor heaps (i.e contiguous allocations of descriptors. Descriptors describe some resource and
+        // specify extra information about it, how it is to be used, etc.
+        m_rtvDescriptorHeap.init(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, FRAME_COUNT, L"RTV Descriptor Heap");
+        m_dsvDescriptorHeap.init(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, 1u, L"DSV Descriptor Heap");
+
+        // Sized for the most assets that can be loaded at once and the mip generation of one upload batch, on top of the descriptors the backend itself keeps for its
+        // lifetime.
+        const uint32_t cbvSrvUavDescriptorCount = BACKEND_DESCRIPTOR_COUNT + maxUploadBatchTextureCount * MIP_GENERATION_DESCRIPTOR_COUNT_PER_TEXTURE +
+                                                  maxMeshCount * MESH_DESCRIPTOR_COUNT + maxTextureCount * TEXTURE_DESCRIPTOR_COUNT;
+
+        m_cbvSrvUavDescriptorHeap.init(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, cbvSrvUavDescriptorCount, L"CBV SRV UAV Descriptor Heap");
+    }
+
+    void D3D12GraphicsBackend::initCommandObjects(const uint32_t maxChunkCount)
+    {
+        // Create the direct command queues (i.e execution ports of the GPU).
+        const D3D12_COMMAND_QUEUE_DESC directCommandQueueDesc = {
+            .Type = D3D12_COMMAND_LIST_TYPE_DIRECT,
+            .Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL,
+            .Flags = D3D12_COMMAND_QUEUE_FLAG_NONE,
+            .NodeMask = 0u,
+        };
+
+        throwIfFailed(m_device->CreateCommandQueue(&directCommandQueueDesc, IID_PPV_ARGS(&m_directCommandQueue)));
+        setName(m_directCommandQueue.Get(), L"Direct command queue");
+
+        for (const uint32_t frameIndex : std::views::iota(0u, FRAME_COUNT))
+        {
+            // Create the command allocator (i.e the backing memory store for GPU commands recorded via command lists).
+            throwIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_frameResources[frameIndex].commandAllocator)));
+            setName(m_frameResources[frameIndex].commandAllocator.Get(), L"Direct command allocator", frameIndex);
+
+            // Create the command list. Used for recording GPU commands.
+            throwIfFailed(m_device->CreateCommandList(0u,
+                                                      D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                      m_frameResources[frameIndex].commandAllocator.Get(),
+                                                      nullptr,
+                                                      IID_PPV_ARGS(&m_frameResources[frameIndex].commandList)));
+            setName(m_frameResources[frameIndex].commandList.Get(), L"Direct command list", frameIndex);
+
+            throwIfFailed(m_frameResources[frameIndex].commandList->Close());
+
+            // Create the command allocators / lists used for recording chunks of draws (one per thread that can record).
+            for (const uint32_t chunkIndex : std::views::iota(0u, maxChunkCount))
+            {
+                Comptr<ID3D12CommandAllocator>& chunkCommandAllocator = m_frameResources[frameIndex].chunkCommandAllocators.emplace_back();
+                throwIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&chunkCommandAllocator)));
+                setName(chunkCommandAllocator.Get(), std::format(L"Chunk direct command allocator {}", chunkIndex), frameIndex);
+
+                Comptr<ID3D12GraphicsCommandList2>& chunkCommandList = m_frameResources[frameIndex].chunkCommandLists.emplace_back();
+                throwIfFailed(m_device->CreateCommandList(0u, D3D12_COMMAND_LIST_TYPE_DIRECT, chunkCommandAllocator.Get(), nullptr, IID_PPV_ARGS(&chunkCommandList)));
+                setName(chunkCommandList.Get(), std::format(L"Chunk direct command list {}", chunkIndex), frameIndex);
+
+                throwIfFailed(chunkCommandList->Close());
+            }
+        }
+
+        m_commandRecorders.resize(maxChunkCount);
+
+        // Create copy command objects.
+        const D3D12_COMMAND_QUEUE_DESC copyCommandQueueDesc = {
+            .Type = D3D12_COMMAND_LIST_TYPE_COPY,
+            .Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL,
+            .Flags = D3D12_COMMAND_QUEUE_FLAG_NONE,
+            .NodeMask = 0u,
+        };
+
+        throwIfFailed(m_device->CreateCommandQueue(&copyCommandQueueDesc, IID_PPV_ARGS(&m_copyCommandQueue)));
+        setName(m_copyCommandQueue.Get(), L"Copy command queue");
+
+        throwIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&m_copyCommandAllocator)));
+        setName(m_copyCommandAllocator.Get(), L"Copy command allocator");
+
+        // Create the command list. Used for recording GPU commands.
+        throwIfFailed(m_device->CreateCommandList(0u, D3D12_COMMAND_LIST_TYPE_COPY, m_copyCommandAllocator.Get(), nullptr, IID_PPV_ARGS(&m_copyCommandList)));
+
+        setName(m_copyCommandList.Get(), L"Copy command list");
+
+        throwIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&m_uploadBatch.commandAllocator)));
+        setName(m_uploadBatch.commandAllocator.Get(), L"Upload batch command allocator");
+
+        throwIfFailed(
+            m_device->CreateCommandList(0u, D3D12_COMMAND_LIST_TYPE_COPY, m_uploadBatch.commandAllocator.Get(), nullptr, IID_PPV_ARGS(&m_uploadBatch.commandList)));
+        setName(m_uploadBatch.commandList.Get(), L"Upload batch command list");
+
+        // Create compute command objects.
+        const D3D12_COMMAND_QUEUE_DESC computeCommandQueueDesc = {
+            .Type = D3D12_COMMAND_LIST_TYPE_COMPUTE,
+            .Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL,
+            .Flags = D3D12_COMMAND_QUEUE_FLAG_NONE,
+            .NodeMask = 0u,
+        };
+
+        throwIfFailed(m_device->CreateCommandQueue(&computeCommandQueueDesc, IID_PPV_ARGS(&m_computeCommandQueue)));
+        setName(m_computeCommandQueue.Get(), L"Compute command queue");
+
+        throwIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(&m_computeCommandAllocator)));
+        setName(m_computeCommandAllocator.Get(), L"Compute command allocator");
+
+        // Create the command list. Used for recording GPU commands.
+        throwIfFailed(m_device->CreateCommandList(0u, D3D12_COMMAND_LIST_TYPE_COMPUTE, m_computeCommandAllocator.Get(), nullptr, IID_PPV_ARGS(&m_computeCommandList)));
+
+        setName(m_computeCommandList.Get(), L"Compute command list");
+
+        throwIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(&m_uploadBatch.computeCommandAllocator)));
+        setName(m_uploadBatch.computeCommandAllocator.Get(), L"Upload batch compute command allocator");
+
+        throwIfFailed(m_device->CreateCommandList(0u,
+                                                  D3D12_COMMAND_LIST_TYPE_COMPUTE,
+                                                  m_uploadBatch.computeCommandAllocator.Get(),
+                                                  nullptr,
+                                                  IID_PPV_ARGS(&m_uploadBatch.computeCommandList)));
+        setName(m_uploadBatch.computeCommandList.Get(), L"Upload batch compute command list");
+    }
+
+    void D3D12GraphicsBackend::initSyncPrimitives()
+    {
+        // Create the synchronization primitives.
+        throwIfFailed(m_device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+
+        m_fenceEvent = ::CreateEvent(nullptr, false, false, nullptr);
+
+        throwIfFailed(m_device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_copyFence)));
+
+        throwIfFailed(m_device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_computeFence)));
+    }
+
+    void D3D12GraphicsBackend::initSwapchain(const HWND windowHandle)
+    {
+        // Setup viewport and scissor rect.
+        m_viewport = {
+            .TopLeftX = 0.0f,
+            .TopLeftY = 0.0f,
+            .Width = static_cast<float>(m_windowDimensions.x),
+            .Height = static_cast<float>(m_windowDimensions.y),
+            .MinDepth = 0.0f,
+            .MaxDepth = 1.0f,
+        };
+
+        m_scissorRect = {
+            .left = 0u,
+            .top = 0u,
+            .right = static_cast<long>(m_windowDimensions.x),
+            .bottom = static_cast<long>(m_windowDimensions.y),
+        };
+
+        // Create the swapchain (allocates backbuffers which we can render into and present to a window).
+        const DXGI_SWAP_CHAIN_DESC1 swapchainDesc = {
+            .Width = m_windowDimensions.x,
+            .Height = m_windowDimensions.y,
+            .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+            .Stereo = false,
+            .SampleDesc = {1u, 0u},
+            .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
+            .BufferCount = FRAME_COUNT,
+            .Scaling = DXGI_SCALING_STRETCH,
+            .SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD,
+            .AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED,
+            .Flags = 0u,
+        };
+
+        Comptr<IDXGISwapChain1> swapchain{};
+        throwIfFailed(m_factory->CreateSwapChainForHwnd(m_directCommandQueue.Get(), windowHandle, &swapchainDesc, nullptr, nullptr, &swapchain));
+        throwIfFailed(swapchain.As(&m_swapchain));
+
+        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_rtvDescriptorHeap.cpuDescriptorHandleFromHeapStart;
+
+        // Create the render target views for each swapchain backbuffer..
+        for (const uint32_t bufferIndex : std::views::iota(0u, FRAME_COUNT))
+        {
+            throwIfFailed(m_swapchain->GetBuffer(bufferIndex, IID_PPV_ARGS(&m_backBuffers[bufferIndex])));
+            setName(m_backBuffers[bufferIndex].Get(), L"Back buffer");
+
+            m_device->CreateRenderTargetView(m_backBuffers[bufferIndex].Get(), nullptr, rtvHandle);
+            m_rtvDescriptorHeap.offset(rtvHandle);
+        }
+    }
+
+    void D3D12GraphicsBackend::initRenderGraph()
+    {
+        // The depth stencil texture is a transient resource, so its memory comes from the render graph's transient heap.
+        const D3D12_RESOURCE_DESC depthStencilTextureResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0u,
+            .Width = m_windowDimensions.x,
+            .Height = m_windowDimensions.y,
+            .DepthOrArraySize = 1u,
+            .MipLevels = 1u,
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .SampleDesc = {1u, 0u},
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL,
+        };
+
+        const D3D12_RESOURCE_ALLOCATION_INFO depthStencilAllocationInfo = m_device->GetResourceAllocationInfo(0u, 1u, &depthStencilTextureResourceDesc);
+
+        // Setup the passes of the frame. The graph does not change from frame to frame, so it is compiled once.
+        m_backBufferResource = m_renderGraph.importResource("Back buffer", ResourceState::Present, ResourceState::Present);
+        m_depthStencilResource =
+            m_renderGraph.createTransientResource("Depth stencil texture", depthStencilAllocationInfo.SizeInBytes, depthStencilAllocationInfo.Alignment);
+
+        m_forwardPass = m_renderGraph.addPass("Forward");
+        m_renderGraph.write(m_forwardPass, m_backBufferResource, ResourceState::RenderTarget);
+        m_renderGraph.write(m_forwardPass, m_depthStencilResource, ResourceState::DepthWrite);
+
+        m_uiPass = m_renderGraph.addPass("UI");
+        m_renderGraph.write(m_uiPass, m_backBufferResource, ResourceState::RenderTarget);
+
+        m_renderGraph.compile();
+
+        // Create the transient heap, and place the transient resources at the offsets the render graph picked.
+        const D3D12_HEAP_DESC transientHeapDesc = {
+            .SizeInBytes = m_renderGraph.getTransientHeapSize(),
+            .Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+            .Alignment = 0u,
+            .Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        };
+
+        throwIfFailed(m_device->CreateHeap(&transientHeapDesc, IID_PPV_ARGS(&m_transientHeap)));
+        setName(m_transientHeap.Get(), L"Render graph transient heap");
+
+        const D3D12_CLEAR_VALUE depthStencilClearValue = {
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .DepthStencil =
+                {
+                    .Depth = 1.0f,
+                },
+        };
+
+        throwIfFailed(m_device->CreatePlacedResource(m_transientHeap.Get(),
+                                                     m_renderGraph.getTransientOffset(m_depthStencilResource),
+                                                     &depthStencilTextureResourceDesc,
+                                                     getD3D12ResourceState(m_renderGraph.getTransientInitialState(m_depthStencilResource)),
+                                                     &depthStencilClearValue,
+                                                     IID_PPV_ARGS(&m_depthStencilTexture)));
+        setName(m_depthStencilTexture.Get(), L"Depth stencil texture");
+
+        // Create the depth stencil texture view.
+        const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
+            .Flags = D3D12_DSV_FLAG_NONE,
+            .Texture2D{
+                .MipSlice = 0u,
+            },
+        };
+
+        const D3D12_CPU_DESCRIPTOR_HANDLE dsvDescriptorHandle = m_dsvDescriptorHeap.cpuDescriptorHandleFromHeapStart;
+
+        m_device->CreateDepthStencilView(m_depthStencilTexture.Get(), &dsvDesc, dsvDescriptorHandle);
+    }
+
+    ID3D12Resource* D3D12GraphicsBackend::getRenderGraphResource(const RenderGraphResource resource)
+    {
+        if (resource == m_backBufferResource)
+        {
+            return m_backBuffers[m_frameIndex].Get();
+        }
+
+        if (resource == m_depthStencilResource)
+        {
+            return m_depthStencilTexture.Get();
+        }
+
+        fatalError(std::format("Render graph resource {} has no D3D12 resource.", m_renderGraph.getName(resource)));
+        return nullptr;
+    }
+
+    void D3D12GraphicsBackend::recordRenderGraphBarriers(ID3D12GraphicsCommandList* const commandList, const std::span<const RenderGraphBarrier> barriers)
+    {
+        m_resourceBarriers.clear();
+
+        for (const RenderGraphBarrier& barrier : barriers)
+        {
+            switch (barrier.type)
+            {
+                case BarrierType::Transition:
+                {
+                    const D3D12_RESOURCE_STATES stateBefore = getD3D12ResourceState(barrier.stateBefore);
+                    const D3D12_RESOURCE_STATES stateAfter = getD3D12ResourceState(barrier.stateAfter);
+
+                    // Some graph states map to the same D3D12 state (e.g present and common).
+                    if (stateBefore == stateAfter)
+                    {
+                        break;
+                    }
+
+                    const D3D12_RESOURCE_BARRIER_FLAGS flags = barrier.split == BarrierSplit::Begin ? D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY
+                                                               : barrier.split == BarrierSplit::End ? D3D12_RESOURCE_BARRIER_FLAG_END_ONLY
+                                                                                                    : D3D12_RESOURCE_BARRIER_FLAG_NONE;
+
+                    m_resourceBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(
+                        getRenderGraphResource(barrier.resource), stateBefore, stateAfter, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, flags));
+                }
+                break;
+
+                case BarrierType::Aliasing:
+                {
+                    ID3D12Resource* const aliasedResource = barrier.aliasedResource.isValid() ? getRenderGraphResource(barrier.aliasedResource) : nullptr;
+                    m_resourceBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(aliasedResource, getRenderGraphResource(barrier.resource)));
+                }
+                break;
+
+                case BarrierType::UnorderedAccess:
+                {
+                    m_resourceBarriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(getRenderGraphResource(barrier.resource)));
+                }
+                break;
+            }
+        }
+
+        if (!m_resourceBarriers.empty())
+        {
+            commandList->ResourceBarrier(static_cast<uint32_t>(m_resourceBarriers.size()), m_resourceBarriers.data());
+        }
+    }
+
+    void D3D12GraphicsBackend::initImgui()
+    {
+        // The ImGui context and its platform backend are set up by the owner of the window. The font texture's SRV is kept for the lifetime of the backend.
+        const uint32_t fontDescriptorIndex = m_cbvSrvUavDescriptorHeap.allocate();
+        ImGui_ImplDX12_Init(m_device.Get(),
+                            FRAME_COUNT,
+                            DXGI_FORMAT_R8G8B8A8_UNORM,
+                            m_cbvSrvUavDescriptorHeap.descriptorHeap.Get(),
+                            m_cbvSrvUavDescriptorHeap.getCpuDescriptorHandleAtIndex(fontDescriptorIndex),
+                            m_cbvSrvUavDescriptorHeap.getGpuDescriptorHandleAtIndex(fontDescriptorIndex));
+
+        // Creates the font texture and the UI pipeline now, rather than in the first UI frame (which is built on the simulation thread, while the render thread uses the
+        // device).
+        ImGui_ImplDX12_NewFrame();
+    }
+
+    void D3D12GraphicsBackend::initRootSignature()
+    {
+        // Setup all static samplers (see shaders/StaticSampler.hlsli).
+        const std::array<CD3DX12_STATIC_SAMPLER_DESC, 5> staticSamplers = {
+            // pointClampSampler.
+            CD3DX12_STATIC_SAMPLER_DESC(0u,
+                                        D3D12_FILTER_MIN_MAG_POINT_MIP_LINEAR,
+                                        D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
+                                        D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
+                                        D3D12_TEXTURE_ADDRESS_MODE_CLAMP),
+
+            // pointWrapSampler.
+            CD3DX12_STATIC_SAMPLER_DESC(1u,
+                                        D3D12_FILTER_MIN_MAG_POINT_MIP_LINEAR,
+                                        D3D12_TEXTURE_ADDRESS_MODE_WRAP,
+                                        D3D12_TEXTURE_ADDRESS_MODE_WRAP,
+                                        D3D12_TEXTURE_ADDRESS_MODE_WRAP),
+
+            // linearClampSampler.
+            CD3DX12_STATIC_SAMPLER_DESC(2u, D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP),
+
+            // linearWrapSampler.
+            CD3DX12_STATIC_SAMPLER_DESC(3u,
+                                        D3D12_FILTER_MIN_MAG_POINT_MIP_LINEAR,
+                                        D3D12_TEXTURE_ADDRESS_MODE_WRAP,
+                                        D3D12_TEXTURE_ADDRESS_MODE_WRAP,
+                                        D3D12_TEXTURE_ADDRESS_MODE_WRAP),
+
+            // anisotropicSampler.
+            CD3DX12_STATIC_SAMPLER_DESC(4u, D3D12_FILTER_ANISOTROPIC, D3D12_TEXTURE_ADDRESS_MODE_WRAP, D3D12_TEXTURE_ADDRESS_MODE_WRAP, D3D12_TEXTURE_ADDRESS_MODE_WRAP),
+        };
+
+        // Setup the root signature. RS specifies what is the layout that resources are used in the shaders. As bindless is used, there is only one root signature for all
+        // pipelines.
+        const D3D12_ROOT_PARAMETER1 rootParameters = {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants =
+                {
+                    .ShaderRegister = 0u,
+                    .RegisterSpace = 0u,
+                    .Num32BitValues = 64,
+                },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL,
+        };
+
+        const D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignaureDesc = {
+            .Version = D3D_ROOT_SIGNATURE_VERSION_1_1,
+            .Desc_1_1 =
+                {
+                    .NumParameters = 1u,
+                    .pParameters = &rootParameters,
+                    .NumStaticSamplers = static_cast<uint32_t>(staticSamplers.size()),
+                    .pStaticSamplers = staticSamplers.data(),
+                    .Flags = D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED | D3D12_ROOT_SIGNATURE_FLAG_SAMPLER_HEAP_DIRECTLY_INDEXED,
+                },
+        };
+
+        Comptr<ID3DBlob> rootSignatureBlob{};
+        Comptr<ID3DBlob> errorBlob{};
+
+        // A serialized root signature is a single chunk of memory
+        throwIfFailed(::D3D12SerializeVersionedRootSignature(&rootSignaureDesc, &rootSignatureBlob, &errorBlob));
+        if (errorBlob)
+        {
+            const char* errorMessage = (const char*)errorBlob->GetBufferPointer();
+            fatalError(errorMessage);
+        }
+
+        throwIfFailed(m_device->CreateRootSignature(0u, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&m_bindlessRootSignature)));
+        setName(m_bindlessRootSignature.Get(), L"Bindless Root signature");
+
+        // Setup the command signature used to draw with ExecuteIndirect. Each record sets the root constants (RenderResources) and the index buffer, and then issues a indexed
+        // draw. Binding the index buffer per record lets every draw of a pipeline go through a single ExecuteIndirect, whatever its mesh.
+        const std::array<D3D12_INDIRECT_ARGUMENT_DESC, 3u> indirectArgumentDescs = {
+            D3D12_INDIRECT_ARGUMENT_DESC{
+                .Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT,
+                .Constant =
+                    {
+                        .RootParameterIndex = INDIRECT_DRAW_LAYOUT.rootParameterIndex,
+                        .DestOffsetIn32BitValues = INDIRECT_DRAW_LAYOUT.rootConstantOffset,
+                        .Num32BitValuesToSet = INDIRECT_DRAW_LAYOUT.rootConstantCount,
+                    },
+            },
+            D3D12_INDIRECT_ARGUMENT_DESC{
+                .Type = D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW,
+            },
+            D3D12_INDIRECT_ARGUMENT_DESC{
+                .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED,
+            },
+        };
+
+        static_assert(sizeof(IndexBufferView) == sizeof(D3D12_INDEX_BUFFER_VIEW));
+        static_assert(offsetof(IndexBufferView, sizeInBytes) == offsetof(D3D12_INDEX_BUFFER_VIEW, SizeInBytes));
+        static_assert(offsetof(IndexBufferView, format) == offsetof(D3D12_INDEX_BUFFER_VIEW, Format));
+
+        static_assert(sizeof(DrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS));
+        static_assert(offsetof(DrawIndexedArguments, startInstanceLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, StartInstanceLocation));
+
+        const D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc = {
+            .ByteStride = INDIRECT_DRAW_LAYOUT.byteStride,
+            .NumArgumentDescs = static_cast<uint32_t>(indirectArgumentDescs.size()),
+            .pArgumentDescs = indirectArgumentDescs.data(),
+            .NodeMask = 0u,
+        };
+
+        throwIfFailed(m_device->CreateCommandSignature(&commandSignatureDesc, m_bindlessRootSignature.Get(), IID_PPV_ARGS(&m_drawIndirectCommandSignature)));
+        setName(m_drawIndirectCommandSignature.Get(), L"Draw Indirect Command signature");
+    }
+
+    void D3D12GraphicsBackend::initFrameBuffers()
+    {
+        for (const uint32_t frameIndex : std::views::iota(0u, FRAME_COUNT))
+        {
+            m_frameResources[frameIndex].sceneBuffer = createConstantBuffer<SceneData>(L"Scene Buffer");
+
+            // As no data is passed in, these buffers are created in the upload heap. They are written to every frame, so they are kept mapped.
+            FrameResources& frameResources = m_frameResources[frameIndex];
+            frameResources.instanceBuffer = createStructuredBuffer(nullptr, m_maxInstanceCount, sizeof(InstanceData), L"Instance Buffer");
+
+            constexpr D3D12_RANGE readRange = {
+                .Begin = 0u,
+                .End = 0u,
+            };
+
+            throwIfFailed(frameResources.instanceBuffer.buffer->Map(0u, &readRange, reinterpret_cast<void**>(&frameResources.instanceBufferPointer)));
+
+            frameResources.indirectCommandBuffer = createStructuredBuffer(nullptr, m_maxInstanceCount, INDIRECT_DRAW_LAYOUT.byteStride, L"Indirect Command Buffer");
+            throwIfFailed(frameResources.indirectCommandBuffer.buffer->Map(0u, &readRange, reinterpret_cast<void**>(&frameResources.indirectCommandBufferPointer)));
+        }
+    }
+
+    void D3D12GraphicsBackend::initMipGenerationData(const uint32_t maxUploadBatchTextureCount)
+    {
+        // Enough slots for every dispatch of a batch, and at least for the dispatches of one texture created outside of a batch.
+        const uint32_t slotCount = std::max(maxUploadBatchTextureCount, 1u) * MAX_MIP_GENERATION_DISPATCH_COUNT_PER_TEXTURE;
+
+        // GenerateMipMapData is aligned to 256 bytes, as constant buffer views must be.
+        const D3D12_RESOURCE_DESC bufferResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0u,
+            .Width = uint64_t{slotCount} * sizeof(GenerateMipMapData),
+            .Height = 1u,
+            .DepthOrArraySize = 1u,
+            .MipLevels = 1u,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc = {1u, 0u},
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE,
+        };
+
+        m_mipGenerationData.buffer = createBuffer(bufferResourceDesc, nullptr, L"Mip Map Generation Constant Buffer");
+
+        constexpr D3D12_RANGE readRange = {
+            .Begin = 0u,
+            .End = 0u,
+        };
+
+        throwIfFailed(m_mipGenerationData.buffer->Map(0u, &readRange, reinterpret_cast<void**>(&m_mipGenerationData.bufferPointer)));
+
+        m_mipGenerationData.cbvIndices.resize(slotCount);
+        for (const uint32_t slot : std::views::iota(0u, slotCount))
+        {
+            const D3D12_CONSTANT_BUFFER_VIEW_DESC constantBufferViewDesc = {
+                .BufferLocation = m_mipGenerationData.buffer->GetGPUVirtualAddress() + uint64_t{slot} * sizeof(GenerateMipMapData),
+                .SizeInBytes = sizeof(GenerateMipMapData),
+            };
+
+            m_mipGenerationData.cbvIndices[slot] = m_cbvSrvUavDescriptorHeap.allocate();
+            m_device->CreateConstantBufferView(&constantBufferViewDesc, m_cbvSrvUavDescriptorHeap.getCpuDescriptorHandleAtIndex(m_mipGenerationData.cbvIndices[slot]));
+        }
+    }
+
+    void D3D12GraphicsBackend::beginUploadBatch()
+    {
+        if (m_uploadBatch.isRecording || m_uploadBatch.fenceValue != 0u)
+        {
+            fatalError("beginUploadBatch called while an upload batch is recorded or in flight.");
+        }
+
+        m_uploadBatch.isRecording = true;
+    }
+
+    void D3D12GraphicsBackend::submitUploadBatch()
+    {
+        if (!std::exchange(m_uploadBatch.isRecording, false))
+        {
+            fatalError("submitUploadBatch called without beginUploadBatch.");
+        }
+
+        throwIfFailed(m_uploadBatch.commandList->Close());
+        const std::array<ID3D12CommandList*, 1u> uploadCommandLists{m_uploadBatch.commandList.Get()};
+        m_copyCommandQueue->ExecuteCommandLists(1u, uploadCommandLists.data());
+
+        m_uploadBatch.fenceValue = ++m_copyFenceValue;
+        throwIfFailed(m_copyCommandQueue->Signal(m_copyFence.Get(), m_uploadBatch.fenceValue));
+
+        if (m_uploadBatch.mipMappedTextures.empty())
+        {
+            return;
+        }
+
+        // The mips of every texture of the batch are generated by one compute list, which the compute queue only runs once the copy queue uploaded the top levels.
+        // The queue waits for the copy, this thread does not.
+        m_uploadBatch.mipMapGenerationPipeline = getMipMapGenerationPipeline();
+        recordMipGeneration(
+            m_uploadBatch.computeCommandList.Get(), m_uploadBatch.mipMapGenerationPipeline, m_uploadBatch.mipMappedTextures, m_uploadBatch.mipGenerationUavIndices);
+
+        throwIfFailed(m_uploadBatch.computeCommandList->Close());
+        throwIfFailed(m_computeCommandQueue->Wait(m_copyFence.Get(), m_uploadBatch.fenceValue));
+
+        const std::array<ID3D12CommandList*, 1u> computeCommandLists{m_uploadBatch.computeCommandList.Get()};
+        m_computeCommandQueue->ExecuteCommandLists(1u, computeCommandLists.data());
+
+        m_uploadBatch.computeFenceValue = ++m_computeFenceValue;
+        throwIfFailed(m_computeCommandQueue->Signal(m_computeFence.Get(), m_uploadBatch.computeFenceValue));
+    }
+
+    bool D3D12GraphicsBackend::completeUploadBatch(const bool waitForGPU)
+    {
+        if (m_uploadBatch.fenceValue == 0u)
+        {
+            return true;
+        }
+
+        // The mips are generated after the copies, so a batch with mips is done once they are.
+        const bool hasMips = m_uploadBatch.computeFenceValue != 0u;
+        ID3D12Fence* const fence = hasMips ? m_computeFence.Get() : m_copyFence.Get();
+        const uint64_t fenceValue = hasMips ? m_uploadBatch.computeFenceValue : m_uploadBatch.fenceValue;
+
+        if (fence->GetCompletedValue() < fenceValue)
+        {
+            if (!waitForGPU)
+            {
+                return false;
+            }
+
+            throwIfFailed(fence->SetEventOnCompletion(fenceValue, nullptr));
+        }
+
+        if (hasMips)
+        {
+            for (const uint32_t uavIndex : m_uploadBatch.mipGenerationUavIndices)
+            {
+                m_cbvSrvUavDescriptorHeap.release(uavIndex);
+            }
+
+            m_uploadBatch.mipGenerationUavIndices.clear();
+            m_uploadBatch.mipMapGenerationPipeline = {};
+            m_uploadBatch.computeFenceValue = 0u;
+
+            throwIfFailed(m_uploadBatch.computeCommandAllocator->Reset());
+            throwIfFailed(m_uploadBatch.computeCommandList->Reset(m_uploadBatch.computeCommandAllocator.Get(), nullptr));
+        }
+
+        m_uploadBatch.mipMappedTextures.clear();
+        m_uploadBatch.uploadBuffers.clear();
+        m_uploadBatch.fenceValue = 0u;
+
+        throwIfFailed(m_uploadBatch.commandAllocator->Reset());
+        throwIfFailed(m_uploadBatch.commandList->Reset(m_uploadBatch.commandAllocator.Get(), nullptr));
+
+        return true;
+    }
+
+    ID3D12GraphicsCommandList2* D3D12GraphicsBackend::getCopyCommandList() const { return m_uploadBatch.isRecording ? m_uploadBatch.commandList.Get() : m_copyCommandList.Get(); }
+
+    void D3D12GraphicsBackend::submitCopyCommands(Comptr<ID3D12Resource> uploadBuffer)
+    {
+        if (m_uploadBatch.isRecording)
+        {
+            m_uploadBatch.uploadBuffers.push_back(std::move(uploadBuffer));
+            return;
+        }
+
+        executeCopyCommands();
+    }
+
+    void D3D12GraphicsBackend::executeCopyCommands()
+    {
+        throwIfFailed(m_copyCommandList->Close());
+        const std::array<ID3D12CommandList*, 1u> copyCommandLists{m_copyCommandList.Get()};
+        m_copyCommandQueue->ExecuteCommandLists(1u, copyCommandLists.data());
+
+        m_copyFenceValue++;
+
+        m_copyCommandQueue->Signal(m_copyFence.Get(), m_copyFenceValue);
+        if (m_copyFence->GetCompletedValue() < m_copyFenceValue)
+        {
+            throwIfFailed(m_copyFence->SetEventOnCompletion(m_copyFenceValue, nullptr));
+        }
+
+        throwIfFailed(m_copyCommandAllocator->Reset());
+        throwIfFailed(m_copyCommandList->Reset(m_copyCommandAllocator.Get(), nullptr));
+    };
+
+    void D3D12GraphicsBackend::executeComputeCommands()
+    {
+        throwIfFailed(m_computeCommandList->Close());
+        const std::array<ID3D12CommandList*, 1u> computeCommandLists{m_computeCommandList.Get()};
+        m_computeCommandQueue->ExecuteCommandLists(1u, computeCommandLists.data());
+
+        m_computeFenceValue++;
+
+        m_computeCommandQueue->Signal(m_computeFence.Get(), m_computeFenceValue);
+        if (m_computeFence->GetCompletedValue() < m_computeFenceValue)
+        {
+            throwIfFailed(m_computeFence->SetEventOnCompletion(m_computeFenceValue, nullptr));
+        }
+
+        throwIfFailed(m_computeCommandAllocator->Reset());
+        throwIfFailed(m_computeCommandList->Reset(m_computeCommandAllocator.Get(), nullptr));
+    };
+
+    Comptr<ID3D12Resource> D3D12GraphicsBackend::createBuffer(const D3D12_RESOURCE_DESC& bufferResourceDesc, const std::byte* data, const std::wstring_view bufferName)
+    {
+        Comptr<ID3D12Resource> buffer{};
+
+        if (!data)
+        {
+            // This buffer will have CPU / GPU access. Mostly used for constant buffers.
+            const CD3DX12_HEAP_PROPERTIES uploadHeapProperties(D3D12_HEAP_TYPE_UPLOAD);
+
+            throwIfFailed(
+                m_device
+                    ->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferResourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&buffer)));
+        }
+        else
+        {
+            // Create the buffer in GPU only memory, and create a additional upload buffer that will be in CPU / GPU
+            // accesible state. The data from this buffer will be copied into the GPU only buffer.
+            const CD3DX12_HEAP_PROPERTIES defaultHeapProperties(D3D12_HEAP_TYPE_DEFAULT);
+
+            throwIfFailed(
+                m_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferResourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&buffer)));
+
+            Comptr<ID3D12Resource> uploadBuffer{};
+            const CD3DX12_HEAP_PROPERTIES uploadHeapProperties(D3D12_HEAP_TYPE_UPLOAD);
+
+            throwIfFailed(m_device->CreateCommittedResource(&uploadHeapProperties,
+                                                            D3D12_HEAP_FLAG_NONE,
+                                                            &bufferResourceDesc,
+                                                            D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                            nullptr,
+                                                            IID_PPV_ARGS(&uploadBuffer)));
+            setName(uploadBuffer.Get(), bufferName.data() + std::wstring(L" upload buffer"));
+
+            // Copy data from data ptr passed in to the CPU / GPU accessible buffer.
+            uint8_t* bufferPointer{};
+
+            // Set null read range, as we don't intend on reading from this resource on the CPU.
+            const D3D12_RANGE readRange = {
+                .Begin = 0u,
+                .End = 0u,
+            };
+
+            const uint32_t bufferSize = static_cast<uint32_t>(bufferResourceDesc.Width * bufferResourceDesc.Height);
+
+            throwIfFailed(uploadBuffer->Map(0u, &readRange, reinterpret_cast<void**>(&bufferPointer)));
+            std::memcpy(bufferPointer, data, bufferSize);
+            uploadBuffer->Unmap(0u, nullptr);
+
+            getCopyCommandList()->CopyBufferRegion(buffer.Get(), 0u, uploadBuffer.Get(), 0u, bufferSize);
+
+            submitCopyCommands(std::move(uploadBuffer));
+        }
+
+        setName(buffer.Get(), bufferName);
+
+        return buffer;
+    }
+
+    Texture D3D12GraphicsBackend::createTexture(const std::string_view texturePath, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName)
+    {
+        return createTexture(loadImage(texturePath), format, generateMipMaps, textureName);
+    }
+
+    Texture D3D12GraphicsBackend::createTexture(const ImageData& image, const DXGI_FORMAT& format, const bool generateMipMaps, const std::wstring_view textureName)
+    {
+        Texture texture{};
+
+        const int32_t width = static_cast<int32_t>(image.width);
+        const int32_t height = static_cast<int32_t>(image.height);
+        const uint8_t* const data = image.pixels.data();
+
+        uint16_t mipLevels = 1u;
+        if (generateMipMaps)
+        {
+            mipLevels = static_cast<uint16_t>(std::floor(std::log2(std::max<int32_t>(width, height))));
+
+            if (mipLevels >= width)
+            {
+                mipLevels = static_cast<UINT16>(width - 1);
+            }
+
+            if (mipLevels >= height)
+            {
+                mipLevels = static_cast<UINT16>(height - 1);
+            }
+        }
+
+        // Create the resource desc for this texture.
+        const D3D12_RESOURCE_DESC textureResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0u,
+            .Width = static_cast<uint64_t>(width),
+            .Height = static_cast<uint32_t>(height),
+            .DepthOrArraySize = 1u,
+            .MipLevels = mipLevels,
+            .Format = format,
+            .SampleDesc = {1u, 0u},
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+        };
+
+        const CD3DX12_HEAP_PROPERTIES defaultHeapProperties(D3D12_HEAP_TYPE_DEFAULT);
+
+        throwIfFailed(m_device->CreateCommittedResource(&defaultHeapProperties,
+                                                        D3D12_HEAP_FLAG_NONE,
+                                                        &textureResourceDesc,
+                                                        D3D12_RESOURCE_STATE_COMMON,
+                                                        nullptr,
+                                                        IID_PPV_ARGS(&texture.texture)));
+
+        const UINT64 bufferSize = GetRequiredIntermediateSize(texture.texture.Get(), 0, 1);
+
+        // Create a GPU upload buffer for the texture.
+        Comptr<ID3D12Resource> uploadBuffer{};
+        const CD3DX12_HEAP_PROPERTIES uploadHeapProperties(D3D12_HEAP_TYPE_UPLOAD);
+        const CD3DX12_RESOURCE_DESC uploadBufferResourceDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize);
+
+        throwIfFailed(m_device->CreateCommittedResource(&uploadHeapProperties,
+                                                        D3D12_HEAP_FLAG_NONE,
+                                                        &uploadBufferResourceDesc,
+                                                        D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                        nullptr,
+                                                        IID_PPV_ARGS(&uploadBuffer)));
+
+        setName(uploadBuffer.Get(), textureName.data() + std::wstring(L" upload buffer"));
+
+        // Place the data on the upload buffer and copy it into the GPU only buffer using the UpdateSubresources() helper function.
+        const D3D12_SUBRESOURCE_DATA textureData = {
+            .pData = data,
+            .RowPitch = width * 4u,
+            .SlicePitch = width * height * 4u,
+        };
+
+        UpdateSubresources(getCopyCommandList(), texture.texture.Get(), uploadBuffer.Get(), 0u, 0u, 1u, &textureData);
+        submitCopyCommands(std::move(uploadBuffer));
+
+        // Transition to pixel shader resource format, as SRV requires texture to be in this format.
+        const CD3DX12_RESOURCE_BARRIER copyDestToPixelShaderResourceBarrier =
+            CD3DX12_RESOURCE_BARRIER::Transition(texture.texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+        // Create the shader resource view for the texture.
+        const D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc = {
+            .Format = format,
+            .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
+            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+            .Texture2D{
+                .MipLevels = 1u,
+            },
+        };
+
+        texture.srvIndex = m_cbvSrvUavDescriptorHeap.allocate();
+        texture.gpuDescriptorHandle = m_cbvSrvUavDescriptorHeap.getGpuDescriptorHandleAtIndex(texture.srvIndex);
+
+        m_device->CreateShaderResourceView(texture.texture.Get(), &shaderResourceViewDesc, m_cbvSrvUavDescriptorHeap.getCpuDescriptorHandleAtIndex(texture.srvIndex));
+
+        setName(texture.texture.Get(), textureName);
+
+        // Textures of an upload batch get their mips once the batch is uploaded (see submitUploadBatch).
+        if (generateMipMaps && m_uploadBatch.isRecording)
+        {
+            if (m_uploadBatch.mipMappedTextures.size() == m_maxUploadBatchTextureCount)
+            {
+                fatalError(std::format("More than {} textures with mips in an upload batch.", m_maxUploadBatchTextureCount));
+            }
+
+            m_uploadBatch.mipMappedTextures.push_back(texture);
+        }
+        else if (generateMipMaps)
+        {
+            generateMips(texture);
+        }
+
+        return texture;
+    }
+
+    IndexBuffer D3D12GraphicsBackend::createIndexBuffer(const std::byte* data, const uint32_t bufferSize, const std::wstring_view indexBufferName)
+    {
+        IndexBuffer indexBuffer{};
+
+        // Setup the resource desc for buffer creation.
+        const D3D12_RESOURCE_DESC indexBufferResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0u,
+            .Width = bufferSize,
+            .Height = 1u,
+            .DepthOrArraySize = 1u,
+            .MipLevels = 1u,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc = {1u, 0u},
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE,
+        };
+
+        indexBuffer.buffer = createBuffer(indexBufferResourceDesc, data, indexBufferName);
+
+        indexBuffer.indexBufferView = {
+            .BufferLocation = indexBuffer.buffer->GetGPUVirtualAddress(),
+            .SizeInBytes = bufferSize,
+            .Format = DXGI_FORMAT_R32_UINT,
+        };
+
+        return indexBuffer;
+    }
+
+    StructuredBuffer D3D12GraphicsBackend::createStructuredBuffer(const std::byte* data, const uint32_t numberOfComponents, const uint32_t stride, const std::wstring_view bufferName)
+    {
+        StructuredBuffer structuredBuffer{};
+
+        // Setup the resource desc for buffer creation.
+        const D3D12_RESOURCE_DESC structuredBufferResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0u,
+            .Width = numberOfComponents * stride,
+            .Height = 1u,
+            .DepthOrArraySize = 1u,
+            .MipLevels = 1u,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc = {1u, 0u},
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE,
+        };
+
+        structuredBuffer.buffer = createBuffer(structuredBufferResourceDesc, data, bufferName);
+
+        // Create the shader resource view.
+        const D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc = {
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+            .Buffer =
+                {
+                    .FirstElement = 0u,
+
+                    .NumElements = numberOfComponents,
+                    .StructureByteStride = stride,
+                },
+        };
+
+        structuredBuffer.srvIndex = m_cbvSrvUavDescriptorHeap.allocate();
+
+        const CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle = m_cbvSrvUavDescriptorHeap.getCpuDescriptorHandleAtIndex(structuredBuffer.srvIndex);
+        m_device->CreateShaderResourceView(structuredBuffer.buffer.Get(), &shaderResourceViewDesc, srvHandle);
+
+        return structuredBuffer;
+    }
+
+    GraphicsPipeline D3D12GraphicsBackend::createGraphicsPipeline(const Shader& vertexShader, const Shader& pixelShader, const std::wstring_view pipelineName)
+    {
+        // Graphics pipelines are drawn with ExecuteIndirect, whose records set RenderResources.
+        const std::array<const Shader*, 2u> shaders = {&vertexShader, &pixelShader};
+        const uint32_t rootConstantCount = validatePipelineRootConstants(RENDER_RESOURCES_LAYOUT, shaders, pipelineName);
+
+        const D3D12_SHADER_BYTECODE vertexShaderByteCode = {
+            .pShaderBytecode = vertexShader.shaderBlob->GetBufferPointer(),
+            .BytecodeLength = vertexShader.shaderBlob->GetBufferSize(),
+        };
+
+        const D3D12_SHADER_BYTECODE pixelShaderByteCode = {
+            .pShaderBytecode = pixelShader.shaderBlob->GetBufferPointer(),
+            .BytecodeLength = pixelShader.shaderBlob->GetBufferSize(),
+        };
+
+        // Setup graphics pipeline state.
+        CD3DX12_RASTERIZER_DESC defaultRasterizerDesc(D3D12_DEFAULT);
+        defaultRasterizerDesc.FrontCounterClockwise = false;
+
+        // Setup depth stencil state.
+        const D3D12_DEPTH_STENCIL_DESC depthStencilDesc = {
+            .DepthEnable = true,
+            .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
+            .DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL,
+            .StencilEnable = false,
+        };
+
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc = {
+            .pRootSignature = m_bindlessRootSignature.Get(),
+            .VS = vertexShaderByteCode,
+            .PS = pixelShaderByteCode,
+            .BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT),
+            .SampleMask = UINT_MAX,
+            .RasterizerState = defaultRasterizerDesc,
+            .DepthStencilState = depthStencilDesc,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+            .NumRenderTargets = 1u,
+            .RTVFormats = DXGI_FORMAT_R8G8B8A8_UNORM,
+            .DSVFormat = DXGI_FORMAT_D32_FLOAT,
+            .SampleDesc = {1u, 0u},
+            .NodeMask = 0u,
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE,
+        };
+
+        GraphicsPipeline graphicsPipeline = {
+            .rootConstantCount = rootConstantCount,
+        };
+
+        throwIfFailed(m_device->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipeline.pipelineState)));
+        setName(graphicsPipeline.pipelineState.Get(), std::wstring(pipelineName) + L" Pipeline State");
+
+        return graphicsPipeline;
+    }
+
+    void D3D12GraphicsBackend::setMipMapGenerationShader(const Shader& computeShader)
+    {
+        ComputePipeline mipMapGenerationPipeline{};
+
+        const std::array<const Shader*, 1u> shaders = {&computeShader};
+        mipMapGenerationPipeline.rootConstantCount = validatePipelineRootConstants(GENERATE_MIP_MAP_RENDER_RESOURCES_LAYOUT, shaders, L"Mip Map Generation");
+
+        const D3D12_SHADER_BYTECODE computeShaderByteCode = {
+            .pShaderBytecode = computeShader.shaderBlob->GetBufferPointer(),
+            .BytecodeLength = computeShader.shaderBlob->GetBufferSize(),
+        };
+
+        const D3D12_COMPUTE_PIPELINE_STATE_DESC computePipelineStateDesc = {
+            .pRootSignature = m_bindlessRootSignature.Get(),
+            .CS = computeShaderByteCode,
+        };
+
+        throwIfFailed(m_device->CreateComputePipelineState(&computePipelineStateDesc, IID_PPV_ARGS(&mipMapGenerationPipeline.pipelineState)));
+        setName(mipMapGenerationPipeline.pipelineState.Get(), L"Mip Map Generation Compute Pipeline State");
+
+        // Only swapped in once it is complete. Lists recorded with the previous pipeline hold their own reference to it.
+        const std::scoped_lock lock(m_mipMapGenerationPipelineMutex);
+        m_mipMapGenerationPipeline = std::move(mipMapGenerationPipeline);
+    }
+
+    ComputePipeline D3D12GraphicsBackend::getMipMapGenerationPipeline()
+    {
+        const std::scoped_lock lock(m_mipMapGenerationPipelineMutex);
+        return m_mipMapGenerationPipeline;
+    }
+
+    void D3D12GraphicsBackend::recordMipGeneration(ID3D12GraphicsCommandList2* const commandList,
+                                                   const ComputePipeline& pipeline,
+                                                   const std::span<const Texture> textures,
+                                                   std::vector<uint32_t>& uavIndices)
+    {
+        const std::array<ID3D12DescriptorHeap*, 1u> shaderVisibleDescriptorHeaps{m_cbvSrvUavDescriptorHeap.descriptorHeap.Get()};
+        commandList->SetDescriptorHeaps(1u, shaderVisibleDescriptorHeaps.data());
+        commandList->SetComputeRootSignature(m_bindlessRootSignature.Get());
+        commandList->SetPipelineState(pipeline.pipelineState.Get());
+
+        uint32_t slot{};
+        for (const Texture& texture : textures)
+        {
+            const D3D12_RESOURCE_DESC sourceResourceDesc = texture.texture->GetDesc();
+
+            // Start the mip generation process.
+            for (uint32_t srcMipLevel = 0; srcMipLevel + 1u < sourceResourceDesc.MipLevels;)
+            {
+                uint64_t sourceWidth = sourceResourceDesc.Width >> srcMipLevel;
+                uint64_t sourceHeight = sourceResourceDesc.Height >> srcMipLevel;
+
+                // Destination width and height is half of that of source width and height.
+                uint32_t destinationWidth = std::max<uint32_t>((uint32_t)sourceWidth >> 1u, 1u);
+                uint32_t destinationHeight = std::max<uint32_t>((uint32_t)sourceHeight >> 1u, 1u);
+
+                // Find the dimension type.
+                DimensionType dimensionType{};
+                if (sourceHeight % 2 == 0 && sourceWidth % 2 == 0)
+                {
+                    dimensionType = DimensionType::WidthHeightEven;
+                }
+                else if (sourceHeight % 2 != 0 && sourceWidth % 2 == 0)
+                {
+                    dimensionType = DimensionType::WidthEvenHeightOdd;
+                }
+                else if (sourceHeight % 2 == 0 && sourceWidth % 2 != 0)
+                {
+                    dimensionType = DimensionType::WidthOddHeightEven;
+                }
+                else
+                {
+                    dimensionType = DimensionType::WidthHeightOdd;
+                }
+
+                // At a single compute shader dispatch, we can generate atmost 4 mip maps.
+                // The code below checks for in this loop iteration, how many levels can we compute, so as to have subsequent mip level dimension
+                // be exactly half : exactly 50 % decrease in mip dimension.
+                // i.e number of times mip can be halved until we reach a mip level where one dimension is odd.
+                // If dimension is odd, texture needs to be sampled multiple times, which will be handled in a new dispatch.
+                DWORD mipCount{};
+                // Value of temp not required.
+                _BitScanForward64(&mipCount, (destinationWidth == 1u ? destinationHeight : destinationWidth) | (destinationHeight == 1u ? destinationWidth : destinationHeight));
+                mipCount = std::min<uint32_t>(4, mipCount + 1);
+                mipCount = (srcMipLevel + mipCount) >= sourceResourceDesc.MipLevels ? sourceResourceDesc.MipLevels - srcMipLevel - 1u : mipCount;
+
+                if (slot == m_mipGenerationData.cbvIndices.size())
+                {
+                    fatalError(std::format("Mip generation needs more than {} dispatches.", m_mipGenerationData.cbvIndices.size()));
+                }
+
+                // NOTE : UAV's have a limited set of formats they can use.
+                // Refer : https://docs.microsoft.com/en-us/windows/win32/direct3d12/typed-unordered-access-view-loads.
+                std::array<uint32_t, 4u> mipUavs{};
+                for (uint32_t uav : std::views::iota(0u, static_cast<uint32_t>(mipCount)))
+                {
+                    const D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {
+                        .Format = getNonSRGBFormat(sourceResourceDesc.Format),
+                        .ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D,
+                        .Texture2D{
+                            .MipSlice = uav + 1 + srcMipLevel,
+                            .PlaneSlice = 0u,
+                        },
+                    };
+
+                    //  Reading from a SRV/UAV mapped to a null resource will return black and writing to a UAV mapped to a null resource will have no effect (from 3DGEP).
+                    mipUavs[uav] = m_cbvSrvUavDescriptorHeap.allocate();
+                    uavIndices.push_back(mipUavs[uav]);
+                    m_device->CreateUnorderedAccessView(texture.texture.Get(), nullptr, &uavDesc, m_cbvSrvUavDescriptorHeap.getCpuDescriptorHandleAtIndex(mipUavs[uav]));
+                }
+
+                // Every dispatch has its own slot, as the list only runs once all of them are written.
+                m_mipGenerationData.bufferPointer[slot] = GenerateMipMapData{
+                    .sourceMipLevel = srcMipLevel,
+                    .numberOfMipLevels = static_cast<uint32_t>(mipCount),
+                    .dimensionType = dimensionType,
+                    .isSrgb = isTextureSRGB(sourceResourceDesc.Format),
+                    .texelSize = {1.0f / destinationWidth, 1.0f / destinationHeight},
+                };
+
+                const GenerateMipMapRenderResources renderResources = {
+                    .mipGenBufferIndex = m_mipGenerationData.cbvIndices[slot++],
+                    .sourceTextureIndex = texture.srvIndex,
+                    .outputMip1Index = mipUavs[0],
+                    .outputMip2Index = mipUavs[1],
+                    .outputMip3Index = mipUavs[2],
+                    .outputMip4Index = mipUavs[3],
+                };
+
+                // Only the values the shader reads are set (validated against the size of GenerateMipMapRenderResources when the pipeline was created).
+                commandList->SetComputeRoot32BitConstants(0u, pipeline.rootConstantCount, &renderResources, 0u);
+
+                commandList->Dispatch(std::max<uint32_t>((uint32_t)std::ceil(destinationWidth / 8.0f), 1u),
+                                      std::max<uint32_t>((uint32_t)std::ceil(destinationHeight / 8.0f), 1u),
+                                      1);
+
+                // The next dispatch of the texture reads the levels this one wrote.
+                const CD3DX12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(texture.texture.Get());
+                commandList->ResourceBarrier(1u, &uavBarrier);
+
+                srcMipLevel += static_cast<uint32_t>(mipCount);
+            }
+        }
+    }
+
+    void D3D12GraphicsBackend::generateMips(const Texture& texture)
+    {
+        // The dispatches write to the same constant buffer slots as the batches, so the mips of the batch in flight (if any) must be done first.
+        if (m_uploadBatch.computeFenceValue != 0u && m_computeFence->GetCompletedValue() < m_uploadBatch.computeFenceValue)
+        {
+            throwIfFailed(m_computeFence->SetEventOnCompletion(m_uploadBatch.computeFenceValue, nullptr));
+        }
+
+        const ComputePipeline mipMapGenerationPipeline = getMipMapGenerationPipeline();
+
+        std::vector<uint32_t> uavIndices{};
+        recordMipGeneration(m_computeCommandList.Get(), mipMapGenerationPipeline, std::span(&texture, 1u), uavIndices);
+
+        executeComputeCommands();
+
+        for (const uint32_t uavIndex : uavIndices)
+        {
+            m_cbvSrvUavDescriptorHeap.release(uavIndex);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "Pch.hpp"
+
+#include "DescriptorAllocator.hpp"
+
+namespace nether
+{
+    void DescriptorAllocator::init(const uint32_t capacity, const std::string_view name)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        m_name = name;
+        m_capacity = capacity;
+
+        m_nextUnusedIndex = 0u;
+        m_freeIndices.clear();
+        m_freeIndices.reserve(capacity);
+    }
+
+    uint32_t DescriptorAllocator::allocate()
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        if (!m_freeIndices.empty())
+        {
+            const uint32_t index = m_freeIndices.back();
+            m_freeIndices.pop_back();
+
+            return index;
+        }
+
+        if (m_nextUnusedIndex == m_capacity)
+        {
+            fatalError(std::format("{} is full ({} descriptors).", m_name, m_capacity));
+        }
+
+        return m_nextUnusedIndex++;
+    }
+
+    void DescriptorAllocator::release(const uint32_t index)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        if (index >= m_nextUnusedIndex)
+        {
+            fatalError(std::format("Descriptor {} released to {}, but it was never allocated.", index, m_name));
+        }
+
+        if (m_freeIndices.size() == m_nextUnusedIndex)
+        {
+            fatalError(std::format("Descriptor {} released to {}, but every descriptor was already released.", index, m_name));
+        }
+
+        m_freeIndices.push_back(index);
+    }
+
+    uint32_t DescriptorAllocator::getAllocatedCount() const
+    {
+        const std::scoped_lock lock(m_mutex);
+        return m_nextUnusedIndex - static_cast<uint32_t>(m_freeIndices.size());
+    }
+}
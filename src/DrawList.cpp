@@ -0,0 +1,114 @@
+#include "Pch.hpp"
+
+#include "DrawList.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    void DrawList::build(const std::span<const Renderable> renderables)
+    {
+        NETHER_PROFILE_SCOPE("DrawList::build");
+
+        const ScratchScope scratchScope{};
+        SortEntries sortEntries(ArenaAllocator<SortEntry>(scratchScope.getArena()));
+        sortEntries.reserve(renderables.size());
+        m_draws.reserve(renderables.size());
+        m_instanceIndices.reserve(renderables.size());
+
+        for (const size_t i : std::views::iota(0u, renderables.size()))
+        {
+            addSortEntry(sortEntries, renderables[i], static_cast<uint32_t>(i));
+        }
+
+        buildDraws(sortEntries);
+    }
+
+    void DrawList::build(const std::span<const Renderable> renderables, const std::span<const uint32_t> visibleIndices)
+    {
+        NETHER_PROFILE_SCOPE("DrawList::build");
+
+        // The arrays are sized for the whole scene rather than the visible renderables, so they do not grow when more of the scene comes into view.
+        const ScratchScope scratchScope{};
+        SortEntries sortEntries(ArenaAllocator<SortEntry>(scratchScope.getArena()));
+        sortEntries.reserve(renderables.size());
+        m_draws.reserve(renderables.size());
+        m_instanceIndices.reserve(renderables.size());
+
+        for (const uint32_t denseIndex : visibleIndices)
+        {
+            addSortEntry(sortEntries, renderables[denseIndex], denseIndex);
+        }
+
+        buildDraws(sortEntries);
+    }
+
+    void DrawList::addSortEntry(SortEntries& sortEntries, const Renderable& renderable, const uint32_t denseIndex)
+    {
+        if (!renderable.mesh || !renderable.graphicsPipeline)
+        {
+            return;
+        }
+
+        sortEntries.push_back(SortEntry{
+            .graphicsPipeline = renderable.graphicsPipeline,
+            .mesh = renderable.mesh,
+            .albedoTextureIndex = renderable.albedoTextureIndex,
+            .denseIndex = denseIndex,
+        });
+    }
+
+    void DrawList::buildDraws(SortEntries& sortEntries)
+    {
+        m_draws.clear();
+        m_instanceIndices.clear();
+
+        // Sort so that all instances of a draw are adjacent. The dense index is the final tie breaker so the order is deterministic.
+        constexpr std::less<const void*> pointerLess{};
+        std::sort(sortEntries.begin(),
+                  sortEntries.end(),
+                  [&](const SortEntry& a, const SortEntry& b)
+                  {
+                      if (a.graphicsPipeline != b.graphicsPipeline)
+                      {
+                          return pointerLess(a.graphicsPipeline, b.graphicsPipeline);
+                      }
+
+                      if (a.mesh != b.mesh)
+                      {
+                          return pointerLess(a.mesh, b.mesh);
+                      }
+
+                      if (a.albedoTextureIndex != b.albedoTextureIndex)
+                      {
+                          return a.albedoTextureIndex < b.albedoTextureIndex;
+                      }
+
+                      return a.denseIndex < b.denseIndex;
+                  });
+
+        // Merge runs of identical state into instanced draws.
+        for (const SortEntry& sortEntry : sortEntries)
+        {
+            const bool canMerge = !m_draws.empty() && m_draws.back().graphicsPipeline == sortEntry.graphicsPipeline && m_draws.back().mesh == sortEntry.mesh &&
+                                  m_draws.back().albedoTextureIndex == sortEntry.albedoTextureIndex;
+
+            if (canMerge)
+            {
+                m_draws.back().instanceCount++;
+            }
+            else
+            {
+                m_draws.push_back(InstancedDraw{
+                    .graphicsPipeline = sortEntry.graphicsPipeline,
+                    .mesh = sortEntry.mesh,
+                    .albedoTextureIndex = sortEntry.albedoTextureIndex,
+                    .indexCount = sortEntry.mesh->indexCount,
+                    .firstInstance = static_cast<uint32_t>(m_instanceIndices.size()),
+                    .instanceCount = 1u,
+                });
+            }
+
+            m_instanceIndices.push_back(sortEntry.denseIndex);
+        }
+    }
+}
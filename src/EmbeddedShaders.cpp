@@ -0,0 +1,10 @@
+#include "Pch.hpp"
+
+#include "EmbeddedShaders.hpp"
+
+namespace nether
+{
+#ifndef NETHER_SHIPPING
+    std::span<const EmbeddedShader> getEmbeddedShaders() { return {}; }
+#endif
+}
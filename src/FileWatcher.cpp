@@ -0,0 +1,208 @@
+#include "Pch.hpp"
+
+#include "FileWatcher.hpp"
+
+#ifndef _WIN32
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace nether
+{
+    FileWatcher::FileWatcher(const Clock::duration debounceDuration, const bool useNativeNotifications)
+        : m_debounceDuration(debounceDuration), m_useNativeNotifications(useNativeNotifications)
+    {
+#ifndef _WIN32
+        if (m_useNativeNotifications)
+        {
+            m_nativeWatcher = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        }
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+#ifdef _WIN32
+        for (const WatchedDirectory& watchedDirectory : m_watchedDirectories)
+        {
+            if (watchedDirectory.nativeHandle != INVALID_NATIVE_HANDLE)
+            {
+                FindCloseChangeNotification(reinterpret_cast<HANDLE>(watchedDirectory.nativeHandle));
+            }
+        }
+#else
+        // Closing the inotify instance removes all of its watches.
+        if (m_nativeWatcher != INVALID_NATIVE_HANDLE)
+        {
+            close(static_cast<int>(m_nativeWatcher));
+        }
+#endif
+    }
+
+    void FileWatcher::watch(const std::filesystem::path& filePath)
+    {
+        if (std::ranges::find(m_watchedFiles, filePath, &WatchedFile::path) != m_watchedFiles.end())
+        {
+            return;
+        }
+
+        // The directory is watched first, so a change right after the last write time is read is not missed.
+        const uint32_t directoryIndex = watchDirectory(filePath.has_parent_path() ? filePath.parent_path() : std::filesystem::path("."));
+
+        std::error_code errorCode{};
+        m_watchedFiles.push_back(WatchedFile{
+            .path = filePath,
+            .directoryIndex = directoryIndex,
+            .lastWriteTime = std::filesystem::last_write_time(filePath, errorCode),
+        });
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::poll(const Clock::time_point currentTime)
+    {
+        collectNativeNotifications();
+
+        bool isAnyChangePending{};
+
+        for (WatchedFile& watchedFile : m_watchedFiles)
+        {
+            const WatchedDirectory& watchedDirectory = m_watchedDirectories[watchedFile.directoryIndex];
+
+            std::error_code errorCode{};
+            if (watchedDirectory.nativeHandle == INVALID_NATIVE_HANDLE || watchedDirectory.hasChanged)
+            {
+                const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(watchedFile.path, errorCode);
+
+                if (!errorCode && lastWriteTime != watchedFile.lastWriteTime)
+                {
+                    watchedFile.lastWriteTime = lastWriteTime;
+                    watchedFile.isChangePending = true;
+
+                    m_lastChangeTime = currentTime;
+                }
+            }
+
+            isAnyChangePending |= watchedFile.isChangePending;
+        }
+
+        for (WatchedDirectory& watchedDirectory : m_watchedDirectories)
+        {
+            watchedDirectory.hasChanged = false;
+        }
+
+        if (!isAnyChangePending || currentTime - m_lastChangeTime < m_debounceDuration)
+        {
+            return {};
+        }
+
+        std::vector<std::filesystem::path> changedFiles{};
+        for (WatchedFile& watchedFile : m_watchedFiles)
+        {
+            if (std::exchange(watchedFile.isChangePending, false))
+            {
+                changedFiles.push_back(watchedFile.path);
+            }
+        }
+
+        return changedFiles;
+    }
+
+    size_t FileWatcher::getNativelyWatchedDirectoryCount() const
+    {
+        return static_cast<size_t>(std::ranges::count_if(m_watchedDirectories,
+                                                         [](const WatchedDirectory& watchedDirectory) { return watchedDirectory.nativeHandle != INVALID_NATIVE_HANDLE; }));
+    }
+
+    uint32_t FileWatcher::watchDirectory(const std::filesystem::path& directoryPath)
+    {
+        if (const auto it = std::ranges::find(m_watchedDirectories, directoryPath, &WatchedDirectory::path); it != m_watchedDirectories.end())
+        {
+            return static_cast<uint32_t>(it - m_watchedDirectories.begin());
+        }
+
+        WatchedDirectory& watchedDirectory = m_watchedDirectories.emplace_back(WatchedDirectory{
+            .path = directoryPath,
+        });
+
+#ifdef _WIN32
+        if (m_useNativeNotifications)
+        {
+            const HANDLE changeNotification =
+                FindFirstChangeNotificationW(directoryPath.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+
+            if (changeNotification != INVALID_HANDLE_VALUE)
+            {
+                watchedDirectory.nativeHandle = reinterpret_cast<intptr_t>(changeNotification);
+            }
+        }
+#else
+        // Writes, touches, and files renamed into place (which is how many editors save).
+        if (m_nativeWatcher != INVALID_NATIVE_HANDLE)
+        {
+            const int watchDescriptor =
+                inotify_add_watch(static_cast<int>(m_nativeWatcher), directoryPath.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_MOVED_TO);
+
+            watchedDirectory.nativeHandle = watchDescriptor;
+        }
+#endif
+
+        return static_cast<uint32_t>(m_watchedDirectories.size() - 1u);
+    }
+
+    void FileWatcher::collectNativeNotifications()
+    {
+#ifdef _WIN32
+        for (WatchedDirectory& watchedDirectory : m_watchedDirectories)
+        {
+            const HANDLE changeNotification = reinterpret_cast<HANDLE>(watchedDirectory.nativeHandle);
+            if (watchedDirectory.nativeHandle == INVALID_NATIVE_HANDLE || WaitForSingleObject(changeNotification, 0u) != WAIT_OBJECT_0)
+            {
+                continue;
+            }
+
+            // Rearmed before the files are checked, so changes made while they are checked signal again.
+            watchedDirectory.hasChanged = true;
+            if (!FindNextChangeNotification(changeNotification))
+            {
+                FindCloseChangeNotification(changeNotification);
+                watchedDirectory.nativeHandle = INVALID_NATIVE_HANDLE;
+            }
+        }
+#else
+        if (m_nativeWatcher == INVALID_NATIVE_HANDLE)
+        {
+            return;
+        }
+
+        // The descriptor is non blocking, so the loop ends once the queue is drained.
+        alignas(inotify_event) std::array<char, 4096u> buffer{};
+        for (ssize_t size = read(static_cast<int>(m_nativeWatcher), buffer.data(), buffer.size()); size > 0;
+             size = read(static_cast<int>(m_nativeWatcher), buffer.data(), buffer.size()))
+        {
+            for (ssize_t offset = 0; offset < size;)
+            {
+                const inotify_event* const event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                for (WatchedDirectory& watchedDirectory : m_watchedDirectories)
+                {
+                    // Events were dropped, so anything could have changed.
+                    if (event->mask & IN_Q_OVERFLOW)
+                    {
+                        watchedDirectory.hasChanged = true;
+                    }
+                    else if (watchedDirectory.nativeHandle == event->wd)
+                    {
+                        watchedDirectory.hasChanged = true;
+
+                        // The directory was removed, its files are polled from now on.
+                        if (event->mask & IN_IGNORED)
+                        {
+                            watchedDirectory.nativeHandle = INVALID_NATIVE_HANDLE;
+                        }
+                    }
+                }
+            }
+        }
+#endif
+    }
+}
@@ -0,0 +1,55 @@
+#include "Pch.hpp"
+
+#include "AllocationTracker.hpp"
+#include "FrameBuilder.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    void FrameBuilder::build(const Scene& scene, const math::XMMATRIX& viewProjectionMatrix, FramePacket& framePacket)
+    {
+        cull(scene, viewProjectionMatrix);
+        buildDraws(scene);
+        gatherInstances(scene, framePacket);
+    }
+
+    void FrameBuilder::cull(const Scene& scene, const math::XMMATRIX& viewProjectionMatrix)
+    {
+        NETHER_ALLOCATION_SCOPE("FrameBuilder");
+        m_frustumCuller.cull(scene, viewProjectionMatrix);
+    }
+
+    void FrameBuilder::buildDraws(const Scene& scene)
+    {
+        NETHER_ALLOCATION_SCOPE("FrameBuilder");
+        m_drawList.build(scene.getRenderables(), m_frustumCuller.getVisibleIndices());
+    }
+
+    void FrameBuilder::gatherInstances(const Scene& scene, FramePacket& framePacket) const
+    {
+        NETHER_PROFILE_SCOPE("FrameBuilder::gatherInstances");
+        NETHER_ALLOCATION_SCOPE("FrameBuilder");
+
+        const std::span<const uint32_t> instanceIndices = m_drawList.getInstanceIndices();
+
+        const std::span<const math::XMFLOAT4X4> worldMatrices = scene.getWorldMatrices();
+        const std::span<const math::XMFLOAT4X4> normalMatrices = scene.getNormalMatrices();
+
+        const std::span<InstancedDraw> draws = framePacket.arena.allocateArray<InstancedDraw>(m_drawList.getDraws().size());
+        std::ranges::copy(m_drawList.getDraws(), draws.begin());
+
+        const std::span<InstanceData> instances = framePacket.arena.allocateArray<InstanceData>(instanceIndices.size());
+        for (const size_t instance : std::views::iota(0u, instanceIndices.size()))
+        {
+            const uint32_t denseIndex = instanceIndices[instance];
+
+            instances[instance] = InstanceData{
+                .modelMatrix = worldMatrices[denseIndex],
+                .normalMatrix = normalMatrices[denseIndex],
+            };
+        }
+
+        framePacket.draws = draws;
+        framePacket.instances = instances;
+    }
+}
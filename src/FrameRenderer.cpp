@@ -0,0 +1,81 @@
+#include "Pch.hpp"
+
+#include "AllocationTracker.hpp"
+#include "FrameRenderer.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    void recordDrawBatches(CommandRecorder& commandRecorder, const std::span<const IndirectDrawBatch> batches)
+    {
+        const GraphicsPipeline* lastGraphicsPipeline{};
+
+        for (const IndirectDrawBatch& batch : batches)
+        {
+            if (batch.graphicsPipeline != lastGraphicsPipeline)
+            {
+                lastGraphicsPipeline = batch.graphicsPipeline;
+                commandRecorder.setGraphicsPipeline(*lastGraphicsPipeline);
+            }
+
+            commandRecorder.drawIndirect(batch.firstRecord, batch.recordCount);
+        }
+    }
+
+    void FrameRenderer::render(GraphicsBackend& graphicsBackend, ParallelRecorder& parallelRecorder, const FramePacket& framePacket)
+    {
+        NETHER_PROFILE_SCOPE("FrameRenderer::render");
+        NETHER_ALLOCATION_SCOPE("FrameRenderer");
+
+        const FrameBuffers frameBuffers = [&]()
+        {
+            NETHER_PROFILE_SCOPE("GraphicsBackend::beginFrame");
+            return graphicsBackend.beginFrame();
+        }();
+
+        *frameBuffers.sceneData = framePacket.sceneData;
+
+        const std::span<const InstanceData> instances = framePacket.instances;
+        if (instances.size() > frameBuffers.instances.size())
+        {
+            fatalError("Number of instances exceeds the capacity of the per frame instance buffer.");
+        }
+
+        std::memcpy(frameBuffers.instances.data(), instances.data(), instances.size_bytes());
+
+        // Encode the draws into indirect records. All records of a pipeline are submitted with a single ExecuteIndirect. Encoded here rather than by the simulation
+        // thread, as the records hold the descriptor indices of this frame's buffers.
+        // Sized for the capacity of the indirect command buffer rather than this frame's draws, so the arrays do not grow when more of the scene comes into view.
+        {
+            NETHER_PROFILE_SCOPE("IndirectCommandBuilder::build");
+            m_indirectCommandBuilder.reserve(frameBuffers.indirectDrawRecords.size());
+            m_indirectCommandBuilder.build(framePacket.draws, frameBuffers.sceneBufferIndex, frameBuffers.instanceBufferIndex);
+        }
+
+        const std::span<const IndirectDrawRecord> indirectDrawRecords = m_indirectCommandBuilder.getRecords();
+        if (indirectDrawRecords.size() > frameBuffers.indirectDrawRecords.size())
+        {
+            fatalError("Number of draws exceeds the capacity of the per frame indirect command buffer.");
+        }
+
+        std::memcpy(frameBuffers.indirectDrawRecords.data(), indirectDrawRecords.data(), indirectDrawRecords.size_bytes());
+
+        // Split the batches into chunks, and record each chunk into its own command list in parallel.
+        const std::span<const IndirectDrawBatch> batches = m_indirectCommandBuilder.getBatches();
+        splitIntoChunks(static_cast<uint32_t>(batches.size()),
+                        std::min(parallelRecorder.getThreadCount(), graphicsBackend.getMaxChunkCount()),
+                        MIN_BATCHES_PER_RECORDING_CHUNK,
+                        m_recordingChunks);
+
+        parallelRecorder.record(m_recordingChunks,
+                                [&](const uint32_t chunkIndex, const RecordingChunk& chunk)
+                                {
+                                    NETHER_PROFILE_SCOPE("Record chunk");
+                                    NETHER_ALLOCATION_SCOPE("FrameRenderer");
+                                    recordDrawBatches(graphicsBackend.beginChunk(chunkIndex), batches.subspan(chunk.firstItem, chunk.itemCount));
+                                });
+
+        NETHER_PROFILE_SCOPE("GraphicsBackend::submitFrame");
+        graphicsBackend.submitFrame(static_cast<uint32_t>(m_recordingChunks.size()));
+    }
+}
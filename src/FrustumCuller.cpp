@@ -0,0 +1,75 @@
+#include "Pch.hpp"
+
+#include "FrustumCuller.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    // The planes point inwards, so a point is inside the frustum if its distance to all of them is positive.
+    static std::array<math::XMVECTOR, 6u> extractFrustumPlanes(const math::XMMATRIX& viewProjectionMatrix)
+    {
+        // With row vectors, clip space coordinate i is the dot product of the position with column i, which are the rows of the transpose.
+        const math::XMMATRIX columns = math::XMMatrixTranspose(viewProjectionMatrix);
+
+        const std::array<math::XMVECTOR, 6u> planes = {
+            columns.r[3] + columns.r[0],
+            columns.r[3] - columns.r[0],
+            columns.r[3] + columns.r[1],
+            columns.r[3] - columns.r[1],
+            columns.r[2],
+            columns.r[3] - columns.r[2],
+        };
+
+        std::array<math::XMVECTOR, 6u> normalizedPlanes{};
+        std::ranges::transform(planes, normalizedPlanes.begin(), [](const math::XMVECTOR plane) { return math::XMPlaneNormalize(plane); });
+
+        return normalizedPlanes;
+    }
+
+    void FrustumCuller::cull(const Scene& scene, const math::XMMATRIX& viewProjectionMatrix)
+    {
+        NETHER_PROFILE_SCOPE("FrustumCuller::cull");
+
+        const std::array<math::XMVECTOR, 6u> planes = extractFrustumPlanes(viewProjectionMatrix);
+
+        const std::span<const Renderable> renderables = scene.getRenderables();
+        const std::span<const math::XMFLOAT4X4> worldMatrices = scene.getWorldMatrices();
+
+        // Sized for the whole scene, so the array does not grow when more of it comes into view.
+        m_visibleIndices.clear();
+        m_visibleIndices.reserve(renderables.size());
+
+        for (const size_t i : std::views::iota(0u, renderables.size()))
+        {
+            const Renderable& renderable = renderables[i];
+            if (!renderable.mesh || !renderable.graphicsPipeline)
+            {
+                continue;
+            }
+
+            const math::XMMATRIX worldMatrix = math::XMLoadFloat4x4(&worldMatrices[i]);
+            const math::XMVECTOR boundingSphere = math::XMLoadFloat4(&renderable.mesh->boundingSphere);
+
+            const math::XMVECTOR center = math::XMVector3Transform(boundingSphere, worldMatrix);
+
+            const math::XMVECTOR maxScaleSquared = math::XMVectorMax(math::XMVector3LengthSq(worldMatrix.r[0]),
+                                                                     math::XMVectorMax(math::XMVector3LengthSq(worldMatrix.r[1]), math::XMVector3LengthSq(worldMatrix.r[2])));
+            const math::XMVECTOR negativeRadius = -math::XMVectorSplatW(boundingSphere) * math::XMVectorSqrt(maxScaleSquared);
+
+            bool isVisible{true};
+            for (const math::XMVECTOR plane : planes)
+            {
+                if (math::XMVector4Less(math::XMPlaneDotCoord(plane, center), negativeRadius))
+                {
+                    isVisible = false;
+                    break;
+                }
+            }
+
+            if (isVisible)
+            {
+                m_visibleIndices.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
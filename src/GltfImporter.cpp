@@ -0,0 +1,657 @@
+#include "Pch.hpp"
+
+#include "GltfImporter.hpp"
+#include "AssetArchive.hpp"
+#include "JsonReader.hpp"
+
+namespace nether
+{
+    static constexpr uint32_t GLB_MAGIC = 0x46546C67u;             // "glTF".
+    static constexpr uint32_t GLB_JSON_CHUNK_TYPE = 0x4E4F534Au;   // "JSON".
+    static constexpr uint32_t GLB_BINARY_CHUNK_TYPE = 0x004E4942u; // "BIN".
+
+    struct GlbHeader
+    {
+        uint32_t magic{};
+        uint32_t version{};
+        uint32_t length{};
+    };
+
+    struct GlbChunkHeader
+    {
+        uint32_t length{};
+        uint32_t type{};
+    };
+
+    static void checkGltf(const bool condition, const std::string_view message)
+    {
+        if (!condition)
+        {
+            fatalError(std::format("Malformed glTF file : {}.", message));
+        }
+    }
+
+    static GltfComponentType readComponentType(JsonReader& reader)
+    {
+        const uint64_t componentType = reader.readUnsigned();
+        checkGltf(componentType >= EnumClassValue(GltfComponentType::Byte) && componentType <= EnumClassValue(GltfComponentType::Float) && componentType != 5124u,
+                  "invalid accessor component type");
+
+        return static_cast<GltfComponentType>(componentType);
+    }
+
+    static GltfAccessorType readAccessorType(JsonReader& reader)
+    {
+        static constexpr std::array<std::string_view, 7u> accessorTypeNames = {"SCALAR", "VEC2", "VEC3", "VEC4", "MAT2", "MAT3", "MAT4"};
+
+        const auto accessorType = std::ranges::find(accessorTypeNames, reader.readRawString());
+        checkGltf(accessorType != accessorTypeNames.end(), "invalid accessor type");
+
+        return static_cast<GltfAccessorType>(accessorType - accessorTypeNames.begin());
+    }
+
+    // Fills the arrays of the model. bufferUris gets the uri of every buffer, empty for the .glb's binary chunk.
+    static void readGltfJson(const std::string_view json, GltfModel& model, std::vector<std::string>& bufferUris)
+    {
+        JsonReader reader(json);
+
+        reader.readObject(
+            [&](const std::string_view key)
+            {
+                if (key == "buffers")
+                {
+                    reader.readArray(
+                        [&]()
+                        {
+                            GltfBuffer& buffer = model.buffers.emplace_back();
+                            std::string& uri = bufferUris.emplace_back();
+
+                            reader.readObject(
+                                [&](const std::string_view bufferKey)
+                                {
+                                    if (bufferKey == "byteLength")
+                                    {
+                                        buffer.byteLength = reader.readUnsigned();
+                                    }
+                                    else if (bufferKey == "uri")
+                                    {
+                                        uri = reader.readString();
+                                    }
+                                    else
+                                    {
+                                        reader.skipValue();
+                                    }
+                                });
+                        });
+                }
+                else if (key == "bufferViews")
+                {
+                    reader.readArray(
+                        [&]()
+                        {
+                            GltfBufferView& bufferView = model.bufferViews.emplace_back();
+
+                            reader.readObject(
+                                [&](const std::string_view bufferViewKey)
+                                {
+                                    if (bufferViewKey == "buffer")
+                                    {
+                                        bufferView.buffer = reader.readIndex();
+                                    }
+                                    else if (bufferViewKey == "byteOffset")
+                                    {
+                                        bufferView.byteOffset = reader.readUnsigned();
+                                    }
+                                    else if (bufferViewKey == "byteLength")
+                                    {
+                                        bufferView.byteLength = reader.readUnsigned();
+                                    }
+                                    else if (bufferViewKey == "byteStride")
+                                    {
+                                        bufferView.byteStride = reader.readIndex();
+                                    }
+                                    else
+                                    {
+                                        reader.skipValue();
+                                    }
+                                });
+                        });
+                }
+                else if (key == "accessors")
+                {
+                    reader.readArray(
+                        [&]()
+                        {
+                            GltfAccessor& accessor = model.accessors.emplace_back();
+
+                            reader.readObject(
+                                [&](const std::string_view accessorKey)
+                                {
+                                    if (accessorKey == "bufferView")
+                                    {
+                                        accessor.bufferView = reader.readIndex();
+                                    }
+                                    else if (accessorKey == "byteOffset")
+                                    {
+                                        accessor.byteOffset = reader.readUnsigned();
+                                    }
+                                    else if (accessorKey == "count")
+                                    {
+                                        accessor.count = reader.readUnsigned();
+                                    }
+                                    else if (accessorKey == "componentType")
+                                    {
+                                        accessor.componentType = readComponentType(reader);
+                                    }
+                                    else if (accessorKey == "type")
+                                    {
+                                        accessor.type = readAccessorType(reader);
+                                    }
+                                    else
+                                    {
+                                        reader.skipValue();
+                                    }
+                                });
+                        });
+                }
+                else if (key == "meshes")
+                {
+                    reader.readArray(
+                        [&]()
+                        {
+                            GltfMesh& mesh = model.meshes.emplace_back();
+
+                            reader.readObject(
+                                [&](const std::string_view meshKey)
+                                {
+                                    if (meshKey != "primitives")
+                                    {
+                                        reader.skipValue();
+                                        return;
+                                    }
+
+                                    mesh.firstPrimitive = static_cast<uint32_t>(model.primitives.size());
+
+                                    reader.readArray(
+                                        [&]()
+                                        {
+                                            GltfPrimitive& primitive = model.primitives.emplace_back();
+                                            mesh.primitiveCount++;
+
+                                            reader.readObject(
+                                                [&](const std::string_view primitiveKey)
+                                                {
+                                                    if (primitiveKey == "indices")
+                                                    {
+                                                        primitive.indices = reader.readIndex();
+                                                    }
+                                                    else if (primitiveKey == "attributes")
+                                                    {
+                                                        reader.readObject(
+                                                            [&](const std::string_view attributeName)
+                                                            {
+                                                                if (attributeName == "POSITION")
+                                                                {
+                                                                    primitive.position = reader.readIndex();
+                                                                }
+                                                                else if (attributeName == "NORMAL")
+                                                                {
+                                                                    primitive.normal = reader.readIndex();
+                                                                }
+                                                                else if (attributeName == "TEXCOORD_0")
+                                                                {
+                                                                    primitive.textureCoord = reader.readIndex();
+                                                                }
+                                                                else
+                                                                {
+                                                                    reader.skipValue();
+                                                                }
+                                                            });
+                                                    }
+                                                    else
+                                                    {
+                                                        reader.skipValue();
+                                                    }
+                                                });
+                                        });
+                                });
+                        });
+                }
+                else if (key == "nodes")
+                {
+                    reader.readArray(
+                        [&]()
+                        {
+                            GltfNode& node = model.nodes.emplace_back();
+
+                            reader.readObject(
+                                [&](const std::string_view nodeKey)
+                                {
+                                    if (nodeKey == "mesh")
+                                    {
+                                        node.mesh = reader.readIndex();
+                                    }
+                                    else
+                                    {
+                                        reader.skipValue();
+                                    }
+                                });
+                        });
+                }
+                else
+                {
+                    reader.skipValue();
+                }
+            });
+
+        reader.expectEnd();
+    }
+
+    // Indices between the arrays, and the ranges of buffer views. Accessor ranges depend on the element size, and are checked when they are decoded.
+    static void validateGltfModel(const GltfModel& model)
+    {
+        for (const GltfBufferView& bufferView : model.bufferViews)
+        {
+            checkGltf(bufferView.buffer < model.buffers.size(), "buffer view of a buffer that does not exist");
+
+            const uint64_t bufferSize = model.buffers[bufferView.buffer].byteLength;
+            checkGltf(bufferView.byteOffset <= bufferSize && bufferView.byteLength <= bufferSize - bufferView.byteOffset, "buffer view out of the buffer's range");
+        }
+
+        for (const GltfAccessor& accessor : model.accessors)
+        {
+            checkGltf(accessor.bufferView == GltfAccessor::NO_BUFFER_VIEW || accessor.bufferView < model.bufferViews.size(),
+                      "accessor of a buffer view that does not exist");
+        }
+
+        for (const GltfPrimitive& primitive : model.primitives)
+        {
+            for (const uint32_t accessor : {primitive.position, primitive.normal, primitive.textureCoord, primitive.indices})
+            {
+                checkGltf(accessor == GltfPrimitive::INVALID_INDEX || accessor < model.accessors.size(), "primitive with an accessor that does not exist");
+            }
+        }
+
+        for (const GltfNode& node : model.nodes)
+        {
+            checkGltf(node.mesh == GltfNode::NO_MESH || node.mesh < model.meshes.size(), "node with a mesh that does not exist");
+        }
+    }
+
+    static std::vector<std::byte> decodeBase64(const std::string_view encodedData)
+    {
+        static constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::vector<std::byte> data{};
+        data.reserve(encodedData.size() / 4u * 3u);
+
+        uint32_t bits{};
+        uint32_t bitCount{};
+        for (const char character : encodedData)
+        {
+            if (character == '=')
+            {
+                break;
+            }
+
+            const size_t value = alphabet.find(character);
+            checkGltf(value != std::string_view::npos, "invalid base64 data URI");
+
+            bits = (bits << 6u) | static_cast<uint32_t>(value);
+            bitCount += 6u;
+
+            if (bitCount >= 8u)
+            {
+                bitCount -= 8u;
+                data.push_back(static_cast<std::byte>((bits >> bitCount) & 0xFFu));
+            }
+        }
+
+        return data;
+    }
+
+    static std::string decodePercentEncoding(const std::string_view uri)
+    {
+        std::string path{};
+        path.reserve(uri.size());
+
+        for (size_t i = 0u; i < uri.size(); ++i)
+        {
+            uint32_t value{};
+            if (uri[i] == '%' && i + 2u < uri.size() && std::from_chars(uri.data() + i + 1u, uri.data() + i + 3u, value, 16).ptr == uri.data() + i + 3u)
+            {
+                path.push_back(static_cast<char>(value));
+                i += 2u;
+            }
+            else
+            {
+                path.push_back(uri[i]);
+            }
+        }
+
+        return path;
+    }
+
+    static std::span<const std::byte> resolveBuffer(const std::string_view uri,
+                                                    const std::string_view baseDirectory,
+                                                    const std::span<const std::byte> binaryChunk,
+                                                    GltfModel& model,
+                                                    const AssetArchive* const assetArchive)
+    {
+        // The buffer of a .glb without a uri is its binary chunk.
+        if (uri.empty())
+        {
+            return binaryChunk;
+        }
+
+        if (uri.starts_with("data:"))
+        {
+            const size_t dataStart = uri.find(";base64,");
+            checkGltf(dataStart != std::string_view::npos, "data URI is not base64");
+
+            return model.bufferStorage.emplace_back(decodeBase64(uri.substr(dataStart + 8u)));
+        }
+
+        const std::string bufferPath = (std::filesystem::path(baseDirectory) / decodePercentEncoding(uri)).generic_string();
+
+        // Moving the decompressed data (or the mapped file) to the model does not move the bytes the returned span points to.
+        if (const AssetArchiveEntry* const archiveEntry = assetArchive ? assetArchive->find(bufferPath) : nullptr)
+        {
+            std::vector<std::byte> decompressedData{};
+            const std::span<const std::byte> data = assetArchive->read(*archiveEntry, decompressedData);
+
+            if (!decompressedData.empty())
+            {
+                model.bufferStorage.push_back(std::move(decompressedData));
+            }
+
+            return data;
+        }
+
+        MappedFile& mappedFile = model.mappedFiles.emplace_back(bufferPath);
+        mappedFile.prefetch();
+
+        return mappedFile.getData();
+    }
+
+    void importGltf(const std::span<const std::byte> file, const std::string_view baseDirectory, GltfModel& model, const AssetArchive* const assetArchive)
+    {
+        std::span<const std::byte> json = file;
+        std::span<const std::byte> binaryChunk{};
+
+        // A .glb is a header followed by the JSON chunk, and optionally the binary chunk. Chunks are padded to 4 bytes.
+        uint32_t magic{};
+        if (file.size() >= sizeof(uint32_t))
+        {
+            std::memcpy(&magic, file.data(), sizeof(uint32_t));
+        }
+
+        if (magic == GLB_MAGIC)
+        {
+            GlbHeader header{};
+            GlbChunkHeader jsonChunkHeader{};
+
+            checkGltf(file.size() >= sizeof(GlbHeader) + sizeof(GlbChunkHeader), "truncated .glb header");
+            std::memcpy(&header, file.data(), sizeof(GlbHeader));
+            std::memcpy(&jsonChunkHeader, file.data() + sizeof(GlbHeader), sizeof(GlbChunkHeader));
+
+            checkGltf(header.version == 2u && header.length <= file.size(), "unsupported .glb version or truncated .glb");
+            checkGltf(jsonChunkHeader.type == GLB_JSON_CHUNK_TYPE, "the first .glb chunk is not JSON");
+
+            const std::span<const std::byte> chunks = file.first(header.length).subspan(sizeof(GlbHeader) + sizeof(GlbChunkHeader));
+            checkGltf(jsonChunkHeader.length <= chunks.size(), "truncated .glb JSON chunk");
+
+            json = chunks.first(jsonChunkHeader.length);
+
+            const uint64_t paddedJsonChunkSize = (uint64_t{jsonChunkHeader.length} + 3u) & ~uint64_t{3u};
+            const std::span<const std::byte> remainingChunks = chunks.subspan(std::min<uint64_t>(paddedJsonChunkSize, chunks.size()));
+
+            if (remainingChunks.size() >= sizeof(GlbChunkHeader))
+            {
+                GlbChunkHeader binaryChunkHeader{};
+                std::memcpy(&binaryChunkHeader, remainingChunks.data(), sizeof(GlbChunkHeader));
+
+                checkGltf(binaryChunkHeader.length <= remainingChunks.size() - sizeof(GlbChunkHeader), "truncated .glb binary chunk");
+                if (binaryChunkHeader.type == GLB_BINARY_CHUNK_TYPE)
+                {
+                    binaryChunk = remainingChunks.subspan(sizeof(GlbChunkHeader), binaryChunkHeader.length);
+                }
+            }
+        }
+
+        std::string_view jsonText(reinterpret_cast<const char*>(json.data()), json.size());
+
+        // glTF does not allow a byte order mark, but some exporters write one anyway.
+        if (jsonText.starts_with("\xEF\xBB\xBF"))
+        {
+            jsonText.remove_prefix(3u);
+        }
+
+        std::vector<std::string> bufferUris{};
+        readGltfJson(jsonText, model, bufferUris);
+
+        validateGltfModel(model);
+
+        for (const size_t i : std::views::iota(size_t{0u}, model.buffers.size()))
+        {
+            GltfBuffer& buffer = model.buffers[i];
+
+            checkGltf(!bufferUris[i].empty() || (i == 0u && magic == GLB_MAGIC), "buffer without a uri");
+
+            const std::span<const std::byte> data = resolveBuffer(bufferUris[i], baseDirectory, binaryChunk, model, assetArchive);
+            checkGltf(data.size() >= buffer.byteLength, "buffer is smaller than its byteLength");
+
+            buffer.data = data.first(buffer.byteLength);
+        }
+    }
+
+    // Elements of an accessor, read in order. Once RELEASE_SIZE bytes of a mapped file the model owns were read, their pages are released (see MappedFile::release), so
+    // decoding a large asset needs about the memory of its MeshData, rather than of the MeshData and the file.
+    class AccessorReader
+    {
+      public:
+        // Checks that count elements of elementSize bytes fit in the buffer view.
+        AccessorReader(const GltfModel& model, const GltfAccessor& accessor, const uint64_t elementSize) : m_elementSize(elementSize)
+        {
+            checkGltf(accessor.bufferView != GltfAccessor::NO_BUFFER_VIEW, "accessor without a buffer view");
+
+            const GltfBufferView& bufferView = model.bufferViews[accessor.bufferView];
+            m_byteStride = bufferView.byteStride != 0u ? bufferView.byteStride : elementSize;
+
+            checkGltf(m_byteStride >= elementSize, "buffer view stride is smaller than the accessor's elements");
+
+            if (accessor.count != 0u)
+            {
+                const bool isInRange = accessor.byteOffset <= bufferView.byteLength && (accessor.count - 1u) <= (bufferView.byteLength - accessor.byteOffset) / m_byteStride &&
+                                       (accessor.count - 1u) * m_byteStride + elementSize <= bufferView.byteLength - accessor.byteOffset;
+                checkGltf(isInRange, "accessor out of its buffer view's range");
+            }
+
+            m_data = model.buffers[bufferView.buffer].data.data() + bufferView.byteOffset + accessor.byteOffset;
+            m_releasedEnd = m_data;
+
+            // Not e.g. the mapping of the asset archive, which other threads read from.
+            const auto mappedFile = std::ranges::find_if(model.mappedFiles,
+                                                         [&](const MappedFile& file)
+                                                         { return m_data >= file.getData().data() && m_data < file.getData().data() + file.getSize(); });
+            m_mappedFile = mappedFile != model.mappedFiles.end() ? &*mappedFile : nullptr;
+        }
+
+        // Buffers can be mapped files, memcpy does not assume they are aligned.
+        template <typename T> T read(const uint64_t index) const
+        {
+            T element{};
+            std::memcpy(&element, m_data + index * m_byteStride, sizeof(T));
+
+            return element;
+        }
+
+        // Called once the elements before end were read.
+        void release(const uint64_t end)
+        {
+            const std::byte* const readEnd = m_data + (end - 1u) * m_byteStride + m_elementSize;
+            if (m_mappedFile && end != 0u && static_cast<uint64_t>(readEnd - m_releasedEnd) >= RELEASE_SIZE)
+            {
+                m_mappedFile->release(std::span(m_releasedEnd, readEnd));
+                m_releasedEnd = readEnd;
+            }
+        }
+
+      private:
+        // Small files are not worth the system calls (and the page faults if they are decoded again).
+        static constexpr uint64_t RELEASE_SIZE = 1024u * 1024u;
+
+        const std::byte* m_data{};
+        uint64_t m_byteStride{};
+        uint64_t m_elementSize{};
+
+        const MappedFile* m_mappedFile{};
+        const std::byte* m_releasedEnd{};
+    };
+
+    // Elements are decoded in blocks, and the pages read by a block are released before the next one.
+    static constexpr uint64_t DECODE_BLOCK_SIZE = 16384u;
+
+    // The engine only renders float positions, normals and texture coordinates.
+    static const GltfAccessor& getAttributeAccessor(const GltfModel& model, const uint32_t accessorIndex, const std::string_view attributeName, const GltfAccessorType type)
+    {
+        if (accessorIndex == GltfPrimitive::INVALID_INDEX)
+        {
+            fatalError(std::format("Mesh primitive has no {} attribute.", attributeName));
+        }
+
+        const GltfAccessor& accessor = model.accessors[accessorIndex];
+        if (accessor.componentType != GltfComponentType::Float || accessor.type != type)
+        {
+            fatalError(std::format("Mesh primitive has an unsupported {} attribute format.", attributeName));
+        }
+
+        return accessor;
+    }
+
+    template <typename T> static void decodeIndices(AccessorReader& reader, const uint64_t count, const uint32_t baseVertex, std::span<uint32_t> indices)
+    {
+        for (uint64_t blockStart = 0u; blockStart < count; blockStart += DECODE_BLOCK_SIZE)
+        {
+            const uint64_t blockEnd = std::min(blockStart + DECODE_BLOCK_SIZE, count);
+            for (const uint64_t i : std::views::iota(blockStart, blockEnd))
+            {
+                indices[i] = baseVertex + static_cast<uint32_t>(reader.read<T>(i));
+            }
+
+            reader.release(blockEnd);
+        }
+    }
+
+    MeshData decodeMeshData(const GltfModel& model)
+    {
+        checkGltf(!model.meshes.empty(), "no mesh");
+
+        const uint32_t meshIndex = model.nodes.empty() || model.nodes[0u].mesh == GltfNode::NO_MESH ? 0u : model.nodes[0u].mesh;
+        const GltfMesh& mesh = model.meshes[meshIndex];
+
+        MeshData meshData{};
+
+        for (const GltfPrimitive& primitive : std::span(model.primitives).subspan(mesh.firstPrimitive, mesh.primitiveCount))
+        {
+            const GltfAccessor& positionAccessor = getAttributeAccessor(model, primitive.position, "POSITION", GltfAccessorType::Vec3);
+            const GltfAccessor& textureCoordAccessor = getAttributeAccessor(model, primitive.textureCoord, "TEXCOORD_0", GltfAccessorType::Vec2);
+            const GltfAccessor& normalAccessor = getAttributeAccessor(model, primitive.normal, "NORMAL", GltfAccessorType::Vec3);
+
+            checkGltf(textureCoordAccessor.count == positionAccessor.count && normalAccessor.count == positionAccessor.count, "attributes with different counts");
+
+            // Indices of the primitive start at its first vertex.
+            const uint32_t baseVertex = static_cast<uint32_t>(meshData.positions.size());
+            const uint64_t vertexCount = positionAccessor.count;
+
+            AccessorReader positions(model, positionAccessor, sizeof(math::XMFLOAT3));
+            AccessorReader textureCoords(model, textureCoordAccessor, sizeof(math::XMFLOAT2));
+            AccessorReader normals(model, normalAccessor, sizeof(math::XMFLOAT3));
+
+            meshData.positions.resize(baseVertex + vertexCount);
+            meshData.textureCoords.resize(baseVertex + vertexCount);
+            meshData.normals.resize(baseVertex + vertexCount);
+
+            // Attributes are often interleaved, so all of them are read before the pages of a block are released.
+            for (uint64_t blockStart = 0u; blockStart < vertexCount; blockStart += DECODE_BLOCK_SIZE)
+            {
+                const uint64_t blockEnd = std::min(blockStart + DECODE_BLOCK_SIZE, vertexCount);
+                for (const uint64_t i : std::views::iota(blockStart, blockEnd))
+                {
+                    meshData.positions[baseVertex + i] = positions.read<math::XMFLOAT3>(i);
+                    meshData.textureCoords[baseVertex + i] = textureCoords.read<math::XMFLOAT2>(i);
+                    meshData.normals[baseVertex + i] = normals.read<math::XMFLOAT3>(i);
+                }
+
+                positions.release(blockEnd);
+                textureCoords.release(blockEnd);
+                normals.release(blockEnd);
+            }
+
+            // Primitives without indices draw their vertices in order.
+            if (primitive.indices == GltfPrimitive::INVALID_INDEX)
+            {
+                for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(vertexCount)))
+                {
+                    meshData.indices.push_back(baseVertex + i);
+                }
+
+                continue;
+            }
+
+            const GltfAccessor& indexAccessor = model.accessors[primitive.indices];
+            checkGltf(indexAccessor.type == GltfAccessorType::Scalar, "indices are not scalars");
+
+            const size_t firstIndex = meshData.indices.size();
+            meshData.indices.resize(firstIndex + indexAccessor.count);
+
+            const std::span<uint32_t> indices = std::span(meshData.indices).subspan(firstIndex);
+
+            switch (indexAccessor.componentType)
+            {
+                case GltfComponentType::UnsignedByte:
+                    {
+                        AccessorReader reader(model, indexAccessor, sizeof(uint8_t));
+                        decodeIndices<uint8_t>(reader, indexAccessor.count, baseVertex, indices);
+                    }
+                    break;
+
+                case GltfComponentType::UnsignedShort:
+                    {
+                        AccessorReader reader(model, indexAccessor, sizeof(uint16_t));
+                        decodeIndices<uint16_t>(reader, indexAccessor.count, baseVertex, indices);
+                    }
+                    break;
+
+                case GltfComponentType::UnsignedInt:
+                    {
+                        AccessorReader reader(model, indexAccessor, sizeof(uint32_t));
+                        decodeIndices<uint32_t>(reader, indexAccessor.count, baseVertex, indices);
+                    }
+                    break;
+
+                default:
+                    checkGltf(false, "unsupported index component type");
+                    break;
+            }
+        }
+
+        meshData.boundingSphere = computeBoundingSphere(meshData.positions);
+
+        return meshData;
+    }
+
+    MeshData loadMeshData(const std::string_view modelPath)
+    {
+        MappedFile file(modelPath);
+        file.prefetch();
+
+        GltfModel model{};
+        importGltf(file.getData(), std::filesystem::path(modelPath).parent_path().generic_string(), model);
+
+        // Owned by the model, so the decode releases the pages of a .glb's binary chunk as well. Moving the mapping does not move the data.
+        model.mappedFiles.push_back(std::move(file));
+
+        return decodeMeshData(model);
+    }
+}
@@ -0,0 +1,78 @@
+#include "Pch.hpp"
+
+#include "IndirectCommands.hpp"
+
+namespace nether
+{
+    IndirectDrawRecord encodeIndirectDraw(const InstancedDraw& draw, const uint32_t sceneBufferIndex, const uint32_t instanceBufferIndex)
+    {
+        const Mesh& mesh = *draw.mesh;
+        const D3D12_INDEX_BUFFER_VIEW& indexBufferView = mesh.indexBuffer.indexBufferView;
+
+        // SV_InstanceID does not include startInstanceLocation, so the shaders get the offset into the instance buffer through the root constants.
+        return IndirectDrawRecord{
+            .renderResources =
+                {
+                    .positionBufferIndex = mesh.positionBuffer.srvIndex,
+                    .textureCoordBufferIndex = mesh.textureCoordBuffer.srvIndex,
+                    .normalBufferIndex = mesh.normalBuffer.srvIndex,
+
+                    .sceneBufferIndex = sceneBufferIndex,
+                    .instanceBufferIndex = instanceBufferIndex,
+                    .instanceOffset = draw.firstInstance,
+
+                    .albedoTextureIndex = draw.albedoTextureIndex,
+                },
+            .indexBufferView =
+                {
+                    .bufferLocationLow = static_cast<uint32_t>(indexBufferView.BufferLocation),
+                    .bufferLocationHigh = static_cast<uint32_t>(indexBufferView.BufferLocation >> 32u),
+                    .sizeInBytes = indexBufferView.SizeInBytes,
+                    .format = static_cast<uint32_t>(indexBufferView.Format),
+                },
+            .drawArguments =
+                {
+                    .indexCountPerInstance = draw.indexCount,
+                    .instanceCount = draw.instanceCount,
+                    .startIndexLocation = 0u,
+                    .baseVertexLocation = 0,
+                    .startInstanceLocation = draw.firstInstance,
+                },
+        };
+    }
+
+    void IndirectCommandBuilder::build(const std::span<const InstancedDraw> draws, const uint32_t sceneBufferIndex, const uint32_t instanceBufferIndex)
+    {
+        m_records.clear();
+        m_batches.clear();
+
+        m_records.reserve(draws.size());
+
+        for (const InstancedDraw& draw : draws)
+        {
+            // The draws are sorted by pipeline (see DrawList), so each pipeline ends up as a single batch.
+            const bool canMerge = !m_batches.empty() && m_batches.back().graphicsPipeline == draw.graphicsPipeline;
+
+            if (canMerge)
+            {
+                m_batches.back().recordCount++;
+            }
+            else
+            {
+                m_batches.push_back(IndirectDrawBatch{
+                    .graphicsPipeline = draw.graphicsPipeline,
+                    .firstRecord = static_cast<uint32_t>(m_records.size()),
+                    .recordCount = 1u,
+                });
+            }
+
+            m_records.push_back(encodeIndirectDraw(draw, sceneBufferIndex, instanceBufferIndex));
+        }
+    }
+
+    void IndirectCommandBuilder::reserve(const size_t maxDrawCount)
+    {
+        m_records.reserve(maxDrawCount);
+        m_batches.reserve(maxDrawCount);
+    }
+}
@@ -0,0 +1,491 @@
+#include "Pch.hpp"
+
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace nether
+{
+    // Times a idle worker looks for jobs (yielding in between) before it goes to sleep.
+    static constexpr uint32_t IDLE_SPIN_COUNT = 64u;
+
+    // The job system and index of the worker running on this thread, so submissions from a worker go to its own deque.
+    struct WorkerContext
+    {
+        const JobSystem* jobSystem{};
+        uint32_t workerIndex{};
+
+        // Xorshift state, used to pick the first worker to steal from.
+        uint32_t randomState{};
+    };
+
+    static thread_local WorkerContext workerContext{};
+
+    // Jobs allocated by JobSystem::schedule. They free themselves after running.
+    struct ScheduledJob
+    {
+        Job job{};
+        std::function<void()> function{};
+    };
+
+    static void runScheduledJob(void* const data)
+    {
+        const std::unique_ptr<ScheduledJob> scheduledJob(static_cast<ScheduledJob*>(data));
+        scheduledJob->function();
+    }
+
+    static ScheduledJob* createScheduledJob(std::function<void()>&& function, JobCounter* const counter)
+    {
+        ScheduledJob* const scheduledJob = new ScheduledJob{.function = std::move(function)};
+        scheduledJob->job = Job{
+            .function = runScheduledJob,
+            .data = scheduledJob,
+            .counter = counter,
+        };
+
+        return scheduledJob;
+    }
+
+    static void resumeCoroutine(void* const data) { std::coroutine_handle<>::from_address(data).resume(); }
+
+    static void pinThread(std::thread& thread, const uint32_t hardwareThreadIndex)
+    {
+#ifdef _WIN32
+        SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{1u} << (hardwareThreadIndex % 64u));
+#else
+        cpu_set_t cpuSet{};
+        CPU_ZERO(&cpuSet);
+        CPU_SET(hardwareThreadIndex, &cpuSet);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+#endif
+    }
+
+    JobSystem::JobSystem(const JobSystemDesc& desc)
+    {
+        const uint32_t workerThreadCount =
+            std::min(desc.workerThreadCount == JobSystemDesc::DEFAULT_WORKER_THREAD_COUNT ? getDefaultWorkerThreadCount() : desc.workerThreadCount, MAX_WORKER_THREAD_COUNT);
+        const uint32_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+        // All deques exist before any worker starts, as workers steal from each other.
+        m_workers.reserve(workerThreadCount);
+        for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, workerThreadCount))
+        {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+
+        for (const uint32_t i : std::views::iota(0u, workerThreadCount))
+        {
+            m_workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+
+            if (desc.pinWorkerThreads)
+            {
+                pinThread(m_workers[i]->thread, (i + 1u) % hardwareThreadCount);
+            }
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        m_isShuttingDown.store(true, std::memory_order_release);
+
+        m_workEpoch.fetch_add(1u, std::memory_order_release);
+        m_workEpoch.notify_all();
+
+        for (const std::unique_ptr<Worker>& worker : m_workers)
+        {
+            worker->thread.join();
+        }
+    }
+
+    void JobSystem::schedule(std::function<void()> function, JobCounter* const counter) { submit(createScheduledJob(std::move(function), counter)->job); }
+
+    void JobSystem::scheduleAfter(JobCounter& dependency, std::function<void()> function, JobCounter* const counter)
+    {
+        submitAfter(dependency, createScheduledJob(std::move(function), counter)->job);
+    }
+
+    void JobSystem::submit(Job& job)
+    {
+        if (job.counter)
+        {
+            job.counter->m_state.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        pushJob(job);
+    }
+
+    void JobSystem::submitAfter(JobCounter& dependency, Job& job)
+    {
+        if (job.counter)
+        {
+            job.counter->m_state.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        addDependentJob(dependency, job);
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        const uint32_t workerIndex = workerContext.jobSystem == this ? workerContext.workerIndex : INVALID_WORKER_INDEX;
+
+        while (counter.m_state.load(std::memory_order_acquire) != 0u)
+        {
+            if (Job* const job = findJob(workerIndex))
+            {
+                execute(*job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (counter.m_exception)
+        {
+            std::rethrow_exception(std::exchange(counter.m_exception, nullptr));
+        }
+    }
+
+    uint32_t JobSystem::getDefaultWorkerThreadCount()
+    {
+        // hardware_concurrency can return 0 if the value is not computable.
+        return std::max(std::thread::hardware_concurrency(), 1u) - 1u;
+    }
+
+    void JobSystem::ScheduleAwaiter::await_suspend(const std::coroutine_handle<> coroutine)
+    {
+        m_job = Job{
+            .function = resumeCoroutine,
+            .data = coroutine.address(),
+        };
+
+        // The coroutine (and this awaiter with it) can be resumed and destroyed on a worker before submit returns, so nothing is accessed after it.
+        m_jobSystem.submit(m_job);
+    }
+
+    void JobSystem::workerLoop(const uint32_t workerIndex)
+    {
+        NETHER_PROFILE_THREAD(std::format("Job worker {}", workerIndex));
+
+        workerContext = WorkerContext{
+            .jobSystem = this,
+            .workerIndex = workerIndex,
+            .randomState = workerIndex + 1u,
+        };
+
+        uint32_t idleSpinCount{};
+        while (!m_isShuttingDown.load(std::memory_order_acquire))
+        {
+            if (Job* const job = findJob(workerIndex))
+            {
+                execute(*job);
+                idleSpinCount = 0u;
+                continue;
+            }
+
+            if (++idleSpinCount < IDLE_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            idleSpinCount = 0u;
+
+            // Announce the sleep before the final check for jobs, and submissions check for sleepers after pushing. With the fences in between, either this check sees
+            // the job, or the submission sees the sleeper and bumps the epoch (which makes the wait return right away).
+            const uint32_t workEpoch = m_workEpoch.load(std::memory_order_acquire);
+            m_sleepingWorkerCount.fetch_add(1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (!hasPendingJobs() && !m_isShuttingDown.load(std::memory_order_acquire))
+            {
+                m_workEpoch.wait(workEpoch, std::memory_order_acquire);
+            }
+
+            m_sleepingWorkerCount.fetch_sub(1u, std::memory_order_relaxed);
+        }
+
+        workerContext = WorkerContext{};
+    }
+
+    void JobSystem::pushJob(Job& job)
+    {
+        if (workerContext.jobSystem == this)
+        {
+            m_workers[workerContext.workerIndex]->deque.push(&job);
+        }
+        else
+        {
+            const std::scoped_lock lock(m_sharedQueueMutex);
+            m_sharedQueue.push_back(&job);
+            m_sharedQueueSize.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepingWorkerCount.load(std::memory_order_relaxed) > 0u)
+        {
+            m_workEpoch.fetch_add(1u, std::memory_order_release);
+            m_workEpoch.notify_one();
+        }
+    }
+
+    Job* JobSystem::findJob(const uint32_t workerIndex)
+    {
+        if (workerIndex != INVALID_WORKER_INDEX)
+        {
+            if (Job* const job = m_workers[workerIndex]->deque.pop())
+            {
+                return job;
+            }
+        }
+
+        if (m_sharedQueueSize.load(std::memory_order_relaxed) > 0u)
+        {
+            const std::scoped_lock lock(m_sharedQueueMutex);
+            if (!m_sharedQueue.empty())
+            {
+                Job* const job = m_sharedQueue.front();
+                m_sharedQueue.pop_front();
+                m_sharedQueueSize.fetch_sub(1u, std::memory_order_relaxed);
+
+                return job;
+            }
+        }
+
+        const uint32_t workerCount = getWorkerThreadCount();
+        if (workerCount == 0u)
+        {
+            return nullptr;
+        }
+
+        // Start at a random worker, so thieves do not all go after the same one.
+        uint32_t& randomState = workerContext.randomState;
+        randomState = randomState == 0u ? 1u : randomState;
+        randomState ^= randomState << 13u;
+        randomState ^= randomState >> 17u;
+        randomState ^= randomState << 5u;
+
+        const uint32_t firstVictimIndex = randomState % workerCount;
+        for (const uint32_t i : std::views::iota(0u, workerCount))
+        {
+            const uint32_t victimIndex = (firstVictimIndex + i) % workerCount;
+            if (victimIndex == workerIndex)
+            {
+                continue;
+            }
+
+            if (Job* const job = m_workers[victimIndex]->deque.steal())
+            {
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool JobSystem::hasPendingJobs() const
+    {
+        return m_sharedQueueSize.load(std::memory_order_relaxed) > 0u ||
+               std::ranges::any_of(m_workers, [](const std::unique_ptr<Worker>& worker) { return !worker->deque.isEmpty(); });
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        // The job can be freed by its function (scheduled jobs free themselves, and resuming a coroutine can destroy the frame the job lives in).
+        JobCounter* const counter = job.counter;
+
+        try
+        {
+            job.function(job.data);
+        }
+        catch (...)
+        {
+            if (!counter)
+            {
+                throw;
+            }
+
+            // Spin lock on the counter, which is alive as this job has not finished yet.
+            uint32_t state = counter->m_state.load(std::memory_order_relaxed);
+            while ((state & JobCounter::LOCKED_BIT) ||
+                   !counter->m_state.compare_exchange_weak(state, state | JobCounter::LOCKED_BIT, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                state = counter->m_state.load(std::memory_order_relaxed);
+            }
+
+            if (!counter->m_exception)
+            {
+                counter->m_exception = std::current_exception();
+            }
+
+            counter->m_state.fetch_and(~JobCounter::LOCKED_BIT, std::memory_order_release);
+        }
+
+        if (counter)
+        {
+            finishJob(*counter);
+        }
+    }
+
+    void JobSystem::finishJob(JobCounter& counter)
+    {
+        const uint32_t previousState = counter.m_state.fetch_sub(1u, std::memory_order_acq_rel);
+        if ((previousState & JobCounter::COUNT_MASK) != 1u || !(previousState & JobCounter::HAS_DEPENDENT_JOBS_BIT))
+        {
+            return;
+        }
+
+        // Last job, and there are dependent jobs. The counter does not read as done until the flag is cleared below, so it is still alive.
+        uint32_t state = counter.m_state.load(std::memory_order_relaxed);
+        while ((state & JobCounter::LOCKED_BIT) ||
+               !counter.m_state.compare_exchange_weak(state, state | JobCounter::LOCKED_BIT, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            state = counter.m_state.load(std::memory_order_relaxed);
+        }
+
+        std::vector<Job*> dependentJobs = std::move(counter.m_dependentJobs);
+        counter.m_dependentJobs.clear();
+
+        // Last access to the counter.
+        counter.m_state.fetch_and(~(JobCounter::LOCKED_BIT | JobCounter::HAS_DEPENDENT_JOBS_BIT), std::memory_order_release);
+
+        for (Job* const job : dependentJobs)
+        {
+            pushJob(*job);
+        }
+    }
+
+    void JobSystem::addDependentJob(JobCounter& dependency, Job& job)
+    {
+        // Lock the counter and set the flag in one step, unless it is already done, so a job finishing in between cannot miss the dependent job.
+        uint32_t state = dependency.m_state.load(std::memory_order_acquire);
+        while (true)
+        {
+            if (state == 0u)
+            {
+                pushJob(job);
+                return;
+            }
+
+            if (state & JobCounter::LOCKED_BIT)
+            {
+                state = dependency.m_state.load(std::memory_order_acquire);
+                continue;
+            }
+
+            if (dependency.m_state.compare_exchange_weak(
+                    state, state | JobCounter::LOCKED_BIT | JobCounter::HAS_DEPENDENT_JOBS_BIT, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                break;
+            }
+        }
+
+        dependency.m_dependentJobs.push_back(&job);
+        dependency.m_state.fetch_and(~JobCounter::LOCKED_BIT, std::memory_order_release);
+    }
+
+    // Shared by the threads of a parallelFor, lives on the calling thread's stack.
+    struct ParallelForState
+    {
+        std::atomic<uint64_t> nextIndex{};
+
+        uint32_t count{};
+        uint32_t minBatchSize{};
+        uint32_t threadCount{};
+
+        void (*rangeFunction)(void* data, const uint32_t begin, const uint32_t end){};
+        void* data{};
+    };
+
+    static void runParallelForBatches(void* const data)
+    {
+        ParallelForState& state = *static_cast<ParallelForState*>(data);
+
+        while (true)
+        {
+            // Half of each thread's share of the remaining items (guided scheduling). The load can be stale, which only changes the batch size.
+            const uint64_t remainingCount = state.count - std::min<uint64_t>(state.nextIndex.load(std::memory_order_relaxed), state.count);
+            const uint64_t batchSize = std::max<uint64_t>(state.minBatchSize, remainingCount / (2u * state.threadCount));
+
+            const uint64_t begin = state.nextIndex.fetch_add(batchSize, std::memory_order_relaxed);
+            if (begin >= state.count)
+            {
+                return;
+            }
+
+            state.rangeFunction(state.data, static_cast<uint32_t>(begin), static_cast<uint32_t>(std::min<uint64_t>(begin + batchSize, state.count)));
+        }
+    }
+
+    void JobSystem::parallelFor(const uint32_t count, const uint32_t minBatchSize, const RangeFunction rangeFunction, void* const data)
+    {
+        if (count == 0u)
+        {
+            return;
+        }
+
+        const uint32_t batchSize = std::max(minBatchSize, 1u);
+        const uint32_t maxBatchCount = count / batchSize + (count % batchSize != 0u ? 1u : 0u);
+        const uint32_t threadCount = std::min(maxBatchCount, getThreadCount());
+
+        if (threadCount == 1u)
+        {
+            rangeFunction(data, 0u, count);
+            return;
+        }
+
+        ParallelForState state{
+            .count = count,
+            .minBatchSize = batchSize,
+            .threadCount = threadCount,
+            .rangeFunction = rangeFunction,
+            .data = data,
+        };
+
+        // One job per helping thread, which keeps grabbing batches until there are none left.
+        JobCounter counter{};
+        std::array<Job, MAX_WORKER_THREAD_COUNT> helperJobs{};
+        for (const uint32_t i : std::views::iota(0u, threadCount - 1u))
+        {
+            helperJobs[i] = Job{
+                .function = runParallelForBatches,
+                .data = &state,
+                .counter = &counter,
+            };
+
+            submit(helperJobs[i]);
+        }
+
+        // The helpers use the state on this stack, so they are waited for even if this thread throws.
+        std::exception_ptr exception{};
+        try
+        {
+            runParallelForBatches(&state);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+            state.nextIndex.store(count, std::memory_order_relaxed);
+        }
+
+        try
+        {
+            wait(counter);
+        }
+        catch (...)
+        {
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
@@ -0,0 +1,467 @@
+#include "Pch.hpp"
+
+#include "JsonReader.hpp"
+#include "CpuFeatures.hpp"
+
+#include <immintrin.h>
+
+namespace nether
+{
+    static bool isWhitespace(const char character) { return character == ' ' || character == '\n' || character == '\r' || character == '\t'; }
+
+    static bool isStructural(const char character)
+    {
+        return character == '{' || character == '}' || character == '[' || character == ']' || character == ':' || character == ',';
+    }
+
+    static bool isHexDigits(const std::string_view digits)
+    {
+        return digits.size() == 4u && std::ranges::all_of(digits, [](const char digit) { return std::isxdigit(static_cast<unsigned char>(digit)) != 0; });
+    }
+
+    // Only used by CPUs with AVX2 (see classifyBlockAvx2).
+    NETHER_AVX2_FUNCTION NETHER_FORCE_INLINE uint64_t getBlockMask(const __m256i low, const __m256i high)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(low))) | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32u);
+    }
+
+    NETHER_AVX2_FUNCTION NETHER_FORCE_INLINE uint64_t getEqualMask(const __m256i low, const __m256i high, const char character)
+    {
+        const __m256i characters = _mm256_set1_epi8(character);
+        return getBlockMask(_mm256_cmpeq_epi8(low, characters), _mm256_cmpeq_epi8(high, characters));
+    }
+
+    NETHER_AVX2_FUNCTION JsonTokenizer::BlockMasks JsonTokenizer::classifyBlockAvx2(const char* const block)
+    {
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32u));
+
+        // '[' and ']' are '{' and '}' without the 0x20 bit.
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i lowBrackets = _mm256_or_si256(low, caseBit);
+        const __m256i highBrackets = _mm256_or_si256(high, caseBit);
+
+        // Unsigned character <= 0x1F.
+        const __m256i maxControl = _mm256_set1_epi8(0x1F);
+        const uint64_t control = getBlockMask(_mm256_cmpeq_epi8(_mm256_min_epu8(low, maxControl), low), _mm256_cmpeq_epi8(_mm256_min_epu8(high, maxControl), high));
+
+        return BlockMasks{
+            .quote = getEqualMask(low, high, '"'),
+            .backslash = getEqualMask(low, high, '\\'),
+            .structural = getEqualMask(lowBrackets, highBrackets, '{') | getEqualMask(lowBrackets, highBrackets, '}') | getEqualMask(low, high, ':') |
+                          getEqualMask(low, high, ','),
+            .whitespace = getEqualMask(low, high, ' ') | getEqualMask(low, high, '\n') | getEqualMask(low, high, '\r') | getEqualMask(low, high, '\t'),
+            .control = control,
+        };
+    }
+
+    JsonTokenizer::BlockMasks JsonTokenizer::classifyBlockScalar(const char* const block)
+    {
+        BlockMasks masks{};
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(BLOCK_SIZE)))
+        {
+            const char character = block[i];
+            const uint64_t bit = uint64_t{1u} << i;
+
+            masks.quote |= character == '"' ? bit : 0u;
+            masks.backslash |= character == '\\' ? bit : 0u;
+            masks.structural |= isStructural(character) ? bit : 0u;
+            masks.whitespace |= isWhitespace(character) ? bit : 0u;
+            masks.control |= static_cast<unsigned char>(character) < 0x20u ? bit : 0u;
+        }
+
+        return masks;
+    }
+
+    // Bit i of the result is the xor of bits 0 to i, so it is set between an opening quote (included) and its closing quote (excluded).
+    static uint64_t prefixXor(uint64_t bits)
+    {
+        bits ^= bits << 1u;
+        bits ^= bits << 2u;
+        bits ^= bits << 4u;
+        bits ^= bits << 8u;
+        bits ^= bits << 16u;
+        bits ^= bits << 32u;
+
+        return bits;
+    }
+
+    JsonTokenizer::JsonTokenizer(const std::string_view json) : m_json(json), m_isAvx2Supported(CpuFeatures::isAvx2Supported()) {}
+
+    bool JsonTokenizer::tokenizeWindow(std::vector<uint64_t>& tokens)
+    {
+        // Windows are whole blocks, so only the last block of the JSON can be partial. It is padded with whitespace.
+        const uint64_t windowEnd = std::min(m_position + WINDOW_SIZE, static_cast<uint64_t>(m_json.size()));
+
+        for (; m_position + BLOCK_SIZE <= windowEnd; m_position += BLOCK_SIZE)
+        {
+            tokenizeBlock(m_json.data() + m_position, m_position, tokens);
+        }
+
+        if (m_position < windowEnd)
+        {
+            std::array<char, BLOCK_SIZE> block{};
+            block.fill(' ');
+            std::memcpy(block.data(), m_json.data() + m_position, windowEnd - m_position);
+
+            tokenizeBlock(block.data(), m_position, tokens);
+            m_position = windowEnd;
+        }
+
+        if (m_position < m_json.size())
+        {
+            return true;
+        }
+
+        if (m_isInString != 0u)
+        {
+            fatalError("Malformed JSON : unterminated string.");
+        }
+
+        // A backslash that ends the last block has no character to escape.
+        if (m_isEscaped != 0u)
+        {
+            fatalError(std::format("Malformed JSON at offset {} : invalid escape sequence.", m_json.size()));
+        }
+
+        tokens.push_back(m_json.size());
+        return false;
+    }
+
+    void JsonTokenizer::tokenizeBlock(const char* const block, const uint64_t blockOffset, std::vector<uint64_t>& tokens)
+    {
+        const BlockMasks masks = m_isAvx2Supported ? classifyBlockAvx2(block) : classifyBlockScalar(block);
+
+        // A backslash that is not escaped escapes the next character. Backslashes are rare in glTF, so they are handled one by one.
+        uint64_t escaped = m_isEscaped;
+        if (m_isEscaped != 0u)
+        {
+            validateEscape(block, 0u, blockOffset);
+        }
+
+        m_isEscaped = 0u;
+
+        uint64_t escapes = masks.backslash & ~escaped;
+        while (escapes != 0u)
+        {
+            const uint32_t index = static_cast<uint32_t>(std::countr_zero(escapes));
+            if (index == BLOCK_SIZE - 1u)
+            {
+                m_isEscaped = 1u;
+                break;
+            }
+
+            escaped |= uint64_t{1u} << (index + 1u);
+            validateEscape(block, index + 1u, blockOffset);
+
+            // The escaped character does not start an escape, even if it is a backslash.
+            escapes &= ~(uint64_t{3u} << index);
+        }
+
+        const uint64_t quotes = masks.quote & ~escaped;
+        const uint64_t inString = prefixXor(quotes) ^ m_isInString;
+        m_isInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63u);
+
+        if ((masks.control & inString) != 0u)
+        {
+            fatalError(std::format("Malformed JSON at offset {} : control character in string.", blockOffset + std::countr_zero(masks.control & inString)));
+        }
+
+        // Numbers and literals are everything else outside of strings. Only their first character is a token.
+        const uint64_t scalars = ~(masks.structural | masks.whitespace | quotes | inString);
+        const uint64_t scalarStarts = scalars & ~((scalars << 1u) | m_isAfterScalar);
+        m_isAfterScalar = scalars >> 63u;
+
+        uint64_t blockTokens = (masks.structural & ~inString) | (quotes & inString) | scalarStarts;
+        while (blockTokens != 0u)
+        {
+            tokens.push_back(blockOffset + static_cast<uint64_t>(std::countr_zero(blockTokens)));
+            blockTokens &= blockTokens - 1u;
+        }
+    }
+
+    void JsonTokenizer::validateEscape(const char* const block, const uint32_t index, const uint64_t blockOffset) const
+    {
+        const uint64_t offset = blockOffset + index;
+
+        const bool isValid = offset < m_json.size() && std::string_view("\"\\/bfnrtu").find(block[index]) != std::string_view::npos &&
+                             (block[index] != 'u' || isHexDigits(m_json.substr(std::min<uint64_t>(offset + 1u, m_json.size()), 4u)));
+        if (!isValid)
+        {
+            fatalError(std::format("Malformed JSON at offset {} : invalid escape sequence.", offset));
+        }
+    }
+
+    JsonReader::JsonReader(const std::string_view json) : m_json(json), m_tokenizer(json)
+    {
+        m_tokens.reserve(JsonTokenizer::WINDOW_SIZE + 1u);
+        fillTokens();
+    }
+
+    uint64_t JsonReader::readUnsigned()
+    {
+        const std::string_view number = readScalar();
+
+        uint64_t value{};
+        const auto [end, error] = std::from_chars(number.data(), number.data() + number.size(), value);
+
+        const bool hasLeadingZero = number.size() > 1u && number.front() == '0';
+        check(error == std::errc{} && end == number.data() + number.size() && !hasLeadingZero, "expected an unsigned integer");
+
+        return value;
+    }
+
+    uint32_t JsonReader::readIndex()
+    {
+        const uint64_t index = readUnsigned();
+        check(index < std::numeric_limits<uint32_t>::max(), "index out of range");
+
+        return static_cast<uint32_t>(index);
+    }
+
+    std::string_view JsonReader::readRawString()
+    {
+        check(peek() == '"', "expected a string");
+
+        // The closing quote is the last character before the next token that is not whitespace, as anything else outside of a string would be a token.
+        const uint64_t start = getTokenPosition() + 1u;
+
+        uint64_t end = getNextTokenPosition();
+        while (end > start && isWhitespace(m_json[end - 1u]))
+        {
+            --end;
+        }
+
+        check(end > start && m_json[end - 1u] == '"', "unexpected characters after a string");
+        ++m_tokenIndex;
+
+        return m_json.substr(start, end - 1u - start);
+    }
+
+    // Code points are at most 0x10FFFF, 4 bytes of UTF-8.
+    static void appendUtf8(std::string& string, const uint32_t codePoint)
+    {
+        if (codePoint < 0x80u)
+        {
+            string.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800u)
+        {
+            string.push_back(static_cast<char>(0xC0u | (codePoint >> 6u)));
+            string.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+        }
+        else if (codePoint < 0x10000u)
+        {
+            string.push_back(static_cast<char>(0xE0u | (codePoint >> 12u)));
+            string.push_back(static_cast<char>(0x80u | ((codePoint >> 6u) & 0x3Fu)));
+            string.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+        }
+        else
+        {
+            string.push_back(static_cast<char>(0xF0u | (codePoint >> 18u)));
+            string.push_back(static_cast<char>(0x80u | ((codePoint >> 12u) & 0x3Fu)));
+            string.push_back(static_cast<char>(0x80u | ((codePoint >> 6u) & 0x3Fu)));
+            string.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+        }
+    }
+
+    std::string JsonReader::readString()
+    {
+        // Escape sequences were validated by the tokenizer.
+        const std::string_view rawString = readRawString();
+
+        const auto parseHex4 = [&](const size_t offset)
+        {
+            uint32_t value{};
+            std::from_chars(rawString.data() + offset, rawString.data() + offset + 4u, value, 16);
+
+            return value;
+        };
+
+        std::string string{};
+        string.reserve(rawString.size());
+
+        for (size_t i = 0u; i < rawString.size(); ++i)
+        {
+            if (rawString[i] != '\\')
+            {
+                string.push_back(rawString[i]);
+                continue;
+            }
+
+            const char escape = rawString[++i];
+            switch (escape)
+            {
+                case 'b':
+                    string.push_back('\b');
+                    break;
+                case 'f':
+                    string.push_back('\f');
+                    break;
+                case 'n':
+                    string.push_back('\n');
+                    break;
+                case 'r':
+                    string.push_back('\r');
+                    break;
+                case 't':
+                    string.push_back('\t');
+                    break;
+                case 'u':
+                    {
+                        uint32_t codePoint = parseHex4(i + 1u);
+                        i += 4u;
+
+                        // Code points above the basic multilingual plane are escaped as a surrogate pair.
+                        if (codePoint >= 0xD800u && codePoint < 0xDC00u && rawString.substr(i + 1u, 2u) == "\\u")
+                        {
+                            const uint32_t lowSurrogate = parseHex4(i + 3u);
+                            if (lowSurrogate >= 0xDC00u && lowSurrogate < 0xE000u)
+                            {
+                                codePoint = 0x10000u + ((codePoint - 0xD800u) << 10u) + (lowSurrogate - 0xDC00u);
+                                i += 6u;
+                            }
+                        }
+
+                        appendUtf8(string, codePoint);
+                    }
+                    break;
+                default:
+                    string.push_back(escape);
+                    break;
+            }
+        }
+
+        return string;
+    }
+
+    void JsonReader::expectEnd()
+    {
+        fillTokens();
+        check(getTokenPosition() == m_json.size(), "unexpected characters after the top level value");
+    }
+
+    void JsonReader::reportError(const std::string_view message) const
+    {
+        fatalError(std::format("Malformed JSON at offset {} : {}.", m_tokenIndex < m_tokens.size() ? getTokenPosition() : m_json.size(), message));
+    }
+
+    void JsonReader::reportExpected(const char character) const { reportError(std::format("expected '{}'", character)); }
+
+    void JsonReader::fillTokens()
+    {
+        if (m_tokenIndex + 1u < m_tokens.size() || m_isTokenized)
+        {
+            return;
+        }
+
+        m_tokens.erase(m_tokens.begin(), m_tokens.begin() + static_cast<ptrdiff_t>(m_tokenIndex));
+        m_tokenIndex = 0u;
+
+        // A window can have no tokens at all (e.g. in a long string).
+        while (m_tokenIndex + 1u >= m_tokens.size() && !m_isTokenized)
+        {
+            m_isTokenized = !m_tokenizer.tokenizeWindow(m_tokens);
+        }
+    }
+
+    std::string_view JsonReader::readScalar()
+    {
+        const char character = peek();
+        check(!isStructural(character) && character != '"', "expected a number or a literal");
+
+        const uint64_t start = getTokenPosition();
+
+        uint64_t end = getNextTokenPosition();
+        while (end > start && isWhitespace(m_json[end - 1u]))
+        {
+            --end;
+        }
+
+        ++m_tokenIndex;
+
+        return m_json.substr(start, end - start);
+    }
+
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    static bool isNumber(const std::string_view number)
+    {
+        const char* position = number.data();
+        const char* const end = number.data() + number.size();
+
+        const auto isDigit = [&]() { return position != end && *position >= '0' && *position <= '9'; };
+        const auto skipDigits = [&]()
+        {
+            const char* const start = position;
+            while (isDigit())
+            {
+                ++position;
+            }
+
+            return position != start;
+        };
+
+        if (position != end && *position == '-')
+        {
+            ++position;
+        }
+
+        if (position != end && *position == '0')
+        {
+            ++position;
+        }
+        else if (!skipDigits())
+        {
+            return false;
+        }
+
+        if (position != end && *position == '.')
+        {
+            ++position;
+            if (!skipDigits())
+            {
+                return false;
+            }
+        }
+
+        if (position != end && (*position == 'e' || *position == 'E'))
+        {
+            ++position;
+            if (position != end && (*position == '+' || *position == '-'))
+            {
+                ++position;
+            }
+
+            if (!skipDigits())
+            {
+                return false;
+            }
+        }
+
+        return position == end;
+    }
+
+    void JsonReader::skipValue(const uint32_t depth)
+    {
+        check(depth < MAX_NESTING_DEPTH, "nesting too deep");
+
+        switch (peek())
+        {
+            case '{':
+                readObject([&](std::string_view) { skipValue(depth + 1u); });
+                break;
+            case '[':
+                readArray([&]() { skipValue(depth + 1u); });
+                break;
+            case '"':
+                readRawString();
+                break;
+            default:
+                {
+                    const std::string_view scalar = readScalar();
+                    check(isNumber(scalar) || scalar == "true" || scalar == "false" || scalar == "null", "invalid number or literal");
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "Pch.hpp"
+
+#include "LinearArena.hpp"
+
+namespace nether
+{
+    static size_t alignUp(const size_t value, const size_t alignment) { return (value + alignment - 1u) & ~(alignment - 1u); }
+
+    // Blocks are allocated with the default new alignment, larger alignments are handled by padding (see allocateFromNextBlock).
+    static std::unique_ptr<std::byte[]> allocateBlock(const size_t size) { return std::unique_ptr<std::byte[]>(new std::byte[size]); }
+
+    LinearArena::LinearArena(const size_t initialCapacity)
+    {
+        const size_t capacity = std::max<size_t>(initialCapacity, 1u);
+        m_blocks.push_back(Block{allocateBlock(capacity), capacity});
+    }
+
+    void* LinearArena::allocate(const size_t size, const size_t alignment)
+    {
+        Block& block = m_blocks[m_blockIndex];
+
+        // Aligned in address space, as the block's own alignment can be lower than the requested one.
+        const uintptr_t blockAddress = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t alignedOffset = alignUp(blockAddress + m_offset, alignment) - blockAddress;
+
+        if (alignedOffset + size > block.size)
+        {
+            return allocateFromNextBlock(size, alignment);
+        }
+
+        m_offset = alignedOffset + size;
+        m_highWatermark = std::max(m_highWatermark, getUsedSize());
+
+        return block.data.get() + alignedOffset;
+    }
+
+    void LinearArena::rewind(const Marker marker)
+    {
+        m_blockIndex = marker.blockIndex;
+        m_offset = marker.offset;
+    }
+
+    void LinearArena::reset()
+    {
+        // One block that fits everything that was in use at once, so in steady state nothing is chained.
+        if (m_blocks.size() > 1u || m_blocks.front().size < m_highWatermark)
+        {
+            const size_t capacity = std::max(getCapacity(), m_highWatermark);
+
+            m_blocks.clear();
+            m_blocks.push_back(Block{allocateBlock(capacity), capacity});
+        }
+
+        m_blockIndex = 0u;
+        m_offset = 0u;
+    }
+
+    void LinearArena::reserve(const size_t capacity)
+    {
+        m_highWatermark = std::max(m_highWatermark, capacity);
+
+        if (m_blockIndex == 0u && m_offset == 0u)
+        {
+            reset();
+        }
+    }
+
+    size_t LinearArena::getUsedSize() const
+    {
+        size_t usedSize = m_offset;
+        for (const size_t i : std::views::iota(size_t{0u}, m_blockIndex))
+        {
+            usedSize += m_blocks[i].size;
+        }
+
+        return usedSize;
+    }
+
+    size_t LinearArena::getCapacity() const
+    {
+        size_t capacity{};
+        for (const Block& block : m_blocks)
+        {
+            capacity += block.size;
+        }
+
+        return capacity;
+    }
+
+    void* LinearArena::allocateFromNextBlock(const size_t size, const size_t alignment)
+    {
+        // Blocks after the current one are left over from before a rewind, and reused if large enough. Those that are too small stay unused until the next reset.
+        const size_t requiredSize = size + alignment;
+        while (++m_blockIndex < m_blocks.size())
+        {
+            if (m_blocks[m_blockIndex].size >= requiredSize)
+            {
+                m_offset = 0u;
+                return allocate(size, alignment);
+            }
+        }
+
+        // Blocks double in size, so an arena that keeps overflowing chains few of them.
+        const size_t blockSize = std::max(m_blocks.back().size * 2u, requiredSize);
+        m_blocks.push_back(Block{allocateBlock(blockSize), blockSize});
+
+        m_blockIndex = m_blocks.size() - 1u;
+        m_offset = 0u;
+
+        return allocate(size, alignment);
+    }
+
+    LinearArena& getScratchArena()
+    {
+        static thread_local LinearArena scratchArena(256u * 1024u);
+        return scratchArena;
+    }
+
+    ScratchScope::~ScratchScope()
+    {
+        // Leaving the outermost scope is the only point where nothing is in use, which is when the blocks can be merged.
+        if (m_marker.blockIndex == 0u && m_marker.offset == 0u)
+        {
+            m_arena.reset();
+        }
+        else
+        {
+            m_arena.rewind(m_marker);
+        }
+    }
+}
@@ -0,0 +1,215 @@
+#include "Pch.hpp"
+
+#include "Lz4.hpp"
+
+namespace nether::Lz4
+{
+    static constexpr size_t MIN_MATCH_LENGTH = 4u;
+    static constexpr size_t MAX_OFFSET = 65535u;
+
+    // End of block rules of the format : the last 5 bytes are always literals, and the last match starts at least 12 bytes before the end.
+    static constexpr size_t LAST_LITERAL_COUNT = 5u;
+    static constexpr size_t MATCH_FIND_LIMIT = 12u;
+
+    static constexpr uint32_t HASH_TABLE_BITS = 16u;
+
+    static uint32_t read32(const std::byte* const data)
+    {
+        uint32_t value{};
+        std::memcpy(&value, data, sizeof(uint32_t));
+
+        return value;
+    }
+
+    static uint32_t hashSequence(const uint32_t sequence) { return (sequence * 2654435761u) >> (32u - HASH_TABLE_BITS); }
+
+    // Lengths that do not fit in the 4 bits of the token continue in bytes of 255, ended by a byte below 255.
+    static void writeLength(std::vector<std::byte>& compressedData, size_t length)
+    {
+        for (; length >= 255u; length -= 255u)
+        {
+            compressedData.push_back(std::byte{255u});
+        }
+
+        compressedData.push_back(static_cast<std::byte>(length));
+    }
+
+    // A match length of 0 writes the last sequence of the block, which only has literals.
+    static void writeSequence(std::vector<std::byte>& compressedData, const std::span<const std::byte> literals, const size_t offset, const size_t matchLength)
+    {
+        const size_t literalLength = literals.size();
+        const size_t encodedMatchLength = matchLength == 0u ? 0u : matchLength - MIN_MATCH_LENGTH;
+
+        compressedData.push_back(static_cast<std::byte>((std::min<size_t>(literalLength, 15u) << 4u) | std::min<size_t>(encodedMatchLength, 15u)));
+        if (literalLength >= 15u)
+        {
+            writeLength(compressedData, literalLength - 15u);
+        }
+
+        compressedData.insert(compressedData.end(), literals.begin(), literals.end());
+
+        if (matchLength == 0u)
+        {
+            return;
+        }
+
+        compressedData.push_back(static_cast<std::byte>(offset & 0xffu));
+        compressedData.push_back(static_cast<std::byte>(offset >> 8u));
+
+        if (encodedMatchLength >= 15u)
+        {
+            writeLength(compressedData, encodedMatchLength - 15u);
+        }
+    }
+
+    std::vector<std::byte> compress(const std::span<const std::byte> data)
+    {
+        std::vector<std::byte> compressedData{};
+        if (data.empty())
+        {
+            return compressedData;
+        }
+
+        compressedData.reserve(data.size() + data.size() / 255u + 16u);
+
+        // Positions are stored plus one, so 0 is an empty slot.
+        std::vector<uint32_t> hashTable(size_t{1u} << HASH_TABLE_BITS);
+
+        const std::byte* const source = data.data();
+        const size_t matchFindEnd = data.size() > MATCH_FIND_LIMIT ? data.size() - MATCH_FIND_LIMIT : 0u;
+        const size_t matchEnd = data.size() - std::min(data.size(), LAST_LITERAL_COUNT);
+
+        size_t anchor{};
+        size_t position{};
+        while (position < matchFindEnd)
+        {
+            const uint32_t sequence = read32(source + position);
+            uint32_t& hashEntry = hashTable[hashSequence(sequence)];
+
+            const size_t candidate = hashEntry;
+            hashEntry = static_cast<uint32_t>(position + 1u);
+
+            if (candidate == 0u || position - (candidate - 1u) > MAX_OFFSET || read32(source + candidate - 1u) != sequence)
+            {
+                // Skips ahead faster the longer no match was found, which keeps incompressible data cheap.
+                position += 1u + ((position - anchor) >> 6u);
+                continue;
+            }
+
+            const size_t matchPosition = candidate - 1u;
+
+            size_t matchLength = MIN_MATCH_LENGTH;
+            while (position + matchLength < matchEnd && source[matchPosition + matchLength] == source[position + matchLength])
+            {
+                ++matchLength;
+            }
+
+            writeSequence(compressedData, data.subspan(anchor, position - anchor), position - matchPosition, matchLength);
+
+            position += matchLength;
+            anchor = position;
+
+            if (position - 2u < matchFindEnd)
+            {
+                hashTable[hashSequence(read32(source + position - 2u))] = static_cast<uint32_t>(position - 1u);
+            }
+        }
+
+        writeSequence(compressedData, data.subspan(anchor), 0u, 0u);
+
+        return compressedData;
+    }
+
+    static void checkBlock(const bool condition)
+    {
+        if (!condition)
+        {
+            fatalError("Malformed LZ4 block.");
+        }
+    }
+
+    static size_t readLength(const std::span<const std::byte> compressedData, size_t& position, size_t length)
+    {
+        std::byte lengthByte{255u};
+        while (lengthByte == std::byte{255u})
+        {
+            checkBlock(position < compressedData.size());
+
+            lengthByte = compressedData[position++];
+            length += static_cast<size_t>(lengthByte);
+        }
+
+        return length;
+    }
+
+    void decompress(const std::span<const std::byte> compressedData, const std::span<std::byte> data)
+    {
+        if (compressedData.empty())
+        {
+            checkBlock(data.empty());
+            return;
+        }
+
+        size_t inputPosition{};
+        size_t outputPosition{};
+
+        while (true)
+        {
+            checkBlock(inputPosition < compressedData.size());
+            const uint32_t token = static_cast<uint32_t>(compressedData[inputPosition++]);
+
+            size_t literalLength = token >> 4u;
+            if (literalLength == 15u)
+            {
+                literalLength = readLength(compressedData, inputPosition, literalLength);
+            }
+
+            checkBlock(literalLength <= compressedData.size() - inputPosition && literalLength <= data.size() - outputPosition);
+
+            std::memcpy(data.data() + outputPosition, compressedData.data() + inputPosition, literalLength);
+            inputPosition += literalLength;
+            outputPosition += literalLength;
+
+            // The last sequence ends the block after its literals.
+            if (inputPosition == compressedData.size())
+            {
+                break;
+            }
+
+            checkBlock(compressedData.size() - inputPosition >= 2u);
+            const size_t offset = static_cast<size_t>(compressedData[inputPosition]) | (static_cast<size_t>(compressedData[inputPosition + 1u]) << 8u);
+            inputPosition += 2u;
+
+            checkBlock(offset != 0u && offset <= outputPosition);
+
+            size_t matchLength = token & 0xfu;
+            if (matchLength == 15u)
+            {
+                matchLength = readLength(compressedData, inputPosition, matchLength);
+            }
+
+            matchLength += MIN_MATCH_LENGTH;
+            checkBlock(matchLength <= data.size() - outputPosition);
+
+            std::byte* const output = data.data() + outputPosition;
+            const std::byte* const match = output - offset;
+
+            // Matches closer than their length overlap the bytes they write, and repeat them.
+            if (offset >= matchLength)
+            {
+                std::memcpy(output, match, matchLength);
+            }
+            else
+            {
+                for (size_t i = 0u; i < matchLength; ++i)
+                {
+                    output[i] = match[i];
+                }
+            }
+
+            outputPosition += matchLength;
+        }
+
+        checkBlock(outputPosition == data.size());
+    }
+}
@@ -12,7 +12,10 @@ int main()
     }
     catch (const std::exception& exception)
     {
+        // fatalError only throws, the error is reported here.
         std::cout << "[Exception Caught] : " << exception.what() << std::endl;
+        ::MessageBoxW(nullptr, stringToWString(exception.what()).c_str(), L"ERROR!", MB_OK | MB_ICONEXCLAMATION);
+
         return -1;
     }
 
@@ -0,0 +1,146 @@
+#include "Pch.hpp"
+
+#include "MappedFile.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nether
+{
+    MappedFile::MappedFile(const std::string_view filePath)
+    {
+        const std::string path(filePath);
+
+#ifdef _WIN32
+        const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            fatalError(std::format("Failed to open file with path : {}", filePath));
+        }
+
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(file, &fileSize);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+
+        // Zero sized files can not be mapped. The view keeps the mapping alive, so both handles are closed right away.
+        if (m_size != 0u)
+        {
+            const HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+            m_data = fileMapping ? static_cast<const std::byte*>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0u, 0u, 0u)) : nullptr;
+
+            if (fileMapping)
+            {
+                CloseHandle(fileMapping);
+            }
+        }
+
+        CloseHandle(file);
+#else
+        const int32_t file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+        {
+            fatalError(std::format("Failed to open file with path : {}", filePath));
+        }
+
+        struct stat fileStatus{};
+        fstat(file, &fileStatus);
+        m_size = static_cast<size_t>(fileStatus.st_size);
+
+        // Zero sized files can not be mapped. The mapping keeps the file open, so the descriptor is closed right away.
+        if (m_size != 0u)
+        {
+            void* const data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+            m_data = data != MAP_FAILED ? static_cast<const std::byte*>(data) : nullptr;
+        }
+
+        close(file);
+#endif
+
+        if (m_size != 0u && !m_data)
+        {
+            fatalError(std::format("Failed to map file with path : {}", filePath));
+        }
+    }
+
+    MappedFile::~MappedFile() { unmap(); }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0u)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0u);
+        }
+
+        return *this;
+    }
+
+    void MappedFile::prefetch(const std::span<const std::byte> range) const
+    {
+        if (range.empty())
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        WIN32_MEMORY_RANGE_ENTRY memoryRange = {
+            .VirtualAddress = const_cast<std::byte*>(range.data()),
+            .NumberOfBytes = range.size(),
+        };
+
+        PrefetchVirtualMemory(GetCurrentProcess(), 1u, &memoryRange, 0u);
+#else
+        // madvise takes page aligned addresses. The mapping starts on a page, so rounding down stays inside of it.
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t rangeStart = reinterpret_cast<uintptr_t>(range.data()) & ~(pageSize - 1u);
+        const uintptr_t rangeEnd = reinterpret_cast<uintptr_t>(range.data() + range.size());
+
+        madvise(reinterpret_cast<void*>(rangeStart), rangeEnd - rangeStart, MADV_WILLNEED);
+#endif
+    }
+
+    void MappedFile::release(const std::span<const std::byte> range) const
+    {
+#ifdef _WIN32
+        // Unlocking pages that are not locked removes them from the working set.
+        if (!range.empty())
+        {
+            VirtualUnlock(const_cast<std::byte*>(range.data()), range.size());
+        }
+#else
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t rangeStart = reinterpret_cast<uintptr_t>(range.data()) & ~(pageSize - 1u);
+        const uintptr_t rangeEnd = reinterpret_cast<uintptr_t>(range.data() + range.size()) & ~(pageSize - 1u);
+
+        if (rangeEnd > rangeStart)
+        {
+            madvise(reinterpret_cast<void*>(rangeStart), rangeEnd - rangeStart, MADV_DONTNEED);
+        }
+#endif
+    }
+
+    void MappedFile::unmap()
+    {
+        if (!m_data)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+
+        m_data = nullptr;
+        m_size = 0u;
+    }
+}
@@ -0,0 +1,238 @@
+#include "Pch.hpp"
+
+#include "NullGraphicsBackend.hpp"
+
+namespace nether
+{
+    void NullCommandRecorder::setGraphicsPipeline(const GraphicsPipeline& graphicsPipeline)
+    {
+        m_graphicsPipeline = &graphicsPipeline;
+        m_statistics.pipelineChangeCount++;
+    }
+
+    void NullCommandRecorder::drawIndirect(const uint32_t firstRecord, const uint32_t recordCount)
+    {
+        if (!m_isRecording)
+        {
+            fatalError("Draw recorded into a chunk that was not begun this frame.");
+        }
+
+        if (!m_graphicsPipeline)
+        {
+            fatalError("Draw recorded without a graphics pipeline set.");
+        }
+
+        if (static_cast<uint64_t>(firstRecord) + recordCount > m_indirectDrawRecords.size())
+        {
+            fatalError(std::format("Draw reads records {} to {}, but the indirect command buffer only holds {}.", firstRecord, firstRecord + recordCount, m_indirectDrawRecords.size()));
+        }
+
+        // Every record must stay inside the index buffer it binds, just like the GPU would read it.
+        for (const IndirectDrawRecord& record : m_indirectDrawRecords.subspan(firstRecord, recordCount))
+        {
+            if (record.indexBufferView.format != DXGI_FORMAT_R32_UINT)
+            {
+                fatalError("Index buffers must have 32 bit indices.");
+            }
+
+            const uint32_t indexBufferIndexCount = record.indexBufferView.sizeInBytes / sizeof(uint32_t);
+
+            const DrawIndexedArguments& drawArguments = record.drawArguments;
+            if (static_cast<uint64_t>(drawArguments.startIndexLocation) + drawArguments.indexCountPerInstance > indexBufferIndexCount)
+            {
+                fatalError(std::format("Draw reads indices {} to {}, but the index buffer only holds {}.",
+                                       drawArguments.startIndexLocation,
+                                       drawArguments.startIndexLocation + drawArguments.indexCountPerInstance,
+                                       indexBufferIndexCount));
+            }
+
+            m_statistics.instanceCount += drawArguments.instanceCount;
+            m_statistics.indexCount += static_cast<uint64_t>(drawArguments.indexCountPerInstance) * drawArguments.instanceCount;
+        }
+
+        m_statistics.drawIndirectCount++;
+        m_statistics.drawRecordCount += recordCount;
+    }
+
+    void NullCommandRecorder::reset(const std::span<const IndirectDrawRecord> indirectDrawRecords)
+    {
+        m_indirectDrawRecords = indirectDrawRecords;
+
+        // Command lists do not inherit state.
+        m_graphicsPipeline = nullptr;
+
+        m_isRecording = true;
+        m_statistics = {};
+    }
+
+    NullGraphicsBackend::NullGraphicsBackend(const uint32_t maxChunkCount, const uint32_t maxInstanceCount, const uint32_t maxDescriptorCount)
+        : m_commandRecorders(maxChunkCount), m_instances(maxInstanceCount), m_indirectDrawRecords(maxInstanceCount)
+    {
+        m_descriptorAllocator.init(maxDescriptorCount, "Null descriptor heap");
+    }
+
+    IndexBuffer NullGraphicsBackend::createIndexBuffer([[maybe_unused]] const std::byte* data, const uint32_t bufferSize, [[maybe_unused]] const std::wstring_view indexBufferName)
+    {
+        m_statistics.bufferCount++;
+
+        return IndexBuffer{
+            .indexBufferView =
+                {
+                    .BufferLocation = 0u,
+                    .SizeInBytes = bufferSize,
+                    .Format = DXGI_FORMAT_R32_UINT,
+                },
+        };
+    }
+
+    StructuredBuffer NullGraphicsBackend::createStructuredBuffer([[maybe_unused]] const std::byte* data,
+                                                                 [[maybe_unused]] const uint32_t numberOfComponents,
+                                                                 [[maybe_unused]] const uint32_t stride,
+                                                                 [[maybe_unused]] const std::wstring_view bufferName)
+    {
+        m_statistics.bufferCount++;
+
+        return StructuredBuffer{
+            .srvIndex = m_descriptorAllocator.allocate(),
+        };
+    }
+
+    Texture NullGraphicsBackend::createTexture([[maybe_unused]] const std::string_view texturePath,
+                                               [[maybe_unused]] const DXGI_FORMAT& format,
+                                               [[maybe_unused]] const bool generateMipMaps,
+                                               [[maybe_unused]] const std::wstring_view textureName)
+    {
+        m_statistics.textureCount++;
+
+        return Texture{
+            .srvIndex = m_descriptorAllocator.allocate(),
+        };
+    }
+
+    Texture NullGraphicsBackend::createTexture([[maybe_unused]] const ImageData& image,
+                                               [[maybe_unused]] const DXGI_FORMAT& format,
+                                               [[maybe_unused]] const bool generateMipMaps,
+                                               [[maybe_unused]] const std::wstring_view textureName)
+    {
+        m_statistics.textureCount++;
+
+        return Texture{
+            .srvIndex = m_descriptorAllocator.allocate(),
+        };
+    }
+
+    void NullGraphicsBackend::destroyStructuredBuffer(StructuredBuffer& structuredBuffer)
+    {
+        m_descriptorAllocator.release(structuredBuffer.srvIndex);
+        structuredBuffer = {};
+    }
+
+    void NullGraphicsBackend::destroyTexture(Texture& texture)
+    {
+        m_descriptorAllocator.release(texture.srvIndex);
+        texture = {};
+    }
+
+    void NullGraphicsBackend::beginUploadBatch()
+    {
+        if (m_isUploadBatchRecording || m_isUploadBatchInFlight)
+        {
+            fatalError("beginUploadBatch called while an upload batch is recorded or in flight.");
+        }
+
+        m_isUploadBatchRecording = true;
+    }
+
+    void NullGraphicsBackend::submitUploadBatch()
+    {
+        if (!std::exchange(m_isUploadBatchRecording, false))
+        {
+            fatalError("submitUploadBatch called without beginUploadBatch.");
+        }
+
+        m_isUploadBatchInFlight = true;
+        m_statistics.uploadBatchCount++;
+    }
+
+    bool NullGraphicsBackend::completeUploadBatch([[maybe_unused]] const bool waitForGPU)
+    {
+        if (m_isUploadBatchRecording)
+        {
+            fatalError("completeUploadBatch called before the upload batch was submitted.");
+        }
+
+        m_isUploadBatchInFlight = false;
+        return true;
+    }
+
+    GraphicsPipeline NullGraphicsBackend::createGraphicsPipeline([[maybe_unused]] const Shader& vertexShader,
+                                                                 [[maybe_unused]] const Shader& pixelShader,
+                                                                 [[maybe_unused]] const std::wstring_view pipelineName)
+    {
+        m_statistics.graphicsPipelineCount++;
+
+        return GraphicsPipeline{
+            .rootConstantCount = INDIRECT_DRAW_LAYOUT.rootConstantCount,
+        };
+    }
+
+    FrameBuffers NullGraphicsBackend::beginFrame()
+    {
+        if (std::exchange(m_isFrameActive, true))
+        {
+            fatalError("beginFrame called twice without submitting the frame.");
+        }
+
+        // Descriptor indices past the end of the heap, so records that use the wrong buffer are easy to spot.
+        return FrameBuffers{
+            .sceneData = &m_sceneData,
+            .sceneBufferIndex = m_descriptorAllocator.getCapacity(),
+            .instances = m_instances,
+            .instanceBufferIndex = m_descriptorAllocator.getCapacity() + 1u,
+            .indirectDrawRecords = m_indirectDrawRecords,
+        };
+    }
+
+    CommandRecorder& NullGraphicsBackend::beginChunk(const uint32_t chunkIndex)
+    {
+        if (!m_isFrameActive || chunkIndex >= m_commandRecorders.size())
+        {
+            fatalError(std::format("Chunk {} begun outside of a frame, or past the maximum chunk count of {}.", chunkIndex, m_commandRecorders.size()));
+        }
+
+        m_commandRecorders[chunkIndex].reset(m_indirectDrawRecords);
+        return m_commandRecorders[chunkIndex];
+    }
+
+    void NullGraphicsBackend::submitFrame(const uint32_t chunkCount)
+    {
+        if (!std::exchange(m_isFrameActive, false))
+        {
+            fatalError("submitFrame called without beginFrame.");
+        }
+
+        if (chunkCount > m_commandRecorders.size())
+        {
+            fatalError(std::format("Submitted {} chunks, but the maximum chunk count is {}.", chunkCount, m_commandRecorders.size()));
+        }
+
+        for (NullCommandRecorder& commandRecorder : std::span(m_commandRecorders).first(chunkCount))
+        {
+            if (!std::exchange(commandRecorder.m_isRecording, false))
+            {
+                fatalError("Submitted a chunk that was not recorded this frame.");
+            }
+
+            const NullGraphicsStatistics& chunkStatistics = commandRecorder.m_statistics;
+            m_statistics.pipelineChangeCount += chunkStatistics.pipelineChangeCount;
+            m_statistics.drawIndirectCount += chunkStatistics.drawIndirectCount;
+            m_statistics.drawRecordCount += chunkStatistics.drawRecordCount;
+            m_statistics.instanceCount += chunkStatistics.instanceCount;
+            m_statistics.indexCount += chunkStatistics.indexCount;
+        }
+
+        m_statistics.frameCount++;
+        m_statistics.chunkCount += chunkCount;
+        m_statistics.uiFrameCount += std::exchange(m_hasUIDrawData, false) ? 1u : 0u;
+    }
+}
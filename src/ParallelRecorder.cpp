@@ -0,0 +1,46 @@
+#include "Pch.hpp"
+
+#include "ParallelRecorder.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    void splitIntoChunks(const uint32_t itemCount, const uint32_t maxChunkCount, const uint32_t minItemsPerChunk, std::vector<RecordingChunk>& chunks)
+    {
+        chunks.clear();
+
+        const uint32_t chunkCountLimit = std::max(itemCount / std::max(minItemsPerChunk, 1u), 1u);
+        const uint32_t chunkCount = std::clamp(maxChunkCount, 1u, chunkCountLimit);
+
+        // The first (itemCount % chunkCount) chunks get one extra item.
+        const uint32_t itemsPerChunk = itemCount / chunkCount;
+        const uint32_t remainder = itemCount % chunkCount;
+
+        uint32_t firstItem = 0u;
+        for (const uint32_t chunkIndex : std::views::iota(0u, chunkCount))
+        {
+            const uint32_t chunkItemCount = itemsPerChunk + (chunkIndex < remainder ? 1u : 0u);
+
+            chunks.push_back(RecordingChunk{
+                .firstItem = firstItem,
+                .itemCount = chunkItemCount,
+            });
+
+            firstItem += chunkItemCount;
+        }
+    }
+
+    void ParallelRecorder::record(const std::span<const RecordingChunk> chunks, const RecordChunkFunction& recordChunk)
+    {
+        // One chunk per batch, chunks are already sized to balance the threads (see splitIntoChunks).
+        m_jobSystem.parallelFor(static_cast<uint32_t>(chunks.size()),
+                                1u,
+                                [&](const uint32_t begin, const uint32_t end)
+                                {
+                                    for (const uint32_t chunkIndex : std::views::iota(begin, end))
+                                    {
+                                        recordChunk(chunkIndex, chunks[chunkIndex]);
+                                    }
+                                });
+    }
+}
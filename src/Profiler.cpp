@@ -0,0 +1,303 @@
+#include "Pch.hpp"
+
+#include "Profiler.hpp"
+
+namespace nether::Profiler
+{
+    // A slot is written with a sequence lock: while a zone is written the sequence is 0, afterwards it is the zone's index + 1. A reader only keeps a zone if the
+    // sequence is the one it expects both before and after reading it, so zones that are overwritten while being read are dropped instead of torn.
+    // Times are timestamps, until they are collected.
+    struct ZoneSlot
+    {
+        std::atomic<uint64_t> sequence{};
+        std::atomic<const char*> name{};
+        std::atomic<int64_t> beginTime{};
+        std::atomic<int64_t> endTime{};
+    };
+
+    struct ThreadBuffer
+    {
+        std::array<ZoneSlot, ZONES_PER_THREAD> zones{};
+
+        // Only written by the owning thread.
+        std::atomic<uint64_t> writtenZoneCount{};
+
+        uint32_t threadIndex{};
+    };
+
+    // Thread buffers are never freed, so the zones of threads that exited can still be collected.
+    std::mutex threadRegistryMutex{};
+    std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers{};
+    std::vector<std::string> threadNames{};
+
+    thread_local ThreadBuffer* currentThreadBuffer{};
+
+    // A capture reads MAX_CAPTURE_FRAME_COUNT + 1 boundaries, the extra slot is the one markFrame may be writing meanwhile.
+    std::array<std::atomic<int64_t>, MAX_CAPTURE_FRAME_COUNT + 2u> frameBeginTimes{};
+    std::atomic<uint64_t> markedFrameCount{};
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        if (!currentThreadBuffer)
+        {
+            const std::scoped_lock lock(threadRegistryMutex);
+
+            std::unique_ptr<ThreadBuffer>& threadBuffer = threadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+            threadBuffer->threadIndex = static_cast<uint32_t>(threadBuffers.size() - 1u);
+            threadNames.push_back(std::format("Thread {}", threadBuffer->threadIndex));
+
+            currentThreadBuffer = threadBuffer.get();
+        }
+
+        return *currentThreadBuffer;
+    }
+
+    void setThreadName(const std::string_view name)
+    {
+        const uint32_t threadIndex = getThreadBuffer().threadIndex;
+
+        const std::scoped_lock lock(threadRegistryMutex);
+        threadNames[threadIndex] = name;
+    }
+
+    void recordZone(const char* const name, const int64_t beginTimestamp, const int64_t endTimestamp)
+    {
+        ThreadBuffer& threadBuffer = getThreadBuffer();
+
+        const uint64_t zoneIndex = threadBuffer.writtenZoneCount.load(std::memory_order_relaxed);
+        ZoneSlot& slot = threadBuffer.zones[zoneIndex % ZONES_PER_THREAD];
+
+        slot.sequence.store(0u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.beginTime.store(beginTimestamp, std::memory_order_relaxed);
+        slot.endTime.store(endTimestamp, std::memory_order_relaxed);
+
+        slot.sequence.store(zoneIndex + 1u, std::memory_order_release);
+        threadBuffer.writtenZoneCount.store(zoneIndex + 1u, std::memory_order_release);
+    }
+
+    void markFrame()
+    {
+        const uint64_t frameIndex = markedFrameCount.load(std::memory_order_relaxed);
+        frameBeginTimes[frameIndex % frameBeginTimes.size()].store(getTimestamp(), std::memory_order_relaxed);
+        markedFrameCount.store(frameIndex + 1u, std::memory_order_release);
+    }
+
+    // Appends the zones of the thread that overlap the range, newest first. Returns false if zones that end inside the range were already overwritten.
+    bool collectThreadZones(const ThreadBuffer& threadBuffer, const int64_t rangeBeginTime, const int64_t rangeEndTime, std::vector<ProfileZone>& zones)
+    {
+        const uint64_t writtenZoneCount = threadBuffer.writtenZoneCount.load(std::memory_order_acquire);
+        const uint64_t oldestZoneIndex = writtenZoneCount > ZONES_PER_THREAD ? writtenZoneCount - ZONES_PER_THREAD : 0u;
+
+        // Zones are recorded when they end, so end times only grow, and the walk can stop at the first zone that ended before the range.
+        for (uint64_t zoneIndex = writtenZoneCount; zoneIndex > oldestZoneIndex; zoneIndex--)
+        {
+            const ZoneSlot& slot = threadBuffer.zones[(zoneIndex - 1u) % ZONES_PER_THREAD];
+
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+            const ProfileZone zone = {
+                .name = slot.name.load(std::memory_order_relaxed),
+                .threadIndex = threadBuffer.threadIndex,
+                .beginTime = slot.beginTime.load(std::memory_order_relaxed),
+                .endTime = slot.endTime.load(std::memory_order_relaxed),
+            };
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence != zoneIndex || slot.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                // Overwritten by the owning thread, so everything older is gone as well.
+                return false;
+            }
+
+            if (zone.endTime < rangeBeginTime)
+            {
+                return true;
+            }
+
+            if (zone.beginTime <= rangeEndTime)
+            {
+                zones.push_back(zone);
+            }
+        }
+
+        // The whole ring overlaps the range, so older zones might be missing.
+        return oldestZoneIndex == 0u;
+    }
+
+    // Converts timestamps to nanoseconds on the Clock, from a reading of both clocks and the rate of the timestamps.
+    struct TimestampCalibration
+    {
+        int64_t timestamp{};
+        int64_t time{};
+        double nanosecondsPerTick{};
+
+        int64_t toTime(const int64_t value) const { return time + static_cast<int64_t>(static_cast<double>(value - timestamp) * nanosecondsPerTick); }
+    };
+
+    // The rate is measured over 10 ms, once (the first capture waits for it).
+    const TimestampCalibration& getTimestampCalibration()
+    {
+        static const TimestampCalibration calibration = []()
+        {
+            const int64_t beginTimestamp = getTimestamp();
+            const int64_t beginTime = getTime();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            const int64_t endTimestamp = getTimestamp();
+            const int64_t endTime = getTime();
+
+            return TimestampCalibration{
+                .timestamp = beginTimestamp,
+                .time = beginTime,
+                .nanosecondsPerTick = static_cast<double>(endTime - beginTime) / static_cast<double>(endTimestamp - beginTimestamp),
+            };
+        }();
+
+        return calibration;
+    }
+
+    // Sorts the zones of a thread by begin time, and derives how deeply each one is nested.
+    void computeDepths(const std::span<ProfileZone> zones)
+    {
+        std::ranges::sort(zones,
+                          [](const ProfileZone& a, const ProfileZone& b)
+                          {
+                              // A parent and its first child can begin at the same time, the parent ends last.
+                              return a.beginTime != b.beginTime ? a.beginTime < b.beginTime : a.endTime > b.endTime;
+                          });
+
+        std::vector<int64_t> openZoneEndTimes{};
+        for (ProfileZone& zone : zones)
+        {
+            while (!openZoneEndTimes.empty() && openZoneEndTimes.back() <= zone.beginTime)
+            {
+                openZoneEndTimes.pop_back();
+            }
+
+            zone.depth = static_cast<uint32_t>(openZoneEndTimes.size());
+            openZoneEndTimes.push_back(zone.endTime);
+        }
+    }
+
+    bool collectRecentFrames(const uint32_t frameCount, ProfileCapture& capture)
+    {
+        capture = {};
+
+        const uint64_t frameIndex = markedFrameCount.load(std::memory_order_acquire);
+        if (frameCount == 0u || frameCount > MAX_CAPTURE_FRAME_COUNT || frameIndex <= frameCount)
+        {
+            return false;
+        }
+
+        // The last mark is the start of the frame in progress, which ends the range.
+        for (const uint64_t boundaryIndex : std::views::iota(frameIndex - frameCount - 1u, frameIndex))
+        {
+            capture.frameBoundaries.push_back(frameBeginTimes[boundaryIndex % frameBeginTimes.size()].load(std::memory_order_relaxed));
+        }
+
+        const int64_t rangeBeginTime = capture.frameBoundaries.front();
+        const int64_t rangeEndTime = capture.frameBoundaries.back();
+
+        std::vector<const ThreadBuffer*> threadBuffersToCollect{};
+        {
+            const std::scoped_lock lock(threadRegistryMutex);
+
+            capture.threadNames = threadNames;
+            for (const std::unique_ptr<ThreadBuffer>& threadBuffer : threadBuffers)
+            {
+                threadBuffersToCollect.push_back(threadBuffer.get());
+            }
+        }
+
+        for (const ThreadBuffer* const threadBuffer : threadBuffersToCollect)
+        {
+            const size_t firstZone = capture.zones.size();
+            capture.isComplete &= collectThreadZones(*threadBuffer, rangeBeginTime, rangeEndTime, capture.zones);
+
+            computeDepths(std::span(capture.zones).subspan(firstZone));
+        }
+
+        // Converted last, depths are derived from the timestamps (which the conversion could round to equal times).
+        const TimestampCalibration& calibration = getTimestampCalibration();
+        for (int64_t& frameBoundary : capture.frameBoundaries)
+        {
+            frameBoundary = calibration.toTime(frameBoundary);
+        }
+
+        for (ProfileZone& zone : capture.zones)
+        {
+            zone.beginTime = calibration.toTime(zone.beginTime);
+            zone.endTime = calibration.toTime(zone.endTime);
+        }
+
+        return true;
+    }
+
+    void writeJsonString(std::ostream& stream, const std::string_view string)
+    {
+        stream << '"';
+        for (const char character : string)
+        {
+            if (character == '"' || character == '\\')
+            {
+                stream << '\\' << character;
+            }
+            else if (static_cast<uint8_t>(character) < 0x20u)
+            {
+                stream << std::format("\\u{:04x}", static_cast<uint32_t>(character));
+            }
+            else
+            {
+                stream << character;
+            }
+        }
+        stream << '"';
+    }
+
+    void writeChromeTrace(const ProfileCapture& capture, std::ostream& stream)
+    {
+        // Trace times are in microseconds, relative to the start of the capture.
+        const int64_t captureBeginTime = capture.frameBoundaries.empty() ? 0 : capture.frameBoundaries.front();
+        const auto toMicroseconds = [&](const int64_t time) { return static_cast<double>(time - captureBeginTime) / 1000.0; };
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        bool isFirstEvent{true};
+        const auto beginEvent = [&]()
+        {
+            stream << (isFirstEvent ? "" : ",\n");
+            isFirstEvent = false;
+        };
+
+        for (const uint32_t threadIndex : std::views::iota(0u, static_cast<uint32_t>(capture.threadNames.size())))
+        {
+            beginEvent();
+            stream << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":", threadIndex);
+            writeJsonString(stream, capture.threadNames[threadIndex]);
+            stream << "}}";
+        }
+
+        for (const size_t frameIndex : std::views::iota(size_t{0u}, capture.frameBoundaries.size()))
+        {
+            beginEvent();
+            stream << std::format("{{\"name\":\"Frame {}\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":{:.3f}}}", frameIndex, toMicroseconds(capture.frameBoundaries[frameIndex]));
+        }
+
+        for (const ProfileZone& zone : capture.zones)
+        {
+            beginEvent();
+            stream << "{\"name\":";
+            writeJsonString(stream, zone.name);
+            stream << std::format(",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                  zone.threadIndex,
+                                  toMicroseconds(zone.beginTime),
+                                  static_cast<double>(zone.endTime - zone.beginTime) / 1000.0);
+        }
+
+        stream << "\n]}\n";
+    }
+}
@@ -0,0 +1,690 @@
+#include "Pch.hpp"
+
+#include "RenderGraph.hpp"
+
+namespace nether
+{
+    inline bool isReadOnlyState(const ResourceState state) { return state != ResourceState::Common && (state & READ_ONLY_RESOURCE_STATES) == state; }
+
+    inline bool isSupportedOnComputeQueue(const RenderGraphBarrier& transition)
+    {
+        return ((transition.stateBefore | transition.stateAfter) & GRAPHICS_QUEUE_RESOURCE_STATES) == ResourceState::Common;
+    }
+
+    inline uint64_t alignUp(const uint64_t value, const uint64_t alignment) { return (value + alignment - 1u) / alignment * alignment; }
+
+    RenderGraphResource RenderGraph::importResource(const std::string_view name, const ResourceState initialState, const ResourceState finalState)
+    {
+        m_resources.push_back(ResourceNode{
+            .name = std::string(name),
+            .isImported = true,
+            .initialState = initialState,
+            .finalState = finalState,
+        });
+
+        return RenderGraphResource{static_cast<uint32_t>(m_resources.size() - 1u)};
+    }
+
+    RenderGraphResource RenderGraph::createTransientResource(const std::string_view name, const uint64_t sizeInBytes, const uint64_t alignment)
+    {
+        if (sizeInBytes == 0u || alignment == 0u || !std::has_single_bit(alignment))
+        {
+            fatalError(std::format("Transient resource {} must have a non zero size and a power of two alignment.", name));
+        }
+
+        m_resources.push_back(ResourceNode{
+            .name = std::string(name),
+            .isImported = false,
+            .sizeInBytes = sizeInBytes,
+            .alignment = alignment,
+        });
+
+        return RenderGraphResource{static_cast<uint32_t>(m_resources.size() - 1u)};
+    }
+
+    RenderGraphPass RenderGraph::addPass(const std::string_view name, const QueueType queue, const bool hasSideEffects)
+    {
+        PassNode& passNode = m_passes.emplace_back();
+        passNode.name = name;
+        passNode.queue = queue;
+        passNode.hasSideEffects = hasSideEffects;
+
+        return RenderGraphPass{static_cast<uint32_t>(m_passes.size() - 1u)};
+    }
+
+    void RenderGraph::read(const RenderGraphPass pass, const RenderGraphResource resource, const ResourceState state)
+    {
+        if (!isReadOnlyState(state))
+        {
+            fatalError(std::format("Pass {} reads resource {} in a state that is not read only.", getName(pass), getName(resource)));
+        }
+
+        m_passes[pass.index].accesses.push_back(Access{
+            .resource = resource,
+            .state = state,
+            .isWrite = false,
+        });
+    }
+
+    void RenderGraph::write(const RenderGraphPass pass, const RenderGraphResource resource, const ResourceState state)
+    {
+        m_passes[pass.index].accesses.push_back(Access{
+            .resource = resource,
+            .state = state,
+            .isWrite = true,
+        });
+    }
+
+    void RenderGraph::compile()
+    {
+        buildDependencies();
+        cullPasses();
+        sortPasses();
+        computeLifetimes();
+        placeTransientResources();
+        generateBarriers();
+        generateQueueSyncs();
+    }
+
+    void RenderGraph::clear()
+    {
+        m_resources.clear();
+        m_passes.clear();
+
+        m_compiledPasses.clear();
+        m_barriers.clear();
+        m_queueSyncs.clear();
+
+        m_transientHeapSize = 0u;
+    }
+
+    std::span<const RenderGraphBarrier> RenderGraph::getBarriersBefore(const CompiledPass& compiledPass) const
+    {
+        return std::span(m_barriers).subspan(compiledPass.firstBarrierBefore, compiledPass.barrierBeforeCount);
+    }
+
+    std::span<const RenderGraphBarrier> RenderGraph::getBarriersAfter(const CompiledPass& compiledPass) const
+    {
+        return std::span(m_barriers).subspan(compiledPass.firstBarrierAfter, compiledPass.barrierAfterCount);
+    }
+
+    void RenderGraph::addDependency(const uint32_t from, const uint32_t to, const bool isReadDependency)
+    {
+        if (from == to || from == RenderGraphPass::INVALID_INDEX)
+        {
+            return;
+        }
+
+        m_passes[from].successors.push_back(to);
+
+        if (isReadDependency)
+        {
+            m_passes[to].readPredecessors.push_back(from);
+        }
+    }
+
+    void RenderGraph::buildDependencies()
+    {
+        // Per resource, the last pass that wrote to it and the passes that read it since then.
+        m_scratchIndices.assign(m_resources.size(), RenderGraphPass::INVALID_INDEX);
+        m_resourceReaders.resize(std::max(m_resourceReaders.size(), m_resources.size()));
+        for (std::vector<uint32_t>& readers : m_resourceReaders)
+        {
+            readers.clear();
+        }
+
+        for (const uint32_t passIndex : std::views::iota(0u, static_cast<uint32_t>(m_passes.size())))
+        {
+            PassNode& passNode = m_passes[passIndex];
+            passNode.successors.clear();
+            passNode.readPredecessors.clear();
+
+            // All reads of a pass happen before its writes (read-modify-write passes read the previous content).
+            for (const Access& access : passNode.accesses)
+            {
+                if (!access.isWrite)
+                {
+                    addDependency(m_scratchIndices[access.resource.index], passIndex, true);
+                }
+            }
+
+            for (const Access& access : passNode.accesses)
+            {
+                if (access.isWrite)
+                {
+                    std::vector<uint32_t>& readers = m_resourceReaders[access.resource.index];
+
+                    // Write after read must wait for all readers. If there were none, write after write must wait for the previous writer.
+                    if (readers.empty())
+                    {
+                        addDependency(m_scratchIndices[access.resource.index], passIndex, false);
+                    }
+
+                    for (const uint32_t reader : readers)
+                    {
+                        addDependency(reader, passIndex, false);
+                    }
+
+                    readers.clear();
+                }
+            }
+
+            for (const Access& access : passNode.accesses)
+            {
+                if (access.isWrite)
+                {
+                    m_scratchIndices[access.resource.index] = passIndex;
+                }
+                else
+                {
+                    m_resourceReaders[access.resource.index].push_back(passIndex);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::cullPasses()
+    {
+        // Passes with side effects, or that write to a resource which outlives the graph, are the roots. Everything they (transitively) read from is kept alive.
+        m_scratchIndices.clear();
+
+        for (const uint32_t passIndex : std::views::iota(0u, static_cast<uint32_t>(m_passes.size())))
+        {
+            PassNode& passNode = m_passes[passIndex];
+
+            passNode.isAlive = passNode.hasSideEffects || std::ranges::any_of(passNode.accesses,
+                                                                              [&](const Access& access)
+                                                                              { return access.isWrite && m_resources[access.resource.index].isImported; });
+
+            if (passNode.isAlive)
+            {
+                m_scratchIndices.push_back(passIndex);
+            }
+        }
+
+        while (!m_scratchIndices.empty())
+        {
+            const uint32_t passIndex = m_scratchIndices.back();
+            m_scratchIndices.pop_back();
+
+            for (const uint32_t predecessor : m_passes[passIndex].readPredecessors)
+            {
+                if (!m_passes[predecessor].isAlive)
+                {
+                    m_passes[predecessor].isAlive = true;
+                    m_scratchIndices.push_back(predecessor);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::sortPasses()
+    {
+        // Kahn's algorithm. Among the passes that are ready, the one added first goes first, so the result is deterministic and follows submission order when possible.
+        m_compiledPasses.clear();
+        m_scratchIndices.clear();
+
+        for (PassNode& passNode : m_passes)
+        {
+            passNode.predecessorCount = 0u;
+            passNode.compiledIndex = RenderGraphPass::INVALID_INDEX;
+        }
+
+        uint32_t alivePassCount{};
+        for (const PassNode& passNode : m_passes)
+        {
+            if (!passNode.isAlive)
+            {
+                continue;
+            }
+
+            ++alivePassCount;
+            for (const uint32_t successor : passNode.successors)
+            {
+                m_passes[successor].predecessorCount += m_passes[successor].isAlive ? 1u : 0u;
+            }
+        }
+
+        for (const uint32_t passIndex : std::views::iota(0u, static_cast<uint32_t>(m_passes.size())))
+        {
+            if (m_passes[passIndex].isAlive && m_passes[passIndex].predecessorCount == 0u)
+            {
+                m_scratchIndices.push_back(passIndex);
+            }
+        }
+
+        std::ranges::make_heap(m_scratchIndices, std::greater{});
+
+        while (!m_scratchIndices.empty())
+        {
+            std::ranges::pop_heap(m_scratchIndices, std::greater{});
+            const uint32_t passIndex = m_scratchIndices.back();
+            m_scratchIndices.pop_back();
+
+            PassNode& passNode = m_passes[passIndex];
+            passNode.compiledIndex = static_cast<uint32_t>(m_compiledPasses.size());
+
+            m_compiledPasses.push_back(CompiledPass{
+                .pass = RenderGraphPass{passIndex},
+                .queue = passNode.queue,
+            });
+
+            for (const uint32_t successor : passNode.successors)
+            {
+                if (m_passes[successor].isAlive && --m_passes[successor].predecessorCount == 0u)
+                {
+                    m_scratchIndices.push_back(successor);
+                    std::ranges::push_heap(m_scratchIndices, std::greater{});
+                }
+            }
+        }
+
+        if (m_compiledPasses.size() != alivePassCount)
+        {
+            fatalError("Render graph contains a cycle.");
+        }
+    }
+
+    void RenderGraph::computeLifetimes()
+    {
+        for (ResourceNode& resourceNode : m_resources)
+        {
+            resourceNode.firstUse = RenderGraphPass::INVALID_INDEX;
+            resourceNode.lastUse = RenderGraphPass::INVALID_INDEX;
+            resourceNode.isUsedByAsyncQueue = false;
+            resourceNode.heapOffset = 0u;
+        }
+
+        for (const uint32_t compiledIndex : std::views::iota(0u, static_cast<uint32_t>(m_compiledPasses.size())))
+        {
+            const PassNode& passNode = m_passes[m_compiledPasses[compiledIndex].pass.index];
+
+            for (const Access& access : passNode.accesses)
+            {
+                ResourceNode& resourceNode = m_resources[access.resource.index];
+
+                if (resourceNode.firstUse == RenderGraphPass::INVALID_INDEX)
+                {
+                    resourceNode.firstUse = compiledIndex;
+                }
+
+                resourceNode.lastUse = compiledIndex;
+                resourceNode.isUsedByAsyncQueue |= passNode.queue != QueueType::Graphics;
+            }
+        }
+    }
+
+    void RenderGraph::placeTransientResources()
+    {
+        // Interval packing: resources are placed largest first, each at the lowest offset that does not overlap (in memory) with an already placed resource whose lifetime
+        // overlaps with it. Passes on other queues are not ordered with respect to the graphics queue, so resources used on a async queue never share memory.
+        m_transientHeapSize = 0u;
+
+        m_scratchIndices.clear();
+        for (const uint32_t resourceIndex : std::views::iota(0u, static_cast<uint32_t>(m_resources.size())))
+        {
+            if (!m_resources[resourceIndex].isImported && m_resources[resourceIndex].firstUse != RenderGraphPass::INVALID_INDEX)
+            {
+                m_scratchIndices.push_back(resourceIndex);
+            }
+        }
+
+        std::ranges::sort(m_scratchIndices,
+                          [&](const uint32_t a, const uint32_t b)
+                          {
+                              if (m_resources[a].sizeInBytes != m_resources[b].sizeInBytes)
+                              {
+                                  return m_resources[a].sizeInBytes > m_resources[b].sizeInBytes;
+                              }
+
+                              return m_resources[a].firstUse < m_resources[b].firstUse;
+                          });
+
+        const auto lifetimesOverlap = [&](const ResourceNode& a, const ResourceNode& b)
+        { return a.isUsedByAsyncQueue || b.isUsedByAsyncQueue || (a.firstUse <= b.lastUse && b.firstUse <= a.lastUse); };
+
+        // Already placed resources, sorted by offset, so the first fitting gap can be found in a single walk.
+        m_placedResources.clear();
+
+        for (const uint32_t resourceIndex : m_scratchIndices)
+        {
+            ResourceNode& resourceNode = m_resources[resourceIndex];
+
+            uint64_t offset{};
+            for (const uint32_t placedIndex : m_placedResources)
+            {
+                const ResourceNode& placedNode = m_resources[placedIndex];
+                if (!lifetimesOverlap(resourceNode, placedNode))
+                {
+                    continue;
+                }
+
+                if (offset + resourceNode.sizeInBytes <= placedNode.heapOffset)
+                {
+                    break;
+                }
+
+                offset = std::max(offset, alignUp(placedNode.heapOffset + placedNode.sizeInBytes, resourceNode.alignment));
+            }
+
+            resourceNode.heapOffset = offset;
+            m_transientHeapSize = std::max(m_transientHeapSize, offset + resourceNode.sizeInBytes);
+
+            const auto insertPosition = std::ranges::upper_bound(m_placedResources, offset, {}, [&](const uint32_t index) { return m_resources[index].heapOffset; });
+            m_placedResources.insert(insertPosition, resourceIndex);
+        }
+    }
+
+    void RenderGraph::generateBarriers()
+    {
+        m_pendingBarriers.clear();
+        m_queueSyncs.clear();
+
+        m_resourceTracking.resize(m_resources.size());
+        for (const size_t resourceIndex : std::views::iota(0u, m_resources.size()))
+        {
+            m_resourceTracking[resourceIndex] = ResourceTracking{
+                .state = m_resources[resourceIndex].initialState,
+            };
+        }
+
+        const auto addBarrier = [&](const uint32_t compiledPass, const BarrierTiming timing, const RenderGraphBarrier& barrier)
+        {
+            m_pendingBarriers.push_back(PendingBarrier{
+                .compiledPass = compiledPass,
+                .timing = timing,
+                .barrier = barrier,
+            });
+        };
+
+        for (const uint32_t compiledIndex : std::views::iota(0u, static_cast<uint32_t>(m_compiledPasses.size())))
+        {
+            const CompiledPass& compiledPass = m_compiledPasses[compiledIndex];
+            const std::vector<Access>& accesses = m_passes[compiledPass.pass.index].accesses;
+
+            for (const size_t accessIndex : std::views::iota(0u, accesses.size()))
+            {
+                const RenderGraphResource resource = accesses[accessIndex].resource;
+
+                // A pass can access the same resource more than once, all accesses are handled together at the first one.
+                const auto isSameResource = [&](const Access& access) { return access.resource == resource; };
+                if (std::ranges::any_of(accesses.begin(), accesses.begin() + accessIndex, isSameResource))
+                {
+                    continue;
+                }
+
+                // Reads in the same pass are combined into one state. If the pass also writes, the write state wins.
+                ResourceState readState{};
+                ResourceState writeState{};
+                bool isWrite{};
+
+                for (const Access& access : accesses | std::views::filter(isSameResource))
+                {
+                    if (access.isWrite)
+                    {
+                        writeState = writeState | access.state;
+                        isWrite = true;
+                    }
+                    else
+                    {
+                        readState = readState | access.state;
+                    }
+                }
+
+                const ResourceState state = isWrite ? writeState : readState;
+
+                ResourceNode& resourceNode = m_resources[resource.index];
+                ResourceTracking& tracking = m_resourceTracking[resource.index];
+
+                if (!resourceNode.isImported && compiledIndex == resourceNode.firstUse)
+                {
+                    // Transient resources are created in the state of their first use. If other resources share the memory, a aliasing barrier is needed: they used it
+                    // earlier in this frame, or later in the previous one.
+                    resourceNode.firstUseState = state;
+
+                    uint32_t aliasedCount{};
+                    RenderGraphResource aliasedResource{};
+
+                    // m_placedResources is sorted by offset, so the walk stops at the first resource past the end of this one.
+                    for (const uint32_t otherIndex : m_placedResources)
+                    {
+                        const ResourceNode& otherNode = m_resources[otherIndex];
+                        if (otherNode.heapOffset >= resourceNode.heapOffset + resourceNode.sizeInBytes)
+                        {
+                            break;
+                        }
+
+                        const bool memoryOverlaps = resourceNode.heapOffset < otherNode.heapOffset + otherNode.sizeInBytes;
+                        if (memoryOverlaps && otherIndex != resource.index)
+                        {
+                            ++aliasedCount;
+                            aliasedResource = RenderGraphResource{otherIndex};
+                        }
+                    }
+
+                    if (aliasedCount > 0u)
+                    {
+                        addBarrier(compiledIndex,
+                                   BarrierTiming::BeforePass,
+                                   RenderGraphBarrier{
+                                       .type = BarrierType::Aliasing,
+                                       .resource = resource,
+                                       .aliasedResource = aliasedCount == 1u ? aliasedResource : RenderGraphResource{},
+                                   });
+                    }
+                }
+                else if (tracking.state == state)
+                {
+                    // Back to back unordered access needs a UAV barrier if either side writes.
+                    if (state == ResourceState::UnorderedAccess && (isWrite || tracking.wasLastUseWrite))
+                    {
+                        addBarrier(compiledIndex,
+                                   BarrierTiming::BeforePass,
+                                   RenderGraphBarrier{
+                                       .type = BarrierType::UnorderedAccess,
+                                       .resource = resource,
+                                   });
+                    }
+                }
+                else if (isWrite || !isReadOnlyState(tracking.state) || (tracking.state & state) != state)
+                {
+                    const RenderGraphBarrier transition = {
+                        .type = BarrierType::Transition,
+                        .resource = resource,
+                        .stateBefore = tracking.state,
+                        .stateAfter = state,
+                    };
+
+                    const bool hasPreviousUse = tracking.lastUse != RenderGraphPass::INVALID_INDEX;
+                    const bool isSameQueue = !hasPreviousUse || m_compiledPasses[tracking.lastUse].queue == compiledPass.queue;
+
+                    if (!isSameQueue)
+                    {
+                        // Transitions between queues are recorded on the graphics queue, which supports every state: after the previous use, before the graphics queue
+                        // signals the compute queue, or before this pass, once the graphics queue waited for the compute queue.
+                        if (compiledPass.queue == QueueType::Graphics)
+                        {
+                            addBarrier(compiledIndex, BarrierTiming::BeforePass, transition);
+                        }
+                        else
+                        {
+                            addBarrier(tracking.lastUse, BarrierTiming::AfterPass, transition);
+                        }
+
+                        m_queueSyncs.push_back(QueueSync{
+                            .signalPass = tracking.lastUse,
+                            .waitPass = compiledIndex,
+                        });
+                    }
+                    else
+                    {
+                        if (compiledPass.queue != QueueType::Graphics && !isSupportedOnComputeQueue(transition))
+                        {
+                            fatalError(std::format("Pass {} needs resource {} transitioned on the compute queue, between states that only the graphics queue supports.",
+                                                   getName(compiledPass.pass),
+                                                   getName(resource)));
+                        }
+
+                        // Split the transition if another pass runs on the same queue between the previous use and this one.
+                        const bool canSplit = hasPreviousUse &&
+                                              std::ranges::any_of(std::span(m_compiledPasses).subspan(tracking.lastUse + 1u, compiledIndex - tracking.lastUse - 1u),
+                                                                  [&](const CompiledPass& other) { return other.queue == compiledPass.queue; });
+
+                        if (canSplit)
+                        {
+                            RenderGraphBarrier beginTransition = transition;
+                            beginTransition.split = BarrierSplit::Begin;
+                            addBarrier(tracking.lastUse, BarrierTiming::AfterPass, beginTransition);
+
+                            RenderGraphBarrier endTransition = transition;
+                            endTransition.split = BarrierSplit::End;
+                            addBarrier(compiledIndex, BarrierTiming::BeforePass, endTransition);
+                        }
+                        else
+                        {
+                            addBarrier(compiledIndex, BarrierTiming::BeforePass, transition);
+                        }
+                    }
+                }
+
+                tracking.state = state;
+                tracking.lastUse = compiledIndex;
+                tracking.wasLastUseWrite = isWrite;
+            }
+        }
+
+        // Leave imported resources in the state the caller expects, and transient resources in the state of their first use, which the next execution of the graph
+        // expects them in. Resources that no pass uses are left untouched.
+        for (const size_t resourceIndex : std::views::iota(0u, m_resources.size()))
+        {
+            const ResourceNode& resourceNode = m_resources[resourceIndex];
+            const ResourceTracking& tracking = m_resourceTracking[resourceIndex];
+
+            const ResourceState finalState = resourceNode.isImported ? resourceNode.finalState : resourceNode.firstUseState;
+            if (tracking.lastUse == RenderGraphPass::INVALID_INDEX || tracking.state == finalState)
+            {
+                continue;
+            }
+
+            const RenderGraphBarrier transition = {
+                .type = BarrierType::Transition,
+                .resource = RenderGraphResource{static_cast<uint32_t>(resourceIndex)},
+                .stateBefore = tracking.state,
+                .stateAfter = finalState,
+            };
+
+            // The transition goes after the last use, unless that was on the compute queue and the compute queue cannot do it. Then it goes after the last graphics
+            // pass, which waits for the compute queue first.
+            uint32_t transitionPass = tracking.lastUse;
+            if (m_compiledPasses[tracking.lastUse].queue != QueueType::Graphics && !isSupportedOnComputeQueue(transition))
+            {
+                transitionPass = RenderGraphPass::INVALID_INDEX;
+                for (const uint32_t compiledIndex : std::views::iota(tracking.lastUse + 1u, static_cast<uint32_t>(m_compiledPasses.size())))
+                {
+                    transitionPass = m_compiledPasses[compiledIndex].queue == QueueType::Graphics ? compiledIndex : transitionPass;
+                }
+
+                if (transitionPass == RenderGraphPass::INVALID_INDEX)
+                {
+                    fatalError(std::format("Resource {} is last used on the compute queue, and no graphics pass runs after it to transition it back to its final state.",
+                                           resourceNode.name));
+                }
+
+                m_queueSyncs.push_back(QueueSync{
+                    .signalPass = tracking.lastUse,
+                    .waitPass = transitionPass,
+                });
+            }
+
+            addBarrier(transitionPass, BarrierTiming::AfterPass, transition);
+        }
+
+        // Group the barriers by pass, so each pass gets one batch before and one batch after it.
+        std::ranges::stable_sort(m_pendingBarriers,
+                                 [](const PendingBarrier& a, const PendingBarrier& b)
+                                 {
+                                     if (a.compiledPass != b.compiledPass)
+                                     {
+                                         return a.compiledPass < b.compiledPass;
+                                     }
+
+                                     return a.timing < b.timing;
+                                 });
+
+        m_barriers.clear();
+        for (const PendingBarrier& pendingBarrier : m_pendingBarriers)
+        {
+            CompiledPass& compiledPass = m_compiledPasses[pendingBarrier.compiledPass];
+            const uint32_t barrierIndex = static_cast<uint32_t>(m_barriers.size());
+
+            if (pendingBarrier.timing == BarrierTiming::BeforePass)
+            {
+                compiledPass.firstBarrierBefore = compiledPass.barrierBeforeCount == 0u ? barrierIndex : compiledPass.firstBarrierBefore;
+                ++compiledPass.barrierBeforeCount;
+            }
+            else
+            {
+                compiledPass.firstBarrierAfter = compiledPass.barrierAfterCount == 0u ? barrierIndex : compiledPass.firstBarrierAfter;
+                ++compiledPass.barrierAfterCount;
+            }
+
+            m_barriers.push_back(pendingBarrier.barrier);
+        }
+    }
+
+    void RenderGraph::generateQueueSyncs()
+    {
+        // Every dependency between passes on different queues needs a sync (generateBarriers already added the ones for cross queue transitions).
+        for (const CompiledPass& compiledPass : m_compiledPasses)
+        {
+            const PassNode& passNode = m_passes[compiledPass.pass.index];
+
+            for (const uint32_t successor : passNode.successors)
+            {
+                const PassNode& successorNode = m_passes[successor];
+                if (successorNode.isAlive && successorNode.queue != passNode.queue)
+                {
+                    m_queueSyncs.push_back(QueueSync{
+                        .signalPass = passNode.compiledIndex,
+                        .waitPass = successorNode.compiledIndex,
+                    });
+                }
+            }
+        }
+
+        // Remove redundant syncs. Queues execute in order, so once a queue waited for pass N of another queue, it does not need to wait for any pass <= N of that queue again.
+        std::ranges::sort(m_queueSyncs,
+                          [](const QueueSync& a, const QueueSync& b)
+                          {
+                              if (a.waitPass != b.waitPass)
+                              {
+                                  return a.waitPass < b.waitPass;
+                              }
+
+                              return a.signalPass > b.signalPass;
+                          });
+
+        constexpr size_t QUEUE_COUNT = 2u;
+        std::array<std::array<uint32_t, QUEUE_COUNT>, QUEUE_COUNT> lastWaitedSignalPass{};
+        for (auto& signalPasses : lastWaitedSignalPass)
+        {
+            signalPasses.fill(RenderGraphPass::INVALID_INDEX);
+        }
+
+        std::erase_if(m_queueSyncs,
+                      [&](const QueueSync& queueSync)
+                      {
+                          const size_t waitQueue = EnumClassValue(m_compiledPasses[queueSync.waitPass].queue);
+                          const size_t signalQueue = EnumClassValue(m_compiledPasses[queueSync.signalPass].queue);
+
+                          uint32_t& lastWaited = lastWaitedSignalPass[waitQueue][signalQueue];
+                          if (lastWaited != RenderGraphPass::INVALID_INDEX && queueSync.signalPass <= lastWaited)
+                          {
+                              return true;
+                          }
+
+                          lastWaited = queueSync.signalPass;
+                          return false;
+                      });
+    }
+}
@@ -0,0 +1,45 @@
+#include "Pch.hpp"
+
+#include "RootConstantLayout.hpp"
+
+namespace nether
+{
+    std::string validateRootConstants(const RootConstantLayout& layout, const std::span<const ReflectedRootConstant> reflectedRootConstants)
+    {
+        std::string errorMessage{};
+
+        for (const ReflectedRootConstant& reflectedRootConstant : reflectedRootConstants)
+        {
+            const auto field = std::ranges::find(layout.fields, std::string_view(reflectedRootConstant.name), &RootConstantField::name);
+            if (field == layout.fields.end())
+            {
+                errorMessage += std::format("{} has no member named {}.\n", layout.name, reflectedRootConstant.name);
+                continue;
+            }
+
+            if (field->offsetInBytes != reflectedRootConstant.offsetInBytes || field->sizeInBytes != reflectedRootConstant.sizeInBytes)
+            {
+                errorMessage += std::format("{}::{} is at offset {} with size {} in C++, but at offset {} with size {} in the shader.\n",
+                                            layout.name,
+                                            reflectedRootConstant.name,
+                                            field->offsetInBytes,
+                                            field->sizeInBytes,
+                                            reflectedRootConstant.offsetInBytes,
+                                            reflectedRootConstant.sizeInBytes);
+            }
+        }
+
+        return errorMessage;
+    }
+
+    uint32_t getRootConstantCount(const std::span<const ReflectedRootConstant> reflectedRootConstants)
+    {
+        uint32_t sizeInBytes{};
+        for (const ReflectedRootConstant& reflectedRootConstant : reflectedRootConstants)
+        {
+            sizeInBytes = std::max(sizeInBytes, reflectedRootConstant.offsetInBytes + reflectedRootConstant.sizeInBytes);
+        }
+
+        return (sizeInBytes + sizeof(uint32_t) - 1u) / sizeof(uint32_t);
+    }
+}
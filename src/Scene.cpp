@@ -0,0 +1,400 @@
+#include "Pch.hpp"
+
+#include "Scene.hpp"
+#include "AllocationTracker.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    EntityHandle Scene::createEntity(const std::string_view name, const EntityHandle parent)
+    {
+        // Reuse a free slot in the sparse array if possible, else grow it.
+        uint32_t entityIndex{};
+        if (!m_freeEntityIndices.empty())
+        {
+            entityIndex = m_freeEntityIndices.back();
+            m_freeEntityIndices.pop_back();
+        }
+        else
+        {
+            entityIndex = static_cast<uint32_t>(m_sparseToDenseIndex.size());
+            m_sparseToDenseIndex.push_back(INVALID_DENSE_INDEX);
+            m_generations.push_back(0u);
+        }
+
+        const size_t denseIndex = m_denseToEntityIndex.size();
+        m_sparseToDenseIndex[entityIndex] = static_cast<uint32_t>(denseIndex);
+
+        forEachDenseArray([](auto& denseArray) { denseArray.emplace_back(); });
+
+        m_denseToEntityIndex[denseIndex] = entityIndex;
+        m_names[denseIndex] = name;
+        setTransformAtIndex(denseIndex, Transform{});
+
+        m_parentDenseIndices[denseIndex] = INVALID_DENSE_INDEX;
+        if (parent.isValid())
+        {
+            // The new entity is appended after its parent, so the parent still comes first. It is however not necessarily in breadth first order anymore.
+            m_parents[denseIndex] = parent;
+            m_parentDenseIndices[denseIndex] = getDenseIndex(parent);
+            m_isHierarchyOrderDirty = true;
+        }
+        else if (denseIndex > 0u && m_parentDenseIndices[denseIndex - 1u] != INVALID_DENSE_INDEX)
+        {
+            // A root appended after non root entities breaks the breadth first order.
+            m_isHierarchyOrderDirty = true;
+        }
+
+        return EntityHandle{
+            .index = entityIndex,
+            .generation = m_generations[entityIndex],
+        };
+    }
+
+    void Scene::destroyEntity(const EntityHandle entity)
+    {
+        if (!isAlive(entity))
+        {
+            return;
+        }
+
+        // The dense indices in the changed list are about to be invalidated.
+        for (const uint32_t changedIndex : m_changedTransformIndices)
+        {
+            m_worldChangedFlags[changedIndex] = 0u;
+        }
+        m_changedTransformIndices.clear();
+
+        // Move the last element of every dense array into the hole left by the destroyed entity, so the arrays stay tightly packed.
+        const uint32_t denseIndex = m_sparseToDenseIndex[entity.index];
+        const uint32_t lastDenseIndex = static_cast<uint32_t>(m_denseToEntityIndex.size() - 1u);
+
+        if (denseIndex != lastDenseIndex)
+        {
+            forEachDenseArray([=](auto& denseArray) { denseArray[denseIndex] = std::move(denseArray[lastDenseIndex]); });
+
+            m_sparseToDenseIndex[m_denseToEntityIndex[denseIndex]] = denseIndex;
+
+            if (m_localDirtyFlags[denseIndex])
+            {
+                m_firstDirtyDenseIndex = std::min<size_t>(m_firstDirtyDenseIndex, denseIndex);
+            }
+        }
+
+        forEachDenseArray([](auto& denseArray) { denseArray.pop_back(); });
+
+        // Invalidate all outstanding handles to this slot and make it available for reuse.
+        m_sparseToDenseIndex[entity.index] = INVALID_DENSE_INDEX;
+        m_generations[entity.index]++;
+        m_freeEntityIndices.push_back(entity.index);
+
+        // Swapping breaks the breadth first order, and any children of the destroyed entity need to be turned into roots.
+        m_isHierarchyOrderDirty = true;
+    }
+
+    bool Scene::isAlive(const EntityHandle entity) const
+    {
+        return entity.index < m_generations.size() && m_generations[entity.index] == entity.generation && m_sparseToDenseIndex[entity.index] != INVALID_DENSE_INDEX;
+    }
+
+    void Scene::setParent(const EntityHandle entity, const EntityHandle parent)
+    {
+        const uint32_t denseIndex = getDenseIndex(entity);
+
+        // Make sure the entity is not a ancestor of the new parent, else the hierarchy would have a cycle. The walk ends at a root, or at a destroyed ancestor (whose
+        // children become roots at the next sortHierarchy).
+        for (EntityHandle ancestor = parent; isAlive(ancestor); ancestor = m_parents[m_sparseToDenseIndex[ancestor.index]])
+        {
+            if (ancestor == entity)
+            {
+                fatalError("Cannot parent a entity to one of its descendants.");
+            }
+        }
+
+        m_parents[denseIndex] = parent;
+        m_isHierarchyOrderDirty = true;
+
+        markDirty(denseIndex);
+    }
+
+    EntityHandle Scene::getParent(const EntityHandle entity) const
+    {
+        const EntityHandle parent = m_parents[getDenseIndex(entity)];
+        return isAlive(parent) ? parent : EntityHandle{};
+    }
+
+    void Scene::reserve(const size_t entityCount)
+    {
+        m_sparseToDenseIndex.reserve(entityCount);
+        m_generations.reserve(entityCount);
+
+        forEachDenseArray([=](auto& denseArray) { denseArray.reserve(entityCount); });
+    }
+
+    void Scene::clear()
+    {
+        // Destroy all entities while bumping generations, so that handles from before the clear are not considered alive.
+        for (const uint32_t entityIndex : m_denseToEntityIndex)
+        {
+            m_sparseToDenseIndex[entityIndex] = INVALID_DENSE_INDEX;
+            m_generations[entityIndex]++;
+            m_freeEntityIndices.push_back(entityIndex);
+        }
+
+        forEachDenseArray([](auto& denseArray) { denseArray.clear(); });
+
+        m_changedTransformIndices.clear();
+        m_firstDirtyDenseIndex = SIZE_MAX;
+        m_isHierarchyOrderDirty = false;
+    }
+
+    void Scene::updateTransforms()
+    {
+        NETHER_PROFILE_SCOPE("Scene::updateTransforms");
+
+        for (const uint32_t changedIndex : m_changedTransformIndices)
+        {
+            m_worldChangedFlags[changedIndex] = 0u;
+        }
+        m_changedTransformIndices.clear();
+
+        if (m_isHierarchyOrderDirty)
+        {
+            sortHierarchy();
+            m_isHierarchyOrderDirty = false;
+        }
+
+        // Reordering the hierarchy only happens after structural changes, and may allocate. The per frame update must not (see AllocationTracker.hpp), so the changed
+        // indices are sized for the whole scene.
+        NETHER_ALLOCATION_SCOPE("Scene");
+        m_changedTransformIndices.reserve(size());
+
+        // Static scenes early out here.
+        if (m_firstDirtyDenseIndex >= size())
+        {
+            m_firstDirtyDenseIndex = SIZE_MAX;
+            return;
+        }
+
+        const size_t firstDirtyDenseIndex = m_firstDirtyDenseIndex;
+
+        // Compute the local matrices of all dirty entities.
+        TransformKernel::compose(getLocalTransforms(firstDirtyDenseIndex),
+                                 m_localDirtyFlags.data() + firstDirtyDenseIndex,
+                                 std::span(m_localMatrices).subspan(firstDirtyDenseIndex),
+                                 std::span(m_localNormalMatrices).subspan(firstDirtyDenseIndex));
+
+        // Propagate to the world matrices. As parents always come before their children, a parent's world matrix (and changed flag) is final by the time its children are
+        // visited. A entity is only recomputed if its own transform or its parent's world matrix changed, so clean subtrees are skipped.
+        for (const size_t i : std::views::iota(firstDirtyDenseIndex, size()))
+        {
+            const uint32_t parentDenseIndex = m_parentDenseIndices[i];
+            const bool isRoot = parentDenseIndex == INVALID_DENSE_INDEX;
+
+            if (!m_localDirtyFlags[i] && (isRoot || !m_worldChangedFlags[parentDenseIndex]))
+            {
+                continue;
+            }
+
+            if (isRoot)
+            {
+                m_worldMatrices[i] = m_localMatrices[i];
+                m_normalMatrices[i] = m_localNormalMatrices[i];
+            }
+            else
+            {
+                // (L * P)^-T = L^-T * P^-T, so the normal matrices compose the same way as the world matrices.
+                math::XMStoreFloat4x4(&m_worldMatrices[i],
+                                      math::XMMatrixMultiply(math::XMLoadFloat4x4(&m_localMatrices[i]), math::XMLoadFloat4x4(&m_worldMatrices[parentDenseIndex])));
+                math::XMStoreFloat4x4(&m_normalMatrices[i],
+                                      math::XMMatrixMultiply(math::XMLoadFloat4x4(&m_localNormalMatrices[i]), math::XMLoadFloat4x4(&m_normalMatrices[parentDenseIndex])));
+            }
+
+            m_localDirtyFlags[i] = 0u;
+            m_worldChangedFlags[i] = 1u;
+            m_changedTransformIndices.push_back(static_cast<uint32_t>(i));
+        }
+
+        m_firstDirtyDenseIndex = SIZE_MAX;
+    }
+
+    Transform Scene::getTransformAtIndex(const size_t denseIndex) const
+    {
+        return Transform{
+            .rotate = {m_rotateX[denseIndex], m_rotateY[denseIndex], m_rotateZ[denseIndex]},
+            .scale = {m_scaleX[denseIndex], m_scaleY[denseIndex], m_scaleZ[denseIndex]},
+            .translate = {m_translateX[denseIndex], m_translateY[denseIndex], m_translateZ[denseIndex]},
+        };
+    }
+
+    void Scene::setTransformAtIndex(const size_t denseIndex, const Transform& transform)
+    {
+        m_rotateX[denseIndex] = transform.rotate.x;
+        m_rotateY[denseIndex] = transform.rotate.y;
+        m_rotateZ[denseIndex] = transform.rotate.z;
+
+        m_scaleX[denseIndex] = transform.scale.x;
+        m_scaleY[denseIndex] = transform.scale.y;
+        m_scaleZ[denseIndex] = transform.scale.z;
+
+        m_translateX[denseIndex] = transform.translate.x;
+        m_translateY[denseIndex] = transform.translate.y;
+        m_translateZ[denseIndex] = transform.translate.z;
+
+        markDirty(denseIndex);
+    }
+
+    EntityHandle Scene::getEntity(const size_t denseIndex) const
+    {
+        const uint32_t entityIndex = m_denseToEntityIndex[denseIndex];
+
+        return EntityHandle{
+            .index = entityIndex,
+            .generation = m_generations[entityIndex],
+        };
+    }
+
+    uint32_t Scene::getDenseIndex(const EntityHandle entity) const
+    {
+        if (!isAlive(entity))
+        {
+            fatalError("Attempted to access a entity that is not alive.");
+        }
+
+        return m_sparseToDenseIndex[entity.index];
+    }
+
+    TransformKernel::LocalTransforms Scene::getLocalTransforms(const size_t firstDenseIndex) const
+    {
+        return TransformKernel::LocalTransforms{
+            .translateX = m_translateX.data() + firstDenseIndex,
+            .translateY = m_translateY.data() + firstDenseIndex,
+            .translateZ = m_translateZ.data() + firstDenseIndex,
+            .rotateX = m_rotateX.data() + firstDenseIndex,
+            .rotateY = m_rotateY.data() + firstDenseIndex,
+            .rotateZ = m_rotateZ.data() + firstDenseIndex,
+            .scaleX = m_scaleX.data() + firstDenseIndex,
+            .scaleY = m_scaleY.data() + firstDenseIndex,
+            .scaleZ = m_scaleZ.data() + firstDenseIndex,
+            .count = size() - firstDenseIndex,
+        };
+    }
+
+    void Scene::markDirty(const size_t denseIndex)
+    {
+        m_localDirtyFlags[denseIndex] = 1u;
+        m_firstDirtyDenseIndex = std::min(m_firstDirtyDenseIndex, denseIndex);
+    }
+
+    void Scene::sortHierarchy()
+    {
+        const size_t entityCount = size();
+
+        // Resolve the parent handles. Entities whose parent was destroyed become roots.
+        for (const size_t i : std::views::iota(0u, entityCount))
+        {
+            if (m_parents[i].isValid() && !isAlive(m_parents[i]))
+            {
+                m_parents[i] = EntityHandle{};
+                markDirty(i);
+            }
+
+            m_parentDenseIndices[i] = m_parents[i].isValid() ? m_sparseToDenseIndex[m_parents[i].index] : INVALID_DENSE_INDEX;
+        }
+
+        // Compute the depth of every entity. Walk up until a entity with known depth (or a root) is found, then assign depths on the way back down.
+        constexpr uint32_t UNKNOWN_DEPTH = ~0u;
+        m_sortDepths.assign(entityCount, UNKNOWN_DEPTH);
+        m_sortAncestors.clear();
+
+        uint32_t maxDepth{};
+        for (const size_t i : std::views::iota(0u, entityCount))
+        {
+            uint32_t current = static_cast<uint32_t>(i);
+            while (current != INVALID_DENSE_INDEX && m_sortDepths[current] == UNKNOWN_DEPTH)
+            {
+                m_sortAncestors.push_back(current);
+                current = m_parentDenseIndices[current];
+            }
+
+            uint32_t depth = current == INVALID_DENSE_INDEX ? 0u : m_sortDepths[current] + 1u;
+            while (!m_sortAncestors.empty())
+            {
+                m_sortDepths[m_sortAncestors.back()] = depth++;
+                m_sortAncestors.pop_back();
+            }
+
+            maxDepth = std::max(maxDepth, depth - 1u);
+        }
+
+        // Counting sort by depth gives breadth first order, while keeping the relative order of siblings. order[newDenseIndex] = oldDenseIndex.
+        m_sortDepthOffsets.assign(maxDepth + 2u, 0u);
+        for (const uint32_t depth : m_sortDepths)
+        {
+            m_sortDepthOffsets[depth + 1u]++;
+        }
+
+        std::partial_sum(m_sortDepthOffsets.begin(), m_sortDepthOffsets.end(), m_sortDepthOffsets.begin());
+
+        m_sortOrder.resize(entityCount);
+        bool isAlreadySorted = true;
+        for (const size_t i : std::views::iota(0u, entityCount))
+        {
+            const uint32_t newDenseIndex = m_sortDepthOffsets[m_sortDepths[i]]++;
+            m_sortOrder[newDenseIndex] = static_cast<uint32_t>(i);
+
+            isAlreadySorted = isAlreadySorted && newDenseIndex == i;
+        }
+
+        if (isAlreadySorted)
+        {
+            return;
+        }
+
+        // Permute every dense array in place, one cycle of the permutation at a time, so that reordering does not allocate (or copy the arrays).
+        forEachDenseArray(
+            [&](auto& denseArray)
+            {
+                m_sortVisitedFlags.assign(entityCount, 0u);
+
+                for (const size_t cycleStart : std::views::iota(0u, entityCount))
+                {
+                    if (m_sortVisitedFlags[cycleStart])
+                    {
+                        continue;
+                    }
+
+                    auto cycleStartElement = std::move(denseArray[cycleStart]);
+
+                    size_t current = cycleStart;
+                    while (true)
+                    {
+                        m_sortVisitedFlags[current] = 1u;
+
+                        const size_t next = m_sortOrder[current];
+                        if (next == cycleStart)
+                        {
+                            denseArray[current] = std::move(cycleStartElement);
+                            break;
+                        }
+
+                        denseArray[current] = std::move(denseArray[next]);
+                        current = next;
+                    }
+                }
+            });
+
+        for (const size_t i : std::views::iota(0u, entityCount))
+        {
+            m_sparseToDenseIndex[m_denseToEntityIndex[i]] = static_cast<uint32_t>(i);
+        }
+
+        for (const size_t i : std::views::iota(0u, entityCount))
+        {
+            m_parentDenseIndices[i] = m_parents[i].isValid() ? m_sparseToDenseIndex[m_parents[i].index] : INVALID_DENSE_INDEX;
+        }
+
+        // Dirty entities could have moved anywhere.
+        m_firstDirtyDenseIndex = 0u;
+    }
+}
@@ -0,0 +1,314 @@
+#include "Pch.hpp"
+
+#include "ShaderCache.hpp"
+
+namespace nether::ShaderCache
+{
+    // Stored in front of the bytecode of every entry, so truncated / corrupted / stale files are detected and treated as a miss.
+    struct EntryHeader
+    {
+        static constexpr uint32_t MAGIC = 0x4E534843u; // "NSHC".
+        static constexpr uint32_t VERSION = 1u;
+
+        uint32_t magic{MAGIC};
+        uint32_t version{VERSION};
+        uint64_t key{};
+        uint64_t bytecodeSize{};
+        uint64_t bytecodeHash{};
+    };
+
+    std::filesystem::path cacheDirectory{};
+    uint64_t maxCacheSizeInBytes{};
+
+    // Guards eviction, so two threads storing at the same time do not both walk and delete from the directory.
+    std::mutex evictionMutex{};
+
+    // Makes temporary file names unique across processes sharing the cache directory, the counter makes them unique within a process.
+    const uint64_t processNonce = std::random_device{}();
+    std::atomic<uint64_t> temporaryFileCounter{};
+
+    template <typename T> inline uint64_t hashValue(const T& value, const uint64_t seed) { return hashBytes(std::as_bytes(std::span(&value, 1u)), seed); }
+
+    inline std::optional<std::vector<std::byte>> tryReadFile(const std::filesystem::path& filePath)
+    {
+        std::ifstream file(filePath, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+        {
+            return std::nullopt;
+        }
+
+        std::vector<std::byte> buffer(static_cast<size_t>(file.tellg()));
+        file.seekg(0u);
+        file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        return buffer;
+    }
+
+    inline std::filesystem::path getEntryPath(const uint64_t key) { return cacheDirectory / std::format("{:016x}.dxil", key); }
+
+    // Finds the quoted / angled path of a #include directive, or returns a empty view if the line is not one.
+    inline std::string_view parseIncludeDirective(std::string_view line)
+    {
+        const auto skipWhitespace = [&]()
+        {
+            while (!line.empty() && (line.front() == ' ' || line.front() == '\t'))
+            {
+                line.remove_prefix(1u);
+            }
+        };
+
+        skipWhitespace();
+        if (!line.starts_with('#'))
+        {
+            return {};
+        }
+
+        line.remove_prefix(1u);
+        skipWhitespace();
+
+        if (!line.starts_with("include"))
+        {
+            return {};
+        }
+
+        line.remove_prefix(std::string_view("include").size());
+        skipWhitespace();
+
+        if (line.empty() || (line.front() != '"' && line.front() != '<'))
+        {
+            return {};
+        }
+
+        const char closingDelimiter = line.front() == '"' ? '"' : '>';
+        line.remove_prefix(1u);
+
+        const size_t end = line.find(closingDelimiter);
+        return end == std::string_view::npos ? std::string_view{} : line.substr(0u, end);
+    }
+
+    // Hashes the contents of the file, then recurses into its includes. This is a textual scan (includes inside disabled #if blocks are hashed too), which can only cause
+    // extra misses, never stale hits.
+    void hashFileAndIncludes(const std::filesystem::path& filePath,
+                             const std::span<const std::filesystem::path> includeDirectories,
+                             std::vector<std::filesystem::path>& visitedFiles,
+                             uint64_t& hash)
+    {
+        const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath);
+        if (std::ranges::find(visitedFiles, canonicalPath) != visitedFiles.end())
+        {
+            return;
+        }
+
+        visitedFiles.push_back(canonicalPath);
+
+        const std::optional<std::vector<std::byte>> contents = tryReadFile(canonicalPath);
+        if (!contents.has_value())
+        {
+            // Missing files still change the key, so the compiler gets to report the error.
+            const std::string missingMarker = "missing:" + canonicalPath.generic_string();
+            hash = hashBytes(std::as_bytes(std::span(missingMarker)), hash);
+            return;
+        }
+
+        hash = hashBytes(*contents, hash);
+
+        const std::string_view source(reinterpret_cast<const char*>(contents->data()), contents->size());
+        for (const auto lineRange : std::views::split(source, '\n'))
+        {
+            const std::string_view includePath = parseIncludeDirective(std::string_view(lineRange.begin(), lineRange.end()));
+            if (includePath.empty())
+            {
+                continue;
+            }
+
+            // Same search order as the compiler: relative to the including file first, then the include directories.
+            std::filesystem::path resolvedPath = canonicalPath.parent_path() / includePath;
+            for (const std::filesystem::path& includeDirectory : includeDirectories)
+            {
+                if (std::filesystem::exists(resolvedPath))
+                {
+                    break;
+                }
+
+                resolvedPath = includeDirectory / includePath;
+            }
+
+            hash = hashBytes(std::as_bytes(std::span(includePath)), hash);
+            hashFileAndIncludes(resolvedPath, includeDirectories, visitedFiles, hash);
+        }
+    }
+
+    void evictLeastRecentlyUsedEntries()
+    {
+        const std::scoped_lock lock(evictionMutex);
+
+        struct Entry
+        {
+            std::filesystem::path path{};
+            std::filesystem::file_time_type lastUseTime{};
+            uint64_t size{};
+        };
+
+        std::vector<Entry> entries{};
+        uint64_t totalSize{};
+
+        std::error_code errorCode{};
+        for (const std::filesystem::directory_entry& directoryEntry : std::filesystem::directory_iterator(cacheDirectory, errorCode))
+        {
+            if (!directoryEntry.is_regular_file(errorCode) || directoryEntry.path().extension() != ".dxil")
+            {
+                continue;
+            }
+
+            const Entry& entry = entries.emplace_back(Entry{
+                .path = directoryEntry.path(),
+                .lastUseTime = directoryEntry.last_write_time(errorCode),
+                .size = directoryEntry.file_size(errorCode),
+            });
+
+            totalSize += entry.size;
+        }
+
+        if (totalSize <= maxCacheSizeInBytes)
+        {
+            return;
+        }
+
+        std::ranges::sort(entries, {}, &Entry::lastUseTime);
+
+        for (const Entry& entry : entries)
+        {
+            if (totalSize <= maxCacheSizeInBytes)
+            {
+                break;
+            }
+
+            // Another process might have removed the file already, which is fine.
+            std::filesystem::remove(entry.path, errorCode);
+            totalSize -= entry.size;
+        }
+    }
+
+    void setCacheDirectory(const std::filesystem::path& directory, const uint64_t maxSizeInBytes)
+    {
+        if (!directory.empty())
+        {
+            std::filesystem::create_directories(directory);
+        }
+
+        cacheDirectory = directory;
+        maxCacheSizeInBytes = maxSizeInBytes;
+    }
+
+    uint64_t computeKey(const std::filesystem::path& shaderPath,
+                        const std::span<const std::filesystem::path> includeDirectories,
+                        const std::span<const wchar_t* const> compilationArguments,
+                        const uint64_t compilerVersion,
+                        std::vector<std::filesystem::path>* const dependencies)
+    {
+        uint64_t hash = hashValue(EntryHeader::VERSION, FNV_OFFSET_BASIS);
+        hash = hashValue(compilerVersion, hash);
+
+        // The null terminator is hashed as well, so that ("-E", "VsMain") and ("-EVs", "Main") hash differently.
+        for (const wchar_t* const argument : compilationArguments)
+        {
+            const std::wstring_view argumentView(argument);
+            hash = hashBytes(std::as_bytes(std::span(argumentView.data(), argumentView.size() + 1u)), hash);
+        }
+
+        std::vector<std::filesystem::path> visitedFiles{};
+        hashFileAndIncludes(shaderPath, includeDirectories, visitedFiles, hash);
+
+        if (dependencies)
+        {
+            *dependencies = std::move(visitedFiles);
+        }
+
+        return hash;
+    }
+
+    std::optional<std::vector<std::byte>> load(const uint64_t key)
+    {
+        if (cacheDirectory.empty())
+        {
+            return std::nullopt;
+        }
+
+        const std::filesystem::path entryPath = getEntryPath(key);
+
+        std::optional<std::vector<std::byte>> entry = tryReadFile(entryPath);
+        if (!entry.has_value() || entry->size() < sizeof(EntryHeader))
+        {
+            return std::nullopt;
+        }
+
+        EntryHeader header{};
+        std::memcpy(&header, entry->data(), sizeof(EntryHeader));
+
+        const std::span<const std::byte> bytecode = std::span(*entry).subspan(sizeof(EntryHeader));
+
+        const bool isValid = header.magic == EntryHeader::MAGIC && header.version == EntryHeader::VERSION && header.key == key && header.bytecodeSize == bytecode.size() &&
+                             header.bytecodeHash == hashBytes(bytecode);
+        if (!isValid)
+        {
+            std::error_code errorCode{};
+            std::filesystem::remove(entryPath, errorCode);
+            return std::nullopt;
+        }
+
+        // The write time doubles as the last use time for eviction.
+        std::error_code errorCode{};
+        std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), errorCode);
+
+        entry->erase(entry->begin(), entry->begin() + sizeof(EntryHeader));
+        return entry;
+    }
+
+    void store(const uint64_t key, const std::span<const std::byte> bytecode)
+    {
+        if (cacheDirectory.empty())
+        {
+            return;
+        }
+
+        const EntryHeader header = {
+            .key = key,
+            .bytecodeSize = bytecode.size(),
+            .bytecodeHash = hashBytes(bytecode),
+        };
+
+        // The rename replaces the entry in a single step, so readers never see a partially written entry.
+        const std::filesystem::path entryPath = getEntryPath(key);
+        const std::filesystem::path temporaryPath =
+            entryPath.string() + std::format(".{:x}.{}.tmp", processNonce, temporaryFileCounter.fetch_add(1u));
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(EntryHeader));
+            file.write(reinterpret_cast<const char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+
+            if (!file)
+            {
+                // Failing to cache is not fatal, the shader just gets compiled again next time.
+                std::error_code errorCode{};
+                std::filesystem::remove(temporaryPath, errorCode);
+                return;
+            }
+        }
+
+        std::error_code errorCode{};
+        std::filesystem::rename(temporaryPath, entryPath, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryPath, errorCode);
+            return;
+        }
+
+        evictLeastRecentlyUsedEntries();
+    }
+}
@@ -1,57 +1,311 @@
 #include "Pch.hpp"
 
 #include "ShaderCompiler.hpp"
+#include "ShaderCache.hpp"
+#include "EmbeddedShaders.hpp"
 
 namespace nether::ShaderCompiler
 {
-    // Responsible for the actual compilation of shaders.
-    Comptr<IDxcCompiler3> compiler{};
+    // DXC objects are not thread safe, so every thread that compiles shaders gets its own set.
+    struct CompilerContext
+    {
+        // Responsible for the actual compilation of shaders.
+        Comptr<IDxcCompiler3> compiler{};
 
-    // Used to create include handle and provides interfaces for loading shader to blob, etc.
-    Comptr<IDxcUtils> utils{};
-    Comptr<IDxcIncludeHandler> includeHandler{};
-    std::wstring shaderDirectory{};
+        // Used to create include handle and provides interfaces for loading shader to blob, etc.
+        Comptr<IDxcUtils> utils{};
+        Comptr<IDxcIncludeHandler> includeHandler{};
+    };
+
+    thread_local CompilerContext compilerContext{};
 
-    Shader compile(const ShaderTypes& shaderType, const std::wstring_view shaderPath)
+    // Wraps bytecode that is part of the executable, so embedded shaders can be used as a IDxcBlob without DXC or a copy.
+    class EmbeddedShaderBlob final : public IDxcBlob
     {
-        Shader shader{};
+      public:
+        explicit EmbeddedShaderBlob(const EmbeddedShader& embeddedShader) : m_embeddedShader(embeddedShader) {}
+
+        LPVOID STDMETHODCALLTYPE GetBufferPointer() override { return const_cast<uint8_t*>(m_embeddedShader.bytecode); }
+        SIZE_T STDMETHODCALLTYPE GetBufferSize() override { return m_embeddedShader.bytecodeSize; }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+        {
+            if (riid == __uuidof(IDxcBlob) || riid == __uuidof(IUnknown))
+            {
+                AddRef();
+                *ppvObject = this;
+                return S_OK;
+            }
+
+            *ppvObject = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override { return ++m_referenceCount; }
+
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            const ULONG referenceCount = --m_referenceCount;
+            if (referenceCount == 0u)
+            {
+                delete this;
+            }
+
+            return referenceCount;
+        }
+
+      private:
+        const EmbeddedShader& m_embeddedShader;
+        std::atomic<ULONG> m_referenceCount{1u};
+    };
+
+    std::string loadEmbeddedShader(const ShaderTypes shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines, Shader& shader)
+    {
+        static const std::unordered_map<std::string_view, const EmbeddedShader*> embeddedShaders = []()
+        {
+            std::unordered_map<std::string_view, const EmbeddedShader*> embeddedShaders{};
+            for (const EmbeddedShader& embeddedShader : getEmbeddedShaders())
+            {
+                embeddedShaders[embeddedShader.key] = &embeddedShader;
+            }
+
+            return embeddedShaders;
+        }();
+
+        const std::string key = getEmbeddedShaderKey(shaderType, shaderPath, defines);
+
+        const auto it = embeddedShaders.find(key);
+        if (it == embeddedShaders.end())
+        {
+            return "Shader " + key + " was not baked, add it to the bakedShaders list in premake5.lua.";
+        }
+
+        // The reference is adopted, not added.
+        shader.shaderBlob.Attach(new EmbeddedShaderBlob(*it->second));
+        return {};
+    }
+
+    // Forwards to the default include handler, and records every file that was included. Lives on the stack for the duration of a single compilation, so reference
+    // counting is not needed.
+    class DependencyRecordingIncludeHandler final : public IDxcIncludeHandler
+    {
+      public:
+        DependencyRecordingIncludeHandler(IDxcIncludeHandler* const defaultIncludeHandler, std::vector<std::filesystem::path>& includedFiles)
+            : m_defaultIncludeHandler(defaultIncludeHandler), m_includedFiles(includedFiles)
+        {
+        }
 
-        if (!utils)
+        HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override
         {
-            throwIfFailed(::DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils)));
-            throwIfFailed(::DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler)));
-            throwIfFailed(utils->CreateDefaultIncludeHandler(&includeHandler));
+            const HRESULT hr = m_defaultIncludeHandler->LoadSource(pFilename, ppIncludeSource);
+            if (SUCCEEDED(hr))
+            {
+                m_includedFiles.push_back(std::filesystem::weakly_canonical(pFilename));
+            }
 
-            // Find the base shader directory.
-            // Find the shader's base directory.
-            std::filesystem::path currentDirectory = std::filesystem::current_path();
+            return hr;
+        }
 
-            while (!std::filesystem::exists(currentDirectory / "shaders"))
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+        {
+            if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown))
             {
-                if (currentDirectory.has_parent_path())
+                *ppvObject = this;
+                return S_OK;
+            }
+
+            *ppvObject = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override { return 1u; }
+        ULONG STDMETHODCALLTYPE Release() override { return 1u; }
+
+      private:
+        IDxcIncludeHandler* m_defaultIncludeHandler{};
+        std::vector<std::filesystem::path>& m_includedFiles;
+    };
+
+    // Shared by all threads, set up once by the first compile.
+    std::once_flag initFlag{};
+    std::wstring shaderDirectory{};
+
+    // Part of the shader cache key, so that updating DXC invalidates the cache.
+    uint64_t compilerVersion{};
+
+    // Least recently used entries are evicted above this size.
+    constexpr uint64_t MAX_SHADER_CACHE_SIZE_IN_BYTES = 64u * 1024u * 1024u;
+
+    void init()
+    {
+        // Find the shader's base directory.
+        std::filesystem::path currentDirectory = std::filesystem::current_path();
+
+        while (!std::filesystem::exists(currentDirectory / "shaders"))
+        {
+            if (currentDirectory.has_parent_path())
+            {
+                currentDirectory = currentDirectory.parent_path();
+            }
+            else
+            {
+                fatalError(L"Shaders Directory not found!");
+            }
+        }
+
+        const std::filesystem::path shadersDirectory = currentDirectory / "shaders/";
+
+        if (!std::filesystem::is_directory(shadersDirectory))
+        {
+            fatalError(L"Shaders Directory that was located is not a directory!");
+        }
+
+        shaderDirectory = currentDirectory.wstring() + L"/shaders/";
+
+        debugLog(L"Shader base directory : " + shaderDirectory);
+
+        Comptr<IDxcVersionInfo> versionInfo{};
+        throwIfFailed(::DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&versionInfo)));
+
+        uint32_t majorVersion{};
+        uint32_t minorVersion{};
+        throwIfFailed(versionInfo->GetVersion(&majorVersion, &minorVersion));
+        compilerVersion = (static_cast<uint64_t>(majorVersion) << 32u) | minorVersion;
+
+        ShaderCache::setCacheDirectory(currentDirectory / ".shader_cache", MAX_SHADER_CACHE_SIZE_IN_BYTES);
+    }
+
+    std::string_view getShaderTypeName(const ShaderTypes shaderType)
+    {
+        switch (shaderType)
+        {
+            case ShaderTypes::Vertex:
                 {
-                    currentDirectory = currentDirectory.parent_path();
+                    return "Vertex";
                 }
-                else
+                break;
+
+            case ShaderTypes::Pixel:
                 {
-                    fatalError(L"Shaders Directory not found!");
+                    return "Pixel";
                 }
-            }
+                break;
 
-            const std::filesystem::path shadersDirectory = currentDirectory / "shaders/";
+            case ShaderTypes::Compute:
+                {
+                    return "Compute";
+                }
+                break;
 
-            if (!std::filesystem::is_directory(shadersDirectory))
+            default:
+                {
+                    return "Unknown";
+                }
+                break;
+        }
+    }
+
+    CompilerContext& getCompilerContext()
+    {
+        std::call_once(initFlag, init);
+
+        if (!compilerContext.compiler)
+        {
+            throwIfFailed(::DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&compilerContext.utils)));
+            throwIfFailed(::DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compilerContext.compiler)));
+            throwIfFailed(compilerContext.utils->CreateDefaultIncludeHandler(&compilerContext.includeHandler));
+        }
+
+        return compilerContext;
+    }
+
+    // Reads the members of the root constant buffer (register b0, space0) from the reflection data DXC outputs next to the bytecode. Reflection reports usage per buffer
+    // and not per member, so every member the shader declares counts as read.
+    void reflectRootConstants(IDxcUtils* const utils, const std::span<const std::byte> reflectionData, std::vector<ReflectedRootConstant>& rootConstants)
+    {
+        const DxcBuffer reflectionBuffer{
+            .Ptr = reflectionData.data(),
+            .Size = reflectionData.size(),
+            .Encoding = 0u,
+        };
+
+        Comptr<ID3D12ShaderReflection> shaderReflection{};
+        throwIfFailed(utils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&shaderReflection)));
+
+        D3D12_SHADER_DESC shaderDesc{};
+        throwIfFailed(shaderReflection->GetDesc(&shaderDesc));
+
+        for (const uint32_t resourceIndex : std::views::iota(0u, shaderDesc.BoundResources))
+        {
+            D3D12_SHADER_INPUT_BIND_DESC bindDesc{};
+            throwIfFailed(shaderReflection->GetResourceBindingDesc(resourceIndex, &bindDesc));
+
+            if (bindDesc.Type != D3D_SIT_CBUFFER || bindDesc.BindPoint != 0u || bindDesc.Space != 0u)
             {
-                fatalError(L"Shaders Directory that was located is not a directory!");
+                continue;
             }
 
-            shaderDirectory = currentDirectory.wstring() + L"/shaders/";
+            ID3D12ShaderReflectionConstantBuffer* const constantBuffer = shaderReflection->GetConstantBufferByName(bindDesc.Name);
+
+            D3D12_SHADER_BUFFER_DESC bufferDesc{};
+            throwIfFailed(constantBuffer->GetDesc(&bufferDesc));
+
+            // ConstantBuffer<T> is reflected as a single variable of type T, a cbuffer block as one variable per member.
+            for (const uint32_t variableIndex : std::views::iota(0u, bufferDesc.Variables))
+            {
+                ID3D12ShaderReflectionVariable* const variable = constantBuffer->GetVariableByIndex(variableIndex);
+
+                D3D12_SHADER_VARIABLE_DESC variableDesc{};
+                throwIfFailed(variable->GetDesc(&variableDesc));
 
-            debugLog(L"Shader base directory : " + shaderDirectory);
+                ID3D12ShaderReflectionType* const variableType = variable->GetType();
+
+                D3D12_SHADER_TYPE_DESC variableTypeDesc{};
+                throwIfFailed(variableType->GetDesc(&variableTypeDesc));
+
+                // Root constants are 32 bit values, so every component is 4 bytes.
+                const auto getSizeInBytes = [](const D3D12_SHADER_TYPE_DESC& typeDesc)
+                { return typeDesc.Rows * typeDesc.Columns * std::max(typeDesc.Elements, 1u) * static_cast<uint32_t>(sizeof(uint32_t)); };
+
+                if (variableTypeDesc.Class != D3D_SVC_STRUCT)
+                {
+                    rootConstants.push_back(ReflectedRootConstant{
+                        .name = variableDesc.Name,
+                        .offsetInBytes = variableDesc.StartOffset,
+                        .sizeInBytes = getSizeInBytes(variableTypeDesc),
+                    });
+
+                    continue;
+                }
+
+                for (const uint32_t memberIndex : std::views::iota(0u, variableTypeDesc.Members))
+                {
+                    D3D12_SHADER_TYPE_DESC memberTypeDesc{};
+                    throwIfFailed(variableType->GetMemberTypeByIndex(memberIndex)->GetDesc(&memberTypeDesc));
+
+                    rootConstants.push_back(ReflectedRootConstant{
+                        .name = variableType->GetMemberTypeName(memberIndex),
+                        .offsetInBytes = variableDesc.StartOffset + memberTypeDesc.Offset,
+                        .sizeInBytes = getSizeInBytes(memberTypeDesc),
+                    });
+                }
+            }
         }
+    }
+
+    // The argument list only stores pointers, this owns the strings they point to. Must not be copied or moved once built.
+    struct CompilationArguments
+    {
+        std::wstring entryPoint{};
+        std::wstring targetProfile{};
+        std::vector<std::wstring> defines{};
+
+        std::vector<LPCWSTR> arguments{};
+    };
 
-        // Setup compilation arguments.
-        const std::wstring entryPoint = [=]()
+    void buildCompilationArguments(const ShaderTypes shaderType, const std::span<const ShaderDefine> defines, CompilationArguments& compilationArguments)
+    {
+        compilationArguments.entryPoint = [=]()
         {
             switch (shaderType)
             {
@@ -81,7 +335,7 @@ namespace nether::ShaderCompiler
             }
         }();
 
-        const std::wstring targetProfile = [=]()
+        compilationArguments.targetProfile = [=]()
         {
             switch (shaderType)
             {
@@ -111,11 +365,11 @@ namespace nether::ShaderCompiler
             }
         }();
 
-        std::vector<LPCWSTR> compilationArguments{
+        compilationArguments.arguments = {
             L"-E",
-            entryPoint.c_str(),
+            compilationArguments.entryPoint.c_str(),
             L"-T",
-            targetProfile.c_str(),
+            compilationArguments.targetProfile.c_str(),
             DXC_ARG_PACK_MATRIX_ROW_MAJOR,
             DXC_ARG_WARNINGS_ARE_ERRORS,
             DXC_ARG_ALL_RESOURCES_BOUND,
@@ -123,15 +377,108 @@ namespace nether::ShaderCompiler
             shaderDirectory.c_str(),
         };
 
+        // Each define is passed as -D NAME=VALUE. Reserved up front, so pushing a define does not move the strings that were already pointed to.
+        compilationArguments.defines.reserve(defines.size());
+
+        for (const ShaderDefine& define : defines)
+        {
+            compilationArguments.defines.push_back(define.value.empty() ? define.name : define.name + L"=" + define.value);
+
+            compilationArguments.arguments.push_back(L"-D");
+            compilationArguments.arguments.push_back(compilationArguments.defines.back().c_str());
+        }
+
         // Indicate that the shader should be in a debuggable state if in debug mode.
         // Else, set optimization level to 03.
         if constexpr (NETHER_DEBUG_MODE)
         {
-            compilationArguments.push_back(DXC_ARG_DEBUG);
+            compilationArguments.arguments.push_back(DXC_ARG_DEBUG);
         }
         else
         {
-            compilationArguments.push_back(DXC_ARG_OPTIMIZATION_LEVEL3);
+            compilationArguments.arguments.push_back(DXC_ARG_OPTIMIZATION_LEVEL3);
+        }
+    }
+
+    // Runs only the preprocessor, with the same arguments a compilation would use (the target profile changes the predefined macros).
+    std::string tryPreprocess(const ShaderTypes shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines, std::string& preprocessedSource)
+    {
+        const auto& [compiler, utils, includeHandler] = getCompilerContext();
+
+        CompilationArguments compilationArguments{};
+        buildCompilationArguments(shaderType, defines, compilationArguments);
+        compilationArguments.arguments.push_back(L"-P");
+
+        Comptr<IDxcBlobEncoding> sourceBlob{};
+        throwIfFailed(utils->LoadFile(shaderPath.data(), nullptr, &sourceBlob));
+
+        const DxcBuffer sourceBuffer{
+            .Ptr = sourceBlob->GetBufferPointer(),
+            .Size = sourceBlob->GetBufferSize(),
+            .Encoding = 0u,
+        };
+
+        Microsoft::WRL::ComPtr<IDxcResult> preprocessResult{};
+        const HRESULT hr = compiler->Compile(&sourceBuffer,
+                                             compilationArguments.arguments.data(),
+                                             static_cast<uint32_t>(compilationArguments.arguments.size()),
+                                             includeHandler.Get(),
+                                             IID_PPV_ARGS(&preprocessResult));
+        if (FAILED(hr))
+        {
+            return "Failed to preprocess shader with path : " + wStringToString(shaderPath);
+        }
+
+        Microsoft::WRL::ComPtr<IDxcBlobUtf8> errors{};
+        throwIfFailed(preprocessResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr));
+        if (errors && errors->GetStringLength() > 0)
+        {
+            return std::string(errors->GetStringPointer(), errors->GetStringLength());
+        }
+
+        Microsoft::WRL::ComPtr<IDxcBlobUtf8> preprocessedBlob{};
+        throwIfFailed(preprocessResult->GetOutput(DXC_OUT_HLSL, IID_PPV_ARGS(&preprocessedBlob), nullptr));
+
+        preprocessedSource.assign(preprocessedBlob->GetStringPointer(), preprocessedBlob->GetStringLength());
+        return {};
+    }
+
+    // Compilation errors are returned rather than raised, so that compileBatch can report the errors of all jobs together. Returns a empty string on success.
+    std::string tryCompile(const ShaderTypes shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines, Shader& shader)
+    {
+        if constexpr (NETHER_SHIPPING_MODE)
+        {
+            return loadEmbeddedShader(shaderType, shaderPath, defines, shader);
+        }
+
+        const auto& [compiler, utils, includeHandler] = getCompilerContext();
+
+        CompilationArguments compilationArguments{};
+        buildCompilationArguments(shaderType, defines, compilationArguments);
+
+        // If the bytecode for this exact source / includes / arguments combination is cached, DXC is skipped entirely.
+        const std::array<std::filesystem::path, 1u> includeDirectories = {shaderDirectory};
+        std::vector<std::filesystem::path> scannedDependencies{};
+        const uint64_t cacheKey = ShaderCache::computeKey(shaderPath, includeDirectories, compilationArguments.arguments, compilerVersion, &scannedDependencies);
+
+        // The reflection data is cached as a separate entry, under a key derived from the bytecode's key.
+        constexpr std::string_view reflectionKeyTag = "reflection";
+        const uint64_t reflectionCacheKey = hashBytes(std::as_bytes(std::span(reflectionKeyTag)), cacheKey);
+
+        const std::optional<std::vector<std::byte>> cachedBytecode = ShaderCache::load(cacheKey);
+        const std::optional<std::vector<std::byte>> cachedReflection = cachedBytecode.has_value() ? ShaderCache::load(reflectionCacheKey) : std::nullopt;
+
+        if (cachedBytecode.has_value() && cachedReflection.has_value())
+        {
+            Comptr<IDxcBlobEncoding> cachedShaderBlob{};
+            throwIfFailed(utils->CreateBlob(cachedBytecode->data(), static_cast<uint32_t>(cachedBytecode->size()), DXC_CP_ACP, &cachedShaderBlob));
+
+            // DXC did not run, so the includes found by the cache key's textual scan are used instead. They can be a superset of the real ones, which only causes
+            // extra recompiles.
+            shader.shaderBlob = cachedShaderBlob;
+            shader.dependencies = std::move(scannedDependencies);
+            reflectRootConstants(utils.Get(), *cachedReflection, shader.rootConstants);
+            return {};
         }
 
         // Load the shader source file to a blob.
@@ -145,30 +492,261 @@ namespace nether::ShaderCompiler
         };
 
         // Compile the shader.
+        std::vector<std::filesystem::path> dependencies = {std::filesystem::weakly_canonical(shaderPath)};
+        DependencyRecordingIncludeHandler dependencyRecordingIncludeHandler(includeHandler.Get(), dependencies);
+
         Microsoft::WRL::ComPtr<IDxcResult> compiledShaderBuffer{};
         const HRESULT hr = compiler->Compile(&sourceBuffer,
-                                             compilationArguments.data(),
-                                             static_cast<uint32_t>(compilationArguments.size()),
-                                             includeHandler.Get(),
+                                             compilationArguments.arguments.data(),
+                                             static_cast<uint32_t>(compilationArguments.arguments.size()),
+                                             &dependencyRecordingIncludeHandler,
                                              IID_PPV_ARGS(&compiledShaderBuffer));
         if (FAILED(hr))
         {
-            fatalError(std::wstring(L"Failed to compile shader with path : ") + shaderPath.data());
+            return "Failed to compile shader with path : " + wStringToString(shaderPath);
         }
 
-        // Get compilation errors (if any).
+        // Get compilation errors (if any). Warnings are treated as errors, so any message means the compilation failed.
         Microsoft::WRL::ComPtr<IDxcBlobUtf8> errors{};
         throwIfFailed(compiledShaderBuffer->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr));
         if (errors && errors->GetStringLength() > 0)
         {
-            const LPCSTR errorMessage = errors->GetStringPointer();
-            fatalError(errorMessage);
+            return std::string(errors->GetStringPointer(), errors->GetStringLength());
         }
 
         Comptr<IDxcBlob> compiledShaderBlob{nullptr};
         compiledShaderBuffer->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&compiledShaderBlob), nullptr);
 
+        Comptr<IDxcBlob> reflectionBlob{nullptr};
+        throwIfFailed(compiledShaderBuffer->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflectionBlob), nullptr));
+
+        const std::span<const std::byte> reflectionData(static_cast<const std::byte*>(reflectionBlob->GetBufferPointer()), reflectionBlob->GetBufferSize());
+
+        ShaderCache::store(cacheKey,
+                           std::span(static_cast<const std::byte*>(compiledShaderBlob->GetBufferPointer()), compiledShaderBlob->GetBufferSize()));
+        ShaderCache::store(reflectionCacheKey, reflectionData);
+
         shader.shaderBlob = compiledShaderBlob;
+        shader.dependencies = std::move(dependencies);
+        reflectRootConstants(utils.Get(), reflectionData, shader.rootConstants);
+        return {};
+    }
+
+    // Raises a single fatal error listing the errors of all failed jobs, so fixing a shared header does not take one launch per broken shader.
+    void reportErrors(const std::span<const ShaderCompileJob> jobs, const std::span<const std::string> errorMessages)
+    {
+        std::string aggregatedErrorMessage{};
+        for (const size_t jobIndex : std::views::iota(size_t{0u}, jobs.size()))
+        {
+            if (!errorMessages[jobIndex].empty())
+            {
+                aggregatedErrorMessage += std::format("{} ({}) :\n{}\n", wStringToString(jobs[jobIndex].shaderPath), getShaderTypeName(jobs[jobIndex].shaderType), errorMessages[jobIndex]);
+            }
+        }
+
+        if (!aggregatedErrorMessage.empty())
+        {
+            fatalError(aggregatedErrorMessage);
+        }
+    }
+
+    Shader compile(const ShaderTypes& shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines)
+    {
+        Shader shader{};
+
+        const std::string errorMessage = tryCompile(shaderType, shaderPath, defines, shader);
+        if (!errorMessage.empty())
+        {
+            fatalError(errorMessage);
+        }
+
         return shader;
     }
+
+    std::vector<ShaderCompileResult> tryCompileBatch(JobSystem& jobSystem, const std::span<const ShaderCompileJob> jobs)
+    {
+        std::vector<ShaderCompileResult> results(jobs.size());
+
+        // Batches shrink down to a single shader towards the end, so the threads still finish together even though compile times vary a lot.
+        jobSystem.parallelFor(static_cast<uint32_t>(jobs.size()),
+                              1u,
+                              [&](const uint32_t begin, const uint32_t end)
+                              {
+                                  for (const uint32_t jobIndex : std::views::iota(begin, end))
+                                  {
+                                      const ShaderCompileJob& job = jobs[jobIndex];
+                                      ShaderCompileResult& result = results[jobIndex];
+
+                                      try
+                                      {
+                                          result.errorMessage = tryCompile(job.shaderType, job.shaderPath, job.defines, result.shader);
+                                      }
+                                      catch (const std::exception& exception)
+                                      {
+                                          result.errorMessage = exception.what();
+                                      }
+                                  }
+                              });
+
+        return results;
+    }
+
+    std::vector<Shader> compileBatch(JobSystem& jobSystem, const std::span<const ShaderCompileJob> jobs)
+    {
+        std::vector<ShaderCompileResult> results = tryCompileBatch(jobSystem, jobs);
+
+        std::vector<std::string> errorMessages{};
+        errorMessages.reserve(results.size());
+
+        std::vector<Shader> shaders{};
+        shaders.reserve(results.size());
+
+        for (ShaderCompileResult& result : results)
+        {
+            errorMessages.push_back(std::move(result.errorMessage));
+            shaders.push_back(std::move(result.shader));
+        }
+
+        reportErrors(jobs, errorMessages);
+
+        return shaders;
+    }
+
+    std::string getEmbeddedShaderKey(const ShaderTypes shaderType, const std::wstring_view shaderPath, const std::span<const ShaderDefine> defines)
+    {
+        std::string key = std::format("{}|{}|", wStringToString(shaderPath), getShaderTypeName(shaderType));
+
+        for (const ShaderDefine& define : defines)
+        {
+            key += wStringToString(define.name);
+            if (!define.value.empty())
+            {
+                key += "=" + wStringToString(define.value);
+            }
+
+            if (&define != &defines.back())
+            {
+                key += ";";
+            }
+        }
+
+        return key;
+    }
+
+    std::vector<ShaderVariantKey> getAllVariantKeys(const uint32_t featureCount)
+    {
+        if (featureCount > MAX_SHADER_FEATURE_COUNT)
+        {
+            fatalError(std::format("A shader can have at most {} features, {} were requested.", MAX_SHADER_FEATURE_COUNT, featureCount));
+        }
+
+        std::vector<ShaderVariantKey> variantKeys(1u << featureCount);
+        std::iota(variantKeys.begin(), variantKeys.end(), ShaderVariantKey{0u});
+
+        return variantKeys;
+    }
+
+    ShaderCompileJob getVariantJob(const ShaderPermutationDesc& permutationDesc, const ShaderVariantKey variantKey)
+    {
+        ShaderCompileJob job = {
+            .shaderType = permutationDesc.shaderType,
+            .shaderPath = permutationDesc.shaderPath,
+            .defines = permutationDesc.defines,
+        };
+
+        for (const uint32_t featureIndex : std::views::iota(0u, static_cast<uint32_t>(permutationDesc.features.size())))
+        {
+            job.defines.push_back(ShaderDefine{
+                .name = permutationDesc.features[featureIndex],
+                .value = (variantKey & (1u << featureIndex)) ? L"1" : L"0",
+            });
+        }
+
+        return job;
+    }
+
+    ShaderPermutationSet compilePermutations(JobSystem& jobSystem, const ShaderPermutationDesc& permutationDesc, const std::span<const ShaderVariantKey> variantKeys)
+    {
+        const uint32_t featureCount = static_cast<uint32_t>(permutationDesc.features.size());
+        if (featureCount > MAX_SHADER_FEATURE_COUNT)
+        {
+            fatalError(std::format("A shader can have at most {} features, {} has {}.", MAX_SHADER_FEATURE_COUNT, wStringToString(permutationDesc.shaderPath), featureCount));
+        }
+
+        const uint32_t variantCount = 1u << featureCount;
+
+        std::vector<ShaderCompileJob> variantJobs{};
+        variantJobs.reserve(variantKeys.size());
+
+        for (const ShaderVariantKey variantKey : variantKeys)
+        {
+            if (variantKey >= variantCount)
+            {
+                fatalError(std::format("Shader variant {} is out of range, {} has {} features.", variantKey, wStringToString(permutationDesc.shaderPath), featureCount));
+            }
+
+            variantJobs.push_back(getVariantJob(permutationDesc, variantKey));
+        }
+
+        ShaderPermutationSet permutationSet = {
+            .shaderIndices = std::vector<uint32_t>(variantCount, ShaderPermutationSet::INVALID_INDEX),
+        };
+
+        // Embedded variants were already deduplicated by bake-shaders (variants with identical bytecode share it), so they are only looked up.
+        if constexpr (NETHER_SHIPPING_MODE)
+        {
+            permutationSet.shaders = compileBatch(jobSystem, variantJobs);
+
+            for (const uint32_t jobIndex : std::views::iota(0u, static_cast<uint32_t>(variantJobs.size())))
+            {
+                permutationSet.shaderIndices[variantKeys[jobIndex]] = jobIndex;
+            }
+
+            return permutationSet;
+        }
+
+        // Preprocessing is a lot cheaper than compiling, and finds the variants whose defines do not change the code.
+        std::vector<std::string> preprocessedSources(variantJobs.size());
+        std::vector<std::string> errorMessages(variantJobs.size());
+
+        jobSystem.parallelFor(static_cast<uint32_t>(variantJobs.size()),
+                              1u,
+                              [&](const uint32_t begin, const uint32_t end)
+                              {
+                                  for (const uint32_t jobIndex : std::views::iota(begin, end))
+                                  {
+                                      const ShaderCompileJob& job = variantJobs[jobIndex];
+
+                                      try
+                                      {
+                                          errorMessages[jobIndex] = tryPreprocess(job.shaderType, job.shaderPath, job.defines, preprocessedSources[jobIndex]);
+                                      }
+                                      catch (const std::exception& exception)
+                                      {
+                                          errorMessages[jobIndex] = exception.what();
+                                      }
+                                  }
+                              });
+
+        reportErrors(variantJobs, errorMessages);
+
+        // Only the first variant with a given preprocessed source is compiled.
+        std::unordered_map<std::string_view, uint32_t> uniqueShaderIndices{};
+        std::vector<ShaderCompileJob> uniqueJobs{};
+
+        for (const size_t jobIndex : std::views::iota(size_t{0u}, variantJobs.size()))
+        {
+            const auto [it, isUnique] = uniqueShaderIndices.try_emplace(preprocessedSources[jobIndex], static_cast<uint32_t>(uniqueJobs.size()));
+            if (isUnique)
+            {
+                uniqueJobs.push_back(std::move(variantJobs[jobIndex]));
+            }
+
+            permutationSet.shaderIndices[variantKeys[jobIndex]] = it->second;
+        }
+
+        permutationSet.shaders = compileBatch(jobSystem, uniqueJobs);
+
+        return permutationSet;
+    }
 }
@@ -0,0 +1,51 @@
+#include "Pch.hpp"
+
+#include "ShaderDependencyGraph.hpp"
+
+namespace nether
+{
+    void ShaderDependencyGraph::setDependencies(const uint32_t programIndex, const std::span<const std::filesystem::path> dependencies)
+    {
+        if (programIndex >= m_programDependencies.size())
+        {
+            m_programDependencies.resize(programIndex + 1u);
+        }
+
+        // Remove the program from the files it used to depend on.
+        for (const std::filesystem::path& dependency : m_programDependencies[programIndex])
+        {
+            std::vector<uint32_t>& dependentPrograms = m_dependentPrograms[dependency.native()];
+            std::erase(dependentPrograms, programIndex);
+        }
+
+        m_programDependencies[programIndex].assign(dependencies.begin(), dependencies.end());
+
+        for (const std::filesystem::path& dependency : dependencies)
+        {
+            std::vector<uint32_t>& dependentPrograms = m_dependentPrograms[dependency.native()];
+            if (std::ranges::find(dependentPrograms, programIndex) == dependentPrograms.end())
+            {
+                dependentPrograms.push_back(programIndex);
+            }
+        }
+    }
+
+    std::vector<uint32_t> ShaderDependencyGraph::getAffectedPrograms(const std::span<const std::filesystem::path> changedFiles) const
+    {
+        std::vector<uint32_t> affectedPrograms{};
+
+        for (const std::filesystem::path& changedFile : changedFiles)
+        {
+            if (const auto it = m_dependentPrograms.find(changedFile.native()); it != m_dependentPrograms.end())
+            {
+                affectedPrograms.insert(affectedPrograms.end(), it->second.begin(), it->second.end());
+            }
+        }
+
+        std::ranges::sort(affectedPrograms);
+        const auto duplicates = std::ranges::unique(affectedPrograms);
+        affectedPrograms.erase(duplicates.begin(), duplicates.end());
+
+        return affectedPrograms;
+    }
+}
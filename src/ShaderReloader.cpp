@@ -0,0 +1,133 @@
+#include "Pch.hpp"
+
+#include "ShaderReloader.hpp"
+#include "Profiler.hpp"
+
+namespace nether
+{
+    ShaderReloader::ShaderReloader(JobSystem& jobSystem, const FileWatcher::Clock::duration pollInterval, const FileWatcher::Clock::duration debounceDuration)
+        : m_jobSystem(jobSystem), m_pollInterval(pollInterval), m_fileWatcher(debounceDuration), m_watchThread([this](const std::stop_token stopToken) { watchLoop(stopToken); })
+    {
+    }
+
+    uint32_t ShaderReloader::addProgram(const std::span<const ShaderCompileJob> jobs, const std::span<const Shader> shaders)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        const uint32_t programIndex = static_cast<uint32_t>(m_programJobs.size());
+        m_programJobs.emplace_back(jobs.begin(), jobs.end());
+
+        std::vector<std::filesystem::path> dependencies{};
+        for (const Shader& shader : shaders)
+        {
+            dependencies.insert(dependencies.end(), shader.dependencies.begin(), shader.dependencies.end());
+        }
+
+        m_dependencyGraph.setDependencies(programIndex, dependencies);
+
+        for (const std::filesystem::path& dependency : dependencies)
+        {
+            m_fileWatcher.watch(dependency);
+        }
+
+        return programIndex;
+    }
+
+    std::vector<ReloadedProgram> ShaderReloader::takeReloadedPrograms()
+    {
+        const std::scoped_lock lock(m_mutex);
+        return std::exchange(m_reloadedPrograms, {});
+    }
+
+    void ShaderReloader::watchLoop(const std::stop_token stopToken)
+    {
+        NETHER_PROFILE_THREAD("Shader reloader");
+
+        while (!stopToken.stop_requested())
+        {
+            std::vector<uint32_t> affectedPrograms{};
+
+            {
+                std::unique_lock lock(m_mutex);
+
+                // Wakes up early if a stop is requested, so destroying the reloader does not wait for the poll interval.
+                m_stopRequested.wait_for(lock, stopToken, m_pollInterval, []() { return false; });
+                if (stopToken.stop_requested())
+                {
+                    return;
+                }
+
+                const std::vector<std::filesystem::path> changedFiles = m_fileWatcher.poll(FileWatcher::Clock::now());
+                affectedPrograms = m_dependencyGraph.getAffectedPrograms(changedFiles);
+            }
+
+            if (!affectedPrograms.empty())
+            {
+                reloadPrograms(affectedPrograms);
+            }
+        }
+    }
+
+    void ShaderReloader::reloadPrograms(const std::span<const uint32_t> programIndices)
+    {
+        NETHER_PROFILE_SCOPE("ShaderReloader::reloadPrograms");
+
+        // The shaders of all affected programs are compiled as one batch, so a change to a shared header recompiles everything in parallel.
+        std::vector<ShaderCompileJob> jobs{};
+        {
+            const std::scoped_lock lock(m_mutex);
+            for (const uint32_t programIndex : programIndices)
+            {
+                jobs.insert(jobs.end(), m_programJobs[programIndex].begin(), m_programJobs[programIndex].end());
+            }
+        }
+
+        std::vector<ShaderCompileResult> results = ShaderCompiler::tryCompileBatch(m_jobSystem, jobs);
+
+        const std::scoped_lock lock(m_mutex);
+
+        size_t firstResult{};
+        for (const uint32_t programIndex : programIndices)
+        {
+            const std::span<ShaderCompileResult> programResults = std::span(results).subspan(firstResult, m_programJobs[programIndex].size());
+            firstResult += programResults.size();
+
+            bool hasFailed{};
+            for (const size_t resultIndex : std::views::iota(size_t{0u}, programResults.size()))
+            {
+                if (!programResults[resultIndex].errorMessage.empty())
+                {
+                    debugLog(L"Failed to reload shader " + m_programJobs[programIndex][resultIndex].shaderPath + L" : " + stringToWString(programResults[resultIndex].errorMessage));
+                    hasFailed = true;
+                }
+            }
+
+            if (hasFailed)
+            {
+                continue;
+            }
+
+            ReloadedProgram reloadedProgram = {
+                .programIndex = programIndex,
+            };
+
+            std::vector<std::filesystem::path> dependencies{};
+            for (ShaderCompileResult& result : programResults)
+            {
+                dependencies.insert(dependencies.end(), result.shader.dependencies.begin(), result.shader.dependencies.end());
+                reloadedProgram.shaders.push_back(std::move(result.shader));
+            }
+
+            // The edit might have added includes.
+            m_dependencyGraph.setDependencies(programIndex, dependencies);
+            for (const std::filesystem::path& dependency : dependencies)
+            {
+                m_fileWatcher.watch(dependency);
+            }
+
+            // A program that was reloaded again before the engine took it only needs the latest shaders.
+            std::erase_if(m_reloadedPrograms, [&](const ReloadedProgram& program) { return program.programIndex == programIndex; });
+            m_reloadedPrograms.push_back(std::move(reloadedProgram));
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include "Pch.hpp"
+
+#include "TransformKernel.hpp"
+#include "CpuFeatures.hpp"
+
+#include <immintrin.h>
+
+namespace nether::TransformKernel
+{
+    // All the unique values of the local and normal matrix of a object (or a lane of objects). The remaining entries are constants.
+    template <typename T> struct ComposedTransform
+    {
+        // local[i][j] for rows 0..2, columns 0..2, and the translation row.
+        std::array<std::array<T, 3u>, 4u> local{};
+        std::array<std::array<T, 3u>, 3u> normal{};
+    };
+
+    // Scalar lane, used for the tail of the batch and when AVX2 is not available.
+    inline void sinCos(float& sin, float& cos, const float value) { math::XMScalarSinCos(&sin, &cos, value); }
+    inline float reciprocal(const float value) { return 1.0f / value; }
+
+    // 8 wide lane. Only used by CPUs with AVX2 (see composeAvx2).
+    struct Float8
+    {
+        __m256 v{};
+    };
+
+    NETHER_AVX2_FUNCTION inline Float8 operator+(const Float8 a, const Float8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+    NETHER_AVX2_FUNCTION inline Float8 operator-(const Float8 a, const Float8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    NETHER_AVX2_FUNCTION inline Float8 operator*(const Float8 a, const Float8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    NETHER_AVX2_FUNCTION inline Float8 operator-(const Float8 a) { return {_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))}; }
+
+    NETHER_AVX2_FUNCTION inline Float8 reciprocal(const Float8 value) { return {_mm256_div_ps(_mm256_set1_ps(1.0f), value.v)}; }
+
+    NETHER_AVX2_FUNCTION inline Float8 loadFloat8(const float* const data) { return {_mm256_loadu_ps(data)}; }
+
+    // Port of XMScalarSinCos to 8 lanes, so both paths produce the same results (11 degree minimax approximation for sin, 10 degree for cos).
+    NETHER_AVX2_FUNCTION inline void sinCos(Float8& sin, Float8& cos, const Float8 value)
+    {
+        // Map value to y in [-pi, pi], value = 2 * pi * quotient + remainder.
+        const __m256 quotient = _mm256_round_ps(_mm256_mul_ps(value.v, _mm256_set1_ps(math::XM_1DIV2PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256 y = _mm256_sub_ps(value.v, _mm256_mul_ps(quotient, _mm256_set1_ps(math::XM_2PI)));
+
+        // Map y to [-pi / 2, pi / 2] with sin(y) = sin(value). If y was reflected, the sign of cos flips.
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 absY = _mm256_andnot_ps(signMask, y);
+        const __m256 reflectedY = _mm256_sub_ps(_mm256_or_ps(_mm256_set1_ps(math::XM_PI), _mm256_and_ps(signMask, y)), y);
+        const __m256 reflectMask = _mm256_cmp_ps(absY, _mm256_set1_ps(math::XM_PIDIV2), _CMP_GT_OQ);
+
+        y = _mm256_blendv_ps(y, reflectedY, reflectMask);
+        const __m256 cosSign = _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_set1_ps(-1.0f), reflectMask);
+
+        const __m256 y2 = _mm256_mul_ps(y, y);
+
+        __m256 sinPolynomial = _mm256_set1_ps(-2.3889859e-08f);
+        sinPolynomial = _mm256_add_ps(_mm256_mul_ps(sinPolynomial, y2), _mm256_set1_ps(2.7525562e-06f));
+        sinPolynomial = _mm256_add_ps(_mm256_mul_ps(sinPolynomial, y2), _mm256_set1_ps(-0.00019840874f));
+        sinPolynomial = _mm256_add_ps(_mm256_mul_ps(sinPolynomial, y2), _mm256_set1_ps(0.0083333310f));
+        sinPolynomial = _mm256_add_ps(_mm256_mul_ps(sinPolynomial, y2), _mm256_set1_ps(-0.16666667f));
+        sinPolynomial = _mm256_add_ps(_mm256_mul_ps(sinPolynomial, y2), _mm256_set1_ps(1.0f));
+        sin.v = _mm256_mul_ps(sinPolynomial, y);
+
+        __m256 cosPolynomial = _mm256_set1_ps(-2.6051615e-07f);
+        cosPolynomial = _mm256_add_ps(_mm256_mul_ps(cosPolynomial, y2), _mm256_set1_ps(2.4760495e-05f));
+        cosPolynomial = _mm256_add_ps(_mm256_mul_ps(cosPolynomial, y2), _mm256_set1_ps(-0.0013888378f));
+        cosPolynomial = _mm256_add_ps(_mm256_mul_ps(cosPolynomial, y2), _mm256_set1_ps(0.041666638f));
+        cosPolynomial = _mm256_add_ps(_mm256_mul_ps(cosPolynomial, y2), _mm256_set1_ps(-0.5f));
+        cosPolynomial = _mm256_add_ps(_mm256_mul_ps(cosPolynomial, y2), _mm256_set1_ps(1.0f));
+        cos.v = _mm256_mul_ps(cosPolynomial, cosSign);
+    }
+
+    // The actual math, written once for both the scalar and the 8 wide lane types.
+    template <typename T>
+    NETHER_FORCE_INLINE ComposedTransform<T> composeLane(const T translateX,
+                                            const T translateY,
+                                            const T translateZ,
+                                            const T rotateX,
+                                            const T rotateY,
+                                            const T rotateZ,
+                                            const T scaleX,
+                                            const T scaleY,
+                                            const T scaleZ)
+    {
+        T sinX{}, cosX{}, sinY{}, cosY{}, sinZ{}, cosZ{};
+        sinCos(sinX, cosX, rotateX);
+        sinCos(sinY, cosY, rotateY);
+        sinCos(sinZ, cosZ, rotateZ);
+
+        // Closed form of XMMatrixRotationX * XMMatrixRotationY * XMMatrixRotationZ.
+        const std::array<std::array<T, 3u>, 3u> rotation = {{
+            {cosY * cosZ, cosY * sinZ, -sinY},
+            {sinX * sinY * cosZ - cosX * sinZ, sinX * sinY * sinZ + cosX * cosZ, sinX * cosY},
+            {cosX * sinY * cosZ + sinX * sinZ, cosX * sinY * sinZ - sinX * cosZ, cosX * cosY},
+        }};
+
+        const std::array<T, 3u> scale = {scaleX, scaleY, scaleZ};
+        const std::array<T, 3u> inverseScale = {reciprocal(scaleX), reciprocal(scaleY), reciprocal(scaleZ)};
+
+        ComposedTransform<T> result{};
+
+        // Local = R * S * T, so the upper 3x3 is R with each column multiplied by the scale and the last row is the translation.
+        // As R is orthonormal and S is diagonal, (R * S)^-T = R * S^-1.
+        for (const uint32_t row : std::views::iota(0u, 3u))
+        {
+            for (const uint32_t column : std::views::iota(0u, 3u))
+            {
+                result.local[row][column] = rotation[row][column] * scale[column];
+                result.normal[row][column] = rotation[row][column] * inverseScale[column];
+            }
+        }
+
+        result.local[3u] = {translateX, translateY, translateZ};
+
+        return result;
+    }
+
+    inline void storeMatrices(const ComposedTransform<float>& composedTransform, math::XMFLOAT4X4& localMatrix, math::XMFLOAT4X4& localNormalMatrix)
+    {
+        const auto& w = composedTransform.local;
+        const auto& n = composedTransform.normal;
+
+        localMatrix = math::XMFLOAT4X4(w[0][0], w[0][1], w[0][2], 0.0f, w[1][0], w[1][1], w[1][2], 0.0f, w[2][0], w[2][1], w[2][2], 0.0f, w[3][0], w[3][1], w[3][2], 1.0f);
+        localNormalMatrix = math::XMFLOAT4X4(n[0][0], n[0][1], n[0][2], 0.0f, n[1][0], n[1][1], n[1][2], 0.0f, n[2][0], n[2][1], n[2][2], 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    // Processes the 8 wide groups of the batch, and returns the number of transforms it processed. The tail is left for the scalar path.
+    NETHER_AVX2_FUNCTION static size_t composeAvx2(const LocalTransforms& localTransforms,
+                                                   const uint8_t* const dirtyFlags,
+                                                   const std::span<math::XMFLOAT4X4> localMatrices,
+                                                   const std::span<math::XMFLOAT4X4> localNormalMatrices)
+    {
+        const LocalTransforms& t = localTransforms;
+        size_t index = 0u;
+
+        constexpr size_t LANE_WIDTH = 8u;
+
+        for (; index + LANE_WIDTH <= t.count; index += LANE_WIDTH)
+        {
+            // Skip the whole group if none of the 8 transforms are dirty.
+            if (dirtyFlags)
+            {
+                uint64_t groupDirtyFlags{};
+                std::memcpy(&groupDirtyFlags, dirtyFlags + index, sizeof(uint64_t));
+
+                if (groupDirtyFlags == 0u)
+                {
+                    continue;
+                }
+            }
+
+            const ComposedTransform<Float8> composed = composeLane(loadFloat8(t.translateX + index),
+                                                                   loadFloat8(t.translateY + index),
+                                                                   loadFloat8(t.translateZ + index),
+                                                                   loadFloat8(t.rotateX + index),
+                                                                   loadFloat8(t.rotateY + index),
+                                                                   loadFloat8(t.rotateZ + index),
+                                                                   loadFloat8(t.scaleX + index),
+                                                                   loadFloat8(t.scaleY + index),
+                                                                   loadFloat8(t.scaleZ + index));
+
+            // Transpose the SoA result back into per object matrices.
+            alignas(32) std::array<std::array<std::array<float, LANE_WIDTH>, 3u>, 4u> local{};
+            alignas(32) std::array<std::array<std::array<float, LANE_WIDTH>, 3u>, 3u> normal{};
+
+            for (const uint32_t row : std::views::iota(0u, 4u))
+            {
+                for (const uint32_t column : std::views::iota(0u, 3u))
+                {
+                    _mm256_store_ps(local[row][column].data(), composed.local[row][column].v);
+
+                    if (row < 3u)
+                    {
+                        _mm256_store_ps(normal[row][column].data(), composed.normal[row][column].v);
+                    }
+                }
+            }
+
+            for (const size_t lane : std::views::iota(0u, LANE_WIDTH))
+            {
+                ComposedTransform<float> composedLane{};
+                for (const uint32_t row : std::views::iota(0u, 4u))
+                {
+                    for (const uint32_t column : std::views::iota(0u, 3u))
+                    {
+                        composedLane.local[row][column] = local[row][column][lane];
+
+                        if (row < 3u)
+                        {
+                            composedLane.normal[row][column] = normal[row][column][lane];
+                        }
+                    }
+                }
+
+                storeMatrices(composedLane, localMatrices[index + lane], localNormalMatrices[index + lane]);
+            }
+        }
+
+        return index;
+    }
+
+    void compose(const LocalTransforms& localTransforms,
+                 const uint8_t* const dirtyFlags,
+                 const std::span<math::XMFLOAT4X4> localMatrices,
+                 const std::span<math::XMFLOAT4X4> localNormalMatrices)
+    {
+        if (localMatrices.size() < localTransforms.count || localNormalMatrices.size() < localTransforms.count)
+        {
+            fatalError("Output spans passed to TransformKernel::compose are smaller than the number of transforms.");
+        }
+
+        const LocalTransforms& t = localTransforms;
+        size_t index = 0u;
+
+        if (CpuFeatures::isAvx2Supported())
+        {
+            index = composeAvx2(localTransforms, dirtyFlags, localMatrices, localNormalMatrices);
+        }
+
+        for (; index < t.count; ++index)
+        {
+            if (dirtyFlags && !dirtyFlags[index])
+            {
+                continue;
+            }
+
+            const ComposedTransform<float> composed = composeLane(t.translateX[index],
+                                                                  t.translateY[index],
+                                                                  t.translateZ[index],
+                                                                  t.rotateX[index],
+                                                                  t.rotateY[index],
+                                                                  t.rotateZ[index],
+                                                                  t.scaleX[index],
+                                                                  t.scaleY[index],
+                                                                  t.scaleZ[index]);
+
+            storeMatrices(composed, localMatrices[index], localNormalMatrices[index]);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "Pch.hpp"
+
+#include "WorkStealingDeque.hpp"
+
+namespace nether
+{
+    WorkStealingDeque::WorkStealingDeque(const uint32_t initialCapacity)
+    {
+        m_buffers.push_back(std::make_unique<Buffer>(static_cast<int64_t>(std::bit_ceil(std::max(initialCapacity, 2u)))));
+        m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    void WorkStealingDeque::push(Job* const job)
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+
+        Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity - 1)
+        {
+            buffer = grow(buffer, top, bottom);
+        }
+
+        // The paper uses a relaxed store followed by a release fence. Release stores are used instead (free on x86), which thread sanitizer understands.
+        (*buffer)[bottom].store(job, std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    Job* WorkStealingDeque::pop()
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* const buffer = m_buffer.load(std::memory_order_relaxed);
+
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int64_t top = m_top.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            // Empty.
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = (*buffer)[bottom].load(std::memory_order_acquire);
+        if (top == bottom)
+        {
+            // Last job, which a thief might be taking at the same time.
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return job;
+    }
+
+    Job* WorkStealingDeque::steal()
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        Buffer* const buffer = m_buffer.load(std::memory_order_acquire);
+        Job* const job = (*buffer)[top].load(std::memory_order_acquire);
+
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
+        return job;
+    }
+
+    bool WorkStealingDeque::isEmpty() const { return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed); }
+
+    WorkStealingDeque::Buffer* WorkStealingDeque::grow(Buffer* const buffer, const int64_t top, const int64_t bottom)
+    {
+        m_buffers.push_back(std::make_unique<Buffer>(buffer->capacity * 2));
+        Buffer* const newBuffer = m_buffers.back().get();
+
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            (*newBuffer)[i].store((*buffer)[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        m_buffer.store(newBuffer, std::memory_order_release);
+        return newBuffer;
+    }
+}
@@ -0,0 +1,179 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AssetArchive.hpp"
+
+namespace nether::Test
+{
+    // The .gltf is text, which LZ4 compresses. Cube_BaseColor_original.png does not compress, so it is stored as is.
+    static const std::array<std::string, 4u> ASSET_PATHS = {
+        "assets/Cube/glTF/Cube.gltf",
+        "assets/Cube/glTF/Cube.bin",
+        "assets/Cube/glTF/Cube_BaseColor_original.png",
+        "assets/Cube/glTF/Cube_MetallicRoughness.png",
+    };
+
+    static std::vector<std::byte> readBytes(const std::string_view filePath)
+    {
+        const std::vector<char> file = readFile(filePath);
+        const std::span<const std::byte> data = std::as_bytes(std::span(file));
+
+        return std::vector<std::byte>(data.begin(), data.end());
+    }
+
+    static void writeBytes(const std::filesystem::path& filePath, const std::span<const std::byte> data)
+    {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    // Every packed file reads back byte for byte, with and without compression.
+    static void testRoundTrip(TestRunner& runner, const bool compress)
+    {
+        const TemporaryDirectory directory("AssetArchive");
+        const std::string archivePath = (directory.getPath() / "Assets.pak").string();
+
+        writeAssetArchive(archivePath, ASSET_PATHS, compress);
+        const AssetArchive archive(archivePath);
+
+        NETHER_CHECK(runner, archive.getEntries().size() == ASSET_PATHS.size());
+
+        std::vector<std::byte> buffer{};
+        for (const std::string& assetPath : ASSET_PATHS)
+        {
+            const AssetArchiveEntry* const entry = archive.find(assetPath);
+            if (entry == nullptr)
+            {
+                NETHER_CHECK(runner, entry != nullptr);
+                continue;
+            }
+
+            NETHER_CHECK(runner, archive.getPath(*entry) == assetPath);
+            NETHER_CHECK(runner, entry->dataOffset % AssetArchive::PAYLOAD_ALIGNMENT == 0u);
+
+            const std::vector<std::byte> file = readBytes(assetPath);
+            const std::span<const std::byte> data = archive.read(*entry, buffer);
+
+            NETHER_CHECK(runner, entry->size == file.size());
+            NETHER_CHECK(runner, std::ranges::equal(data, file));
+
+            // Uncompressed entries are read from the mapping, without going through the buffer.
+            NETHER_CHECK(runner, (entry->compression == AssetCompression::None) == (data.data() != buffer.data()));
+        }
+
+        const AssetArchiveEntry* const gltfEntry = archive.find(ASSET_PATHS[0]);
+        const AssetArchiveEntry* const imageEntry = archive.find(ASSET_PATHS[2]);
+
+        NETHER_CHECK(runner, gltfEntry != nullptr && gltfEntry->compression == (compress ? AssetCompression::Lz4 : AssetCompression::None));
+        NETHER_CHECK(runner, imageEntry != nullptr && imageEntry->compression == AssetCompression::None);
+
+        // Lookups canonicalize the path, and miss assets that were not packed.
+        NETHER_CHECK(runner, archive.find("assets/Cube/../Cube/glTF\\Cube.bin") == archive.find(ASSET_PATHS[1]));
+        NETHER_CHECK(runner, archive.find("assets/Cube/glTF/Missing.png") == nullptr);
+        NETHER_CHECK(runner, archive.find("assets/Cube/glTF") == nullptr);
+    }
+
+    // The archive does not depend on the order of the files, and moving it keeps its entries valid.
+    static void testDeterministic(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("AssetArchive");
+        const std::filesystem::path firstPath = directory.getPath() / "First.pak";
+        const std::filesystem::path secondPath = directory.getPath() / "Second.pak";
+
+        std::array<std::string, 4u> reversedPaths = ASSET_PATHS;
+        std::ranges::reverse(reversedPaths);
+
+        writeAssetArchive(firstPath.string(), ASSET_PATHS, true);
+        writeAssetArchive(secondPath.string(), reversedPaths, true);
+
+        NETHER_CHECK(runner, readBytes(firstPath.string()) == readBytes(secondPath.string()));
+
+        AssetArchive archive(firstPath.string());
+        const AssetArchive movedArchive(std::move(archive));
+
+        NETHER_CHECK(runner, archive.getEntries().empty() && archive.find(ASSET_PATHS[0]) == nullptr);
+        NETHER_CHECK(runner, movedArchive.find(ASSET_PATHS[0]) != nullptr);
+    }
+
+    static void testEmpty(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("AssetArchive");
+        const std::string archivePath = (directory.getPath() / "Empty.pak").string();
+
+        writeAssetArchive(archivePath, {}, true);
+        const AssetArchive archive(archivePath);
+
+        NETHER_CHECK(runner, archive.getEntries().empty());
+        NETHER_CHECK(runner, archive.find(ASSET_PATHS[0]) == nullptr);
+
+        NETHER_CHECK(runner, AssetArchive{}.find(ASSET_PATHS[0]) == nullptr);
+    }
+
+    static void testPackErrors(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("AssetArchive");
+        const std::string archivePath = (directory.getPath() / "Assets.pak").string();
+
+        // The same asset under two spellings of its path.
+        const std::array<std::string, 2u> duplicatePaths = {ASSET_PATHS[0], "assets/Cube/./glTF/Cube.gltf"};
+        NETHER_CHECK_THROWS(runner, writeAssetArchive(archivePath, duplicatePaths, true), "is packed more than once");
+
+        const std::array<std::string, 1u> missingPaths = {"assets/Cube/glTF/Missing.png"};
+        NETHER_CHECK_THROWS(runner, writeAssetArchive(archivePath, missingPaths, true), "Missing.png");
+    }
+
+    // Archives that are truncated or corrupted fail to open, instead of failing (or reading out of bounds) on a later lookup.
+    static void testMalformed(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("AssetArchive");
+        const std::string archivePath = (directory.getPath() / "Assets.pak").string();
+        const std::filesystem::path malformedPath = directory.getPath() / "Malformed.pak";
+
+        writeAssetArchive(archivePath, ASSET_PATHS, true);
+        const std::vector<std::byte> archiveData = readBytes(archivePath);
+
+        const auto checkMalformed = [&](const std::span<const std::byte> data)
+        {
+            writeBytes(malformedPath, data);
+            NETHER_CHECK_THROWS(runner, AssetArchive(malformedPath.string()), "Malformed asset archive");
+        };
+
+        checkMalformed(std::span(archiveData).first(sizeof(AssetArchiveHeader) - 1u));
+
+        // Cuts the path table, which is at the end.
+        checkMalformed(std::span(archiveData).first(archiveData.size() - 1u));
+
+        const auto checkCorrupted = [&](const size_t offset)
+        {
+            std::vector<std::byte> data = archiveData;
+            data[offset] ^= std::byte{0xffu};
+
+            checkMalformed(data);
+        };
+
+        const AssetArchiveHeader& header = *reinterpret_cast<const AssetArchiveHeader*>(archiveData.data());
+
+        checkCorrupted(offsetof(AssetArchiveHeader, magic));
+        checkCorrupted(offsetof(AssetArchiveHeader, version));
+        checkCorrupted(offsetof(AssetArchiveHeader, entryCount));
+        checkCorrupted(offsetof(AssetArchiveHeader, directoryOffset) + 1u);
+
+        // The first entry's hash no longer matches its path, and its payload runs past the end of the file.
+        checkCorrupted(header.directoryOffset + offsetof(AssetArchiveEntry, pathHash));
+        checkCorrupted(header.directoryOffset + offsetof(AssetArchiveEntry, storedSize) + 7u);
+
+        // A path no longer hashes to its entry.
+        checkCorrupted(header.pathTableOffset);
+    }
+
+    void runAssetArchiveTests(TestRunner& runner)
+    {
+        runner.run("AssetArchive/roundTrip", [&]() { testRoundTrip(runner, false); });
+        runner.run("AssetArchive/roundTripCompressed", [&]() { testRoundTrip(runner, true); });
+        runner.run("AssetArchive/deterministic", [&]() { testDeterministic(runner); });
+        runner.run("AssetArchive/empty", [&]() { testEmpty(runner); });
+        runner.run("AssetArchive/packErrors", [&]() { testPackErrors(runner); });
+        runner.run("AssetArchive/malformed", [&]() { testMalformed(runner); });
+    }
+}
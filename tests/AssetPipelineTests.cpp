@@ -0,0 +1,136 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AssetPipeline.hpp"
+
+// The threaded tests are meant to be run under ThreadSanitizer as well (premake5 gmake2 --sanitize=thread).
+namespace nether::Test
+{
+    static constexpr std::string_view MESH_PATH = "assets/Cube/glTF/Cube.gltf";
+    static constexpr std::string_view IMAGE_PATH = "assets/Cube/glTF/Cube_MetallicRoughness.png";
+    static constexpr std::string_view MISSING_PATH = "assets/Missing.png";
+
+    // Every request comes out of the pipeline exactly once, with its user data, whether it loaded or not.
+    static void testLoad(TestRunner& runner, const uint32_t workerThreadCount)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = workerThreadCount});
+        AssetPipeline assetPipeline(jobSystem, AssetPipelineDesc{.maxInFlightCount = 4u});
+
+        // Meshes and textures alternate, and every third request is for a file that does not exist.
+        constexpr uint64_t requestCount = 12u;
+        const auto isMissing = [](const uint64_t request) { return request % 3u == 2u; };
+        const auto getType = [](const uint64_t request) { return request % 2u == 0u ? AssetType::Mesh : AssetType::Texture; };
+
+        for (const uint64_t request : std::views::iota(uint64_t{0u}, requestCount))
+        {
+            const std::string_view path = isMissing(request) ? MISSING_PATH : getType(request) == AssetType::Mesh ? MESH_PATH : IMAGE_PATH;
+            assetPipeline.request(AssetLoadRequest{.path = std::string(path), .type = getType(request), .userData = request});
+        }
+
+        NETHER_CHECK(runner, assetPipeline.getPendingCount() == requestCount);
+
+        std::vector<DecodedAsset> decodedAssets{};
+        while (assetPipeline.waitForDecodedAssets(decodedAssets, 5u) != 0u)
+        {
+        }
+
+        NETHER_CHECK(runner, decodedAssets.size() == requestCount);
+        NETHER_CHECK(runner, assetPipeline.getPendingCount() == 0u);
+
+        std::vector<uint32_t> decodedCounts(requestCount);
+        for (const DecodedAsset& decodedAsset : decodedAssets)
+        {
+            const uint64_t request = decodedAsset.request.userData;
+            decodedCounts[request]++;
+
+            NETHER_CHECK(runner, decodedAsset.request.type == getType(request));
+            if (isMissing(request))
+            {
+                // A plain exception, which names the file.
+                NETHER_CHECK(runner, decodedAsset.loadException != nullptr);
+                NETHER_CHECK_THROWS(runner, std::rethrow_exception(decodedAsset.loadException), MISSING_PATH);
+                continue;
+            }
+
+            NETHER_CHECK(runner, decodedAsset.loadException == nullptr);
+            if (decodedAsset.request.type == AssetType::Mesh)
+            {
+                // 6 faces of 2 triangles.
+                NETHER_CHECK(runner, decodedAsset.meshData.indices.size() == 36u && decodedAsset.meshData.positions.size() == 36u);
+            }
+            else
+            {
+                NETHER_CHECK(runner, decodedAsset.imageData.width == 512u && decodedAsset.imageData.height == 512u);
+                NETHER_CHECK(runner, decodedAsset.imageData.pixels.size() == 512u * 512u * 4u);
+            }
+        }
+
+        NETHER_CHECK(runner, std::ranges::all_of(decodedCounts, [](const uint32_t decodedCount) { return decodedCount == 1u; }));
+    }
+
+    // The upload stage is slower than the loads, so loads stop once maxInFlightCount assets are waiting to be taken.
+    static void testBackpressure(TestRunner& runner)
+    {
+        constexpr uint32_t maxInFlightCount = 2u;
+        constexpr uint32_t requestCount = 10u;
+
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+        AssetPipeline assetPipeline(jobSystem, AssetPipelineDesc{.maxInFlightCount = maxInFlightCount});
+
+        for ([[maybe_unused]] const uint32_t request : std::views::iota(0u, requestCount))
+        {
+            assetPipeline.request(AssetLoadRequest{.path = std::string(IMAGE_PATH), .type = AssetType::Texture});
+        }
+
+        std::vector<DecodedAsset> decodedAssets{};
+        size_t maxTakenCount{};
+        while (const size_t takenCount = assetPipeline.waitForDecodedAssets(decodedAssets, requestCount))
+        {
+            maxTakenCount = std::max(maxTakenCount, takenCount);
+
+            // Gives the loads time to run ahead, which they must not do past maxInFlightCount.
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+
+        NETHER_CHECK(runner, decodedAssets.size() == requestCount);
+        NETHER_CHECK(runner, maxTakenCount <= maxInFlightCount);
+    }
+
+    // Destroying the pipeline waits for the loads that started, and drops the requests that did not.
+    static void testDestroyWhileLoading(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+
+        {
+            AssetPipeline assetPipeline(jobSystem, AssetPipelineDesc{.maxInFlightCount = 2u});
+            for ([[maybe_unused]] const uint32_t request : std::views::iota(0u, 20u))
+            {
+                assetPipeline.request(AssetLoadRequest{.path = std::string(IMAGE_PATH), .type = AssetType::Texture});
+            }
+
+            std::vector<DecodedAsset> decodedAssets{};
+            NETHER_CHECK(runner, assetPipeline.waitForDecodedAssets(decodedAssets, 1u) == 1u);
+        }
+
+        // No job of the pipeline is left behind, so the job system still runs (and waits for) new jobs.
+        JobCounter counter{};
+        bool hasRun{false};
+        jobSystem.schedule([&]() { hasRun = true; }, &counter);
+        jobSystem.wait(counter);
+
+        NETHER_CHECK(runner, hasRun);
+    }
+
+    void runAssetPipelineTests(TestRunner& runner)
+    {
+        // Without workers, the loads run on the thread that takes the decoded assets.
+        for (const uint32_t workerThreadCount : {0u, 3u})
+        {
+            runner.run(std::format("AssetPipeline/load/{}Workers", workerThreadCount), [&]() { testLoad(runner, workerThreadCount); });
+        }
+
+        runner.run("AssetPipeline/backpressure", [&]() { testBackpressure(runner); });
+        runner.run("AssetPipeline/destroyWhileLoading", [&]() { testDestroyWhileLoading(runner); });
+    }
+}
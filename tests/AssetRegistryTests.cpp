@@ -0,0 +1,279 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AssetRegistry.hpp"
+
+namespace nether::Test
+{
+    // Counts live instances, so the tests can check when the registry destroys an asset.
+    struct TestAsset
+    {
+        explicit TestAsset(const uint32_t value, std::atomic<int32_t>& liveCount) : value(value), liveCount(&liveCount) { liveCount++; }
+
+        TestAsset(TestAsset&& other) noexcept : value(other.value), liveCount(std::exchange(other.liveCount, nullptr)) {}
+        TestAsset& operator=(TestAsset&&) = delete;
+
+        ~TestAsset()
+        {
+            if (liveCount != nullptr)
+            {
+                (*liveCount)--;
+            }
+        }
+
+        uint32_t value{};
+        std::atomic<int32_t>* liveCount{};
+    };
+
+    static constexpr uint64_t RETIRE_LATENCY = 3u;
+
+    static void testCanonicalPath(TestRunner& runner)
+    {
+        NETHER_CHECK(runner, getCanonicalAssetPath("assets/./Cube\\Cube.gltf") == "assets/Cube/Cube.gltf");
+        NETHER_CHECK(runner, getCanonicalAssetPath("assets/Sponza/../Cube/Cube.gltf") == "assets/Cube/Cube.gltf");
+        NETHER_CHECK(runner, getCanonicalAssetPath("assets/Cube/Cube.gltf") == "assets/Cube/Cube.gltf");
+    }
+
+    static void testAcquireAndRelease(TestRunner& runner)
+    {
+        std::atomic<int32_t> liveCount{};
+        AssetRegistry<TestAsset> registry(4u, RETIRE_LATENCY);
+
+        uint32_t loadCount{};
+        const auto loader = [&](const std::string_view) { return TestAsset(++loadCount, liveCount); };
+
+        // The same file through different spellings of its path is loaded once.
+        const auto handle = registry.acquire("assets/Cube/Cube.gltf", loader);
+        const auto sameHandle = registry.acquire("assets/./Cube\\Cube.gltf", loader);
+        const auto otherHandle = registry.acquire("assets/Sphere.gltf", loader);
+
+        NETHER_CHECK(runner, handle == sameHandle && handle != otherHandle);
+        NETHER_CHECK(runner, loadCount == 2u && liveCount.load() == 2);
+        NETHER_CHECK(runner, registry.getReferenceCount(handle) == 2u);
+        NETHER_CHECK(runner, registry.getState(handle) == AssetState::Loaded);
+        NETHER_CHECK(runner, registry.get(handle).value == 1u);
+        NETHER_CHECK(runner, registry.getPath(sameHandle) == "assets/Cube/Cube.gltf");
+        NETHER_CHECK(runner, registry.getAssetCount() == 2u);
+
+        // Released at frame 10, so kept until frame 10 + RETIRE_LATENCY.
+        registry.collectGarbage(10u);
+        registry.release(handle);
+        registry.release(sameHandle);
+
+        registry.collectGarbage(12u);
+        NETHER_CHECK(runner, liveCount.load() == 2);
+
+        // Acquiring the path before it is destroyed gives the same asset back, and a later release restarts the latency.
+        const auto reacquiredHandle = registry.acquire("assets/Cube/Cube.gltf", loader);
+        NETHER_CHECK(runner, reacquiredHandle == handle && loadCount == 2u);
+
+        registry.collectGarbage(13u);
+        NETHER_CHECK(runner, liveCount.load() == 2);
+
+        registry.release(reacquiredHandle);
+        registry.collectGarbage(15u);
+        NETHER_CHECK(runner, liveCount.load() == 2);
+
+        registry.collectGarbage(16u);
+        NETHER_CHECK(runner, liveCount.load() == 1);
+        NETHER_CHECK(runner, registry.getAssetCount() == 1u);
+
+        // The slot is reused with a new generation, so the old handle is stale.
+        const auto newHandle = registry.acquire("assets/Cube/Cube.gltf", loader);
+        NETHER_CHECK(runner, loadCount == 3u);
+        NETHER_CHECK(runner, newHandle.index == handle.index && newHandle.generation != handle.generation);
+
+        // References taken with addReference keep the asset alive as well.
+        registry.addReference(otherHandle);
+        registry.release(otherHandle);
+        registry.collectGarbage(100u);
+        NETHER_CHECK(runner, registry.getState(otherHandle) == AssetState::Loaded && liveCount.load() == 2);
+
+        registry.release(otherHandle);
+        registry.release(newHandle);
+        registry.collectGarbage(100u + RETIRE_LATENCY);
+        NETHER_CHECK(runner, liveCount.load() == 0 && registry.getAssetCount() == 0u);
+    }
+
+    static void testFailedLoad(TestRunner& runner)
+    {
+        std::atomic<int32_t> liveCount{};
+        AssetRegistry<TestAsset> registry(4u, RETIRE_LATENCY);
+
+        // The exception reaches the caller, and the path is not registered, so the next acquire loads it again.
+        const auto failingLoader = [](const std::string_view) -> TestAsset { throw std::runtime_error("Missing.gltf not found."); };
+        NETHER_CHECK_THROWS(runner, registry.acquire("assets/Missing.gltf", failingLoader), "not found");
+
+        const auto handle = registry.acquire("assets/Missing.gltf", [&](const std::string_view) { return TestAsset(1u, liveCount); });
+        NETHER_CHECK(runner, registry.get(handle).value == 1u);
+
+        // An asynchronous load that fails is rethrown to the acquires waiting for it, and its slot is freed once they all dropped their reference.
+        const auto asyncAcquire = registry.acquireAsync("assets/Broken.gltf");
+        NETHER_CHECK(runner, asyncAcquire.isNewLoad);
+        NETHER_CHECK(runner, registry.getState(asyncAcquire.handle) == AssetState::Loading);
+
+        std::jthread waitingThread(
+            [&]()
+            {
+                const auto loader = [&](const std::string_view) { return TestAsset(2u, liveCount); };
+                NETHER_CHECK_THROWS(runner, registry.acquire("assets/Broken.gltf", loader), "Broken.gltf is corrupt");
+            });
+
+        // Only fails once the other thread's acquire found the loading asset, so that it waits for the load rather than loading the path again.
+        while (registry.getReferenceCount(asyncAcquire.handle) != 2u)
+        {
+            std::this_thread::yield();
+        }
+
+        registry.failLoad(asyncAcquire.handle, std::make_exception_ptr(std::runtime_error("Broken.gltf is corrupt.")));
+        waitingThread.join();
+
+        NETHER_CHECK(runner, registry.getState(asyncAcquire.handle) == AssetState::Failed);
+        registry.release(asyncAcquire.handle);
+
+        registry.collectGarbage(RETIRE_LATENCY);
+        NETHER_CHECK(runner, registry.getAssetCount() == 1u);
+    }
+
+    static void testFull(TestRunner& runner)
+    {
+        std::atomic<int32_t> liveCount{};
+        AssetRegistry<TestAsset> registry(2u, RETIRE_LATENCY);
+
+        const auto loader = [&](const std::string_view) { return TestAsset(0u, liveCount); };
+
+        const auto first = registry.acquire("a.png", loader);
+        [[maybe_unused]] const auto second = registry.acquire("b.png", loader);
+
+        NETHER_CHECK_THROWS(runner, registry.acquire("c.png", loader), "Asset registry is full");
+
+        // Freed slots are available again, but only once collected.
+        registry.release(first);
+        NETHER_CHECK_THROWS(runner, registry.acquire("c.png", loader), "Asset registry is full");
+
+        registry.collectGarbage(RETIRE_LATENCY);
+        NETHER_CHECK(runner, registry.acquire("c.png", loader).isValid());
+    }
+
+    // A load released before it completes (e.g. a renderable removed while its mesh is loading) keeps its slot, so finishLoad / failLoad never write to a slot that
+    // was reused for another path, and the path never leads to a freed slot.
+    static void testReleaseBeforeFinishLoad(TestRunner& runner)
+    {
+        std::atomic<int32_t> liveCount{};
+        AssetRegistry<TestAsset> registry(2u, RETIRE_LATENCY);
+
+        const auto loader = [&](const std::string_view) { return TestAsset(0u, liveCount); };
+
+        const auto asyncAcquire = registry.acquireAsync("assets/Cube.gltf");
+        registry.release(asyncAcquire.handle);
+        registry.collectGarbage(RETIRE_LATENCY * 2u);
+
+        NETHER_CHECK(runner, registry.getAssetCount() == 1u);
+        NETHER_CHECK(runner, registry.getState(asyncAcquire.handle) == AssetState::Loading);
+
+        // The path still leads to the loading asset, and its slot is not free.
+        const auto sameAcquire = registry.acquireAsync("assets/Cube.gltf");
+        NETHER_CHECK(runner, !sameAcquire.isNewLoad && sameAcquire.handle == asyncAcquire.handle);
+        registry.release(sameAcquire.handle);
+
+        const auto otherHandle = registry.acquire("assets/Sphere.gltf", loader);
+        NETHER_CHECK_THROWS(runner, registry.acquire("assets/Plane.gltf", loader), "Asset registry is full");
+        registry.release(otherHandle);
+
+        // Destroyed by the first collection after the load completes.
+        registry.finishLoad(asyncAcquire.handle, TestAsset(1u, liveCount));
+        NETHER_CHECK(runner, registry.getState(asyncAcquire.handle) == AssetState::Loaded && liveCount.load() == 2);
+
+        registry.collectGarbage(RETIRE_LATENCY * 3u);
+        NETHER_CHECK(runner, liveCount.load() == 0 && registry.getAssetCount() == 0u);
+
+        // The handle is stale, so completing its load again is an error.
+        NETHER_CHECK_THROWS(runner, registry.finishLoad(asyncAcquire.handle, TestAsset(2u, liveCount)), "not loading");
+
+        // Same for a load that fails after it was released.
+        const auto failingAcquire = registry.acquireAsync("assets/Broken.gltf");
+        registry.release(failingAcquire.handle);
+        registry.collectGarbage(RETIRE_LATENCY * 4u);
+        NETHER_CHECK(runner, registry.getAssetCount() == 1u);
+
+        registry.failLoad(failingAcquire.handle, std::make_exception_ptr(std::runtime_error("Broken.gltf is corrupt.")));
+        NETHER_CHECK_THROWS(runner, registry.failLoad(failingAcquire.handle, nullptr), "not loading");
+
+        registry.collectGarbage(RETIRE_LATENCY * 4u + 1u);
+        NETHER_CHECK(runner, registry.getAssetCount() == 0u);
+    }
+
+    // Threads acquire and release overlapping sets of paths while the registry collects garbage. Every path is loaded by one thread at a time, and nothing leaks.
+    static void testConcurrentAcquire(TestRunner& runner)
+    {
+        constexpr uint32_t threadCount = 4u;
+        constexpr uint32_t pathCount = 16u;
+        constexpr uint32_t iterationCount = 2000u;
+
+        std::atomic<int32_t> liveCount{};
+
+        // One more slot than paths, as a path can be acquired again between its old slot leaving the path map and returning to the free list.
+        AssetRegistry<TestAsset> registry(pathCount + 1u, 1u);
+
+        std::array<std::atomic<uint32_t>, pathCount> loadingCounts{};
+        std::atomic<uint32_t> overlappingLoadCount{};
+        std::atomic<uint32_t> wrongValueCount{};
+
+        std::atomic<bool> isDone{false};
+        std::jthread collectorThread(
+            [&]()
+            {
+                uint64_t frameNumber{};
+                while (!isDone.load(std::memory_order_acquire))
+                {
+                    registry.collectGarbage(++frameNumber);
+                }
+            });
+
+        std::vector<std::jthread> threads{};
+        for (const uint32_t thread : std::views::iota(0u, threadCount))
+        {
+            threads.emplace_back(
+                [&, thread]()
+                {
+                    for (const uint32_t iteration : std::views::iota(0u, iterationCount))
+                    {
+                        const uint32_t path = (iteration * 7u + thread) % pathCount;
+                        const auto handle = registry.acquire(std::format("assets/{}.png", path),
+                                                             [&](const std::string_view)
+                                                             {
+                                                                 overlappingLoadCount += loadingCounts[path].fetch_add(1u) == 0u ? 0u : 1u;
+                                                                 TestAsset asset(path, liveCount);
+                                                                 loadingCounts[path].fetch_sub(1u);
+
+                                                                 return asset;
+                                                             });
+
+                        wrongValueCount += registry.get(handle).value == path ? 0u : 1u;
+                        registry.release(handle);
+                    }
+                });
+        }
+
+        threads.clear();
+        isDone.store(true, std::memory_order_release);
+        collectorThread.join();
+
+        NETHER_CHECK(runner, overlappingLoadCount.load() == 0u);
+        NETHER_CHECK(runner, wrongValueCount.load() == 0u);
+
+        registry.collectGarbage(std::numeric_limits<uint32_t>::max());
+        NETHER_CHECK(runner, liveCount.load() == 0 && registry.getAssetCount() == 0u);
+    }
+
+    void runAssetRegistryTests(TestRunner& runner)
+    {
+        runner.run("AssetRegistry/canonicalPath", [&]() { testCanonicalPath(runner); });
+        runner.run("AssetRegistry/acquireAndRelease", [&]() { testAcquireAndRelease(runner); });
+        runner.run("AssetRegistry/failedLoad", [&]() { testFailedLoad(runner); });
+        runner.run("AssetRegistry/full", [&]() { testFull(runner); });
+        runner.run("AssetRegistry/releaseBeforeFinishLoad", [&]() { testReleaseBeforeFinishLoad(runner); });
+        runner.run("AssetRegistry/concurrentAcquire", [&]() { testConcurrentAcquire(runner); });
+    }
+}
@@ -0,0 +1,115 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "DescriptorAllocator.hpp"
+
+namespace nether::Test
+{
+    static void testAllocateAndRelease(TestRunner& runner)
+    {
+        DescriptorAllocator allocator{};
+        allocator.init(4u, "Test heap");
+
+        // Handed out in order while the heap has not been used up once.
+        NETHER_CHECK(runner, allocator.allocate() == 0u);
+        NETHER_CHECK(runner, allocator.allocate() == 1u);
+        NETHER_CHECK(runner, allocator.allocate() == 2u);
+        NETHER_CHECK(runner, allocator.getAllocatedCount() == 3u);
+
+        // Released slots are reused before the unused ones, newest first.
+        allocator.release(0u);
+        allocator.release(2u);
+        NETHER_CHECK(runner, allocator.getAllocatedCount() == 1u);
+
+        NETHER_CHECK(runner, allocator.allocate() == 2u);
+        NETHER_CHECK(runner, allocator.allocate() == 0u);
+        NETHER_CHECK(runner, allocator.allocate() == 3u);
+        NETHER_CHECK(runner, allocator.getAllocatedCount() == 4u);
+
+        // Initializing again forgets every allocation.
+        allocator.init(2u, "Test heap");
+        NETHER_CHECK(runner, allocator.getCapacity() == 2u && allocator.getAllocatedCount() == 0u);
+        NETHER_CHECK(runner, allocator.allocate() == 0u);
+    }
+
+    static void testFull(TestRunner& runner)
+    {
+        DescriptorAllocator allocator{};
+        allocator.init(2u, "Test heap");
+
+        [[maybe_unused]] const uint32_t first = allocator.allocate();
+        const uint32_t second = allocator.allocate();
+
+        NETHER_CHECK_THROWS(runner, allocator.allocate(), "Test heap is full (2 descriptors)");
+
+        // A release makes room for exactly one more.
+        allocator.release(second);
+        NETHER_CHECK(runner, allocator.allocate() == second);
+        NETHER_CHECK_THROWS(runner, allocator.allocate(), "is full");
+    }
+
+    static void testInvalidRelease(TestRunner& runner)
+    {
+        DescriptorAllocator allocator{};
+        allocator.init(4u, "Test heap");
+
+        const uint32_t index = allocator.allocate();
+        NETHER_CHECK_THROWS(runner, allocator.release(3u), "never allocated");
+
+        allocator.release(index);
+        NETHER_CHECK_THROWS(runner, allocator.release(index), "already released");
+        NETHER_CHECK(runner, allocator.getAllocatedCount() == 0u);
+    }
+
+    // Threads allocate and release at the same time. No slot is handed out twice, and every slot is back once they are done.
+    static void testConcurrentAllocate(TestRunner& runner)
+    {
+        constexpr uint32_t threadCount = 4u;
+        constexpr uint32_t slotsPerThread = 16u;
+        constexpr uint32_t iterationCount = 2000u;
+
+        DescriptorAllocator allocator{};
+        allocator.init(threadCount * slotsPerThread, "Test heap");
+
+        std::vector<std::atomic<uint32_t>> ownerCounts(threadCount * slotsPerThread);
+        std::atomic<uint32_t> sharedSlotCount{};
+
+        std::vector<std::jthread> threads{};
+        for ([[maybe_unused]] const uint32_t thread : std::views::iota(0u, threadCount))
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    std::array<uint32_t, slotsPerThread> indices{};
+                    for ([[maybe_unused]] const uint32_t iteration : std::views::iota(0u, iterationCount))
+                    {
+                        for (uint32_t& index : indices)
+                        {
+                            index = allocator.allocate();
+                            sharedSlotCount += ownerCounts[index].fetch_add(1u) == 0u ? 0u : 1u;
+                        }
+
+                        for (const uint32_t index : indices)
+                        {
+                            ownerCounts[index].fetch_sub(1u);
+                            allocator.release(index);
+                        }
+                    }
+                });
+        }
+
+        threads.clear();
+
+        NETHER_CHECK(runner, sharedSlotCount.load() == 0u);
+        NETHER_CHECK(runner, allocator.getAllocatedCount() == 0u);
+    }
+
+    void runDescriptorAllocatorTests(TestRunner& runner)
+    {
+        runner.run("DescriptorAllocator/allocateAndRelease", [&]() { testAllocateAndRelease(runner); });
+        runner.run("DescriptorAllocator/full", [&]() { testFull(runner); });
+        runner.run("DescriptorAllocator/invalidRelease", [&]() { testInvalidRelease(runner); });
+        runner.run("DescriptorAllocator/concurrentAllocate", [&]() { testConcurrentAllocate(runner); });
+    }
+}
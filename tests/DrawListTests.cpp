@@ -0,0 +1,162 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AllocationTracker.hpp"
+#include "DrawList.hpp"
+
+namespace nether::Test
+{
+    // Renderables spread over every combination of a few pipelines, meshes and textures, in a scrambled order.
+    struct DrawListScene
+    {
+        std::array<GraphicsPipeline, 3u> graphicsPipelines{};
+        std::array<Mesh, 4u> meshes{};
+        std::vector<Renderable> renderables{};
+
+        explicit DrawListScene(const uint32_t renderableCount)
+        {
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(meshes.size())))
+            {
+                meshes[i].indexCount = 3u * (i + 1u);
+            }
+
+            for (const uint32_t i : std::views::iota(0u, renderableCount))
+            {
+                const uint32_t key = (i * 7919u) % 101u;
+                renderables.push_back(Renderable{
+                    .mesh = &meshes[key % meshes.size()],
+                    .graphicsPipeline = &graphicsPipelines[(key / 4u) % graphicsPipelines.size()],
+                    .albedoTextureIndex = (key / 12u) % 2u,
+                });
+            }
+        }
+    };
+
+    // Every instance of a draw has the draw's state, the instance ranges tile the instance indices, and the draws are sorted by pipeline, then mesh, then texture.
+    static void checkDraws(TestRunner& runner, const DrawList& drawList, const std::span<const Renderable> renderables)
+    {
+        const std::span<const InstancedDraw> draws = drawList.getDraws();
+        const std::span<const uint32_t> instanceIndices = drawList.getInstanceIndices();
+
+        const auto getSortKey = [&](const InstancedDraw& draw)
+        { return std::array<uintptr_t, 3u>{reinterpret_cast<uintptr_t>(draw.graphicsPipeline), reinterpret_cast<uintptr_t>(draw.mesh), draw.albedoTextureIndex}; };
+
+        uint32_t nextInstance{};
+        for (const size_t i : std::views::iota(size_t{0u}, draws.size()))
+        {
+            const InstancedDraw& draw = draws[i];
+
+            NETHER_CHECK(runner, draw.firstInstance == nextInstance);
+            NETHER_CHECK(runner, draw.instanceCount > 0u);
+            NETHER_CHECK(runner, draw.indexCount == draw.mesh->indexCount);
+            nextInstance += draw.instanceCount;
+
+            // Draws with the same state would have been merged.
+            if (i > 0u)
+            {
+                NETHER_CHECK(runner, getSortKey(draws[i - 1u]) < getSortKey(draw));
+            }
+
+            for (const uint32_t denseIndex : instanceIndices.subspan(draw.firstInstance, draw.instanceCount))
+            {
+                const Renderable& renderable = renderables[denseIndex];
+                NETHER_CHECK(runner,
+                             renderable.graphicsPipeline == draw.graphicsPipeline && renderable.mesh == draw.mesh &&
+                                 renderable.albedoTextureIndex == draw.albedoTextureIndex);
+            }
+
+            // Deterministic order within a draw.
+            NETHER_CHECK(runner, std::ranges::is_sorted(instanceIndices.subspan(draw.firstInstance, draw.instanceCount)));
+        }
+
+        NETHER_CHECK(runner, nextInstance == instanceIndices.size());
+    }
+
+    static void testMerge(TestRunner& runner)
+    {
+        DrawListScene drawListScene(1000u);
+
+        DrawList drawList{};
+        drawList.build(drawListScene.renderables);
+
+        checkDraws(runner, drawList, drawListScene.renderables);
+
+        // 3 pipelines * 4 meshes * 2 textures, all of which occur.
+        NETHER_CHECK(runner, drawList.getDraws().size() == 24u);
+        NETHER_CHECK(runner, drawList.getInstanceIndices().size() == 1000u);
+
+        // Every renderable is drawn exactly once.
+        std::vector<uint32_t> instanceIndices(drawList.getInstanceIndices().begin(), drawList.getInstanceIndices().end());
+        std::ranges::sort(instanceIndices);
+        NETHER_CHECK(runner, std::ranges::equal(instanceIndices, std::views::iota(0u, 1000u)));
+    }
+
+    static void testSkipsIncompleteRenderables(TestRunner& runner)
+    {
+        DrawListScene drawListScene(8u);
+        drawListScene.renderables[2].mesh = nullptr;
+        drawListScene.renderables[5].graphicsPipeline = nullptr;
+
+        DrawList drawList{};
+        drawList.build(drawListScene.renderables);
+
+        checkDraws(runner, drawList, drawListScene.renderables);
+        NETHER_CHECK(runner, drawList.getInstanceIndices().size() == 6u);
+        NETHER_CHECK(runner, std::ranges::find(drawList.getInstanceIndices(), 2u) == drawList.getInstanceIndices().end());
+        NETHER_CHECK(runner, std::ranges::find(drawList.getInstanceIndices(), 5u) == drawList.getInstanceIndices().end());
+    }
+
+    static void testVisibleIndices(TestRunner& runner)
+    {
+        DrawListScene drawListScene(200u);
+
+        std::vector<uint32_t> visibleIndices{};
+        for (uint32_t i = 0u; i < 200u; i += 3u)
+        {
+            visibleIndices.push_back(i);
+        }
+
+        DrawList drawList{};
+        drawList.build(drawListScene.renderables, visibleIndices);
+
+        checkDraws(runner, drawList, drawListScene.renderables);
+
+        std::vector<uint32_t> instanceIndices(drawList.getInstanceIndices().begin(), drawList.getInstanceIndices().end());
+        std::ranges::sort(instanceIndices);
+        NETHER_CHECK(runner, instanceIndices == visibleIndices);
+
+        // Nothing visible, nothing drawn (and the previous frame's draws are gone).
+        drawList.build(drawListScene.renderables, std::span<const uint32_t>{});
+        NETHER_CHECK(runner, drawList.getDraws().empty());
+        NETHER_CHECK(runner, drawList.getInstanceIndices().empty());
+    }
+
+    // Rebuilding for a scene of the same size reuses the arrays (see DrawList::build).
+    static void testSteadyStateAllocations(TestRunner& runner)
+    {
+        if constexpr (!NETHER_ALLOCATION_TRACKING_MODE)
+        {
+            return;
+        }
+
+        DrawListScene drawListScene(500u);
+
+        DrawList drawList{};
+        drawList.build(drawListScene.renderables);
+
+        const uint64_t allocationCount = AllocationTracker::getTotalAllocationCount();
+        drawList.build(drawListScene.renderables);
+        drawList.build(drawListScene.renderables, std::span<const uint32_t>{});
+
+        NETHER_CHECK(runner, AllocationTracker::getTotalAllocationCount() == allocationCount);
+    }
+
+    void runDrawListTests(TestRunner& runner)
+    {
+        runner.run("DrawList/merge", [&]() { testMerge(runner); });
+        runner.run("DrawList/skipsIncompleteRenderables", [&]() { testSkipsIncompleteRenderables(runner); });
+        runner.run("DrawList/visibleIndices", [&]() { testVisibleIndices(runner); });
+        runner.run("DrawList/steadyStateAllocations", [&]() { testSteadyStateAllocations(runner); });
+    }
+}
@@ -0,0 +1,96 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "FileWatcher.hpp"
+
+namespace nether::Test
+{
+    static constexpr FileWatcher::Clock::duration DEBOUNCE_DURATION = std::chrono::milliseconds(50);
+
+    // File systems update write times at a coarse granularity, so back to back writes can have the same write time. Every write gets a distinct one instead.
+    static void writeFile(const std::filesystem::path& filePath, const std::string_view text)
+    {
+        static uint32_t writeCount{};
+
+        {
+            std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+
+        std::filesystem::last_write_time(filePath, std::filesystem::file_time_type::clock::now() + std::chrono::seconds(++writeCount));
+    }
+
+    static void testFileWatcher(TestRunner& runner, const bool useNativeNotifications)
+    {
+        TemporaryDirectory temporaryDirectory("FileWatcher");
+        const std::filesystem::path shaderPath = temporaryDirectory.getPath() / "Shader.hlsl";
+        const std::filesystem::path headerPath = temporaryDirectory.getPath() / "Common.hlsli";
+        const std::filesystem::path unwatchedPath = temporaryDirectory.getPath() / "Unwatched.hlsli";
+
+        writeFile(shaderPath, "Shader");
+        writeFile(headerPath, "Header");
+
+        FileWatcher fileWatcher(DEBOUNCE_DURATION, useNativeNotifications);
+        fileWatcher.watch(shaderPath);
+        fileWatcher.watch(headerPath);
+        fileWatcher.watch(shaderPath);
+
+        NETHER_CHECK(runner, fileWatcher.getWatchedFileCount() == 2u);
+        NETHER_CHECK(runner, useNativeNotifications || fileWatcher.getNativelyWatchedDirectoryCount() == 0u);
+
+        const FileWatcher::Clock::time_point startTime{};
+        const auto pollAt = [&](const uint32_t milliseconds) { return fileWatcher.poll(startTime + std::chrono::milliseconds(milliseconds)); };
+
+        NETHER_CHECK(runner, pollAt(0u).empty());
+
+        // Reported once nothing changed for the debounce duration, and only once.
+        writeFile(shaderPath, "Shader 2");
+        NETHER_CHECK(runner, pollAt(100u).empty());
+        NETHER_CHECK(runner, pollAt(140u).empty());
+        NETHER_CHECK(runner, pollAt(150u) == std::vector{shaderPath});
+        NETHER_CHECK(runner, pollAt(300u).empty());
+
+        // Changes to other files in the same directory are not reported.
+        writeFile(unwatchedPath, "Unwatched");
+        NETHER_CHECK(runner, pollAt(400u).empty());
+        NETHER_CHECK(runner, pollAt(500u).empty());
+
+        // A second change restarts the debounce, and both files are reported together.
+        writeFile(shaderPath, "Shader 3");
+        NETHER_CHECK(runner, pollAt(600u).empty());
+        writeFile(headerPath, "Header 2");
+        NETHER_CHECK(runner, pollAt(630u).empty());
+        NETHER_CHECK(runner, pollAt(660u).empty());
+        NETHER_CHECK(runner, pollAt(680u) == (std::vector{shaderPath, headerPath}));
+
+        // Saved by renaming a new file into place. The file is not reported while it is missing.
+        std::filesystem::remove(headerPath);
+        NETHER_CHECK(runner, pollAt(800u).empty());
+        NETHER_CHECK(runner, pollAt(900u).empty());
+
+        writeFile(unwatchedPath, "Header 3");
+        std::filesystem::rename(unwatchedPath, headerPath);
+        NETHER_CHECK(runner, pollAt(1000u).empty());
+        NETHER_CHECK(runner, pollAt(1100u) == std::vector{headerPath});
+    }
+
+    void runFileWatcherTests(TestRunner& runner)
+    {
+        runner.run("FileWatcher/polling", [&]() { testFileWatcher(runner, false); });
+        runner.run("FileWatcher/nativeNotifications", [&]() { testFileWatcher(runner, true); });
+
+        // inotify / change notifications are available on every platform the engine builds on.
+        runner.run("FileWatcher/nativeDirectory",
+                   [&]()
+                   {
+                       TemporaryDirectory temporaryDirectory("FileWatcherDirectory");
+                       FileWatcher fileWatcher(DEBOUNCE_DURATION);
+                       fileWatcher.watch(temporaryDirectory.getPath() / "A.hlsl");
+                       fileWatcher.watch(temporaryDirectory.getPath() / "B.hlsl");
+                       fileWatcher.watch(temporaryDirectory.getPath() / "Missing" / "C.hlsl");
+
+                       NETHER_CHECK(runner, fileWatcher.getNativelyWatchedDirectoryCount() == 1u);
+                   });
+    }
+}
@@ -0,0 +1,419 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AssetArchive.hpp"
+#include "AssetLoader.hpp"
+#include "GltfImporter.hpp"
+
+#include <tiny_gltf.h>
+
+namespace nether::Test
+{
+    static constexpr std::array<std::string_view, 2u> SAMPLE_MODEL_PATHS = {
+        "assets/Cube/glTF/Cube.gltf",
+        "assets/Suzanne/glTF/Suzanne.gltf",
+    };
+
+    // The test asset has a mesh of 2 primitives. The first has 4 interleaved vertices (32 bytes each, read through accessor offsets) and 32 bit indices, the second 3
+    // vertices with an attribute per buffer view and 16 bit indices, which are in a second buffer (a base64 data URI).
+    static constexpr uint32_t TEST_ASSET_VERTEX_COUNT = 7u;
+    static constexpr uint64_t TEST_ASSET_BUFFER_SIZE = 248u;
+
+    static std::string getTestAssetJson(const std::string_view bufferUri, const uint32_t firstPrimitiveIndexCount = 6u)
+    {
+        const std::string uri = bufferUri.empty() ? std::string{} : std::format(R"(,"uri":"{}")", bufferUri);
+
+        return std::format(R"({{"asset":{{"version":"2.0"}},"scene":0,"scenes":[{{"nodes":[0]}}],"nodes":[{{"mesh":0}}],)"
+                           R"("meshes":[{{"primitives":[{{"attributes":{{"POSITION":0,"NORMAL":1,"TEXCOORD_0":2}},"indices":3}},)"
+                           R"({{"attributes":{{"POSITION":4,"NORMAL":5,"TEXCOORD_0":6}},"indices":7}}]}}],)"
+                           R"("buffers":[{{"byteLength":{}{}}},{{"byteLength":6,"uri":"data:application/octet-stream;base64,AAABAAIA"}}],)"
+                           R"("bufferViews":[{{"buffer":0,"byteLength":128,"byteStride":32}},{{"buffer":0,"byteOffset":128,"byteLength":24}},)"
+                           R"({{"buffer":0,"byteOffset":152,"byteLength":36}},{{"buffer":0,"byteOffset":188,"byteLength":36}},{{"buffer":0,"byteOffset":224,"byteLength":24}},)"
+                           R"({{"buffer":1,"byteLength":6}}],)"
+                           R"("accessors":[{{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3","min":[0,1,-3],"max":[3,7,0]}},)"
+                           R"({{"bufferView":0,"byteOffset":12,"componentType":5126,"count":4,"type":"VEC3"}},)"
+                           R"({{"bufferView":0,"byteOffset":24,"componentType":5126,"count":4,"type":"VEC2"}},)"
+                           R"({{"bufferView":1,"componentType":5125,"count":{},"type":"SCALAR"}},)"
+                           R"({{"bufferView":2,"componentType":5126,"count":3,"type":"VEC3","min":[4,9,-6],"max":[6,13,-4]}},)"
+                           R"({{"bufferView":3,"componentType":5126,"count":3,"type":"VEC3"}},)"
+                           R"({{"bufferView":4,"componentType":5126,"count":3,"type":"VEC2"}},)"
+                           R"({{"bufferView":5,"componentType":5123,"count":3,"type":"SCALAR"}}]}})",
+                           TEST_ASSET_BUFFER_SIZE,
+                           uri,
+                           firstPrimitiveIndexCount);
+    }
+
+    static math::XMFLOAT3 getTestAssetPosition(const uint32_t vertex)
+    {
+        return {static_cast<float>(vertex), static_cast<float>(vertex * 2u + 1u), -static_cast<float>(vertex)};
+    }
+
+    static math::XMFLOAT3 getTestAssetNormal(const uint32_t vertex) { return vertex < 4u ? math::XMFLOAT3{0.0f, 0.0f, 1.0f} : math::XMFLOAT3{0.0f, 1.0f, 0.0f}; }
+
+    static math::XMFLOAT2 getTestAssetTextureCoord(const uint32_t vertex)
+    {
+        return {static_cast<float>(vertex) * 0.25f, 1.0f - static_cast<float>(vertex) * 0.25f};
+    }
+
+    static std::vector<std::byte> getTestAssetBuffer()
+    {
+        std::vector<std::byte> buffer{};
+        const auto append = [&](const auto& value)
+        {
+            const std::span<const std::byte> bytes = std::as_bytes(std::span(&value, 1u));
+            buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+        };
+
+        for (const uint32_t vertex : std::views::iota(0u, 4u))
+        {
+            append(getTestAssetPosition(vertex));
+            append(getTestAssetNormal(vertex));
+            append(getTestAssetTextureCoord(vertex));
+        }
+
+        for (const uint32_t index : {0u, 1u, 2u, 0u, 2u, 3u})
+        {
+            append(index);
+        }
+
+        for (const uint32_t vertex : std::views::iota(4u, TEST_ASSET_VERTEX_COUNT))
+        {
+            append(getTestAssetPosition(vertex));
+        }
+
+        for (const uint32_t vertex : std::views::iota(4u, TEST_ASSET_VERTEX_COUNT))
+        {
+            append(getTestAssetNormal(vertex));
+        }
+
+        for (const uint32_t vertex : std::views::iota(4u, TEST_ASSET_VERTEX_COUNT))
+        {
+            append(getTestAssetTextureCoord(vertex));
+        }
+
+        return buffer;
+    }
+
+    // Offset of the binary chunk's data in the .glb made by makeGlb.
+    static uint64_t getGlbBinaryChunkOffset(const std::span<const std::byte> glb)
+    {
+        uint32_t jsonChunkSize{};
+        std::memcpy(&jsonChunkSize, glb.data() + 12u, sizeof(uint32_t));
+
+        return 12u + 8u + jsonChunkSize + 8u;
+    }
+
+    static std::vector<std::byte> makeGlb(std::string json, const std::span<const std::byte> buffer)
+    {
+        json.resize((json.size() + 3u) & ~size_t{3u}, ' ');
+
+        const std::array<uint32_t, 3u> header = {0x46546C67u, 2u, static_cast<uint32_t>(12u + 8u + json.size() + 8u + buffer.size())};
+        const std::array<uint32_t, 2u> jsonChunkHeader = {static_cast<uint32_t>(json.size()), 0x4E4F534Au};
+        const std::array<uint32_t, 2u> binaryChunkHeader = {static_cast<uint32_t>(buffer.size()), 0x004E4942u};
+
+        const std::array<std::span<const std::byte>, 5u> parts = {
+            std::as_bytes(std::span(header)),
+            std::as_bytes(std::span(jsonChunkHeader)),
+            std::as_bytes(std::span(json)),
+            std::as_bytes(std::span(binaryChunkHeader)),
+            buffer,
+        };
+
+        std::vector<std::byte> glb{};
+        for (const std::span<const std::byte> part : parts)
+        {
+            glb.insert(glb.end(), part.begin(), part.end());
+        }
+
+        return glb;
+    }
+
+    static void writeFile(const std::filesystem::path& filePath, const std::span<const std::byte> data)
+    {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    static bool isSameData(const auto& a, const auto& b) { return std::ranges::equal(std::as_bytes(std::span(a)), std::as_bytes(std::span(b))); }
+
+    static void checkTestAssetMesh(TestRunner& runner, const MeshData& meshData)
+    {
+        std::vector<math::XMFLOAT3> positions{};
+        std::vector<math::XMFLOAT3> normals{};
+        std::vector<math::XMFLOAT2> textureCoords{};
+        for (const uint32_t vertex : std::views::iota(0u, TEST_ASSET_VERTEX_COUNT))
+        {
+            positions.push_back(getTestAssetPosition(vertex));
+            normals.push_back(getTestAssetNormal(vertex));
+            textureCoords.push_back(getTestAssetTextureCoord(vertex));
+        }
+
+        NETHER_CHECK(runner, isSameData(meshData.positions, positions));
+        NETHER_CHECK(runner, isSameData(meshData.normals, normals));
+        NETHER_CHECK(runner, isSameData(meshData.textureCoords, textureCoords));
+
+        // The indices of the second primitive start at its first vertex.
+        NETHER_CHECK(runner, meshData.indices == std::vector<uint32_t>({0u, 1u, 2u, 0u, 2u, 3u, 4u, 5u, 6u}));
+    }
+
+    // The arrays the importer reads against the ones of tinygltf, and the mesh decoded by each (see checkConformance in benchmarks/GltfBenchmarks.cpp as well).
+    static void checkConformance(TestRunner& runner, const tinygltf::Model& model, const GltfModel& gltfModel)
+    {
+        static constexpr std::array<int32_t, 7u> tinyGltfTypes = {
+            TINYGLTF_TYPE_SCALAR,
+            TINYGLTF_TYPE_VEC2,
+            TINYGLTF_TYPE_VEC3,
+            TINYGLTF_TYPE_VEC4,
+            TINYGLTF_TYPE_MAT2,
+            TINYGLTF_TYPE_MAT3,
+            TINYGLTF_TYPE_MAT4,
+        };
+
+        // tinygltf uses -1 for indices that are not set.
+        const auto isSameIndex = [](const int32_t index, const uint32_t gltfIndex) { return index < 0 ? gltfIndex == ~0u : static_cast<uint32_t>(index) == gltfIndex; };
+
+        NETHER_CHECK(runner, model.buffers.size() == gltfModel.buffers.size());
+        NETHER_CHECK(runner, model.bufferViews.size() == gltfModel.bufferViews.size());
+        NETHER_CHECK(runner, model.accessors.size() == gltfModel.accessors.size());
+        NETHER_CHECK(runner, model.meshes.size() == gltfModel.meshes.size());
+        NETHER_CHECK(runner, model.nodes.size() == gltfModel.nodes.size());
+
+        for (size_t i = 0u; i < std::min(model.buffers.size(), gltfModel.buffers.size()); ++i)
+        {
+            // tinygltf keeps the padding of a .glb's binary chunk.
+            const std::span<const std::byte> data = std::as_bytes(std::span(model.buffers[i].data));
+            NETHER_CHECK(runner, data.size() >= gltfModel.buffers[i].byteLength && std::ranges::equal(data.first(gltfModel.buffers[i].byteLength), gltfModel.buffers[i].data));
+        }
+
+        for (size_t i = 0u; i < std::min(model.bufferViews.size(), gltfModel.bufferViews.size()); ++i)
+        {
+            const tinygltf::BufferView& bufferView = model.bufferViews[i];
+            const GltfBufferView& gltfBufferView = gltfModel.bufferViews[i];
+
+            NETHER_CHECK(runner, isSameIndex(bufferView.buffer, gltfBufferView.buffer) && bufferView.byteOffset == gltfBufferView.byteOffset);
+            NETHER_CHECK(runner, bufferView.byteLength == gltfBufferView.byteLength && bufferView.byteStride == gltfBufferView.byteStride);
+        }
+
+        for (size_t i = 0u; i < std::min(model.accessors.size(), gltfModel.accessors.size()); ++i)
+        {
+            const tinygltf::Accessor& accessor = model.accessors[i];
+            const GltfAccessor& gltfAccessor = gltfModel.accessors[i];
+
+            NETHER_CHECK(runner, isSameIndex(accessor.bufferView, gltfAccessor.bufferView) && accessor.byteOffset == gltfAccessor.byteOffset);
+            NETHER_CHECK(runner, accessor.count == gltfAccessor.count && accessor.componentType == static_cast<int32_t>(gltfAccessor.componentType));
+            NETHER_CHECK(runner, accessor.type == tinyGltfTypes[EnumClassValue(gltfAccessor.type)]);
+        }
+
+        for (size_t i = 0u; i < std::min(model.meshes.size(), gltfModel.meshes.size()); ++i)
+        {
+            const std::vector<tinygltf::Primitive>& primitives = model.meshes[i].primitives;
+            const GltfMesh& gltfMesh = gltfModel.meshes[i];
+
+            NETHER_CHECK(runner, primitives.size() == gltfMesh.primitiveCount);
+            for (size_t j = 0u; j < std::min<size_t>(primitives.size(), gltfMesh.primitiveCount); ++j)
+            {
+                const GltfPrimitive& gltfPrimitive = gltfModel.primitives[gltfMesh.firstPrimitive + j];
+
+                const auto getAttribute = [&](const std::string& attributeName)
+                {
+                    const auto attribute = primitives[j].attributes.find(attributeName);
+                    return attribute != primitives[j].attributes.end() ? attribute->second : -1;
+                };
+
+                NETHER_CHECK(runner, isSameIndex(getAttribute("POSITION"), gltfPrimitive.position) && isSameIndex(getAttribute("NORMAL"), gltfPrimitive.normal));
+                NETHER_CHECK(runner, isSameIndex(getAttribute("TEXCOORD_0"), gltfPrimitive.textureCoord) && isSameIndex(primitives[j].indices, gltfPrimitive.indices));
+            }
+        }
+
+        for (size_t i = 0u; i < std::min(model.nodes.size(), gltfModel.nodes.size()); ++i)
+        {
+            NETHER_CHECK(runner, isSameIndex(model.nodes[i].mesh, gltfModel.nodes[i].mesh));
+        }
+
+        const MeshData meshData = decodeMeshData(model);
+        const MeshData gltfMeshData = decodeMeshData(gltfModel);
+
+        NETHER_CHECK(runner, isSameData(meshData.positions, gltfMeshData.positions));
+        NETHER_CHECK(runner, isSameData(meshData.textureCoords, gltfMeshData.textureCoords));
+        NETHER_CHECK(runner, isSameData(meshData.normals, gltfMeshData.normals));
+        NETHER_CHECK(runner, meshData.indices == gltfMeshData.indices);
+    }
+
+    // The buffer of a .glb is a view of its binary chunk, nothing is copied but the data URI.
+    static void testGlb(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("GltfImporter");
+        const std::filesystem::path glbPath = directory.getPath() / "Test.glb";
+
+        const std::vector<std::byte> buffer = getTestAssetBuffer();
+        writeFile(glbPath, makeGlb(getTestAssetJson({}), buffer));
+
+        const MappedFile file(glbPath.string());
+
+        GltfModel gltfModel{};
+        importGltf(file.getData(), directory.getPath().generic_string(), gltfModel);
+
+        NETHER_CHECK(runner, gltfModel.buffers[0u].data.data() == file.getData().data() + getGlbBinaryChunkOffset(file.getData()));
+        NETHER_CHECK(runner, gltfModel.mappedFiles.empty() && gltfModel.bufferStorage.size() == 1u);
+
+        checkTestAssetMesh(runner, decodeMeshData(gltfModel));
+        checkTestAssetMesh(runner, loadMeshData(glbPath.string()));
+
+        tinygltf::Model model{};
+        loadGltfModel(glbPath.string(), model);
+
+        checkConformance(runner, model, gltfModel);
+    }
+
+    // The external buffer of a .gltf is a view of the mapped .bin file.
+    static void testGltf(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("GltfImporter");
+        const std::filesystem::path gltfPath = directory.getPath() / "Test.gltf";
+
+        const std::string json = getTestAssetJson("Test.bin");
+        writeFile(gltfPath, std::as_bytes(std::span(json)));
+        writeFile(directory.getPath() / "Test.bin", getTestAssetBuffer());
+
+        const MappedFile file(gltfPath.string());
+
+        GltfModel gltfModel{};
+        importGltf(file.getData(), directory.getPath().generic_string(), gltfModel);
+
+        NETHER_CHECK(runner, gltfModel.mappedFiles.size() == 1u && gltfModel.buffers[0u].data.data() == gltfModel.mappedFiles[0u].getData().data());
+
+        checkTestAssetMesh(runner, decodeMeshData(gltfModel));
+        checkTestAssetMesh(runner, loadMeshData(gltfPath.string()));
+
+        tinygltf::Model model{};
+        loadGltfModel(gltfPath.string(), model);
+
+        checkConformance(runner, model, gltfModel);
+    }
+
+    static void testSampleAssets(TestRunner& runner)
+    {
+        for (const std::string_view modelPath : SAMPLE_MODEL_PATHS)
+        {
+            const MappedFile file(modelPath);
+
+            GltfModel gltfModel{};
+            importGltf(file.getData(), std::filesystem::path(modelPath).parent_path().generic_string(), gltfModel);
+
+            tinygltf::Model model{};
+            loadGltfModel(modelPath, model);
+
+            checkConformance(runner, model, gltfModel);
+        }
+
+        // 6 faces of 2 triangles.
+        NETHER_CHECK(runner, loadMeshData(SAMPLE_MODEL_PATHS[0u]).indices.size() == 36u);
+    }
+
+    // External buffers are read from the asset archive when it has them, and from the file system otherwise.
+    static void testAssetArchive(TestRunner& runner)
+    {
+        const TemporaryDirectory directory("GltfImporter");
+        const std::string gltfPath = (directory.getPath() / "Test.gltf").generic_string();
+        const std::string binPath = (directory.getPath() / "Test.bin").generic_string();
+        const std::string archivePath = (directory.getPath() / "Test.pak").generic_string();
+
+        const std::string json = getTestAssetJson("Test.bin");
+        writeFile(gltfPath, std::as_bytes(std::span(json)));
+        writeFile(binPath, getTestAssetBuffer());
+
+        const std::array<std::string, 2u> filePaths = {gltfPath, binPath};
+        writeAssetArchive(archivePath, filePaths, true);
+
+        // Only the archive has the .bin now.
+        std::filesystem::remove(binPath);
+
+        const AssetArchive archive(archivePath);
+        const AssetArchiveEntry* const gltfEntry = archive.find(gltfPath);
+        if (gltfEntry == nullptr)
+        {
+            NETHER_CHECK(runner, gltfEntry != nullptr);
+            return;
+        }
+
+        std::vector<std::byte> gltfBuffer{};
+        const std::span<const std::byte> gltfFile = archive.read(*gltfEntry, gltfBuffer);
+
+        GltfModel gltfModel{};
+        importGltf(gltfFile, directory.getPath().generic_string(), gltfModel, &archive);
+
+        NETHER_CHECK(runner, gltfModel.mappedFiles.empty());
+        checkTestAssetMesh(runner, decodeMeshData(gltfModel));
+
+        tinygltf::Model model{};
+        parseGltfModel(gltfFile, directory.getPath().generic_string(), model, &archive);
+
+        checkConformance(runner, model, gltfModel);
+
+        // Without the archive, the .bin is looked for on disk.
+        GltfModel fileSystemModel{};
+        NETHER_CHECK_THROWS(runner, importGltf(gltfFile, directory.getPath().generic_string(), fileSystemModel), "Test.bin");
+    }
+
+    static void testMalformedGlb(TestRunner& runner)
+    {
+        const std::vector<std::byte> buffer = getTestAssetBuffer();
+        const std::vector<std::byte> glb = makeGlb(getTestAssetJson({}), buffer);
+        const uint64_t binaryChunkHeaderOffset = getGlbBinaryChunkOffset(glb) - 8u;
+
+        const auto import = [](const std::span<const std::byte> file)
+        {
+            GltfModel model{};
+            importGltf(file, {}, model);
+
+            return decodeMeshData(model);
+        };
+
+        const auto importPatched = [&](const uint64_t offset, const uint32_t value)
+        {
+            std::vector<std::byte> file = glb;
+            std::memcpy(file.data() + offset, &value, sizeof(uint32_t));
+
+            return import(file);
+        };
+
+        NETHER_CHECK_THROWS(runner, import(std::span(glb).first(16u)), "truncated .glb header");
+
+        // Version, then a length past the end of the file.
+        NETHER_CHECK_THROWS(runner, importPatched(4u, 1u), "unsupported .glb version");
+        NETHER_CHECK_THROWS(runner, import(std::span(glb).first(glb.size() - 4u)), "truncated .glb");
+
+        // Type and length of the JSON chunk.
+        NETHER_CHECK_THROWS(runner, importPatched(16u, 0x004E4942u), "the first .glb chunk is not JSON");
+        NETHER_CHECK_THROWS(runner, importPatched(12u, static_cast<uint32_t>(glb.size())), "truncated .glb JSON chunk");
+
+        // A binary chunk longer than the file, or shorter than the buffer.
+        NETHER_CHECK_THROWS(runner, importPatched(binaryChunkHeaderOffset, static_cast<uint32_t>(buffer.size() + 4u)), "truncated .glb binary chunk");
+        NETHER_CHECK_THROWS(runner, importPatched(binaryChunkHeaderOffset, 16u), "buffer is smaller than its byteLength");
+
+        // No binary chunk at all.
+        std::vector<std::byte> jsonOnlyGlb = makeGlb(getTestAssetJson({}), {});
+        jsonOnlyGlb.resize(jsonOnlyGlb.size() - 8u);
+
+        const uint32_t jsonOnlyGlbSize = static_cast<uint32_t>(jsonOnlyGlb.size());
+        std::memcpy(jsonOnlyGlb.data() + 8u, &jsonOnlyGlbSize, sizeof(uint32_t));
+
+        NETHER_CHECK_THROWS(runner, import(jsonOnlyGlb), "buffer is smaller than its byteLength");
+
+        // An accessor that reads past its buffer view is only found when decoding.
+        NETHER_CHECK_THROWS(runner, import(makeGlb(getTestAssetJson({}, 7u), buffer)), "accessor out of its buffer view's range");
+
+        // The untouched file imports.
+        checkTestAssetMesh(runner, import(glb));
+    }
+
+    void runGltfImporterTests(TestRunner& runner)
+    {
+        runner.run("GltfImporter/glb", [&]() { testGlb(runner); });
+        runner.run("GltfImporter/gltf", [&]() { testGltf(runner); });
+        runner.run("GltfImporter/sampleAssets", [&]() { testSampleAssets(runner); });
+        runner.run("GltfImporter/assetArchive", [&]() { testAssetArchive(runner); });
+        runner.run("GltfImporter/malformedGlb", [&]() { testMalformedGlb(runner); });
+    }
+}
@@ -0,0 +1,116 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AssetRegistry.hpp"
+#include "NullGraphicsBackend.hpp"
+
+// The engine only talks to the GPU through GraphicsBackend. The D3D12 backend needs a device, so the contract is checked against the null backend.
+namespace nether::Test
+{
+    static void testUploadBatch(TestRunner& runner)
+    {
+        NullGraphicsBackend graphicsBackend(1u, 16u);
+
+        // Nothing in flight yet, as Engine::uploadDecodedAssets assumes on its first call.
+        NETHER_CHECK(runner, graphicsBackend.completeUploadBatch(false));
+
+        const ImageData image = {
+            .width = 2u,
+            .height = 2u,
+            .pixels = std::vector<uint8_t>(2u * 2u * 4u, 255u),
+        };
+
+        graphicsBackend.beginUploadBatch();
+        const Texture texture = graphicsBackend.createTexture(image, DXGI_FORMAT_R8G8B8A8_UNORM, true, L"Test texture");
+        const Texture otherTexture = graphicsBackend.createTexture(image, DXGI_FORMAT_R8G8B8A8_UNORM, false, L"Test texture");
+
+        NETHER_CHECK(runner, texture.srvIndex != otherTexture.srvIndex);
+        NETHER_CHECK_THROWS(runner, graphicsBackend.beginUploadBatch(), "while an upload batch is recorded");
+        NETHER_CHECK_THROWS(runner, graphicsBackend.completeUploadBatch(false), "before the upload batch was submitted");
+
+        graphicsBackend.submitUploadBatch();
+        NETHER_CHECK_THROWS(runner, graphicsBackend.submitUploadBatch(), "without beginUploadBatch");
+        NETHER_CHECK_THROWS(runner, graphicsBackend.beginUploadBatch(), "or in flight");
+
+        // The next batch can only begin once the one in flight completed.
+        NETHER_CHECK(runner, graphicsBackend.completeUploadBatch(true));
+        graphicsBackend.beginUploadBatch();
+        graphicsBackend.submitUploadBatch();
+        NETHER_CHECK(runner, graphicsBackend.completeUploadBatch(false));
+
+        const NullGraphicsStatistics& statistics = graphicsBackend.getStatistics();
+        NETHER_CHECK(runner, statistics.uploadBatchCount == 2u);
+        NETHER_CHECK(runner, statistics.textureCount == 2u);
+    }
+
+    // The UI draw data is set by the render thread for the frame it submits next, and is not kept for the frames after it.
+    static void testUIDrawData(TestRunner& runner)
+    {
+        NullGraphicsBackend graphicsBackend(1u, 16u);
+
+        // Only compared against nullptr by the null backend, so it does not need to point to actual draw data.
+        const ImDrawData* const uiDrawData = reinterpret_cast<const ImDrawData*>(&graphicsBackend);
+
+        const auto submitFrame = [&](const ImDrawData* const drawData)
+        {
+            [[maybe_unused]] const FrameBuffers frameBuffers = graphicsBackend.beginFrame();
+            graphicsBackend.setUIDrawData(drawData);
+            graphicsBackend.submitFrame(0u);
+        };
+
+        submitFrame(uiDrawData);
+        NETHER_CHECK(runner, graphicsBackend.getStatistics().uiFrameCount == 1u);
+
+        submitFrame(nullptr);
+        NETHER_CHECK(runner, graphicsBackend.getStatistics().uiFrameCount == 1u);
+
+        // A frame that does not set it again is submitted without UI.
+        submitFrame(uiDrawData);
+        [[maybe_unused]] const FrameBuffers frameBuffers = graphicsBackend.beginFrame();
+        graphicsBackend.submitFrame(0u);
+
+        NETHER_CHECK(runner, graphicsBackend.getStatistics().frameCount == 4u);
+        NETHER_CHECK(runner, graphicsBackend.getStatistics().uiFrameCount == 2u);
+    }
+
+    // Assets destroyed by their registry return their descriptors, so loading and unloading assets does not use up the heap.
+    static void testDescriptorReclaim(TestRunner& runner)
+    {
+        constexpr uint32_t maxTextureCount = 4u;
+        constexpr uint64_t retireLatency = 3u;
+
+        NullGraphicsBackend graphicsBackend(1u, 16u, maxTextureCount);
+        AssetRegistry<Texture> textures(maxTextureCount, retireLatency, [&](Texture& texture) { graphicsBackend.destroyTexture(texture); });
+
+        const auto loader = [&](const std::string_view) { return graphicsBackend.createTexture(ImageData{}, DXGI_FORMAT_R8G8B8A8_UNORM, false, L"Test texture"); };
+
+        // Many more textures than the heap holds, but never more than it holds at once.
+        uint64_t frameNumber{};
+        for (const uint32_t i : std::views::iota(0u, maxTextureCount * 8u))
+        {
+            textures.release(textures.acquire(std::format("{}.png", i), loader));
+            textures.collectGarbage(++frameNumber);
+
+            NETHER_CHECK(runner, graphicsBackend.getAllocatedDescriptorCount() <= maxTextureCount);
+        }
+
+        textures.collectGarbage(frameNumber + retireLatency);
+        NETHER_CHECK(runner, graphicsBackend.getAllocatedDescriptorCount() == 0u);
+
+        // Running out of descriptors is fatal, rather than writing past the end of the heap.
+        for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, maxTextureCount))
+        {
+            [[maybe_unused]] const Texture texture = graphicsBackend.createTexture(ImageData{}, DXGI_FORMAT_R8G8B8A8_UNORM, false, L"Test texture");
+        }
+
+        NETHER_CHECK_THROWS(runner, graphicsBackend.createTexture(ImageData{}, DXGI_FORMAT_R8G8B8A8_UNORM, false, L"Test texture"), "Null descriptor heap is full");
+    }
+
+    void runGraphicsBackendTests(TestRunner& runner)
+    {
+        runner.run("GraphicsBackend/uploadBatch", [&]() { testUploadBatch(runner); });
+        runner.run("GraphicsBackend/uiDrawData", [&]() { testUIDrawData(runner); });
+        runner.run("GraphicsBackend/descriptorReclaim", [&]() { testDescriptorReclaim(runner); });
+    }
+}
@@ -0,0 +1,163 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "FrameRenderer.hpp"
+#include "IndirectCommands.hpp"
+#include "NullGraphicsBackend.hpp"
+
+namespace nether::Test
+{
+    static void testEncode(TestRunner& runner)
+    {
+        Mesh mesh{};
+        mesh.positionBuffer.srvIndex = 11u;
+        mesh.textureCoordBuffer.srvIndex = 12u;
+        mesh.normalBuffer.srvIndex = 13u;
+        mesh.indexBuffer.indexBufferView = {
+            .BufferLocation = 0x0000'1234'89AB'CDEFull,
+            .SizeInBytes = 36u * sizeof(uint32_t),
+            .Format = DXGI_FORMAT_R32_UINT,
+        };
+        mesh.indexCount = 36u;
+
+        const InstancedDraw draw = {
+            .mesh = &mesh,
+            .albedoTextureIndex = 5u,
+            .indexCount = mesh.indexCount,
+            .firstInstance = 100u,
+            .instanceCount = 7u,
+        };
+
+        const IndirectDrawRecord record = encodeIndirectDraw(draw, 1u, 2u);
+
+        NETHER_CHECK(runner, record.renderResources.positionBufferIndex == 11u);
+        NETHER_CHECK(runner, record.renderResources.textureCoordBufferIndex == 12u);
+        NETHER_CHECK(runner, record.renderResources.normalBufferIndex == 13u);
+        NETHER_CHECK(runner, record.renderResources.sceneBufferIndex == 1u);
+        NETHER_CHECK(runner, record.renderResources.instanceBufferIndex == 2u);
+        NETHER_CHECK(runner, record.renderResources.instanceOffset == 100u);
+        NETHER_CHECK(runner, record.renderResources.albedoTextureIndex == 5u);
+
+        NETHER_CHECK(runner, record.drawArguments.indexCountPerInstance == 36u);
+        NETHER_CHECK(runner, record.drawArguments.instanceCount == 7u);
+        NETHER_CHECK(runner, record.drawArguments.startInstanceLocation == 100u);
+
+        // The command signature reads the index buffer view as a D3D12_INDEX_BUFFER_VIEW, at the offset given by the layout.
+        std::array<std::byte, sizeof(IndirectDrawRecord)> recordBytes{};
+        std::memcpy(recordBytes.data(), &record, sizeof(IndirectDrawRecord));
+
+        D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+        std::memcpy(&indexBufferView.BufferLocation, recordBytes.data() + INDIRECT_DRAW_LAYOUT.indexBufferViewOffsetInBytes, sizeof(uint64_t));
+        std::memcpy(&indexBufferView.SizeInBytes, recordBytes.data() + INDIRECT_DRAW_LAYOUT.indexBufferViewOffsetInBytes + 8u, sizeof(uint32_t));
+        std::memcpy(&indexBufferView.Format, recordBytes.data() + INDIRECT_DRAW_LAYOUT.indexBufferViewOffsetInBytes + 12u, sizeof(uint32_t));
+
+        NETHER_CHECK(runner, indexBufferView.BufferLocation == mesh.indexBuffer.indexBufferView.BufferLocation);
+        NETHER_CHECK(runner, indexBufferView.SizeInBytes == mesh.indexBuffer.indexBufferView.SizeInBytes);
+        NETHER_CHECK(runner, indexBufferView.Format == DXGI_FORMAT_R32_UINT);
+    }
+
+    // Meshes with different index buffers, drawn with a few pipelines, as the null backend creates them.
+    struct IndirectDrawScene
+    {
+        NullGraphicsBackend graphicsBackend;
+
+        std::array<GraphicsPipeline, 3u> graphicsPipelines{};
+        std::array<Mesh, 8u> meshes{};
+        std::vector<Renderable> renderables{};
+
+        DrawList drawList{};
+
+        explicit IndirectDrawScene(const uint32_t renderableCount) : graphicsBackend(4u, renderableCount)
+        {
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(meshes.size())))
+            {
+                meshes[i].indexCount = 3u * (i + 1u);
+                meshes[i].indexBuffer = graphicsBackend.createIndexBuffer(nullptr, meshes[i].indexCount * sizeof(uint32_t), L"Test index buffer");
+            }
+
+            for (const uint32_t i : std::views::iota(0u, renderableCount))
+            {
+                renderables.push_back(Renderable{
+                    .mesh = &meshes[(i * 5u) % meshes.size()],
+                    .graphicsPipeline = &graphicsPipelines[(i / 3u) % graphicsPipelines.size()],
+                    .albedoTextureIndex = i % 2u,
+                });
+            }
+
+            drawList.build(renderables);
+        }
+    };
+
+    static void testBatchPerPipeline(TestRunner& runner)
+    {
+        IndirectDrawScene scene(300u);
+
+        IndirectCommandBuilder indirectCommandBuilder{};
+        indirectCommandBuilder.build(scene.drawList.getDraws(), 1u, 2u);
+
+        const std::span<const InstancedDraw> draws = scene.drawList.getDraws();
+        const std::span<const IndirectDrawRecord> records = indirectCommandBuilder.getRecords();
+        const std::span<const IndirectDrawBatch> batches = indirectCommandBuilder.getBatches();
+
+        // Every pipeline is a single batch, even though its draws use different meshes.
+        NETHER_CHECK(runner, records.size() == draws.size());
+        NETHER_CHECK(runner, batches.size() == scene.graphicsPipelines.size());
+
+        uint32_t nextRecord{};
+        for (const IndirectDrawBatch& batch : batches)
+        {
+            NETHER_CHECK(runner, batch.firstRecord == nextRecord);
+            nextRecord += batch.recordCount;
+
+            for (const uint32_t i : std::views::iota(batch.firstRecord, batch.firstRecord + batch.recordCount))
+            {
+                NETHER_CHECK(runner, draws[i].graphicsPipeline == batch.graphicsPipeline);
+                NETHER_CHECK(runner, records[i].indexBufferView.sizeInBytes == draws[i].mesh->indexBuffer.indexBufferView.SizeInBytes);
+                NETHER_CHECK(runner, records[i].drawArguments.indexCountPerInstance == draws[i].indexCount);
+            }
+        }
+
+        NETHER_CHECK(runner, nextRecord == records.size());
+    }
+
+    // A frame through the null backend, which validates every record against the index buffer it binds.
+    static void testRenderFrame(TestRunner& runner)
+    {
+        IndirectDrawScene scene(300u);
+
+        FramePacket framePacket{};
+        framePacket.draws = scene.drawList.getDraws();
+
+        const std::span<InstanceData> instances = framePacket.arena.allocateArray<InstanceData>(scene.drawList.getInstanceIndices().size());
+        std::ranges::fill(instances, InstanceData{});
+        framePacket.instances = instances;
+
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 0u});
+        ParallelRecorder parallelRecorder(jobSystem);
+        FrameRenderer frameRenderer{};
+        frameRenderer.render(scene.graphicsBackend, parallelRecorder, framePacket);
+
+        // One ExecuteIndirect per pipeline for the whole pass.
+        const NullGraphicsStatistics& statistics = scene.graphicsBackend.getStatistics();
+        NETHER_CHECK(runner, statistics.frameCount == 1u);
+        NETHER_CHECK(runner, statistics.drawIndirectCount == scene.graphicsPipelines.size());
+        NETHER_CHECK(runner, statistics.pipelineChangeCount == scene.graphicsPipelines.size());
+        NETHER_CHECK(runner, statistics.drawRecordCount == framePacket.draws.size());
+        NETHER_CHECK(runner, statistics.instanceCount == scene.renderables.size());
+
+        // A draw that reads past the end of its own index buffer is caught, even when the previous record's index buffer would have been large enough.
+        scene.meshes[0].indexCount = scene.meshes.back().indexCount;
+        scene.drawList.build(scene.renderables);
+        framePacket.draws = scene.drawList.getDraws();
+
+        NETHER_CHECK_THROWS(runner, frameRenderer.render(scene.graphicsBackend, parallelRecorder, framePacket), "index buffer only holds");
+    }
+
+    void runIndirectCommandsTests(TestRunner& runner)
+    {
+        runner.run("IndirectCommands/encode", [&]() { testEncode(runner); });
+        runner.run("IndirectCommands/batchPerPipeline", [&]() { testBatchPerPipeline(runner); });
+        runner.run("IndirectCommands/renderFrame", [&]() { testRenderFrame(runner); });
+    }
+}
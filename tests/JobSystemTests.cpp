@@ -0,0 +1,302 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "JobSystem.hpp"
+
+// The threaded tests are meant to be run under ThreadSanitizer as well (premake5 gmake2 --sanitize=thread).
+namespace nether::Test
+{
+    // Single threaded, so the order of the jobs is known.
+    static void testWorkStealingDeque(TestRunner& runner)
+    {
+        // Starts small, so the buffer grows while jobs are in it.
+        WorkStealingDeque deque(2u);
+        std::array<Job, 10u> jobs{};
+
+        NETHER_CHECK(runner, deque.isEmpty());
+        NETHER_CHECK(runner, deque.pop() == nullptr);
+        NETHER_CHECK(runner, deque.steal() == nullptr);
+
+        for (Job& job : jobs)
+        {
+            deque.push(&job);
+        }
+
+        // The owner pops the newest jobs, thieves steal the oldest.
+        NETHER_CHECK(runner, deque.pop() == &jobs[9]);
+        NETHER_CHECK(runner, deque.steal() == &jobs[0]);
+        NETHER_CHECK(runner, deque.steal() == &jobs[1]);
+        NETHER_CHECK(runner, deque.pop() == &jobs[8]);
+
+        uint32_t remainingCount{};
+        while (deque.pop() != nullptr)
+        {
+            remainingCount++;
+        }
+
+        NETHER_CHECK(runner, remainingCount == 6u);
+        NETHER_CHECK(runner, deque.isEmpty());
+    }
+
+    // The owner pushes and pops while thieves steal. Every job is taken exactly once.
+    static void testConcurrentSteal(TestRunner& runner)
+    {
+        constexpr uint32_t jobCount = 100000u;
+        constexpr uint32_t thiefCount = 3u;
+
+        WorkStealingDeque deque(16u);
+        std::vector<Job> jobs(jobCount);
+        std::vector<std::atomic<uint32_t>> takenCounts(jobCount);
+
+        const auto take = [&](const Job* const job) { takenCounts[static_cast<size_t>(job - jobs.data())].fetch_add(1u, std::memory_order_relaxed); };
+
+        std::atomic<bool> isOwnerDone{false};
+        std::vector<std::jthread> thieves{};
+        for ([[maybe_unused]] const uint32_t thief : std::views::iota(0u, thiefCount))
+        {
+            thieves.emplace_back(
+                [&]()
+                {
+                    while (!isOwnerDone.load(std::memory_order_acquire) || !deque.isEmpty())
+                    {
+                        if (const Job* const job = deque.steal())
+                        {
+                            take(job);
+                        }
+                    }
+                });
+        }
+
+        for (const uint32_t i : std::views::iota(0u, jobCount))
+        {
+            deque.push(&jobs[i]);
+
+            // Pops some of the jobs, so the owner races the thieves for the last job of the deque.
+            if (i % 3u == 0u)
+            {
+                if (const Job* const job = deque.pop())
+                {
+                    take(job);
+                }
+            }
+        }
+
+        isOwnerDone.store(true, std::memory_order_release);
+        thieves.clear();
+
+        NETHER_CHECK(runner, std::ranges::all_of(takenCounts, [](const std::atomic<uint32_t>& count) { return count.load() == 1u; }));
+    }
+
+    static void testScheduleAndWait(TestRunner& runner, const uint32_t workerThreadCount)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = workerThreadCount});
+        NETHER_CHECK(runner, jobSystem.getThreadCount() == workerThreadCount + 1u);
+
+        // Jobs that fork more jobs (to the worker's own deque) from inside a job, and wait for them there.
+        constexpr uint32_t outerJobCount = 64u;
+        constexpr uint32_t innerJobCount = 32u;
+
+        std::atomic<uint32_t> innerRunCount{};
+        JobCounter counter{};
+        for ([[maybe_unused]] const uint32_t outerJob : std::views::iota(0u, outerJobCount))
+        {
+            jobSystem.schedule(
+                [&]()
+                {
+                    JobCounter innerCounter{};
+                    for ([[maybe_unused]] const uint32_t innerJob : std::views::iota(0u, innerJobCount))
+                    {
+                        jobSystem.schedule([&]() { innerRunCount.fetch_add(1u, std::memory_order_relaxed); }, &innerCounter);
+                    }
+
+                    jobSystem.wait(innerCounter);
+                },
+                &counter);
+        }
+
+        jobSystem.wait(counter);
+
+        NETHER_CHECK(runner, counter.isDone());
+        NETHER_CHECK(runner, innerRunCount.load() == outerJobCount * innerJobCount);
+
+        // Jobs the caller keeps alive, submitted without allocating.
+        std::array<uint32_t, 16u> values{};
+        std::array<Job, 16u> jobs{};
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(jobs.size())))
+        {
+            jobs[i] = Job{
+                .function = [](void* const data) { *static_cast<uint32_t*>(data) += 1u; },
+                .data = &values[i],
+                .counter = &counter,
+            };
+
+            jobSystem.submit(jobs[i]);
+        }
+
+        jobSystem.wait(counter);
+        NETHER_CHECK(runner, std::ranges::all_of(values, [](const uint32_t value) { return value == 1u; }));
+    }
+
+    // A job scheduled after a counter only runs once every job it counted has finished, including jobs that finish before the dependent job is scheduled.
+    static void testScheduleAfter(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+
+        for ([[maybe_unused]] const uint32_t iteration : std::views::iota(0u, 200u))
+        {
+            std::atomic<uint32_t> finishedCount{};
+            uint32_t finishedCountSeenByDependentJob{};
+
+            JobCounter dependency{};
+            for ([[maybe_unused]] const uint32_t job : std::views::iota(0u, 8u))
+            {
+                jobSystem.schedule([&]() { finishedCount.fetch_add(1u, std::memory_order_relaxed); }, &dependency);
+            }
+
+            JobCounter counter{};
+            jobSystem.scheduleAfter(dependency, [&]() { finishedCountSeenByDependentJob = finishedCount.load(std::memory_order_relaxed); }, &counter);
+
+            jobSystem.wait(counter);
+            jobSystem.wait(dependency);
+
+            NETHER_CHECK(runner, finishedCountSeenByDependentJob == 8u);
+        }
+
+        // Once the dependency is done, the job runs right away.
+        JobCounter doneDependency{};
+        JobCounter counter{};
+        bool hasRun{false};
+        jobSystem.scheduleAfter(doneDependency, [&]() { hasRun = true; }, &counter);
+        jobSystem.wait(counter);
+
+        NETHER_CHECK(runner, hasRun);
+    }
+
+    static void testExceptions(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 2u});
+
+        // The first exception is rethrown by wait, and the other jobs of the counter still run.
+        std::atomic<uint32_t> runCount{};
+        JobCounter counter{};
+        for (const uint32_t i : std::views::iota(0u, 16u))
+        {
+            jobSystem.schedule(
+                [&, i]()
+                {
+                    runCount.fetch_add(1u, std::memory_order_relaxed);
+                    if (i == 5u)
+                    {
+                        fatalError("Job 5 failed.");
+                    }
+                },
+                &counter);
+        }
+
+        NETHER_CHECK_THROWS(runner, jobSystem.wait(counter), "Job 5 failed.");
+        NETHER_CHECK(runner, runCount.load() == 16u);
+        NETHER_CHECK(runner, counter.isDone());
+    }
+
+    static void testParallelFor(TestRunner& runner, const uint32_t workerThreadCount)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = workerThreadCount});
+
+        // Every index is visited exactly once, whatever the count and batch size, including counts smaller than a batch.
+        for (const uint32_t count : {0u, 1u, 7u, 64u, 1000u, 100003u})
+        {
+            for (const uint32_t minBatchSize : {1u, 16u, 4096u})
+            {
+                std::vector<std::atomic<uint32_t>> visitCounts(count);
+                std::atomic<uint32_t> outOfRangeCount{};
+
+                jobSystem.parallelFor(count,
+                                      minBatchSize,
+                                      [&](const uint32_t begin, const uint32_t end)
+                                      {
+                                          if (begin >= end || end > count)
+                                          {
+                                              outOfRangeCount.fetch_add(1u, std::memory_order_relaxed);
+                                              return;
+                                          }
+
+                                          for (const uint32_t i : std::views::iota(begin, end))
+                                          {
+                                              visitCounts[i].fetch_add(1u, std::memory_order_relaxed);
+                                          }
+                                      });
+
+                NETHER_CHECK(runner, outOfRangeCount.load() == 0u);
+                NETHER_CHECK(runner, std::ranges::all_of(visitCounts, [](const std::atomic<uint32_t>& visitCount) { return visitCount.load() == 1u; }));
+            }
+        }
+    }
+
+    static Task<uint32_t> sumRange(JobSystem& jobSystem, const uint32_t begin, const uint32_t end)
+    {
+        co_await jobSystem.schedule();
+
+        uint32_t sum{};
+        for (const uint32_t i : std::views::iota(begin, end))
+        {
+            sum += i;
+        }
+
+        co_return sum;
+    }
+
+    static Task<uint32_t> sumInParallel(JobSystem& jobSystem, const uint32_t count, const uint32_t taskCount)
+    {
+        std::vector<Task<uint32_t>> tasks{};
+        for (const uint32_t i : std::views::iota(0u, taskCount))
+        {
+            tasks.push_back(sumRange(jobSystem, count * i / taskCount, count * (i + 1u) / taskCount));
+        }
+
+        co_await jobSystem.whenAll(std::span(tasks));
+
+        uint32_t sum{};
+        for (Task<uint32_t>& task : tasks)
+        {
+            sum += task.getResult();
+        }
+
+        co_return sum;
+    }
+
+    static Task<void> failAfterSchedule(JobSystem& jobSystem)
+    {
+        co_await jobSystem.schedule();
+        fatalError("Task failed.");
+    }
+
+    static void testTasks(TestRunner& runner, const uint32_t workerThreadCount)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = workerThreadCount});
+
+        NETHER_CHECK(runner, jobSystem.runTask(sumInParallel(jobSystem, 10000u, 8u)) == 10000u * 9999u / 2u);
+        NETHER_CHECK(runner, jobSystem.runTask(sumInParallel(jobSystem, 10u, 0u)) == 0u);
+
+        NETHER_CHECK_THROWS(runner, jobSystem.runTask(failAfterSchedule(jobSystem)), "Task failed.");
+    }
+
+    void runJobSystemTests(TestRunner& runner)
+    {
+        runner.run("JobSystem/workStealingDeque", [&]() { testWorkStealingDeque(runner); });
+        runner.run("JobSystem/concurrentSteal", [&]() { testConcurrentSteal(runner); });
+
+        // Without workers, every job runs on the thread that waits for it.
+        for (const uint32_t workerThreadCount : {0u, 3u})
+        {
+            const std::string suffix = std::format("/{}Workers", workerThreadCount);
+
+            runner.run("JobSystem/scheduleAndWait" + suffix, [&]() { testScheduleAndWait(runner, workerThreadCount); });
+            runner.run("JobSystem/parallelFor" + suffix, [&]() { testParallelFor(runner, workerThreadCount); });
+            runner.run("JobSystem/tasks" + suffix, [&]() { testTasks(runner, workerThreadCount); });
+        }
+
+        runner.run("JobSystem/scheduleAfter", [&]() { testScheduleAfter(runner); });
+        runner.run("JobSystem/exceptions", [&]() { testExceptions(runner); });
+    }
+}
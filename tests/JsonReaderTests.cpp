@@ -0,0 +1,465 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "CpuFeatures.hpp"
+#include "JsonReader.hpp"
+
+namespace nether::Test
+{
+    static bool isJsonWhitespace(const char character) { return character == ' ' || character == '\n' || character == '\r' || character == '\t'; }
+
+    static bool isJsonStructural(const char character) { return std::string_view("{}[]:,").find(character) != std::string_view::npos; }
+
+    // What JsonTokenizer finds 64 bytes at a time, found one character at a time. Returns nullopt where the tokenizer fails (unterminated strings, control characters in
+    // strings and invalid escape sequences, which are checked inside and outside of strings).
+    static std::optional<std::vector<uint64_t>> tokenizeReference(const std::string_view json)
+    {
+        std::vector<uint64_t> tokens{};
+        bool isInString{};
+        bool isAfterScalar{};
+
+        for (uint64_t i = 0u; i < json.size(); ++i)
+        {
+            const char character = json[i];
+
+            if (character == '\\')
+            {
+                const std::string_view escape = json.substr(std::min<uint64_t>(i + 1u, json.size()));
+                const bool isValid = !escape.empty() && std::string_view("\"\\/bfnrtu").find(escape[0u]) != std::string_view::npos &&
+                                     (escape[0u] != 'u' || (escape.size() >= 5u && std::ranges::all_of(escape.substr(1u, 4u),
+                                                                                                       [](const char digit)
+                                                                                                       { return std::isxdigit(static_cast<unsigned char>(digit)) != 0; })));
+                if (!isValid)
+                {
+                    return std::nullopt;
+                }
+
+                // Outside of strings, the backslash and the character it escapes are part of a scalar.
+                if (!isInString && !isAfterScalar)
+                {
+                    tokens.push_back(i);
+                }
+
+                isAfterScalar = !isInString;
+                ++i;
+            }
+            else if (character == '"')
+            {
+                if (!isInString)
+                {
+                    tokens.push_back(i);
+                }
+
+                isInString = !isInString;
+                isAfterScalar = false;
+            }
+            else if (isInString)
+            {
+                if (static_cast<unsigned char>(character) < 0x20u)
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (isJsonStructural(character))
+            {
+                tokens.push_back(i);
+                isAfterScalar = false;
+            }
+            else if (isJsonWhitespace(character))
+            {
+                isAfterScalar = false;
+            }
+            else
+            {
+                if (!isAfterScalar)
+                {
+                    tokens.push_back(i);
+                }
+
+                isAfterScalar = true;
+            }
+        }
+
+        if (isInString)
+        {
+            return std::nullopt;
+        }
+
+        tokens.push_back(json.size());
+        return tokens;
+    }
+
+    static std::optional<std::vector<uint64_t>> tokenize(const std::string_view json)
+    {
+        JsonTokenizer tokenizer(json);
+        std::vector<uint64_t> tokens{};
+
+        try
+        {
+            while (tokenizer.tokenizeWindow(tokens))
+            {
+            }
+        }
+        catch (const std::runtime_error&)
+        {
+            return std::nullopt;
+        }
+
+        return tokens;
+    }
+
+    // Skips the whole document. Returns false if it is malformed.
+    static bool isValidJson(const std::string_view json)
+    {
+        try
+        {
+            JsonReader reader(json);
+            reader.skipValue();
+            reader.expectEnd();
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    // Parts of strings and the characters they decode to : escape sequences (including a surrogate pair, U+1F600), structural characters and UTF-8 (U+00E9).
+    static constexpr std::array<std::pair<std::string_view, std::string_view>, 12u> STRING_PARTS = {{
+        {"a", "a"},
+        {"glTF", "glTF"},
+        {"\\\"", "\""},
+        {"\\\\", "\\"},
+        {"\\/", "/"},
+        {"\\n", "\n"},
+        {"\\t", "\t"},
+        {"\\u00e9", "\xC3\xA9"},
+        {"\\ud83d\\ude00", "\xF0\x9F\x98\x80"},
+        {"{}[]:,", "{}[]:,"},
+        {"\xC3\xA9", "\xC3\xA9"},
+        {"  ", "  "},
+    }};
+
+    // Random valid JSON, with the whitespace, escape sequences and nesting the tokenizer has to get right.
+    static void appendRandomValue(std::mt19937& randomEngine, const uint32_t depth, std::string& json)
+    {
+        static constexpr std::array<std::string_view, 4u> whitespaces = {"", " ", "\n\t", "\r\n    "};
+        static constexpr std::array<std::string_view, 8u> scalars = {"0", "-12", "3.25", "1e9", "-0.5E-3", "true", "false", "null"};
+
+        json += whitespaces[randomEngine() % whitespaces.size()];
+
+        const uint32_t kind = depth >= 4u ? randomEngine() % 2u : randomEngine() % 4u;
+        if (kind == 0u)
+        {
+            json += scalars[randomEngine() % scalars.size()];
+        }
+        else if (kind == 1u)
+        {
+            json += '"';
+            for ([[maybe_unused]] const uint32_t part : std::views::iota(0u, static_cast<uint32_t>(randomEngine() % 8u)))
+            {
+                json += STRING_PARTS[randomEngine() % STRING_PARTS.size()].first;
+            }
+
+            json += '"';
+        }
+        else
+        {
+            const bool isObject = kind == 2u;
+            json += isObject ? '{' : '[';
+
+            const uint32_t elementCount = static_cast<uint32_t>(randomEngine() % 5u);
+            for (const uint32_t element : std::views::iota(0u, elementCount))
+            {
+                json += element == 0u ? "" : ",";
+                if (isObject)
+                {
+                    json += std::format("{}\"key{}\"{}:", whitespaces[randomEngine() % whitespaces.size()], element, whitespaces[randomEngine() % whitespaces.size()]);
+                }
+
+                appendRandomValue(randomEngine, depth + 1u, json);
+            }
+
+            json += whitespaces[randomEngine() % whitespaces.size()];
+            json += isObject ? '}' : ']';
+        }
+
+        json += whitespaces[randomEngine() % whitespaces.size()];
+    }
+
+    // Random documents, and the same documents with a byte changed, inserted or removed, are tokenized the same as by the reference. Any document the reference
+    // rejects is rejected by the reader as well.
+    static void testTokenizerReference(TestRunner& runner)
+    {
+        static constexpr std::string_view mutationCharacters = "{}[]:,\"\\ \nu0aE-\x01\x7F\xC3";
+
+        std::mt19937 randomEngine(50u);
+
+        uint32_t mismatchCount{};
+        uint32_t rejectedCount{};
+        uint32_t missedErrorCount{};
+
+        for (const uint32_t iteration : std::views::iota(0u, 3000u))
+        {
+            std::string json{};
+            appendRandomValue(randomEngine, 0u, json);
+
+            // Valid documents tokenize and read as they are.
+            NETHER_CHECK(runner, tokenize(json).has_value() && isValidJson(json));
+
+            if (iteration % 2u == 1u && !json.empty())
+            {
+                const size_t position = randomEngine() % json.size();
+                const char character = mutationCharacters[randomEngine() % mutationCharacters.size()];
+
+                switch (randomEngine() % 3u)
+                {
+                    case 0u:
+                        json[position] = character;
+                        break;
+                    case 1u:
+                        json.insert(json.begin() + static_cast<ptrdiff_t>(position), character);
+                        break;
+                    default:
+                        json.erase(position, 1u);
+                        break;
+                }
+            }
+
+            const std::optional<std::vector<uint64_t>> referenceTokens = tokenizeReference(json);
+            mismatchCount += tokenize(json) == referenceTokens ? 0u : 1u;
+
+            rejectedCount += referenceTokens.has_value() ? 0u : 1u;
+            missedErrorCount += !referenceTokens.has_value() && isValidJson(json) ? 1u : 0u;
+        }
+
+        NETHER_CHECK(runner, mismatchCount == 0u);
+        NETHER_CHECK(runner, missedErrorCount == 0u);
+
+        // The mutations do make malformed documents.
+        NETHER_CHECK(runner, rejectedCount > 100u);
+    }
+
+    // The scalar lane classifies each character as the reference does, and the AVX2 lane (on CPUs that have it) gives the same masks for the same blocks : every byte
+    // value at every position, and the blocks of random documents.
+    static void testClassifyLanes(TestRunner& runner)
+    {
+        using BlockMasks = JsonTokenizer::BlockMasks;
+
+        const auto classifyReference = [](const std::span<const char> block)
+        {
+            BlockMasks masks{};
+            for (const size_t i : std::views::iota(size_t{0u}, block.size()))
+            {
+                const uint64_t bit = uint64_t{1u} << i;
+
+                masks.quote |= block[i] == '"' ? bit : 0u;
+                masks.backslash |= block[i] == '\\' ? bit : 0u;
+                masks.structural |= isJsonStructural(block[i]) ? bit : 0u;
+                masks.whitespace |= isJsonWhitespace(block[i]) ? bit : 0u;
+                masks.control |= static_cast<uint8_t>(block[i]) < 0x20u ? bit : 0u;
+            }
+
+            return masks;
+        };
+
+        std::vector<std::array<char, JsonTokenizer::BLOCK_SIZE>> blocks{};
+        for (const uint32_t firstValue : std::views::iota(0u, 256u))
+        {
+            std::array<char, JsonTokenizer::BLOCK_SIZE>& block = blocks.emplace_back();
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(block.size())))
+            {
+                block[i] = static_cast<char>((firstValue + i * 37u) % 256u);
+            }
+        }
+
+        std::mt19937 randomEngine(51u);
+        for ([[maybe_unused]] const uint32_t document : std::views::iota(0u, 100u))
+        {
+            std::string json{};
+            appendRandomValue(randomEngine, 0u, json);
+
+            for (size_t offset = 0u; offset + JsonTokenizer::BLOCK_SIZE <= json.size(); offset += 7u)
+            {
+                std::ranges::copy(std::string_view(json).substr(offset, JsonTokenizer::BLOCK_SIZE), blocks.emplace_back().begin());
+            }
+        }
+
+        const bool isAvx2Supported = CpuFeatures::isAvx2Supported();
+
+        uint32_t scalarMismatchCount{};
+        uint32_t avx2MismatchCount{};
+
+        for (const std::array<char, JsonTokenizer::BLOCK_SIZE>& block : blocks)
+        {
+            const BlockMasks scalarMasks = JsonTokenizer::classifyBlockScalar(block.data());
+
+            scalarMismatchCount += scalarMasks == classifyReference(block) ? 0u : 1u;
+            avx2MismatchCount += !isAvx2Supported || JsonTokenizer::classifyBlockAvx2(block.data()) == scalarMasks ? 0u : 1u;
+        }
+
+        NETHER_CHECK(runner, blocks.size() > 1000u);
+        NETHER_CHECK(runner, scalarMismatchCount == 0u);
+        NETHER_CHECK(runner, avx2MismatchCount == 0u);
+
+        if (!isAvx2Supported)
+        {
+            std::cout << "    JsonReader/classifyLanes : this CPU does not have AVX2, only the scalar lane was checked\n";
+        }
+    }
+
+    static void testStrings(TestRunner& runner)
+    {
+        for (const auto& [encoded, decoded] : STRING_PARTS)
+        {
+            const std::string json = std::format("\"{}\"", encoded);
+
+            NETHER_CHECK(runner, JsonReader(json).readString() == decoded);
+            NETHER_CHECK(runner, JsonReader(json).readRawString() == encoded);
+        }
+
+        // A high surrogate without its low surrogate is decoded on its own.
+        NETHER_CHECK(runner, JsonReader("\"\\ud83dx\"").readString() == "\xED\xA0\xBDx");
+        NETHER_CHECK(runner, JsonReader("\"\\u0041\\b\\f\\r\"").readString() == "A\b\f\r");
+    }
+
+    // Escapes, strings and scalars that cross the boundaries of the 64 byte blocks and of the windows.
+    static void testBoundaries(TestRunner& runner)
+    {
+        for (const uint64_t padding : std::views::iota(50u, 80u))
+        {
+            const std::string json = std::format("[{}\"\\\\\\\"\\u00e9\",12345678,\"{}\\\\\"]", std::string(padding, ' '), std::string(padding % 7u, 'a'));
+
+            NETHER_CHECK(runner, tokenize(json) == tokenizeReference(json));
+
+            JsonReader reader(json);
+            std::vector<std::string> strings{};
+            uint64_t number{};
+
+            reader.readArray(
+                [&]()
+                {
+                    if (strings.size() == 1u && number == 0u)
+                    {
+                        number = reader.readUnsigned();
+                    }
+                    else
+                    {
+                        strings.push_back(reader.readString());
+                    }
+                });
+            reader.expectEnd();
+
+            NETHER_CHECK(runner, strings.size() == 2u && strings[0u] == "\\\"\xC3\xA9" && strings[1u] == std::string(padding % 7u, 'a') + "\\");
+            NETHER_CHECK(runner, number == 12345678u);
+        }
+
+        // A string longer than a window, which has no tokens, then an array that spans the next windows.
+        std::string json = std::format("[\"{}\",[", std::string(JsonTokenizer::WINDOW_SIZE + 100u, 'x'));
+        for (const uint32_t i : std::views::iota(0u, 40000u))
+        {
+            json += std::format("{}{}", i == 0u ? "" : ",", i);
+        }
+
+        json += "]]";
+
+        NETHER_CHECK(runner, tokenize(json) == tokenizeReference(json));
+
+        JsonReader reader(json);
+        std::string string{};
+        uint64_t sum{};
+
+        reader.readArray(
+            [&]()
+            {
+                if (string.empty())
+                {
+                    string = reader.readString();
+                }
+                else
+                {
+                    reader.readArray([&]() { sum += reader.readUnsigned(); });
+                }
+            });
+        reader.expectEnd();
+
+        NETHER_CHECK(runner, string.size() == JsonTokenizer::WINDOW_SIZE + 100u);
+        NETHER_CHECK(runner, sum == uint64_t{39999u} * 40000u / 2u);
+    }
+
+    static void testMalformed(TestRunner& runner)
+    {
+        const auto skip = [](const std::string_view json)
+        {
+            JsonReader reader(json);
+            reader.skipValue();
+            reader.expectEnd();
+        };
+
+        // Found by the tokenizer.
+        NETHER_CHECK_THROWS(runner, skip("[\"abc]"), "unterminated string");
+        NETHER_CHECK_THROWS(runner, skip("[\"a\nb\"]"), "control character in string");
+        NETHER_CHECK_THROWS(runner, skip("[\"a\\xb\"]"), "invalid escape sequence");
+        NETHER_CHECK_THROWS(runner, skip("[\"\\u12G4\"]"), "invalid escape sequence");
+        NETHER_CHECK_THROWS(runner, skip("[\"\\u12\"]"), "invalid escape sequence");
+        NETHER_CHECK_THROWS(runner, skip("[1]\\"), "invalid escape sequence");
+
+        // A backslash that ends the JSON, and the last block of it, escapes nothing.
+        NETHER_CHECK_THROWS(runner, skip(std::string(JsonTokenizer::BLOCK_SIZE - 1u, ' ') + "\\"), "invalid escape sequence");
+        NETHER_CHECK_THROWS(runner, skip("\"" + std::string(JsonTokenizer::BLOCK_SIZE - 2u, 'a') + "\\"), "Malformed JSON");
+
+        // Found by the reader.
+        NETHER_CHECK_THROWS(runner, skip(""), "unexpected end of file");
+        NETHER_CHECK_THROWS(runner, skip("{\"a\":[1,2"), "unexpected end of file");
+        NETHER_CHECK_THROWS(runner, skip("{\"a\" 1}"), "expected ':'");
+        NETHER_CHECK_THROWS(runner, skip("{\"a\":1,}"), "expected a string");
+        NETHER_CHECK_THROWS(runner, skip("{1:2}"), "expected a string");
+        NETHER_CHECK_THROWS(runner, skip("[1 2]"), "expected ']'");
+        NETHER_CHECK_THROWS(runner, skip("[1,]"), "expected a number or a literal");
+        NETHER_CHECK_THROWS(runner, skip("[\"a\"b]"), "expected ']'");
+        NETHER_CHECK_THROWS(runner, skip("{} {}"), "unexpected characters after the top level value");
+
+        for (const std::string_view scalar : {"01", "-", "1.", ".5", "1e", "+1", "0x10", "tru", "nul", "True", "1.5.2"})
+        {
+            NETHER_CHECK_THROWS(runner, skip(std::format("[{}]", scalar)), "invalid number or literal");
+        }
+
+        const std::string deepJson = std::string(1000u, '[') + std::string(1000u, ']');
+        NETHER_CHECK_THROWS(runner, skip(deepJson), "nesting too deep");
+
+        const auto readUnsigned = [](const std::string_view json) { return JsonReader(json).readUnsigned(); };
+        const auto readIndex = [](const std::string_view json) { return JsonReader(json).readIndex(); };
+
+        for (const std::string_view number : {"-1", "1.5", "01", "1e3", "18446744073709551616", "true"})
+        {
+            NETHER_CHECK_THROWS(runner, readUnsigned(number), "expected an unsigned integer");
+        }
+
+        NETHER_CHECK(runner, readUnsigned("18446744073709551615") == std::numeric_limits<uint64_t>::max());
+        NETHER_CHECK(runner, readIndex("4294967294") == 4294967294u);
+        NETHER_CHECK_THROWS(runner, readIndex("4294967295"), "index out of range");
+
+        NETHER_CHECK_THROWS(runner, JsonReader("12").readRawString(), "expected a string");
+        NETHER_CHECK_THROWS(runner, JsonReader("[]").readObject([](std::string_view) {}), "expected '{'");
+
+        // Every prefix of a document is malformed, and fails without reading past its end.
+        const std::string_view json = R"({"asset":{"version":"2.0"},"nodes":[{"mesh":0,"name":"a\"b\u00e9"}],"scale":[1.5,-2e3,true,null]})";
+        NETHER_CHECK(runner, isValidJson(json));
+
+        for (const size_t size : std::views::iota(size_t{0u}, json.size()))
+        {
+            NETHER_CHECK(runner, !isValidJson(json.substr(0u, size)));
+        }
+    }
+
+    void runJsonReaderTests(TestRunner& runner)
+    {
+        runner.run("JsonReader/tokenizerReference", [&]() { testTokenizerReference(runner); });
+        runner.run("JsonReader/classifyLanes", [&]() { testClassifyLanes(runner); });
+        runner.run("JsonReader/strings", [&]() { testStrings(runner); });
+        runner.run("JsonReader/boundaries", [&]() { testBoundaries(runner); });
+        runner.run("JsonReader/malformed", [&]() { testMalformed(runner); });
+    }
+}
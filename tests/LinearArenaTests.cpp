@@ -0,0 +1,231 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "AllocationTracker.hpp"
+#include "FramePacket.hpp"
+#include "LinearArena.hpp"
+
+namespace nether::Test
+{
+    static bool isAligned(const void* const pointer, const size_t alignment) { return reinterpret_cast<uintptr_t>(pointer) % alignment == 0u; }
+
+    // Allocations made by function. Only counted when allocation tracking is enabled, 0 otherwise.
+    template <typename Function> static uint64_t countAllocations(Function&& function)
+    {
+        const uint64_t allocationCount = AllocationTracker::getTotalAllocationCount();
+        function();
+
+        return AllocationTracker::getTotalAllocationCount() - allocationCount;
+    }
+
+    static void testAllocate(TestRunner& runner)
+    {
+        LinearArena arena(256u);
+
+        // Allocations are aligned and do not overlap, also past the alignment of the block itself.
+        std::byte* const first = static_cast<std::byte*>(arena.allocate(3u, 1u));
+        std::byte* const second = static_cast<std::byte*>(arena.allocate(8u, 8u));
+        std::byte* const third = static_cast<std::byte*>(arena.allocate(16u, 128u));
+
+        NETHER_CHECK(runner, isAligned(second, 8u) && isAligned(third, 128u));
+        NETHER_CHECK(runner, second >= first + 3u && third >= second + 8u);
+        NETHER_CHECK(runner, arena.getUsedSize() >= 3u + 8u + 16u);
+
+        const std::span<uint64_t> values = arena.allocateArray<uint64_t>(4u);
+        NETHER_CHECK(runner, values.size() == 4u && isAligned(values.data(), alignof(uint64_t)));
+
+        // Freed all at once, and the same memory is handed out again.
+        arena.reset();
+        NETHER_CHECK(runner, arena.getUsedSize() == 0u);
+        NETHER_CHECK(runner, arena.allocate(3u, 1u) == first);
+    }
+
+    static void testOverflow(TestRunner& runner)
+    {
+        LinearArena arena(64u);
+
+        // Larger than the first block, so blocks are chained. The memory written before the overflow stays valid.
+        std::vector<std::span<uint32_t>> arrays{};
+        for (const uint32_t i : std::views::iota(0u, 10u))
+        {
+            arrays.push_back(arena.allocateArray<uint32_t>(16u));
+            std::ranges::fill(arrays.back(), i);
+        }
+
+        NETHER_CHECK(runner, arena.getCapacity() > 64u);
+        for (const uint32_t i : std::views::iota(0u, 10u))
+        {
+            NETHER_CHECK(runner, std::ranges::all_of(arrays[i], [&](const uint32_t value) { return value == i; }));
+        }
+
+        // A single allocation larger than any block.
+        NETHER_CHECK(runner, arena.allocateArray<std::byte>(4096u).size() == 4096u);
+
+        // The reset merges the blocks into one that fits the high watermark, so the same frame fits without chaining (and without allocating).
+        const size_t highWatermark = arena.getHighWatermark();
+        arena.reset();
+        NETHER_CHECK(runner, arena.getCapacity() >= highWatermark);
+
+        const size_t capacity = arena.getCapacity();
+        const uint64_t allocationCount = countAllocations(
+            [&]()
+            {
+                for ([[maybe_unused]] const uint32_t frame : std::views::iota(0u, 3u))
+                {
+                    for ([[maybe_unused]] const uint32_t i : std::views::iota(0u, 10u))
+                    {
+                        [[maybe_unused]] const std::span<uint32_t> array = arena.allocateArray<uint32_t>(16u);
+                    }
+
+                    [[maybe_unused]] const std::span<std::byte> bytes = arena.allocateArray<std::byte>(4096u);
+                    arena.reset();
+                }
+            });
+
+        NETHER_CHECK(runner, allocationCount == 0u);
+        NETHER_CHECK(runner, arena.getCapacity() == capacity);
+    }
+
+    static void testRewind(TestRunner& runner)
+    {
+        LinearArena arena(64u);
+
+        [[maybe_unused]] const void* const kept = arena.allocate(16u);
+        const LinearArena::Marker marker = arena.getMarker();
+        const size_t usedSize = arena.getUsedSize();
+
+        // Overflows into a new block, which is reused after the rewind rather than chaining another one.
+        [[maybe_unused]] const void* const temporary = arena.allocate(32u);
+        const void* const overflowed = arena.allocate(128u);
+        const size_t capacity = arena.getCapacity();
+
+        arena.rewind(marker);
+        NETHER_CHECK(runner, arena.getUsedSize() == usedSize);
+
+        [[maybe_unused]] const void* const reusedTemporary = arena.allocate(32u);
+        NETHER_CHECK(runner, arena.allocate(128u) == overflowed);
+        NETHER_CHECK(runner, arena.getCapacity() == capacity);
+
+        // Reserving while in use only takes effect on the next reset.
+        arena.reserve(4096u);
+        NETHER_CHECK(runner, arena.getCapacity() == capacity);
+
+        arena.reset();
+        NETHER_CHECK(runner, arena.getCapacity() >= 4096u);
+    }
+
+    static void testScratchScope(TestRunner& runner)
+    {
+        LinearArena& scratchArena = getScratchArena();
+        NETHER_CHECK(runner, scratchArena.getUsedSize() == 0u);
+
+        {
+            ScratchScope outerScope{};
+            [[maybe_unused]] const std::span<uint32_t> outer = outerScope.getArena().allocateArray<uint32_t>(64u);
+            const size_t outerUsedSize = scratchArena.getUsedSize();
+
+            {
+                // Containers allocate from the arena, and deallocating does nothing.
+                ScratchScope innerScope{};
+                ArenaVector<uint32_t> values{ArenaAllocator<uint32_t>(innerScope.getArena())};
+                values.reserve(256u);
+                values.assign(256u, 7u);
+
+                NETHER_CHECK(runner, scratchArena.getUsedSize() >= outerUsedSize + 256u * sizeof(uint32_t));
+            }
+
+            // Leaving the inner scope only frees what was allocated in it.
+            NETHER_CHECK(runner, scratchArena.getUsedSize() == outerUsedSize);
+        }
+
+        NETHER_CHECK(runner, scratchArena.getUsedSize() == 0u);
+
+        // Every thread has its own scratch arena.
+        const LinearArena* otherThreadScratchArena{};
+        std::jthread([&]() { otherThreadScratchArena = &getScratchArena(); }).join();
+
+        NETHER_CHECK(runner, otherThreadScratchArena != &scratchArena);
+    }
+
+    // A packet arena reserved for the largest frame does not allocate while writing a frame of that size.
+    static void testFramePacketReserve(TestRunner& runner)
+    {
+        constexpr uint32_t instanceCount = 1000u;
+
+        FramePacket framePacket{};
+        framePacket.arena.reserve(getFramePacketArenaSize(instanceCount));
+
+        const uint64_t allocationCount = countAllocations(
+            [&]()
+            {
+                framePacket.arena.reset();
+                framePacket.draws = framePacket.arena.allocateArray<InstancedDraw>(instanceCount);
+                framePacket.instances = framePacket.arena.allocateArray<InstanceData>(instanceCount);
+            });
+
+        NETHER_CHECK(runner, allocationCount == 0u);
+    }
+
+    static void testAllocationTracker(TestRunner& runner)
+    {
+        if constexpr (!NETHER_ALLOCATION_TRACKING_MODE)
+        {
+            return;
+        }
+
+        const uint32_t subsystemIndex = AllocationTracker::getSubsystemIndex("Test subsystem");
+        NETHER_CHECK(runner, subsystemIndex != AllocationTracker::UNTRACKED_SUBSYSTEM_INDEX);
+        NETHER_CHECK(runner, AllocationTracker::getSubsystemIndex("Test subsystem") == subsystemIndex);
+
+        // Also clears what the other tests allocated.
+        AllocationTracker::FrameAllocations frameAllocations{};
+        AllocationTracker::collectFrame(frameAllocations);
+
+        // Calls operator new directly, as the compiler may leave out a new expression whose memory is never used.
+        const auto allocate = [](const size_t size)
+        {
+            void* const memory = ::operator new(size);
+            ::operator delete(memory);
+            return memory != nullptr;
+        };
+
+        // Counted per subsystem, but only a violation in steady state.
+        {
+            const AllocationTracker::SubsystemScope scope(subsystemIndex);
+            NETHER_CHECK(runner, allocate(100u));
+        }
+
+        AllocationTracker::collectFrame(frameAllocations);
+        NETHER_CHECK(runner, frameAllocations.subsystems[subsystemIndex].allocationCount == 1u);
+        NETHER_CHECK(runner, frameAllocations.subsystems[subsystemIndex].allocatedBytes >= 100u);
+        NETHER_CHECK(runner, frameAllocations.getViolationCount() == 0u);
+
+        AllocationTracker::setSteadyState(true);
+        {
+            const AllocationTracker::SubsystemScope scope(subsystemIndex);
+            NETHER_CHECK(runner, allocate(100u));
+
+            // The innermost scope wins, and allocations outside of any subsystem are never violations.
+            const AllocationTracker::SubsystemScope untrackedScope(AllocationTracker::UNTRACKED_SUBSYSTEM_INDEX);
+            NETHER_CHECK(runner, allocate(100u));
+        }
+        AllocationTracker::setSteadyState(false);
+
+        AllocationTracker::collectFrame(frameAllocations);
+        NETHER_CHECK(runner, frameAllocations.subsystems[subsystemIndex].allocationCount == 1u);
+        NETHER_CHECK(runner, frameAllocations.subsystems[subsystemIndex].violationCount == 1u);
+        NETHER_CHECK(runner, frameAllocations.getViolationCount() == 1u);
+        NETHER_CHECK(runner, frameAllocations.subsystems[AllocationTracker::UNTRACKED_SUBSYSTEM_INDEX].allocationCount >= 1u);
+    }
+
+    void runLinearArenaTests(TestRunner& runner)
+    {
+        runner.run("LinearArena/allocate", [&]() { testAllocate(runner); });
+        runner.run("LinearArena/overflow", [&]() { testOverflow(runner); });
+        runner.run("LinearArena/rewind", [&]() { testRewind(runner); });
+        runner.run("LinearArena/scratchScope", [&]() { testScratchScope(runner); });
+        runner.run("LinearArena/framePacketReserve", [&]() { testFramePacketReserve(runner); });
+        runner.run("LinearArena/allocationTracker", [&]() { testAllocationTracker(runner); });
+    }
+}
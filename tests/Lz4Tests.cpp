@@ -0,0 +1,192 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "Lz4.hpp"
+
+namespace nether::Test
+{
+    static std::vector<std::byte> makeNoise(const size_t size, uint32_t seed)
+    {
+        std::vector<std::byte> data(size);
+        for (std::byte& value : data)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            value = static_cast<std::byte>(seed >> 24u);
+        }
+
+        return data;
+    }
+
+    static std::vector<std::byte> makeText(const uint32_t repeatCount)
+    {
+        static constexpr std::string_view SENTENCE = "The quick brown fox jumps over the lazy dog. ";
+
+        std::vector<std::byte> data{};
+        for ([[maybe_unused]] const uint32_t repeat : std::views::iota(0u, repeatCount))
+        {
+            const std::span<const std::byte> sentence = std::as_bytes(std::span(SENTENCE));
+            data.insert(data.end(), sentence.begin(), sentence.end());
+        }
+
+        return data;
+    }
+
+    template <typename... Bytes> static std::vector<std::byte> makeBlock(const Bytes... bytes) { return {static_cast<std::byte>(bytes)...}; }
+
+    static std::vector<std::byte> decompress(const std::span<const std::byte> compressedData, const size_t size)
+    {
+        std::vector<std::byte> data(size);
+        Lz4::decompress(compressedData, data);
+
+        return data;
+    }
+
+    // The reference decoder (LZ4_decompress_safe) rejects blocks that break the end of block rules, which the decompressor here does not check : the last 5 bytes are
+    // literals, and the last match starts at least 12 bytes before the end.
+    static bool followsEndOfBlockRules(const std::span<const std::byte> compressedData, const size_t size)
+    {
+        const auto readLength = [&](size_t& position, size_t length)
+        {
+            for (std::byte lengthByte{255u}; lengthByte == std::byte{255u}; length += static_cast<size_t>(lengthByte))
+            {
+                lengthByte = compressedData[position++];
+            }
+
+            return length;
+        };
+
+        size_t inputPosition{};
+        size_t outputPosition{};
+        size_t lastMatchPosition{};
+        size_t literalLength{};
+
+        while (inputPosition < compressedData.size())
+        {
+            const uint32_t token = static_cast<uint32_t>(compressedData[inputPosition++]);
+
+            literalLength = token >> 4u == 15u ? readLength(inputPosition, 15u) : token >> 4u;
+            inputPosition += literalLength;
+            outputPosition += literalLength;
+
+            if (inputPosition == compressedData.size())
+            {
+                break;
+            }
+
+            inputPosition += 2u;
+            lastMatchPosition = outputPosition;
+            outputPosition += ((token & 0xfu) == 15u ? readLength(inputPosition, 15u) : token & 0xfu) + 4u;
+        }
+
+        return literalLength >= std::min<size_t>(size, 5u) && (lastMatchPosition == 0u || lastMatchPosition + 12u <= size);
+    }
+
+    // Blocks written by the reference compressor (LZ4_compress_default of lz4 1.9.4) decompress to the data they were made from.
+    static void testReferenceBlocks(TestRunner& runner)
+    {
+        // 300 times 'a' : an overlapping match of offset 1, with a length that continues in 2 bytes.
+        const std::vector<std::byte> runBlock = makeBlock(0x1f, 0x61, 0x01, 0x00, 0xff, 0x14, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61);
+
+        const std::vector<std::byte> textBlock = makeBlock(
+            0xff, 0x1e, 0x54, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69, 0x63, 0x6b, 0x20, 0x62, 0x72, 0x6f, 0x77, 0x6e, 0x20, 0x66, 0x6f, 0x78, 0x20, 0x6a, 0x75, 0x6d, 0x70,
+            0x73, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6c, 0x61, 0x7a, 0x79, 0x20, 0x64, 0x6f, 0x67, 0x2e, 0x20, 0x2d, 0x00, 0x6f, 0x50, 0x64,
+            0x6f, 0x67, 0x2e, 0x20);
+
+        // Incompressible : a single sequence of literals, larger than the data.
+        const std::vector<std::byte> noiseBlock = makeBlock(
+            0xf0, 0x21, 0x3c, 0x5e, 0x81, 0xb4, 0x0c, 0x5e, 0xc6, 0x8e, 0x04, 0xa3, 0x40, 0x6c, 0x97, 0xd6, 0x3c, 0xfb, 0xdc, 0x53, 0xae, 0x88, 0x37, 0x1a, 0x12, 0x51,
+            0x21, 0xb5, 0x95, 0x61, 0x43, 0xc0, 0xee, 0x2d, 0x55, 0xfb, 0x63, 0x8c, 0x77, 0xfe, 0xe0, 0xb6, 0xf5, 0xf9, 0x27, 0x5f, 0xaf, 0x29, 0x7e, 0x2c);
+
+        // 64 bytes of noise twice, then the text.
+        const std::vector<std::byte> mixedBlock = makeBlock(
+            0xff, 0x31, 0x3d, 0xe9, 0x9c, 0xed, 0x0c, 0xdb, 0x5c, 0x0d, 0x11, 0xfb, 0xf9, 0x88, 0x73, 0x8c, 0x9a, 0xc7, 0xc7, 0x6b, 0x79, 0xda, 0x5c, 0x7b, 0x17, 0xbf,
+            0xd5, 0x5b, 0x2d, 0xfb, 0x1f, 0x74, 0x74, 0x1b, 0x1d, 0x9f, 0xc5, 0x15, 0x9b, 0xed, 0x44, 0x97, 0x5a, 0x50, 0x83, 0xb6, 0x4f, 0x28, 0xdf, 0xa0, 0x61, 0xff,
+            0x7c, 0x2d, 0x40, 0xeb, 0x96, 0x7e, 0x2c, 0x6f, 0x2d, 0x00, 0xb1, 0xc2, 0x25, 0x8b, 0x40, 0x00, 0x2d, 0xff, 0x1e, 0x54, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69,
+            0x63, 0x6b, 0x20, 0x62, 0x72, 0x6f, 0x77, 0x6e, 0x20, 0x66, 0x6f, 0x78, 0x20, 0x6a, 0x75, 0x6d, 0x70, 0x73, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x20, 0x74, 0x68,
+            0x65, 0x20, 0x6c, 0x61, 0x7a, 0x79, 0x20, 0x64, 0x6f, 0x67, 0x2e, 0x20, 0x2d, 0x00, 0x6f, 0x50, 0x64, 0x6f, 0x67, 0x2e, 0x20);
+
+        const std::vector<std::byte> noise = makeNoise(64u, 7u);
+        std::vector<std::byte> mixedData = noise;
+        mixedData.insert(mixedData.end(), noise.begin(), noise.end());
+
+        const std::vector<std::byte> text = makeText(4u);
+        mixedData.insert(mixedData.end(), text.begin(), text.end());
+
+        NETHER_CHECK(runner, decompress(runBlock, 300u) == std::vector<std::byte>(300u, std::byte{'a'}));
+        NETHER_CHECK(runner, decompress(textBlock, text.size()) == text);
+        NETHER_CHECK(runner, decompress(noiseBlock, 48u) == makeNoise(48u, 1u));
+        NETHER_CHECK(runner, decompress(mixedBlock, mixedData.size()) == mixedData);
+    }
+
+    static void testRoundTrip(TestRunner& runner)
+    {
+        std::vector<std::vector<std::byte>> inputs{};
+
+        // Sizes around the end of block rules, where there is no room for a match.
+        for (const size_t size : {0u, 1u, 4u, 5u, 12u, 13u, 16u})
+        {
+            inputs.push_back(std::vector<std::byte>(size, std::byte{'a'}));
+        }
+
+        inputs.push_back(makeNoise(100'000u, 3u));
+        inputs.push_back(makeText(1000u));
+        inputs.push_back(std::vector<std::byte>(100'000u, std::byte{0u}));
+
+        // The repeat is further than the largest offset (65535), so it must not be matched.
+        const std::vector<std::byte> repeat = makeNoise(1000u, 5u);
+        const std::vector<std::byte> gap = makeNoise(70'000u, 6u);
+
+        std::vector<std::byte> farRepeat = repeat;
+        farRepeat.insert(farRepeat.end(), gap.begin(), gap.end());
+        farRepeat.insert(farRepeat.end(), repeat.begin(), repeat.end());
+        inputs.push_back(std::move(farRepeat));
+
+        for (const std::vector<std::byte>& input : inputs)
+        {
+            const std::vector<std::byte> compressedData = Lz4::compress(input);
+
+            NETHER_CHECK(runner, compressedData.empty() == input.empty());
+            NETHER_CHECK(runner, decompress(compressedData, input.size()) == input);
+            NETHER_CHECK(runner, followsEndOfBlockRules(compressedData, input.size()));
+
+            // The bound of LZ4_compressBound.
+            NETHER_CHECK(runner, compressedData.size() <= input.size() + input.size() / 255u + 16u);
+        }
+
+        NETHER_CHECK(runner, Lz4::compress(makeText(1000u)).size() < 1000u);
+        NETHER_CHECK(runner, Lz4::compress(std::vector<std::byte>(100'000u, std::byte{0u})).size() < 1000u);
+    }
+
+    static void testMalformedBlocks(TestRunner& runner)
+    {
+        const std::vector<std::byte> runBlock = makeBlock(0x1f, 0x61, 0x01, 0x00, 0xff, 0x14, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61);
+        std::vector<std::byte> data(300u);
+
+        // Decompresses to more or less than the size of the data.
+        NETHER_CHECK_THROWS(runner, decompress(runBlock, 299u), "Malformed LZ4 block");
+        NETHER_CHECK_THROWS(runner, decompress(runBlock, 301u), "Malformed LZ4 block");
+        NETHER_CHECK_THROWS(runner, decompress({}, 1u), "Malformed LZ4 block");
+
+        // Ends in the middle of the literals, of the offset or of a length.
+        NETHER_CHECK_THROWS(runner, decompress(std::span(runBlock).first(runBlock.size() - 1u), 300u), "Malformed LZ4 block");
+        NETHER_CHECK_THROWS(runner, decompress(std::span(runBlock).first(3u), 300u), "Malformed LZ4 block");
+        NETHER_CHECK_THROWS(runner, decompress(std::span(runBlock).first(5u), 300u), "Malformed LZ4 block");
+        NETHER_CHECK_THROWS(runner, decompress(makeBlock(0xf0, 0xff), 300u), "Malformed LZ4 block");
+
+        // Matches at offset 0, or before the start of the data.
+        NETHER_CHECK_THROWS(runner, decompress(makeBlock(0x1f, 0x61, 0x00, 0x00, 0xff, 0x14, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61), 300u), "Malformed LZ4 block");
+        NETHER_CHECK_THROWS(runner, decompress(makeBlock(0x10, 0x61, 0x02, 0x00, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61), 10u), "Malformed LZ4 block");
+
+        // A failed decompression leaves the data in any state, but never writes past it.
+        NETHER_CHECK_THROWS(runner, Lz4::decompress(runBlock, std::span(data).first(10u)), "Malformed LZ4 block");
+        NETHER_CHECK(runner, std::ranges::all_of(std::span(data).subspan(10u), [](const std::byte value) { return value == std::byte{0u}; }));
+    }
+
+    void runLz4Tests(TestRunner& runner)
+    {
+        runner.run("Lz4/referenceBlocks", [&]() { testReferenceBlocks(runner); });
+        runner.run("Lz4/roundTrip", [&]() { testRoundTrip(runner); });
+        runner.run("Lz4/malformedBlocks", [&]() { testMalformedBlocks(runner); });
+    }
+}
@@ -0,0 +1,58 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+// Usage : NetherTests [--filter <substring>]
+// Run from the repository root, some tests read files from shaders/. Returns the number of failed tests.
+int main(int argc, char** argv)
+{
+    using namespace nether::Test;
+
+    std::string filter{};
+
+    const std::vector<std::string_view> arguments(argv + 1, argv + argc);
+    for (size_t i = 0u; i < arguments.size(); ++i)
+    {
+        const bool hasValue = i + 1u < arguments.size();
+
+        if (arguments[i] == "--filter" && hasValue)
+        {
+            filter = arguments[++i];
+        }
+        else
+        {
+            std::cout << "Usage : NetherTests [--filter <substring>]" << std::endl;
+            return -1;
+        }
+    }
+
+    TestRunner runner(filter);
+
+    runSceneTests(runner);
+    runTransformKernelTests(runner);
+    runDrawListTests(runner);
+    runIndirectCommandsTests(runner);
+    runGraphicsBackendTests(runner);
+    runDescriptorAllocatorTests(runner);
+    runParallelRecorderTests(runner);
+    runRenderGraphTests(runner);
+    runShaderCacheTests(runner);
+    runShaderCompilerTests(runner);
+    runFileWatcherTests(runner);
+    runShaderDependencyGraphTests(runner);
+    runRootConstantLayoutTests(runner);
+    runTripleBufferTests(runner);
+    runProfilerTests(runner);
+    runJobSystemTests(runner);
+    runLinearArenaTests(runner);
+    runAssetRegistryTests(runner);
+    runLz4Tests(runner);
+    runAssetArchiveTests(runner);
+    runJsonReaderTests(runner);
+    runGltfImporterTests(runner);
+    runAssetPipelineTests(runner);
+
+    std::cout << std::format("{} of {} tests passed\n", runner.getTestCount() - runner.getFailedTestCount(), runner.getTestCount());
+
+    return static_cast<int>(runner.getFailedTestCount());
+}
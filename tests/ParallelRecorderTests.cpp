@@ -0,0 +1,98 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "ParallelRecorder.hpp"
+
+namespace nether::Test
+{
+    static void testSplitIntoChunks(TestRunner& runner)
+    {
+        std::vector<RecordingChunk> chunks{};
+
+        for (const uint32_t itemCount : {0u, 1u, 15u, 16u, 100u, 1000u})
+        {
+            for (const uint32_t maxChunkCount : {1u, 3u, 8u, 64u})
+            {
+                splitIntoChunks(itemCount, maxChunkCount, 16u, chunks);
+
+                NETHER_CHECK(runner, !chunks.empty());
+                NETHER_CHECK(runner, chunks.size() <= maxChunkCount);
+
+                // In item order, without gaps, and near equal in size.
+                uint32_t nextItem{};
+                for (const RecordingChunk& chunk : chunks)
+                {
+                    NETHER_CHECK(runner, chunk.firstItem == nextItem);
+                    NETHER_CHECK(runner, chunk.itemCount + 1u >= chunks.front().itemCount);
+                    nextItem += chunk.itemCount;
+                }
+
+                NETHER_CHECK(runner, nextItem == itemCount);
+
+                if (chunks.size() > 1u)
+                {
+                    NETHER_CHECK(runner, chunks.back().itemCount >= 16u);
+                }
+            }
+        }
+    }
+
+    static void testRecord(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+        ParallelRecorder parallelRecorder(jobSystem);
+
+        NETHER_CHECK(runner, parallelRecorder.getThreadCount() == 4u);
+
+        std::vector<RecordingChunk> chunks{};
+        splitIntoChunks(1000u, 8u, 1u, chunks);
+
+        // Every chunk is recorded exactly once, whichever thread picks it up. Repeated so that the workers are asleep for some of the calls and awake for others.
+        std::vector<std::atomic<uint32_t>> recordCounts(chunks.size());
+        for ([[maybe_unused]] const uint32_t iteration : std::views::iota(0u, 100u))
+        {
+            parallelRecorder.record(chunks,
+                                    [&](const uint32_t chunkIndex, const RecordingChunk& chunk)
+                                    {
+                                        if (chunk.firstItem == chunks[chunkIndex].firstItem)
+                                        {
+                                            recordCounts[chunkIndex].fetch_add(1u, std::memory_order_relaxed);
+                                        }
+                                    });
+        }
+
+        NETHER_CHECK(runner, std::ranges::all_of(recordCounts, [](const std::atomic<uint32_t>& recordCount) { return recordCount.load() == 100u; }));
+    }
+
+    static void testRecordException(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+        ParallelRecorder parallelRecorder(jobSystem);
+
+        std::vector<RecordingChunk> chunks{};
+        splitIntoChunks(64u, 8u, 1u, chunks);
+
+        const auto recordChunk = [](const uint32_t chunkIndex, const RecordingChunk&)
+        {
+            if (chunkIndex == 5u)
+            {
+                fatalError("Chunk 5 failed to record.");
+            }
+        };
+
+        NETHER_CHECK_THROWS(runner, parallelRecorder.record(chunks, recordChunk), "Chunk 5");
+
+        // The recorder is still usable afterwards.
+        std::atomic<uint32_t> recordedChunkCount{};
+        parallelRecorder.record(chunks, [&](const uint32_t, const RecordingChunk&) { recordedChunkCount.fetch_add(1u, std::memory_order_relaxed); });
+        NETHER_CHECK(runner, recordedChunkCount.load() == chunks.size());
+    }
+
+    void runParallelRecorderTests(TestRunner& runner)
+    {
+        runner.run("ParallelRecorder/splitIntoChunks", [&]() { testSplitIntoChunks(runner); });
+        runner.run("ParallelRecorder/record", [&]() { testRecord(runner); });
+        runner.run("ParallelRecorder/recordException", [&]() { testRecordException(runner); });
+    }
+}
@@ -0,0 +1,326 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "JsonReader.hpp"
+#include "Profiler.hpp"
+
+// The profiler's state is global : frames are only marked by these tests, and each test records its zones on threads of its own. The concurrent test is meant to be run
+// under ThreadSanitizer as well (premake5 gmake2 --sanitize=thread).
+namespace nether::Test
+{
+    using namespace Profiler;
+
+    // Zones of the thread with that name, in the order of the capture.
+    static std::vector<ProfileZone> getThreadZones(const ProfileCapture& capture, const std::string_view threadName)
+    {
+        const auto foundName = std::ranges::find(capture.threadNames, threadName);
+        if (foundName == capture.threadNames.end())
+        {
+            return {};
+        }
+
+        const uint32_t threadIndex = static_cast<uint32_t>(foundName - capture.threadNames.begin());
+
+        std::vector<ProfileZone> zones{};
+        std::ranges::copy_if(capture.zones, std::back_inserter(zones), [&](const ProfileZone& zone) { return zone.threadIndex == threadIndex; });
+
+        return zones;
+    }
+
+    // Waits until the timestamps pass the given one, so the frame marked next ends after the zones recorded with earlier timestamps.
+    static void waitForTimestamp(const int64_t timestamp)
+    {
+        while (getTimestamp() <= timestamp)
+        {
+        }
+    }
+
+    // Runs first, before any frame is marked.
+    static void testCollectRecentFrames(TestRunner& runner)
+    {
+        ProfileCapture capture{};
+        capture.zones.push_back(ProfileZone{});
+
+        NETHER_CHECK(runner, !collectRecentFrames(1u, capture));
+        NETHER_CHECK(runner, capture.zones.empty() && capture.frameBoundaries.empty());
+
+        // The first mark starts a frame, which the second one completes.
+        markFrame();
+        NETHER_CHECK(runner, !collectRecentFrames(1u, capture));
+
+        markFrame();
+        NETHER_CHECK(runner, collectRecentFrames(1u, capture) && capture.frameBoundaries.size() == 2u);
+        NETHER_CHECK(runner, !collectRecentFrames(2u, capture));
+        NETHER_CHECK(runner, !collectRecentFrames(0u, capture));
+
+        // More frames than a capture can hold are marked, and the boundaries of the last ones are kept.
+        for ([[maybe_unused]] const uint32_t frame : std::views::iota(0u, MAX_CAPTURE_FRAME_COUNT + 10u))
+        {
+            markFrame();
+        }
+
+        NETHER_CHECK(runner, collectRecentFrames(MAX_CAPTURE_FRAME_COUNT, capture));
+        NETHER_CHECK(runner, capture.frameBoundaries.size() == MAX_CAPTURE_FRAME_COUNT + 1u && std::ranges::is_sorted(capture.frameBoundaries));
+        NETHER_CHECK(runner, capture.isComplete);
+
+        NETHER_CHECK(runner, !collectRecentFrames(MAX_CAPTURE_FRAME_COUNT + 1u, capture));
+        NETHER_CHECK(runner, capture.frameBoundaries.empty());
+    }
+
+    static void testNesting(TestRunner& runner)
+    {
+        markFrame();
+        const int64_t frameTimestamp = getTimestamp();
+
+        // Recorded when they end, as the scopes do. The first child begins with its parent, and a zone that begins as another one ends is not nested in it.
+        std::jthread([&]()
+                     {
+                         setThreadName("Nesting");
+
+                         recordZone("First child", frameTimestamp + 10, frameTimestamp + 30);
+                         recordZone("Grandchild", frameTimestamp + 35, frameTimestamp + 40);
+                         recordZone("Second child", frameTimestamp + 30, frameTimestamp + 50);
+                         recordZone("Parent", frameTimestamp + 10, frameTimestamp + 60);
+                         recordZone("Sibling", frameTimestamp + 60, frameTimestamp + 70);
+
+                         // Begins long after the frame.
+                         recordZone("After", frameTimestamp + 1'000'000'000'000'000, frameTimestamp + 1'000'000'000'000'001);
+                     })
+            .join();
+
+        waitForTimestamp(frameTimestamp + 70);
+        markFrame();
+
+        ProfileCapture capture{};
+        NETHER_CHECK(runner, collectRecentFrames(1u, capture) && capture.isComplete);
+
+        const std::vector<ProfileZone> zones = getThreadZones(capture, "Nesting");
+
+        const std::array<std::pair<std::string_view, uint32_t>, 5u> expectedZones = {{
+            {"Parent", 0u},
+            {"First child", 1u},
+            {"Second child", 1u},
+            {"Grandchild", 2u},
+            {"Sibling", 0u},
+        }};
+
+        NETHER_CHECK(runner, zones.size() == expectedZones.size());
+        for (const size_t zoneIndex : std::views::iota(size_t{0u}, std::min(zones.size(), expectedZones.size())))
+        {
+            NETHER_CHECK(runner, zones[zoneIndex].name == expectedZones[zoneIndex].first);
+            NETHER_CHECK(runner, zones[zoneIndex].depth == expectedZones[zoneIndex].second);
+        }
+
+        // Converted to nanoseconds inside the frame, keeping equal times equal.
+        if (zones.size() == expectedZones.size())
+        {
+            NETHER_CHECK(runner, zones[0].beginTime == zones[1].beginTime && zones[1].endTime == zones[2].beginTime);
+            NETHER_CHECK(runner, capture.frameBoundaries.front() <= zones[0].beginTime && zones[4].endTime <= capture.frameBoundaries.back());
+        }
+    }
+
+    // A capture is complete as long as every zone of the frames is still in the ring.
+    static void testRingOverwrite(TestRunner& runner)
+    {
+        for (const uint32_t zoneCount : {ZONES_PER_THREAD, ZONES_PER_THREAD + 1u})
+        {
+            const std::string threadName = std::format("Ring {}", zoneCount);
+
+            markFrame();
+            const int64_t frameTimestamp = getTimestamp();
+
+            std::jthread([&]()
+                         {
+                             setThreadName(threadName);
+                             for (const uint32_t zoneIndex : std::views::iota(0u, zoneCount))
+                             {
+                                 recordZone("Zone", frameTimestamp + zoneIndex, frameTimestamp + zoneIndex + 1);
+                             }
+                         })
+                .join();
+
+            waitForTimestamp(frameTimestamp + zoneCount);
+            markFrame();
+
+            ProfileCapture capture{};
+            NETHER_CHECK(runner, collectRecentFrames(1u, capture));
+            NETHER_CHECK(runner, getThreadZones(capture, threadName).size() == ZONES_PER_THREAD);
+            NETHER_CHECK(runner, capture.isComplete == (zoneCount == ZONES_PER_THREAD));
+        }
+    }
+
+    // Threads record nested scopes while frames are marked and collected. Zones are never torn : each one is collected with the name and times it was recorded with.
+    static void testConcurrentCollect(TestRunner& runner)
+    {
+        constexpr uint32_t recorderCount = 4u;
+        constexpr uint32_t captureCount = 200u;
+
+        static constexpr const char* OUTER_ZONE = "Outer";
+        static constexpr const char* INNER_ZONE = "Inner";
+
+        std::atomic<bool> isRecording{true};
+
+        std::vector<std::jthread> recorderThreads{};
+        for (const uint32_t recorderIndex : std::views::iota(0u, recorderCount))
+        {
+            recorderThreads.emplace_back(
+                [&, recorderIndex]()
+                {
+                    setThreadName(std::format("Recorder {}", recorderIndex));
+
+                    while (isRecording.load(std::memory_order_relaxed))
+                    {
+                        const ProfileScope outerScope(OUTER_ZONE);
+                        const ProfileScope innerScope(INNER_ZONE);
+                    }
+                });
+        }
+
+        uint32_t collectedZoneCount{};
+        uint32_t invalidZoneCount{};
+
+        for ([[maybe_unused]] const uint32_t captureIndex : std::views::iota(0u, captureCount))
+        {
+            markFrame();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+            ProfileCapture capture{};
+            NETHER_CHECK(runner, collectRecentFrames(2u, capture));
+
+            for (const uint32_t recorderIndex : std::views::iota(0u, recorderCount))
+            {
+                const std::vector<ProfileZone> zones = getThreadZones(capture, std::format("Recorder {}", recorderIndex));
+                for (const ProfileZone& zone : zones)
+                {
+                    // An inner zone whose outer zone was not recorded yet is not nested in anything.
+                    const bool isValid = (zone.name == OUTER_ZONE && zone.depth == 0u) || (zone.name == INNER_ZONE && zone.depth <= 1u);
+                    invalidZoneCount += isValid && zone.beginTime <= zone.endTime && zone.beginTime <= capture.frameBoundaries.back() &&
+                                                zone.endTime >= capture.frameBoundaries.front()
+                                            ? 0u
+                                            : 1u;
+                }
+
+                collectedZoneCount += static_cast<uint32_t>(zones.size());
+                NETHER_CHECK(runner, std::ranges::is_sorted(zones, {}, &ProfileZone::beginTime));
+            }
+        }
+
+        isRecording.store(false, std::memory_order_relaxed);
+        recorderThreads.clear();
+
+        NETHER_CHECK(runner, collectedZoneCount > 0u);
+        NETHER_CHECK(runner, invalidZoneCount == 0u);
+    }
+
+    // Names with quotes, backslashes and control characters are escaped, so the trace parses back to the same names.
+    static void testChromeTrace(TestRunner& runner)
+    {
+        static constexpr const char* ZONE_NAME = "Zone \"quoted\" \\ \n\t\x01\x1f end";
+
+        ProfileCapture capture{};
+        capture.threadNames = {"Main", "Thread \"with\" \\ \r\n"};
+        capture.frameBoundaries = {1'000'000, 2'000'000, 3'000'000};
+        capture.zones = {
+            ProfileZone{.name = "Frame", .threadIndex = 0u, .beginTime = 1'000'000, .endTime = 2'000'000},
+            ProfileZone{.name = ZONE_NAME, .threadIndex = 1u, .depth = 0u, .beginTime = 1'500'000, .endTime = 2'500'000},
+        };
+
+        std::ostringstream stream{};
+        writeChromeTrace(capture, stream);
+        const std::string trace = stream.str();
+
+        std::vector<std::string> threadNames{};
+        std::vector<std::string> zoneNames{};
+        std::vector<uint64_t> zoneThreadIndices{};
+        uint32_t frameCount{};
+
+        JsonReader reader(trace);
+        reader.readObject(
+            [&](const std::string_view key)
+            {
+                if (key != "traceEvents")
+                {
+                    reader.skipValue();
+                    return;
+                }
+
+                reader.readArray(
+                    [&]()
+                    {
+                        std::string name{};
+                        std::string phase{};
+                        std::string argumentName{};
+                        uint64_t threadIndex{};
+
+                        reader.readObject(
+                            [&](const std::string_view eventKey)
+                            {
+                                if (eventKey == "name")
+                                {
+                                    name = reader.readString();
+                                }
+                                else if (eventKey == "ph")
+                                {
+                                    phase = reader.readString();
+                                }
+                                else if (eventKey == "tid")
+                                {
+                                    threadIndex = reader.readUnsigned();
+                                }
+                                else if (eventKey == "args")
+                                {
+                                    reader.readObject(
+                                        [&](const std::string_view argumentKey)
+                                        {
+                                            if (argumentKey == "name")
+                                            {
+                                                argumentName = reader.readString();
+                                            }
+                                            else
+                                            {
+                                                reader.skipValue();
+                                            }
+                                        });
+                                }
+                                else
+                                {
+                                    reader.skipValue();
+                                }
+                            });
+
+                        if (phase == "M")
+                        {
+                            threadNames.push_back(argumentName);
+                        }
+                        else if (phase == "i")
+                        {
+                            frameCount++;
+                        }
+                        else if (phase == "X")
+                        {
+                            zoneNames.push_back(name);
+                            zoneThreadIndices.push_back(threadIndex);
+                        }
+                    });
+            });
+        reader.expectEnd();
+
+        NETHER_CHECK(runner, threadNames == capture.threadNames);
+        NETHER_CHECK(runner, frameCount == capture.frameBoundaries.size());
+        NETHER_CHECK(runner, zoneNames == std::vector<std::string>({"Frame", ZONE_NAME}));
+        NETHER_CHECK(runner, zoneThreadIndices == std::vector<uint64_t>({0u, 1u}));
+
+        // No raw control characters are left in the trace.
+        NETHER_CHECK(runner, std::ranges::none_of(trace, [](const char character) { return static_cast<uint8_t>(character) < 0x20u && character != '\n'; }));
+    }
+
+    void runProfilerTests(TestRunner& runner)
+    {
+        runner.run("Profiler/collectRecentFrames", [&]() { testCollectRecentFrames(runner); });
+        runner.run("Profiler/nesting", [&]() { testNesting(runner); });
+        runner.run("Profiler/ringOverwrite", [&]() { testRingOverwrite(runner); });
+        runner.run("Profiler/concurrentCollect", [&]() { testConcurrentCollect(runner); });
+        runner.run("Profiler/chromeTrace", [&]() { testChromeTrace(runner); });
+    }
+}
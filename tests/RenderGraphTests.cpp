@@ -0,0 +1,395 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "RenderGraph.hpp"
+
+namespace nether::Test
+{
+    // A render graph, along with the accesses and states the test declared, so that the compiled barriers can be checked against them.
+    struct RenderGraphBuilder
+    {
+        struct Access
+        {
+            RenderGraphResource resource{};
+            ResourceState state{};
+        };
+
+        RenderGraph renderGraph{};
+
+        // Indexed by RenderGraphPass / RenderGraphResource.
+        std::vector<std::vector<Access>> passAccesses{};
+        std::vector<std::pair<ResourceState, ResourceState>> importedStates{};
+
+        RenderGraphResource importResource(const ResourceState initialState, const ResourceState finalState)
+        {
+            importedStates.emplace_back(initialState, finalState);
+            return renderGraph.importResource("Imported", initialState, finalState);
+        }
+
+        RenderGraphResource createTransientResource(const uint64_t sizeInBytes)
+        {
+            importedStates.emplace_back(ResourceState::Common, ResourceState::Common);
+            return renderGraph.createTransientResource("Transient", sizeInBytes, 256u);
+        }
+
+        RenderGraphPass addPass(const QueueType queue = QueueType::Graphics, const bool hasSideEffects = false)
+        {
+            passAccesses.emplace_back();
+            return renderGraph.addPass("Pass", queue, hasSideEffects);
+        }
+
+        void read(const RenderGraphPass pass, const RenderGraphResource resource, const ResourceState state)
+        {
+            passAccesses[pass.index].push_back(Access{resource, state});
+            renderGraph.read(pass, resource, state);
+        }
+
+        void write(const RenderGraphPass pass, const RenderGraphResource resource, const ResourceState state)
+        {
+            passAccesses[pass.index].push_back(Access{resource, state});
+            renderGraph.write(pass, resource, state);
+        }
+
+        uint32_t getCompiledPassIndex(const RenderGraphPass pass) const { return renderGraph.getCompiledPassIndex(pass); }
+    };
+
+    // Executes the compiled graph twice in a row (as consecutive frames do), tracking the state of every resource through the barriers. Every pass must find its
+    // resources in the state it declared, the compute queue must only get transitions it supports, and the resources must end up in their final state.
+    static void checkResourceStates(TestRunner& runner, const RenderGraphBuilder& builder)
+    {
+        const RenderGraph& renderGraph = builder.renderGraph;
+        const size_t resourceCount = builder.importedStates.size();
+
+        const auto isImported = [&](const size_t resourceIndex) { return builder.importedStates[resourceIndex].first != ResourceState::Common; };
+        const auto getFinalState = [&](const size_t resourceIndex)
+        {
+            const RenderGraphResource resource{static_cast<uint32_t>(resourceIndex)};
+            return isImported(resourceIndex) ? builder.importedStates[resourceIndex].second : renderGraph.getTransientInitialState(resource);
+        };
+
+        std::vector<ResourceState> states(resourceCount);
+        for (const size_t resourceIndex : std::views::iota(0u, resourceCount))
+        {
+            const RenderGraphResource resource{static_cast<uint32_t>(resourceIndex)};
+            states[resourceIndex] = isImported(resourceIndex) ? builder.importedStates[resourceIndex].first : renderGraph.getTransientInitialState(resource);
+        }
+
+        // Resources between the begin and the end of a split transition.
+        std::vector<bool> isInSplitTransition(resourceCount);
+
+        const auto applyBarriers = [&](const CompiledPass& compiledPass, const std::span<const RenderGraphBarrier> barriers)
+        {
+            for (const RenderGraphBarrier& barrier : barriers | std::views::filter([](const RenderGraphBarrier& b) { return b.type == BarrierType::Transition; }))
+            {
+                const uint32_t resourceIndex = barrier.resource.index;
+
+                NETHER_CHECK(runner, compiledPass.queue == QueueType::Graphics ||
+                                         ((barrier.stateBefore | barrier.stateAfter) & GRAPHICS_QUEUE_RESOURCE_STATES) == ResourceState::Common);
+                NETHER_CHECK(runner, isInSplitTransition[resourceIndex] == (barrier.split == BarrierSplit::End));
+
+                if (barrier.split != BarrierSplit::End)
+                {
+                    NETHER_CHECK(runner, states[resourceIndex] == barrier.stateBefore);
+                }
+
+                isInSplitTransition[resourceIndex] = barrier.split == BarrierSplit::Begin;
+                states[resourceIndex] = barrier.stateAfter;
+            }
+        };
+
+        for ([[maybe_unused]] const uint32_t frame : std::views::iota(0u, 2u))
+        {
+            for (const CompiledPass& compiledPass : renderGraph.getCompiledPasses())
+            {
+                applyBarriers(compiledPass, renderGraph.getBarriersBefore(compiledPass));
+
+                for (const RenderGraphBuilder::Access& access : builder.passAccesses[compiledPass.pass.index])
+                {
+                    const ResourceState state = states[access.resource.index];
+                    NETHER_CHECK(runner, !isInSplitTransition[access.resource.index]);
+                    NETHER_CHECK(runner, state == access.state || ((state & READ_ONLY_RESOURCE_STATES) == state && (state & access.state) == access.state));
+                }
+
+                applyBarriers(compiledPass, renderGraph.getBarriersAfter(compiledPass));
+            }
+
+            for (const size_t resourceIndex : std::views::iota(0u, resourceCount))
+            {
+                NETHER_CHECK(runner, !isInSplitTransition[resourceIndex]);
+                NETHER_CHECK(runner, states[resourceIndex] == getFinalState(resourceIndex) || !renderGraph.isAllocated(RenderGraphResource{static_cast<uint32_t>(resourceIndex)}));
+            }
+        }
+    }
+
+    static bool hasQueueSync(const RenderGraph& renderGraph, const uint32_t signalPass, const uint32_t waitPass)
+    {
+        return std::ranges::any_of(renderGraph.getQueueSyncs(),
+                                   [&](const QueueSync& queueSync) { return queueSync.signalPass == signalPass && queueSync.waitPass == waitPass; });
+    }
+
+    static void testCullAndSort(TestRunner& runner)
+    {
+        RenderGraphBuilder builder{};
+        const RenderGraphResource backBuffer = builder.importResource(ResourceState::Present, ResourceState::Present);
+        const RenderGraphResource gBuffer = builder.createTransientResource(1024u);
+        const RenderGraphResource unused = builder.createTransientResource(1024u);
+        const RenderGraphResource readback = builder.createTransientResource(1024u);
+
+        const RenderGraphPass gBufferPass = builder.addPass();
+        builder.write(gBufferPass, gBuffer, ResourceState::RenderTarget);
+
+        // Writes a resource that nothing reads.
+        const RenderGraphPass unusedPass = builder.addPass();
+        builder.read(unusedPass, gBuffer, ResourceState::ShaderResource);
+        builder.write(unusedPass, unused, ResourceState::RenderTarget);
+
+        // Kept alive by its side effects.
+        const RenderGraphPass readbackPass = builder.addPass(QueueType::Graphics, true);
+        builder.write(readbackPass, readback, ResourceState::CopyDest);
+
+        const RenderGraphPass lightingPass = builder.addPass();
+        builder.read(lightingPass, gBuffer, ResourceState::ShaderResource);
+        builder.write(lightingPass, backBuffer, ResourceState::RenderTarget);
+
+        builder.renderGraph.compile();
+
+        NETHER_CHECK(runner, builder.renderGraph.isCulled(unusedPass));
+        NETHER_CHECK(runner, !builder.renderGraph.isAllocated(unused));
+
+        // The surviving passes run in submission order.
+        const std::span<const CompiledPass> compiledPasses = builder.renderGraph.getCompiledPasses();
+        NETHER_CHECK(runner, compiledPasses.size() == 3u);
+        NETHER_CHECK(runner, compiledPasses[0].pass == gBufferPass && compiledPasses[1].pass == readbackPass && compiledPasses[2].pass == lightingPass);
+
+        checkResourceStates(runner, builder);
+    }
+
+    static void testTransientAliasing(TestRunner& runner)
+    {
+        RenderGraphBuilder builder{};
+        const RenderGraphResource backBuffer = builder.importResource(ResourceState::Present, ResourceState::Present);
+        const RenderGraphResource a = builder.createTransientResource(4096u);
+        const RenderGraphResource b = builder.createTransientResource(2048u);
+        const RenderGraphResource c = builder.createTransientResource(4096u);
+
+        // a and b are alive at the same time, c only once a is done.
+        const RenderGraphPass passA = builder.addPass();
+        builder.write(passA, a, ResourceState::RenderTarget);
+
+        const RenderGraphPass passB = builder.addPass();
+        builder.read(passB, a, ResourceState::ShaderResource);
+        builder.write(passB, b, ResourceState::RenderTarget);
+
+        const RenderGraphPass passC = builder.addPass();
+        builder.read(passC, b, ResourceState::ShaderResource);
+        builder.write(passC, c, ResourceState::UnorderedAccess);
+
+        const RenderGraphPass presentPass = builder.addPass();
+        builder.read(presentPass, c, ResourceState::ShaderResource);
+        builder.write(presentPass, backBuffer, ResourceState::RenderTarget);
+
+        builder.renderGraph.compile();
+
+        const RenderGraph& renderGraph = builder.renderGraph;
+        NETHER_CHECK(runner, renderGraph.getTransientOffset(a) == renderGraph.getTransientOffset(c));
+        NETHER_CHECK(runner, renderGraph.getTransientOffset(b) >= 4096u);
+        NETHER_CHECK(runner, renderGraph.getTransientHeapSize() == 4096u + 2048u);
+
+        // c takes over the memory of a, and the next frame a takes it back from c.
+        const auto hasAliasingBarrier = [&](const RenderGraphPass pass, const RenderGraphResource resource, const RenderGraphResource aliasedResource)
+        {
+            const CompiledPass& compiledPass = renderGraph.getCompiledPasses()[renderGraph.getCompiledPassIndex(pass)];
+            return std::ranges::any_of(renderGraph.getBarriersBefore(compiledPass),
+                                       [&](const RenderGraphBarrier& barrier)
+                                       { return barrier.type == BarrierType::Aliasing && barrier.resource == resource && barrier.aliasedResource == aliasedResource; });
+        };
+
+        NETHER_CHECK(runner, hasAliasingBarrier(passC, c, a));
+        NETHER_CHECK(runner, hasAliasingBarrier(passA, a, c));
+        NETHER_CHECK(runner, !std::ranges::any_of(renderGraph.getBarriers(), [&](const RenderGraphBarrier& barrier) { return barrier.resource == b && barrier.type == BarrierType::Aliasing; }));
+
+        checkResourceStates(runner, builder);
+    }
+
+    static void testBarriers(TestRunner& runner)
+    {
+        RenderGraphBuilder builder{};
+        const RenderGraphResource backBuffer = builder.importResource(ResourceState::Present, ResourceState::Present);
+        const RenderGraphResource shadowMap = builder.createTransientResource(1024u);
+        const RenderGraphResource particles = builder.createTransientResource(1024u);
+
+        const RenderGraphPass shadowPass = builder.addPass();
+        builder.write(shadowPass, shadowMap, ResourceState::DepthWrite);
+
+        // Back to back unordered access. The first pass is only kept alive by its side effects, as the second one does not read the particles.
+        const RenderGraphPass simulatePass = builder.addPass(QueueType::Graphics, true);
+        builder.write(simulatePass, particles, ResourceState::UnorderedAccess);
+
+        const RenderGraphPass compactPass = builder.addPass();
+        builder.write(compactPass, particles, ResourceState::UnorderedAccess);
+
+        const RenderGraphPass forwardPass = builder.addPass();
+        builder.read(forwardPass, shadowMap, ResourceState::ShaderResource);
+        builder.read(forwardPass, particles, ResourceState::ShaderResource);
+        builder.write(forwardPass, backBuffer, ResourceState::RenderTarget);
+
+        builder.renderGraph.compile();
+
+        const RenderGraph& renderGraph = builder.renderGraph;
+        const auto getCompiledPass = [&](const RenderGraphPass pass) -> const CompiledPass& { return renderGraph.getCompiledPasses()[renderGraph.getCompiledPassIndex(pass)]; };
+
+        // The shadow map transition is split around the passes in between, the particles one is not.
+        const std::span<const RenderGraphBarrier> afterShadowPass = renderGraph.getBarriersAfter(getCompiledPass(shadowPass));
+        NETHER_CHECK(runner, std::ranges::any_of(afterShadowPass, [&](const RenderGraphBarrier& barrier) { return barrier.resource == shadowMap && barrier.split == BarrierSplit::Begin; }));
+
+        const std::span<const RenderGraphBarrier> beforeCompactPass = renderGraph.getBarriersBefore(getCompiledPass(compactPass));
+        NETHER_CHECK(runner, beforeCompactPass.size() == 1u && beforeCompactPass[0].type == BarrierType::UnorderedAccess && beforeCompactPass[0].resource == particles);
+
+        const std::span<const RenderGraphBarrier> beforeForwardPass = renderGraph.getBarriersBefore(getCompiledPass(forwardPass));
+        NETHER_CHECK(runner, beforeForwardPass.size() == 3u);
+        NETHER_CHECK(runner, std::ranges::any_of(beforeForwardPass, [&](const RenderGraphBarrier& barrier) { return barrier.resource == shadowMap && barrier.split == BarrierSplit::End; }));
+        NETHER_CHECK(runner, std::ranges::any_of(beforeForwardPass, [&](const RenderGraphBarrier& barrier) { return barrier.resource == backBuffer && barrier.stateAfter == ResourceState::RenderTarget; }));
+
+        // The back buffer goes back to Present, and the transient resources to the state they were created in, after their last use.
+        const std::span<const RenderGraphBarrier> afterForwardPass = renderGraph.getBarriersAfter(getCompiledPass(forwardPass));
+        NETHER_CHECK(runner, afterForwardPass.size() == 3u);
+        NETHER_CHECK(runner, renderGraph.getTransientInitialState(shadowMap) == ResourceState::DepthWrite);
+        NETHER_CHECK(runner, std::ranges::any_of(afterForwardPass, [&](const RenderGraphBarrier& barrier) { return barrier.resource == shadowMap && barrier.stateAfter == ResourceState::DepthWrite; }));
+
+        checkResourceStates(runner, builder);
+    }
+
+    // Transitions between the queues are recorded on the graphics queue, which supports every state.
+    static void testCrossQueueTransitions(TestRunner& runner)
+    {
+        RenderGraphBuilder builder{};
+        const RenderGraphResource backBuffer = builder.importResource(ResourceState::Present, ResourceState::Present);
+        const RenderGraphResource depthBuffer = builder.createTransientResource(1024u);
+        const RenderGraphResource occlusion = builder.createTransientResource(1024u);
+
+        const RenderGraphPass depthPass = builder.addPass();
+        builder.write(depthPass, depthBuffer, ResourceState::DepthWrite);
+
+        const RenderGraphPass occlusionPass = builder.addPass(QueueType::Compute);
+        builder.read(occlusionPass, depthBuffer, ResourceState::ShaderResource);
+        builder.write(occlusionPass, occlusion, ResourceState::UnorderedAccess);
+
+        const RenderGraphPass forwardPass = builder.addPass();
+        builder.read(forwardPass, occlusion, ResourceState::ShaderResource);
+        builder.write(forwardPass, backBuffer, ResourceState::RenderTarget);
+
+        builder.renderGraph.compile();
+
+        const RenderGraph& renderGraph = builder.renderGraph;
+        const uint32_t depthIndex = builder.getCompiledPassIndex(depthPass);
+        const uint32_t occlusionIndex = builder.getCompiledPassIndex(occlusionPass);
+        const uint32_t forwardIndex = builder.getCompiledPassIndex(forwardPass);
+        const std::span<const CompiledPass> compiledPasses = renderGraph.getCompiledPasses();
+
+        // DepthWrite -> ShaderResource after the depth pass, before the graphics queue signals the compute queue.
+        const std::span<const RenderGraphBarrier> afterDepthPass = renderGraph.getBarriersAfter(compiledPasses[depthIndex]);
+        NETHER_CHECK(runner, std::ranges::any_of(afterDepthPass,
+                                                 [&](const RenderGraphBarrier& barrier)
+                                                 {
+                                                     return barrier.resource == depthBuffer && barrier.stateBefore == ResourceState::DepthWrite &&
+                                                            barrier.stateAfter == ResourceState::ShaderResource && barrier.split == BarrierSplit::None;
+                                                 }));
+        NETHER_CHECK(runner, hasQueueSync(renderGraph, depthIndex, occlusionIndex));
+
+        // UnorderedAccess -> ShaderResource before the forward pass, once the graphics queue waited.
+        NETHER_CHECK(runner, renderGraph.getBarriersBefore(compiledPasses[occlusionIndex]).empty());
+        NETHER_CHECK(runner, std::ranges::any_of(renderGraph.getBarriersBefore(compiledPasses[forwardIndex]),
+                                                 [&](const RenderGraphBarrier& barrier) { return barrier.resource == occlusion && barrier.stateAfter == ResourceState::ShaderResource; }));
+        NETHER_CHECK(runner, hasQueueSync(renderGraph, occlusionIndex, forwardIndex));
+
+        // The depth buffer is last used on the compute queue, which cannot transition it back to DepthWrite, so the forward pass does it.
+        NETHER_CHECK(runner, std::ranges::any_of(renderGraph.getBarriersAfter(compiledPasses[forwardIndex]),
+                                                 [&](const RenderGraphBarrier& barrier) { return barrier.resource == depthBuffer && barrier.stateAfter == ResourceState::DepthWrite; }));
+
+        // One sync per direction.
+        NETHER_CHECK(runner, renderGraph.getQueueSyncs().size() == 2u);
+
+        checkResourceStates(runner, builder);
+    }
+
+    static void testComputeQueueTransitionFails(TestRunner& runner)
+    {
+        RenderGraphBuilder builder{};
+        const RenderGraphResource backBuffer = builder.importResource(ResourceState::Present, ResourceState::Present);
+        const RenderGraphResource histogram = builder.createTransientResource(1024u);
+
+        const RenderGraphPass buildPass = builder.addPass(QueueType::Compute);
+        builder.write(buildPass, histogram, ResourceState::UnorderedAccess);
+
+        // UnorderedAccess -> ShaderResource, with no graphics pass in between to do it.
+        const RenderGraphPass reducePass = builder.addPass(QueueType::Compute);
+        builder.read(reducePass, histogram, ResourceState::ShaderResource);
+        builder.write(reducePass, backBuffer, ResourceState::UnorderedAccess);
+
+        NETHER_CHECK_THROWS(runner, builder.renderGraph.compile(), "only the graphics queue supports");
+    }
+
+    // The graph the rendering benchmarks compile, with a compute pass every 8 passes.
+    static void testMixedQueues(TestRunner& runner)
+    {
+        RenderGraphBuilder builder{};
+        const RenderGraphResource backBuffer = builder.importResource(ResourceState::Present, ResourceState::Present);
+
+        std::array<RenderGraphResource, 2u> previousOutputs{};
+        for (const uint32_t passIndex : std::views::iota(0u, 63u))
+        {
+            const bool isComputePass = passIndex % 8u == 7u;
+            const RenderGraphPass pass = builder.addPass(isComputePass ? QueueType::Compute : QueueType::Graphics);
+
+            for (const RenderGraphResource previousOutput : previousOutputs)
+            {
+                if (previousOutput.isValid())
+                {
+                    builder.read(pass, previousOutput, ResourceState::ShaderResource);
+                }
+            }
+
+            const RenderGraphResource output = builder.createTransientResource((1u + passIndex % 4u) * 1024u);
+            builder.write(pass, output, isComputePass ? ResourceState::UnorderedAccess : ResourceState::RenderTarget);
+
+            if (passIndex % 16u != 15u)
+            {
+                previousOutputs = {previousOutputs[1], output};
+            }
+        }
+
+        const RenderGraphPass presentPass = builder.addPass();
+        builder.read(presentPass, previousOutputs[1], ResourceState::ShaderResource);
+        builder.write(presentPass, backBuffer, ResourceState::RenderTarget);
+
+        builder.renderGraph.compile();
+
+        const RenderGraph& renderGraph = builder.renderGraph;
+        const std::span<const CompiledPass> compiledPasses = renderGraph.getCompiledPasses();
+        // Passes 15, 31 and 47 are culled.
+        NETHER_CHECK(runner, compiledPasses.size() == 64u - 3u);
+
+        // Syncs go between passes on different queues, in order, at most once per pass and direction.
+        for (const QueueSync& queueSync : renderGraph.getQueueSyncs())
+        {
+            NETHER_CHECK(runner, queueSync.signalPass < queueSync.waitPass);
+            NETHER_CHECK(runner, compiledPasses[queueSync.signalPass].queue != compiledPasses[queueSync.waitPass].queue);
+        }
+
+        NETHER_CHECK(runner, std::ranges::adjacent_find(renderGraph.getQueueSyncs(), [](const QueueSync& a, const QueueSync& b) { return a.waitPass == b.waitPass; }) ==
+                                 renderGraph.getQueueSyncs().end());
+
+        checkResourceStates(runner, builder);
+    }
+
+    void runRenderGraphTests(TestRunner& runner)
+    {
+        runner.run("RenderGraph/cullAndSort", [&]() { testCullAndSort(runner); });
+        runner.run("RenderGraph/transientAliasing", [&]() { testTransientAliasing(runner); });
+        runner.run("RenderGraph/barriers", [&]() { testBarriers(runner); });
+        runner.run("RenderGraph/crossQueueTransitions", [&]() { testCrossQueueTransitions(runner); });
+        runner.run("RenderGraph/computeQueueTransitionFails", [&]() { testComputeQueueTransitionFails(runner); });
+        runner.run("RenderGraph/mixedQueues", [&]() { testMixedQueues(runner); });
+    }
+}
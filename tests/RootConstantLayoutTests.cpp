@@ -0,0 +1,77 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "IndirectCommands.hpp"
+#include "RootConstantLayout.hpp"
+
+namespace nether::Test
+{
+    // RenderResources as a shader that declares the same members as the C++ struct reflects it.
+    static std::vector<ReflectedRootConstant> getMatchingRootConstants()
+    {
+        std::vector<ReflectedRootConstant> reflectedRootConstants{};
+        for (const RootConstantField& field : RENDER_RESOURCES_LAYOUT.fields)
+        {
+            reflectedRootConstants.push_back(ReflectedRootConstant{
+                .name = std::string(field.name),
+                .offsetInBytes = field.offsetInBytes,
+                .sizeInBytes = field.sizeInBytes,
+            });
+        }
+
+        return reflectedRootConstants;
+    }
+
+    static void testValidateRootConstants(TestRunner& runner)
+    {
+        std::vector<ReflectedRootConstant> reflectedRootConstants = getMatchingRootConstants();
+        NETHER_CHECK(runner, validateRootConstants(RENDER_RESOURCES_LAYOUT, reflectedRootConstants).empty());
+
+        // A shader that declares a prefix of the struct, and one that uses no root constants at all.
+        NETHER_CHECK(runner, validateRootConstants(RENDER_RESOURCES_LAYOUT, std::span(reflectedRootConstants).first(3u)).empty());
+        NETHER_CHECK(runner, validateRootConstants(RENDER_RESOURCES_LAYOUT, {}).empty());
+
+        // Members declared in a different order than in C++.
+        std::swap(reflectedRootConstants[3].offsetInBytes, reflectedRootConstants[4].offsetInBytes);
+
+        std::string errorMessage = validateRootConstants(RENDER_RESOURCES_LAYOUT, reflectedRootConstants);
+        const auto hasError = [&](const std::string_view error) { return errorMessage.find(error) != std::string::npos; };
+
+        NETHER_CHECK(runner, hasError("RenderResources::sceneBufferIndex is at offset 12 with size 4 in C++, but at offset 16 with size 4 in the shader."));
+        NETHER_CHECK(runner, hasError("RenderResources::instanceBufferIndex is at offset 16 with size 4 in C++, but at offset 12 with size 4 in the shader."));
+
+        // A member whose type changed (e.g. uint to uint2), and a member that does not exist in C++. Every mismatch is reported at once.
+        reflectedRootConstants = getMatchingRootConstants();
+        reflectedRootConstants[6].sizeInBytes = 8u;
+        reflectedRootConstants.push_back(ReflectedRootConstant{.name = "materialIndex", .offsetInBytes = 32u, .sizeInBytes = 4u});
+
+        errorMessage = validateRootConstants(RENDER_RESOURCES_LAYOUT, reflectedRootConstants);
+        NETHER_CHECK(runner, hasError("RenderResources::albedoTextureIndex is at offset 24 with size 4 in C++, but at offset 24 with size 8 in the shader."));
+        NETHER_CHECK(runner, hasError("RenderResources has no member named materialIndex."));
+        NETHER_CHECK(runner, std::ranges::count(errorMessage, '\n') == 2);
+    }
+
+    static void testRootConstantCount(TestRunner& runner)
+    {
+        const std::vector<ReflectedRootConstant> reflectedRootConstants = getMatchingRootConstants();
+
+        NETHER_CHECK(runner, getRootConstantCount(reflectedRootConstants) == RENDER_RESOURCES_LAYOUT.sizeInBytes / sizeof(uint32_t));
+        NETHER_CHECK(runner, getRootConstantCount(std::span(reflectedRootConstants).first(3u)) == 3u);
+        NETHER_CHECK(runner, getRootConstantCount({}) == 0u);
+
+        // Covers the member that ends last, whatever the order the members were reflected in, and rounds up to whole 32 bit values.
+        const std::array<ReflectedRootConstant, 2u> unorderedRootConstants = {{
+            {.name = "b", .offsetInBytes = 16u, .sizeInBytes = 6u},
+            {.name = "a", .offsetInBytes = 0u, .sizeInBytes = 4u},
+        }};
+
+        NETHER_CHECK(runner, getRootConstantCount(unorderedRootConstants) == 6u);
+    }
+
+    void runRootConstantLayoutTests(TestRunner& runner)
+    {
+        runner.run("RootConstantLayout/validateRootConstants", [&]() { testValidateRootConstants(runner); });
+        runner.run("RootConstantLayout/rootConstantCount", [&]() { testRootConstantCount(runner); });
+    }
+}
@@ -0,0 +1,342 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "Scene.hpp"
+
+namespace nether::Test
+{
+    static void testCreateAndDestroy(TestRunner& runner)
+    {
+        Scene scene{};
+
+        const EntityHandle a = scene.createEntity("A");
+        const EntityHandle b = scene.createEntity("B");
+        const EntityHandle c = scene.createEntity("C");
+
+        NETHER_CHECK(runner, scene.size() == 3u);
+        NETHER_CHECK(runner, scene.isAlive(a) && scene.isAlive(b) && scene.isAlive(c));
+
+        scene.setTransform(c, Transform{.translate = {3.0f, 0.0f, 0.0f}});
+        scene.getRenderable(c).albedoTextureIndex = 7u;
+
+        // Destroying from the middle moves the last entity into the hole, its handle and components must follow.
+        scene.destroyEntity(a);
+
+        NETHER_CHECK(runner, scene.size() == 2u);
+        NETHER_CHECK(runner, !scene.isAlive(a));
+        NETHER_CHECK(runner, scene.isAlive(b) && scene.isAlive(c));
+        NETHER_CHECK(runner, scene.getTransform(c).translate.x == 3.0f);
+        NETHER_CHECK(runner, scene.getRenderable(c).albedoTextureIndex == 7u);
+
+        for (const size_t denseIndex : std::views::iota(size_t{0u}, scene.size()))
+        {
+            const EntityHandle entity = scene.getEntity(denseIndex);
+            NETHER_CHECK(runner, scene.getName(denseIndex) == (entity == b ? "B" : "C"));
+        }
+
+        // Destroying a dead handle is a no-op.
+        scene.destroyEntity(a);
+        NETHER_CHECK(runner, scene.size() == 2u);
+    }
+
+    static void testStaleHandles(TestRunner& runner)
+    {
+        Scene scene{};
+
+        const EntityHandle first = scene.createEntity("First");
+        scene.destroyEntity(first);
+
+        // The slot is reused with a new generation, so the old handle stays dead.
+        const EntityHandle second = scene.createEntity("Second");
+
+        NETHER_CHECK(runner, second.index == first.index);
+        NETHER_CHECK(runner, second.generation != first.generation);
+        NETHER_CHECK(runner, !scene.isAlive(first));
+        NETHER_CHECK(runner, scene.isAlive(second));
+        NETHER_CHECK(runner, !scene.isAlive(EntityHandle{}));
+
+        NETHER_CHECK_THROWS(runner, scene.getTransform(first), "not alive");
+        NETHER_CHECK_THROWS(runner, scene.getRenderable(first), "not alive");
+    }
+
+    static void testClear(TestRunner& runner)
+    {
+        Scene scene{};
+
+        std::vector<EntityHandle> entities{};
+        for (const uint32_t i : std::views::iota(0u, 100u))
+        {
+            entities.push_back(scene.createEntity(std::format("Entity {}", i)));
+        }
+
+        scene.clear();
+
+        NETHER_CHECK(runner, scene.size() == 0u);
+        NETHER_CHECK(runner, std::ranges::none_of(entities, [&](const EntityHandle entity) { return scene.isAlive(entity); }));
+
+        // Handles from before the clear must not alias the entities created after it.
+        const EntityHandle entity = scene.createEntity("After clear");
+        NETHER_CHECK(runner, scene.isAlive(entity));
+        NETHER_CHECK(runner, std::ranges::none_of(entities, [&](const EntityHandle oldEntity) { return scene.isAlive(oldEntity); }));
+    }
+
+    static void testUpdateTransforms(TestRunner& runner)
+    {
+        Scene scene{};
+
+        const Transform transform = {
+            .rotate = {0.1f, 0.2f, 0.3f},
+            .scale = {2.0f, 2.0f, 2.0f},
+            .translate = {1.0f, 2.0f, 3.0f},
+        };
+
+        const EntityHandle entity = scene.createEntity("Entity");
+        scene.setTransform(entity, transform);
+        scene.updateTransforms();
+
+        // Same order as the engine used before the scene store (see TransformKernel.hpp).
+        const math::XMMATRIX rotationMatrix = math::XMMatrixRotationX(0.1f) * math::XMMatrixRotationY(0.2f) * math::XMMatrixRotationZ(0.3f);
+
+        math::XMFLOAT4X4 expectedWorldMatrix{};
+        math::XMStoreFloat4x4(&expectedWorldMatrix, rotationMatrix * math::XMMatrixScaling(2.0f, 2.0f, 2.0f) * math::XMMatrixTranslation(1.0f, 2.0f, 3.0f));
+
+        NETHER_CHECK(runner, isNearlyEqual(scene.getWorldMatrix(entity), expectedWorldMatrix));
+        NETHER_CHECK(runner, scene.getChangedTransformIndices().size() == 1u);
+
+        // Nothing changed, so nothing is reported as changed.
+        scene.updateTransforms();
+        NETHER_CHECK(runner, scene.getChangedTransformIndices().empty());
+    }
+
+    static math::XMFLOAT4X4 getExpectedWorldMatrix(const Scene& scene, const EntityHandle entity)
+    {
+        math::XMMATRIX worldMatrix = math::XMMatrixIdentity();
+        for (EntityHandle current = entity; current.isValid(); current = scene.getParent(current))
+        {
+            const Transform transform = scene.getTransform(current);
+            const math::XMMATRIX localMatrix = math::XMMatrixRotationX(transform.rotate.x) * math::XMMatrixRotationY(transform.rotate.y) *
+                                               math::XMMatrixRotationZ(transform.rotate.z) *
+                                               math::XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z) *
+                                               math::XMMatrixTranslation(transform.translate.x, transform.translate.y, transform.translate.z);
+            worldMatrix = worldMatrix * localMatrix;
+        }
+
+        math::XMFLOAT4X4 expectedWorldMatrix{};
+        math::XMStoreFloat4x4(&expectedWorldMatrix, worldMatrix);
+
+        return expectedWorldMatrix;
+    }
+
+    // Parents come before their children in the dense arrays (see Scene.hpp).
+    static bool isInBreadthFirstOrder(const Scene& scene)
+    {
+        std::vector<uint32_t> depths(scene.size());
+        for (const size_t denseIndex : std::views::iota(size_t{0u}, scene.size()))
+        {
+            for (EntityHandle ancestor = scene.getParent(scene.getEntity(denseIndex)); ancestor.isValid(); ancestor = scene.getParent(ancestor))
+            {
+                depths[denseIndex]++;
+            }
+        }
+
+        return std::ranges::is_sorted(depths);
+    }
+
+    static void testHierarchy(TestRunner& runner)
+    {
+        Scene scene{};
+
+        // Created children first, so the order has to be fixed by updateTransforms.
+        const EntityHandle grandchild = scene.createEntity("Grandchild");
+        const EntityHandle child = scene.createEntity("Child");
+        const EntityHandle root = scene.createEntity("Root");
+        const EntityHandle other = scene.createEntity("Other");
+
+        scene.setParent(grandchild, child);
+        scene.setParent(child, root);
+
+        scene.setTransform(root, Transform{.rotate = {0.0f, 0.5f, 0.0f}, .translate = {10.0f, 0.0f, 0.0f}});
+        scene.setTransform(child, Transform{.scale = {2.0f, 2.0f, 2.0f}, .translate = {0.0f, 1.0f, 0.0f}});
+        scene.setTransform(grandchild, Transform{.rotate = {0.3f, 0.0f, 0.0f}, .translate = {0.0f, 0.0f, 1.0f}});
+        scene.updateTransforms();
+
+        NETHER_CHECK(runner, isInBreadthFirstOrder(scene));
+        NETHER_CHECK(runner, scene.getParent(grandchild) == child);
+        NETHER_CHECK(runner, scene.getName(0u) == "Root" || scene.getName(0u) == "Other");
+
+        for (const EntityHandle entity : {root, child, grandchild, other})
+        {
+            NETHER_CHECK(runner, isNearlyEqual(scene.getWorldMatrix(entity), getExpectedWorldMatrix(scene, entity)));
+        }
+
+        // Moving the child's subtree under another root.
+        scene.setParent(child, other);
+        scene.setTransform(other, Transform{.translate = {0.0f, -5.0f, 0.0f}});
+        scene.updateTransforms();
+
+        NETHER_CHECK(runner, isInBreadthFirstOrder(scene));
+        NETHER_CHECK(runner, isNearlyEqual(scene.getWorldMatrix(grandchild), getExpectedWorldMatrix(scene, grandchild)));
+    }
+
+    static void testChangedIndices(TestRunner& runner)
+    {
+        Scene scene{};
+
+        const EntityHandle rootA = scene.createEntity("Root A");
+        const EntityHandle childA = scene.createEntity("Child A", rootA);
+        const EntityHandle grandchildA = scene.createEntity("Grandchild A", childA);
+        const EntityHandle rootB = scene.createEntity("Root B");
+        const EntityHandle childB = scene.createEntity("Child B", rootB);
+        scene.updateTransforms();
+
+        NETHER_CHECK(runner, scene.getChangedTransformIndices().size() == 5u);
+
+        // Only the moved entity and its subtree are reported.
+        scene.setTransform(childA, Transform{.translate = {1.0f, 0.0f, 0.0f}});
+        scene.updateTransforms();
+
+        std::vector<EntityHandle> changedEntities{};
+        for (const uint32_t denseIndex : scene.getChangedTransformIndices())
+        {
+            changedEntities.push_back(scene.getEntity(denseIndex));
+        }
+        std::ranges::sort(changedEntities);
+
+        std::vector<EntityHandle> expectedChangedEntities = {childA, grandchildA};
+        std::ranges::sort(expectedChangedEntities);
+
+        NETHER_CHECK(runner, changedEntities == expectedChangedEntities);
+        NETHER_CHECK(runner, scene.getWorldMatrix(grandchildA)._41 == 1.0f);
+        NETHER_CHECK(runner, scene.getWorldMatrix(childB)._41 == 0.0f);
+    }
+
+    static void testReparentCycle(TestRunner& runner)
+    {
+        Scene scene{};
+
+        const EntityHandle root = scene.createEntity("Root");
+        const EntityHandle child = scene.createEntity("Child", root);
+        const EntityHandle grandchild = scene.createEntity("Grandchild", child);
+
+        NETHER_CHECK_THROWS(runner, scene.setParent(root, grandchild), "descendants");
+        NETHER_CHECK_THROWS(runner, scene.setParent(child, child), "descendants");
+
+        // The failed calls must not have changed the hierarchy.
+        NETHER_CHECK(runner, !scene.getParent(root).isValid());
+        NETHER_CHECK(runner, scene.getParent(child) == root);
+    }
+
+    static void testDestroyedParent(TestRunner& runner)
+    {
+        Scene scene{};
+
+        const EntityHandle root = scene.createEntity("Root");
+        const EntityHandle parent = scene.createEntity("Parent", root);
+        const EntityHandle child = scene.createEntity("Child", parent);
+        const EntityHandle other = scene.createEntity("Other");
+
+        scene.setTransform(parent, Transform{.translate = {5.0f, 0.0f, 0.0f}});
+        scene.setTransform(child, Transform{.translate = {0.0f, 1.0f, 0.0f}});
+        scene.updateTransforms();
+
+        // The cycle check walks through the destroyed parent before updateTransforms turned the child into a root.
+        scene.destroyEntity(parent);
+        NETHER_CHECK(runner, !scene.getParent(child).isValid());
+
+        scene.setParent(other, child);
+        scene.updateTransforms();
+
+        NETHER_CHECK(runner, isInBreadthFirstOrder(scene));
+        NETHER_CHECK(runner, !scene.getParent(child).isValid());
+        NETHER_CHECK(runner, scene.getParent(other) == child);
+        NETHER_CHECK(runner, isNearlyEqual(scene.getWorldMatrix(child), getExpectedWorldMatrix(scene, child)));
+        NETHER_CHECK(runner, isNearlyEqual(scene.getWorldMatrix(other), getExpectedWorldMatrix(scene, other)));
+
+        // A reused slot must not be mistaken for the destroyed parent.
+        const EntityHandle reused = scene.createEntity("Reused");
+        NETHER_CHECK(runner, reused.index == parent.index);
+        NETHER_CHECK(runner, !scene.getParent(child).isValid());
+    }
+
+    // Random structural changes, checked against the world matrices recomputed from the handles.
+    static void testRandomHierarchy(TestRunner& runner)
+    {
+        std::mt19937 randomEngine(28u);
+        std::uniform_real_distribution<float> valueDistribution(-1.0f, 1.0f);
+
+        Scene scene{};
+        std::vector<EntityHandle> entities{};
+
+        for (const uint32_t iteration : std::views::iota(0u, 2000u))
+        {
+            const uint32_t operation = iteration < 200u ? 0u : static_cast<uint32_t>(randomEngine() % 4u);
+
+            if (operation == 0u || entities.empty())
+            {
+                const EntityHandle parent = entities.empty() || randomEngine() % 4u == 0u ? EntityHandle{} : entities[randomEngine() % entities.size()];
+                entities.push_back(scene.createEntity("Entity", parent));
+            }
+            else if (operation == 1u)
+            {
+                const size_t index = randomEngine() % entities.size();
+                scene.destroyEntity(entities[index]);
+                entities.erase(entities.begin() + static_cast<ptrdiff_t>(index));
+            }
+            else if (operation == 2u)
+            {
+                const EntityHandle entity = entities[randomEngine() % entities.size()];
+                const EntityHandle parent = entities[randomEngine() % entities.size()];
+
+                try
+                {
+                    scene.setParent(entity, parent);
+                }
+                catch (const std::runtime_error&)
+                {
+                    // Would have been a cycle.
+                }
+            }
+            else
+            {
+                scene.setTransform(entities[randomEngine() % entities.size()],
+                                   Transform{
+                                       .rotate = {valueDistribution(randomEngine), valueDistribution(randomEngine), valueDistribution(randomEngine)},
+                                       .translate = {valueDistribution(randomEngine), valueDistribution(randomEngine), valueDistribution(randomEngine)},
+                                   });
+            }
+
+            if (iteration % 50u == 0u)
+            {
+                scene.updateTransforms();
+            }
+        }
+
+        scene.updateTransforms();
+
+        NETHER_CHECK(runner, scene.size() == entities.size());
+        NETHER_CHECK(runner, isInBreadthFirstOrder(scene));
+
+        // Chains of translations add up, so the tolerance is relative to a few units.
+        bool areWorldMatricesCorrect = true;
+        for (const EntityHandle entity : entities)
+        {
+            areWorldMatricesCorrect = areWorldMatricesCorrect && isNearlyEqual(scene.getWorldMatrix(entity), getExpectedWorldMatrix(scene, entity), 1e-4f);
+        }
+
+        NETHER_CHECK(runner, areWorldMatricesCorrect);
+    }
+
+    void runSceneTests(TestRunner& runner)
+    {
+        runner.run("Scene/createAndDestroy", [&]() { testCreateAndDestroy(runner); });
+        runner.run("Scene/staleHandles", [&]() { testStaleHandles(runner); });
+        runner.run("Scene/clear", [&]() { testClear(runner); });
+        runner.run("Scene/updateTransforms", [&]() { testUpdateTransforms(runner); });
+        runner.run("Scene/hierarchy", [&]() { testHierarchy(runner); });
+        runner.run("Scene/changedIndices", [&]() { testChangedIndices(runner); });
+        runner.run("Scene/reparentCycle", [&]() { testReparentCycle(runner); });
+        runner.run("Scene/destroyedParent", [&]() { testDestroyedParent(runner); });
+        runner.run("Scene/randomHierarchy", [&]() { testRandomHierarchy(runner); });
+    }
+}
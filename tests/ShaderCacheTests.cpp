@@ -0,0 +1,178 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "ShaderCache.hpp"
+
+namespace nether::Test
+{
+    static void writeTextFile(const std::filesystem::path& filePath, const std::string_view text)
+    {
+        std::filesystem::create_directories(filePath.parent_path());
+
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    // A shader that includes a header next to it, which includes a header from an include directory, which includes the first header again.
+    struct ShaderSources
+    {
+        TemporaryDirectory temporaryDirectory{"ShaderCache"};
+
+        std::filesystem::path shaderPath{};
+        std::filesystem::path commonHeaderPath{};
+        std::filesystem::path libraryHeaderPath{};
+        std::array<std::filesystem::path, 1u> includeDirectories{};
+
+        ShaderSources()
+        {
+            const std::filesystem::path& root = temporaryDirectory.getPath();
+
+            shaderPath = root / "shaders" / "Mesh.hlsl";
+            commonHeaderPath = root / "shaders" / "Common.hlsli";
+            libraryHeaderPath = root / "library" / "Library.hlsli";
+            includeDirectories[0] = root / "library";
+
+            writeTextFile(shaderPath, "#include \"Common.hlsli\"\nfloat4 VsMain() : SV_Position { return 0; }\n");
+            writeTextFile(commonHeaderPath, "  #  include <Library.hlsli>\n#define COMMON 1\n");
+            writeTextFile(libraryHeaderPath, "#pragma once\n#include \"../shaders/Common.hlsli\"\n#define LIBRARY 1\n");
+        }
+
+        uint64_t computeKey(const std::span<const wchar_t* const> arguments = DEFAULT_ARGUMENTS, const uint64_t compilerVersion = 1u) const
+        {
+            return ShaderCache::computeKey(shaderPath, includeDirectories, arguments, compilerVersion);
+        }
+
+        static constexpr std::array<const wchar_t*, 4u> DEFAULT_ARGUMENTS = {L"-E", L"VsMain", L"-T", L"vs_6_6"};
+    };
+
+    static void testKeyInputs(TestRunner& runner)
+    {
+        ShaderSources shaderSources{};
+
+        // Stable for the same inputs, and the include cycle terminates.
+        const uint64_t key = shaderSources.computeKey();
+        NETHER_CHECK(runner, shaderSources.computeKey() == key);
+
+        // Every dependency, each once.
+        std::vector<std::filesystem::path> dependencies{};
+        [[maybe_unused]] const uint64_t keyWithDependencies =
+            ShaderCache::computeKey(shaderSources.shaderPath, shaderSources.includeDirectories, ShaderSources::DEFAULT_ARGUMENTS, 1u, &dependencies);
+
+        NETHER_CHECK(runner, keyWithDependencies == key);
+        NETHER_CHECK(runner, dependencies.size() == 3u);
+        for (const std::filesystem::path& filePath : {shaderSources.shaderPath, shaderSources.commonHeaderPath, shaderSources.libraryHeaderPath})
+        {
+            NETHER_CHECK(runner, std::ranges::count(dependencies, std::filesystem::weakly_canonical(filePath)) == 1);
+        }
+
+        // Arguments are hashed one by one, so moving characters between them changes the key.
+        constexpr std::array<const wchar_t*, 4u> splitArguments = {L"-EVs", L"Main", L"-T", L"vs_6_6"};
+        constexpr std::array<const wchar_t*, 5u> debugArguments = {L"-E", L"VsMain", L"-T", L"vs_6_6", L"-Zi"};
+
+        NETHER_CHECK(runner, shaderSources.computeKey(splitArguments) != key);
+        NETHER_CHECK(runner, shaderSources.computeKey(debugArguments) != key);
+        NETHER_CHECK(runner, shaderSources.computeKey(ShaderSources::DEFAULT_ARGUMENTS, 2u) != key);
+    }
+
+    // Editing any file in the include graph, at any depth, gives a new key.
+    static void testKeyIncludeGraph(TestRunner& runner)
+    {
+        ShaderSources shaderSources{};
+
+        std::vector<uint64_t> keys{shaderSources.computeKey()};
+
+        writeTextFile(shaderSources.shaderPath, "#include \"Common.hlsli\"\nfloat4 VsMain() : SV_Position { return 1; }\n");
+        keys.push_back(shaderSources.computeKey());
+
+        writeTextFile(shaderSources.commonHeaderPath, "  #  include <Library.hlsli>\n#define COMMON 2\n");
+        keys.push_back(shaderSources.computeKey());
+
+        writeTextFile(shaderSources.libraryHeaderPath, "#pragma once\n#include \"../shaders/Common.hlsli\"\n#define LIBRARY 2\n");
+        keys.push_back(shaderSources.computeKey());
+
+        // A include that does not exist yet, and then does.
+        writeTextFile(shaderSources.libraryHeaderPath, "#include \"Generated.hlsli\"\n");
+        keys.push_back(shaderSources.computeKey());
+
+        writeTextFile(shaderSources.includeDirectories[0] / "Generated.hlsli", "#define GENERATED 1\n");
+        keys.push_back(shaderSources.computeKey());
+
+        // Lines that only look like includes are not followed.
+        writeTextFile(shaderSources.libraryHeaderPath, "// #include \"Generated.hlsli\"\n#includes \"Generated.hlsli\"\n#include Generated.hlsli\n");
+
+        std::vector<std::filesystem::path> dependencies{};
+        keys.push_back(ShaderCache::computeKey(shaderSources.shaderPath, shaderSources.includeDirectories, ShaderSources::DEFAULT_ARGUMENTS, 1u, &dependencies));
+        NETHER_CHECK(runner, dependencies.size() == 3u);
+
+        // A file next to the including file shadows the one in the include directories.
+        writeTextFile(shaderSources.shaderPath.parent_path() / "Library.hlsli", "#define LIBRARY 3\n");
+        keys.push_back(ShaderCache::computeKey(shaderSources.shaderPath, shaderSources.includeDirectories, ShaderSources::DEFAULT_ARGUMENTS, 1u, &dependencies));
+        NETHER_CHECK(runner, std::ranges::find(dependencies, std::filesystem::weakly_canonical(shaderSources.libraryHeaderPath)) == dependencies.end());
+
+        std::ranges::sort(keys);
+        NETHER_CHECK(runner, std::ranges::adjacent_find(keys) == keys.end());
+    }
+
+    static void testStoreAndLoad(TestRunner& runner)
+    {
+        TemporaryDirectory cacheDirectory("ShaderCacheEntries");
+
+        std::vector<std::byte> bytecode(64u);
+        for (const size_t i : std::views::iota(0u, bytecode.size()))
+        {
+            bytecode[i] = static_cast<std::byte>(i * 31u);
+        }
+
+        // Disabled until a directory is set.
+        ShaderCache::store(1u, bytecode);
+        NETHER_CHECK(runner, !ShaderCache::load(1u).has_value());
+
+        // Room for two entries (header included), but not three.
+        ShaderCache::setCacheDirectory(cacheDirectory.getPath(), 250u);
+
+        ShaderCache::store(1u, bytecode);
+        NETHER_CHECK(runner, ShaderCache::load(1u) == bytecode);
+        NETHER_CHECK(runner, !ShaderCache::load(2u).has_value());
+
+        // A corrupted entry is a miss, and is removed.
+        const std::filesystem::path entryPath = cacheDirectory.getPath() / std::format("{:016x}.dxil", 1u);
+        {
+            std::fstream file(entryPath, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(-1, std::ios::end);
+            file.put('\x7F');
+        }
+
+        NETHER_CHECK(runner, !ShaderCache::load(1u).has_value());
+        NETHER_CHECK(runner, !std::filesystem::exists(entryPath));
+
+        // Least recently used entries are evicted first, and a hit counts as a use.
+        ShaderCache::store(1u, bytecode);
+        ShaderCache::store(2u, bytecode);
+
+        const auto now = std::filesystem::file_time_type::clock::now();
+        std::filesystem::last_write_time(entryPath, now - std::chrono::hours(2));
+        std::filesystem::last_write_time(cacheDirectory.getPath() / std::format("{:016x}.dxil", 2u), now - std::chrono::hours(1));
+
+        NETHER_CHECK(runner, ShaderCache::load(1u).has_value());
+        ShaderCache::store(3u, bytecode);
+
+        NETHER_CHECK(runner, ShaderCache::load(1u).has_value());
+        NETHER_CHECK(runner, !ShaderCache::load(2u).has_value());
+        NETHER_CHECK(runner, ShaderCache::load(3u) == bytecode);
+
+        // No temporary files are left behind.
+        NETHER_CHECK(runner, std::ranges::distance(std::filesystem::directory_iterator(cacheDirectory.getPath())) == 2);
+
+        // Disabled again, the directory is about to be removed.
+        ShaderCache::setCacheDirectory({}, 0u);
+        NETHER_CHECK(runner, !ShaderCache::load(3u).has_value());
+    }
+
+    void runShaderCacheTests(TestRunner& runner)
+    {
+        runner.run("ShaderCache/keyInputs", [&]() { testKeyInputs(runner); });
+        runner.run("ShaderCache/keyIncludeGraph", [&]() { testKeyIncludeGraph(runner); });
+        runner.run("ShaderCache/storeAndLoad", [&]() { testStoreAndLoad(runner); });
+    }
+}
@@ -0,0 +1,303 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+// Only built where DXC is available (see premake5.lua), and shipping builds do not compile shaders at runtime.
+#if defined(NETHER_HAS_DXC) && !defined(NETHER_SHIPPING)
+#include "IndirectCommands.hpp"
+#include "ShaderCache.hpp"
+#include "ShaderCompiler.hpp"
+
+namespace nether::Test
+{
+    static constexpr std::wstring_view PHONG_SHADER_PATH = L"shaders/PhongShader.hlsl";
+    static constexpr std::wstring_view GENERATE_MIP_MAPS_SHADER_PATH = L"shaders/GenerateMipMaps.hlsl";
+
+    static void writeShaderFile(const std::filesystem::path& filePath, const std::string_view text)
+    {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    // Every variant of the Phong vertex and pixel shaders, as the engine compiles them at startup.
+    static std::vector<ShaderCompileJob> getPhongShaderJobs()
+    {
+        const ShaderPermutationDesc vertexShaderDesc = {
+            .shaderType = ShaderTypes::Vertex,
+            .shaderPath = std::wstring(PHONG_SHADER_PATH),
+            .features = {L"PHONG_SPECULAR", L"PHONG_DIRECTIONAL_LIGHT"},
+        };
+
+        ShaderPermutationDesc pixelShaderDesc = vertexShaderDesc;
+        pixelShaderDesc.shaderType = ShaderTypes::Pixel;
+
+        std::vector<ShaderCompileJob> jobs{};
+        for (const ShaderVariantKey variantKey : ShaderCompiler::getAllVariantKeys(static_cast<uint32_t>(vertexShaderDesc.features.size())))
+        {
+            jobs.push_back(ShaderCompiler::getVariantJob(vertexShaderDesc, variantKey));
+            jobs.push_back(ShaderCompiler::getVariantJob(pixelShaderDesc, variantKey));
+        }
+
+        return jobs;
+    }
+
+    static void testCompileBatch(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+        const std::vector<ShaderCompileJob> jobs = getPhongShaderJobs();
+
+        // The second batch comes from the shader cache. Every shader comes back in job order, with its bytecode and dependencies.
+        for ([[maybe_unused]] const uint32_t iteration : std::views::iota(0u, 2u))
+        {
+            const std::vector<Shader> shaders = ShaderCompiler::compileBatch(jobSystem, jobs);
+
+            NETHER_CHECK(runner, shaders.size() == jobs.size());
+            for (const Shader& shader : shaders)
+            {
+                NETHER_CHECK(runner, shader.shaderBlob && shader.shaderBlob->GetBufferSize() > 0u);
+                NETHER_CHECK(runner, std::ranges::count(shader.dependencies, std::filesystem::weakly_canonical(PHONG_SHADER_PATH)) == 1);
+            }
+        }
+    }
+
+    // A job that fails does not affect the others, and compileBatch reports every failed job at once.
+    static void testCompileBatchErrors(TestRunner& runner)
+    {
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+
+        std::vector<ShaderCompileJob> jobs = getPhongShaderJobs();
+        jobs[1].shaderPath = L"shaders/Missing.hlsl";
+        jobs[4].shaderPath = L"shaders/AlsoMissing.hlsl";
+
+        const std::vector<ShaderCompileResult> results = ShaderCompiler::tryCompileBatch(jobSystem, jobs);
+        for (const size_t jobIndex : std::views::iota(size_t{0u}, results.size()))
+        {
+            const bool shouldFail = jobIndex == 1u || jobIndex == 4u;
+            NETHER_CHECK(runner, results[jobIndex].errorMessage.empty() != shouldFail);
+        }
+
+        NETHER_CHECK_THROWS(runner, ShaderCompiler::compileBatch(jobSystem, jobs), "shaders/Missing.hlsl");
+        NETHER_CHECK_THROWS(runner, ShaderCompiler::compileBatch(jobSystem, jobs), "shaders/AlsoMissing.hlsl");
+    }
+
+    // Two features, one of which the shader never tests, so the variants that only differ in it have the same preprocessed source.
+    static void testCompilePermutations(TestRunner& runner)
+    {
+        TemporaryDirectory temporaryDirectory("ShaderPermutations");
+        const std::filesystem::path shaderPath = temporaryDirectory.getPath() / "Permutations.hlsl";
+
+        writeShaderFile(shaderPath,
+                        "float4 VsMain(uint vertexID : SV_VertexID) : SV_Position\n"
+                        "{\n"
+                        "#if USE_OFFSET\n"
+                        "    return float4(vertexID + 1.0f, 0.0f, 0.0f, 1.0f);\n"
+                        "#else\n"
+                        "    return float4(vertexID, 0.0f, 0.0f, 1.0f);\n"
+                        "#endif\n"
+                        "}\n");
+
+        const ShaderPermutationDesc permutationDesc = {
+            .shaderType = ShaderTypes::Vertex,
+            .shaderPath = shaderPath.wstring(),
+            .features = {L"USE_OFFSET", L"UNUSED_FEATURE"},
+        };
+
+        const std::vector<ShaderVariantKey> variantKeys = ShaderCompiler::getAllVariantKeys(2u);
+        NETHER_CHECK(runner, variantKeys == (std::vector<ShaderVariantKey>{0u, 1u, 2u, 3u}));
+
+        // The defines of a variant key are set to 1 for the features it enables and to 0 for the others.
+        const ShaderCompileJob variantJob = ShaderCompiler::getVariantJob(permutationDesc, 0b10u);
+        NETHER_CHECK(runner, variantJob.defines.size() == 2u);
+        NETHER_CHECK(runner, variantJob.defines[0].name == L"USE_OFFSET" && variantJob.defines[0].value == L"0");
+        NETHER_CHECK(runner, variantJob.defines[1].name == L"UNUSED_FEATURE" && variantJob.defines[1].value == L"1");
+
+        JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+
+        const ShaderPermutationSet permutationSet = ShaderCompiler::compilePermutations(jobSystem, permutationDesc, variantKeys);
+        NETHER_CHECK(runner, permutationSet.shaders.size() == 2u);
+        NETHER_CHECK(runner, &permutationSet.getShader(0b00u) == &permutationSet.getShader(0b10u));
+        NETHER_CHECK(runner, &permutationSet.getShader(0b01u) == &permutationSet.getShader(0b11u));
+        NETHER_CHECK(runner, &permutationSet.getShader(0b00u) != &permutationSet.getShader(0b01u));
+
+        // Only the requested variants are compiled.
+        const std::array<ShaderVariantKey, 1u> requestedVariantKeys = {0b01u};
+        const ShaderPermutationSet partialPermutationSet = ShaderCompiler::compilePermutations(jobSystem, permutationDesc, requestedVariantKeys);
+
+        NETHER_CHECK(runner, partialPermutationSet.shaders.size() == 1u);
+        NETHER_CHECK(runner, partialPermutationSet.getShader(0b01u).shaderBlob);
+        NETHER_CHECK_THROWS(runner, partialPermutationSet.getShader(0b00u), "Shader variant 0 was not compiled.");
+        NETHER_CHECK_THROWS(runner, partialPermutationSet.getShader(4u), "Shader variant 4 was not compiled.");
+
+        const std::array<ShaderVariantKey, 1u> outOfRangeVariantKeys = {4u};
+        NETHER_CHECK_THROWS(runner, ShaderCompiler::compilePermutations(jobSystem, permutationDesc, outOfRangeVariantKeys), "Shader variant 4 is out of range");
+    }
+
+    // The root constants of the engine's shaders match the C++ layouts they are filled from, and a shader whose struct drifted apart from the C++ one is rejected.
+    static void testReflectRootConstants(TestRunner& runner)
+    {
+        for (const ShaderTypes shaderType : {ShaderTypes::Vertex, ShaderTypes::Pixel})
+        {
+            const Shader shader = ShaderCompiler::compile(shaderType, PHONG_SHADER_PATH);
+            NETHER_CHECK(runner, shader.rootConstants.size() == RENDER_RESOURCES_FIELDS.size());
+            NETHER_CHECK(runner, validateRootConstants(RENDER_RESOURCES_LAYOUT, shader.rootConstants).empty());
+            NETHER_CHECK(runner, getRootConstantCount(shader.rootConstants) == RENDER_RESOURCES_LAYOUT.sizeInBytes / sizeof(uint32_t));
+        }
+
+        const Shader mipMapShader = ShaderCompiler::compile(ShaderTypes::Compute, GENERATE_MIP_MAPS_SHADER_PATH);
+        NETHER_CHECK(runner, validateRootConstants(GENERATE_MIP_MAP_RENDER_RESOURCES_LAYOUT, mipMapShader.rootConstants).empty());
+        NETHER_CHECK(runner, getRootConstantCount(mipMapShader.rootConstants) == GENERATE_MIP_MAP_RENDER_RESOURCES_LAYOUT.sizeInBytes / sizeof(uint32_t));
+
+        // Two members swapped, and one that C++ does not have. The same shader as a cbuffer block (reflected member by member rather than as a struct), and from the
+        // shader cache, reflects the same way. The compiler set its own cache directory when it compiled its first shader above, so this one is not overridden.
+        TemporaryDirectory temporaryDirectory("ShaderReflection");
+        ShaderCache::setCacheDirectory(temporaryDirectory.getPath() / "Cache", 64u * 1024u * 1024u);
+
+        const std::filesystem::path structShaderPath = temporaryDirectory.getPath() / "Struct.hlsl";
+        const std::filesystem::path cbufferShaderPath = temporaryDirectory.getPath() / "Cbuffer.hlsl";
+
+        constexpr std::string_view members = "uint positionBufferIndex; uint textureCoordBufferIndex; uint normalBufferIndex; uint instanceBufferIndex; "
+                                             "uint sceneBufferIndex; uint instanceOffset; uint albedoTextureIndex; uint materialIndex;";
+        constexpr std::string_view vertexShader = "float4 VsMain() : SV_Position { return float4(renderResources.materialIndex, 0.0f, 0.0f, 1.0f); }\n";
+
+        writeShaderFile(structShaderPath,
+                        std::format("struct RenderResources {{ {} }};\nConstantBuffer<RenderResources> renderResources : register(b0);\n{}", members, vertexShader));
+        writeShaderFile(cbufferShaderPath, std::format("cbuffer renderResources : register(b0) {{ {} }};\n{}", members, vertexShader));
+
+        const std::array<Shader, 3u> mismatchedShaders = {
+            ShaderCompiler::compile(ShaderTypes::Vertex, structShaderPath.wstring()),
+            ShaderCompiler::compile(ShaderTypes::Vertex, structShaderPath.wstring()),
+            ShaderCompiler::compile(ShaderTypes::Vertex, cbufferShaderPath.wstring()),
+        };
+
+        for (const Shader& shader : mismatchedShaders)
+        {
+            const std::string errorMessage = validateRootConstants(RENDER_RESOURCES_LAYOUT, shader.rootConstants);
+            const auto hasError = [&](const std::string_view error) { return errorMessage.find(error) != std::string::npos; };
+
+            NETHER_CHECK(runner, hasError("RenderResources::instanceBufferIndex is at offset 16 with size 4 in C++, but at offset 12 with size 4 in the shader."));
+            NETHER_CHECK(runner, hasError("RenderResources::sceneBufferIndex is at offset 12 with size 4 in C++, but at offset 16 with size 4 in the shader."));
+            NETHER_CHECK(runner, hasError("RenderResources has no member named materialIndex."));
+            NETHER_CHECK(runner, getRootConstantCount(shader.rootConstants) == 8u);
+        }
+
+        // Disabled for the tests that follow, the directory is about to be removed.
+        ShaderCache::setCacheDirectory({}, 0u);
+    }
+
+    void runShaderCompilerTests(TestRunner& runner)
+    {
+        if (!std::filesystem::exists(PHONG_SHADER_PATH))
+        {
+            std::cout << "Skipping the shader compiler tests, the shaders were not found (run from the repository root)." << std::endl;
+            return;
+        }
+
+        runner.run("ShaderCompiler/compileBatch", [&]() { testCompileBatch(runner); });
+        runner.run("ShaderCompiler/compileBatchErrors", [&]() { testCompileBatchErrors(runner); });
+        runner.run("ShaderCompiler/compilePermutations", [&]() { testCompilePermutations(runner); });
+        runner.run("ShaderCompiler/reflectRootConstants", [&]() { testReflectRootConstants(runner); });
+    }
+}
+#elif defined(NETHER_HAS_DXC)
+#include "EmbeddedShaders.hpp"
+#include "ShaderCompiler.hpp"
+
+// Shipping builds load the shaders baked by "premake5 bake-shaders" (see premake5.lua) instead of compiling them.
+namespace nether::Test
+{
+    // Returns the four character codes of the parts of a DXIL container.
+    static std::vector<std::string> getContainerParts(const std::span<const std::byte> bytecode)
+    {
+        const auto readUint32 = [&](const size_t offset)
+        {
+            uint32_t value{};
+            std::memcpy(&value, bytecode.data() + offset, sizeof(uint32_t));
+            return value;
+        };
+
+        // "DXBC", a 16 byte digest, the version, the container size, the part count, and the offset of each part.
+        std::vector<std::string> parts{};
+        if (bytecode.size() < 32u || std::memcmp(bytecode.data(), "DXBC", 4u) != 0)
+        {
+            return parts;
+        }
+
+        for (const uint32_t partIndex : std::views::iota(0u, readUint32(28u)))
+        {
+            const uint32_t partOffset = readUint32(32u + partIndex * sizeof(uint32_t));
+            parts.emplace_back(reinterpret_cast<const char*>(bytecode.data() + partOffset), 4u);
+        }
+
+        return parts;
+    }
+
+    // Every shader the engine loads at startup (see Engine::loadContent) is found, without the shaders directory, and was stripped of debug and reflection data.
+    static void testEmbeddedShaders(TestRunner& runner)
+    {
+        const std::filesystem::path currentDirectory = std::filesystem::current_path();
+        TemporaryDirectory temporaryDirectory("EmbeddedShaders");
+        std::filesystem::current_path(temporaryDirectory.getPath());
+
+        try
+        {
+            JobSystem jobSystem(JobSystemDesc{.workerThreadCount = 3u});
+
+            const std::array<ShaderCompileJob, 3u> jobs = {{
+                {.shaderType = ShaderTypes::Vertex, .shaderPath = L"shaders/LightShader.hlsl"},
+                {.shaderType = ShaderTypes::Pixel, .shaderPath = L"shaders/LightShader.hlsl"},
+                {.shaderType = ShaderTypes::Compute, .shaderPath = L"shaders/GenerateMipMaps.hlsl"},
+            }};
+
+            std::vector<Shader> shaders = ShaderCompiler::compileBatch(jobSystem, jobs);
+
+            const std::vector<ShaderVariantKey> phongVariantKeys = ShaderCompiler::getAllVariantKeys(2u);
+            for (const ShaderTypes shaderType : {ShaderTypes::Vertex, ShaderTypes::Pixel})
+            {
+                const ShaderPermutationDesc phongShaderDesc = {
+                    .shaderType = shaderType,
+                    .shaderPath = L"shaders/PhongShader.hlsl",
+                    .features = {L"PHONG_SPECULAR", L"PHONG_DIRECTIONAL_LIGHT"},
+                };
+
+                const ShaderPermutationSet phongShaders = ShaderCompiler::compilePermutations(jobSystem, phongShaderDesc, phongVariantKeys);
+                for (const ShaderVariantKey variantKey : phongVariantKeys)
+                {
+                    shaders.push_back(phongShaders.getShader(variantKey));
+                }
+            }
+
+            // Nothing is baked that the engine does not load.
+            NETHER_CHECK(runner, shaders.size() == getEmbeddedShaders().size());
+
+            for (const Shader& shader : shaders)
+            {
+                const std::span<const std::byte> bytecode(static_cast<const std::byte*>(shader.shaderBlob->GetBufferPointer()), shader.shaderBlob->GetBufferSize());
+                const std::vector<std::string> parts = getContainerParts(bytecode);
+
+                NETHER_CHECK(runner, std::ranges::find(parts, "DXIL") != parts.end());
+                NETHER_CHECK(runner, std::ranges::find(parts, "ILDB") == parts.end());
+                NETHER_CHECK(runner, std::ranges::find(parts, "STAT") == parts.end());
+            }
+
+            NETHER_CHECK_THROWS(runner, ShaderCompiler::compile(ShaderTypes::Vertex, L"shaders/Missing.hlsl"), "was not baked");
+        }
+        catch (...)
+        {
+            std::filesystem::current_path(currentDirectory);
+            throw;
+        }
+
+        std::filesystem::current_path(currentDirectory);
+    }
+
+    void runShaderCompilerTests(TestRunner& runner)
+    {
+        runner.run("ShaderCompiler/embeddedShaders", [&]() { testEmbeddedShaders(runner); });
+    }
+}
+#else
+namespace nether::Test
+{
+    void runShaderCompilerTests([[maybe_unused]] TestRunner& runner) {}
+}
+#endif
@@ -0,0 +1,107 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "FileWatcher.hpp"
+#include "ShaderCache.hpp"
+#include "ShaderDependencyGraph.hpp"
+
+namespace nether::Test
+{
+    static void writeShaderFile(const std::filesystem::path& filePath, const std::string_view text)
+    {
+        static uint32_t writeCount{};
+
+        std::filesystem::create_directories(filePath.parent_path());
+
+        {
+            std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+
+        // Distinct write times, as back to back writes can otherwise share one (see FileWatcherTests.cpp).
+        std::filesystem::last_write_time(filePath, std::filesystem::file_time_type::clock::now() + std::chrono::seconds(++writeCount));
+    }
+
+    // Three programs: a mesh and a skinned mesh program sharing Common.hlsli (which includes Lighting.hlsli from the include directory), and a post process program
+    // that only includes Lighting.hlsli. Each program has a file of its own. The dependencies come from the shader cache, as they do in the shader reloader.
+    static void testIncludeGraphInvalidation(TestRunner& runner)
+    {
+        TemporaryDirectory temporaryDirectory("ShaderDependencyGraph");
+        const std::filesystem::path shaderDirectory = temporaryDirectory.getPath() / "shaders";
+        const std::array<std::filesystem::path, 1u> includeDirectories = {temporaryDirectory.getPath() / "include"};
+
+        const std::filesystem::path commonHeaderPath = shaderDirectory / "Common.hlsli";
+        const std::filesystem::path lightingHeaderPath = includeDirectories[0] / "Lighting.hlsli";
+        const std::filesystem::path skinningHeaderPath = shaderDirectory / "Skinning.hlsli";
+        const std::array<std::filesystem::path, 3u> programPaths = {
+            shaderDirectory / "Mesh.hlsl",
+            shaderDirectory / "SkinnedMesh.hlsl",
+            shaderDirectory / "PostProcess.hlsl",
+        };
+
+        writeShaderFile(commonHeaderPath, "#include <Lighting.hlsli>\n");
+        writeShaderFile(lightingHeaderPath, "#define LIGHTING 1\n");
+        writeShaderFile(skinningHeaderPath, "#define SKINNING 1\n");
+        writeShaderFile(programPaths[0], "#include \"Common.hlsli\"\n");
+        writeShaderFile(programPaths[1], "#include \"Common.hlsli\"\n#include \"Skinning.hlsli\"\n");
+        writeShaderFile(programPaths[2], "#include \"Lighting.hlsli\"\n");
+
+        constexpr std::array<const wchar_t*, 2u> arguments = {L"-T", L"vs_6_6"};
+
+        ShaderDependencyGraph dependencyGraph{};
+        FileWatcher fileWatcher(std::chrono::milliseconds(50));
+
+        const auto updateDependencies = [&](const uint32_t programIndex)
+        {
+            std::vector<std::filesystem::path> dependencies{};
+            [[maybe_unused]] const uint64_t key = ShaderCache::computeKey(programPaths[programIndex], includeDirectories, arguments, 1u, &dependencies);
+
+            dependencyGraph.setDependencies(programIndex, dependencies);
+            for (const std::filesystem::path& dependency : dependencies)
+            {
+                fileWatcher.watch(dependency);
+            }
+        };
+
+        for (const uint32_t programIndex : std::views::iota(0u, static_cast<uint32_t>(programPaths.size())))
+        {
+            updateDependencies(programIndex);
+        }
+
+        NETHER_CHECK(runner, fileWatcher.getWatchedFileCount() == 6u);
+
+        // Edits the file, and returns the programs the watcher invalidates once the change settled.
+        FileWatcher::Clock::time_point currentTime{};
+        const auto editFile = [&](const std::filesystem::path& filePath, const std::string_view text)
+        {
+            writeShaderFile(filePath, text);
+
+            NETHER_CHECK(runner, fileWatcher.poll(currentTime += std::chrono::milliseconds(10)).empty());
+            const std::vector<std::filesystem::path> changedFiles = fileWatcher.poll(currentTime += std::chrono::milliseconds(100));
+
+            return dependencyGraph.getAffectedPrograms(changedFiles);
+        };
+
+        // A header at the bottom of the graph affects every program, one the programs share only the programs that include it, and a program's own file only it.
+        NETHER_CHECK(runner, editFile(lightingHeaderPath, "#define LIGHTING 2\n") == (std::vector{0u, 1u, 2u}));
+        NETHER_CHECK(runner, editFile(commonHeaderPath, "#include <Lighting.hlsli>\n#define COMMON 1\n") == (std::vector{0u, 1u}));
+        NETHER_CHECK(runner, editFile(skinningHeaderPath, "#define SKINNING 2\n") == std::vector{1u});
+        NETHER_CHECK(runner, editFile(programPaths[2], "#include \"Lighting.hlsli\"\n#define POST_PROCESS 1\n") == std::vector{2u});
+
+        // Once the skinned mesh program no longer includes Skinning.hlsli, the header affects nothing. The file is still watched, so its edit is reported.
+        editFile(programPaths[1], "#include \"Common.hlsli\"\n");
+        updateDependencies(1u);
+
+        NETHER_CHECK(runner, editFile(skinningHeaderPath, "#define SKINNING 3\n").empty());
+
+        // Files with no dependent programs do not affect anything, and each program is reported once.
+        const std::array<std::filesystem::path, 3u> changedFiles = {temporaryDirectory.getPath() / "Unknown.hlsli", commonHeaderPath, lightingHeaderPath};
+        NETHER_CHECK(runner, dependencyGraph.getAffectedPrograms(changedFiles) == (std::vector{0u, 1u, 2u}));
+    }
+
+    void runShaderDependencyGraphTests(TestRunner& runner)
+    {
+        runner.run("ShaderDependencyGraph/includeGraphInvalidation", [&]() { testIncludeGraphInvalidation(runner); });
+    }
+}
@@ -0,0 +1,103 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+namespace nether::Test
+{
+    void TestRunner::run(const std::string_view name, const std::function<void()>& function)
+    {
+        if (name.find(m_filter) == std::string_view::npos)
+        {
+            return;
+        }
+
+        m_currentTestName = name;
+        m_hasCurrentTestFailed = false;
+        m_testCount++;
+
+        try
+        {
+            function();
+        }
+        catch (const std::exception& exception)
+        {
+            reportFailure(std::format("unexpected exception : {}", exception.what()), std::source_location::current());
+        }
+
+        if (m_hasCurrentTestFailed)
+        {
+            m_failedTestCount++;
+        }
+
+        std::cout << std::format("[{}] {}\n", m_hasCurrentTestFailed ? "FAILED" : "passed", name);
+    }
+
+    void TestRunner::check(const bool condition, const std::string_view expression, const std::source_location location)
+    {
+        if (!condition)
+        {
+            reportFailure(std::format("check failed : {}", expression), location);
+        }
+    }
+
+    void TestRunner::checkThrows(const std::function<void()>& function,
+                                 const std::string_view messageSubstring,
+                                 const std::string_view expression,
+                                 const std::source_location location)
+    {
+        try
+        {
+            function();
+        }
+        catch (const std::exception& exception)
+        {
+            if (std::string_view(exception.what()).find(messageSubstring) == std::string_view::npos)
+            {
+                reportFailure(std::format("{} failed with \"{}\", expected a message containing \"{}\"", expression, exception.what(), messageSubstring), location);
+            }
+
+            return;
+        }
+
+        reportFailure(std::format("{} did not fail, expected a message containing \"{}\"", expression, messageSubstring), location);
+    }
+
+    void TestRunner::reportFailure(const std::string_view message, const std::source_location location)
+    {
+        m_hasCurrentTestFailed = true;
+
+        const std::string fileName = std::filesystem::path(location.file_name()).filename().string();
+        std::cout << std::format("    {} ({}:{}) : {}\n", m_currentTestName, fileName, location.line(), message);
+    }
+
+    bool isNearlyEqual(const math::XMFLOAT4X4& a, const math::XMFLOAT4X4& b, const float tolerance)
+    {
+        for (const uint32_t row : std::views::iota(0u, 4u))
+        {
+            for (const uint32_t column : std::views::iota(0u, 4u))
+            {
+                if (std::abs(a.m[row][column] - b.m[row][column]) > tolerance)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    TemporaryDirectory::TemporaryDirectory(const std::string_view name)
+    {
+        // Unique per process, so that several test runs can happen at the same time.
+        m_path = std::filesystem::temp_directory_path() / std::format("NetherTests-{}-{}", name, std::random_device{}());
+
+        std::filesystem::remove_all(m_path);
+        std::filesystem::create_directories(m_path);
+    }
+
+    TemporaryDirectory::~TemporaryDirectory()
+    {
+        std::error_code errorCode{};
+        std::filesystem::remove_all(m_path, errorCode);
+    }
+}
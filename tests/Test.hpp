@@ -0,0 +1,86 @@
+#pragma once
+
+// Minimal test harness for the CPU side of the engine. A test is a function that checks its results through the runner. Failed checks are reported with their expression
+// and location, and do not stop the test. Errors in the engine go through fatalError (which throws), so a test that throws fails with the exception message.
+namespace nether::Test
+{
+    class TestRunner
+    {
+      public:
+        // Only tests whose name contains the filter run.
+        explicit TestRunner(const std::string_view filter) : m_filter(filter) {}
+
+        void run(const std::string_view name, const std::function<void()>& function);
+
+        // Use the NETHER_CHECK macros below, which fill in the expression.
+        void check(const bool condition, const std::string_view expression, const std::source_location location = std::source_location::current());
+
+        // Checks that function fails with a fatalError whose message contains messageSubstring.
+        void checkThrows(const std::function<void()>& function,
+                         const std::string_view messageSubstring,
+                         const std::string_view expression,
+                         const std::source_location location = std::source_location::current());
+
+        uint32_t getTestCount() const { return m_testCount; }
+        uint32_t getFailedTestCount() const { return m_failedTestCount; }
+
+      private:
+        void reportFailure(const std::string_view message, const std::source_location location);
+
+      private:
+        std::string m_filter{};
+
+        std::string m_currentTestName{};
+        bool m_hasCurrentTestFailed{};
+
+        uint32_t m_testCount{};
+        uint32_t m_failedTestCount{};
+    };
+
+#define NETHER_CHECK(runner, condition) (runner).check(static_cast<bool>(condition), #condition)
+#define NETHER_CHECK_THROWS(runner, expression, messageSubstring) (runner).checkThrows([&]() { (void)(expression); }, messageSubstring, #expression)
+
+    // True if the matrices are equal within tolerance, element by element.
+    [[nodiscard]] bool isNearlyEqual(const math::XMFLOAT4X4& a, const math::XMFLOAT4X4& b, const float tolerance = 1e-5f);
+
+    // Temporary directory that is removed (with everything in it) when it goes out of scope.
+    class TemporaryDirectory
+    {
+      public:
+        explicit TemporaryDirectory(const std::string_view name);
+        ~TemporaryDirectory();
+
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+        const std::filesystem::path& getPath() const { return m_path; }
+
+      private:
+        std::filesystem::path m_path{};
+    };
+
+    // Each group registers its tests with the runner (see Main.cpp).
+    void runSceneTests(TestRunner& runner);
+    void runTransformKernelTests(TestRunner& runner);
+    void runDrawListTests(TestRunner& runner);
+    void runIndirectCommandsTests(TestRunner& runner);
+    void runGraphicsBackendTests(TestRunner& runner);
+    void runDescriptorAllocatorTests(TestRunner& runner);
+    void runParallelRecorderTests(TestRunner& runner);
+    void runRenderGraphTests(TestRunner& runner);
+    void runShaderCacheTests(TestRunner& runner);
+    void runShaderCompilerTests(TestRunner& runner);
+    void runFileWatcherTests(TestRunner& runner);
+    void runShaderDependencyGraphTests(TestRunner& runner);
+    void runRootConstantLayoutTests(TestRunner& runner);
+    void runTripleBufferTests(TestRunner& runner);
+    void runProfilerTests(TestRunner& runner);
+    void runJobSystemTests(TestRunner& runner);
+    void runLinearArenaTests(TestRunner& runner);
+    void runAssetRegistryTests(TestRunner& runner);
+    void runLz4Tests(TestRunner& runner);
+    void runAssetArchiveTests(TestRunner& runner);
+    void runJsonReaderTests(TestRunner& runner);
+    void runGltfImporterTests(TestRunner& runner);
+    void runAssetPipelineTests(TestRunner& runner);
+}
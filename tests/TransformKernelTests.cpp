@@ -0,0 +1,232 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "TransformKernel.hpp"
+
+namespace nether::Test
+{
+    // Local transforms in structure of arrays form, as the scene stores them.
+    struct TransformArrays
+    {
+        std::array<std::vector<float>, 9u> components{};
+
+        explicit TransformArrays(const size_t count) { components.fill(std::vector<float>(count)); }
+
+        void set(const size_t index, const math::XMFLOAT3& translate, const math::XMFLOAT3& rotate, const math::XMFLOAT3& scale)
+        {
+            const std::array<float, 9u> values = {translate.x, translate.y, translate.z, rotate.x, rotate.y, rotate.z, scale.x, scale.y, scale.z};
+            for (const size_t component : std::views::iota(0u, 9u))
+            {
+                components[component][index] = values[component];
+            }
+        }
+
+        TransformKernel::LocalTransforms getLocalTransforms() const
+        {
+            return TransformKernel::LocalTransforms{
+                .translateX = components[0].data(),
+                .translateY = components[1].data(),
+                .translateZ = components[2].data(),
+                .rotateX = components[3].data(),
+                .rotateY = components[4].data(),
+                .rotateZ = components[5].data(),
+                .scaleX = components[6].data(),
+                .scaleY = components[7].data(),
+                .scaleZ = components[8].data(),
+                .count = components[0].size(),
+            };
+        }
+    };
+
+    // Not a multiple of 8, so both the AVX2 groups (on CPUs that have it) and the scalar tail are checked.
+    static constexpr size_t TRANSFORM_COUNT = 1003u;
+
+    static float getMaxError(const math::XMFLOAT4X4& a, const math::XMFLOAT4X4& b)
+    {
+        float maxError{};
+        for (const uint32_t row : std::views::iota(0u, 4u))
+        {
+            for (const uint32_t column : std::views::iota(0u, 4u))
+            {
+                maxError = std::max(maxError, std::abs(a.m[row][column] - b.m[row][column]));
+            }
+        }
+
+        return maxError;
+    }
+
+    // Against the DirectXMath matrices the engine built per object before the kernel, and XMMatrixInverse for the normal matrix.
+    static void testPrecision(TestRunner& runner)
+    {
+        std::mt19937 randomEngine(27u);
+        std::uniform_real_distribution<float> translateDistribution(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> rotateDistribution(-2.0f * math::XM_PI, 2.0f * math::XM_PI);
+        std::uniform_real_distribution<float> scaleDistribution(0.25f, 4.0f);
+
+        TransformArrays transformArrays(TRANSFORM_COUNT);
+        for (const size_t i : std::views::iota(size_t{0u}, TRANSFORM_COUNT))
+        {
+            transformArrays.set(i,
+                                {translateDistribution(randomEngine), translateDistribution(randomEngine), translateDistribution(randomEngine)},
+                                {rotateDistribution(randomEngine), rotateDistribution(randomEngine), rotateDistribution(randomEngine)},
+                                {scaleDistribution(randomEngine), scaleDistribution(randomEngine), scaleDistribution(randomEngine)});
+        }
+
+        std::vector<math::XMFLOAT4X4> localMatrices(TRANSFORM_COUNT);
+        std::vector<math::XMFLOAT4X4> localNormalMatrices(TRANSFORM_COUNT);
+        TransformKernel::compose(transformArrays.getLocalTransforms(), nullptr, localMatrices, localNormalMatrices);
+
+        float maxLocalError{};
+        float maxNormalError{};
+
+        const auto& c = transformArrays.components;
+        for (const size_t i : std::views::iota(size_t{0u}, TRANSFORM_COUNT))
+        {
+            const math::XMMATRIX localMatrix = math::XMMatrixRotationX(c[3][i]) * math::XMMatrixRotationY(c[4][i]) * math::XMMatrixRotationZ(c[5][i]) *
+                                               math::XMMatrixScaling(c[6][i], c[7][i], c[8][i]) * math::XMMatrixTranslation(c[0][i], c[1][i], c[2][i]);
+
+            // Normals are not translated, so only the upper 3x3 is inverted.
+            math::XMMATRIX linearMatrix = localMatrix;
+            linearMatrix.r[3] = math::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+            const math::XMMATRIX normalMatrix = math::XMMatrixTranspose(math::XMMatrixInverse(nullptr, linearMatrix));
+
+            math::XMFLOAT4X4 expectedLocalMatrix{};
+            math::XMFLOAT4X4 expectedNormalMatrix{};
+            math::XMStoreFloat4x4(&expectedLocalMatrix, localMatrix);
+            math::XMStoreFloat4x4(&expectedNormalMatrix, normalMatrix);
+
+            maxLocalError = std::max(maxLocalError, getMaxError(localMatrices[i], expectedLocalMatrix));
+            maxNormalError = std::max(maxNormalError, getMaxError(localNormalMatrices[i], expectedNormalMatrix));
+        }
+
+        // Same math, but rounded in a different order than the matrix products. Values are at most 4 (the translation row is copied), where a float ulp is about 5e-7.
+        // The normal matrix is compared against a general inverse, whose error grows with the ratio of the scale components (up to 16 here).
+        NETHER_CHECK(runner, maxLocalError < 1e-5f);
+        NETHER_CHECK(runner, maxNormalError < 5e-5f);
+    }
+
+    // With a uniform scale, R * S = S * R, so the local matrix is also what XMMatrixAffineTransformation builds from the equivalent quaternion.
+    static void testAffineTransformation(TestRunner& runner)
+    {
+        std::mt19937 randomEngine(270u);
+        std::uniform_real_distribution<float> translateDistribution(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> rotateDistribution(-math::XM_PI, math::XM_PI);
+        std::uniform_real_distribution<float> scaleDistribution(0.25f, 4.0f);
+
+        TransformArrays transformArrays(TRANSFORM_COUNT);
+        for (const size_t i : std::views::iota(size_t{0u}, TRANSFORM_COUNT))
+        {
+            const float scale = scaleDistribution(randomEngine);
+            transformArrays.set(i,
+                                {translateDistribution(randomEngine), translateDistribution(randomEngine), translateDistribution(randomEngine)},
+                                {rotateDistribution(randomEngine), rotateDistribution(randomEngine), rotateDistribution(randomEngine)},
+                                {scale, scale, scale});
+        }
+
+        std::vector<math::XMFLOAT4X4> localMatrices(TRANSFORM_COUNT);
+        std::vector<math::XMFLOAT4X4> localNormalMatrices(TRANSFORM_COUNT);
+        TransformKernel::compose(transformArrays.getLocalTransforms(), nullptr, localMatrices, localNormalMatrices);
+
+        float maxError{};
+
+        const auto& c = transformArrays.components;
+        for (const size_t i : std::views::iota(size_t{0u}, TRANSFORM_COUNT))
+        {
+            // Rotation around x, then y, then z (XMQuaternionMultiply(a, b) rotates by a, then b).
+            const math::XMVECTOR rotationX = math::XMQuaternionRotationNormal(math::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), c[3][i]);
+            const math::XMVECTOR rotationY = math::XMQuaternionRotationNormal(math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), c[4][i]);
+            const math::XMVECTOR rotationZ = math::XMQuaternionRotationNormal(math::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), c[5][i]);
+            const math::XMVECTOR rotation = math::XMQuaternionMultiply(math::XMQuaternionMultiply(rotationX, rotationY), rotationZ);
+
+            math::XMFLOAT4X4 expectedLocalMatrix{};
+            math::XMStoreFloat4x4(&expectedLocalMatrix,
+                                  math::XMMatrixAffineTransformation(math::XMVectorSet(c[6][i], c[7][i], c[8][i], 0.0f),
+                                                                     math::XMVectorZero(),
+                                                                     rotation,
+                                                                     math::XMVectorSet(c[0][i], c[1][i], c[2][i], 0.0f)));
+
+            maxError = std::max(maxError, getMaxError(localMatrices[i], expectedLocalMatrix));
+        }
+
+        // The quaternion is a different route to the same rotation.
+        NETHER_CHECK(runner, maxError < 1e-5f);
+    }
+
+    // The same transform in a 8 wide group and in the scalar tail gives the same matrices.
+    static void testPathsAgree(TestRunner& runner)
+    {
+        constexpr size_t count = 19u;
+
+        TransformArrays transformArrays(count);
+        for (const size_t i : std::views::iota(0u, count))
+        {
+            transformArrays.set(i, {1.0f, -2.0f, 3.0f}, {0.4f, -1.3f, 2.9f}, {0.5f, 1.5f, 3.0f});
+        }
+
+        std::vector<math::XMFLOAT4X4> localMatrices(count);
+        std::vector<math::XMFLOAT4X4> localNormalMatrices(count);
+        TransformKernel::compose(transformArrays.getLocalTransforms(), nullptr, localMatrices, localNormalMatrices);
+
+        for (const size_t i : std::views::iota(1u, count))
+        {
+            NETHER_CHECK(runner, isNearlyEqual(localMatrices[i], localMatrices[0], 1e-6f));
+            NETHER_CHECK(runner, isNearlyEqual(localNormalMatrices[i], localNormalMatrices[0], 1e-6f));
+        }
+    }
+
+    static void testDirtyFlags(TestRunner& runner)
+    {
+        constexpr size_t count = 27u;
+
+        TransformArrays transformArrays(count);
+        for (const size_t i : std::views::iota(0u, count))
+        {
+            transformArrays.set(i, {static_cast<float>(i), 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f});
+        }
+
+        // Group 0 is clean, group 1 has one dirty transform, and transform 25 is dirty in the scalar tail.
+        std::vector<uint8_t> dirtyFlags(count);
+        dirtyFlags[12] = 1u;
+        dirtyFlags[25] = 1u;
+
+        const math::XMFLOAT4X4 sentinel(-1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f);
+        std::vector<math::XMFLOAT4X4> localMatrices(count, sentinel);
+        std::vector<math::XMFLOAT4X4> localNormalMatrices(count, sentinel);
+
+        TransformKernel::compose(transformArrays.getLocalTransforms(), dirtyFlags.data(), localMatrices, localNormalMatrices);
+
+        for (const size_t i : std::views::iota(0u, count))
+        {
+            const bool isWritten = localMatrices[i]._11 != -1.0f;
+
+            // Clean transforms may only be written when they share a group with a dirty one, and then with their correct value.
+            if (dirtyFlags[i] || isWritten)
+            {
+                NETHER_CHECK(runner, localMatrices[i]._41 == static_cast<float>(i));
+                NETHER_CHECK(runner, localMatrices[i]._11 == 1.0f);
+            }
+
+            if (i < 8u || i == 24u || i == 26u)
+            {
+                NETHER_CHECK(runner, !isWritten);
+            }
+        }
+    }
+
+    void runTransformKernelTests(TestRunner& runner)
+    {
+        runner.run("TransformKernel/precision", [&]() { testPrecision(runner); });
+        runner.run("TransformKernel/affineTransformation", [&]() { testAffineTransformation(runner); });
+        runner.run("TransformKernel/pathsAgree", [&]() { testPathsAgree(runner); });
+        runner.run("TransformKernel/dirtyFlags", [&]() { testDirtyFlags(runner); });
+
+        runner.run("TransformKernel/outputTooSmall",
+                   [&]()
+                   {
+                       TransformArrays transformArrays(4u);
+                       std::vector<math::XMFLOAT4X4> matrices(3u);
+                       NETHER_CHECK_THROWS(runner, TransformKernel::compose(transformArrays.getLocalTransforms(), nullptr, matrices, matrices), "smaller than");
+                   });
+    }
+}
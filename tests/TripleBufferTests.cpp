@@ -0,0 +1,177 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+#include "TripleBuffer.hpp"
+
+// The threaded tests are meant to be run under ThreadSanitizer as well (premake5 gmake2 --sanitize=thread), which checks that the slots are never accessed by both
+// threads at once.
+namespace nether::Test
+{
+    // Large enough that a value the consumer reads while the producer writes it would be torn.
+    struct Packet
+    {
+        uint32_t frame{};
+        std::array<uint32_t, 64u> payload{};
+
+        void write(const uint32_t newFrame)
+        {
+            frame = newFrame;
+            payload.fill(newFrame);
+        }
+
+        bool isConsistent() const
+        {
+            return std::ranges::all_of(payload, [&](const uint32_t value) { return value == frame; });
+        }
+    };
+
+    static void testHandoff(TestRunner& runner)
+    {
+        TripleBuffer<Packet> packets{};
+
+        // The latest published value replaces one the consumer has not acquired yet, and the producer never writes the slot the consumer reads.
+        packets.getWriteSlot().write(1u);
+        packets.publish();
+        packets.getWriteSlot().write(2u);
+        packets.publish();
+
+        const Packet* const packet = packets.acquire();
+        NETHER_CHECK(runner, packet != nullptr && packet->frame == 2u);
+        NETHER_CHECK(runner, &packets.getWriteSlot() != packet);
+
+        // Consumed, so the producer does not wait.
+        NETHER_CHECK(runner, packets.waitUntilConsumed());
+
+        packets.getWriteSlot().write(3u);
+        packets.publish();
+        NETHER_CHECK(runner, packets.acquire()->frame == 3u);
+
+        // Once closed, every wait on either side fails, even with a value published.
+        packets.getWriteSlot().write(4u);
+        packets.publish();
+        packets.close();
+
+        NETHER_CHECK(runner, packets.acquire() == nullptr);
+        NETHER_CHECK(runner, !packets.waitUntilConsumed());
+
+        packets.publish();
+        NETHER_CHECK(runner, packets.acquire() == nullptr);
+    }
+
+    // The producer runs free (the consumer skips values) or waits for each value to be consumed (the consumer sees every value), as Engine::run does.
+    static void testConcurrentHandoff(TestRunner& runner, const bool waitUntilConsumed)
+    {
+        constexpr uint32_t frameCount = 20000u;
+
+        TripleBuffer<Packet> packets{};
+
+        uint32_t acquiredCount{};
+        uint32_t inconsistentCount{};
+        uint32_t outOfOrderCount{};
+
+        std::jthread consumerThread(
+            [&]()
+            {
+                uint32_t previousFrame{};
+                while (const Packet* const packet = packets.acquire())
+                {
+                    acquiredCount++;
+                    inconsistentCount += packet->isConsistent() ? 0u : 1u;
+                    outOfOrderCount += packet->frame > previousFrame ? 0u : 1u;
+
+                    previousFrame = packet->frame;
+                    if (previousFrame == frameCount)
+                    {
+                        return;
+                    }
+                }
+            });
+
+        for (const uint32_t frame : std::views::iota(1u, frameCount + 1u))
+        {
+            packets.getWriteSlot().write(frame);
+
+            if (waitUntilConsumed && !packets.waitUntilConsumed())
+            {
+                break;
+            }
+
+            packets.publish();
+        }
+
+        consumerThread.join();
+
+        NETHER_CHECK(runner, inconsistentCount == 0u);
+        NETHER_CHECK(runner, outOfOrderCount == 0u);
+        NETHER_CHECK(runner, waitUntilConsumed ? acquiredCount == frameCount : (acquiredCount >= 1u && acquiredCount <= frameCount));
+    }
+
+    // Either side closes while the other keeps swapping slots. The close is never lost: the thread that closed sees the buffer closed from then on, however the swaps
+    // of the other thread interleave with its checks, and the other thread stops.
+    static void testCloseRace(TestRunner& runner, const bool isClosedByConsumer)
+    {
+        constexpr uint32_t iterationCount = 200u;
+        constexpr uint32_t publishCount = 2000u;
+        constexpr uint32_t checkCount = 200u;
+
+        uint32_t reopenedCount{};
+
+        for (const uint32_t iteration : std::views::iota(0u, iterationCount))
+        {
+            TripleBuffer<Packet> packets{};
+
+            // Varies between iterations, so the close lands at different points of the other thread's swaps.
+            const uint32_t closeFrame = 1u + iteration % 64u;
+
+            std::jthread consumerThread(
+                [&]()
+                {
+                    while (const Packet* const packet = packets.acquire())
+                    {
+                        if (isClosedByConsumer && packet->frame >= closeFrame)
+                        {
+                            packets.close();
+                            for ([[maybe_unused]] const uint32_t check : std::views::iota(0u, checkCount))
+                            {
+                                reopenedCount += packets.acquire() == nullptr ? 0u : 1u;
+                            }
+                        }
+                    }
+                });
+
+            // The producer does not wait for its values to be consumed, so it swaps as often as it can while the consumer checks.
+            for (const uint32_t frame : std::views::iota(1u, publishCount + 1u))
+            {
+                packets.getWriteSlot().write(frame);
+                packets.publish();
+
+                if (!isClosedByConsumer && frame == closeFrame)
+                {
+                    packets.close();
+                    for ([[maybe_unused]] const uint32_t check : std::views::iota(0u, checkCount))
+                    {
+                        reopenedCount += packets.waitUntilConsumed() ? 1u : 0u;
+                    }
+
+                    break;
+                }
+            }
+
+            // Stops the consumer if it has not closed the buffer yet (it may have skipped the close frame).
+            packets.close();
+            consumerThread.join();
+        }
+
+        NETHER_CHECK(runner, reopenedCount == 0u);
+    }
+
+    void runTripleBufferTests(TestRunner& runner)
+    {
+        runner.run("TripleBuffer/handoff", [&]() { testHandoff(runner); });
+        runner.run("TripleBuffer/concurrentHandoff", [&]() { testConcurrentHandoff(runner, false); });
+        runner.run("TripleBuffer/concurrentHandoffWaitUntilConsumed", [&]() { testConcurrentHandoff(runner, true); });
+        runner.run("TripleBuffer/closeByConsumerRace", [&]() { testCloseRace(runner, true); });
+        runner.run("TripleBuffer/closeByProducerRace", [&]() { testCloseRace(runner, false); });
+    }
+}
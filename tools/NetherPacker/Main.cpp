@@ -0,0 +1,80 @@
+#include "Pch.hpp"
+
+#include "AssetArchive.hpp"
+
+// Usage : NetherPacker <archive path> <directory>... [--no-compression]
+// Packs every file under the directories into an asset archive (see AssetArchive.hpp). Run from the repository root, assets are stored under their path relative to
+// the working directory, which is the path the engine loads them with (e.g. "NetherPacker assets.pak assets").
+int main(int argc, char** argv)
+{
+    using namespace nether;
+
+    std::string archivePath{};
+    std::vector<std::string> directories{};
+    bool compress{true};
+
+    const std::vector<std::string_view> arguments(argv + 1, argv + argc);
+    for (const std::string_view argument : arguments)
+    {
+        if (argument == "--no-compression")
+        {
+            compress = false;
+        }
+        else if (archivePath.empty())
+        {
+            archivePath = argument;
+        }
+        else
+        {
+            directories.emplace_back(argument);
+        }
+    }
+
+    if (archivePath.empty() || directories.empty())
+    {
+        std::cout << "Usage : NetherPacker <archive path> <directory>... [--no-compression]" << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        std::vector<std::string> filePaths{};
+        for (const std::string& directory : directories)
+        {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directory))
+            {
+                if (entry.is_regular_file())
+                {
+                    filePaths.push_back(entry.path().generic_string());
+                }
+            }
+        }
+
+        writeAssetArchive(archivePath, filePaths, compress);
+
+        const AssetArchive archive(archivePath);
+
+        uint64_t totalSize{};
+        uint64_t compressedCount{};
+        for (const AssetArchiveEntry& entry : archive.getEntries())
+        {
+            totalSize += entry.size;
+            compressedCount += entry.compression == AssetCompression::None ? 0u : 1u;
+        }
+
+        std::cout << std::format("Packed {} files ({} compressed) into {} : {} bytes, {} bytes on disk.",
+                                 archive.getEntries().size(),
+                                 compressedCount,
+                                 archivePath,
+                                 totalSize,
+                                 std::filesystem::file_size(archivePath))
+                  << std::endl;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cout << "[Exception Caught] : " << exception.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}